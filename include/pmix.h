@@ -215,6 +215,30 @@ PMIX_EXPORT pmix_status_t PMIx_Get_nb(const pmix_proc_t *proc, const char key[],
                                       const pmix_info_t info[], size_t ninfo,
                                       pmix_value_cbfunc_t cbfunc, void *cbdata);
 
+/* Retrieve the same _key_ from each of the _nranks_ processes named in
+ * _ranks_ within the given namespace - e.g., the endpoint of every peer in a
+ * communicator - returning the answers in a single contiguous array of
+ * _nranks_ values, in the order given. A NULL or empty namespace refers to
+ * the caller's own.
+ *
+ * This is a blocking operation, equivalent to a PMIx_Get for each rank but
+ * resolved in one pass: ranks whose data is already held locally are
+ * answered without further round trips, and requests for all the others
+ * are issued to the server together before the caller waits on any of
+ * them. The info array carries the same directives as PMIx_Get, except that
+ * PMIX_GET_POINTER_VALUES and PMIX_GET_STATIC_VALUES are not supported.
+ *
+ * Returns PMIX_SUCCESS if every value was found. If only some were found,
+ * PMIX_ERR_PARTIAL_SUCCESS is returned and the entries that could not be
+ * retrieved are of type PMIX_UNDEF. In either case the caller is
+ * responsible for releasing the array with PMIX_VALUE_FREE(*values, nranks).
+ * If none were found, an error is returned and _values_ is set to NULL. */
+PMIX_EXPORT pmix_status_t PMIx_Get_multi(const pmix_nspace_t nspace,
+                                         const pmix_rank_t ranks[], size_t nranks,
+                                         const char key[],
+                                         const pmix_info_t info[], size_t ninfo,
+                                         pmix_value_t **values);
+
 
 /* Publish the data in the info array for lookup. By default,
  * the data will be published into the PMIX_SESSION range and
@@ -4,7 +4,7 @@
  * Copyright (c) 2012      Los Alamos National Security, LLC. All rights reserved
  * Copyright (c) 2015-2020 Intel, Inc.  All rights reserved.
  * Copyright (c) 2020      IBM Corporation.  All rights reserved.
- * Copyright (c) 2021      Nanook Consulting.  All rights reserved.
+ * Copyright (c) 2021-2026 Nanook Consulting.  All rights reserved.
  * $COPYRIGHT$
  *
  * Additional copyrights may follow
@@ -23,10 +23,17 @@
 static void constructor(pmix_hotel_t *h);
 static void destructor(pmix_hotel_t *h);
 
-static void local_eviction_callback(int fd, short flags, void *arg)
+/* The wheel ticks at this fraction of the eviction timeout, within the
+ * bounds below - fine enough that an occupant is not kept noticeably
+ * past its time, coarse enough that a wheel sized for one turn per
+ * timeout stays small. */
+#define PMIX_HOTEL_TICKS_PER_TIMEOUT 64
+#define PMIX_HOTEL_MIN_TICK_USEC 10000
+#define PMIX_HOTEL_MAX_TICK_USEC 1000000
+
+static void local_eviction_callback(pmix_timer_wheel_entry_t *entry, void *arg)
 {
-    (void) fd;
-    (void) flags;
+    (void) entry;
     pmix_hotel_room_eviction_callback_arg_t *eargs = (pmix_hotel_room_eviction_callback_arg_t *)
         arg;
     void *occupant = eargs->hotel->rooms[eargs->room_num].occupant;
@@ -52,6 +59,9 @@ pmix_status_t pmix_hotel_init(pmix_hotel_t *h, int num_rooms, pmix_event_base_t
                               pmix_hotel_eviction_callback_fn_t evict_callback_fn)
 {
     int i;
+    uint64_t usec;
+    struct timeval tick;
+    pmix_status_t rc;
 
     /* Bozo check */
     if (num_rooms <= 0 || NULL == evict_callback_fn) {
@@ -89,6 +99,29 @@ pmix_status_t pmix_hotel_init(pmix_hotel_t *h, int num_rooms, pmix_event_base_t
     }
     h->last_unoccupied_room = num_rooms - 1;
 
+    if (NULL != h->evbase) {
+        h->wheel = PMIX_NEW(pmix_timer_wheel_t);
+        usec = (uint64_t) eviction_timeout * 1000000 / PMIX_HOTEL_TICKS_PER_TIMEOUT;
+        if (PMIX_HOTEL_MIN_TICK_USEC > usec) {
+            usec = PMIX_HOTEL_MIN_TICK_USEC;
+        } else if (PMIX_HOTEL_MAX_TICK_USEC < usec) {
+            usec = PMIX_HOTEL_MAX_TICK_USEC;
+        }
+        tick.tv_sec = usec / 1000000;
+        tick.tv_usec = usec % 1000000;
+        /* one turn of the wheel covers the whole timeout, so each timer
+         * is visited just the once - plus a slot for the tick that was
+         * already under way when it was started */
+        rc = (NULL == h->wheel) ? PMIX_ERR_NOMEM
+                                : pmix_timer_wheel_init(h->wheel, h->evbase, &tick,
+                                                        (size_t) ((uint64_t) eviction_timeout
+                                                                  * 1000000 / usec) + 2);
+        if (PMIX_SUCCESS != rc) {
+            destructor(h);
+            return PMIX_ERR_OUT_OF_RESOURCE;
+        }
+    }
+
     for (i = 0; i < num_rooms; ++i) {
         /* Mark this room as unoccupied */
         h->rooms[i].occupant = NULL;
@@ -100,11 +133,9 @@ pmix_status_t pmix_hotel_init(pmix_hotel_t *h, int num_rooms, pmix_event_base_t
         h->eviction_args[i].hotel = h;
         h->eviction_args[i].room_num = i;
 
-        /* Create this room's event (but don't add it) */
-        if (NULL != h->evbase) {
-            pmix_event_assign(&(h->rooms[i].eviction_timer_event), h->evbase, -1, 0,
-                              local_eviction_callback, &(h->eviction_args[i]));
-        }
+        /* Setup this room's eviction timer (but don't start it) */
+        pmix_timer_wheel_entry_init(&(h->rooms[i].eviction_timer), local_eviction_callback,
+                                    &(h->eviction_args[i]));
     }
 
     return PMIX_SUCCESS;
@@ -116,6 +147,7 @@ static void constructor(pmix_hotel_t *h)
     h->evbase = NULL;
     h->eviction_timeout.tv_sec = 0;
     h->eviction_timeout.tv_usec = 0;
+    h->wheel = NULL;
     h->evict_callback_fn = NULL;
     h->rooms = NULL;
     h->eviction_args = NULL;
@@ -125,15 +157,10 @@ static void constructor(pmix_hotel_t *h)
 
 static void destructor(pmix_hotel_t *h)
 {
-    int i;
-
-    /* Go through all occupied rooms and destroy their events */
-    if (NULL != h->evbase) {
-        for (i = 0; i < h->num_rooms; ++i) {
-            if (NULL != h->rooms[i].occupant) {
-                pmix_event_del(&(h->rooms[i].eviction_timer_event));
-            }
-        }
+    /* Cancel every pending eviction - the wheel's timers live in the
+     * rooms, so it has to go before they do */
+    if (NULL != h->wheel) {
+        PMIX_RELEASE(h->wheel);
     }
 
     if (NULL != h->rooms) {
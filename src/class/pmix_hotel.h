@@ -22,7 +22,8 @@
  * - An arbitrary data pointer can check into an empty room at any time
  * - The occupant of a room can check out at any time
  * - Optionally, the occupant of a room can be forcibly evicted at a
- *   given time (i.e., when an pmix timer event expires).
+ *   given time (i.e., when its timer on the hotel's timing wheel
+ *   expires - see pmix_timer_wheel.h).
  * - The hotel has finite occupancy; if you try to checkin a new
  *   occupant and the hotel is already full, it will gracefully fail
  *   to checkin.
@@ -48,9 +49,18 @@
  *
  * There is an pmix_hotel_init() function to create a hotel, but no
  * corresponding finalize; the destructor will handle all finalization
- * issues.  Note that when a hotel is destroyed, it will delete all
- * pending events from the event base (i.e., all pending eviction
- * callbacks); no further eviction callbacks will be invoked.
+ * issues.  Note that when a hotel is destroyed, it will cancel all
+ * pending eviction timers; no further eviction callbacks will be
+ * invoked.
+ *
+ * Eviction timers all run off one timing wheel per hotel rather than
+ * one libevent timer per room. A hotel that fills and drains quickly -
+ * the notification cache during a fault storm - used to add and delete
+ * an event on the event library's heap for every occupant; checking in
+ * and out is now a list operation, and every occupant whose time comes
+ * in the same tick is evicted by a single timer callback. Evictions are
+ * correspondingly less punctual: an occupant leaves up to one tick
+ * (a small fraction of the eviction timeout) after its time is up.
  */
 
 #ifndef PMIX_HOTEL_H
@@ -59,6 +69,7 @@
 #include "src/include/pmix_config.h"
 #include "pmix_common.h"
 #include "src/class/pmix_object.h"
+#include "src/class/pmix_timer_wheel.h"
 #include "src/include/pmix_prefetch.h"
 #include "src/include/pmix_types.h"
 #include <event.h>
@@ -86,7 +97,7 @@ typedef void (*pmix_hotel_eviction_callback_fn_t)(struct pmix_hotel_t *hotel, in
    contiguous set of rooms in an array. */
 typedef struct {
     void *occupant;
-    pmix_event_t eviction_timer_event;
+    pmix_timer_wheel_entry_t eviction_timer;
 } pmix_hotel_room_t;
 
 /* Note that this is an internal data structure; it is not part of the
@@ -122,6 +133,8 @@ typedef struct pmix_hotel_t {
     /* event base to be used for eviction timeout */
     pmix_event_base_t *evbase;
     struct timeval eviction_timeout;
+    /* the eviction timers - NULL if there is no event base */
+    pmix_timer_wheel_t *wheel;
     pmix_hotel_eviction_callback_fn_t evict_callback_fn;
 
     /* All rooms in this hotel */
@@ -144,6 +157,7 @@ PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_hotel_t);
     .num_rooms = 0,                                 \
     .evbase = NULL,                                 \
     .eviction_timeout = {0, 0},                     \
+    .wheel = NULL,                                  \
     .evict_callback_fn = NULL,                      \
     .rooms = NULL,                                  \
     .eviction_args = NULL,                          \
@@ -216,9 +230,9 @@ static inline pmix_status_t pmix_hotel_checkin(pmix_hotel_t *hotel, void *occupa
     room = &(hotel->rooms[*room_num]);
     room->occupant = occupant;
 
-    /* Assign the event and make it pending */
-    if (NULL != hotel->evbase) {
-        pmix_event_add(&(room->eviction_timer_event), &(hotel->eviction_timeout));
+    /* Start the eviction timer */
+    if (NULL != hotel->wheel) {
+        pmix_timer_wheel_add(hotel->wheel, &(room->eviction_timer), &(hotel->eviction_timeout));
     }
 
     return PMIX_SUCCESS;
@@ -245,9 +259,9 @@ static inline void pmix_hotel_checkin_with_res(pmix_hotel_t *hotel, void *occupa
     assert(room->occupant == NULL);
     room->occupant = occupant;
 
-    /* Assign the event and make it pending */
-    if (NULL != hotel->evbase) {
-        pmix_event_add(&(room->eviction_timer_event), &(hotel->eviction_timeout));
+    /* Start the eviction timer */
+    if (NULL != hotel->wheel) {
+        pmix_timer_wheel_add(hotel->wheel, &(room->eviction_timer), &(hotel->eviction_timeout));
     }
 }
 
@@ -288,8 +302,8 @@ static inline void pmix_hotel_checkout(pmix_hotel_t *hotel, int room_num)
            logic in pmix_hotel_checkout_and_return_occupant() and
            pmix_hotel.c:local_eviction_callback(). */
         room->occupant = NULL;
-        if (NULL != hotel->evbase) {
-            pmix_event_del(&(room->eviction_timer_event));
+        if (NULL != hotel->wheel) {
+            pmix_timer_wheel_del(hotel->wheel, &(room->eviction_timer));
         }
         hotel->last_unoccupied_room++;
         assert(hotel->last_unoccupied_room < hotel->num_rooms);
@@ -335,8 +349,8 @@ static inline void pmix_hotel_checkout_and_return_occupant(pmix_hotel_t *hotel,
            pmix_hotel.c:local_eviction_callback(). */
         *occupant = room->occupant;
         room->occupant = NULL;
-        if (NULL != hotel->evbase) {
-            pmix_event_del(&(room->eviction_timer_event));
+        if (NULL != hotel->wheel) {
+            pmix_timer_wheel_del(hotel->wheel, &(room->eviction_timer));
         }
         hotel->last_unoccupied_room++;
         assert(hotel->last_unoccupied_room < hotel->num_rooms);
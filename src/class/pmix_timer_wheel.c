@@ -0,0 +1,209 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "src/include/pmix_config.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include <event.h>
+#include "src/class/pmix_timer_wheel.h"
+
+static void unlink_entry(pmix_timer_wheel_entry_t *entry)
+{
+    entry->prev->next = entry->next;
+    entry->next->prev = entry->prev;
+    entry->next = NULL;
+    entry->prev = NULL;
+}
+
+static void append_entry(pmix_timer_wheel_entry_t *head, pmix_timer_wheel_entry_t *entry)
+{
+    entry->prev = head->prev;
+    entry->next = head;
+    head->prev->next = entry;
+    head->prev = entry;
+}
+
+static void tick_cb(int fd, short flags, void *arg)
+{
+    (void) fd;
+    (void) flags;
+    pmix_timer_wheel_t *wheel = (pmix_timer_wheel_t *) arg;
+
+    (void) pmix_timer_wheel_tick(wheel);
+    /* the timer is persistent - stop it once there is nothing left to
+     * time, so an idle wheel costs nothing at all */
+    if (0 == wheel->npending && wheel->ev_active) {
+        pmix_event_del(&wheel->ev);
+        wheel->ev_active = false;
+    }
+}
+
+pmix_status_t pmix_timer_wheel_init(pmix_timer_wheel_t *wheel, pmix_event_base_t *evbase,
+                                    const struct timeval *tick, size_t nslots)
+{
+    pmix_timer_wheel_entry_t *slots;
+    size_t n, size;
+
+    if (NULL == tick || (0 == tick->tv_sec && 0 == tick->tv_usec) || 0 == nslots
+        || 0 < wheel->npending) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    for (size = 1; size < nslots; size <<= 1) {
+        if (size > (SIZE_MAX >> 1) / sizeof(pmix_timer_wheel_entry_t)) {
+            return PMIX_ERR_BAD_PARAM;
+        }
+    }
+    slots = (pmix_timer_wheel_entry_t *) malloc(size * sizeof(pmix_timer_wheel_entry_t));
+    if (NULL == slots) {
+        return PMIX_ERR_NOMEM;
+    }
+    for (n = 0; n < size; n++) {
+        slots[n].next = &slots[n];
+        slots[n].prev = &slots[n];
+        slots[n].rounds = 0;
+        slots[n].pending = false;
+        slots[n].cbfunc = NULL;
+        slots[n].cbdata = NULL;
+    }
+
+    /* an idle wheel has no timer running, so it can be resized */
+    if (NULL != wheel->slots) {
+        free(wheel->slots);
+    }
+    wheel->slots = slots;
+    wheel->nslots = size;
+    wheel->cursor = 0;
+    wheel->tick = *tick;
+    wheel->evbase = evbase;
+    if (NULL != evbase) {
+        pmix_event_assign(&wheel->ev, evbase, -1, EV_PERSIST, tick_cb, wheel);
+    }
+    return PMIX_SUCCESS;
+}
+
+void pmix_timer_wheel_add(pmix_timer_wheel_t *wheel, pmix_timer_wheel_entry_t *entry,
+                          const struct timeval *timeout)
+{
+    uint64_t usec, tickusec, ticks;
+
+    if (entry->pending) {
+        pmix_timer_wheel_del(wheel, entry);
+    }
+
+    usec = (uint64_t) timeout->tv_sec * 1000000 + (uint64_t) timeout->tv_usec;
+    tickusec = (uint64_t) wheel->tick.tv_sec * 1000000 + (uint64_t) wheel->tick.tv_usec;
+    ticks = (usec + tickusec - 1) / tickusec;
+    if (0 == ticks) {
+        ticks = 1;
+    }
+    /* a running timer is somewhere inside its current tick, so the next
+     * one comes sooner than a full tick from now - count it as nothing,
+     * or the entry could expire early */
+    if (wheel->ev_active) {
+        ++ticks;
+    }
+
+    entry->rounds = (size_t) ((ticks - 1) / wheel->nslots);
+    entry->pending = true;
+    append_entry(&wheel->slots[(wheel->cursor + ticks) & (wheel->nslots - 1)], entry);
+    ++wheel->npending;
+
+    if (NULL != wheel->evbase && !wheel->ev_active) {
+        pmix_event_add(&wheel->ev, &wheel->tick);
+        wheel->ev_active = true;
+    }
+}
+
+void pmix_timer_wheel_del(pmix_timer_wheel_t *wheel, pmix_timer_wheel_entry_t *entry)
+{
+    if (!entry->pending) {
+        return;
+    }
+    unlink_entry(entry);
+    entry->pending = false;
+    --wheel->npending;
+}
+
+size_t pmix_timer_wheel_tick(pmix_timer_wheel_t *wheel)
+{
+    pmix_timer_wheel_entry_t batch, *head, *entry, *next;
+    size_t nexpired = 0;
+
+    if (NULL == wheel->slots) {
+        return 0;
+    }
+    wheel->cursor = (wheel->cursor + 1) & (wheel->nslots - 1);
+    head = &wheel->slots[wheel->cursor];
+
+    /* Move everything that is due onto a private list before running
+     * any callback. A callback is free to add and delete entries, and
+     * one it adds for a full turn from now lands in this very slot - it
+     * must wait for that turn, not be expired on this pass. Entries on
+     * the batch stay pending until their turn comes, so a callback can
+     * still cancel one that fell due on the same tick. */
+    batch.next = &batch;
+    batch.prev = &batch;
+    for (entry = head->next; entry != head; entry = next) {
+        next = entry->next;
+        if (0 < entry->rounds) {
+            --entry->rounds;
+            continue;
+        }
+        unlink_entry(entry);
+        append_entry(&batch, entry);
+    }
+
+    while (batch.next != &batch) {
+        entry = batch.next;
+        pmix_timer_wheel_del(wheel, entry);
+        ++nexpired;
+        entry->cbfunc(entry, entry->cbdata);
+    }
+    return nexpired;
+}
+
+static void constructor(pmix_timer_wheel_t *wheel)
+{
+    wheel->evbase = NULL;
+    wheel->ev_active = false;
+    wheel->tick.tv_sec = 0;
+    wheel->tick.tv_usec = 0;
+    wheel->slots = NULL;
+    wheel->nslots = 0;
+    wheel->cursor = 0;
+    wheel->npending = 0;
+}
+
+static void destructor(pmix_timer_wheel_t *wheel)
+{
+    size_t n;
+    pmix_timer_wheel_entry_t *entry;
+
+    if (wheel->ev_active) {
+        pmix_event_del(&wheel->ev);
+        wheel->ev_active = false;
+    }
+    /* the entries belong to their owners, who may well outlive us -
+     * leave them looking disarmed rather than pointing into freed slots */
+    for (n = 0; n < wheel->nslots; n++) {
+        while (wheel->slots[n].next != &wheel->slots[n]) {
+            entry = wheel->slots[n].next;
+            pmix_timer_wheel_del(wheel, entry);
+        }
+    }
+    if (NULL != wheel->slots) {
+        free(wheel->slots);
+    }
+    constructor(wheel);
+}
+
+PMIX_CLASS_INSTANCE(pmix_timer_wheel_t, pmix_object_t, constructor, destructor);
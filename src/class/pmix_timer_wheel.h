@@ -0,0 +1,140 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * A hashed timing wheel: many timeouts, one event.
+ *
+ * Giving every timeout its own libevent timer puts each of them on the
+ * event library's heap, so arming and cancelling one costs a heap
+ * operation and a burst of them - a fault storm caching hundreds of
+ * notifications at once - churns the heap for every one. The wheel
+ * instead files each timeout in one of a ring of slots according to
+ * when it falls due, and keeps a single timer that fires once per tick
+ * while anything is pending. Each tick visits one slot and expires,
+ * as a batch, everything in it whose time has come. Arming and
+ * cancelling are constant-time list operations.
+ *
+ * The price is resolution: a timeout fires on the first tick at or
+ * after it falls due, so it may run up to one tick late, and never
+ * early. Pick the tick to suit the coarsest timeout that will be asked
+ * for - the wheel is meant for timeouts measured in seconds, not for
+ * anything that has to be punctual.
+ *
+ * Entries are embedded in the caller's own objects and are never
+ * allocated or freed by the wheel. An entry's callback may add or
+ * delete any entry - including itself, and including others that fall
+ * due on the same tick - as an entry is always taken off the wheel
+ * before its callback runs.
+ */
+
+#ifndef PMIX_TIMER_WHEEL_H
+#define PMIX_TIMER_WHEEL_H
+
+#include "src/include/pmix_config.h"
+
+#include "src/class/pmix_object.h"
+#include "src/include/pmix_types.h"
+#include <event.h>
+
+BEGIN_C_DECLS
+
+struct pmix_timer_wheel_entry_t;
+
+/* Invoked, on the wheel's event base, when an entry's timeout expires.
+ * The entry is no longer pending by then and may be re-added. */
+typedef void (*pmix_timer_wheel_cbfunc_t)(struct pmix_timer_wheel_entry_t *entry, void *cbdata);
+
+typedef struct pmix_timer_wheel_entry_t {
+    /* the slot (or the batch being expired) this entry is on */
+    struct pmix_timer_wheel_entry_t *next;
+    struct pmix_timer_wheel_entry_t *prev;
+    /* full turns of the wheel still to pass before it expires */
+    size_t rounds;
+    bool pending;
+    pmix_timer_wheel_cbfunc_t cbfunc;
+    void *cbdata;
+} pmix_timer_wheel_entry_t;
+
+typedef struct {
+    pmix_object_t super;
+    /* the base our timer runs on - NULL means nobody drives the wheel
+     * but the caller, through pmix_timer_wheel_tick() */
+    pmix_event_base_t *evbase;
+    pmix_event_t ev;
+    bool ev_active;
+    struct timeval tick;
+    /* ring of list heads, one per slot; nslots is a power of two */
+    pmix_timer_wheel_entry_t *slots;
+    size_t nslots;
+    /* the slot the last tick visited */
+    size_t cursor;
+    size_t npending;
+} pmix_timer_wheel_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_timer_wheel_t);
+
+/**
+ * Prepare an entry for use. Must be called once before the entry is
+ * first added; an entry that is not pending may be re-added at will.
+ */
+static inline void pmix_timer_wheel_entry_init(pmix_timer_wheel_entry_t *entry,
+                                               pmix_timer_wheel_cbfunc_t cbfunc, void *cbdata)
+{
+    entry->next = NULL;
+    entry->prev = NULL;
+    entry->rounds = 0;
+    entry->pending = false;
+    entry->cbfunc = cbfunc;
+    entry->cbdata = cbdata;
+}
+
+static inline bool pmix_timer_wheel_entry_pending(pmix_timer_wheel_entry_t *entry)
+{
+    return entry->pending;
+}
+
+/**
+ * Size the wheel. The tick is the wheel's resolution; nslots is rounded
+ * up to a power of two and should cover the longest common timeout in
+ * ticks, since a timeout longer than one full turn costs a visit per
+ * turn. Returns PMIX_ERR_BAD_PARAM for a zero tick or slot count, or if
+ * the wheel has entries pending.
+ */
+PMIX_EXPORT pmix_status_t pmix_timer_wheel_init(pmix_timer_wheel_t *wheel,
+                                                pmix_event_base_t *evbase,
+                                                const struct timeval *tick,
+                                                size_t nslots);
+
+/**
+ * Arm the entry to expire once the given time has passed, rounded up to
+ * whole ticks (and to at least one). An entry that is already pending
+ * is re-armed.
+ */
+PMIX_EXPORT void pmix_timer_wheel_add(pmix_timer_wheel_t *wheel,
+                                      pmix_timer_wheel_entry_t *entry,
+                                      const struct timeval *timeout);
+
+/**
+ * Disarm the entry. Harmless if it is not pending.
+ */
+PMIX_EXPORT void pmix_timer_wheel_del(pmix_timer_wheel_t *wheel,
+                                      pmix_timer_wheel_entry_t *entry);
+
+/**
+ * Advance the wheel by one tick and expire whatever falls due on it.
+ * The wheel's own timer calls this; it is exported so a wheel without
+ * an event base can be driven by hand. Returns the number of entries
+ * expired.
+ */
+PMIX_EXPORT size_t pmix_timer_wheel_tick(pmix_timer_wheel_t *wheel);
+
+END_C_DECLS
+
+#endif /* PMIX_TIMER_WHEEL_H */
@@ -78,6 +78,8 @@ static pmix_status_t process_values(pmix_cb_t *cb);
 
 static pmix_status_t refresh_cache(const pmix_proc_t *p);
 
+static pmix_status_t resolve_realm(pmix_cb_t *cb, pmix_get_logic_t *lg);
+
 /* A PMIX_QUALIFIED_VALUE kval carries the value the caller actually asked for
  * as the first element of a PMIX_INFO data array, with the qualifiers behind
  * it. Three places here unwrap that, and all three used to reach straight
@@ -353,19 +355,26 @@ static pmix_status_t process_request(const pmix_proc_t *proc, const char key[],
  * actual lookup underneath it - so for the module that can support it,
  * skipping the round trip is most of the operation.
  *
- * "Can support it" is the module's own claim, via is_tsafe. Today only
- * gds/shmem3 makes it, and only because its data lives in shared
- * segments that are immutable once a client can see them, its fetch
- * holds a reference to the tracker that owns those mappings, and a
- * client no longer writes to them at all (the segment is mprotect'd
- * read-only). None of that is true of gds/hash, whose tables the
- * progress thread mutates in place, and which correctly says so.
+ * "Can support it" is the module's own claim, via is_tsafe. gds/shmem3
+ * makes it because its data lives in shared segments that are immutable
+ * once a client can see them, its fetch holds a reference to the tracker
+ * that owns those mappings, and a client no longer writes to them at all
+ * (the segment is mprotect'd read-only). gds/hash makes it because every
+ * one of its entry points runs under a reader/writer lock: the progress
+ * thread still mutates its tables in place, but only while holding the
+ * lock for writing, and a fetch copies out what it finds before letting
+ * go of the lock for reading.
  *
  * The gating is deliberately narrow. Anything that would make this more
- * than a lookup - a cache refresh, a realm redirection, "give me
- * everything for this proc" - goes the ordinary way. A miss also goes
- * the ordinary way: this is a short-circuit, never a partial one, so
- * every path that could need the server still reaches it unchanged.
+ * than a lookup - a cache refresh, "give me everything for this proc" -
+ * goes the ordinary way. A miss also goes the ordinary way: this is a
+ * short-circuit, never a partial one, so every path that could need the
+ * server still reaches it unchanged.
+ *
+ * Session-, node- and app-realm requests are resolved here as well, as
+ * long as both stores resolve_realm() may consult are safe to read from
+ * this thread - working out the realm is only more fetches. They are
+ * also the bulk of what an application asks for at startup.
  *
  * Returns true only when "cb" now holds the answer.
  */
@@ -377,14 +386,8 @@ static bool try_local_fetch(pmix_cb_t *cb, pmix_get_logic_t *lg)
         return false;
     }
     /* A NULL key is "everything this proc put", which is an aggregate
-     * across scopes rather than a lookup; the realm directives send the
-     * request somewhere other than the proc's own data, and resolving
-     * them takes further fetches and an info-array rebuild that belong
-     * on the progress thread. */
-    if (NULL == cb->key || lg->refresh_cache || lg->nodeinfo || lg->appinfo
-        || lg->sessioninfo || lg->nodedirective || lg->appdirective
-        || lg->sessiondirective || NULL != lg->hostname
-        || UINT32_MAX != lg->nodeid) {
+     * across scopes rather than a lookup */
+    if (NULL == cb->key || lg->refresh_cache) {
         return false;
     }
     if (pmix_client_globals.singleton
@@ -402,6 +405,19 @@ static bool try_local_fetch(pmix_cb_t *cb, pmix_get_logic_t *lg)
 
     cb->proc = &lg->p;
     cb->scope = lg->scope;
+    if (!lg->resolved) {
+        /* the realm lookups also read our own peer's store */
+        PMIX_GDS_FETCH_IS_TSAFE(rc, pmix_globals.mypeer);
+        if (PMIX_SUCCESS != rc) {
+            return false;
+        }
+        rc = resolve_realm(cb, lg);
+        if (PMIX_OPERATION_SUCCEEDED == rc) {
+            /* answered - or refused - outright, exactly as get_data()
+             * would have */
+            return true;
+        }
+    }
     PMIX_GDS_FETCH_KV(rc, pmix_client_globals.myserver, cb);
     if (PMIX_SUCCESS != rc) {
         /* Nothing found, or something we do not handle here. Drop
@@ -507,8 +523,8 @@ PMIX_EXPORT pmix_status_t PMIx_Get(const pmix_proc_t *proc, const char key[],
     cb->cbdata = cb;
 
     /* If the store can be read from here, do that and skip the round
-     * trip entirely. On anything other than a hit this falls through
-     * untouched. */
+     * trip entirely. On anything other than a final answer this falls
+     * through to the progress thread. */
     if (try_local_fetch(cb, lg)) {
         rc = cb->status;
         goto answered;
@@ -662,6 +678,296 @@ PMIX_EXPORT pmix_status_t PMIx_Get_nb(const pmix_proc_t *proc, const char key[],
     return rc;
 }
 
+/* Tracker for a PMIx_Get_multi. Each rank that could not be answered on
+ * the caller's thread gets an ordinary get caddy, resolved by get_data()
+ * exactly as a PMIx_Get for that rank would be - so the realm handling,
+ * the server request and the coalescing against pending_requests are all
+ * the existing ones. What the tracker adds is that every one of those
+ * caddies is launched from a single event, and the caller is woken once,
+ * when the last of them completes. */
+struct pmix_get_multi_t;
+
+typedef struct {
+    struct pmix_get_multi_t *mg;
+    pmix_cb_t *cb;
+    pmix_status_t status;
+} pmix_get_multi_req_t;
+
+typedef struct pmix_get_multi_t {
+    pmix_object_t super;
+    pmix_event_t ev;
+    pmix_lock_t lock;
+    /* one slot per rank - "cb" is NULL for a rank already answered */
+    pmix_get_multi_req_t *reqs;
+    size_t nreqs;
+    /* only ever touched on the progress thread */
+    size_t npending;
+} pmix_get_multi_t;
+
+static void mgcon(pmix_get_multi_t *p)
+{
+    PMIX_CONSTRUCT_LOCK(&p->lock);
+    p->reqs = NULL;
+    p->nreqs = 0;
+    p->npending = 0;
+}
+static void mgdes(pmix_get_multi_t *p)
+{
+    size_t n;
+
+    PMIX_DESTRUCT_LOCK(&p->lock);
+    for (n = 0; n < p->nreqs; n++) {
+        if (NULL == p->reqs[n].cb) {
+            continue;
+        }
+        /* the caddy destructor touches neither of these */
+        if (NULL != p->reqs[n].cb->value) {
+            PMIX_VALUE_RELEASE(p->reqs[n].cb->value);
+        }
+        if (NULL != p->reqs[n].cb->lg) {
+            PMIX_RELEASE(p->reqs[n].cb->lg);
+        }
+        PMIX_RELEASE(p->reqs[n].cb);
+    }
+    if (NULL != p->reqs) {
+        free(p->reqs);
+    }
+}
+static PMIX_CLASS_INSTANCE(pmix_get_multi_t,
+                           pmix_object_t,
+                           mgcon, mgdes);
+
+static void mget_release(pmix_get_multi_t *mg)
+{
+    --mg->npending;
+    if (0 == mg->npending) {
+        /* nothing may touch "mg" after this - the caller is free to
+         * release it the moment it wakes */
+        PMIX_POST_OBJECT(mg);
+        PMIX_WAKEUP_THREAD(&mg->lock);
+    }
+}
+
+static void mget_cbfunc(pmix_status_t status, pmix_value_t *kv, void *cbdata)
+{
+    pmix_get_multi_req_t *req = (pmix_get_multi_req_t *) cbdata;
+    PMIX_HIDE_UNUSED_PARAMS(kv);
+
+    /* both callers hand us the value they left in cb->value, so it is
+     * already where it will be collected from - only the status has to
+     * be kept, as the server-response path does not record it */
+    req->status = status;
+    mget_release(req->mg);
+}
+
+static void mget_data(int sd, short args, void *cbdata)
+{
+    pmix_get_multi_t *mg = (pmix_get_multi_t *) cbdata;
+    size_t n;
+    PMIX_HIDE_UNUSED_PARAMS(sd, args);
+
+    PMIX_ACQUIRE_OBJECT(mg);
+    /* hold a count of our own across the launch loop: a request that is
+     * answered from the local store completes inside get_data(), and if
+     * the last of them did so the caller could be woken - and release
+     * the tracker - while we are still walking it */
+    mg->npending = 1;
+    for (n = 0; n < mg->nreqs; n++) {
+        if (NULL == mg->reqs[n].cb) {
+            continue;
+        }
+        ++mg->npending;
+        get_data(0, 0, mg->reqs[n].cb);
+    }
+    mget_release(mg);
+}
+
+/* Move a standalone value into a slot of the result array. Every value
+ * reaching here was allocated on its own and is owned by us, so the
+ * contents can simply be taken over and the shell freed - which is
+ * exactly what PMIX_VALUE_RELEASE would do after a deep copy, without
+ * the copy. */
+static void mget_store(pmix_value_t *dst, pmix_value_t *src)
+{
+    memcpy(dst, src, sizeof(pmix_value_t));
+    free(src);
+}
+
+PMIX_EXPORT pmix_status_t PMIx_Get_multi(const pmix_nspace_t nspace,
+                                         const pmix_rank_t ranks[], size_t nranks,
+                                         const char key[],
+                                         const pmix_info_t info[], size_t ninfo,
+                                         pmix_value_t **values)
+{
+    pmix_get_multi_t *mg;
+    pmix_get_logic_t *lg;
+    pmix_cb_t *cb;
+    pmix_value_t *vals, *val;
+    pmix_proc_t proc;
+    pmix_status_t rc, ret = PMIX_ERR_NOT_FOUND;
+    size_t n, nfound = 0;
+    bool launch = false;
+
+    pmix_output_verbose(2, pmix_client_globals.get_output,
+                        "pmix:client get_multi for %lu ranks key %s",
+                        (unsigned long) nranks, (NULL == key) ? "NULL" : key);
+
+    if (PMIX_UNLIKELY(!pmix_atomic_check_bool(&pmix_globals.initialized))) {
+        return PMIX_ERR_INIT;
+    }
+
+    /* a NULL key asks for everything a proc put, which PMIx_Get returns
+     * as a single aggregate - there is nothing to batch about that */
+    if (PMIX_UNLIKELY(NULL == values || NULL == ranks || 0 == nranks || NULL == key)) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    *values = NULL;
+
+    if (PMIX_UNLIKELY(pmix_atomic_check_bool(&pmix_globals.progress_thread_stopped))) {
+        return PMIX_ERR_NOT_AVAILABLE;
+    }
+
+    if (PMIX_MAX_KEYLEN < pmix_keylen(key)) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+
+    /* the answers come back as one array we allocate, so neither a
+     * pointer into the store nor caller-provided storage makes sense */
+    for (n = 0; n < ninfo; n++) {
+        if (PMIX_CHECK_KEY(&info[n], PMIX_GET_POINTER_VALUES) ||
+            PMIX_CHECK_KEY(&info[n], PMIX_GET_STATIC_VALUES)) {
+            if (PMIX_INFO_TRUE(&info[n])) {
+                return PMIX_ERR_NOT_SUPPORTED;
+            }
+        }
+    }
+
+    if (pmix_progress_thread_check_blocking("PMIx_Get_multi")) {
+        return PMIX_ERR_WOULD_BLOCK;
+    }
+
+    PMIX_VALUE_CREATE(vals, nranks);
+    if (PMIX_UNLIKELY(NULL == vals)) {
+        return PMIX_ERR_NOMEM;
+    }
+    mg = PMIX_NEW(pmix_get_multi_t);
+    mg->reqs = (pmix_get_multi_req_t *) calloc(nranks, sizeof(pmix_get_multi_req_t));
+    if (PMIX_UNLIKELY(NULL == mg->reqs)) {
+        PMIX_RELEASE(mg);
+        PMIX_VALUE_FREE(vals, nranks);
+        return PMIX_ERR_NOMEM;
+    }
+    mg->nreqs = nranks;
+
+    /* first pass, on our own thread: parse each request and answer
+     * whatever can be answered here - the requests process_request()
+     * resolves outright, and local hits in a store that permits it */
+    for (n = 0; n < nranks; n++) {
+        mg->reqs[n].mg = mg;
+        mg->reqs[n].status = PMIX_ERR_NOT_FOUND;
+        PMIX_LOAD_PROCID(&proc, nspace, ranks[n]);
+        lg = PMIX_NEW(pmix_get_logic_t);
+        val = NULL;
+        rc = process_request(&proc, key, info, ninfo, lg, &val);
+        if (PMIX_OPERATION_SUCCEEDED == rc) {
+            mget_store(&vals[n], val);
+            mg->reqs[n].status = PMIX_SUCCESS;
+            PMIX_RELEASE(lg);
+            continue;
+        } else if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            PMIX_RELEASE(lg);
+            if (PMIX_ERR_BAD_PARAM == rc) {
+                /* the directives are shared by every rank, so this
+                 * would be the answer for all of them */
+                PMIX_RELEASE(mg);
+                PMIX_VALUE_FREE(vals, nranks);
+                return rc;
+            }
+            mg->reqs[n].status = rc;
+            continue;
+        }
+        if (lg->refresh_cache) {
+            rc = refresh_cache(&lg->p);
+            if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+                PMIX_RELEASE(lg);
+                mg->reqs[n].status = rc;
+                continue;
+            }
+        }
+
+        cb = PMIX_NEW(pmix_cb_t);
+        cb->lg = lg;
+        cb->key = (char *) key;
+        cb->info = (pmix_info_t *) info;
+        cb->ninfo = ninfo;
+        cb->cbfunc.valuefn = mget_cbfunc;
+        cb->cbdata = &mg->reqs[n];
+        if (try_local_fetch(cb, lg)) {
+            /* a realm request can be refused outright, too */
+            if (PMIX_SUCCESS == cb->status && NULL != cb->value) {
+                mget_store(&vals[n], cb->value);
+                cb->value = NULL;
+            } else if (PMIX_SUCCESS == cb->status) {
+                cb->status = PMIX_ERR_NOT_FOUND;
+            }
+            mg->reqs[n].status = cb->status;
+            PMIX_RELEASE(lg);
+            PMIX_RELEASE(cb);
+            continue;
+        }
+        mg->reqs[n].cb = cb;
+        launch = true;
+    }
+
+    /* everything else goes over in one shift, and is in flight together
+     * before we wait on any of it */
+    if (launch) {
+        PMIX_THREADSHIFT(mg, mget_data);
+        PMIX_WAIT_THREAD(&mg->lock);
+        PMIX_ACQUIRE_OBJECT(mg);
+    }
+
+    for (n = 0; n < nranks; n++) {
+        cb = mg->reqs[n].cb;
+        if (NULL != cb) {
+            if (PMIX_OPERATION_SUCCEEDED == mg->reqs[n].status) {
+                mg->reqs[n].status = PMIX_SUCCESS;
+            }
+            if (PMIX_SUCCESS == mg->reqs[n].status && NULL != cb->value) {
+                mget_store(&vals[n], cb->value);
+                cb->value = NULL;
+            } else if (PMIX_SUCCESS == mg->reqs[n].status) {
+                mg->reqs[n].status = PMIX_ERR_NOT_FOUND;
+            }
+        }
+        if (PMIX_SUCCESS == mg->reqs[n].status) {
+            ++nfound;
+        } else if (PMIX_ERR_NOT_FOUND == ret) {
+            /* report the first failure that says more than "not found" */
+            ret = mg->reqs[n].status;
+        }
+    }
+    PMIX_RELEASE(mg);
+
+    if (nfound == nranks) {
+        rc = PMIX_SUCCESS;
+    } else if (0 < nfound) {
+        rc = PMIX_ERR_PARTIAL_SUCCESS;
+    } else {
+        PMIX_VALUE_FREE(vals, nranks);
+        vals = NULL;
+        rc = ret;
+    }
+    *values = vals;
+
+    pmix_output_verbose(2, pmix_client_globals.get_output,
+                        "pmix:client get_multi completed with status %s (%lu of %lu found)",
+                        PMIx_Error_string(rc), (unsigned long) nfound,
+                        (unsigned long) nranks);
+
+    return rc;
+}
+
 static void _value_cbfunc(pmix_status_t status, pmix_value_t *kv, void *cbdata)
 {
     pmix_cb_t *cb;
@@ -1001,32 +1307,28 @@ static pmix_status_t process_values(pmix_cb_t *cb)
     return PMIX_SUCCESS;
 }
 
-static void get_data(int sd, short args, void *cbdata)
+/* Turn a session-, node- or app-realm request into the plain fetch that
+ * answers it: work out which session, node or app is meant - which may
+ * itself take fetches, e.g. of the target's hostname - and rebuild the
+ * qualifiers to name it. A request for the realm's identifier is answered
+ * outright. Nothing here leaves this process, so it is equally valid on
+ * the progress thread and, against a store that permits it, on the
+ * caller's; "lg->resolved" records that it has been done, so a request
+ * that was resolved on the caller's thread and then missed is not
+ * resolved a second time against its own rebuilt qualifiers.
+ *
+ * Returns PMIX_OPERATION_SUCCEEDED when cb->status (and cb->value) hold
+ * the final answer, PMIX_SUCCESS when cb is ready to be fetched. */
+static pmix_status_t resolve_realm(pmix_cb_t *cb, pmix_get_logic_t *lg)
 {
-    pmix_cb_t *cb, cb2;
-    pmix_cb_t *cbret;
-    pmix_buffer_t *msg;
+    pmix_cb_t cb2;
     pmix_status_t rc;
-    pmix_proc_t proc;
-    pmix_get_logic_t *lg;
     pmix_info_t optional, *iptr;
     size_t nfo, n;
     pmix_kval_t *kv;
-    PMIX_HIDE_UNUSED_PARAMS(sd, args);
 
-    cb = (pmix_cb_t*)cbdata;
-    PMIX_ACQUIRE_OBJECT(cb);
-    lg = cb->lg;
     iptr = cb->info;
     nfo = cb->ninfo;
-
-    pmix_output_verbose(2, pmix_client_globals.get_output,
-                        "pmix:client:get_data value for proc %s key %s",
-                        PMIX_NAME_PRINT(&lg->p), (NULL == cb->key) ? "NULL" : cb->key);
-
-    /* check the data provided to us by the server first */
-    cb->proc = &lg->p;
-    cb->scope = lg->scope;
     PMIX_INFO_LOAD(&optional, PMIX_OPTIONAL, NULL, PMIX_BOOL);
 
     if (lg->nodeinfo) {
@@ -1101,7 +1403,7 @@ static void get_data(int sd, short args, void *cbdata)
                         }
                         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                             cb->status = rc;
-                            goto done;
+                            return PMIX_OPERATION_SUCCEEDED;
                         }
                     } else {
                         /* see the hostname fetch above - the caddy must be
@@ -1129,7 +1431,7 @@ static void get_data(int sd, short args, void *cbdata)
             } else {
                 cb->status = PMIX_ERR_NOT_FOUND;
             }
-            goto done;
+            return PMIX_OPERATION_SUCCEEDED;
         }
         /* if they were asking for nodeid, then we are done */
         if (PMIx_Check_key(cb->key, PMIX_NODEID)) {
@@ -1140,7 +1442,7 @@ static void get_data(int sd, short args, void *cbdata)
             } else {
                 cb->status = PMIX_ERR_NOT_FOUND;
             }
-            goto done;
+            return PMIX_OPERATION_SUCCEEDED;
         }
         /* we have to look for the info, so we need to tell the GDS
          * that this is a nodeinfo request and pass the
@@ -1203,13 +1505,13 @@ static void get_data(int sd, short args, void *cbdata)
                         PMIX_DESTRUCT(&cb2);
                         if (PMIX_UNLIKELY(NULL == kv)) { // should never happen
                             cb->status = PMIX_ERR_NOT_FOUND;
-                            goto done;
+                            return PMIX_OPERATION_SUCCEEDED;
                         }
                         rc = PMIx_Value_get_number(kv->value, &lg->appnum, PMIX_UINT32);
                         PMIX_RELEASE(kv);
                         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                             cb->status = rc;
-                            goto done;
+                            return PMIX_OPERATION_SUCCEEDED;
                         }
                     } else {
                         /* couldn't find this proc's appnum - nothing we can do.
@@ -1217,7 +1519,7 @@ static void get_data(int sd, short args, void *cbdata)
                          * above, whose failure path had the same hole */
                         PMIX_DESTRUCT(&cb2);
                         cb->status = PMIX_ERR_NOT_FOUND;
-                        goto done;
+                        return PMIX_OPERATION_SUCCEEDED;
                     }
                 }
                 // set the rank to undefined since this request is
@@ -1236,7 +1538,7 @@ static void get_data(int sd, short args, void *cbdata)
             cb->status = PMIX_SUCCESS;
             PMIX_VALUE_CREATE(cb->value, 1);
             PMIX_VALUE_LOAD(cb->value, &lg->appnum, PMIX_UINT32);
-            goto done;
+            return PMIX_OPERATION_SUCCEEDED;
         }
         /* setup the request */
         if (lg->appdirective) {
@@ -1285,13 +1587,13 @@ static void get_data(int sd, short args, void *cbdata)
                         PMIX_DESTRUCT(&cb2);
                         if (PMIX_UNLIKELY(NULL == kv)) { // should never happen
                             cb->status = PMIX_ERR_NOT_FOUND;
-                            goto done;
+                            return PMIX_OPERATION_SUCCEEDED;
                         }
                         rc = PMIx_Value_get_number(kv->value, &lg->sessionid, PMIX_UINT32);
                         PMIX_RELEASE(kv);
                         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                             cb->status = rc;
-                            goto done;
+                            return PMIX_OPERATION_SUCCEEDED;
                         }
                     } else {
                         /* the fetch failed, so the caddy still has to come
@@ -1314,7 +1616,7 @@ static void get_data(int sd, short args, void *cbdata)
             cb->status = PMIX_SUCCESS;
             PMIX_VALUE_CREATE(cb->value, 1);
             PMIX_VALUE_LOAD(cb->value, &lg->sessionid, PMIX_UINT32);
-            goto done;
+            return PMIX_OPERATION_SUCCEEDED;
         }
         /* setup the request */
         if (lg->sessiondirective) {
@@ -1345,6 +1647,39 @@ static void get_data(int sd, short args, void *cbdata)
 doget:
     cb->info = iptr;
     cb->ninfo = nfo;
+    lg->resolved = true;
+    return PMIX_SUCCESS;
+}
+
+static void get_data(int sd, short args, void *cbdata)
+{
+    pmix_cb_t *cb;
+    pmix_cb_t *cbret;
+    pmix_buffer_t *msg;
+    pmix_status_t rc;
+    pmix_proc_t proc;
+    pmix_get_logic_t *lg;
+    PMIX_HIDE_UNUSED_PARAMS(sd, args);
+
+    cb = (pmix_cb_t*)cbdata;
+    PMIX_ACQUIRE_OBJECT(cb);
+    lg = cb->lg;
+
+    pmix_output_verbose(2, pmix_client_globals.get_output,
+                        "pmix:client:get_data value for proc %s key %s",
+                        PMIX_NAME_PRINT(&lg->p), (NULL == cb->key) ? "NULL" : cb->key);
+
+    /* check the data provided to us by the server first */
+    cb->proc = &lg->p;
+    cb->scope = lg->scope;
+
+    if (!lg->resolved) {
+        rc = resolve_realm(cb, lg);
+        if (PMIX_OPERATION_SUCCEEDED == rc) {
+            goto done;
+        }
+    }
+
     PMIX_GDS_FETCH_KV(rc, pmix_client_globals.myserver, cb);
     if (PMIX_SUCCESS == rc) {
         pmix_output_verbose(5, pmix_client_globals.get_output,
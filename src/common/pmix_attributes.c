@@ -630,6 +630,7 @@ static pmix_attr_init_t client_fns[] = {
                          "PMIX_NODEID",
                          "PMIX_HOSTNAME",
                          "PMIX_QUERY_NODE_RESOURCE_USAGE",
+                         "PMIX_QUERY_GDS_USAGE",
                          "PMIX_JOBID",
                          "PMIX_DAEMON_MEMORY",
                          "PMIX_CLIENT_AVG_MEMORY",
@@ -722,6 +723,7 @@ static pmix_attr_init_t client_fns[] = {
                          "PMIX_NODEID",
                          "PMIX_HOSTNAME",
                          "PMIX_QUERY_NODE_RESOURCE_USAGE",
+                         "PMIX_QUERY_GDS_USAGE",
                          "PMIX_JOBID",
                          "PMIX_DAEMON_MEMORY",
                          "PMIX_CLIENT_AVG_MEMORY",
@@ -1079,6 +1081,7 @@ static pmix_attr_init_t server_fns[] = {
                          "PMIX_ALLOW_CLIENT_CLONES",
                          "PMIX_TOPOLOGY2",
                          "PMIX_SERVER_SHARE_TOPOLOGY",
+                         "PMIX_SERVER_DMODEX_BATCH",
                          "PMIX_HOMOGENEOUS_SYSTEM",
                          "PMIX_SERVER_ENABLE_MONITORING",
                          "PMIX_EXTERNAL_PROGRESS",
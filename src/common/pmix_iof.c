@@ -2125,7 +2125,7 @@ static pmix_status_t write_output(const pmix_proc_t *name,
     pmix_byte_object_t bopass;
     pmix_iof_write_event_t *channel;
     pmix_iof_flags_t myflags;
-    pmix_namespace_t *nptr, *ns;
+    pmix_namespace_t *nptr;
     bool outputio;
     bool copystdout = false;
     bool copystderr = false;
@@ -2141,14 +2141,7 @@ static pmix_status_t write_output(const pmix_proc_t *name,
     }
 
     /* find the nspace for this source */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t)
-    {
-        if (0 == strcmp(ns->nspace, name->nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(name->nspace);
 
     channel = NULL;
     /* default outputio to our flag */
@@ -25,6 +25,7 @@
 
 #include "src/common/pmix_attributes.h"
 #include "src/mca/bfrops/bfrops.h"
+#include "src/mca/gds/base/base.h"
 #include "src/mca/ptl/base/base.h"
 #include "src/threads/pmix_threads.h"
 #include "src/util/pmix_argv.h"
@@ -242,20 +243,91 @@ static void finalstep(pmix_status_t status, pmix_info_t info[], size_t ninfo, vo
     return;
 }
 
+/* The host's answer to a set of queries that may be asked again: keep
+ * a successful one in the server's query cache before passing it on.
+ * The host may answer from any thread of its own, and the cache is
+ * ours, so the answer is shifted onto our thread first - the host's
+ * info stays valid until finalstep hands it back. The unresolved
+ * queries are still in the caddy, so the key is rebuilt from them
+ * rather than carried across. */
+static void cache_answer(int sd, short args, void *cbdata)
+{
+    pmix_shift_caddy_t *scd = (pmix_shift_caddy_t *) cbdata;
+    pmix_query_caddy_t *cd = (pmix_query_caddy_t *) scd->cbdata;
+    unsigned int ttl;
+    bool refresh;
+    char *key;
+    PMIX_HIDE_UNUSED_PARAMS(sd, args);
+
+    PMIX_ACQUIRE_OBJECT(scd);
+
+    if (PMIX_SUCCESS == scd->status) {
+        key = pmix_server_query_cache_key(cd->queries, cd->nqueries, &ttl, &refresh);
+        if (NULL != key) {
+            pmix_server_query_cache_store(key, ttl, scd->info, scd->ninfo);
+        }
+    }
+    finalstep(scd->status, scd->info, scd->ninfo, cd, scd->cbfunc.relfn, scd->relcbdata);
+    PMIX_RELEASE(scd);
+}
+
+static void cachestep(pmix_status_t status, pmix_info_t info[], size_t ninfo, void *cbdata,
+                      pmix_release_cbfunc_t release_fn, void *release_cbdata)
+{
+    pmix_shift_caddy_t *scd;
+
+    scd = PMIX_NEW(pmix_shift_caddy_t);
+    if (NULL == scd) {
+        /* the answer is still good - it just is not kept */
+        finalstep(status, info, ninfo, cbdata, release_fn, release_cbdata);
+        return;
+    }
+    scd->status = status;
+    scd->info = info;
+    scd->ninfo = ninfo;
+    scd->cbfunc.relfn = release_fn;
+    scd->relcbdata = release_cbdata;
+    scd->cbdata = cbdata;
+    PMIX_THREADSHIFT(scd, cache_answer);
+}
+
 static pmix_status_t request_help(pmix_query_caddy_t *cd)
 {
     pmix_status_t rc;
+    pmix_query_reply_t *qr = NULL;
+    unsigned int ttl;
+    bool refresh, cacheable;
+    char *key;
 
     /* if our host has support, then we just issue the query and
      * return the response - but don't pass it back to the host
      * is the host is a server as that would be a loopback */
     if (!cd->host_called && NULL != pmix_host_server.query) {
+        cd->host_called = true;
+        /* the host may have answered this very set lately */
+        key = pmix_server_query_cache_key(cd->queries, cd->nqueries, &ttl, &refresh);
+        cacheable = (NULL != key);
+        if (cacheable) {
+            if (!refresh) {
+                qr = pmix_server_query_cache_fetch(key);
+            }
+            free(key);
+            if (NULL != qr) {
+                pmix_output_verbose(2, pmix_globals.debug_output,
+                                    "pmix:query answered from cache");
+                /* finalstep copies the answer out, but the callback it
+                 * makes could reach the cache - hold the entry meanwhile */
+                PMIX_RETAIN(qr);
+                finalstep(PMIX_SUCCESS, qr->info, qr->ninfo, cd, NULL, NULL);
+                PMIX_RELEASE(qr);
+                return PMIX_SUCCESS;
+            }
+        }
         pmix_output_verbose(2, pmix_globals.debug_output,
                             "pmix:query handed to RM");
-        cd->host_called = true;
         rc = pmix_host_server.query(&pmix_globals.myid,
                                     cd->queries, cd->nqueries,
-                                    finalstep, (void*)cd);
+                                    cacheable ? cachestep : finalstep, (void*)cd);
         return rc;
     }
 
@@ -269,6 +341,47 @@ static pmix_status_t request_help(pmix_query_caddy_t *cd)
     return rc;
 }
 
+/* Answer PMIX_QUERY_GDS_USAGE from our own datastore, leaving the one
+ * result in kvs exactly as a local fetch would have. PMIX_ERR_NOT_FOUND
+ * means we hold nothing to report on - a tool, or a client on gds/hash -
+ * and the query goes up to the server like any other miss. */
+static pmix_status_t query_gds_usage(const char *nspace, pmix_list_t *kvs)
+{
+    pmix_list_t usage;
+    pmix_kval_t *kv, *ukv;
+    pmix_data_array_t *darray;
+    pmix_info_t *iptr;
+    pmix_status_t rc;
+    size_t n;
+
+    PMIX_CONSTRUCT(&usage, pmix_list_t);
+    rc = pmix_gds_base_report_usage(nspace, &usage);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_LIST_DESTRUCT(&usage);
+        return rc;
+    }
+    PMIX_DATA_ARRAY_CREATE(darray, pmix_list_get_size(&usage), PMIX_INFO);
+    iptr = (pmix_info_t *) darray->array;
+    n = 0;
+    PMIX_LIST_FOREACH (ukv, &usage, pmix_kval_t) {
+        PMIX_LOAD_KEY(iptr[n].key, ukv->key);
+        rc = PMIx_Value_xfer(&iptr[n].value, ukv->value);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_DATA_ARRAY_FREE(darray);
+            PMIX_LIST_DESTRUCT(&usage);
+            return rc;
+        }
+        ++n;
+    }
+    PMIX_LIST_DESTRUCT(&usage);
+
+    PMIX_KVAL_NEW(kv, PMIX_QUERY_GDS_USAGE);
+    kv->value->type = PMIX_DATA_ARRAY;
+    kv->value->data.darray = darray;
+    pmix_list_append(kvs, &kv->super);
+    return PMIX_SUCCESS;
+}
+
 static void _local_relcb(void *cbdata)
 {
     pmix_query_caddy_t *cd = (pmix_query_caddy_t *) cbdata;
@@ -392,7 +505,12 @@ void pmix_parse_localquery(int sd, short args, void *cbdata)
                 return;
 
             } else {
-                PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+                if (0 == strcmp(queries[n].keys[p], PMIX_QUERY_GDS_USAGE)) {
+                    rc = query_gds_usage((0 < strlen(proc.nspace)) ? proc.nspace : NULL,
+                                         &cb.kvs);
+                } else {
+                    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+                }
                 if (PMIX_SUCCESS == rc) {
                     /* need to retain this result */
                     PMIX_LIST_FOREACH_SAFE (kv, kvnxt, &cb.kvs, pmix_kval_t) {
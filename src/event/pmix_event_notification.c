@@ -25,6 +25,7 @@
 #include "src/runtime/pmix_progress_threads.h"
 #include "src/util/pmix_output.h"
 
+#include "src/class/pmix_hash_table.h"
 #include "src/client/pmix_client_ops.h"
 #include "src/include/pmix_globals.h"
 #include "src/mca/bfrops/bfrops.h"
@@ -171,6 +172,78 @@ static void notify_event_cbfunc(struct pmix_peer_t *pr,
     PMIX_RELEASE(cb);
 }
 
+/* Cached notifications are also filed by status, so a handler that
+ * registers for a few codes is offered the cached events with those
+ * codes without our knocking on every room in the hotel - which, with
+ * the cache sized for a fault storm, is most of the work of every
+ * registration. Notifications with the same status are chained through
+ * index_next from the one the index holds, oldest first, so a late
+ * handler is offered them in the order they happened. index_prev links
+ * back the other way, and the oldest one's points at the newest - the
+ * tail - so a new arrival is appended without walking the chain and one
+ * can be unfiled without walking its siblings: a storm caches hundreds
+ * of PROC_TERMINATED events under one status. index_prev is NULL only
+ * on a notification that is not in the index. */
+static void index_cached(pmix_notify_caddy_t *cd)
+{
+    pmix_notify_caddy_t *head = NULL, *tail;
+    pmix_status_t rc;
+
+    (void) pmix_hash_table_get_value_uint32(&pmix_globals.notifications_index,
+                                            (uint32_t) cd->status, (void **) &head);
+    cd->index_next = NULL;
+    if (NULL != head) {
+        tail = head->index_prev;
+        tail->index_next = cd;
+        cd->index_prev = tail;
+        head->index_prev = cd;
+        return;
+    }
+    rc = pmix_hash_table_set_value_uint32(&pmix_globals.notifications_index,
+                                          (uint32_t) cd->status, cd);
+    if (PMIX_SUCCESS != rc) {
+        /* it is cached all the same, and anything that scans the rooms
+         * will find it - only a lookup by status will not */
+        PMIX_ERROR_LOG(rc);
+        cd->index_prev = NULL;
+        return;
+    }
+    cd->index_prev = cd;
+}
+
+static void unindex_cached(pmix_notify_caddy_t *cd)
+{
+    pmix_notify_caddy_t *head = NULL;
+
+    if (NULL == cd->index_prev) {
+        /* never made it into the index */
+        return;
+    }
+    (void) pmix_hash_table_get_value_uint32(&pmix_globals.notifications_index,
+                                            (uint32_t) cd->status, (void **) &head);
+    if (head == cd) {
+        if (NULL != cd->index_next) {
+            /* the next oldest takes over, and with it the tail */
+            cd->index_next->index_prev = cd->index_prev;
+            pmix_hash_table_set_value_uint32(&pmix_globals.notifications_index,
+                                             (uint32_t) cd->status, cd->index_next);
+        } else {
+            pmix_hash_table_remove_value_uint32(&pmix_globals.notifications_index,
+                                                (uint32_t) cd->status);
+        }
+    } else {
+        cd->index_prev->index_next = cd->index_next;
+        if (NULL != cd->index_next) {
+            cd->index_next->index_prev = cd->index_prev;
+        } else if (NULL != head) {
+            /* it was the tail */
+            head->index_prev = cd->index_prev;
+        }
+    }
+    cd->index_next = NULL;
+    cd->index_prev = NULL;
+}
+
 pmix_status_t pmix_notify_event_cache(pmix_notify_caddy_t *cd)
 {
     pmix_status_t rc;
@@ -191,6 +264,7 @@ pmix_status_t pmix_notify_event_cache(pmix_notify_caddy_t *cd)
             if (NULL == pk) {
                 /* hey, there is room! */
                 pmix_hotel_checkin_with_res(&pmix_globals.notifications, cd, &cd->room);
+                index_cached(cd);
                 return PMIX_SUCCESS;
             }
             /* check the age */
@@ -206,15 +280,92 @@ pmix_status_t pmix_notify_event_cache(pmix_notify_caddy_t *cd)
         }
         if (0 <= idx) {
             /* we found the oldest occupant - evict it */
-            pmix_hotel_checkout_and_return_occupant(&pmix_globals.notifications, idx,
-                                                    (void **) &pk);
+            pmix_hotel_knock(&pmix_globals.notifications, idx, (void **) &pk);
+            pmix_notify_event_uncache(pk);
             PMIX_RELEASE(pk);
             rc = pmix_hotel_checkin(&pmix_globals.notifications, cd, &cd->room);
         }
     }
+    if (PMIX_SUCCESS == rc) {
+        index_cached(cd);
+    }
     return rc;
 }
 
+void pmix_notify_event_uncache(pmix_notify_caddy_t *cd)
+{
+    pmix_notify_caddy_t *occupant;
+
+    if (0 > cd->room) {
+        return;
+    }
+    /* the hotel empties the room itself when it evicts an occupant, and
+     * the room may have been let again since - only check out what is
+     * actually ours */
+    pmix_hotel_knock(&pmix_globals.notifications, cd->room, (void **) &occupant);
+    if (occupant == cd) {
+        pmix_hotel_checkout(&pmix_globals.notifications, cd->room);
+    }
+    unindex_cached(cd);
+    cd->room = -1;
+}
+
+size_t pmix_notify_event_lookup(pmix_status_t *codes, size_t ncodes, pmix_notify_caddy_t ***cds)
+{
+    pmix_notify_caddy_t **array, *cd;
+    size_t n, k, nfound = 0, nalloc;
+    int j;
+
+    *cds = NULL;
+    nalloc = (size_t) pmix_globals.max_events;
+    if (0 == nalloc || pmix_hotel_is_empty(&pmix_globals.notifications)) {
+        return 0;
+    }
+    array = (pmix_notify_caddy_t **) malloc(nalloc * sizeof(pmix_notify_caddy_t *));
+    if (NULL == array) {
+        PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+        return 0;
+    }
+
+    if (NULL == codes) {
+        for (j = 0; j < pmix_globals.max_events; j++) {
+            pmix_hotel_knock(&pmix_globals.notifications, j, (void **) &cd);
+            if (NULL != cd) {
+                PMIX_RETAIN(cd);
+                array[nfound++] = cd;
+            }
+        }
+    } else {
+        for (n = 0; n < ncodes; n++) {
+            /* a code named twice must not offer its events twice */
+            for (k = 0; k < n; k++) {
+                if (codes[k] == codes[n]) {
+                    break;
+                }
+            }
+            if (k < n) {
+                continue;
+            }
+            cd = NULL;
+            (void) pmix_hash_table_get_value_uint32(&pmix_globals.notifications_index,
+                                                    (uint32_t) codes[n], (void **) &cd);
+            /* each cached notification is in the hotel, so the hotel's
+             * size bounds the array - but check rather than trust it */
+            for (; NULL != cd && nfound < nalloc; cd = cd->index_next) {
+                PMIX_RETAIN(cd);
+                array[nfound++] = cd;
+            }
+        }
+    }
+
+    if (0 == nfound) {
+        free(array);
+        return 0;
+    }
+    *cds = array;
+    return nfound;
+}
+
 /* Completion of a chain built from an event our server forwarded to us -
  * see the declaration in pmix_event.h for where it is used and why it
  * lives here.
@@ -1219,24 +1370,57 @@ static void local_cbfunc(pmix_status_t status, void *cbdata)
     PMIX_RELEASE(cd);
 }
 
+/* A custom-range target, filed by nspace and rank in a hash table so
+ * that checking whether a peer is in range is two probes - its own
+ * rank, and a wildcard for its nspace - instead of a scan of every
+ * target. The key is the nspace without its padding followed by the
+ * rank, so no two distinct targets can share one. */
+#define TARGET_KEYLEN (PMIX_MAX_NSLEN + 1 + sizeof(pmix_rank_t))
+
+static size_t target_key(char *key, const char *nspace, pmix_rank_t rank)
+{
+    size_t len;
+
+    len = strnlen(nspace, PMIX_MAX_NSLEN);
+    memcpy(key, nspace, len);
+    memcpy(key + len, &rank, sizeof(pmix_rank_t));
+    return len + sizeof(pmix_rank_t);
+}
+
+static bool in_targets(pmix_hash_table_t *tgts, const char *nspace, pmix_rank_t rank)
+{
+    char key[TARGET_KEYLEN];
+    size_t klen;
+    void *ptr;
+
+    klen = target_key(key, nspace, rank);
+    if (PMIX_SUCCESS == pmix_hash_table_get_value_ptr(tgts, key, klen, &ptr)) {
+        return true;
+    }
+    klen = target_key(key, nspace, PMIX_RANK_WILDCARD);
+    return (PMIX_SUCCESS == pmix_hash_table_get_value_ptr(tgts, key, klen, &ptr));
+}
+
 static void _notify_client_event(int sd, short args, void *cbdata)
 {
     (void) sd;
     (void) args;
     pmix_notify_caddy_t *cd = (pmix_notify_caddy_t *) cbdata;
-    pmix_regevents_info_t *reginfoptr;
+    pmix_regevents_info_t *reginfoptr, *regs[2];
     pmix_peer_events_info_t *pr;
     pmix_event_chain_t *chain;
-    size_t n, nleft;
-    bool matched, holdcd, cached;
+    size_t n, nleft, klen;
+    int r;
+    bool holdcd, cached;
     pmix_buffer_t *bfr;
     pmix_cmd_t cmd = PMIX_NOTIFY_CMD;
     pmix_status_t rc;
-    pmix_list_t trk;
-    pmix_namelist_t *nm;
-    pmix_namespace_t *nptr, *tmp;
+    pmix_namespace_t *nptr;
     pmix_range_trkr_t rngtrk;
     pmix_proc_t proc;
+    pmix_hash_table_t *tgts;
+    uint64_t stamp;
+    char key[TARGET_KEYLEN];
 
     /* need to acquire the object from its originating thread */
     PMIX_ACQUIRE_OBJECT(cd);
@@ -1245,6 +1429,10 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                         "pmix_server: _notify_client_event notifying clients of event %s range %s",
                         PMIx_Error_string(cd->status), PMIx_Data_range_string(cd->range));
 
+    /* every event the server hears of passes through here - drop any
+     * host query answers it makes stale */
+    pmix_server_query_cache_event(cd->status);
+
     /* check for caching instructions */
     holdcd = true;
     if (0 < cd->ninfo) {
@@ -1350,13 +1538,7 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                 ++nleft;
             } else {
                 /* look up the nspace for this proc */
-                nptr = NULL;
-                PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-                    if (PMIX_CHECK_NSPACE(tmp->nspace, cd->targets[n].nspace)) {
-                        nptr = tmp;
-                        break;
-                    }
-                }
+                nptr = pmix_nspace_lookup(cd->targets[n].nspace);
                 /* if we don't yet know it, then nothing to do */
                 if (NULL == nptr) {
                     nleft = SIZE_MAX;
@@ -1400,14 +1582,45 @@ static void _notify_client_event(int sd, short args, void *cbdata)
 
     holdcd = false;
     if (PMIX_RANGE_PROC_LOCAL != cd->range) {
-        PMIX_CONSTRUCT(&trk, pmix_list_t);
+        /* only two sets of registrations can want this event: those
+         * for its code, and the default handlers unless the event is
+         * flagged for non-default handlers only. Both come straight out
+         * of the registration index, so the fan-out costs time in
+         * proportion to the peers that asked and not to everything that
+         * has been registered for any code. */
+        regs[0] = pmix_server_find_reginfo(cd->status);
+        regs[1] = cd->nondefault ? NULL : pmix_server_globals.default_events;
+        if (regs[1] == regs[0]) {
+            regs[1] = NULL;
+        }
+        /* a client can hold several registrations that match - a second
+         * handler for a code it already registered, or a default handler
+         * alongside one for the code - and must hear of the event once.
+         * Each notification takes a new stamp and marks the ranks it
+         * reaches with it, so telling whether a client has already been
+         * notified is a comparison rather than a search of everyone we
+         * have notified so far. */
+        stamp = ++pmix_server_globals.events_stamp;
+        /* the custom range is checked against every candidate, so file
+         * its targets once rather than scanning them for each one */
+        tgts = NULL;
+        if (!PMIX_PEER_IS_TOOL(pmix_globals.mypeer) && NULL != cd->targets) {
+            tgts = PMIX_NEW(pmix_hash_table_t);
+            if (NULL != tgts) {
+                pmix_hash_table_init(tgts, cd->ntargets);
+                for (n = 0; n < cd->ntargets; n++) {
+                    klen = target_key(key, cd->targets[n].nspace, cd->targets[n].rank);
+                    pmix_hash_table_set_value_ptr(tgts, key, klen, &cd->targets[n]);
+                }
+            }
+        }
         rngtrk.procs = NULL;
         rngtrk.nprocs = 0;
-        /* cycle across our registered events and send the message to
-         * any client who registered for it */
-        PMIX_LIST_FOREACH (reginfoptr, &pmix_server_globals.events, pmix_regevents_info_t) {
-            if ((PMIX_MAX_ERR_CONSTANT == reginfoptr->code && !cd->nondefault) ||
-                cd->status == reginfoptr->code) {
+        /* cycle across the matching registrations and send the message
+         * to any client who registered for it */
+        for (r = 0; r < 2; r++) {
+            if (NULL != regs[r]) {
+                reginfoptr = regs[r];
                 PMIX_LIST_FOREACH (pr, &reginfoptr->peers, pmix_peer_events_info_t) {
                     /* if this client was the source of the event, then
                      * don't send it back as they will have processed it
@@ -1420,14 +1633,7 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                         continue;
                     }
                     /* if we have already notified this client, then don't do it again */
-                    matched = false;
-                    PMIX_LIST_FOREACH (nm, &trk, pmix_namelist_t) {
-                        if (nm->pname == &pr->peer->info->pname) {
-                            matched = true;
-                            break;
-                        }
-                    }
-                    if (matched) {
+                    if (stamp == pr->peer->info->notified) {
                         continue;
                     }
                     /* Deliberately NOT filtered on pr->affected here. That
@@ -1451,7 +1657,12 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                      * pmix_peer_events_info_t still records what the message
                      * said - it is what _check_cached_events replays
                      * against - it just does not gate delivery. */
-                    if (!PMIX_PEER_IS_TOOL(pmix_globals.mypeer) && NULL != cd->targets) {
+                    if (NULL != tgts) {
+                        if (!in_targets(tgts, pr->peer->info->pname.nspace,
+                                        pr->peer->info->pname.rank)) {
+                            continue;
+                        }
+                    } else if (!PMIX_PEER_IS_TOOL(pmix_globals.mypeer) && NULL != cd->targets) {
                         rngtrk.procs = cd->targets;
                         rngtrk.nprocs = cd->ntargets;
                         rngtrk.range = cd->range;
@@ -1467,9 +1678,7 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                                         PMIx_Error_string(cd->status));
 
                     /* record that we notified this client */
-                    nm = PMIX_NEW(pmix_namelist_t);
-                    nm->pname = &pr->peer->info->pname;
-                    pmix_list_append(&trk, &nm->super);
+                    pr->peer->info->notified = stamp;
 
                     bfr = PMIX_NEW(pmix_buffer_t);
                     if (NULL == bfr) {
@@ -1537,7 +1746,7 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                                  * reference the cache was holding; our own
                                  * in-flight reference keeps cd alive through
                                  * the remainder of this routine */
-                                pmix_hotel_checkout(&pmix_globals.notifications, cd->room);
+                                pmix_notify_event_uncache(cd);
                                 PMIX_RELEASE(cd);
                                 cached = false;
                             }
@@ -1547,7 +1756,9 @@ static void _notify_client_event(int sd, short args, void *cbdata)
                 }
             }
         }
-        PMIX_LIST_DESTRUCT(&trk);
+        if (NULL != tgts) {
+            PMIX_RELEASE(tgts);
+        }
         if (PMIX_RANGE_LOCAL != cd->range &&
             !cd->staylocal &&
             PMIX_CHECK_PROCID(&cd->source, &pmix_globals.myid)) {
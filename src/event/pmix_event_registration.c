@@ -402,32 +402,24 @@ static pmix_status_t _add_hdlr(pmix_rshift_caddy_t *cd, pmix_list_t *xfer)
 
 static void check_cached_events(pmix_rshift_caddy_t *cd)
 {
-    size_t n;
-    pmix_notify_caddy_t *ncd;
-    bool found, matched;
+    size_t n, j, ncds;
+    pmix_notify_caddy_t *ncd, **cds;
+    bool matched;
     pmix_event_chain_t *chain;
-    int j;
 
-    for (j = 0; j < pmix_globals.max_events; j++) {
-        pmix_hotel_knock(&pmix_globals.notifications, j, (void **) &ncd);
-        if (NULL == ncd) {
+    /* only the cached events with the codes they registered for, or all
+     * of them for a default handler. Running a handler can cache or
+     * uncache events, so work from the snapshot and skip any that have
+     * left the cache by the time we reach them. */
+    ncds = pmix_notify_event_lookup(cd->codes, cd->ncodes, &cds);
+    for (j = 0; j < ncds; j++) {
+        ncd = cds[j];
+        if (0 > ncd->room) {
             continue;
         }
-        found = false;
-        if (NULL == cd->codes) {
-            if (!ncd->nondefault) {
-                /* they registered a default event handler - always matches */
-                found = true;
-            }
-        } else {
-            for (n = 0; n < cd->ncodes; n++) {
-                if (cd->codes[n] == ncd->status) {
-                    found = true;
-                    break;
-                }
-            }
-        }
-        if (!found) {
+        if (NULL == cd->codes && ncd->nondefault) {
+            /* a default event handler matches anything not flagged
+             * for non-default handlers only */
             continue;
         }
         /* if we were given specific targets, check if we are one */
@@ -495,7 +487,7 @@ static void check_cached_events(pmix_rshift_caddy_t *cd)
         }
         /* check this event out of the cache since we
          * are processing it */
-        pmix_hotel_checkout(&pmix_globals.notifications, ncd->room);
+        pmix_notify_event_uncache(ncd);
         /* release the storage */
         PMIX_RELEASE(ncd);
 
@@ -505,6 +497,12 @@ static void check_cached_events(pmix_rshift_caddy_t *cd)
         /* now notify any matching registered callbacks we have */
         pmix_invoke_local_event_hdlr(chain);
     }
+    for (j = 0; j < ncds; j++) {
+        PMIX_RELEASE(cds[j]);
+    }
+    if (NULL != cds) {
+        free(cds);
+    }
 }
 
 void pmix_internal_reg_event_hdlr(int sd, short args, void *cbdata)
@@ -54,6 +54,7 @@
 #include "src/util/pmix_name_fns.h"
 #include "src/util/pmix_path.h"
 #include "src/util/pmix_printf.h"
+#include "src/util/pmix_shmem.h"
 #include "src/util/pmix_show_help.h"
 #include "src/util/pmix_vmem.h"
 
@@ -69,6 +70,7 @@ static char *topo_file = NULL;
 static char *testcpuset = NULL;
 static int pmix_hwloc_output = -1;
 static int pmix_hwloc_verbose = 0;
+static bool huge_pages = false;
 
 static size_t shmemsize = 0;
 static size_t shmemaddr;
@@ -129,6 +131,11 @@ pmix_status_t pmix_hwloc_register(void)
                                       PMIX_MCA_BASE_VAR_TYPE_STRING,
                                       &testcpuset);
 
+    (void) pmix_mca_base_var_register("pmix", "pmix", "hwloc", "huge_pages",
+                                      "Place and size the shared topology on transparent huge pages, "
+                                      "where the kernel allows them for shared memory (default=false)",
+                                      PMIX_MCA_BASE_VAR_TYPE_BOOL, &huge_pages);
+
     return PMIX_SUCCESS;
 }
 
@@ -309,6 +316,18 @@ pmix_status_t pmix_hwloc_setup_topology(pmix_info_t *info, size_t ninfo)
     if (0 == rc) {
         pmix_output_verbose(2, pmix_hwloc_output, "%s:%s shmem adopted",
                             __FILE__, __func__);
+#ifdef MADV_HUGEPAGE
+        /* A server that put the topology on huge pages lined it up on
+         * them, and that is the only way we can tell - nothing on the
+         * wire says so. hwloc owns the mapping, but advice on it is ours
+         * to give, and the kernel is free to ignore it. */
+        {
+            const size_t hp = pmix_shmem_utils_huge_page_size();
+            if (0 < hp && 0 == (addr & (hp - 1)) && 0 == (size & (hp - 1))) {
+                (void) madvise((void *) (uintptr_t) addr, size, MADV_HUGEPAGE);
+            }
+        }
+#endif
         /* got it - we are done */
         pmix_asprintf(&pmix_globals.topology.source, "hwloc:%s", HWLOC_VERSION);
         /* record locally in case someone does a PMIx_Get to retrieve it */
@@ -534,14 +553,25 @@ sharetopo:
         return PMIX_SUCCESS;
     }
 
+    /* On huge pages the segment is a whole number of them and starts on
+     * one, which is also what tells a client to ask for them. hwloc takes
+     * a length larger than it needs. */
+    const size_t hp = huge_pages ? pmix_shmem_utils_huge_page_size() : 0;
+    if (0 < hp) {
+        shmemsize = (shmemsize + hp - 1) & ~(hp - 1);
+    }
+
     /* try and find a hole */
-    if (PMIX_SUCCESS != pmix_vmem_find_hole(hole_kind, &shmemaddr, shmemsize)) {
+    if (PMIX_SUCCESS != pmix_vmem_find_hole(hole_kind, &shmemaddr, shmemsize + hp)) {
         /* we couldn't find a hole, so don't use the shmem support */
         if (4 < pmix_output_get_verbosity(pmix_hwloc_output)) {
             print_maps();
         }
         return PMIX_SUCCESS;
     }
+    if (0 < hp) {
+        shmemaddr = (shmemaddr + hp - 1) & ~(hp - 1);
+    }
     /* create the shmem file in our session dir so it
      * will automatically get cleaned up */
     pmix_asprintf(&shmemfile, "%s/hwloc.sm", pmix_server_globals.tmpdir);
@@ -1106,6 +1136,54 @@ pmix_status_t pmix_hwloc_get_cpuset(pmix_cpuset_t *cpuset, pmix_bind_envelope_t
     return PMIX_SUCCESS;
 }
 
+pmix_status_t pmix_hwloc_membind_area(void *addr, size_t len, pmix_hwloc_membind_t policy)
+{
+    hwloc_topology_t topo = pmix_globals.topology.topology;
+    hwloc_membind_policy_t hpolicy;
+    hwloc_nodeset_t nodeset;
+    hwloc_cpuset_t cpuset;
+    int rc;
+
+    if (PMIX_HWLOC_MEMBIND_NONE == policy) {
+        return PMIX_SUCCESS;
+    }
+    if (NULL == topo || NULL == addr || 0 == len) {
+        return PMIX_ERR_NOT_AVAILABLE;
+    }
+    /* one NUMA node - there is nowhere else for the pages to go */
+    if (1 >= hwloc_get_nbobjs_by_type(topo, HWLOC_OBJ_NUMANODE)) {
+        return PMIX_SUCCESS;
+    }
+
+    nodeset = hwloc_bitmap_alloc();
+    if (PMIX_HWLOC_MEMBIND_INTERLEAVE == policy) {
+        hwloc_bitmap_copy(nodeset, hwloc_topology_get_topology_nodeset(topo));
+        hpolicy = HWLOC_MEMBIND_INTERLEAVE;
+    } else {
+        /* an unbound process is local to every node, which makes this
+         * the same as asking for nothing - say so rather than pretend */
+        cpuset = hwloc_bitmap_alloc();
+        if (0 != hwloc_get_cpubind(topo, cpuset, HWLOC_CPUBIND_PROCESS)
+            || hwloc_bitmap_isincluded(hwloc_topology_get_topology_cpuset(topo), cpuset)) {
+            hwloc_bitmap_free(cpuset);
+            hwloc_bitmap_free(nodeset);
+            return PMIX_ERR_NOT_AVAILABLE;
+        }
+        hwloc_cpuset_to_nodeset(topo, cpuset, nodeset);
+        hwloc_bitmap_free(cpuset);
+        hpolicy = HWLOC_MEMBIND_BIND;
+    }
+    rc = hwloc_set_area_membind(topo, addr, len, nodeset, hpolicy, HWLOC_MEMBIND_BYNODESET);
+    hwloc_bitmap_free(nodeset);
+    if (0 != rc) {
+        pmix_output_verbose(2, pmix_hwloc_output,
+                            "%s:%s could not set memory binding: %s",
+                            __FILE__, __func__, strerror(errno));
+        return PMIX_ERR_NOT_SUPPORTED;
+    }
+    return PMIX_SUCCESS;
+}
+
 static hwloc_obj_t dsearch(hwloc_topology_t t, int depth, hwloc_cpuset_t cpuset)
 {
     hwloc_obj_t obj;
@@ -73,6 +73,23 @@ PMIX_EXPORT pmix_status_t pmix_hwloc_get_relative_locality(const char *locality1
 /* Get current bound location */
 PMIX_EXPORT pmix_status_t pmix_hwloc_get_cpuset(pmix_cpuset_t *cpuset, pmix_bind_envelope_t ref);
 
+/* Where pmix_hwloc_membind_area() puts an area's pages */
+typedef enum {
+    /* wherever the first process to touch each page runs */
+    PMIX_HWLOC_MEMBIND_NONE = 0,
+    /* round-robin across every NUMA node in the topology */
+    PMIX_HWLOC_MEMBIND_INTERLEAVE,
+    /* on the NUMA nodes local to where this process is bound */
+    PMIX_HWLOC_MEMBIND_LOCAL
+} pmix_hwloc_membind_t;
+
+/* Set the NUMA placement of pages not yet allocated in [addr, addr+len).
+ * For a shared mapping the policy belongs to the shared object, so it
+ * holds whichever process touches a page first. Succeeds without doing
+ * anything on a single-node topology */
+PMIX_EXPORT pmix_status_t pmix_hwloc_membind_area(void *addr, size_t len,
+                                                  pmix_hwloc_membind_t policy);
+
 /* Get distance array */
 PMIX_EXPORT pmix_status_t pmix_hwloc_compute_distances(pmix_topology_t *topo, pmix_cpuset_t *cpuset,
                                                        pmix_info_t info[], size_t ninfo,
@@ -155,12 +155,15 @@ static void nscon(pmix_namespace_t *p)
     p->nfinalized = 0;
     p->local_app_fini_fired = false;
     PMIX_CONSTRUCT(&p->ranks, pmix_list_t);
+    PMIX_CONSTRUCT(&p->rank_index, pmix_hash_table_t);
+    pmix_hash_table_init(&p->rank_index, 16);
     memset(&p->compat, 0, sizeof(p->compat));
     PMIX_CONSTRUCT(&p->epilog.cleanup_dirs, pmix_list_t);
     PMIX_CONSTRUCT(&p->epilog.cleanup_files, pmix_list_t);
     PMIX_CONSTRUCT(&p->epilog.ignores, pmix_list_t);
     PMIX_CONSTRUCT(&p->setup_data, pmix_list_t);
     PMIX_CONSTRUCT(&p->departed, pmix_list_t);
+    PMIX_CONSTRUCT(&p->prefetched, pmix_bitmap_t);
     pmix_iof_init_flags(&p->iof_flags);
     PMIX_CONSTRUCT(&p->sinks, pmix_list_t);
 
@@ -174,7 +177,9 @@ static void nsdes(pmix_namespace_t *p)
         PMIX_RELEASE(p->jobbkt);
     }
     PMIX_LIST_DESTRUCT(&p->ranks);
+    PMIX_DESTRUCT(&p->rank_index);
     PMIX_LIST_DESTRUCT(&p->departed);
+    PMIX_DESTRUCT(&p->prefetched);
     /* perform any epilog */
     pmix_execute_epilog(&p->epilog);
     /* cleanup the epilog */
@@ -208,6 +213,121 @@ PMIX_EXPORT PMIX_CLASS_INSTANCE(pmix_nspace_caddy_t,
                                 pmix_list_item_t,
                                 ncdcon, ncddes);
 
+pmix_namespace_t *pmix_nspace_lookup(const char *nspace)
+{
+    pmix_namespace_t *nptr;
+
+    if (NULL == nspace || '\0' == nspace[0]) {
+        return NULL;
+    }
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_ptr(&pmix_globals.nspace_index, nspace,
+                                                      strnlen(nspace, PMIX_MAX_NSLEN),
+                                                      (void **) &nptr)) {
+        return NULL;
+    }
+    return nptr;
+}
+
+void pmix_nspace_add(pmix_namespace_t *nptr, bool first)
+{
+    pmix_namespace_t *existing;
+
+    if (first) {
+        pmix_list_prepend(&pmix_globals.nspaces, &nptr->super);
+    } else {
+        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+    }
+    if (NULL == nptr->nspace || '\0' == nptr->nspace[0]) {
+        /* nothing to find it by - it can only be reached through the list */
+        return;
+    }
+    /* a name that is already indexed keeps its entry: a walk of the list
+     * would have stopped at the earlier one, and a lookup has to give the
+     * same answer that walk did. Only the one at the front of the list
+     * displaces it. */
+    existing = pmix_nspace_lookup(nptr->nspace);
+    if (NULL == existing || first) {
+        pmix_hash_table_set_value_ptr(&pmix_globals.nspace_index, nptr->nspace,
+                                      strnlen(nptr->nspace, PMIX_MAX_NSLEN), nptr);
+    }
+}
+
+void pmix_nspace_remove(pmix_namespace_t *nptr)
+{
+    pmix_namespace_t *ns;
+    size_t len;
+
+    pmix_list_remove_item(&pmix_globals.nspaces, &nptr->super);
+    if (NULL == nptr->nspace || '\0' == nptr->nspace[0] ||
+        nptr != pmix_nspace_lookup(nptr->nspace)) {
+        return;
+    }
+    len = strnlen(nptr->nspace, PMIX_MAX_NSLEN);
+    pmix_hash_table_remove_value_ptr(&pmix_globals.nspace_index, nptr->nspace, len);
+    /* if another entry carries the same name, it is now the one a
+     * lookup has to find. Removal is rare, so the walk is affordable. */
+    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
+        if (NULL != ns->nspace && 0 == strncmp(ns->nspace, nptr->nspace, PMIX_MAX_NSLEN)) {
+            pmix_hash_table_set_value_ptr(&pmix_globals.nspace_index, ns->nspace, len, ns);
+            break;
+        }
+    }
+}
+
+/* A namespace's ranks used to be found by walking its ranks list, and
+ * that happens on every connection, every direct-modex request, and for
+ * each participant every time a fence or group tracker is defined - with
+ * a few hundred local ranks, a few hundred comparisons apiece, over and
+ * over during the collectives of a job's startup. The list stays, for
+ * the code that wants every rank in order; rank_index finds one. */
+pmix_rank_info_t *pmix_nspace_find_rank(pmix_namespace_t *nptr, pmix_rank_t rank)
+{
+    pmix_rank_info_t *info;
+
+    if (NULL == nptr) {
+        return NULL;
+    }
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_uint32(&nptr->rank_index, rank,
+                                                         (void **) &info)) {
+        return NULL;
+    }
+    return info;
+}
+
+void pmix_nspace_add_rank(pmix_namespace_t *nptr, pmix_rank_info_t *info)
+{
+    pmix_list_append(&nptr->ranks, &info->super);
+    /* as with namespaces, a rank already indexed keeps its entry - the
+     * walk this replaces would have stopped at the earlier one. Nothing
+     * registers a rank twice on purpose, so this is belt and braces */
+    if (NULL == pmix_nspace_find_rank(nptr, info->pname.rank)) {
+        pmix_hash_table_set_value_uint32(&nptr->rank_index, info->pname.rank, info);
+    }
+}
+
+void pmix_nspace_remove_rank(pmix_namespace_t *nptr, pmix_rank_info_t *info)
+{
+    pmix_rank_info_t *ri;
+
+    pmix_list_remove_item(&nptr->ranks, &info->super);
+    if (info != pmix_nspace_find_rank(nptr, info->pname.rank)) {
+        return;
+    }
+    pmix_hash_table_remove_value_uint32(&nptr->rank_index, info->pname.rank);
+    /* a second entry for the rank is now the one to find - but when every
+     * entry left is indexed there cannot be one, and that is the case a
+     * namespace being torn down rank by rank hits every time */
+    if (pmix_list_get_size(&nptr->ranks) == pmix_hash_table_get_size(&nptr->rank_index)) {
+        return;
+    }
+    PMIX_LIST_FOREACH (ri, &nptr->ranks, pmix_rank_info_t) {
+        if (ri->pname.rank == info->pname.rank) {
+            pmix_hash_table_set_value_uint32(&nptr->rank_index, ri->pname.rank, ri);
+            break;
+        }
+    }
+}
+
 static void keyindex_construct(pmix_keyindex_t *ki)
 {
     pmix_tma_t *const tma = pmix_obj_get_tma(&ki->super);
@@ -298,6 +418,9 @@ static void info_con(pmix_rank_info_t *info)
     PMIX_CONSTRUCT(&info->pending_deletes, pmix_list_t);
     info->modex_sig = 0;
     info->modex_contributed = false;
+    info->modex_gen = 0;
+    info->dmodex_reply = NULL;
+    info->notified = 0;
 }
 static void info_des(pmix_rank_info_t *info)
 {
@@ -500,6 +623,7 @@ static void lgcon(pmix_get_logic_t *p)
     p->appinfo = false;
     p->appdirective = false;
     p->appnum = UINT32_MAX;
+    p->resolved = false;
 }
 static void lgdes(pmix_get_logic_t *p)
 {
@@ -661,6 +785,8 @@ static void ncon(pmix_notify_caddy_t *p)
     p->ts = tv.tv_sec;
 #endif
     p->room = -1;
+    p->index_next = NULL;
+    p->index_prev = NULL;
     memset(p->source.nspace, 0, PMIX_MAX_NSLEN + 1);
     p->source.rank = PMIX_RANK_UNDEF;
     p->range = PMIX_RANGE_UNDEF;
@@ -690,24 +816,76 @@ PMIX_CLASS_INSTANCE(pmix_notify_caddy_t,
                     ncon, ndes);
 
 pmix_dstor_t *pmix_dstor_new_tma(uint32_t index,
+                                 const pmix_value_t *val,
                                  pmix_tma_t *tma)
 {
-    pmix_dstor_t *d = (pmix_dstor_t *)pmix_tma_malloc(tma, sizeof(pmix_dstor_t));
+    pmix_dstor_t *d;
+    size_t slen = 0;
+
+    if (NULL != val && PMIX_STRING == val->type && NULL != val->data.string) {
+        slen = strlen(val->data.string) + 1;
+        if (PMIX_DSTOR_INLINE_MAX < slen) {
+            slen = 0;
+        }
+    }
+    d = (pmix_dstor_t *)pmix_tma_malloc(tma, sizeof(pmix_dstor_t) + slen);
     if (PMIX_LIKELY(NULL != d)) {
         d->index = index;
         d->qualindex = UINT32_MAX;
         d->value = NULL;
+        d->inl.type = PMIX_UNDEF;
+        d->slen = slen;
     }
     return d;
 }
 
+pmix_status_t pmix_dstor_load_value_tma(pmix_dstor_t *d,
+                                        const pmix_value_t *val,
+                                        pmix_tma_t *tma)
+{
+    pmix_status_t rc;
+    size_t len;
+
+    pmix_dstor_clear_value_tma(d, tma);
+    if (PMIX_STRING == val->type && NULL != val->data.string && 0 < d->slen) {
+        len = strlen(val->data.string) + 1;
+        if (len <= d->slen) {
+            memcpy(d->str, val->data.string, len);
+            d->inl.type = PMIX_STRING;
+            d->inl.data.string = d->str;
+            d->value = &d->inl;
+            return PMIX_SUCCESS;
+        }
+    }
+    /* a scalar lands in the union here and needs nothing more; anything
+     * else gets its payload allocated from the same TMA as the entry */
+    rc = pmix_bfrops_base_tma_value_xfer(&d->inl, val, tma);
+    if (PMIX_SUCCESS != rc) {
+        d->inl.type = PMIX_UNDEF;
+        return rc;
+    }
+    d->value = &d->inl;
+    return PMIX_SUCCESS;
+}
+
+void pmix_dstor_clear_value_tma(pmix_dstor_t *d,
+                                pmix_tma_t *tma)
+{
+    if (NULL == d->value) {
+        return;
+    }
+    /* a string held in the tail of the entry is not an allocation */
+    if (!(PMIX_STRING == d->inl.type && d->str == d->inl.data.string)) {
+        pmix_bfrops_base_tma_value_destruct(&d->inl, tma);
+    }
+    d->inl.type = PMIX_UNDEF;
+    d->value = NULL;
+}
+
 void pmix_dstor_release_tma(pmix_dstor_t *d,
                             pmix_tma_t *tma)
 {
-    if (NULL != d->value) {
-        pmix_bfrops_base_tma_value_destruct(d->value, tma);
-        pmix_tma_free(tma, d->value);
-    }
+    pmix_dstor_clear_value_tma(d, tma);
     pmix_tma_free(tma, d);
 }
 
@@ -41,6 +41,7 @@
 #include "pmix_common.h"
 #include "pmix_tool.h"
 
+#include "src/class/pmix_bitmap.h"
 #include "src/class/pmix_hash_table.h"
 #include "src/class/pmix_hotel.h"
 #include "src/class/pmix_list.h"
@@ -170,15 +171,55 @@ do {                                    \
     }                                   \
 } while(0)
 
+/* A stored value. The pmix_value_t lives in the entry itself rather
+ * than in an allocation of its own, so a scalar - and most of what a
+ * job stores is ranks, node ids, flags and the like - costs exactly one
+ * allocation and is read without leaving the entry. A string short
+ * enough to have been given room at creation (see pmix_dstor_new_tma)
+ * is kept in the tail of the entry as well; anything larger or more
+ * complex keeps its payload out of line, exactly as a pmix_value_t
+ * would. "value" is either NULL (nothing stored) or points at "inl" -
+ * it is kept so that readers can go on treating the entry's value as a
+ * pmix_value_t*, but only the pmix_dstor_*_value_tma functions may set
+ * or release it: neither the value nor its string is a separate
+ * allocation any more. */
 typedef struct {
     uint32_t index;
     uint32_t qualindex;
     pmix_value_t *value;
+    pmix_value_t inl;
+    /* bytes available in str[], including the terminator */
+    size_t slen;
+    char str[];
 } pmix_dstor_t;
 
+/* The longest string, terminator included, given room inside the
+ * entry. Long enough for hostnames, namespaces and URIs of ordinary
+ * length; beyond that the extra copy is not where the time goes. */
+#define PMIX_DSTOR_INLINE_MAX 64
+
+/* Create an entry for key index "index". If "val" is given it is only
+ * a sizing hint - nothing is stored - and a string value that fits in
+ * PMIX_DSTOR_INLINE_MAX gets room for itself in the entry. */
 PMIX_EXPORT pmix_dstor_t *
 pmix_dstor_new_tma(
     uint32_t index,
+    const pmix_value_t *val,
+    pmix_tma_t *tma
+);
+
+/* Replace whatever the entry holds with a deep copy of "val" */
+PMIX_EXPORT pmix_status_t
+pmix_dstor_load_value_tma(
+    pmix_dstor_t *d,
+    const pmix_value_t *val,
+    pmix_tma_t *tma
+);
+
+/* Release the entry's value, leaving d->value NULL */
+PMIX_EXPORT void
+pmix_dstor_clear_value_tma(
+    pmix_dstor_t *d,
     pmix_tma_t *tma
 );
 
@@ -188,9 +229,9 @@ pmix_dstor_release_tma(
     pmix_tma_t *tma
 );
 
-#define PMIX_DSTOR_NEW(d, k)                                \
+#define PMIX_DSTOR_NEW(d, k, v)                             \
 do {                                                        \
-    (d) = pmix_dstor_new_tma((k), NULL);                    \
+    (d) = pmix_dstor_new_tma((k), (v), NULL);               \
 } while(0)
 
 #define PMIX_DSTOR_RELEASE(d)           \
@@ -386,6 +427,7 @@ typedef struct {
                                // fired for this nspace; guards against re-firing it once
                                // per rank while the nspace is torn down
     pmix_list_t ranks;     // list of pmix_rank_info_t for connection support of my clients
+    pmix_hash_table_t rank_index; // the same entries, by rank - see pmix_nspace_find_rank()
     /* Ranks whose entry above the host has taken back - the proc has
      * terminated. pmix_proclist_t, one per reaped LOCAL rank, kept until
      * this namespace is deregistered.
@@ -398,6 +440,8 @@ typedef struct {
      * peer that has exited is an application error, but it has to
      * SURFACE as one - a hang tells the developer nothing. */
     pmix_list_t departed;
+    pmix_bitmap_t prefetched; // remote ranks whose modex a server fetched before anyone
+                              // asked for it, and nobody yet has - see pmix_server_get.c
     /* all members of an nspace are required to have the
      * same personality, but it can differ between nspaces.
      * Since servers may support clients from multiple nspaces,
@@ -473,6 +517,18 @@ typedef struct pmix_rank_info_t {
      * datastore reads as "this key is gone". Announced once, with the
      * next contribution, and then dropped. */
     pmix_list_t pending_deletes;
+    /* Server side: bumped each time this rank commits, so anything
+     * derived from its published data can tell whether it still is -
+     * see pmix_server_dmodex_reply(). dmodex_reply is the packed answer
+     * to a direct-modex request for this rank, if one is cached; the
+     * cache holds a reference on this object while it does. */
+    uint64_t modex_gen;
+    struct pmix_dmodex_reply_t *dmodex_reply;
+    /* Server side: the last event notification relayed to this rank -
+     * see _notify_client_event(). Kept here rather than on the peer for
+     * the same reason as pending_modex: a clone is the same rank, and
+     * hears of an event once. */
+    uint64_t notified;
 } pmix_rank_info_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_rank_info_t);
 
@@ -628,7 +684,7 @@ PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_grpinfo_t);
 
 /* define a tracker for collective operations
  * - instanced in pmix_server_ops.c */
-typedef struct {
+typedef struct pmix_server_trkr_t {
     pmix_list_item_t super;
     pmix_event_t ev;
     bool event_active;
@@ -677,6 +733,12 @@ typedef struct {
     pmix_op_cbfunc_t op_cbfunc;
     pmix_info_cbfunc_t info_cbfunc;
     void *cbdata;
+    /* where pmix_server_get_tracker() looks for this tracker: its key in
+     * pmix_server_globals.collectives_index, and the next tracker filed
+     * under the same key. Set by pmix_server_track_collective(). */
+    bool indexed;
+    uint64_t index_key;
+    struct pmix_server_trkr_t *index_next;
 } pmix_server_trkr_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_server_trkr_t);
 
@@ -769,6 +831,9 @@ typedef struct {
     bool appinfo;
     bool appdirective;
     uint32_t appnum;
+    /* the realm qualifiers have been worked out and folded into the
+     * request's info - see resolve_realm() in pmix_client_get.c */
+    bool resolved;
 } pmix_get_logic_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_get_logic_t);
 
@@ -835,15 +900,19 @@ PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_cb_t);
         pmix_event_evtimer_add(&(r)->ev, &_tv);                          \
     } while (0)
 
-typedef struct {
+typedef struct pmix_notify_caddy_t {
     pmix_object_t super;
     pmix_event_t ev;
     pmix_lock_t lock;
     /* timestamp receipt of the notification so we
      * can evict the oldest one if we get overwhelmed */
     time_t ts;
-    /* what room of the hotel they are in */
+    /* what room of the hotel they are in - -1 if not cached */
     int room;
+    /* the other cached notifications with this status, oldest first -
+     * see index_cached() in src/event/pmix_event_notification.c */
+    struct pmix_notify_caddy_t *index_next;
+    struct pmix_notify_caddy_t *index_prev;
     pmix_status_t status;
     pmix_proc_t source;
     pmix_data_range_t range;
@@ -965,6 +1034,7 @@ typedef struct {
     int max_events;                    // size of the notifications hotel
     int event_eviction_time;           // max time to cache notifications
     pmix_hotel_t notifications;        // hotel of pending notifications
+    pmix_hash_table_t notifications_index; // the same notifications, by status
     /* IOF controls */
     bool pushstdin;
     pmix_list_t stdin_targets; // list of pmix_namelist_t
@@ -972,7 +1042,14 @@ typedef struct {
     bool xml_output;
     bool timestamp_output;
     size_t output_limit;
+    /* Every namespace this process knows about. The list owns them and
+     * keeps their order (our own namespace first on a server); the index
+     * maps a name to its entry so the per-message lookups - switchyard,
+     * get, fence, IOF, event delivery - do not walk a list that only
+     * grows over the life of a daemon. Add and remove through
+     * pmix_nspace_add()/pmix_nspace_remove() so the two stay in step. */
     pmix_list_t nspaces;
+    pmix_hash_table_t nspace_index;
     pmix_topology_t topology;
     pmix_cpuset_t cpuset;
     bool external_topology;
@@ -1016,7 +1093,50 @@ typedef struct {
 /* provide access to a function to cleanup epilogs */
 PMIX_EXPORT void pmix_execute_epilog(pmix_epilog_t *ep);
 
+/* Namespace registry - see pmix_globals.nspaces.
+ *
+ * pmix_nspace_lookup() matches the name EXACTLY and returns NULL for an
+ * invalid name; callers that want the wildcard behavior of
+ * PMIX_CHECK_NSPACE have to walk the list themselves. The returned object
+ * is borrowed from the registry. pmix_nspace_add() takes over the
+ * caller's reference, as pmix_list_append() did, and the object must
+ * already carry its name. pmix_nspace_remove() hands that reference back
+ * without releasing it. */
+PMIX_EXPORT pmix_namespace_t *pmix_nspace_lookup(const char *nspace);
+PMIX_EXPORT void pmix_nspace_add(pmix_namespace_t *nptr, bool first);
+PMIX_EXPORT void pmix_nspace_remove(pmix_namespace_t *nptr);
+
+/* The ranks a namespace knows - see pmix_namespace_t.ranks.
+ *
+ * Same contract, one level down: pmix_nspace_find_rank() returns the
+ * entry a walk of the ranks list would have stopped at, borrowed, or NULL.
+ * pmix_nspace_add_rank() takes over the caller's reference and the entry
+ * must already carry its rank; pmix_nspace_remove_rank() hands it back
+ * without releasing it. Anything that puts an entry on the list or takes
+ * one off has to go through these, or lookups stop seeing it. */
+PMIX_EXPORT pmix_rank_info_t *pmix_nspace_find_rank(pmix_namespace_t *nptr, pmix_rank_t rank);
+PMIX_EXPORT void pmix_nspace_add_rank(pmix_namespace_t *nptr, pmix_rank_info_t *info);
+PMIX_EXPORT void pmix_nspace_remove_rank(pmix_namespace_t *nptr, pmix_rank_info_t *info);
+
+/* The notification cache - pmix_globals.notifications.
+ *
+ * pmix_notify_event_cache() checks a notification in, evicting the
+ * oldest occupant if the cache is full, and takes over the caller's
+ * reference. pmix_notify_event_uncache() checks it out again and hands
+ * that reference back without releasing it; it is harmless on one that
+ * is no longer cached. Anything that takes a notification out of the
+ * hotel has to go through it, or lookups by status keep finding it.
+ *
+ * pmix_notify_event_lookup() returns, in a malloc'd array, the cached
+ * notifications whose status is one of the given codes - or every one
+ * of them if codes is NULL - each with a reference the caller must
+ * release. Those of each code come in the order they were cached, so
+ * a late handler sees them in the order they happened. They stay valid while the caller works through them, but
+ * one may be uncached along the way: check room before acting on it. */
 PMIX_EXPORT pmix_status_t pmix_notify_event_cache(pmix_notify_caddy_t *cd);
+PMIX_EXPORT void pmix_notify_event_uncache(pmix_notify_caddy_t *cd);
+PMIX_EXPORT size_t pmix_notify_event_lookup(pmix_status_t *codes, size_t ncodes,
+                                            pmix_notify_caddy_t ***cds);
 
 PMIX_EXPORT extern pmix_globals_t pmix_globals;
 PMIX_EXPORT extern const char* PMIX_PROXY_VERSION;
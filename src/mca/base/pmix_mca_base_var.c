@@ -1437,6 +1437,18 @@ int pmix_mca_base_component_var_register(const pmix_mca_base_component_t *compon
                                       description, type, storage);
 }
 
+int pmix_mca_base_component_var_register_deprecated(const pmix_mca_base_component_t *component,
+                                                    const char *variable_name,
+                                                    const char *description,
+                                                    pmix_mca_base_var_type_t type, void *storage)
+{
+    return register_variable(component->pmix_mca_project_name, component->pmix_mca_type_name,
+                             component->pmix_mca_component_name, variable_name, description,
+                             type,
+                             (pmix_mca_base_var_flag_internal_t) PMIX_MCA_BASE_VAR_FLAG_DEPRECATED,
+                             0, storage);
+}
+
 int pmix_mca_base_framework_var_register(const pmix_mca_base_framework_t *framework,
                                          const char *variable_name, const char *help_msg,
                                          pmix_mca_base_var_type_t type, void *storage)
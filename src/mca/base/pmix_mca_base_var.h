@@ -318,7 +318,8 @@ PMIX_EXPORT int pmix_mca_base_var_init(void);
  * successfully.
  *
  * NOTE: this interface takes no flags, scope, info level, binding hint
- * or enumerator. Earlier revisions of this comment described all five,
+ * or enumerator (a deprecated variable is registered through
+ * pmix_mca_base_component_var_register_deprecated() instead). Earlier revisions of this comment described all five,
  * and none of them has ever been a parameter of this function. The
  * corresponding pmix_mca_base_var_t fields (mbv_flags beyond the
  * internal bits, mbv_bind, mbv_enumerator) are consequently never set
@@ -345,6 +346,21 @@ PMIX_EXPORT int pmix_mca_base_component_var_register(
     const pmix_mca_base_component_t *component, const char *variable_name, const char *description,
     pmix_mca_base_var_type_t type, void *storage);
 
+/**
+ * Register a component variable that is deprecated and has no
+ * replacement.
+ *
+ * The same as pmix_mca_base_component_var_register(), except that the
+ * variable carries PMIX_MCA_BASE_VAR_FLAG_DEPRECATED: setting it in the
+ * environment, on the command line or in a file produces the standard
+ * deprecation message, with "None (going away)" as the new variable.
+ * A deprecated name that has a replacement should instead be registered
+ * as a synonym of it with PMIX_MCA_BASE_VAR_SYN_FLAG_DEPRECATED.
+ */
+PMIX_EXPORT int pmix_mca_base_component_var_register_deprecated(
+    const pmix_mca_base_component_t *component, const char *variable_name, const char *description,
+    pmix_mca_base_var_type_t type, void *storage);
+
 /**
  * Convenience function for registering a variable associated with a framework. This
  * function is equivalent to pmix_mca_base_var_register with component_name = "base" and
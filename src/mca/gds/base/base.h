@@ -124,6 +124,16 @@ pmix_gds_base_get_fallback_module(pmix_gds_base_module_t *failing);
  */
 PMIX_EXPORT pmix_status_t pmix_gds_base_setup_fork(const pmix_proc_t *proc, char ***env);
 
+/**
+ * Collect PMIX_QUERY_GDS_USAGE reports from every active module that
+ * has one to give; see pmix_gds_base_module_report_usage_fn_t.
+ *
+ * @return PMIX_SUCCESS if any module appended to kvs, PMIX_ERR_NOT_FOUND
+ *         if none did - which is how a query learns it has to ask the
+ *         server instead.
+ */
+PMIX_EXPORT pmix_status_t pmix_gds_base_report_usage(const char *nspace, pmix_list_t *kvs);
+
 /* Walk an aggregated fence result and hand each proc's blob to cb_fn,
  * then call cb_fn once per nspace with a NULL buffer to signal "done".
  *
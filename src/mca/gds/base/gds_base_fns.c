@@ -22,7 +22,8 @@
 #include "src/include/pmix_globals.h"
 
 #include "src/class/pmix_list.h"
-#include "src/mca/pcompress/pcompress.h"
+#include "src/mca/pcompress/base/base.h"
+#include "src/threads/pmix_parallel.h"
 #include "src/util/pmix_argv.h"
 #include "src/util/pmix_error.h"
 #include "src/util/pmix_show_help.h"
@@ -123,6 +124,269 @@ pmix_status_t pmix_gds_base_setup_fork(const pmix_proc_t *proc, char ***env)
     return PMIX_SUCCESS;
 }
 
+pmix_status_t pmix_gds_base_report_usage(const char *nspace, pmix_list_t *kvs)
+{
+    pmix_gds_base_active_module_t *active;
+    pmix_status_t rc, ret = PMIX_ERR_NOT_FOUND;
+
+    if (!pmix_gds_globals.initialized) {
+        return PMIX_ERR_INIT;
+    }
+
+    /* not just the module assigned to our own namespace: a client whose
+     * shmem3 attach failed is on hash, and the count of that failure is
+     * exactly what shmem3 has to report */
+    PMIX_LIST_FOREACH (active, &pmix_gds_globals.actives, pmix_gds_base_active_module_t) {
+        if (NULL == active->module->report_usage) {
+            continue;
+        }
+        rc = active->module->report_usage(nspace, kvs);
+        if (PMIX_SUCCESS == rc) {
+            ret = PMIX_SUCCESS;
+        } else if (PMIX_ERR_NOT_FOUND != rc) {
+            return rc;
+        }
+    }
+
+    return ret;
+}
+
+/* Screen one server's collect-flag byte and hold it to the others'. */
+static pmix_status_t check_blob_info(uint8_t blob_info_byte,
+                                     pmix_collect_t *last_blob_info_byte)
+{
+    pmix_collect_t blob_info = (pmix_collect_t) blob_info_byte;
+
+    /* Screen the value before comparing it. The check below only
+     * asks whether the servers agree with each other, so a marker
+     * they all agree on and none of us can act on would otherwise
+     * pass straight through. Two cases, and they fail differently:
+     *
+     * PMIX_MODEX_DELTA is honored - the kind is handed to the
+     * component's callback, which decides what it means for its
+     * own storage (gds/hash accumulates, so nothing; gds/shmem3
+     * keeps the generations a delta does not repeat).
+     *
+     * Anything else is a value no release ever defined, so the
+     * sender is not something this code can reason about. */
+    if (PMIX_COLLECT_NO != blob_info && PMIX_COLLECT_YES != blob_info
+        && PMIX_MODEX_DELTA != blob_info) {
+        PMIX_ERROR_LOG(PMIX_ERR_BAD_PARAM);
+        return PMIX_ERR_BAD_PARAM;
+    }
+    if (PMIX_COLLECT_INVALID == *last_blob_info_byte) {
+        *last_blob_info_byte = blob_info;
+    } else if (*last_blob_info_byte != blob_info) {
+        // we have a mismatch - report the error
+        pmix_show_help("help-pmix-server.txt", "collection-mismatch", true);
+        return PMIX_ERR_BAD_PARAM;
+    }
+    return PMIX_SUCCESS;
+}
+
+/* Store every rank-level blob left in "bkt3", tracking each nspace seen
+ * in "nspaces". Reaching the end of the buffer is success - but only the
+ * end: a blob that starts and is then cut short is a truncated
+ * contribution, and storing what came before it as if that were all
+ * there was would lose the rest without a word. */
+static pmix_status_t store_blobs(pmix_buffer_t *bkt3, const char *nspace,
+                                 uint8_t blob_info_byte,
+                                 pmix_gds_base_store_modex_cb_fn_t cb_fn,
+                                 pmix_list_t *nspaces)
+{
+    pmix_status_t rc;
+    pmix_byte_object_t bo4;
+    pmix_buffer_t pbkt;
+    pmix_proc_t proc;
+    pmix_proclist_t *plist;
+    bool found;
+    int32_t cnt;
+
+   /* unpack the enclosed blobs from the various peers */
+    cnt = 1;
+    PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, bkt3, &bo4, &cnt, PMIX_BYTE_OBJECT);
+    while (PMIX_SUCCESS == rc) {
+        /* unpack all the kval's from this peer and store them in
+         * our GDS. Note that PMIx by design holds all data at
+         * the server level until requested. If our GDS is a
+         * shared memory region, then the data may be available
+         * right away - but the client still has to be notified
+         * of its presence. */
+
+        /* setup the byte object for unpacking */
+        PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
+        PMIX_LOAD_BUFFER(pmix_globals.mypeer, &pbkt, bo4.bytes, bo4.size);
+
+        // unpack the proc that provided this data
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, &proc, &cnt, PMIX_PROC);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+            PMIX_DESTRUCT(&pbkt);
+            break;
+        }
+
+        /* the caller may have asked for only one nspace's data -
+         * local clients of different nspaces can be on different
+         * gds modules, so the same payload gets walked once for
+         * each of them, each time storing only its own share */
+        if (NULL != nspace && !PMIX_CHECK_NSPACE(nspace, proc.nspace)) {
+            PMIX_DESTRUCT(&pbkt);
+            /* get the next peer-level blob */
+            cnt = 1;
+            PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, bkt3, &bo4, &cnt,
+                               PMIX_BYTE_OBJECT);
+            continue;
+        }
+
+        // track the nspace involved
+        found = false;
+        PMIX_LIST_FOREACH(plist, nspaces, pmix_proclist_t) {
+            if (PMIX_CHECK_NSPACE(plist->proc.nspace, proc.nspace)) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            plist = PMIX_NEW(pmix_proclist_t);
+            PMIX_LOAD_NSPACE(plist->proc.nspace, proc.nspace);
+            pmix_list_append(nspaces, &plist->super);
+        }
+
+        // call the specific GDS component-provided function to store it
+        rc = cb_fn(&proc, &pbkt, blob_info_byte);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+            PMIX_DESTRUCT(&pbkt);
+            break;
+        }
+        PMIX_DESTRUCT(&pbkt);
+        /* get the next peer-level blob */
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, bkt3, &bo4, &cnt, PMIX_BYTE_OBJECT);
+    }
+
+    if (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER == rc) {
+        if ((size_t) (bkt3->unpack_ptr - bkt3->base_ptr) < bkt3->bytes_used) {
+            rc = PMIX_ERR_UNPACK_FAILURE;
+            PMIX_ERROR_LOG(rc);
+        } else {
+            rc = PMIX_SUCCESS;
+        }
+    } else if (PMIX_SUCCESS != rc) {
+        PMIX_ERROR_LOG(rc);
+    }
+    return rc;
+}
+
+/* One frame of a framed contribution, expanded on a worker */
+typedef struct {
+    const pmix_compress_frames_t *frames;
+    size_t n;
+    uint8_t *bytes;
+    size_t size;
+} frame_read_t;
+
+static pmix_status_t read_frame(void *items, size_t n)
+{
+    frame_read_t *fr = &((frame_read_t *) items)[n];
+
+    if (!pmix_compress_base_frames_read(fr->frames, fr->n, &fr->bytes, &fr->size)) {
+        return PMIX_ERR_UNPACK_FAILURE;
+    }
+    return PMIX_SUCCESS;
+}
+
+/* Store a contribution sent as a framed container (see pack_bucket in
+ * src/server/pmix_server_fence.c): the caller has read the marker, and
+ * "bkt" holds the container next.
+ *
+ * The sender cut the frames where one packed item of the bucket ends
+ * and the next begins, so each frame unpacks on its own. That is what
+ * lets this store one frame's ranks and let the frame go before the
+ * next is expanded, rather than expanding the whole contribution first:
+ * what is held at any moment is the compressed container plus the
+ * frames in hand, not the container plus all of it expanded. Frames
+ * are expanded a batch at a time across pmix_server_fence_threads - the
+ * expanding is independent per frame, the storing is not, so each batch
+ * is then stored in order on this thread. */
+static pmix_status_t store_framed(pmix_buffer_t *bkt, const char *nspace,
+                                  pmix_gds_base_store_modex_cb_fn_t cb_fn,
+                                  pmix_collect_t *last_blob_info_byte,
+                                  pmix_list_t *nspaces)
+{
+    pmix_status_t rc;
+    pmix_byte_object_t bo;
+    pmix_compress_frames_t frames;
+    pmix_buffer_t fbkt;
+    frame_read_t *batch = NULL;
+    size_t first, i, nbatch, nworkers;
+    uint8_t blob_info_byte = 0;
+    int32_t cnt = 1;
+
+    PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, bkt, &bo, &cnt, PMIX_BYTE_OBJECT);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
+    if (!pmix_compress_base_frames_open(&frames, (uint8_t *) bo.bytes, bo.size)) {
+        rc = PMIX_ERR_UNPACK_FAILURE;
+        PMIX_ERROR_LOG(rc);
+        PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+        return rc;
+    }
+    nworkers = pmix_parallel_nworkers(pmix_server_globals.fence_threads, frames.nframes, 1);
+    batch = (frame_read_t *) calloc(nworkers, sizeof(*batch));
+    if (NULL == batch) {
+        PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+        PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+        return PMIX_ERR_NOMEM;
+    }
+
+    for (first = 0; first < frames.nframes && PMIX_SUCCESS == rc; first += nbatch) {
+        nbatch = frames.nframes - first;
+        if (nbatch > nworkers) {
+            nbatch = nworkers;
+        }
+        for (i = 0; i < nbatch; i++) {
+            batch[i].frames = &frames;
+            batch[i].n = first + i;
+            batch[i].bytes = NULL;
+            batch[i].size = 0;
+        }
+        rc = pmix_parallel_items(read_frame, batch, 0, nbatch, nworkers);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+        }
+        for (i = 0; i < nbatch; i++) {
+            if (PMIX_SUCCESS != rc) {
+                free(batch[i].bytes);
+                continue;
+            }
+            PMIX_CONSTRUCT(&fbkt, pmix_buffer_t);
+            PMIX_LOAD_BUFFER(pmix_globals.mypeer, &fbkt, batch[i].bytes, batch[i].size);
+            /* the collect flag leads the bucket, so the first frame */
+            if (0 == first + i) {
+                cnt = 1;
+                PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &fbkt, &blob_info_byte, &cnt,
+                                   PMIX_BYTE);
+                if (PMIX_SUCCESS != rc) {
+                    PMIX_ERROR_LOG(rc);
+                } else {
+                    rc = check_blob_info(blob_info_byte, last_blob_info_byte);
+                }
+            }
+            if (PMIX_SUCCESS == rc) {
+                rc = store_blobs(&fbkt, nspace, blob_info_byte, cb_fn, nspaces);
+            }
+            PMIX_DESTRUCT(&fbkt);
+        }
+    }
+    free(batch);
+    PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+    return rc;
+}
+
 pmix_status_t pmix_gds_base_store_modex(pmix_buffer_t *buff,
                                         const char *nspace,
                                         pmix_gds_base_store_modex_cb_fn_t cb_fn,
@@ -130,13 +394,11 @@ pmix_status_t pmix_gds_base_store_modex(pmix_buffer_t *buff,
 {
     pmix_status_t rc = PMIX_SUCCESS;
     pmix_buffer_t bkt, bkt3;
-    pmix_byte_object_t bo, bo3, bo4, wbo;
+    pmix_byte_object_t bo, bo3, wbo;
     int32_t cnt = 1;
     pmix_server_trkr_t *trk = (pmix_server_trkr_t *) cbdata;
-    pmix_proc_t proc;
-    pmix_buffer_t pbkt;
-    bool compressed, decompressed, found;
-    pmix_collect_t last_blob_info_byte, blob_info;
+    bool compressed, decompressed;
+    pmix_collect_t last_blob_info_byte;
     /* PMIX_BYTE writes exactly one byte through this pointer, and
      * pmix_collect_t is an enum carrying a negative member - so the
      * compiler makes it int-sized and an unpack into it leaves three
@@ -192,139 +454,59 @@ pmix_status_t pmix_gds_base_store_modex(pmix_buffer_t *buff,
                 goto exit;
             }
 
-            // decompress it if required
-            if (compressed) {
-                decompressed = pmix_compress.decompress((uint8_t**)&wbo.bytes, &wbo.size,
-                                                        (uint8_t*)bo3.bytes, bo3.size);
-                if (decompressed) {
-                    PMIX_BYTE_OBJECT_DESTRUCT(&bo3);
-                    bo3.bytes = wbo.bytes;
-                    bo3.size = wbo.size;
-                } else {
-                    /* The sender said these bytes are compressed. If we
-                     * cannot expand them we have no data, not the
-                     * original bytes - carrying on would hand the
-                     * compressed stream to the unpacker and report
-                     * whatever it made of it. */
-                    PMIX_ERROR_LOG(PMIX_ERR_UNPACK_FAILURE);
-                    PMIX_BYTE_OBJECT_DESTRUCT(&bo3);
-                    rc = PMIX_ERR_UNPACK_FAILURE;
+            /* a compressed flag over an empty object is the marker for a
+             * contribution sent as a framed container - stored a frame
+             * at a time, never expanded whole */
+            if (compressed && 0 == bo3.size) {
+                rc = store_framed(&bkt, nspace, cb_fn, &last_blob_info_byte, &nspaces);
+                if (PMIX_SUCCESS != rc) {
                     goto exit;
                 }
-            }
+            } else {
+                // decompress it if required
+                if (compressed) {
+                    decompressed = pmix_compress.decompress((uint8_t**)&wbo.bytes, &wbo.size,
+                                                            (uint8_t*)bo3.bytes, bo3.size);
+                    if (decompressed) {
+                        PMIX_BYTE_OBJECT_DESTRUCT(&bo3);
+                        bo3.bytes = wbo.bytes;
+                        bo3.size = wbo.size;
+                    } else {
+                        /* The sender said these bytes are compressed. If we
+                         * cannot expand them we have no data, not the
+                         * original bytes - carrying on would hand the
+                         * compressed stream to the unpacker and report
+                         * whatever it made of it. */
+                        PMIX_ERROR_LOG(PMIX_ERR_UNPACK_FAILURE);
+                        PMIX_BYTE_OBJECT_DESTRUCT(&bo3);
+                        rc = PMIX_ERR_UNPACK_FAILURE;
+                        goto exit;
+                    }
+                }
 
-            // set it up for unpacking
-            PMIX_CONSTRUCT(&bkt3, pmix_buffer_t);
-            PMIX_LOAD_BUFFER(pmix_globals.mypeer, &bkt3, bo3.bytes, bo3.size);
+                // set it up for unpacking
+                PMIX_CONSTRUCT(&bkt3, pmix_buffer_t);
+                PMIX_LOAD_BUFFER(pmix_globals.mypeer, &bkt3, bo3.bytes, bo3.size);
 
-            // unpack the flag indicating if data was collected on that node
-            cnt = 1;
-            PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &bkt3, &blob_info_byte, &cnt, PMIX_BYTE);
-            if (PMIX_SUCCESS != rc) {
-                PMIX_ERROR_LOG(rc);
-                PMIX_DESTRUCT(&bkt3);
-                goto exit;
-            }
-            blob_info = (pmix_collect_t) blob_info_byte;
-            /* Screen the value before comparing it. The check below only
-             * asks whether the servers agree with each other, so a marker
-             * they all agree on and none of us can act on would otherwise
-             * pass straight through. Two cases, and they fail differently:
-             *
-             * PMIX_MODEX_DELTA is honored - the kind is handed to the
-             * component's callback, which decides what it means for its
-             * own storage (gds/hash accumulates, so nothing; gds/shmem3
-             * keeps the generations a delta does not repeat).
-             *
-             * Anything else is a value no release ever defined, so the
-             * sender is not something this code can reason about. */
-            if (PMIX_COLLECT_NO != blob_info && PMIX_COLLECT_YES != blob_info
-                && PMIX_MODEX_DELTA != blob_info) {
-                PMIX_ERROR_LOG(PMIX_ERR_BAD_PARAM);
-                rc = PMIX_ERR_BAD_PARAM;
-                PMIX_DESTRUCT(&bkt3);
-                goto exit;
-            }
-            if (PMIX_COLLECT_INVALID == last_blob_info_byte) {
-                last_blob_info_byte = blob_info;
-            } else if (last_blob_info_byte != blob_info) {
-                // we have a mismatch - report the error
-                pmix_show_help("help-pmix-server.txt", "collection-mismatch", true);
-                rc = PMIX_ERR_BAD_PARAM;
-                PMIX_DESTRUCT(&bkt3);
-                goto exit;
-            }
-
-           /* unpack the enclosed blobs from the various peers */
-            cnt = 1;
-            PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &bkt3, &bo4, &cnt, PMIX_BYTE_OBJECT);
-            while (PMIX_SUCCESS == rc) {
-                /* unpack all the kval's from this peer and store them in
-                 * our GDS. Note that PMIx by design holds all data at
-                 * the server level until requested. If our GDS is a
-                 * shared memory region, then the data may be available
-                 * right away - but the client still has to be notified
-                 * of its presence. */
-
-                /* setup the byte object for unpacking */
-                PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
-                PMIX_LOAD_BUFFER(pmix_globals.mypeer, &pbkt, bo4.bytes, bo4.size);
-
-                // unpack the proc that provided this data
+                // unpack the flag indicating if data was collected on that node
                 cnt = 1;
-                PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, &proc, &cnt, PMIX_PROC);
+                PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &bkt3, &blob_info_byte, &cnt, PMIX_BYTE);
                 if (PMIX_SUCCESS != rc) {
                     PMIX_ERROR_LOG(rc);
-                    PMIX_DESTRUCT(&pbkt);
-                    break;
-                }
-
-                /* the caller may have asked for only one nspace's data -
-                 * local clients of different nspaces can be on different
-                 * gds modules, so the same payload gets walked once for
-                 * each of them, each time storing only its own share */
-                if (NULL != nspace && !PMIX_CHECK_NSPACE(nspace, proc.nspace)) {
-                    PMIX_DESTRUCT(&pbkt);
-                    /* get the next peer-level blob */
-                    cnt = 1;
-                    PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &bkt3, &bo4, &cnt,
-                                       PMIX_BYTE_OBJECT);
-                    continue;
-                }
-
-                // track the nspace involved
-                found = false;
-                PMIX_LIST_FOREACH(plist, &nspaces, pmix_proclist_t) {
-                    if (PMIX_CHECK_NSPACE(plist->proc.nspace, proc.nspace)) {
-                        found = true;
-                        break;
-                    }
+                    PMIX_DESTRUCT(&bkt3);
+                    goto exit;
                 }
-                if (!found) {
-                    plist = PMIX_NEW(pmix_proclist_t);
-                    PMIX_LOAD_NSPACE(plist->proc.nspace, proc.nspace);
-                    pmix_list_append(&nspaces, &plist->super);
+                rc = check_blob_info(blob_info_byte, &last_blob_info_byte);
+                if (PMIX_SUCCESS != rc) {
+                    PMIX_DESTRUCT(&bkt3);
+                    goto exit;
                 }
 
-                // call the specific GDS component-provided function to store it
-                rc = cb_fn(&proc, &pbkt, blob_info_byte);
+                rc = store_blobs(&bkt3, nspace, blob_info_byte, cb_fn, &nspaces);
+                PMIX_DESTRUCT(&bkt3);
                 if (PMIX_SUCCESS != rc) {
-                    PMIX_ERROR_LOG(rc);
-                    PMIX_DESTRUCT(&pbkt);
-                    break;
+                    goto exit;
                 }
-                PMIX_DESTRUCT(&pbkt);
-                /* get the next peer-level blob */
-                cnt = 1;
-                PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &bkt3, &bo4, &cnt, PMIX_BYTE_OBJECT);
-            }
-            PMIX_DESTRUCT(&bkt3);
-
-            if (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER == rc) {
-                rc = PMIX_SUCCESS;
-            } else if (PMIX_SUCCESS != rc) {
-                PMIX_ERROR_LOG(rc);
-                goto exit;
             }
             // prep for next cycle
             PMIX_DESTRUCT(&bkt);
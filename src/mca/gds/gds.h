@@ -164,8 +164,8 @@ typedef pmix_status_t (*pmix_gds_base_module_cache_job_info_fn_t)(struct pmix_na
  * we don't know the GDS component to use for that application until
  * a local client contacts us. Thus, the module is required to process
  * the job-level info cached in the pmix_namespace_t for this job and
- * do whatever is necessary to support the client, packing any required
- * return message into the provided buffer.
+ * do whatever is necessary to support the client, and return the
+ * message to be sent to it.
  *
  * This function will be called once for each local client of
  * a given nspace. PMIx assumes that all peers of a given nspace
@@ -184,9 +184,19 @@ typedef pmix_status_t (*pmix_gds_base_module_cache_job_info_fn_t)(struct pmix_na
  * The pmix_peer_t of the requesting client is provided here so that
  * the module can access the job-level info cached on the corresponding
  * pmix_namespace_t pointed to by the pmix_peer_t
+ *
+ * On success *reply holds a buffer carrying one reference that belongs
+ * to the caller, which queues it to the client as it stands. That need
+ * not be a new buffer: a module that keeps the packed reply for the
+ * next client of the nspace should PMIX_RETAIN its cached buffer and
+ * return that, instead of copying what may be megabytes of job map
+ * once per local client. The caller and the send path treat the
+ * buffer as read-only, and so must the module once it has handed it
+ * out - see PMIX_SERVER_QUEUE_SHARED_REPLY. On error *reply is left
+ * untouched.
  */
 typedef pmix_status_t (*pmix_gds_base_module_register_job_info_fn_t)(struct pmix_peer_t *pr,
-                                                                     pmix_buffer_t *reply);
+                                                                     pmix_buffer_t **reply);
 
 /* define a convenience macro for registering job info for
  * a given peer */
@@ -309,7 +319,12 @@ typedef pmix_status_t (*pmix_gds_base_module_mark_modex_complete_fn_t)(struct pm
                                                                        pmix_buffer_t *buff);
 /* Resolved from the peer being replied to, not from the local server:
  * this adds whatever that peer's own module needs in order to reach the
- * modex data - for shmem3, the segment info it must map. */
+ * modex data - for shmem3, the segment info it must map.
+ *
+ * What is added may depend on the peer's module and wire format, but
+ * not on which peer of them it is: the server builds one release per
+ * such combination and queues it to every participant that shares it
+ * (see _mdxcbfunc). */
 #define PMIX_GDS_MARK_MODEX_COMPLETE(r, p, l, b)                            \
     do {                                                                    \
         pmix_gds_base_module_t *_g = PMIX_GDS_PEER_MODULE(p);               \
@@ -543,6 +558,24 @@ typedef pmix_status_t (*pmix_gds_base_module_fetch_array_fn_t)(struct pmix_peer_
         }                                                                   \
     } while(0)
 
+/**
+ * Report how this module's datastore is using the memory it holds, to
+ * answer PMIX_QUERY_GDS_USAGE. Optional: a module that keeps nothing
+ * worth measuring - gds/hash, whose memory is the process heap - leaves
+ * it NULL.
+ *
+ * Called on the progress thread, so it may read whatever the module
+ * keeps there without locking.
+ *
+ * @param nspace  report on this namespace only; NULL for all of them
+ * @param kvs     list to append a pmix_kval_t to for each thing reported,
+ *                keyed PMIX_GDS_SEGMENT_USAGE or PMIX_GDS_ATTACH_FALLBACKS
+ *
+ * @return PMIX_SUCCESS if anything was appended, PMIX_ERR_NOT_FOUND if
+ *         there was nothing to report.
+ */
+typedef pmix_status_t (*pmix_gds_base_module_report_usage_fn_t)(const char *nspace,
+                                                                pmix_list_t *kvs);
 
 /* structure for gds modules */
 typedef struct {
@@ -566,6 +599,7 @@ typedef struct {
     pmix_gds_base_module_fetch_array_fn_t           fetch_arrays;
     pmix_gds_base_module_mark_modex_complete_fn_t   mark_modex_complete;
     pmix_gds_base_module_recv_modex_complete_fn_t   recv_modex_complete;
+    pmix_gds_base_module_report_usage_fn_t          report_usage;
 } pmix_gds_base_module_t;
 
 /* NOTE: there is no public GDS interface structure - all access is
@@ -581,7 +615,7 @@ typedef pmix_mca_base_component_t pmix_gds_base_component_t;
  * Bump it on any change to the module interface that a component built
  * against the previous one would not survive. */
 #define PMIX_MCA_gds_MAJOR_VERSION   1
-#define PMIX_MCA_gds_MINOR_VERSION   0
+#define PMIX_MCA_gds_MINOR_VERSION   1
 #define PMIX_MCA_gds_RELEASE_VERSION 0
 
 END_C_DECLS
@@ -16,6 +16,7 @@
 
 #include "src/include/pmix_config.h"
 
+#include <assert.h>
 #include <string.h>
 #ifdef HAVE_UNISTD_H
 #    include <unistd.h>
@@ -60,7 +61,7 @@ static pmix_status_t hash_assign_module(pmix_info_t *info, size_t ninfo, int *pr
 static pmix_status_t hash_cache_job_info(struct pmix_namespace_t *ns, pmix_info_t info[],
                                          size_t ninfo);
 
-static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t *reply);
+static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t **reply);
 
 static pmix_status_t hash_store_job_info(const char *nspace, pmix_buffer_t *buf);
 
@@ -90,28 +91,182 @@ static pmix_status_t mark_modex_complete(struct pmix_peer_t *peer,
 
 static pmix_status_t recv_modex_complete(pmix_buffer_t *buff);
 
+/* Entry points that touch the store run under the component lock - see
+ * the wrappers below. The rest never look at it. */
+static pmix_status_t locked_cache_job_info(struct pmix_namespace_t *ns, pmix_info_t info[],
+                                           size_t ninfo);
+static pmix_status_t locked_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t **reply);
+static pmix_status_t locked_store_job_info(const char *nspace, pmix_buffer_t *buf);
+static pmix_status_t locked_store(const pmix_proc_t *proc, pmix_scope_t scope,
+                                  pmix_kval_t *kv);
+static pmix_status_t locked_store_modex(pmix_buffer_t *buff, const char *nspace,
+                                        void *cbdata);
+static pmix_status_t locked_fetch(struct pmix_peer_t *pr, const pmix_proc_t *proc,
+                                  pmix_scope_t scope, bool copy, const char *key,
+                                  pmix_info_t qualifiers[], size_t nqual, pmix_list_t *kvs);
+static pmix_status_t locked_del_nspace(const char *nspace);
+static pmix_status_t locked_accept_kvs_resp(pmix_buffer_t *buf);
+static pmix_status_t locked_fetch_arrays(struct pmix_peer_t *pr, pmix_buffer_t *reply);
+
 pmix_gds_base_module_t pmix_hash_module = {
     .name = "hash",
-    .is_tsafe = false,
+    .is_tsafe = true,
     .init = hash_init,
     .finalize = hash_finalize,
     .assign_module = hash_assign_module,
-    .cache_job_info = hash_cache_job_info,
-    .register_job_info = hash_register_job_info,
-    .store_job_info = hash_store_job_info,
-    .store = pmix_gds_hash_store,
-    .store_modex = hash_store_modex,
-    .fetch = pmix_gds_hash_fetch,
+    .cache_job_info = locked_cache_job_info,
+    .register_job_info = locked_register_job_info,
+    .store_job_info = locked_store_job_info,
+    .store = locked_store,
+    .store_modex = locked_store_modex,
+    .fetch = locked_fetch,
     .setup_fork = setup_fork,
     .add_nspace = nspace_add,
-    .del_nspace = nspace_del,
+    .del_nspace = locked_del_nspace,
     .assemb_kvs_req = assemb_kvs_req,
-    .accept_kvs_resp = accept_kvs_resp,
-    .fetch_arrays = pmix_gds_hash_fetch_arrays,
+    .accept_kvs_resp = locked_accept_kvs_resp,
+    .fetch_arrays = locked_fetch_arrays,
     .mark_modex_complete = mark_modex_complete,
     .recv_modex_complete = recv_modex_complete
 };
 
+/* The lock is what lets a fetch run on an application thread, but a
+ * writer that reaches a fetch on its own thread - through a pmdl or
+ * other callback - must not then wait on itself. Each thread therefore
+ * counts how deeply it is inside the module, and only the outermost
+ * entry takes or drops the lock.
+ *
+ * That is only sound one way round. A read nested in a write is covered
+ * by the write lock, but a write nested in a read would run with other
+ * readers in the store, and a read lock cannot be upgraded in place. So
+ * each thread also records which mode its outermost entry took, and a
+ * nested entry that needs more than that is a bug in whatever led to
+ * it: it is asserted against, and logged where asserts are compiled
+ * out. */
+static _Thread_local int lockdepth = 0;
+static _Thread_local bool lockwrite = false;
+
+static void hash_lock(bool write)
+{
+    if (0 == lockdepth++) {
+        if (write) {
+            pthread_rwlock_wrlock(&pmix_mca_gds_hash_component.lock);
+        } else {
+            pthread_rwlock_rdlock(&pmix_mca_gds_hash_component.lock);
+        }
+        lockwrite = write;
+    } else if (write && !lockwrite) {
+        PMIX_ERROR_LOG(PMIX_ERR_NOT_SUPPORTED);
+        assert(!"gds/hash: store entered from inside a fetch");
+    }
+}
+
+static void hash_unlock(void)
+{
+    if (0 == --lockdepth) {
+        lockwrite = false;
+        pthread_rwlock_unlock(&pmix_mca_gds_hash_component.lock);
+    }
+}
+
+static pmix_status_t locked_cache_job_info(struct pmix_namespace_t *ns, pmix_info_t info[],
+                                           size_t ninfo)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = hash_cache_job_info(ns, info, ninfo);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t **reply)
+{
+    pmix_status_t rc;
+
+    /* creates the job tracker on first use */
+    hash_lock(true);
+    rc = hash_register_job_info(pr, reply);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_store_job_info(const char *nspace, pmix_buffer_t *buf)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = hash_store_job_info(nspace, buf);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_store(const pmix_proc_t *proc, pmix_scope_t scope,
+                                  pmix_kval_t *kv)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = pmix_gds_hash_store(proc, scope, kv);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_store_modex(pmix_buffer_t *buff, const char *nspace,
+                                        void *cbdata)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = hash_store_modex(buff, nspace, cbdata);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_fetch(struct pmix_peer_t *pr, const pmix_proc_t *proc,
+                                  pmix_scope_t scope, bool copy, const char *key,
+                                  pmix_info_t qualifiers[], size_t nqual, pmix_list_t *kvs)
+{
+    pmix_status_t rc;
+
+    /* the results are copies made under the lock, so nothing the
+     * caller is handed refers back into the store once it is dropped */
+    hash_lock(false);
+    rc = pmix_gds_hash_fetch(pr, proc, scope, copy, key, qualifiers, nqual, kvs);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_del_nspace(const char *nspace)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = nspace_del(nspace);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_accept_kvs_resp(pmix_buffer_t *buf)
+{
+    pmix_status_t rc;
+
+    hash_lock(true);
+    rc = accept_kvs_resp(buf);
+    hash_unlock();
+    return rc;
+}
+
+static pmix_status_t locked_fetch_arrays(struct pmix_peer_t *pr, pmix_buffer_t *reply)
+{
+    pmix_status_t rc;
+
+    hash_lock(false);
+    rc = pmix_gds_hash_fetch_arrays(pr, reply);
+    hash_unlock();
+    return rc;
+}
+
 static pmix_status_t hash_init(pmix_info_t info[], size_t ninfo)
 {
 
@@ -119,6 +274,7 @@ static pmix_status_t hash_init(pmix_info_t info[], size_t ninfo)
 
     PMIX_CONSTRUCT(&pmix_mca_gds_hash_component.mysessions, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_mca_gds_hash_component.myjobs, pmix_list_t);
+    pthread_rwlock_init(&pmix_mca_gds_hash_component.lock, NULL);
 
     return PMIX_SUCCESS;
 }
@@ -127,6 +283,7 @@ static void hash_finalize(void)
 {
     PMIX_LIST_DESTRUCT(&pmix_mca_gds_hash_component.mysessions);
     PMIX_LIST_DESTRUCT(&pmix_mca_gds_hash_component.myjobs);
+    pthread_rwlock_destroy(&pmix_mca_gds_hash_component.lock);
     return;
 }
 
@@ -726,10 +883,11 @@ static pmix_status_t register_info(pmix_peer_t *peer,
 /* the purpose of this function is to pack the job-level
  * info stored in the pmix_namespace_t into a buffer and send
  * it to the given client */
-static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t *reply)
+static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_t **reply)
 {
     pmix_peer_t *peer = (pmix_peer_t *) pr;
     pmix_namespace_t *ns = peer->nptr;
+    pmix_buffer_t *bkt;
     char *msg;
     pmix_status_t rc;
     pmix_job_t *trk;
@@ -751,20 +909,22 @@ static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_
      * time doing it again */
     if (NULL != ns->jobbkt) {
         pmix_output_verbose(2, pmix_gds_base_framework.framework_output,
-                            "[%s:%d] gds:hash:register_job_info copying prepacked payload",
+                            "[%s:%d] gds:hash:register_job_info sharing prepacked payload",
                             pmix_globals.myid.nspace, pmix_globals.myid.rank);
-        /* we have packed this before - can just deliver it */
-        PMIX_BFROPS_COPY_PAYLOAD(rc, peer, reply, ns->jobbkt);
-        if (PMIX_SUCCESS != rc) {
-            PMIX_ERROR_LOG(rc);
-        }
+        /* we have packed this before - deliver the very same buffer.
+         * Every local client of the nspace gets identical bytes, so a
+         * reference is all each of them needs; copying it here put one
+         * full job map per client into the send queues at once. */
+        PMIX_RETAIN(ns->jobbkt);
+        *reply = ns->jobbkt;
         /* now see if we have delivered it to all our local clients for
          * this nspace. ndelivered counts the deliveries that have
          * *completed*, and the caller bumps it after we return - so on
          * this call it names the client before this one. Comparing it
          * with nlocalprocs directly therefore never matched during the
          * nlocalprocs deliveries that actually happen, and the cached
-         * copy was held until the namespace itself went away. */
+         * copy was held until the namespace itself went away. Dropping
+         * our reference does not disturb the sends still holding one. */
         if (!PMIX_PEER_IS_LAUNCHER(pmix_globals.mypeer) &&
             ns->ndelivered + 1 == ns->nlocalprocs) {
             /* we have, so let's get rid of the packed
@@ -772,7 +932,7 @@ static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_
             PMIX_RELEASE(ns->jobbkt);
             ns->jobbkt = NULL;
         }
-        return rc;
+        return PMIX_SUCCESS;
     }
 
     /* setup a tracker for this nspace as we will likely
@@ -782,6 +942,11 @@ static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_
         return PMIX_ERR_NOMEM;
     }
 
+    bkt = PMIX_NEW(pmix_buffer_t);
+    if (NULL == bkt) {
+        return PMIX_ERR_NOMEM;
+    }
+
     /* the job info for the specified nspace has
      * been given to us in the info array - pack
      * them for delivery */
@@ -790,25 +955,27 @@ static pmix_status_t hash_register_job_info(struct pmix_peer_t *pr, pmix_buffer_
                         "[%s:%d] gds:hash:register_job_info packing new payload",
                         pmix_globals.myid.nspace, pmix_globals.myid.rank);
     msg = ns->nspace;
-    PMIX_BFROPS_PACK(rc, peer, reply, &msg, 1, PMIX_STRING);
+    PMIX_BFROPS_PACK(rc, peer, bkt, &msg, 1, PMIX_STRING);
     if (PMIX_SUCCESS != rc) {
         PMIX_ERROR_LOG(rc);
+        PMIX_RELEASE(bkt);
         return rc;
     }
 
-    rc = register_info(peer, ns, reply);
-    if (PMIX_SUCCESS == rc) {
-        /* if we have more than one local client for this nspace,
-         * save this packed object so we don't do this again */
-        if (PMIX_PEER_IS_LAUNCHER(pmix_globals.mypeer) || 1 < ns->nlocalprocs) {
-            PMIX_RETAIN(reply);
-            ns->jobbkt = reply;
-        }
-    } else {
+    rc = register_info(peer, ns, bkt);
+    if (PMIX_SUCCESS != rc) {
         PMIX_ERROR_LOG(rc);
+        PMIX_RELEASE(bkt);
+        return rc;
     }
-
-    return rc;
+    /* if we have more than one local client for this nspace,
+     * save this packed object so we don't do this again */
+    if (PMIX_PEER_IS_LAUNCHER(pmix_globals.mypeer) || 1 < ns->nlocalprocs) {
+        PMIX_RETAIN(bkt);
+        ns->jobbkt = bkt;
+    }
+    *reply = bkt;
+    return PMIX_SUCCESS;
 }
 
 static pmix_status_t hash_store_job_info(const char *nspace, pmix_buffer_t *buf)
@@ -827,7 +994,7 @@ static pmix_status_t hash_store_job_info(const char *nspace, pmix_buffer_t *buf)
     pmix_hash_table_t *ht;
     char **nodelist = NULL;
     pmix_nodeinfo_t *nd;
-    pmix_namespace_t *ns, *nptr;
+    pmix_namespace_t *nptr;
     pmix_info_t *iptr;
     pmix_session_t *s = NULL;
     pmix_apptrkr_t *apptr;
@@ -852,13 +1019,7 @@ static pmix_status_t hash_store_job_info(const char *nspace, pmix_buffer_t *buf)
     ht = &trk->internal;
 
     /* retrieve the nspace pointer */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(ns->nspace, nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(nspace);
     if (NULL == nptr) {
         /* only can happen if we are out of mem */
         return PMIX_ERR_NOMEM;
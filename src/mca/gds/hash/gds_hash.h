@@ -14,6 +14,8 @@
 
 #include "src/include/pmix_config.h"
 
+#include <pthread.h>
+
 #include "src/class/pmix_list.h"
 #include "src/include/pmix_globals.h"
 #include "src/util/pmix_argv.h"
@@ -30,6 +32,13 @@ typedef struct {
     pmix_gds_base_component_t super;
     pmix_list_t mysessions;
     pmix_list_t myjobs;
+    /* Guards the two lists above and everything reachable from them.
+     * Every module entry point takes it - fetch for reading, everything
+     * else for writing - so that a fetch may run on an application
+     * thread while the progress thread updates the store. The functions
+     * behind the entry points never take it themselves, and must not
+     * call back in through the module. */
+    pthread_rwlock_t lock;
 } pmix_gds_hash_component_t;
 
 /* the component must be visible data for the linker to find it */
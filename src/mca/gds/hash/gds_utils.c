@@ -56,7 +56,7 @@
 pmix_job_t *pmix_gds_hash_get_tracker(const pmix_nspace_t nspace, bool create)
 {
     pmix_job_t *trk, *t;
-    pmix_namespace_t *ns, *nptr;
+    pmix_namespace_t *nptr;
 
     /* find the hash table for this nspace */
     trk = NULL;
@@ -71,13 +71,7 @@ pmix_job_t *pmix_gds_hash_get_tracker(const pmix_nspace_t nspace, bool create)
         trk = PMIX_NEW(pmix_job_t);
         trk->ns = strdup(nspace);
         /* see if we already have this nspace */
-        nptr = NULL;
-        PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (0 == strcmp(ns->nspace, nspace)) {
-                nptr = ns;
-                break;
-            }
-        }
+        nptr = pmix_nspace_lookup(nspace);
         if (NULL == nptr) {
             nptr = PMIX_NEW(pmix_namespace_t);
             if (NULL == nptr) {
@@ -85,7 +79,7 @@ pmix_job_t *pmix_gds_hash_get_tracker(const pmix_nspace_t nspace, bool create)
                 return NULL;
             }
             nptr->nspace = strdup(nspace);
-            pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+            pmix_nspace_add(nptr, false);
         }
         PMIX_RETAIN(nptr);
         trk->nptr = nptr;
@@ -209,6 +203,13 @@ pmix_session_t* pmix_gds_hash_check_session(pmix_job_t *trk,
     pmix_session_t *sptr;
     bool found;
 
+    /* Without "create" this only looks: it is how a fetch finds the
+     * session it was asked about, and fetches run under the module's
+     * read lock, several at once - so it must not re-point the job
+     * tracker at the session it finds, nor touch a reference count.
+     * The tracker is bound to its session when that session's info is
+     * stored, which is done under the write lock. */
+
     /* if the tracker is NULL, then they are asking for the
      * session tracker for a specific sid (which can be UINT32_MAX) */
     if (NULL == trk) {
@@ -240,9 +241,12 @@ pmix_session_t* pmix_gds_hash_check_session(pmix_job_t *trk,
             }
         }
         if (found) {
-            /* point the job tracker at this session */
-            PMIX_RETAIN(sptr);
-            trk->session = sptr;
+            /* point the job tracker at this session - but only when
+             * permitted to change things, see above */
+            if (create) {
+                PMIX_RETAIN(sptr);
+                trk->session = sptr;
+            }
             return sptr;
         }
         /* if it wasn't found, then create it if permitted */
@@ -275,11 +279,13 @@ pmix_session_t* pmix_gds_hash_check_session(pmix_job_t *trk,
             }
         }
         if (found) {
-            /* update the refcount on the current session object */
-            PMIX_RELEASE(trk->session);
-            /* point the job tracker at the new place */
-            PMIX_RETAIN(sptr);
-            trk->session = sptr;
+            if (create) {
+                /* update the refcount on the current session object */
+                PMIX_RELEASE(trk->session);
+                /* point the job tracker at the new place */
+                PMIX_RETAIN(sptr);
+                trk->session = sptr;
+            }
             return sptr;
         }
         /* if it wasn't found, then create it */
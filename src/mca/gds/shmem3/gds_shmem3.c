@@ -30,6 +30,8 @@
 #include "src/client/pmix_client_ops.h"
 #include "src/server/pmix_server_ops.h"
 
+#include <time.h>
+
 //
 // Notes for developers:
 // We cannot use PMIX_CONSTRUCT for data that are stored in shared memory
@@ -74,18 +76,16 @@
 "\n2.) Disabling gds/shmem3 via PMIX_MCA_gds=hash\n***\n"
 
 /**
- * Stores packed job information.
+ * Stores what has to be known about a job's data before it is stored.
+ * How much space it takes is not among it: that is measured by storing
+ * it; see size_shmem3_stores_for_local_job_data().
  */
 typedef struct {
     pmix_object_t super;
     /** Session ID associated with this job. */
     uint32_t session_id;
-    /** Size of packed data. */
-    size_t packed_size;
     /** Number of elements the local hash table needs - one per rank. */
     size_t hash_table_size;
-    /** Number of key/value pairs those elements will hold between them. */
-    size_t nkvals;
 } pmix_gds_shmem3_packed_local_job_info_t;
 PMIX_CLASS_DECLARATION(pmix_gds_shmem3_packed_local_job_info_t);
 
@@ -94,7 +94,9 @@ PMIX_CLASS_DECLARATION(pmix_gds_shmem3_packed_local_job_info_t);
  */
 typedef struct {
     size_t size;
-    size_t num_ht_elements;
+    /** Ranks and values the image's tables are sized for. */
+    size_t nranks;
+    size_t nkvals;
 } pmix_gds_shmem3_modex_info_t;
 
 static void
@@ -102,9 +104,7 @@ packed_job_info_construct(
     pmix_gds_shmem3_packed_local_job_info_t *pji
 ) {
     pji->session_id = UINT32_MAX;
-    pji->packed_size = 0;
     pji->hash_table_size = 0;
-    pji->nkvals = 0;
 }
 
 PMIX_CLASS_INSTANCE(
@@ -234,10 +234,27 @@ typedef struct {
  */
 typedef struct {
     pmix_object_t super;
-    /** Handle to shared-memory backing store. */
+    /** Handle to shared-memory backing store. NULL for a counting
+     *  allocator; see tma_init_counting(). */
     pmix_shmem_t *shmem3;
     /** Points to a value that maintains the next available address. */
     void **data_ptr;
+    /** Counting allocator only: the bytes the same requests would have
+     *  taken from a segment, and the heap blocks that stood in for them,
+     *  chained through their first word. */
+    size_t counted;
+    void *heap;
+    /** Bytes handed out and then given up - by a free, or by a realloc
+     *  that moved - which a bump allocator cannot take back. Reported as
+     *  PMIX_GDS_SEGMENT_STRANDED. */
+    size_t stranded;
+    /** Sub-arena only: the TMA chunks are carved from, the lock every
+     *  sub-arena of it takes to do so, and the part of the current chunk
+     *  not yet handed out. See pmix_gds_shmem3_subarena_init(). */
+    pmix_tma_t *parent;
+    pmix_mutex_t *parent_lock;
+    char *cur;
+    char *limit;
 } pmix_gds_shmem3_alloc_ctx_t;
 PMIX_CLASS_DECLARATION(pmix_gds_shmem3_alloc_ctx_t);
 
@@ -247,14 +264,31 @@ shmem3_allocator_construct(
 ) {
     a->shmem3 = NULL;
     a->data_ptr = NULL;
+    a->counted = 0;
+    a->heap = NULL;
+    a->stranded = 0;
+    a->parent = NULL;
+    a->parent_lock = NULL;
+    a->cur = NULL;
+    a->limit = NULL;
 }
 
 static void
 shmem3_allocator_destruct(
     pmix_gds_shmem3_alloc_ctx_t *a
 ) {
+    // Everything a counting allocator handed out goes at once. Nothing
+    // built from it is released first, nor needs to be: free is a no-op
+    // here, exactly as it is for a segment.
+    while (NULL != a->heap) {
+        void *const next = *(void **)a->heap;
+        free(a->heap);
+        a->heap = next;
+    }
     a->shmem3 = NULL;
     a->data_ptr = NULL;
+    a->parent = NULL;
+    a->parent_lock = NULL;
 }
 
 PMIX_CLASS_INSTANCE(
@@ -347,6 +381,101 @@ tma_alloc_header(
         ((char *)ptr - sizeof(pmix_gds_shmem3_tma_alloc_t));
 }
 
+/**
+ * The counting allocator's tma_carve(): the block comes from the heap,
+ * and what it would have cost in a segment - its header, then its size
+ * rounded up by addr_align() - is added to the tally. The block is laid
+ * out as a segment block is, header and all, so tma_realloc() works on
+ * it unchanged; a word ahead of the header chains it for release.
+ *
+ * It is zeroed because a segment block would have been: the structures
+ * built from these rely on that.
+ */
+static inline void *
+tma_count(
+    pmix_gds_shmem3_alloc_ctx_t *ctx,
+    size_t size
+) {
+    const size_t hdrsize = sizeof(pmix_gds_shmem3_tma_alloc_t);
+    const size_t lead = sizeof(void *) + hdrsize;
+
+    if (PMIX_UNLIKELY(SIZE_MAX - lead < size)) {
+        return NULL;
+    }
+    void **const blk = calloc(1, lead + size);
+    if (PMIX_UNLIKELY(NULL == blk)) {
+        return NULL;
+    }
+    *blk = ctx->heap;
+    ctx->heap = blk;
+
+    pmix_gds_shmem3_tma_alloc_t *const hdr =
+        (pmix_gds_shmem3_tma_alloc_t *)(blk + 1);
+    hdr->extent = size;
+    hdr->magic = PMIX_GDS_SHMEM3_TMA_ALLOC_MAGIC;
+
+    ctx->counted += hdrsize + (size_t)addr_align(NULL, size);
+    return (char *)hdr + hdrsize;
+}
+
+/**
+ * How much a sub-arena takes from its parent at a time, and the largest
+ * request it serves from that rather than passing straight through. The
+ * ratio bounds what a refill can strand at the tail of the chunk it
+ * abandons; the chunk bounds how often workers queue on the parent.
+ */
+#define PMIX_GDS_SHMEM3_SUBARENA_CHUNK (64 * 1024)
+#define PMIX_GDS_SHMEM3_SUBARENA_DIRECT (PMIX_GDS_SHMEM3_SUBARENA_CHUNK / 16)
+
+/**
+ * The sub-arena's tma_carve(): bump through the current chunk, taking a
+ * new one from the parent - under the lock the sub-arenas share - when
+ * it runs out. Blocks are laid out exactly as the parent lays out its
+ * own, header and all, so tma_realloc() and tma_free() work on them
+ * with either TMA.
+ *
+ * Which chunks a sub-arena takes depends only on the requests made of
+ * it, never on when the other sub-arenas make theirs. So a store pass
+ * that divides its work the same way asks the parent for the same
+ * blocks whether the parent is counting or carving, and the dry run's
+ * figure stays exact.
+ */
+static inline void *
+tma_subarena_carve(
+    pmix_gds_shmem3_alloc_ctx_t *ctx,
+    size_t size
+) {
+    const size_t hdrsize = sizeof(pmix_gds_shmem3_tma_alloc_t);
+    const size_t need = hdrsize + (size_t)addr_align(NULL, size);
+    void *base;
+
+    if (need > (size_t)(ctx->limit - ctx->cur)) {
+        if (PMIX_GDS_SHMEM3_SUBARENA_DIRECT < size) {
+            // Too big to be worth abandoning a chunk for.
+            pmix_mutex_lock(ctx->parent_lock);
+            base = pmix_tma_malloc(ctx->parent, size);
+            pmix_mutex_unlock(ctx->parent_lock);
+            return base;
+        }
+        pmix_mutex_lock(ctx->parent_lock);
+        char *const chunk = pmix_tma_malloc(ctx->parent, PMIX_GDS_SHMEM3_SUBARENA_CHUNK);
+        pmix_mutex_unlock(ctx->parent_lock);
+        if (PMIX_UNLIKELY(NULL == chunk)) {
+            return NULL;
+        }
+        ctx->stranded += (size_t)(ctx->limit - ctx->cur);
+        ctx->cur = chunk;
+        ctx->limit = chunk + PMIX_GDS_SHMEM3_SUBARENA_CHUNK;
+    }
+    pmix_gds_shmem3_tma_alloc_t *const hdr = (pmix_gds_shmem3_tma_alloc_t *)ctx->cur;
+    hdr->extent = size;
+    hdr->magic = PMIX_GDS_SHMEM3_TMA_ALLOC_MAGIC;
+
+    base = (char *)hdr + hdrsize;
+    ctx->cur += need;
+    return base;
+}
+
 /**
  * Carves a block of the requested size out of the segment, stamping its
  * header. The caller owns initializing the returned storage.
@@ -373,6 +502,13 @@ tma_carve(
         perror(EMSG_SHMEM3_OOM);
         abort();
     }
+    pmix_gds_shmem3_alloc_ctx_t *const ctx = tma_get_alloc_ctx(tma);
+    if (NULL != ctx->parent) {
+        return tma_subarena_carve(ctx, size);
+    }
+    if (NULL == ctx->shmem3) {
+        return tma_count(ctx, size);
+    }
     if (PMIX_UNLIKELY(tma_alloc_request_will_overflow(tma, size + hdrsize))) {
         return NULL;
     }
@@ -475,8 +611,19 @@ tma_free(
     struct pmix_tma *tma,
     void *ptr
 ) {
-    PMIX_HIDE_UNUSED_PARAMS(tma, ptr);
-    // We don't do anything for free.
+    // Nothing is given back - this is a bump allocator, and a client may
+    // already be reading the block - but what is given up is counted, so
+    // that a segment's stranded bytes can be reported rather than guessed.
+    // The magic check is tma_realloc()'s: a block without our header is
+    // one we cannot size, so it is left out rather than made up.
+    pmix_gds_shmem3_alloc_ctx_t *const ctx = tma_get_alloc_ctx(tma);
+    if (NULL == ptr || NULL == ctx) {
+        return;
+    }
+    const pmix_gds_shmem3_tma_alloc_t *const hdr = tma_alloc_header(ptr);
+    if (PMIX_GDS_SHMEM3_TMA_ALLOC_MAGIC == hdr->magic) {
+        ctx->stranded += sizeof(*hdr) + (size_t)addr_align(NULL, hdr->extent);
+    }
 }
 
 static void
@@ -506,6 +653,75 @@ tma_init(
     ctx->data_ptr = data_ptr;
 }
 
+/**
+ * A TMA that allocates from the heap and counts what a segment would
+ * have given up for the same requests; see tma_count().
+ *
+ * Running a store pass against one first is how a segment is sized: the
+ * pass makes exactly the requests it will make again against the real
+ * segment, so the tally is the size it needs rather than an estimate of
+ * it. Read the tally off with tma_counted(); releasing the context frees
+ * every block at once.
+ */
+static pmix_status_t
+tma_init_counting(
+    pmix_tma_t *tma,
+    size_t base_size
+) {
+    pmix_gds_shmem3_alloc_ctx_t *ctx = PMIX_NEW(pmix_gds_shmem3_alloc_ctx_t);
+    if (PMIX_UNLIKELY(NULL == ctx)) {
+        return PMIX_ERR_NOMEM;
+    }
+    tma_init_function_pointers(tma);
+    tma->data_context = (void *)ctx;
+    // What sits ahead of the first block in a real segment: the shared
+    // data structure that holds the TMA, rounded as the real one is.
+    ctx->counted = (size_t)addr_align(NULL, base_size);
+    return PMIX_SUCCESS;
+}
+
+static inline size_t
+tma_counted(
+    pmix_tma_t *tma
+) {
+    return tma_get_alloc_ctx(tma)->counted;
+}
+
+pmix_status_t
+pmix_gds_shmem3_subarena_init(
+    pmix_tma_t *parent,
+    pmix_mutex_t *lock,
+    pmix_tma_t *sub
+) {
+    pmix_gds_shmem3_alloc_ctx_t *ctx = PMIX_NEW(pmix_gds_shmem3_alloc_ctx_t);
+    if (PMIX_UNLIKELY(NULL == ctx)) {
+        return PMIX_ERR_NOMEM;
+    }
+    tma_init_function_pointers(sub);
+    sub->data_context = (void *)ctx;
+
+    ctx->shmem3 = tma_get_alloc_ctx(parent)->shmem3;
+    ctx->parent = parent;
+    ctx->parent_lock = lock;
+    return PMIX_SUCCESS;
+}
+
+void
+pmix_gds_shmem3_subarena_fini(
+    pmix_tma_t *sub
+) {
+    pmix_gds_shmem3_alloc_ctx_t *ctx = tma_get_alloc_ctx(sub);
+    if (NULL == ctx) {
+        return;
+    }
+    // What the sub-arena gave up, and the unused tail of its last chunk,
+    // are the parent segment's stranded bytes now.
+    pmix_gds_shmem3_alloc_ctx_t *const pctx = tma_get_alloc_ctx(ctx->parent);
+    pctx->stranded += ctx->stranded + (size_t)(ctx->limit - ctx->cur);
+    PMIX_RELEASE(ctx);
+    sub->data_context = NULL;
+}
+
 static void
 host_alias_construct(
     pmix_gds_shmem3_host_alias_t *a
@@ -589,6 +805,9 @@ job_construct(
     job->modex_shmem3 = PMIX_NEW(pmix_shmem_t);
     job->smmodex = NULL;
     job->modex_is_delta = false;
+    job->modex_need_bytes = 0;
+    job->modex_need_ranks = 0;
+    job->modex_need_kvals = 0;
     PMIX_CONSTRUCT(&job->modex_prior, pmix_list_t);
     PMIX_CONSTRUCT(&job->tombstones, pmix_list_t);
     PMIX_CONSTRUCT(&job->datalock, pmix_mutex_t);
@@ -596,8 +815,10 @@ job_construct(
     job->arena_base = 0;
     job->arena_size = 0;
     job->arena_static_used = 0;
-    job->arena_slot_bytes = 0;
-    job->arena_slots = 0;
+    // Usage reporting
+    for (int i = 0; i < PMIX_GDS_SHMEM3_INVALID_ID; ++i) {
+        job->attach_time[i] = 0.0;
+    }
     // Connection info
     job->conni = NULL;
 }
@@ -611,7 +832,8 @@ get_tma_by_shmem3_id(
         case PMIX_GDS_SHMEM3_JOB_ID:
             return &job->smdata->tma;
         case PMIX_GDS_SHMEM3_MODEX_ID:
-            return &job->smmodex->tma;
+            // A flat image; nothing in it was allocated through a TMA.
+            return NULL;
         case PMIX_GDS_SHMEM3_SESSION_ID:
             return &job->session->smdata->tma;
         case PMIX_GDS_SHMEM3_INVALID_ID:
@@ -643,6 +865,75 @@ get_shmem3_id_name(
     }
 }
 
+/**
+ * What one of a job's segments holds: logged by emit_shmem3_usage_stats(),
+ * reported by report_usage().
+ */
+typedef struct {
+    size_t size;
+    size_t used;
+    /** Known only where the allocator context is, which is to say by the
+     *  process that built the segment. Zero everywhere else. */
+    size_t stranded;
+    /** Modex only: the generations counted into size and used. */
+    uint32_t generations;
+} shmem3_usage_t;
+
+/**
+ * Measures a segment of this job that is mapped here.
+ *
+ * Works the same on a client as on the server: the job and session
+ * allocators keep their bump pointer in the segment, so how far it has
+ * got can be read by anyone who can read the segment. The modex images
+ * keep their own count, and for the modex the figures are the sum over
+ * every generation still held, since that is what the job is costing.
+ *
+ * Progress thread only - the modex chain is only ever changed there.
+ */
+static void
+measure_shmem3_usage(
+    pmix_gds_shmem3_job_t *job,
+    pmix_gds_shmem3_job_shmem3_id_t shmem3_id,
+    shmem3_usage_t *usage
+) {
+    memset(usage, 0, sizeof(*usage));
+
+    if (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id) {
+        if (NULL != job->smmodex) {
+            usage->size += job->modex_shmem3->size;
+            usage->used += (size_t)job->smmodex->used;
+            ++usage->generations;
+        }
+        pmix_gds_shmem3_modex_seg_t *seg;
+        PMIX_LIST_FOREACH (seg, &job->modex_prior, pmix_gds_shmem3_modex_seg_t) {
+            usage->size += seg->shmem3->size;
+            usage->used += (size_t)seg->smmodex->used;
+            ++usage->generations;
+        }
+        return;
+    }
+
+    pmix_shmem_t *const shmem3 = (PMIX_GDS_SHMEM3_JOB_ID == shmem3_id)
+                               ? job->shmem3 : job->session->shmem3;
+    void *const *const holder = (PMIX_GDS_SHMEM3_JOB_ID == shmem3_id)
+        ? ((NULL == job->smdata) ? NULL : &job->smdata->current_addr)
+        : ((NULL == job->session->smdata) ? NULL : &job->session->smdata->current_addr);
+    usage->size = shmem3->size;
+    // Mapped, but torn down before anything was built in it.
+    if (NULL == holder) {
+        return;
+    }
+    void *const curraddr = *holder;
+    usage->used = (size_t)((uintptr_t)curraddr - (uintptr_t)shmem3->data_address);
+    if (pmix_gds_shmem3_has_status(job, shmem3_id, PMIX_GDS_SHMEM3_MINE)) {
+        const pmix_gds_shmem3_alloc_ctx_t *const ctx =
+            tma_get_alloc_ctx(get_tma_by_shmem3_id(job, shmem3_id));
+        if (NULL != ctx) {
+            usage->stranded = ctx->stranded;
+        }
+    }
+}
+
 static void
 emit_shmem3_usage_stats(
     pmix_gds_shmem3_job_t *job,
@@ -659,21 +950,118 @@ emit_shmem3_usage_stats(
         return;
     }
 
-    pmix_tma_t *tma = get_tma_by_shmem3_id(job, shmem3_id);
     const char *smname = get_shmem3_id_name(shmem3_id);
-
-    const size_t shmem3_size = shmem3->size;
-    const size_t bytes_used = (size_t)((uintptr_t)tma_get_curraddr(tma)
-                            - (uintptr_t)shmem3->data_address);
-    const float utilization = (bytes_used / (float)shmem3_size) * 100.0;
+    shmem3_usage_t usage;
+    measure_shmem3_usage(job, shmem3_id, &usage);
+    if (0 == usage.size) {
+        return;
+    }
+    const float utilization = (usage.used / (float)usage.size) * 100.0;
 
     PMIX_GDS_SHMEM3_VOUT(
         "%s memory statistics: "
-        "segment size=%zd, bytes used=%zd, utilization=%.2f %%",
-        smname, shmem3_size, bytes_used, utilization
+        "segment size=%zd, bytes used=%zd, utilization=%.2f %%, "
+        "bytes stranded=%zd, page size=%zu, page faults since attach=%ld",
+        smname, usage.size, usage.used, utilization, usage.stranded,
+        shmem3->page_size, pmix_shmem_segment_faults(shmem3)
     );
 }
 
+/**
+ * Appends one PMIX_GDS_SEGMENT_USAGE assembly to kvs.
+ */
+static pmix_status_t
+report_segment_usage(
+    pmix_gds_shmem3_job_t *job,
+    pmix_gds_shmem3_job_shmem3_id_t shmem3_id,
+    pmix_list_t *kvs
+) {
+    static const char *const kinds[PMIX_GDS_SHMEM3_INVALID_ID] = {
+        [PMIX_GDS_SHMEM3_JOB_ID] = "job",
+        [PMIX_GDS_SHMEM3_SESSION_ID] = "session",
+        [PMIX_GDS_SHMEM3_MODEX_ID] = "modex"
+    };
+    const bool modex = (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id);
+    shmem3_usage_t usage;
+    pmix_data_array_t *darray;
+    pmix_info_t *info;
+    pmix_kval_t *kv;
+    size_t n = 0;
+
+    measure_shmem3_usage(job, shmem3_id, &usage);
+
+    PMIX_DATA_ARRAY_CREATE(darray, modex ? 7 : 6, PMIX_INFO);
+    if (PMIX_UNLIKELY(NULL == darray)) {
+        return PMIX_ERR_NOMEM;
+    }
+    info = (pmix_info_t *)darray->array;
+    PMIX_INFO_LOAD(&info[n++], PMIX_NSPACE, job->nspace_id, PMIX_STRING);
+    PMIX_INFO_LOAD(&info[n++], PMIX_GDS_SEGMENT_KIND, kinds[shmem3_id], PMIX_STRING);
+    PMIX_INFO_LOAD(&info[n++], PMIX_GDS_SEGMENT_SIZE, &usage.size, PMIX_SIZE);
+    PMIX_INFO_LOAD(&info[n++], PMIX_GDS_SEGMENT_USED, &usage.used, PMIX_SIZE);
+    PMIX_INFO_LOAD(&info[n++], PMIX_GDS_SEGMENT_STRANDED, &usage.stranded, PMIX_SIZE);
+    PMIX_INFO_LOAD(&info[n++], PMIX_GDS_ATTACH_TIME, &job->attach_time[shmem3_id], PMIX_DOUBLE);
+    if (modex) {
+        PMIX_INFO_LOAD(&info[n++], PMIX_GDS_MODEX_GENERATIONS, &usage.generations, PMIX_UINT32);
+    }
+
+    PMIX_KVAL_NEW(kv, PMIX_GDS_SEGMENT_USAGE);
+    kv->value->type = PMIX_DATA_ARRAY;
+    kv->value->data.darray = darray;
+    pmix_list_append(kvs, &kv->super);
+    return PMIX_SUCCESS;
+}
+
+/**
+ * Answers PMIX_QUERY_GDS_USAGE with what is mapped in this process: on
+ * the server, the segments it built; on a client, the ones it attached.
+ *
+ * Says nothing at all - PMIX_ERR_NOT_FOUND - when there is nothing mapped
+ * and nothing has failed to be, so that a process with no stake in any
+ * segment (a tool, most usefully) passes the question on to its server
+ * rather than answering it with zeros.
+ */
+static pmix_status_t
+report_usage(
+    const char *nspace,
+    pmix_list_t *kvs
+) {
+    pmix_status_t rc = PMIX_SUCCESS;
+    pmix_gds_shmem3_job_t *job;
+    bool found = false;
+
+    PMIX_LIST_FOREACH (job, &pmix_mca_gds_shmem3_component.jobs, pmix_gds_shmem3_job_t) {
+        if (NULL != nspace && !PMIX_CHECK_NSPACE(job->nspace_id, nspace)) {
+            continue;
+        }
+        for (int i = 0; i < PMIX_GDS_SHMEM3_INVALID_ID; ++i) {
+            const pmix_gds_shmem3_job_shmem3_id_t sid = i;
+            const bool mapped = (PMIX_GDS_SHMEM3_MODEX_ID == sid)
+                ? (NULL != job->smmodex || !pmix_list_is_empty(&job->modex_prior))
+                : pmix_gds_shmem3_has_status(job, sid, PMIX_GDS_SHMEM3_READY_FOR_USE);
+            if (!mapped) {
+                continue;
+            }
+            rc = report_segment_usage(job, sid, kvs);
+            if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+                PMIX_ERROR_LOG(rc);
+                return rc;
+            }
+            found = true;
+        }
+    }
+
+    const uint32_t fallbacks = pmix_mca_gds_shmem3_component.attach_fallbacks;
+    if (!found && 0 == fallbacks) {
+        return PMIX_ERR_NOT_FOUND;
+    }
+    pmix_kval_t *kv;
+    PMIX_KVAL_NEW(kv, PMIX_GDS_ATTACH_FALLBACKS);
+    PMIx_Value_load(kv->value, &fallbacks, PMIX_UINT32);
+    pmix_list_append(kvs, &kv->super);
+    return PMIX_SUCCESS;
+}
+
 static void
 job_destruct(
     pmix_gds_shmem3_job_t *job
@@ -721,8 +1109,11 @@ job_destruct(
         if (pmix_gds_shmem3_has_status(job, sid, PMIX_GDS_SHMEM3_MINE)) {
             // Emit usage status before we potentially destroy the segment.
             emit_shmem3_usage_stats(job, sid);
-            // Points to a pmix_gds_shmem3_alloc_ctx_t.
-            PMIX_RELEASE(get_tma_by_shmem3_id(job, sid)->data_context);
+            // Points to a pmix_gds_shmem3_alloc_ctx_t, where there is one.
+            pmix_tma_t *const tma = get_tma_by_shmem3_id(job, sid);
+            if (NULL != tma) {
+                PMIX_RELEASE(tma->data_context);
+            }
         }
         // Releases memory for the structures located in shared-memory. This
         // will also unmap in case we need to later remap something in the
@@ -796,13 +1187,7 @@ modex_seg_destruct(
         return;
     }
     /* Mirrors what release_modex_segment() does for the current
-     * generation - keep the two in step. Order matters: the allocator
-     * context is reached through smmodex, so it goes first. */
-    if (PMIX_GDS_SHMEM3_MINE & seg->status) {
-        if (NULL != seg->smmodex) {
-            PMIX_RELEASE(seg->smmodex->tma.data_context);
-        }
-    }
+     * generation - keep the two in step. */
     PMIX_RELEASE(seg->shmem3);
     seg->shmem3 = NULL;
     seg->smmodex = NULL;
@@ -882,6 +1267,97 @@ drop_modex_priors(
     pmix_mutex_unlock(&job->datalock);
 }
 
+/* What a compaction has to know to judge an entry of one retired
+ * generation. */
+typedef struct {
+    pmix_gds_shmem3_job_t *job;
+    uint32_t generation;
+} modex_compact_keep_t;
+
+/* Carry an entry into the compacted generation unless a tombstone
+ * shadows it where it was - the same test a read applies to that
+ * generation (see drop_tombstoned() in gds_shmem3_fetch.c). It has to be
+ * applied here, not left to the read: the compacted generation is newer
+ * than every tombstone recorded so far, so none of them would shadow it
+ * there. */
+static bool
+modex_compact_keep(
+    pmix_rank_t rank,
+    const pmix_kval_t *kv,
+    void *cbdata
+) {
+    const modex_compact_keep_t *const ck = (const modex_compact_keep_t *)cbdata;
+    pmix_gds_shmem3_tombstone_t *t;
+
+    PMIX_LIST_FOREACH (t, &ck->job->tombstones, pmix_gds_shmem3_tombstone_t) {
+        if (t->rank == rank && NULL != t->key && NULL != kv->key
+            && 0 == strcmp(t->key, kv->key) && ck->generation <= t->generation) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Should the generation about to be started fold the retired ones into
+ * itself rather than chain to them?
+ *
+ * Each delta generation holds only what changed, which is what keeps a
+ * fence's cost to the size of its delta - but every one of them stays
+ * mapped, and a miss in the newest costs a lookup in each. After
+ * modex_max_layers of them the next generation is built as a full one
+ * instead. That fence pays for copying what the chain holds, once, and
+ * the ones after it go back to paying for their deltas alone.
+ */
+static bool
+modex_wants_compaction(
+    pmix_gds_shmem3_job_t *job
+) {
+    return 0 < pmix_gds_shmem3_modex_max_layers
+        && pmix_gds_shmem3_modex_max_layers <= pmix_list_get_size(&job->modex_prior);
+}
+
+/**
+ * Copy every retired modex generation into the current one, oldest
+ * first, so what comes out is what a read of the whole chain would have
+ * answered: the newest value of each key, a deletion included. Then let
+ * the retired generations go.
+ *
+ * Server side only, on the progress thread and before anything has been
+ * stored in - or advertised for - the current generation. The current
+ * one must have been sized with get_modex_sizing_data(job, true).
+ */
+static pmix_status_t
+compact_modex_priors(
+    pmix_gds_shmem3_job_t *job
+) {
+    pmix_gds_shmem3_modex_seg_t *seg;
+    modex_compact_keep_t ck = {.job = job, .generation = 0};
+    pmix_status_t rc;
+
+    PMIX_LIST_FOREACH_REV (seg, &job->modex_prior, pmix_gds_shmem3_modex_seg_t) {
+        if (NULL == seg->smmodex) {
+            continue;
+        }
+        ck.generation = seg->generation;
+        rc = pmix_shmem_flat_merge(job->smmodex, seg->smmodex,
+                                   modex_compact_keep, &ck);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+    PMIX_GDS_SHMEM3_VOUT(
+        "%s: folded %zu modex generations into %u for namespace=%s "
+        "(%zu B, %u values)", __func__,
+        pmix_list_get_size(&job->modex_prior), job->modex_generation,
+        job->nspace_id, (size_t)job->smmodex->used,
+        (unsigned)job->smmodex->nentries
+    );
+    drop_modex_priors(job);
+    return PMIX_SUCCESS;
+}
+
 /**
  * Let go of this job's current modex segment.
  *
@@ -892,8 +1368,8 @@ drop_modex_priors(
  * starting the next safe.
  *
  * Mirrors what job_destruct() does for this segment; keep the two in
- * step. Order matters - the allocator context is reached through
- * job->smmodex, so it has to go before that pointer is cleared.
+ * step. The statistics are read through job->smmodex, so they have to
+ * go before that pointer is cleared.
  */
 static void
 release_modex_segment(
@@ -906,10 +1382,9 @@ release_modex_segment(
     if (pmix_gds_shmem3_has_status(job, PMIX_GDS_SHMEM3_MODEX_ID,
                                    PMIX_GDS_SHMEM3_MINE)) {
         emit_shmem3_usage_stats(job, PMIX_GDS_SHMEM3_MODEX_ID);
-        PMIX_RELEASE(get_tma_by_shmem3_id(job, PMIX_GDS_SHMEM3_MODEX_ID)->data_context);
     }
     /* This one really does unmap the segment, and a read on another
-     * thread may be part way through the hash table inside it - see
+     * thread may be part way through the image inside it - see
      * job->datalock. */
     pmix_mutex_lock(&job->datalock);
     PMIX_RELEASE(job->modex_shmem3);
@@ -1003,31 +1478,52 @@ PMIX_CLASS_INSTANCE(
     session_destruct
 );
 
+/**
+ * Setup the shared information structure for a session. For a dry run
+ * (see size_shmem3_stores_for_local_job_data()) the structure is on the
+ * heap and its TMA only counts; otherwise both are in the segment.
+ */
 static pmix_status_t
 session_smdata_construct(
     pmix_gds_shmem3_job_t *job,
-    uint32_t sid
+    uint32_t sid,
+    bool dryrun
 ) {
     pmix_status_t rc = PMIX_SUCCESS;
-    // Setup the shared information structure. It will be at the base address of
-    // the shared-memory segment. The memory is already allocated, so let the
-    // session know about its data located at the base of the segment.
     const size_t smdata_size = sizeof(*job->session->smdata);
-    void *const baseaddr = job->session->shmem3->data_address;
-
-    job->session->smdata = baseaddr;
-    memset(job->session->smdata, 0, smdata_size);
-    // Save the starting address for TMA memory allocations.
-    job->session->smdata->current_addr = baseaddr;
-    // Setup the TMA.
-    tma_init(
-        job->session->shmem3,
-        &job->session->smdata->tma,
-        &job->session->smdata->current_addr
-    );
-    // Now we need to update the TMA's pointer to account for our using up some
-    // space for its header.
-    tma_set_curraddr(&job->session->smdata->tma, addr_align(baseaddr, smdata_size));
+
+    if (dryrun) {
+        job->session->smdata = calloc(1, smdata_size);
+        if (PMIX_UNLIKELY(!job->session->smdata)) {
+            return PMIX_ERR_NOMEM;
+        }
+        rc = tma_init_counting(&job->session->smdata->tma, smdata_size);
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            return rc;
+        }
+    }
+    else {
+        // It will be at the base address of the shared-memory segment. The
+        // memory is already allocated, so let the session know about its
+        // data located at the base of the segment.
+        void *const baseaddr = job->session->shmem3->data_address;
+
+        job->session->smdata = baseaddr;
+        memset(job->session->smdata, 0, smdata_size);
+        // Save the starting address for TMA memory allocations.
+        job->session->smdata->current_addr = baseaddr;
+        // Setup the TMA.
+        tma_init(
+            job->session->shmem3,
+            &job->session->smdata->tma,
+            &job->session->smdata->current_addr
+        );
+        // Now we need to update the TMA's pointer to account for our using
+        // up some space for its header.
+        tma_set_curraddr(
+            &job->session->smdata->tma, addr_align(baseaddr, smdata_size)
+        );
+    }
     // We can now safely get our TMA.
     pmix_tma_t *const tma = &job->session->smdata->tma;
     // Now that we know the TMA, initialize smdata structures using it.
@@ -1059,27 +1555,45 @@ out:
     return rc;
 }
 
+/**
+ * Setup the shared information structure for a job; see
+ * session_smdata_construct() for what a dry run is.
+ */
 static pmix_status_t
 job_smdata_construct(
     pmix_gds_shmem3_job_t *job,
-    size_t htsize
+    size_t htsize,
+    bool dryrun
 ) {
     pmix_status_t rc = PMIX_SUCCESS;
-    // Setup the shared information structure. It will be at the base address of
-    // the shared-memory segment. The memory is already allocated, so let the
-    // job know about its data located at the base of the segment.
     const size_t smdata_size = sizeof(*job->smdata);
-    void *const baseaddr = job->shmem3->data_address;
-
-    job->smdata = baseaddr;
-    memset(job->smdata, 0, smdata_size);
-    // Save the starting address for TMA memory allocations.
-    job->smdata->current_addr = baseaddr;
-    // Setup the TMA.
-    tma_init(job->shmem3, &job->smdata->tma, &job->smdata->current_addr);
-    // Now we need to update the TMA's pointer to account for our using up some
-    // space for its header.
-    tma_set_curraddr(&job->smdata->tma, addr_align(baseaddr, smdata_size));
+
+    if (dryrun) {
+        job->smdata = calloc(1, smdata_size);
+        if (PMIX_UNLIKELY(!job->smdata)) {
+            return PMIX_ERR_NOMEM;
+        }
+        rc = tma_init_counting(&job->smdata->tma, smdata_size);
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            return rc;
+        }
+    }
+    else {
+        // It will be at the base address of the shared-memory segment. The
+        // memory is already allocated, so let the job know about its data
+        // located at the base of the segment.
+        void *const baseaddr = job->shmem3->data_address;
+
+        job->smdata = baseaddr;
+        memset(job->smdata, 0, smdata_size);
+        // Save the starting address for TMA memory allocations.
+        job->smdata->current_addr = baseaddr;
+        // Setup the TMA.
+        tma_init(job->shmem3, &job->smdata->tma, &job->smdata->current_addr);
+        // Now we need to update the TMA's pointer to account for our using
+        // up some space for its header.
+        tma_set_curraddr(&job->smdata->tma, addr_align(baseaddr, smdata_size));
+    }
     // We can now safely get our TMA.
     pmix_tma_t *const tma = &job->smdata->tma;
     // Now that we know the TMA, initialize smdata structures using it.
@@ -1147,45 +1661,25 @@ out:
 static pmix_status_t
 modex_smdata_construct(
     pmix_gds_shmem3_job_t *job,
-    size_t htsize
+    size_t nranks,
+    size_t nkvals
 ) {
-    pmix_status_t rc = PMIX_SUCCESS;
-    // Setup the shared information structure. It will be at the base address of
-    // the shared-memory segment. The memory is already allocated, so let the
-    // job know about its data located at the base of the segment.
-    const size_t smmodex_size = sizeof(*job->smmodex);
-    void *const baseaddr = job->modex_shmem3->data_address;
-
-    job->smmodex = baseaddr;
-    memset(job->smmodex, 0, smmodex_size);
-    // Save the starting address for TMA memory allocations.
-    job->smmodex->current_addr = baseaddr;
-    // Setup the TMA.
-    tma_init(job->modex_shmem3, &job->smmodex->tma, &job->smmodex->current_addr);
-    // Now we need to update the TMA's pointer to account for our using up some
-    // space for its header.
-    tma_set_curraddr(&job->smmodex->tma, addr_align(baseaddr, smmodex_size));
-    // We can now safely get our TMA.
-    pmix_tma_t *const tma = &job->smmodex->tma;
-    // Now that we know the TMA, initialize smdata structures using it.
-    job->smmodex->hashtab = PMIX_NEW(pmix_hash_table_t, tma);
-    if (!job->smmodex->hashtab) {
-        rc = PMIX_ERR_NOMEM;
-        PMIX_ERROR_LOG(rc);
-        return rc;
-    }
-    pmix_hash_table_init(job->smmodex->hashtab, htsize);
-
-    // The indices stored in that table are meaningless without the
-    // translation, and the translation cannot be the process-global one
-    // because clients do not share our numbering. Build it here, in the
-    // segment, so it travels with the data it describes.
-    job->smmodex->keyindex = PMIX_NEW(pmix_keyindex_t, tma);
-    if (!job->smmodex->keyindex) {
-        rc = PMIX_ERR_NOMEM;
+    // The image starts at the base of the segment's data region and may
+    // use all of it. There is no allocator to set up: the image does its
+    // own bump allocation, and it records how far it has got in its own
+    // header, where a reader can see it.
+    pmix_shmem_t *const shmem3 = job->modex_shmem3;
+    const size_t avail = (size_t)((uintptr_t)shmem3->hdr_address + shmem3->size
+                                - (uintptr_t)shmem3->data_address);
+
+    pmix_status_t rc = pmix_shmem_flat_init(
+        shmem3->data_address, avail, nranks, nkvals
+    );
+    if (PMIX_SUCCESS != rc) {
         PMIX_ERROR_LOG(rc);
         return rc;
     }
+    job->smmodex = shmem3->data_address;
 
     pmix_gds_shmem3_vout_smmodex(job);
 
@@ -1380,6 +1874,17 @@ addr_in_arena(
     return (addr - job->arena_base) <= (job->arena_size - size);
 }
 
+/**
+ * Seconds on a clock that only moves forward, for timing attaches.
+ */
+static double
+shmem3_now(void)
+{
+    struct timespec tp;
+    (void)clock_gettime(CLOCK_MONOTONIC, &tp);
+    return (double)tp.tv_sec + (double)tp.tv_nsec / 1.0e9;
+}
+
 /**
  * Attaches to the given shared-memory segment.
  */
@@ -1390,6 +1895,7 @@ shmem3_attach(
     uintptr_t req_addr
 ) {
     pmix_status_t rc = PMIX_SUCCESS;
+    const double start = shmem3_now();
 
     pmix_shmem_t *shmem3;
     rc = pmix_gds_shmem3_get_job_shmem3_by_id(
@@ -1400,18 +1906,33 @@ shmem3_attach(
         return rc;
     }
 
+    /* The modex segment holds nothing but self-relative references (see
+     * pmix_shmem_flat.h), so it reads the same wherever it lands and the
+     * server's address is of no interest to us. Let the kernel choose.
+     * This is the attach that happens at fence time, in a process full of
+     * whatever the application has mapped since PMIx_Init - the one most
+     * likely to find the server's address already taken. */
+    const bool anywhere = (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id);
     /* If this address is inside the arena we reserved for the job, then
      * we are not asking for it - we are already holding it, and mapping
      * over our own reservation cannot be refused. That is the point of
      * having reserved it: the client's address space has moved on since
      * PMIx_Init, but this range has been ours the whole time. */
-    const pmix_shmem_flags_t aflags =
-        addr_in_arena(job, req_addr, shmem3->size)
+    pmix_shmem_flags_t aflags =
+        anywhere ? 0
+        : addr_in_arena(job, req_addr, shmem3->size)
             ? PMIX_SHMEM_MAP_OVER_RESERVATION
             : PMIX_SHMEM_MUST_MAP_AT_RADDR;
+    /* A client reads its job data right after attaching, and reads the
+     * modex right after the fence that published it. Take the faults
+     * for all of it here, in one pass, rather than one at a time in the
+     * middle of PMIx_Init or the first PMIx_Get. */
+    if (pmix_gds_shmem3_prefault) {
+        aflags |= PMIX_SHMEM_PREFAULT;
+    }
 
     rc = pmix_shmem_segment_attach(
-        shmem3, req_addr, aflags, PMIX_GDS_SHMEM3_LAYOUT_ID
+        shmem3, anywhere ? 0 : req_addr, aflags, PMIX_GDS_SHMEM3_LAYOUT_ID
     );
     if (PMIX_UNLIKELY(pmix_gds_shmem3_force_client_attach_failure)) {
         // Testing only: pretend the fixed-address attach failed so the
@@ -1464,6 +1985,7 @@ shmem3_attach(
 out:
     if (PMIX_SUCCESS != rc) {
         (void)pmix_shmem_segment_detach(shmem3);
+        ++pmix_mca_gds_shmem3_component.attach_fallbacks;
         if (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id) {
             /* Only this segment is lost. The job and session segments
              * this client has been reading since PMIx_Init are mapped
@@ -1493,6 +2015,7 @@ out:
         pmix_gds_shmem3_set_status(
             job, shmem3_id, PMIX_GDS_SHMEM3_ATTACHED
         );
+        job->attach_time[shmem3_id] = shmem3_now() - start;
     }
     return rc;
 }
@@ -1511,10 +2034,29 @@ init_client_side_sm_data(
             job->session->smdata = job->session->shmem3->data_address;
             pmix_gds_shmem3_vout_smsession(job->session);
             break;
-        case PMIX_GDS_SHMEM3_MODEX_ID:
-            job->smmodex = job->modex_shmem3->data_address;
+        case PMIX_GDS_SHMEM3_MODEX_ID: {
+            // The layout id has already been checked, but that covers the
+            // segment, not the image in it; look before we read.
+            pmix_shmem_t *const shmem3 = job->modex_shmem3;
+            const size_t avail = (size_t)((uintptr_t)shmem3->hdr_address + shmem3->size
+                                        - (uintptr_t)shmem3->data_address);
+            if (!pmix_shmem_flat_check(shmem3->data_address, avail)) {
+                // Treated like a failed attach, which is what it is to
+                // the caller: this client reads remote data from its
+                // server instead.
+                PMIX_GDS_SHMEM3_VOUT(
+                    "%s: %s holds no modex image we can read",
+                    __func__, shmem3->backing_path
+                );
+                (void)pmix_shmem_segment_detach(shmem3);
+                pmix_gds_shmem3_clearall_status(job, shmem3_id);
+                ++pmix_mca_gds_shmem3_component.attach_fallbacks;
+                return PMIX_ERR_TAKE_NEXT_OPTION;
+            }
+            job->smmodex = shmem3->data_address;
             pmix_gds_shmem3_vout_smmodex(job);
             break;
+        }
         case PMIX_GDS_SHMEM3_INVALID_ID:
         default:
             PMIX_ERROR_LOG(PMIX_ERROR);
@@ -1633,7 +2175,7 @@ arena_reserve(
     pmix_gds_shmem3_job_t *job,
     size_t job_segsize
 ) {
-    if (0 == pmix_gds_shmem3_arena_slot_size) {
+    if (!pmix_gds_shmem3_arena) {
         // Explicitly disabled.
         return;
     }
@@ -1645,35 +2187,20 @@ arena_reserve(
     /* Ask what the segment will actually occupy, rather than assuming it
      * is the size we asked for: a segment maps a page of header ahead of
      * its data. Carving to the requested size instead left every segment
-     * overlapping the next by that page. */
-    const size_t statics = pmix_shmem_utils_segment_footprint(job_segsize);
-    size_t slot = pmix_shmem_utils_pad_to_page(
-        pmix_gds_shmem3_arena_slot_size
-    );
-    /* A job whose job-level data alone exceeds the configured slot is
-     * one whose modex will not be small either. Do not hand it slots it
-     * is guaranteed to overflow. */
-    if (slot < statics) {
-        slot = statics;
-    }
-
-    /* One slot per modex generation that can be live at once. More than
-     * one is live whenever a contribution carried only what changed -
-     * the generations before it are still the only copy of what it did
-     * not repeat - so this is a depth, not the two an alternation would
-     * need. The bitmap in arena_alloc_modex() is what caps it at 32. */
-    size_t slots = pmix_gds_shmem3_arena_modex_slots;
-    if (0 == slots) {
-        return;
-    }
-    if (slots > 32) {
-        slots = 32;
-    }
-    // Guard the arithmetic rather than trust two tunables to be sane.
-    if (slot > (SIZE_MAX - statics) / slots) {
-        return;
+     * overlapping the next by that page.
+     *
+     * Only the job segment is reserved for. A modex generation is a
+     * position-independent image that maps wherever it lands, so it has
+     * no address to hold on to. */
+    size_t total = pmix_shmem_utils_segment_footprint(job_segsize);
+    /* On huge pages the segment is a whole number of them and has to
+     * start on one, so hold enough to line it up wherever the
+     * reservation lands. */
+    const size_t huge_page = pmix_gds_shmem3_huge_pages
+                           ? pmix_shmem_utils_huge_page_size() : 0;
+    if (0 < huge_page) {
+        total = ((total + huge_page - 1) & ~(huge_page - 1)) + huge_page;
     }
-    const size_t total = statics + (slots * slot);
 
     uintptr_t base = 0;
     if (PMIX_SUCCESS != pmix_vmem_reserve(segment_hole_kind(),
@@ -1689,13 +2216,10 @@ arena_reserve(
     job->arena_base = base;
     job->arena_size = total;
     job->arena_static_used = 0;
-    job->arena_slot_bytes = slot;
-    job->arena_slots = slots;
 
     PMIX_GDS_SHMEM3_VOUT(
-        "%s: reserved arena [0x%zx, 0x%zx) (%zu B, %zu slots of %zu B) "
-        "for namespace=%s",
-        __func__, (size_t)base, (size_t)(base + total), total, slots, slot,
+        "%s: reserved arena [0x%zx, 0x%zx) (%zu B) for namespace=%s",
+        __func__, (size_t)base, (size_t)(base + total), total,
         job->nspace_id
     );
 }
@@ -1710,111 +2234,24 @@ static bool
 arena_alloc_static(
     pmix_gds_shmem3_job_t *job,
     size_t size,
+    size_t align,
     uintptr_t *addr
 ) {
-    if (0 == job->arena_size || 0 == job->arena_slots) {
+    if (0 == job->arena_size) {
         return false;
     }
-    const size_t statics =
-        job->arena_size - (job->arena_slots * job->arena_slot_bytes);
-    if (size > statics - job->arena_static_used) {
+    /* start on a page of whatever backs the segment */
+    const uintptr_t next = job->arena_base + job->arena_static_used;
+    const uintptr_t at = (next + align - 1) & ~((uintptr_t)align - 1);
+    const size_t pad = (size_t)(at - next);
+    if (pad + size > job->arena_size - job->arena_static_used) {
         return false;
     }
-    *addr = job->arena_base + job->arena_static_used;
-    job->arena_static_used += size;
+    *addr = at;
+    job->arena_static_used += pad + size;
     return true;
 }
 
-/**
- * Where the modex slots begin - everything below this is the static
- * region the job segment came out of.
- */
-static inline uintptr_t
-arena_modex_base(
-    const pmix_gds_shmem3_job_t *job
-) {
-    return job->arena_base + job->arena_size
-           - (job->arena_slots * job->arena_slot_bytes);
-}
-
-/**
- * Mark the slot a mapped segment occupies, if it is in the arena.
- */
-static inline void
-note_slot_in_use(
-    const pmix_gds_shmem3_job_t *job,
-    const pmix_shmem_t *shmem3,
-    uint32_t *inuse
-) {
-    if (NULL == shmem3 || !shmem3->attached || NULL == shmem3->hdr_address) {
-        return;
-    }
-    const uintptr_t addr = (uintptr_t)shmem3->hdr_address;
-    const uintptr_t mbase = arena_modex_base(job);
-
-    if (addr < mbase || addr >= job->arena_base + job->arena_size) {
-        // Placed outside the arena; owns no slot.
-        return;
-    }
-    *inuse |= (uint32_t)1 << ((addr - mbase) / job->arena_slot_bytes);
-}
-
-/**
- * Hand out an arena slot for a new modex generation.
- *
- * A generation cannot simply take the slot before last. It used to be
- * true that at most one was live at a time, and this alternated between
- * two slots on that basis; it stopped being true when a contribution
- * became able to carry only what changed. A delta generation leaves
- * every generation before it mapped and answerable on job->modex_prior,
- * so the slot each of those sits in is still in use, and writing over
- * one would take away data nothing else holds a copy of.
- *
- * So read the occupancy off the segments themselves - the current
- * generation and every retired one - rather than keeping a count.
- * Deriving it means there is no allocation tally to be left stale by a
- * path that releases a generation without telling us, and the whole
- * thing is a walk of a list that is empty in the common case.
- *
- * Returns false when every slot is taken, which is not an error: the
- * caller places the generation outside the arena exactly as it would
- * have without one.
- */
-static bool
-arena_alloc_modex(
-    pmix_gds_shmem3_job_t *job,
-    size_t size,
-    uintptr_t *addr
-) {
-    uint32_t inuse = 0;
-
-    if (0 == job->arena_size || 0 == job->arena_slots) {
-        return false;
-    }
-    if (size > job->arena_slot_bytes) {
-        return false;
-    }
-
-    note_slot_in_use(job, job->modex_shmem3, &inuse);
-    pmix_gds_shmem3_modex_seg_t *seg;
-    PMIX_LIST_FOREACH (seg, &job->modex_prior, pmix_gds_shmem3_modex_seg_t) {
-        note_slot_in_use(job, seg->shmem3, &inuse);
-    }
-
-    for (size_t slot = 0; slot < job->arena_slots; ++slot) {
-        if (0 == (inuse & ((uint32_t)1 << slot))) {
-            *addr = arena_modex_base(job) + (slot * job->arena_slot_bytes);
-            return true;
-        }
-    }
-    PMIX_GDS_SHMEM3_VOUT(
-        "%s: all %zu modex slots are in use for namespace=%s; placing "
-        "generation %u outside the arena",
-        __func__, job->arena_slots, job->nspace_id, job->modex_generation
-    );
-    return false;
-}
-
 /**
  * Create and attach to a shared-memory segment.
  */
@@ -1826,6 +2263,7 @@ shmem3_segment_create_and_attach(
     size_t segment_size
 ) {
     pmix_status_t rc = PMIX_SUCCESS;
+    const double start = shmem3_now();
     // Pad given size to fill remaining space on the last page.
     const size_t real_segsize = pmix_shmem_utils_pad_to_page(segment_size);
     // Find a unique path for the shared-memory backing file.
@@ -1848,12 +2286,17 @@ shmem3_segment_create_and_attach(
     }
     // Create a shared-memory segment backing store at the given path.
     rc = pmix_shmem_segment_create(
-        shmem3, real_segsize, segment_path, PMIX_GDS_SHMEM3_LAYOUT_ID
+        shmem3, real_segsize, segment_path, PMIX_GDS_SHMEM3_LAYOUT_ID,
+        pmix_gds_shmem3_huge_pages ? PMIX_SHMEM_HUGE_PAGES : 0
     );
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         goto out;
     }
+    PMIX_GDS_SHMEM3_VOUT(
+        "%s: %s is %zu B in %zu B pages", __func__, segment_name,
+        shmem3->size, shmem3->page_size
+    );
     // Place the segment. Out of the job's arena where it fits, because a
     // reserved address is one every client can be sure of holding too;
     // otherwise from a hole located here and now, which is what the arena
@@ -1861,17 +2304,30 @@ shmem3_segment_create_and_attach(
     //
     // Carve by what the mapping will occupy, not by what we asked to
     // store: pmix_shmem_segment_create() put a page of header in front of
-    // it, and shmem3->size below reports the larger number.
-    const size_t mapped_size = pmix_shmem_utils_segment_footprint(
-        real_segsize
-    );
+    // it and, on huge pages, rounded the whole up to a number of them.
+    // shmem3->size is the result of both.
+    const size_t mapped_size = shmem3->size;
+    // And place it on a page of whatever backs it. hugetlbfs will not map
+    // anywhere else, and a transparent huge page needs its virtual
+    // address lined up as much as its file offset.
+    const size_t align = shmem3->page_size;
+    const size_t align_slack = (align > pmix_shmem_utils_pad_to_page(1))
+                             ? align : 0;
     uintptr_t arena_addr = 0;
-    const bool from_arena =
-        (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id)
-            ? arena_alloc_modex(job, mapped_size, &arena_addr)
-            : arena_alloc_static(job, mapped_size, &arena_addr);
 
-    if (from_arena) {
+    if (PMIX_GDS_SHMEM3_MODEX_ID == shmem3_id) {
+        // A modex image holds no absolute address, so neither we nor any
+        // client has to map it anywhere in particular. Let the kernel
+        // choose; there is no hole to find and none to lose.
+        rc = pmix_shmem_segment_attach(
+            shmem3, 0, 0, PMIX_GDS_SHMEM3_LAYOUT_ID
+        );
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            PMIX_ERROR_LOG(rc);
+            goto out_release;
+        }
+    }
+    else if (arena_alloc_static(job, mapped_size, align, &arena_addr)) {
         PMIX_GDS_SHMEM3_VOUT(
             "%s: %s placed in arena at address=0x%zx",
             __func__, segment_name, (size_t)arena_addr
@@ -1925,12 +2381,15 @@ shmem3_segment_create_and_attach(
             size_t base_addr = 0;
             rc = pmix_vmem_find_hole_scattered(
                 segment_hole_kind(), scatter + (uint64_t)attempt,
-                &base_addr, real_segsize
+                &base_addr, mapped_size + align_slack
             );
             if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                 PMIX_ERROR_LOG(rc);
                 goto out_release;
             }
+            if (0 < align_slack) {
+                base_addr = (base_addr + align - 1) & ~(align - 1);
+            }
             PMIX_GDS_SHMEM3_VOUT(
                 "%s: %s found vmhole at address=0x%zx (attempt %d)",
                 __func__, segment_name, base_addr, attempt
@@ -1953,6 +2412,27 @@ shmem3_segment_create_and_attach(
         }
     }
     pmix_gds_shmem3_set_status(job, shmem3_id, PMIX_GDS_SHMEM3_ATTACHED);
+    /* Place the pages before anything is written: the policy decides
+     * where each page goes when it is first touched, and we are about to
+     * touch all of them. What it binds depends on where the backing file
+     * lives. On tmpfs (/dev/shm, or a session directory mounted as one)
+     * the kernel keeps the policy with the shared file, so it holds for
+     * every client's mapping too. On a disk-backed file it is a policy on
+     * this mapping only, and the kernel allocates page cache by the
+     * faulting task's own policy rather than the mapping's - there the
+     * pages end up wherever the server touches them, as with "none".
+     * Either way, failing to set it costs locality, not correctness. */
+    const size_t data_size = shmem3->size
+                           - (size_t)((uintptr_t)shmem3->data_address
+                                      - (uintptr_t)shmem3->hdr_address);
+    if (PMIX_HWLOC_MEMBIND_NONE != pmix_gds_shmem3_numa_policy
+        && PMIX_SUCCESS != pmix_hwloc_membind_area(shmem3->data_address, data_size,
+                                                   pmix_gds_shmem3_numa_policy)) {
+        PMIX_GDS_SHMEM3_VOUT(
+            "%s: could not set the NUMA policy of %s; its pages go where "
+            "they are first touched", __func__, segment_name
+        );
+    }
     /* Fix up the backing file's permissions. A failure here is reported
      * and then dropped, deliberately: the segment is created, mapped and
      * perfectly usable by US, and what a client loses is the ability to
@@ -1975,6 +2455,7 @@ out:
         pmix_gds_shmem3_set_status(
             job, shmem3_id, PMIX_GDS_SHMEM3_MINE
         );
+        job->attach_time[shmem3_id] = shmem3_now() - start;
     }
     return rc;
 out_release:
@@ -2004,6 +2485,7 @@ module_init(
     PMIX_CONSTRUCT(&pmix_mca_gds_shmem3_component.jobs, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_mca_gds_shmem3_component.joblock, pmix_mutex_t);
     PMIX_CONSTRUCT(&pmix_mca_gds_shmem3_component.sessions, pmix_list_t);
+    pmix_mca_gds_shmem3_component.attach_fallbacks = 0;
     return PMIX_SUCCESS;
 }
 
@@ -2073,66 +2555,117 @@ server_cache_job_info(
 }
 
 /**
+ * Size the job and session segments by building their contents once,
+ * against counting allocators, before there is a segment to build them in.
+ *
+ * Both segments are filled through a bump allocator that cannot grow, so
+ * they used to be sized by formula - per-rank and per-key terms, the
+ * packed size scaled up, the lot multiplied by a fluff factor and then by
+ * segment_size_multiplier in case that was still not enough. It was
+ * generous for most jobs and short for some, and short is an abort.
+ * Running the store pass itself gives the exact figure instead: it makes
+ * the same requests, in the same order, as the real pass will.
  *
+ * The pass runs against a tracker of its own, so nothing anyone else can
+ * reach ever points at the heap blocks standing in for the segment.
  */
 static pmix_status_t
-prepare_shmem3_stores_for_local_job_data(
+size_shmem3_stores_for_local_job_data(
     pmix_gds_shmem3_job_t *job,
-    pmix_gds_shmem3_packed_local_job_info_t *pji
+    pmix_gds_shmem3_packed_local_job_info_t *pji,
+    pmix_list_t *job_data,
+    size_t *job_segsize,
+    size_t *session_segsize
 ) {
     pmix_status_t rc = PMIX_SUCCESS;
-    static const float fluff = 3.0;
-    const size_t kvsize = (sizeof(pmix_kval_t) + sizeof(pmix_value_t));
-    // Elements the table needs - one per rank it will hold.
-    const size_t htsize = pji->hash_table_size;
-    // Key/value pairs those elements hold between them. The table is
-    // sized by the first number and its contents by this one; they are
-    // not interchangeable, and using htsize for both is what made the
-    // table thousands of times larger than it had to be.
-    const size_t nkvals = pji->nkvals;
-    // Calculate a rough estimate on the amount of storage required to store the
-    // values associated with the pmix_gds_shmem3_shared_job_data_t. Err on the
-    // side of overestimation.
-    size_t seg_size = sizeof(*job->smdata);
-    // We need to store a hash table in the shared-memory segment, so calculate
-    // a rough estimate on the memory required for its storage.
-    seg_size += sizeof(pmix_hash_table_t);
-    seg_size += pmix_hash_table_sizeof_storage(htsize);
-    // Each element points at a per-rank structure with its own arrays.
-    seg_size += htsize * pmix_hash_sizeof_proc_storage();
-    // Add a little extra to compensate for the value storage requirements. Here
-    // we add an additional storage space for each key/value pair.
-    seg_size += nkvals * kvsize;
-    /* The keyindex that translates the indices in that table lives in
-     * this segment too, and an empty one is already ~170 KB. On top of
-     * that each distinct key costs a record and three copies of its own
-     * string. Bound the entry count by nkvals - the real number of
-     * distinct keys is normally far smaller.
-     *
-     * The key *lengths* are bounded by the data, not by PMIX_MAX_KEYLEN:
-     * every one of these keys arrived in the buffer we just packed, so
-     * their strings cannot total more than it holds. Reserving the
-     * 511-byte maximum for each instead made this term alone dwarf the
-     * payload it was protecting.
-     *
-     * Leaving this out is not a slow leak, it is a hard failure: the
-     * TMA behind the segment is a bump allocator with nowhere to grow,
-     * so the server aborts partway through register_job_info() and
-     * every client sits waiting for job data that will never arrive. */
-    seg_size += pmix_keyindex_sizeof_fixed_storage();
-    seg_size += nkvals * pmix_hash_sizeof_key_entry(0);
-    /* Three copies per registered key, plus the copy newkval() strdups
-     * for every value that lands on a list rather than in the table. */
-    seg_size += 4 * pji->packed_size;
-    // Finally add the data size contribution, plus a little extra.
-    seg_size += pji->packed_size;
-    // Include some extra fluff that empirically seems reasonable.
-    seg_size *= fluff;
-    // Adjust (increase or decrease) segment size by the given parameter size.
-    seg_size *= pmix_gds_shmem3_segment_size_multiplier;
+
+    pmix_gds_shmem3_job_t *dry = PMIX_NEW(pmix_gds_shmem3_job_t);
+    if (PMIX_UNLIKELY(!dry || !dry->session)) {
+        rc = PMIX_ERR_NOMEM;
+        PMIX_ERROR_LOG(rc);
+        goto out;
+    }
+    dry->nspace_id = strdup(job->nspace_id);
+    if (PMIX_UNLIKELY(!dry->nspace_id)) {
+        rc = PMIX_ERR_NOMEM;
+        PMIX_ERROR_LOG(rc);
+        goto out;
+    }
+
+    rc = job_smdata_construct(dry, pji->hash_table_size, true);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        goto out;
+    }
+    rc = session_smdata_construct(dry, pji->session_id, true);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        goto out;
+    }
+    rc = pmix_gds_shmem3_store_local_job_data_in_shmem3(dry, job_data);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        goto out;
+    }
+    *job_segsize = tma_counted(&dry->smdata->tma);
+    *session_segsize = tma_counted(&dry->session->smdata->tma);
+
+    PMIX_GDS_SHMEM3_VOUT(
+        "%s: namespace=%s needs %zu B of job data and %zu B of session data",
+        __func__, job->nspace_id, *job_segsize, *session_segsize
+    );
+out:
+    if (NULL != dry) {
+        // Not in a segment, so not reached by job_destruct(): give the
+        // counting contexts back, which frees every block they handed out,
+        // then the structures that held them.
+        if (NULL != dry->smdata) {
+            if (NULL != dry->smdata->tma.data_context) {
+                PMIX_RELEASE(dry->smdata->tma.data_context);
+            }
+            free(dry->smdata);
+            dry->smdata = NULL;
+        }
+        if (NULL != dry->session && NULL != dry->session->smdata) {
+            if (NULL != dry->session->smdata->tma.data_context) {
+                PMIX_RELEASE(dry->session->smdata->tma.data_context);
+            }
+            free(dry->session->smdata);
+            dry->session->smdata = NULL;
+        }
+        PMIX_RELEASE(dry);
+    }
+    return rc;
+}
+
+/**
+ * Create the job and session segments at the size their contents need.
+ */
+static pmix_status_t
+prepare_shmem3_stores_for_local_job_data(
+    pmix_gds_shmem3_job_t *job,
+    pmix_gds_shmem3_packed_local_job_info_t *pji,
+    pmix_list_t *job_data
+) {
+    size_t seg_size = 0, session_size = 0;
+
+    pmix_status_t rc = size_shmem3_stores_for_local_job_data(
+        job, pji, job_data, &seg_size, &session_size
+    );
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
+    // The sizes are exact, so the multiplier can only add headroom: less
+    // than what the store pass is about to ask for is an abort, not a
+    // saving.
+    if (1.0 < pmix_gds_shmem3_segment_size_multiplier) {
+        seg_size *= pmix_gds_shmem3_segment_size_multiplier;
+        session_size *= pmix_gds_shmem3_segment_size_multiplier;
+    }
     /* Reserve this job's address space before placing anything in it.
-     * Everything below, and every modex this job ever produces, is then
-     * carved from a range that clients will hold too - which is what a
+     * The job segment is then carved from a range that clients will hold
+     * too - which is what a
      * fixed-address attach needs and cannot otherwise be given, because
      * the client that has to honor it does not exist yet. */
     arena_reserve(job, seg_size);
@@ -2146,9 +2679,7 @@ prepare_shmem3_stores_for_local_job_data(
         PMIX_ERROR_LOG(rc);
         return rc;
     }
-    // Do the same for the job's session information. Note that we recycle the
-    // segment size calculated above because we know that it will be at least as
-    // big as we need for this session information.
+    // Do the same for the job's session information.
     const char *session_name = get_shmem3_session_name(pji->session_id);
     if (PMIX_UNLIKELY(!session_name)) {
         rc = PMIX_ERROR;
@@ -2157,20 +2688,20 @@ prepare_shmem3_stores_for_local_job_data(
     }
 
     rc = shmem3_segment_create_and_attach(
-        job, PMIX_GDS_SHMEM3_SESSION_ID, session_name, seg_size
+        job, PMIX_GDS_SHMEM3_SESSION_ID, session_name, session_size
     );
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         return rc;
     }
     // Construct shared-memory data structures for job and session.
-    rc = job_smdata_construct(job, htsize);
+    rc = job_smdata_construct(job, pji->hash_table_size, false);
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         return rc;
     }
 
-    rc = session_smdata_construct(job, pji->session_id);
+    rc = session_smdata_construct(job, pji->session_id, false);
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
     }
@@ -2603,21 +3134,10 @@ get_local_job_data_info(
      * that does not exist. */
     size_t nprocarrays = 0;
     bool have_job_level_kv = false;
-    /* How many key/value pairs go into that table between them. This is a
-     * different quantity from the element count, and the estimate below
-     * needs both: the elements size the table, the pairs size the values
-     * hanging off it and the key index describing them. Conflating the
-     * two is what made the element count wrong in the first place. */
-    size_t nkvals = 0;
     uint32_t sid = UINT32_MAX;
 
-    pmix_buffer_t data;
-    PMIX_CONSTRUCT(&data, pmix_buffer_t);
-
     pmix_kval_t *kvi;
     PMIX_LIST_FOREACH (kvi, &job_cb->kvs, pmix_kval_t) {
-        // Calculate some statistics so we can make an educated estimate on the
-        // size of structures we need for our backing store.
         if (PMIX_DATA_ARRAY == kvi->value->type &&
             NULL != kvi->value->data.darray &&
             NULL != kvi->value->data.darray->array &&
@@ -2627,7 +3147,6 @@ get_local_job_data_info(
              * describes. */
             if (PMIX_CHECK_KEY(kvi, PMIX_PROC_INFO_ARRAY)) {
                 nprocarrays += 1;
-                nkvals += kvi->value->data.darray->size;
             }
             /* See if this is the job's session ID. If so, capture it.
              *
@@ -2646,7 +3165,7 @@ get_local_job_data_info(
                     );
                     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                         PMIX_ERROR_LOG(rc);
-                        goto out;
+                        return rc;
                     }
                 }
             }
@@ -2656,23 +3175,12 @@ get_local_job_data_info(
          * entry between them. */
         else {
             have_job_level_kv = true;
-            nkvals += 1;
-        }
-
-        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &data, kvi, 1, PMIX_KVAL);
-        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
-            PMIX_ERROR_LOG(rc);
-            goto out;
         }
     }
     pji->session_id = sid;
-    pji->packed_size = data.bytes_used;
     /* Entries, not capacity: pmix_hash_table_init() applies the density
      * ratio itself, so passing it a capacity double-applied it. */
     pji->hash_table_size = nprocarrays + (have_job_level_kv ? 1 : 0);
-    pji->nkvals = nkvals;
-out:
-    PMIX_DESTRUCT(&data);
     return rc;
 }
 
@@ -2848,15 +3356,14 @@ server_register_new_job_info(
         PMIX_ERROR_LOG(rc);
         goto out;
     }
-    // Pack the data so we can see how large it is. This will help inform how
-    // large to make the shared-memory segments associated with these data.
+    // Find the job's session and how many ranks its data describes.
     rc = get_local_job_data_info(&job_cb, &pji);
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         goto out;
     }
     // Get the shared-memory segments ready for job data.
-    rc = prepare_shmem3_stores_for_local_job_data(job, &pji);
+    rc = prepare_shmem3_stores_for_local_job_data(job, &pji, &job_cb.kvs);
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         goto out;
@@ -2878,7 +3385,7 @@ out:
 static pmix_status_t
 server_register_job_info(
     struct pmix_peer_t *peer_struct,
-    pmix_buffer_t *reply
+    pmix_buffer_t **reply
 ) {
     PMIX_GDS_SHMEM3_VVOUT_HERE();
     pmix_status_t rc = PMIX_SUCCESS;
@@ -2925,8 +3432,12 @@ server_register_job_info(
     } while (false);
 
     if (PMIX_LIKELY(PMIX_SUCCESS == rc)) {
-        // Copy reply over to send the connection info to the given peer.
-        PMIX_BFROPS_COPY_PAYLOAD(rc, peer, reply, job->conni);
+        // Every local client is sent the same connection info, so hand
+        // out a reference to the cached buffer rather than a copy of it.
+        // Anything that changes what it describes replaces job->conni
+        // instead of packing into it, so sends already queued are safe.
+        PMIX_RETAIN(job->conni);
+        *reply = job->conni;
     }
     else {
         PMIX_ERROR_LOG(rc);
@@ -3216,74 +3727,57 @@ store_job_info(
 
 /**
  * Returns size required to store modex data.
+ *
+ * This is the tally server_store_modex() took of the whole contribution
+ * before storing any of it, so it is what the image will hold, not a
+ * guess: the tables at their final size, and every entry, key and
+ * payload as the image will round them. It used to be scaled up from the
+ * first proc's blob alone - by a compression factor, a fluff factor and
+ * segment_size_multiplier - and then had to hold every proc's.
+ *
+ * A generation that compacts the retired ones (see
+ * compact_modex_priors()) has to hold them as well. Each is bounded by
+ * the bytes it already uses - pmix_shmem_flat_merge() never spends more
+ * on a value than its source did - and its ranks and values are added to
+ * the tables, counting a rank that posted to several generations once
+ * per generation. That overstates the tables a little; it never
+ * understates them, so the rank table never has to grow.
  */
 static pmix_gds_shmem3_modex_info_t
 get_modex_sizing_data(
-    const pmix_gds_shmem3_job_t *job,
-    const pmix_buffer_t *buff
-) {
-    const size_t kval_size = sizeof(pmix_kval_t);
-    // The default values if not provided with modex size info. More fluff than
-    // in other places because this calculation is more imprecise. In many ways
-    // this is okay because mmap() implements demand paging.
-    float fluff = 5.0;
-    // Multiplier to fudge compression factor. zlib max compression is 5:1.
-    size_t segment_size = buff->bytes_used * 5;
-    // Get an estimate on the number of kvals we need to store.
-    const size_t nkvals = (segment_size / (float)kval_size) + kval_size;
-    /* The modex table is keyed by RANK, not by key: pmix_hash_store()
-     * looks up one pmix_proc_data_t per rank and hangs that rank's values
-     * off it in a pointer array. So the table needs one element per rank
-     * whose data lands in this segment - the procs of this namespace,
-     * since a blob for another namespace goes to that job's own segment -
-     * and not, as it used to compute, one per byte-group of payload. At
-     * 32 ranks that was the difference between 32 elements and tens of
-     * thousands, every one of which had to be zeroed into a fresh
-     * mapping before the first value could be stored.
-     *
-     * nprocs comes from the host's PMIX_JOB_SIZE and is not guaranteed to
-     * have arrived; the table grows itself if this is short, so a floor
-     * of one is a slow path rather than a wrong answer. */
-    size_t nranks = (size_t)job->nspace->nprocs;
+    pmix_gds_shmem3_job_t *job,
+    bool compact
+) {
+    pmix_gds_shmem3_modex_seg_t *seg;
+    size_t nranks = job->modex_need_ranks;
+    size_t nkvals = job->modex_need_kvals;
+    size_t bytes = job->modex_need_bytes;
+
+    if (compact) {
+        PMIX_LIST_FOREACH (seg, &job->modex_prior, pmix_gds_shmem3_modex_seg_t) {
+            if (NULL == seg->smmodex) {
+                continue;
+            }
+            nranks += seg->smmodex->nranks;
+            nkvals += seg->smmodex->nentries;
+            bytes += (size_t)seg->smmodex->used;
+        }
+    }
+    // RANK_UNDEF data is filed under rank 0, so there is always one.
     if (0 == nranks) {
         nranks = 1;
     }
-    // Entries, not capacity: pmix_hash_table_init() applies the density
-    // ratio itself, so handing it a capacity would double-apply it.
-    const size_t nhtelems = nranks;
-    // We also need storage space for the hash table, its elements, and the
-    // per-rank structures those elements point at.
-    segment_size += sizeof(pmix_hash_table_t);
-    segment_size += pmix_hash_table_sizeof_storage(nhtelems);
-    segment_size += nranks * pmix_hash_sizeof_proc_storage();
-    /* The keyindex that translates the indices in that hash table lives
-     * in this segment too. An empty one is already ~170 KB - both its
-     * children are built at a fixed capacity whatever the key count turns
-     * out to be - and each distinct key then costs a record plus three
-     * copies of its own string. We cannot know the number of distinct
-     * keys without unpacking, so bound it by nkvals; the real count is
-     * normally far smaller.
-     *
-     * The key *lengths* are bounded by the blob, not by PMIX_MAX_KEYLEN.
-     * Every key here arrived in the buffer being unpacked, so the key
-     * strings cannot total more than that buffer decompresses to.
-     * Reserving 511 bytes for each instead made this one term roughly
-     * fifty times the payload - by far the largest thing in this
-     * estimate, and the reason a 1.3 MB modex was getting an 80 MB
-     * segment. */
-    segment_size += pmix_keyindex_sizeof_fixed_storage();
-    segment_size += nkvals * pmix_hash_sizeof_key_entry(0);
-    // Three copies of every key string, against a payload already scaled
-    // by the compression factor above.
-    segment_size += 3 * (buff->bytes_used * 5);
-    // Include some extra fluff that empirically seems reasonable.
-    segment_size *= fluff;
-    // Adjust (increase or decrease) segment size by the given parameter size.
-    segment_size *= pmix_gds_shmem3_segment_size_multiplier;
+
+    size_t segment_size = pmix_shmem_flat_sizeof_tables(nranks, nkvals) + bytes;
+    // Exact, so the multiplier can only add headroom.
+    if (1.0 < pmix_gds_shmem3_segment_size_multiplier) {
+        segment_size *= pmix_gds_shmem3_segment_size_multiplier;
+    }
 
     pmix_gds_shmem3_modex_info_t result = {
         .size = segment_size,
-        .num_ht_elements = nhtelems
+        .nranks = nranks,
+        .nkvals = nkvals
     };
     return result;
 }
@@ -3383,6 +3877,9 @@ server_store_modex_cb(pmix_proc_t *proc,
         pmix_gds_shmem3_set_status(
             job, PMIX_GDS_SHMEM3_MODEX_ID, PMIX_GDS_SHMEM3_READY_FOR_USE
         );
+        job->modex_need_bytes = 0;
+        job->modex_need_ranks = 0;
+        job->modex_need_kvals = 0;
         return PMIX_SUCCESS;
     }
 
@@ -3406,13 +3903,13 @@ server_store_modex_cb(pmix_proc_t *proc,
      * gds_shmem3_fetch.c). See openpmix#4087; examples/modex_twice.c is
      * the canary. Either way the finished segment has been advertised
      * and local clients have it mapped, so it must not be written again:
-     * storing into it can rehash the table and reallocate the key index
-     * underneath a reader, and the segment was sized for the first
-     * modex's data, so a larger second one overruns the allocator and
-     * aborts the server. Start a fresh segment instead. */
+     * storing into it can replace a value underneath a reader, and the
+     * segment was sized for the first modex's data, so a larger second
+     * one would not fit. Start a fresh segment instead. */
     const bool complete = pmix_gds_shmem3_has_status(
         job, PMIX_GDS_SHMEM3_MODEX_ID, PMIX_GDS_SHMEM3_READY_FOR_USE
     );
+    bool compact = false;
     if (!attached || complete) {
         if (complete) {
             PMIX_GDS_SHMEM3_VOUT(
@@ -3428,6 +3925,7 @@ server_store_modex_cb(pmix_proc_t *proc,
                     PMIX_ERROR_LOG(rc);
                     return rc;
                 }
+                compact = modex_wants_compaction(job);
             } else {
                 /* a cumulative contribution repeats everything, so it
                  * supersedes this generation and every one behind it */
@@ -3436,15 +3934,16 @@ server_store_modex_cb(pmix_proc_t *proc,
             }
             advance_modex_generation(job);
         }
-        /* what the clients have to be told about this generation */
-        job->modex_is_delta = isdelta;
+        /* What the clients have to be told about this generation. One
+         * that compacts the chain stands on its own whatever arrived, and
+         * saying so is what has each client drop its retired ones too. */
+        job->modex_is_delta = isdelta && !compact;
         /* The name has to differ per generation or the backing paths
          * collide - they are built from the nspace, this pid and this
          * name. */
         char segname[PMIX_PATH_MAX];
         snprintf(segname, sizeof(segname), "modexdata.%u", job->modex_generation);
-        // Get the global packed buffer size from ctx.
-        pmix_gds_shmem3_modex_info_t minfo = get_modex_sizing_data(job, pbkt);
+        pmix_gds_shmem3_modex_info_t minfo = get_modex_sizing_data(job, compact);
         // Create and attach to the shared-memory
         // segment that will back these data.
         rc = shmem3_segment_create_and_attach(
@@ -3455,14 +3954,21 @@ server_store_modex_cb(pmix_proc_t *proc,
             return rc;
         }
 
-        rc = modex_smdata_construct(job, minfo.num_ht_elements);
+        rc = modex_smdata_construct(job, minfo.nranks, minfo.nkvals);
         if (PMIX_SUCCESS != rc) {
             PMIX_ERROR_LOG(rc);
             return rc;
         }
+        /* Before the delta goes in, so that it lands on top of what it
+         * changes exactly as it would have on top of the chain. */
+        if (compact) {
+            rc = compact_modex_priors(job);
+            if (PMIX_SUCCESS != rc) {
+                return rc;
+            }
+        }
     }
 
-    pmix_hash_table_t *const ht = job->smmodex->hashtab;
     // This is data returned via the PMIx_Fence call when data collection was
     // requested, so it only contains REMOTE/GLOBAL data. The byte object
     // contains the rank followed by pmix_kval_ts.
@@ -3470,8 +3976,8 @@ server_store_modex_cb(pmix_proc_t *proc,
     while (true) {
         // it is okay to use a static variable here and construct it
         // because we are NOT going to actually store the variable
-        // anywhere - the hash_store function COPIES it into an
-        // appropriately allocated object
+        // anywhere - pmix_shmem_flat_store() COPIES it into the
+        // segment
         PMIX_CONSTRUCT(&kv, pmix_kval_t);
 
         cnt = 1;
@@ -3520,22 +4026,12 @@ server_store_modex_cb(pmix_proc_t *proc,
             }
             pmix_server_notify_deleted(&dproc, PMIX_DEL_REMOTE, kv.key, NULL);
         }
-        if (PMIX_CHECK_KEY(&kv, PMIX_QUALIFIED_VALUE)) {
-            rc = pmix_gds_shmem3_store_qualified(
-                ht, (PMIX_RANK_UNDEF == rank) ? 0 : rank, kv.value,
-                job->smmodex->keyindex
-            );
-        }
-        else {
-            // Note the keyindex: the indices this store mints have to be
-            // readable by every local client that maps the segment, so
-            // they come from the segment's own translation table rather
-            // than from this process's global one.
-            rc = pmix_hash_store(
-                ht, (PMIX_RANK_UNDEF == rank) ? 0 : rank, &kv, NULL, 0,
-                job->smmodex->keyindex
-            );
-        }
+        // The image files a PMIX_QUALIFIED_VALUE under its own key with
+        // its qualifiers alongside, as pmix_gds_shmem3_store_qualified()
+        // does for a hash table, so there is no second path for it here.
+        rc = pmix_shmem_flat_store(
+            job->smmodex, (PMIX_RANK_UNDEF == rank) ? 0 : rank, &kv
+        );
         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
             PMIX_ERROR_LOG(rc);
             PMIX_DESTRUCT(&kv);
@@ -3558,6 +4054,56 @@ server_store_modex_cb(pmix_proc_t *proc,
     return rc;
 }
 
+/**
+ * The sizing pass's counterpart to server_store_modex_cb(): unpack the
+ * proc's blob exactly as the store will, and add up what storing it will
+ * take instead of storing it.
+ */
+static pmix_status_t
+server_size_modex_cb(pmix_proc_t *proc,
+                     pmix_buffer_t *pbkt,
+                     uint8_t kind)
+{
+    pmix_status_t rc;
+    pmix_gds_shmem3_job_t *job;
+    pmix_kval_t kv;
+    int32_t cnt;
+    size_t size;
+
+    PMIX_HIDE_UNUSED_PARAMS(kind);
+
+    if (NULL == pbkt) {
+        // The end of this namespace's share; nothing to count.
+        return PMIX_SUCCESS;
+    }
+    rc = pmix_gds_shmem3_get_job_tracker(proc->nspace, false, &job);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
+    // One rank table slot per blob. A proc contributing twice is counted
+    // twice, which costs a slot and never a growth.
+    job->modex_need_ranks++;
+    while (true) {
+        PMIX_CONSTRUCT(&kv, pmix_kval_t);
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, pbkt, &kv, &cnt, PMIX_KVAL);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_DESTRUCT(&kv);
+            break;
+        }
+        rc = pmix_shmem_flat_sizeof_kval(&kv, &size);
+        PMIX_DESTRUCT(&kv);
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            PMIX_ERROR_LOG(rc);
+            return rc;
+        }
+        job->modex_need_bytes += size;
+        job->modex_need_kvals++;
+    }
+    return (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER == rc) ? PMIX_SUCCESS : rc;
+}
+
 /**
  * This function is only called by the PMIx server when its host has received
  * data from some other peer. It therefore always contains data solely from
@@ -3568,12 +4114,36 @@ server_store_modex(pmix_buffer_t *buff,
                    const char *nspace,
                    void *cbdata)
 {
+    pmix_gds_shmem3_component_t *const component = &pmix_mca_gds_shmem3_component;
+    pmix_gds_shmem3_job_t *job;
+    pmix_status_t rc;
+
     PMIX_GDS_SHMEM3_VVOUT_HERE();
 
     PMIX_GDS_SHMEM3_VOUT(
         "%s:%s buff_size=%zd", __func__,
         PMIX_NAME_PRINT(&pmix_globals.myid), buff->bytes_used
     );
+    /* Walk the contribution twice: once to measure it, then to store it.
+     * A generation's segment is created when its first blob arrives and
+     * cannot grow, so it has to be created at the size of all of them -
+     * which nothing short of unpacking them can say. The walk leaves the
+     * buffer where it found it for the second. */
+    pmix_mutex_lock(&component->joblock);
+    PMIX_LIST_FOREACH (job, &component->jobs, pmix_gds_shmem3_job_t) {
+        job->modex_need_bytes = 0;
+        job->modex_need_ranks = 0;
+        job->modex_need_kvals = 0;
+    }
+    pmix_mutex_unlock(&component->joblock);
+
+    char *const mark = buff->unpack_ptr;
+    rc = pmix_gds_base_store_modex(buff, nspace, server_size_modex_cb, cbdata);
+    buff->unpack_ptr = mark;
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
     return pmix_gds_base_store_modex(buff, nspace, server_store_modex_cb, cbdata);
 }
 
@@ -3749,7 +4319,8 @@ pmix_gds_base_module_t pmix_shmem3_module = {
     .assemb_kvs_req = NULL,
     .accept_kvs_resp = NULL,
     .mark_modex_complete = server_mark_modex_complete,
-    .recv_modex_complete = client_recv_modex_complete
+    .recv_modex_complete = client_recv_modex_complete,
+    .report_usage = report_usage
 };
 
 /*
@@ -18,8 +18,10 @@
 #include "include/pmix_common.h"
 
 #include "src/include/pmix_globals.h"
+#include "src/hwloc/pmix_hwloc.h"
 #include "src/threads/pmix_threads.h"
 #include "src/util/pmix_shmem.h"
+#include "src/util/pmix_shmem_flat.h"
 #include "src/mca/gds/base/base.h"
 
 #ifdef HAVE_STDINT_H
@@ -68,7 +70,10 @@
  *    resolved against the process-global index instead. No size changed,
  *    but a peer built before this looks for reserved keys in a table that
  *    no longer holds them. */
-#define PMIX_GDS_SHMEM3_LAYOUT_VERSION 2u
+/* 3: the modex segment holds a position-independent pmix_shmem_flat_t
+ *    image instead of a hash table and key index, and is mapped wherever
+ *    the reader likes rather than at the writer's address. */
+#define PMIX_GDS_SHMEM3_LAYOUT_VERSION 3u
 
 #define PMIX_GDS_SHMEM3_LAYOUT_ID                                            \
     ((uint32_t)(                                                             \
@@ -83,13 +88,15 @@
       +  23u * (uint32_t)sizeof(pmix_kval_t)                                 \
       +  29u * (uint32_t)sizeof(pmix_gds_shmem3_shared_session_data_t)       \
       +  31u * (uint32_t)sizeof(pmix_gds_shmem3_shared_job_data_t)           \
-      +  37u * (uint32_t)sizeof(pmix_gds_shmem3_shared_modex_data_t)         \
+      +  37u * (uint32_t)sizeof(pmix_shmem_flat_t)                          \
       +  41u * (uint32_t)sizeof(pmix_gds_shmem3_nodeinfo_t)                  \
       +  43u * (uint32_t)sizeof(pmix_gds_shmem3_app_t)                       \
       +  47u * (uint32_t)sizeof(pmix_gds_shmem3_host_alias_t)                \
       +  53u * (uint32_t)sizeof(pmix_keyindex_t)                             \
       +  59u * (uint32_t)sizeof(pmix_regattr_input_t)                        \
       +  61u * (uint32_t)sizeof(pmix_pointer_array_t)                        \
+      +  67u * (uint32_t)sizeof(pmix_shmem_flat_entry_t)                    \
+      +  71u * (uint32_t)sizeof(pmix_shmem_flat_rank_t)                     \
     ))
 
 /**
@@ -116,20 +123,20 @@ PMIX_EXPORT extern double pmix_gds_shmem3_segment_size_multiplier;
 PMIX_EXPORT extern bool pmix_gds_shmem3_force_client_attach_failure;
 
 /**
- * Address space reserved for each modex slot in a job's arena, in bytes.
- * Setting it to zero disables the arena entirely, which restores the
- * pre-arena behavior of placing every segment independently.
- */
-PMIX_EXPORT extern size_t pmix_gds_shmem3_arena_slot_size;
-
-/**
- * How many modex slots a job's arena holds - that is, how many modex
- * generations can be live at once and still be placed in it. More than
- * one is live whenever a fence contributed only what changed, since the
- * generations before such a one remain the only copy of what it did not
- * repeat. Capped at 32 by the occupancy bitmap.
+ * Whether to reserve address space for a job's fixed-address segments
+ * ahead of mapping them. On by default; turning it off places every
+ * segment independently, as before there was an arena.
+ *
+ * Only the modex segment is position-independent. The job and session
+ * segments are still built with PMIx's own classes in a TMA - hash
+ * tables, lists and kvals that point at one another by absolute
+ * address, down to a pmix_dstor_t's pointer to its own inline value -
+ * so a client has to map them where the server did. Until they hold
+ * offsets instead, the arena, pmix_vmem_find_hole(), offset placement
+ * and the fallback to gds/hash when a client cannot get the address
+ * are all still needed; converting them is work of its own.
  */
-PMIX_EXPORT extern size_t pmix_gds_shmem3_arena_modex_slots;
+PMIX_EXPORT extern bool pmix_gds_shmem3_arena;
 
 /**
  * Whether to keep away from the midpoint of the biggest hole when
@@ -137,6 +144,41 @@ PMIX_EXPORT extern size_t pmix_gds_shmem3_arena_modex_slots;
  */
 PMIX_EXPORT extern bool pmix_gds_shmem3_offset_placement;
 
+/**
+ * How many retired modex generations may chain behind the current one
+ * before the next is built as a full generation that replaces them all.
+ * Zero lets the chain grow without bound.
+ */
+PMIX_EXPORT extern unsigned int pmix_gds_shmem3_modex_max_layers;
+
+/**
+ * Whether to ask for huge pages behind the segments this server creates
+ * (see PMIX_SHMEM_HUGE_PAGES). Off by default.
+ */
+PMIX_EXPORT extern bool pmix_gds_shmem3_huge_pages;
+
+/**
+ * Where the pages of the segments this server creates go, parsed from
+ * the numa_policy MCA parameter. PMIX_HWLOC_MEMBIND_NONE by default,
+ * which leaves them wherever the server's progress thread first touches
+ * them.
+ */
+PMIX_EXPORT extern pmix_hwloc_membind_t pmix_gds_shmem3_numa_policy;
+
+/**
+ * Whether a client maps every page of a segment when it attaches,
+ * rather than faulting each in when it is first read. Off by default.
+ */
+PMIX_EXPORT extern bool pmix_gds_shmem3_prefault;
+
+/**
+ * How many threads build a job's segments when a server registers it.
+ * 1 (the default) builds them on the progress thread alone, as always;
+ * 0 uses one per online processor. A job too small to keep that many
+ * busy gets fewer; see pmix_gds_shmem3_store_local_job_data_in_shmem3().
+ */
+PMIX_EXPORT extern unsigned int pmix_gds_shmem3_populate_threads;
+
 /**
  * Testing-only MCA parameter. When true, a client's attach is forced to
  * fail only for the modex segment, leaving the job and session attaches
@@ -192,6 +234,11 @@ typedef struct {
     pmix_mutex_t joblock;
     /** List of sessions that I'm supporting. */
     pmix_list_t sessions;
+    /** Segments this process could not attach and fell back from, for
+     *  PMIX_GDS_ATTACH_FALLBACKS. Kept here rather than on a job tracker
+     *  because a failed job or session attach takes the tracker with it.
+     *  Touched only on the progress thread. */
+    uint32_t attach_fallbacks;
 } pmix_gds_shmem3_component_t;
 // The component must be visible data for the linker to find it.
 PMIX_EXPORT extern
@@ -277,40 +324,6 @@ typedef struct {
     pmix_keyindex_t *keyindex;
 } pmix_gds_shmem3_shared_job_data_t;
 
-typedef struct {
-    /** Shared-memory allocator for data this structure. */
-    pmix_tma_t tma;
-    /** Holds the current address of the shared-memory allocator. */
-    void *current_addr;
-    /** Stores static modex data. */
-    pmix_hash_table_t *hashtab;
-    /** Translates the NON-RESERVED key indices stored in hashtab above.
-     *
-     * An index in that table crosses a process boundary - the server
-     * writes it and every local client reads it - so the two ends have
-     * to agree on what it means. They agree in two different ways, and
-     * only one of them needs anything stored here:
-     *
-     *  - a RESERVED attribute is numbered by the dictionary, and those
-     *    ids are pinned in contrib/dictionary_ids.txt precisely so that
-     *    they are the same in every process and every release. Nothing
-     *    has to be carried, so nothing is: lookup_key() resolves any id
-     *    below PMIX_INDEX_BOUNDARY against the process-global index.
-     *  - a NON-RESERVED key is numbered on first encounter, in an order
-     *    that depends on what arrived and when, so no two processes can
-     *    be assumed to agree. Those go here, beside the data they
-     *    describe, where they only have to be consistent within this one
-     *    segment - which they are, because exactly one process writes it.
-     *
-     * The reserved half used to be carried here too, which meant the
-     * server allocated several hundred entries out of the segment, for
-     * every generation, to say what the dictionary already said.
-     *
-     * Clients map the segment read-only, so they must reach this only
-     * through pmix_hash_find_key() and friends, which never register. */
-    pmix_keyindex_t *keyindex;
-} pmix_gds_shmem3_shared_modex_data_t;
-
 /* A key this job has been told to stop answering for.
  *
  * Deliberately NOT in shared memory. A segment a client can see is never
@@ -340,12 +353,13 @@ PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_gds_shmem3_tombstone_t);
  * lands in does not stand on its own and the ones before it cannot be
  * dropped. They are held here, newest first, and a read walks them in
  * that order. A cumulative contribution supersedes everything before it
- * and collapses the whole list. */
+ * and collapses the whole list; so, once the list reaches
+ * modex_max_layers, does a generation built to replace it. */
 typedef struct {
     pmix_list_item_t super;
     pmix_gds_shmem3_status_t status;
     pmix_shmem_t *shmem3;
-    pmix_gds_shmem3_shared_modex_data_t *smmodex;
+    pmix_shmem_flat_t *smmodex;
     /** which generation this was, so a tombstone recorded later can be
      * told from one recorded before it - see pmix_gds_shmem3_tombstone_t */
     uint32_t generation;
@@ -399,14 +413,29 @@ typedef struct {
     pmix_shmem_t *modex_shmem3;
     /** Points to shared job data located in a shared-memory segment. */
     pmix_gds_shmem3_shared_job_data_t *smdata;
-    /** Points to shared modex data located in a shared-memory segment. */
-    pmix_gds_shmem3_shared_modex_data_t *smmodex;
+    /** Points to shared modex data located in a shared-memory segment.
+     *
+     * Unlike smdata, this holds no pointer: it is a pmix_shmem_flat_t
+     * image, every reference in it relative to itself, so a client reads
+     * it wherever its mapping happened to land. That matters here more
+     * than anywhere - the modex segment is the one mapped at fence time,
+     * when a client's address space is at its fullest, and a client that
+     * could not get the server's address used to lose the shared-memory
+     * path to every remote proc's data. */
+    pmix_shmem_flat_t *smmodex;
     /** Does the current modex generation hold only what changed?
      *
      * Set when it was built from a PMIX_MODEX_DELTA contribution, and
      * told to each client in the segment blob so it can make the same
      * keep-or-drop decision this server made. */
     bool modex_is_delta;
+    /** What the next modex generation has to hold: bytes of entries,
+     *  ranks and values, tallied by the sizing pass server_store_modex()
+     *  makes over a contribution before storing it. All zero when there is
+     *  no tally. Touched only on the progress thread. */
+    size_t modex_need_bytes;
+    size_t modex_need_ranks;
+    size_t modex_need_kvals;
     /** Guards the process-local state a read walks: the modex generation
      *  chain below and the tombstone list.
      *
@@ -432,7 +461,9 @@ typedef struct {
      * Non-empty only when a delta contribution has been stored: such a
      * generation holds just what changed, so what came before it is
      * still the only copy of everything it did not repeat. A read walks
-     * this after the current generation. */
+     * this after the current generation. Bounded by modex_max_layers:
+     * past that, the next generation is built from the whole chain and
+     * the chain goes (see compact_modex_priors()). */
     pmix_list_t modex_prior;
     /** Base of this job's reserved address-space arena, or 0 if it has
      *  none. See "The address-space arena" in AGENTS.md.
@@ -441,8 +472,13 @@ typedef struct {
      * its local clients - holds the SAME range, in its own address space,
      * from the moment it learns of the job. Segments are then mapped over
      * that reservation rather than into whatever happens to be free,
-     * which is what makes a fixed-address attach reliable at a point in
-     * the run when the process is no longer empty.
+     * which is what makes a fixed-address attach reliable.
+     *
+     * Only the job segment needs one now. Modex generations used to have
+     * slots at the top of it, reserved at PMIx_Init for a fence that had
+     * yet to happen; they are position-independent (see smmodex) and map
+     * anywhere, so the arena is one segment's footprint rather than that
+     * plus a gibibyte per generation.
      */
     uintptr_t arena_base;
     /** Size of the reservation above. Zero means there is none. */
@@ -451,21 +487,12 @@ typedef struct {
      *  the job does (the job segment). Server-side only: a client maps
      *  wherever the server tells it to, so it has no carving to do. */
     size_t arena_static_used;
-    /** Size of each modex slot at the top of the arena.
-     *
-     * A modex generation gets a slot of its own and holds it for as long
-     * as it is readable, which is NOT just until the next one arrives: a
-     * delta generation carries only what changed, so the generations
-     * before it stay mapped and answerable on job->modex_prior. The
-     * slots therefore have to be allocated and freed, not alternated
-     * between - see arena_alloc_modex(), which reads the occupancy off
-     * the live segments rather than keeping a tally that could drift.
-     * Server-side only, like arena_static_used. */
-    size_t arena_slot_bytes;
-    /** How many modex slots the arena was reserved with. A generation
-     *  that arrives when they are all taken places itself outside the
-     *  arena, the way everything did before there was one. */
-    size_t arena_slots;
+    /** Seconds this process spent getting each of the job's segments
+     *  mapped, indexed by pmix_gds_shmem3_job_shmem3_id_t: creating and
+     *  attaching them on the server, attaching them on a client. The
+     *  modex entry is for the current generation. Zero for a segment
+     *  this process has not mapped. Reported as PMIX_GDS_ATTACH_TIME. */
+    double attach_time[PMIX_GDS_SHMEM3_INVALID_ID];
     /** Packed connection information to this segment. */
     pmix_buffer_t *conni;
 } pmix_gds_shmem3_job_t;
@@ -502,6 +529,33 @@ pmix_gds_shmem3_acquire_job_tracker(
     pmix_gds_shmem3_job_t **job
 );
 
+/**
+ * Give "sub" a sub-arena of "parent": a TMA that takes chunks from the
+ * parent under "lock" and hands out blocks from them without it, so that
+ * several threads can each fill their own part of one segment at once.
+ * Every sub-arena of a parent has to share the one lock, and nothing else
+ * may allocate from the parent while any of them is in use.
+ *
+ * The parent may be a segment's TMA or a counting one; a sub-arena asks
+ * the same of either, so sizing a segment by a dry run stays exact.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_gds_shmem3_subarena_init(
+    pmix_tma_t *parent,
+    pmix_mutex_t *lock,
+    pmix_tma_t *sub
+);
+
+/**
+ * Retire a sub-arena, folding what it could not use into its parent's
+ * stranded bytes. Its blocks stay where they are; only the sub-arena's
+ * own bookkeeping goes.
+ */
+PMIX_EXPORT void
+pmix_gds_shmem3_subarena_fini(
+    pmix_tma_t *sub
+);
+
 END_C_DECLS
 
 #endif
@@ -31,6 +31,10 @@
 
 #include "gds_shmem3.h"
 
+#include "src/util/pmix_output.h"
+
+#include <strings.h>
+
 static int
 gds_shmem3_component_register(void);
 
@@ -81,21 +85,29 @@ bool pmix_gds_shmem3_force_client_attach_failure = false;
 
 bool pmix_gds_shmem3_force_modex_attach_failure = false;
 
-/* One gibibyte per slot. Nothing is committed, so the cost of being
- * generous is a virtual address range and a VMA; the cost of being
- * stingy is a modex that does not fit and has to be placed the old
- * way. */
-size_t pmix_gds_shmem3_arena_slot_size = 1024UL * 1024UL * 1024UL;
+bool pmix_gds_shmem3_arena = true;
 
-/* Four generations live at once. One is the steady state; more than one
- * only arises where a fence contributed just what changed, and each such
- * fence adds one until a cumulative contribution collapses them. Four
- * covers the shapes seen in practice and costs nothing but address
- * space; past it, a generation is placed outside the arena. */
-size_t pmix_gds_shmem3_arena_modex_slots = 4;
+/* Where arena_slot_size and arena_modex_slots land. Modex segments no
+ * longer live in the arena, so nothing reads these: the parameters are
+ * only still registered, as deprecated, so that a site that sets them
+ * is warned rather than told they do not exist. */
+static size_t retired_arena_slot_size = 0;
+static size_t retired_arena_modex_slots = 0;
 
 bool pmix_gds_shmem3_offset_placement = true;
 
+unsigned int pmix_gds_shmem3_modex_max_layers = 8;
+
+bool pmix_gds_shmem3_huge_pages = false;
+
+pmix_hwloc_membind_t pmix_gds_shmem3_numa_policy = PMIX_HWLOC_MEMBIND_NONE;
+
+static char *numa_policy = "none";
+
+bool pmix_gds_shmem3_prefault = false;
+
+unsigned int pmix_gds_shmem3_populate_threads = 1;
+
 static int
 gds_shmem3_component_register(void)
 {
@@ -104,10 +116,10 @@ gds_shmem3_component_register(void)
     varidx = pmix_mca_base_component_var_register(
         &pmix_mca_gds_shmem3_component.super,
         "segment_size_multiplier",
-        "Multiplier that influences the ultimate sizes of the shared-memory "
-        "segments used for gds data storage. As a percentage, values less or "
-        "greater than 1.0 decrease or increase the final segment sizes, "
-        "respectively.",
+        "Multiplier applied to the sizes of the shared-memory segments used "
+        "for gds data storage. Segments are sized to exactly what they will "
+        "hold, so only values greater than 1.0 have an effect: they add "
+        "that much headroom.",
         PMIX_MCA_BASE_VAR_TYPE_DOUBLE,
         &pmix_gds_shmem3_segment_size_multiplier
     );
@@ -145,29 +157,43 @@ gds_shmem3_component_register(void)
 
     varidx = pmix_mca_base_component_var_register(
         &pmix_mca_gds_shmem3_component.super,
-        "arena_slot_size",
-        "Bytes of address space reserved for each modex slot in a job's "
-        "arena. The reservation holds the addresses a client will later "
-        "need to map at; nothing is committed, so this costs virtual "
-        "address space only. Set to 0 to disable the arena and place "
+        "arena",
+        "Reserve address space for a job's fixed-address segments when the "
+        "job is first seen, and map them over that reservation. The range "
+        "is held by the server and by each client from PMIx_Init on, so "
+        "nothing else can take it in the meantime. Modex segments are "
+        "position-independent and never need it. Set to false to place "
         "every segment independently.",
+        PMIX_MCA_BASE_VAR_TYPE_BOOL,
+        &pmix_gds_shmem3_arena
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
+
+    /* The arena used to hold modex generations too, sized by these.
+     * Nothing has replaced them, so they are not synonyms of anything;
+     * the MCA base warns whoever still sets them. */
+    varidx = pmix_mca_base_component_var_register_deprecated(
+        &pmix_mca_gds_shmem3_component.super,
+        "arena_slot_size",
+        "DEPRECATED and ignored. Modex segments are position-independent "
+        "and are no longer placed in the arena; set arena to false to "
+        "disable the arena.",
         PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
-        &pmix_gds_shmem3_arena_slot_size
+        &retired_arena_slot_size
     );
     if (varidx < 0) {
         return PMIX_ERROR;
     }
 
-    varidx = pmix_mca_base_component_var_register(
+    varidx = pmix_mca_base_component_var_register_deprecated(
         &pmix_mca_gds_shmem3_component.super,
         "arena_modex_slots",
-        "How many modex generations a job's arena can hold at once. More "
-        "than one is live whenever a fence contributed only what changed, "
-        "since the generations before such a one are still the only copy "
-        "of what it did not repeat. A generation that arrives with every "
-        "slot taken is placed outside the arena. Capped at 32.",
+        "DEPRECATED and ignored. Modex segments are position-independent "
+        "and are no longer placed in the arena, so it has no modex slots.",
         PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
-        &pmix_gds_shmem3_arena_modex_slots
+        &retired_arena_modex_slots
     );
     if (varidx < 0) {
         return PMIX_ERROR;
@@ -187,6 +213,92 @@ gds_shmem3_component_register(void)
     if (varidx < 0) {
         return PMIX_ERROR;
     }
+
+    varidx = pmix_mca_base_component_var_register(
+        &pmix_mca_gds_shmem3_component.super,
+        "modex_max_layers",
+        "Most retired modex generations a job keeps behind the current one. "
+        "A fence that contributes only what changed (a delta) stores just "
+        "that and chains to the generations before it; once this many are "
+        "chained, the next fence folds them into a single full generation. "
+        "0 never folds them.",
+        PMIX_MCA_BASE_VAR_TYPE_UNSIGNED_INT,
+        &pmix_gds_shmem3_modex_max_layers
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
+
+    varidx = pmix_mca_base_component_var_register(
+        &pmix_mca_gds_shmem3_component.super,
+        "huge_pages",
+        "Back shared-memory segments with transparent huge pages where the "
+        "kernel allows them for shared memory, rounding each segment up to "
+        "a whole number of them. Cuts the TLB misses and page faults of "
+        "many clients reading large segments; falls back to ordinary pages "
+        "where huge pages are unavailable. A segment whose backing file is "
+        "on hugetlbfs uses that mount's pages regardless.",
+        PMIX_MCA_BASE_VAR_TYPE_BOOL,
+        &pmix_gds_shmem3_huge_pages
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
+
+    numa_policy = "none";
+    varidx = pmix_mca_base_component_var_register(
+        &pmix_mca_gds_shmem3_component.super,
+        "numa_policy",
+        "Where to place the pages of the shared-memory segments a server "
+        "creates: none (wherever the server first touches them), "
+        "interleave (round-robin across every NUMA node, so no client is "
+        "remote from all of them) or local (on the NUMA nodes the server "
+        "is bound to). Has no effect on a single-node machine, and none "
+        "unless the segments' backing files are on tmpfs (e.g., /dev/shm).",
+        PMIX_MCA_BASE_VAR_TYPE_STRING,
+        &numa_policy
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
+    if (NULL == numa_policy || 0 == strcasecmp(numa_policy, "none")) {
+        pmix_gds_shmem3_numa_policy = PMIX_HWLOC_MEMBIND_NONE;
+    } else if (0 == strcasecmp(numa_policy, "interleave")) {
+        pmix_gds_shmem3_numa_policy = PMIX_HWLOC_MEMBIND_INTERLEAVE;
+    } else if (0 == strcasecmp(numa_policy, "local")) {
+        pmix_gds_shmem3_numa_policy = PMIX_HWLOC_MEMBIND_LOCAL;
+    } else {
+        pmix_output(0, "gds/shmem3: invalid numa_policy \"%s\"", numa_policy);
+        return PMIX_ERR_BAD_PARAM;
+    }
+
+    varidx = pmix_mca_base_component_var_register(
+        &pmix_mca_gds_shmem3_component.super,
+        "prefault",
+        "Have a client map every page of a shared-memory segment when it "
+        "attaches, in one pass, instead of taking a page fault the first "
+        "time it reads each one.",
+        PMIX_MCA_BASE_VAR_TYPE_BOOL,
+        &pmix_gds_shmem3_prefault
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
+
+    varidx = pmix_mca_base_component_var_register(
+        &pmix_mca_gds_shmem3_component.super,
+        "populate_threads",
+        "Number of threads a server uses to copy a newly registered job's "
+        "per-process data into its shared-memory segment, while the job's "
+        "local clients wait to attach. 1 does it all on the progress "
+        "thread; 0 uses one thread per online processor. Jobs with too few "
+        "processes to share out use fewer.",
+        PMIX_MCA_BASE_VAR_TYPE_UNSIGNED_INT,
+        &pmix_gds_shmem3_populate_threads
+    );
+    if (varidx < 0) {
+        return PMIX_ERROR;
+    }
     return PMIX_SUCCESS;
 }
 PMIX_MCA_BASE_COMPONENT_INIT(pmix, gds, shmem3)
@@ -719,8 +719,8 @@ modex_fetch(
                                    PMIX_GDS_SHMEM3_READY_FOR_USE)
         && NULL != job->smmodex) {
         mark = pmix_list_get_size(kvs);
-        rc = pmix_hash_fetch(job->smmodex->hashtab, rank, key, qualifiers,
-                             nqual, kvs, job->smmodex->keyindex);
+        rc = pmix_shmem_flat_fetch(job->smmodex, rank, key, qualifiers,
+                                   nqual, kvs);
         if (PMIX_ERR_NOMEM == rc) {
             return rc;
         }
@@ -747,8 +747,8 @@ modex_fetch(
             continue;
         }
         mark = pmix_list_get_size(kvs);
-        r2 = pmix_hash_fetch(seg->smmodex->hashtab, rank, key, qualifiers,
-                             nqual, kvs, seg->smmodex->keyindex);
+        r2 = pmix_shmem_flat_fetch(seg->smmodex, rank, key, qualifiers,
+                                   nqual, kvs);
         if (PMIX_ERR_NOMEM == r2) {
             return r2;
         }
@@ -832,16 +832,13 @@ shmem3_fetch_from_job(
      * whenever the progress thread has just set the current generation
      * aside (see release_modex_segment()) and a read arrives before its
      * replacement is published. That read would have dereferenced NULL. */
-    // Every index in these tables was minted by the server against the
-    // keyindex living in the same segment, never against this process's
-    // global one, so a read has to translate through that same table.
-    // See the comment on pmix_gds_shmem3_shared_modex_data_t.keyindex.
-    //
-    // Every segment carries its own, which is what lets a read of shared
-    // data be independent of pmix_globals.keyindex - a structure the
-    // progress thread rewrites. The modex side of that lives in
-    // modex_fetch(), which has to pair each generation's table with that
-    // generation's index; only the job segment's is needed here.
+    // Every index in the job segment's table was minted by the server
+    // against the keyindex living in the same segment, never against this
+    // process's global one, so a read has to translate through that same
+    // table. That is what lets a read of shared data be independent of
+    // pmix_globals.keyindex - a structure the progress thread rewrites.
+    // The modex has no key indices to translate: its images hold their
+    // key strings (see src/util/pmix_shmem_flat.h).
     /* There is modex data to read if the current generation is ready OR
      * any retired one survives - the two differ during the window in
      * which a delta is being stored, when the current generation has
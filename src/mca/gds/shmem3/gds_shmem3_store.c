@@ -17,10 +17,14 @@
 #include "gds_shmem3_store.h"
 #include "gds_shmem3_utils.h"
 
+#include "src/threads/pmix_parallel.h"
 #include "src/util/pmix_hash.h"
 
 #include "src/mca/bfrops/base/bfrop_base_tma.h"
 
+#include <stdlib.h>
+#include <unistd.h>
+
 /**
  * Convenience function for creating an initialized pmix_kval_t.
  */
@@ -393,13 +397,17 @@ out:
     return rc;
 }
 
+/**
+ * Checks that a PMIX_PROC_INFO_ARRAY is one, and finds the proc it
+ * describes: the host may name it with a rank or a procid, in any
+ * position, and that entry is not itself stored.
+ */
 static pmix_status_t
-store_proc_data(
-    pmix_gds_shmem3_job_t *job,
-    const pmix_kval_t *kval
+proc_array_id(
+    const pmix_kval_t *kval,
+    pmix_rank_t *rank,
+    size_t *idpos
 ) {
-    pmix_status_t rc = PMIX_SUCCESS;
-
     // First, make sure this is proc data.
     if (PMIX_UNLIKELY(!PMIX_CHECK_KEY(kval, PMIX_PROC_INFO_ARRAY))) {
         PMIX_ERROR_LOG(PMIX_ERR_BAD_PARAM);
@@ -412,45 +420,356 @@ store_proc_data(
         PMIX_ERROR_LOG(PMIX_ERR_TYPE_MISMATCH);
         return PMIX_ERR_TYPE_MISMATCH;
     }
-
-    pmix_info_t *const info = (pmix_info_t *)kval->value->data.darray->array;
-    const size_t size = kval->value->data.darray->size;
-    // The array has to say which proc it describes - the host may do
-    // that with a rank or a procid, in any position.
-    pmix_rank_t rank;
-    size_t idpos;
-    rc = pmix_gds_base_proc_array_id(info, size, &rank, &idpos);
+    pmix_status_t rc = pmix_gds_base_proc_array_id(
+        (pmix_info_t *)kval->value->data.darray->array,
+        kval->value->data.darray->size, rank, idpos
+    );
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
-        return rc;
     }
+    return rc;
+}
 
+static pmix_status_t
+store_proc_value(
+    pmix_gds_shmem3_job_t *job,
+    pmix_rank_t rank,
+    pmix_info_t *info
+) {
     pmix_hash_table_t *const ht = job->smdata->local_hashtab;
     pmix_tma_t *const tma = pmix_obj_get_tma(&ht->super);
 
+    pmix_kval_t *kv = PMIX_NEW(pmix_kval_t, tma);
+    kv->key = info->key;
+    kv->value = &info->value;
+    PMIX_GDS_SHMEM3_VVOUT(
+        "%s:%s for nspace=%s rank=%u key=%s",
+        __func__, PMIX_NAME_PRINT(&pmix_globals.myid),
+        job->nspace_id, rank, kv->key
+    );
+    // Store it in the hash_table, numbering the key against the
+    // segment's own index rather than this process's global one -
+    // the clients that read this table do not share our numbering.
+    pmix_status_t rc = pmix_hash_store(ht, rank, kv, NULL, 0, job->smdata->keyindex);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        PMIX_ERROR_LOG(rc);
+    }
+    return rc;
+}
+
+static pmix_status_t
+store_proc_data(
+    pmix_gds_shmem3_job_t *job,
+    const pmix_kval_t *kval
+) {
+    pmix_rank_t rank;
+    size_t idpos;
+    pmix_status_t rc = proc_array_id(kval, &rank, &idpos);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        return rc;
+    }
+
+    pmix_info_t *const info = (pmix_info_t *)kval->value->data.darray->array;
+    const size_t size = kval->value->data.darray->size;
     // Cycle through the values for this rank and store them, skipping
     // the entry that identified the array.
     for (size_t j = 0; j < size; j++) {
         if (j == idpos) {
             continue;
         }
-        pmix_kval_t *kv = PMIX_NEW(pmix_kval_t, tma);
-        kv->key = info[j].key;
-        kv->value = &info[j].value;
-        PMIX_GDS_SHMEM3_VVOUT(
-            "%s:%s for nspace=%s rank=%u key=%s",
-            __func__, PMIX_NAME_PRINT(&pmix_globals.myid),
-            job->nspace_id, rank, kv->key
-        );
-        // Store it in the hash_table, numbering the key against the
-        // segment's own index rather than this process's global one -
-        // the clients that read this table do not share our numbering.
-        rc = pmix_hash_store(ht, rank, kv, NULL, 0, job->smdata->keyindex);
+        rc = store_proc_value(job, rank, &info[j]);
         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            return rc;
+        }
+    }
+    return rc;
+}
+
+/**
+ * Fewest proc arrays worth a populating thread of their own. Below this
+ * a thread costs more to start than the copying it takes off the rest.
+ */
+#define PMIX_GDS_SHMEM3_POPULATE_MIN_PROCS 256
+
+/**
+ * One PMIX_PROC_INFO_ARRAY, resolved on the calling thread before any
+ * worker sees it.
+ */
+typedef struct {
+    const pmix_kval_t *kval;
+    pmix_rank_t rank;
+    size_t idpos;
+    /** Where the array came in the job data: a rank described twice
+     *  keeps the host's order between its arrays once sorted. */
+    size_t order;
+    /** The rank's storage; see pmix_hash_reserve_proc(). */
+    void *proc;
+} populate_entry_t;
+
+/**
+ * A value a worker left for the calling thread to store: its key was not
+ * yet registered, or its rank had no room reserved for it.
+ */
+typedef struct {
+    size_t entry;
+    size_t index;
+} populate_deferred_t;
+
+typedef struct {
+    /** This worker's sub-arena of the job segment. */
+    pmix_tma_t tma;
+    populate_deferred_t *deferred;
+    size_t ndeferred;
+    size_t ndeferred_alloc;
+} populate_worker_t;
+
+/**
+ * What pmix_parallel_range() hands each worker. The items it shares out
+ * are ranks, not entries - "ranks" holds where each rank's entries
+ * start, plus one past the last - so a rank's arrays always go to the
+ * same worker.
+ */
+typedef struct {
+    pmix_gds_shmem3_job_t *job;
+    populate_entry_t *entries;
+    size_t *ranks;
+    populate_worker_t *workers;
+} populate_ctx_t;
+
+/**
+ * How many workers to split "nprocs" proc arrays across.
+ *
+ * This has to come out the same for the dry run that sizes the segment
+ * as for the pass that fills it: how the work is divided decides which
+ * chunks each sub-arena takes, and so how much of the segment is used.
+ * It depends on nothing but the job and the MCA parameter, so it does.
+ */
+static size_t
+populate_nworkers(
+    size_t nprocs
+) {
+    return pmix_parallel_nworkers(
+        pmix_gds_shmem3_populate_threads, nprocs,
+        PMIX_GDS_SHMEM3_POPULATE_MIN_PROCS
+    );
+}
+
+static int
+populate_entry_compare(
+    const void *a,
+    const void *b
+) {
+    const populate_entry_t *const ea = (const populate_entry_t *)a;
+    const populate_entry_t *const eb = (const populate_entry_t *)b;
+
+    if (ea->rank != eb->rank) {
+        return (ea->rank < eb->rank) ? -1 : 1;
+    }
+    return (ea->order < eb->order) ? -1 : (ea->order > eb->order);
+}
+
+static pmix_status_t
+populate_defer(
+    populate_worker_t *w,
+    size_t entry,
+    size_t index
+) {
+    if (w->ndeferred == w->ndeferred_alloc) {
+        const size_t nalloc = (0 == w->ndeferred_alloc) ? 16 : 2 * w->ndeferred_alloc;
+        populate_deferred_t *const tmp = realloc(w->deferred, nalloc * sizeof(*tmp));
+        if (PMIX_UNLIKELY(NULL == tmp)) {
+            return PMIX_ERR_NOMEM;
+        }
+        w->deferred = tmp;
+        w->ndeferred_alloc = nalloc;
+    }
+    w->deferred[w->ndeferred].entry = entry;
+    w->deferred[w->ndeferred].index = index;
+    ++w->ndeferred;
+    return PMIX_SUCCESS;
+}
+
+/**
+ * A worker's share of the proc arrays. Nothing here allocates from the
+ * segment's own TMA or registers a key - both are shared, and neither
+ * is safe to touch from more than one thread - so whatever would need
+ * to is put off for the calling thread to store once every worker is
+ * done. Values are copied with the worker's sub-arena.
+ */
+static pmix_status_t
+populate_range(
+    void *ctx,
+    size_t worker,
+    size_t first,
+    size_t last
+) {
+    populate_ctx_t *const pc = (populate_ctx_t *)ctx;
+    populate_worker_t *const w = &pc->workers[worker];
+    pmix_keyindex_t *const kidx = pc->job->smdata->keyindex;
+    pmix_rank_t deferring = PMIX_RANK_INVALID;
+
+    for (size_t e = pc->ranks[first]; e < pc->ranks[last]; e++) {
+        const populate_entry_t *const ent = &pc->entries[e];
+        pmix_info_t *const info = (pmix_info_t *)ent->kval->value->data.darray->array;
+        const size_t size = ent->kval->value->data.darray->size;
+
+        for (size_t j = 0; j < size; j++) {
+            if (j == ent->idpos) {
+                continue;
+            }
+            pmix_status_t rc = PMIX_ERR_NOT_FOUND;
+            // Once one of a rank's values is put off, so are all that
+            // follow it: the same key again, later in this array or in
+            // another for the same rank, has to land after it, as it
+            // would have stored serially.
+            if (ent->rank != deferring) {
+                pmix_regattr_input_t *const p = pmix_hash_find_key(
+                    UINT32_MAX, info[j].key, kidx
+                );
+                if (NULL != p) {
+                    rc = pmix_hash_store_reserved(
+                        ent->proc, p->index, &info[j].value, &w->tma
+                    );
+                }
+            }
+            if (PMIX_SUCCESS == rc) {
+                continue;
+            }
+            if (PMIX_ERR_NOT_FOUND != rc && PMIX_ERR_OUT_OF_RESOURCE != rc) {
+                return rc;
+            }
+            rc = populate_defer(w, e, j);
+            if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+                return rc;
+            }
+            deferring = ent->rank;
+        }
+    }
+    return PMIX_SUCCESS;
+}
+
+/**
+ * Stores a job's proc arrays from several threads at once.
+ *
+ * The copying is what takes the time - every value of every rank goes
+ * into the segment while the job's clients wait to attach - and it is
+ * the one part that divides cleanly: each rank's values go into that
+ * rank's storage and nowhere else. So ranks are shared out in contiguous
+ * ranges with pmix_parallel_range(), a rank's arrays always to the same
+ * worker, and each worker
+ * copies into its own sub-arena of the segment. Everything shared - the
+ * hash table, the key index, the segment's own bump pointer - is touched
+ * on the calling thread only: before the workers start (creating each
+ * rank's storage, registering the keys) and after they finish (whatever
+ * they put off). The calling thread takes a range of its own meanwhile.
+ *
+ * Nothing is visible to a client until the caller marks the segment
+ * ready, after this returns, so the workers' stores are published all
+ * at once.
+ */
+static pmix_status_t
+store_proc_data_in_parallel(
+    pmix_gds_shmem3_job_t *job,
+    populate_entry_t *entries,
+    size_t nentries,
+    size_t nworkers
+) {
+    pmix_status_t rc = PMIX_SUCCESS;
+    pmix_hash_table_t *const ht = job->smdata->local_hashtab;
+    pmix_tma_t *const tma = pmix_obj_get_tma(&ht->super);
+    pmix_keyindex_t *const kidx = job->smdata->keyindex;
+    pmix_mutex_t lock;
+    size_t ndeferred = 0;
+
+    qsort(entries, nentries, sizeof(*entries), populate_entry_compare);
+
+    for (size_t e = 0; e < nentries; e++) {
+        entries[e].proc = pmix_hash_reserve_proc(
+            ht, entries[e].rank, entries[e].kval->value->data.darray->size - 1
+        );
+        if (PMIX_UNLIKELY(NULL == entries[e].proc)) {
+            rc = PMIX_ERR_NOMEM;
             PMIX_ERROR_LOG(rc);
             return rc;
         }
     }
+    // A host describes its procs with much the same keys, so registering
+    // the first array's registers nearly all there are. Anything it
+    // missed is found unregistered by a worker and stored afterwards.
+    if (0 < nentries) {
+        const pmix_info_t *const info =
+            (const pmix_info_t *)entries[0].kval->value->data.darray->array;
+        for (size_t j = 0; j < entries[0].kval->value->data.darray->size; j++) {
+            if (j != entries[0].idpos) {
+                (void)pmix_hash_lookup_key(UINT32_MAX, info[j].key, kidx);
+            }
+        }
+    }
+
+    // Where each rank's entries start, now they are sorted by rank.
+    size_t *const ranks = calloc(nentries + 1, sizeof(*ranks));
+    populate_worker_t *const workers = calloc(nworkers, sizeof(*workers));
+    if (PMIX_UNLIKELY(NULL == ranks || NULL == workers)) {
+        free(ranks);
+        free(workers);
+        rc = PMIX_ERR_NOMEM;
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
+    size_t nranks = 0;
+    for (size_t e = 0; e < nentries; e++) {
+        if (0 == e || entries[e].rank != entries[e - 1].rank) {
+            ranks[nranks++] = e;
+        }
+    }
+    ranks[nranks] = nentries;
+
+    PMIX_CONSTRUCT(&lock, pmix_mutex_t);
+    size_t ninit = 0;
+    for (; ninit < nworkers; ninit++) {
+        rc = pmix_gds_shmem3_subarena_init(tma, &lock, &workers[ninit].tma);
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            PMIX_ERROR_LOG(rc);
+            break;
+        }
+    }
+
+    if (PMIX_SUCCESS == rc) {
+        // A worker that cannot be started has its ranks done on this
+        // thread instead: the same requests of the same sub-arena, so
+        // the same size.
+        populate_ctx_t ctx = {
+            .job = job,
+            .entries = entries,
+            .ranks = ranks,
+            .workers = workers
+        };
+        rc = pmix_parallel_range(populate_range, &ctx, nranks, nworkers);
+        if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+            PMIX_ERROR_LOG(rc);
+        }
+    }
+
+    for (size_t w = 0; w < ninit; w++) {
+        // In worker order, and in order within each: see populate_range().
+        for (size_t d = 0; PMIX_SUCCESS == rc && d < workers[w].ndeferred; d++) {
+            const populate_entry_t *const ent = &entries[workers[w].deferred[d].entry];
+            pmix_info_t *const info = (pmix_info_t *)ent->kval->value->data.darray->array;
+            rc = store_proc_value(job, ent->rank, &info[workers[w].deferred[d].index]);
+        }
+        ndeferred += workers[w].ndeferred;
+        pmix_gds_shmem3_subarena_fini(&workers[w].tma);
+        free(workers[w].deferred);
+    }
+    PMIX_DESTRUCT(&lock);
+    free(workers);
+    free(ranks);
+
+    PMIX_GDS_SHMEM3_VOUT(
+        "%s: namespace=%s stored %zu procs across %zu threads, "
+        "%zu values after them", __func__, job->nspace_id,
+        nentries, nworkers, ndeferred
+    );
     return rc;
 }
 
@@ -608,6 +927,25 @@ pmix_gds_shmem3_store_local_job_data_in_shmem3(
     pmix_tma_t *const tma = pmix_obj_get_tma(&local_ht->super);
 
     pmix_kval_t *kvi;
+    // With more than one worker, the proc arrays are collected here and
+    // stored together once the rest is in; see store_proc_data_in_parallel().
+    size_t nprocs = 0, nentries = 0;
+    PMIX_LIST_FOREACH (kvi, job_data, pmix_kval_t) {
+        if (PMIX_CHECK_KEY(kvi, PMIX_PROC_INFO_ARRAY)) {
+            ++nprocs;
+        }
+    }
+    const size_t nworkers = populate_nworkers(nprocs);
+    populate_entry_t *entries = NULL;
+    if (1 < nworkers) {
+        entries = calloc(nprocs, sizeof(*entries));
+        if (PMIX_UNLIKELY(NULL == entries)) {
+            rc = PMIX_ERR_NOMEM;
+            PMIX_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+
     PMIX_LIST_FOREACH (kvi, job_data, pmix_kval_t) {
         PMIX_GDS_SHMEM3_VVOUT("%s: key=%s", __func__, kvi->key);
         // We support the following data array keys.
@@ -628,7 +966,15 @@ pmix_gds_shmem3_store_local_job_data_in_shmem3(
             }
         }
         else if (PMIX_CHECK_KEY(kvi, PMIX_PROC_INFO_ARRAY)) {
-            rc = store_proc_data(job, kvi);
+            if (NULL != entries) {
+                populate_entry_t *const ent = &entries[nentries];
+                rc = proc_array_id(kvi, &ent->rank, &ent->idpos);
+                ent->kval = kvi;
+                ent->order = nentries++;
+            }
+            else {
+                rc = store_proc_data(job, kvi);
+            }
             if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
                 PMIX_ERROR_LOG(rc);
                 break;
@@ -665,6 +1011,10 @@ pmix_gds_shmem3_store_local_job_data_in_shmem3(
             }
         }
     }
+    if (PMIX_SUCCESS == rc && NULL != entries) {
+        rc = store_proc_data_in_parallel(job, entries, nentries, nworkers);
+    }
+    free(entries);
     if (PMIX_SUCCESS == rc) {
         // Segments are ready for use.
         pmix_gds_shmem3_set_status(
@@ -92,13 +92,7 @@ pmix_gds_shmem3_get_job_tracker(
             goto out;
         }
         // See if we already have this nspace in global namespaces.
-        pmix_namespace_t *nsi = NULL, *inspace = NULL;
-        PMIX_LIST_FOREACH (nsi, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (0 == strcmp(nsi->nspace, nspace)) {
-                inspace = nsi;
-                break;
-            }
-        }
+        pmix_namespace_t *inspace = pmix_nspace_lookup(nspace);
         // If not, create one and update global namespace list.
         if (!inspace) {
             inspace = PMIX_NEW(pmix_namespace_t);
@@ -115,7 +109,7 @@ pmix_gds_shmem3_get_job_tracker(
                 rc = PMIX_ERR_NOMEM;
                 goto out;
             }
-            pmix_list_append(&pmix_globals.nspaces, &inspace->super);
+            pmix_nspace_add(inspace, false);
         }
         PMIX_RETAIN(inspace);
         ijob->nspace = inspace;
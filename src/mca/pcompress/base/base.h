@@ -4,7 +4,7 @@
  *                         Corporation.  All rights reserved.
  *
  * Copyright (c) 2019      Intel, Inc.  All rights reserved.
- * Copyright (c) 2021-2022 Nanook Consulting.  All rights reserved.
+ * Copyright (c) 2021-2026 Nanook Consulting.  All rights reserved.
  * $COPYRIGHT$
  *
  * Additional copyrights may follow
@@ -60,6 +60,76 @@ PMIX_EXPORT extern pmix_compress_base_t pmix_compress_base;
  */
 PMIX_EXPORT int pmix_compress_base_select(void);
 
+/*
+ * Framed containers.
+ *
+ * A block compressed whole has to be expanded whole before any of it can
+ * be read, so a receiver of a large one holds it twice over - compressed
+ * and expanded - and can do nothing with it until the last byte is
+ * inflated. A framed container is the same data cut into frames, each
+ * compressed on its own and located through a small index at the front:
+ *
+ *     "PMXF"  version(1)  reserved(3)  nframes(u32)
+ *     per frame: offset(u64) stored(u64) size(u64) flags(u32) reserved(u32)
+ *     the frames, back to back
+ *
+ * All integers are little-endian. "offset" is from the start of the frame
+ * data, "size" is the frame's expanded length and "stored" its length in
+ * the container; a frame the compressor declined is stored as it is, and
+ * its flags say so. Any frame can be expanded without touching another,
+ * so a reader can expand several at once, or one at a time and drop each
+ * when it is done with it.
+ *
+ * The container knows nothing of what the frames hold. Where they are cut
+ * is the writer's business: cutting at the boundaries of whatever it
+ * packed lets the reader use each frame as it comes.
+ */
+typedef struct {
+    /* the frame as it is to be read back */
+    const uint8_t *bytes;
+    size_t size;
+    /* its compressed form, or NULL if it is to be stored as it is */
+    uint8_t *packed;
+    size_t packed_size;
+} pmix_compress_frame_t;
+
+/* Compress one frame, filling in "packed" if the compressor took it.
+ * Touches nothing but the frame, so different frames may be compressed
+ * from different threads at once. The exception is a library with no
+ * compression component: the stub warns the first time it is asked, so a
+ * caller spreading frames across threads should do one itself first. */
+PMIX_EXPORT void pmix_compress_base_frame_compress(pmix_compress_frame_t *frame);
+
+/* Free what pmix_compress_base_frame_compress() allocated. */
+PMIX_EXPORT void pmix_compress_base_frame_release(pmix_compress_frame_t *frame);
+
+/* Lay the frames out as a container in a buffer allocated here. */
+PMIX_EXPORT bool pmix_compress_base_frames_build(const pmix_compress_frame_t *frames,
+                                                 size_t nframes, uint8_t **out,
+                                                 size_t *outlen);
+
+/* A container opened for reading. It points into the caller's bytes,
+ * which must outlive it. */
+typedef struct {
+    const uint8_t *index;
+    const uint8_t *data;
+    size_t nframes;
+    /* the sum of the frames' expanded sizes */
+    size_t size;
+} pmix_compress_frames_t;
+
+/* Check a container and open it for reading. Every offset and size in
+ * the index is screened against the bytes actually given before this
+ * succeeds, so pmix_compress_base_frames_read() need not repeat it. */
+PMIX_EXPORT bool pmix_compress_base_frames_open(pmix_compress_frames_t *frames,
+                                                const uint8_t *in, size_t len);
+
+/* Expand frame "n" into a buffer allocated here. Reads nothing but that
+ * frame, so frames may be read from different threads at once. Fails if
+ * the frame does not expand to the size the index gave for it. */
+PMIX_EXPORT bool pmix_compress_base_frames_read(const pmix_compress_frames_t *frames,
+                                                size_t n, uint8_t **out, size_t *outlen);
+
 /**
  * Globals
  */
@@ -0,0 +1,218 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/* Framed containers - see the description in base.h. Nothing here is
+ * component-specific: a frame is compressed and expanded through
+ * whichever module was selected, exactly as a whole block would be, so a
+ * container is readable wherever a block from the same sender is. */
+
+#include "pmix_config.h"
+
+#include <string.h>
+
+#include "src/mca/pcompress/base/base.h"
+
+#define FRAMES_MAGIC      "PMXF"
+#define FRAMES_VERSION    1
+#define FRAMES_HDR_SIZE   12
+#define FRAMES_ENTRY_SIZE 32
+
+/* the frame's bytes are compressed; otherwise they are stored as they are */
+#define FRAMES_COMPRESSED 0x1u
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        p[i] = (uint8_t) (v >> (8 * i));
+    }
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t) (v >> (8 * i));
+    }
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    uint32_t v = 0;
+    int i;
+
+    for (i = 3; 0 <= i; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t *p)
+{
+    uint64_t v = 0;
+    int i;
+
+    for (i = 7; 0 <= i; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+void pmix_compress_base_frame_compress(pmix_compress_frame_t *frame)
+{
+    if (!pmix_compress.compress(frame->bytes, frame->size,
+                                &frame->packed, &frame->packed_size)) {
+        frame->packed = NULL;
+        frame->packed_size = 0;
+    }
+}
+
+void pmix_compress_base_frame_release(pmix_compress_frame_t *frame)
+{
+    if (NULL != frame->packed) {
+        free(frame->packed);
+        frame->packed = NULL;
+    }
+    frame->packed_size = 0;
+}
+
+bool pmix_compress_base_frames_build(const pmix_compress_frame_t *frames,
+                                     size_t nframes, uint8_t **out, size_t *outlen)
+{
+    size_t n, len, offset = 0;
+    uint8_t *buf, *entry, *data;
+
+    *out = NULL;
+    *outlen = 0;
+    if (0 == nframes || UINT32_MAX < nframes) {
+        return false;
+    }
+    len = FRAMES_HDR_SIZE + nframes * FRAMES_ENTRY_SIZE;
+    for (n = 0; n < nframes; n++) {
+        len += (NULL != frames[n].packed) ? frames[n].packed_size : frames[n].size;
+    }
+    buf = (uint8_t *) malloc(len);
+    if (NULL == buf) {
+        return false;
+    }
+
+    memcpy(buf, FRAMES_MAGIC, 4);
+    buf[4] = FRAMES_VERSION;
+    memset(buf + 5, 0, 3);
+    put_u32(buf + 8, (uint32_t) nframes);
+    data = buf + FRAMES_HDR_SIZE + nframes * FRAMES_ENTRY_SIZE;
+    for (n = 0; n < nframes; n++) {
+        const bool packed = (NULL != frames[n].packed);
+        const size_t stored = packed ? frames[n].packed_size : frames[n].size;
+
+        entry = buf + FRAMES_HDR_SIZE + n * FRAMES_ENTRY_SIZE;
+        put_u64(entry, offset);
+        put_u64(entry + 8, stored);
+        put_u64(entry + 16, frames[n].size);
+        put_u32(entry + 24, packed ? FRAMES_COMPRESSED : 0);
+        put_u32(entry + 28, 0);
+        memcpy(data + offset, packed ? frames[n].packed : frames[n].bytes, stored);
+        offset += stored;
+    }
+    *out = buf;
+    *outlen = len;
+    return true;
+}
+
+bool pmix_compress_base_frames_open(pmix_compress_frames_t *frames,
+                                    const uint8_t *in, size_t len)
+{
+    size_t n, nframes, datalen, expect = 0, total = 0;
+    const uint8_t *entry;
+    uint64_t offset, stored, size;
+    uint32_t flags;
+
+    memset(frames, 0, sizeof(*frames));
+    if (NULL == in || FRAMES_HDR_SIZE > len || 0 != memcmp(in, FRAMES_MAGIC, 4)
+        || FRAMES_VERSION != in[4]) {
+        return false;
+    }
+    nframes = get_u32(in + 8);
+    /* screen the count against what is there before multiplying by it */
+    if (0 == nframes || (len - FRAMES_HDR_SIZE) / FRAMES_ENTRY_SIZE < nframes) {
+        return false;
+    }
+    datalen = len - FRAMES_HDR_SIZE - nframes * FRAMES_ENTRY_SIZE;
+
+    /* The frames must tile the data exactly, in order: each starting
+     * where the last ended and the last ending where the data does. That
+     * rules out overlaps, gaps and anything pointing outside. */
+    for (n = 0; n < nframes; n++) {
+        entry = in + FRAMES_HDR_SIZE + n * FRAMES_ENTRY_SIZE;
+        offset = get_u64(entry);
+        stored = get_u64(entry + 8);
+        size = get_u64(entry + 16);
+        flags = get_u32(entry + 24);
+        if (offset != expect || 0 == stored || 0 == size
+            || stored > datalen - expect || SIZE_MAX - total < size
+            || 0 != (flags & ~FRAMES_COMPRESSED)
+            || (!(flags & FRAMES_COMPRESSED) && stored != size)) {
+            return false;
+        }
+        expect += stored;
+        total += size;
+    }
+    if (expect != datalen) {
+        return false;
+    }
+
+    frames->index = in + FRAMES_HDR_SIZE;
+    frames->data = in + FRAMES_HDR_SIZE + nframes * FRAMES_ENTRY_SIZE;
+    frames->nframes = nframes;
+    frames->size = total;
+    return true;
+}
+
+bool pmix_compress_base_frames_read(const pmix_compress_frames_t *frames,
+                                    size_t n, uint8_t **out, size_t *outlen)
+{
+    const uint8_t *entry;
+    uint64_t offset, stored, size;
+    uint8_t *buf;
+
+    *out = NULL;
+    *outlen = 0;
+    if (n >= frames->nframes) {
+        return false;
+    }
+    entry = frames->index + n * FRAMES_ENTRY_SIZE;
+    offset = get_u64(entry);
+    stored = get_u64(entry + 8);
+    size = get_u64(entry + 16);
+
+    if (get_u32(entry + 24) & FRAMES_COMPRESSED) {
+        if (!pmix_compress.decompress(&buf, outlen, frames->data + offset, stored)) {
+            return false;
+        }
+        /* the index is a claim too - hold the frame to it */
+        if (*outlen != size) {
+            free(buf);
+            *outlen = 0;
+            return false;
+        }
+        *out = buf;
+        return true;
+    }
+    buf = (uint8_t *) malloc(size);
+    if (NULL == buf) {
+        return false;
+    }
+    memcpy(buf, frames->data + offset, size);
+    *out = buf;
+    *outlen = size;
+    return true;
+}
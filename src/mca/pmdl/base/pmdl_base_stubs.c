@@ -80,7 +80,7 @@ pmix_status_t pmix_pmdl_base_harvest_envars(char *nspace, const pmix_info_t info
 {
     pmix_pmdl_base_active_module_t *active;
     pmix_status_t rc;
-    pmix_namespace_t *nptr = NULL, *ns;
+    pmix_namespace_t *nptr = NULL;
     char *params[2] = {"PMIX_MCA_", NULL};
     char **priors = NULL;
     pmix_kval_t *kv;
@@ -117,12 +117,7 @@ pmix_status_t pmix_pmdl_base_harvest_envars(char *nspace, const pmix_info_t info
     if (NULL != nspace && 0 < strlen(nspace)) {
         /* find this nspace - note that it may not have
          * been registered yet */
-        PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (0 == strcmp(ns->nspace, nspace)) {
-                nptr = ns;
-                break;
-            }
-        }
+        nptr = pmix_nspace_lookup(nspace);
         if (NULL == nptr) {
             /* add it */
             nptr = PMIX_NEW(pmix_namespace_t);
@@ -134,7 +129,7 @@ pmix_status_t pmix_pmdl_base_harvest_envars(char *nspace, const pmix_info_t info
                 PMIX_RELEASE(nptr);
                 return PMIX_ERR_NOMEM;
             }
-            pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+            pmix_nspace_add(nptr, false);
         }
     }
 
@@ -38,7 +38,7 @@ pmix_status_t pmix_pnet_base_allocate(char *nspace, pmix_info_t info[], size_t n
 {
     pmix_pnet_base_active_module_t *active;
     pmix_status_t rc;
-    pmix_namespace_t *nptr, *ns;
+    pmix_namespace_t *nptr;
 
     pmix_output_verbose(2, pmix_pnet_base_framework.framework_output, "pnet:allocate called");
 
@@ -56,13 +56,7 @@ pmix_status_t pmix_pnet_base_allocate(char *nspace, pmix_info_t info[], size_t n
     }
 
     /* find this proc's nspace object */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (PMIX_CHECK_NSPACE(ns->nspace, nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(nspace);
     if (NULL == nptr) {
         /* add it */
         nptr = PMIX_NEW(pmix_namespace_t);
@@ -76,7 +70,7 @@ pmix_status_t pmix_pnet_base_allocate(char *nspace, pmix_info_t info[], size_t n
             PMIX_RELEASE(nptr);
             return PMIX_ERR_NOMEM;
         }
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
     }
 
     if (PMIX_PEER_IS_SERVER(pmix_globals.mypeer)) {
@@ -101,7 +95,7 @@ pmix_status_t pmix_pnet_base_setup_local_network(char *nspace, pmix_info_t info[
 {
     pmix_pnet_base_active_module_t *active;
     pmix_status_t rc;
-    pmix_namespace_t *nsp, *nsp2;
+    pmix_namespace_t *nsp;
     pmix_nspace_env_cache_t *ns, *ns2;
 
     pmix_output_verbose(2, pmix_pnet_base_framework.framework_output,
@@ -127,13 +121,7 @@ pmix_status_t pmix_pnet_base_setup_local_network(char *nspace, pmix_info_t info[
     }
     if (NULL == ns) {
         /* find the namespace object for this nspace */
-        nsp = NULL;
-        PMIX_LIST_FOREACH (nsp2, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (PMIX_CHECK_NSPACE(nsp2->nspace, nspace)) {
-                nsp = nsp2;
-                break;
-            }
-        }
+        nsp = pmix_nspace_lookup(nspace);
         if (NULL == nsp) {
             /* add it */
             nsp = PMIX_NEW(pmix_namespace_t);
@@ -145,7 +133,7 @@ pmix_status_t pmix_pnet_base_setup_local_network(char *nspace, pmix_info_t info[
                 PMIX_RELEASE(nsp);
                 return PMIX_ERR_NOMEM;
             }
-            pmix_list_append(&pmix_globals.nspaces, &nsp->super);
+            pmix_nspace_add(nsp, false);
         }
         ns = PMIX_NEW(pmix_nspace_env_cache_t);
         if (NULL == ns) {
@@ -448,7 +436,7 @@ void pmix_pnet_base_deregister_nspace(char *nspace)
 {
     pmix_pnet_base_active_module_t *active;
     pmix_nspace_env_cache_t *ns, *ns2;
-    pmix_namespace_t *nptr, *nsp;
+    pmix_namespace_t *nptr;
 
     pmix_output_verbose(2, pmix_pnet_base_framework.framework_output,
                         "pnet: deregister_nspace called");
@@ -477,13 +465,7 @@ void pmix_pnet_base_deregister_nspace(char *nspace)
     if (NULL != ns) {
         nptr = ns->ns;
     } else {
-        nptr = NULL;
-        PMIX_LIST_FOREACH (nsp, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (PMIX_CHECK_NSPACE(nsp->nspace, nspace)) {
-                nptr = nsp;
-                break;
-            }
-        }
+        nptr = pmix_nspace_lookup(nspace);
     }
     if (NULL == nptr) {
         return;
@@ -188,8 +188,8 @@ void pmix_ptl_base_connection_handler(int sd, short args, void *cbdata)
     size_t cnt, n, nblob = 0;
     size_t len = 0;
     int32_t i32;
-    pmix_namespace_t *nptr, *tmp;
-    pmix_rank_info_t *info = NULL, *iptr;
+    pmix_namespace_t *nptr;
+    pmix_rank_info_t *info = NULL;
     pmix_proc_t proc;
     pmix_info_t ginfo, *iblob = NULL;
     pmix_byte_object_t cred;
@@ -393,13 +393,7 @@ void pmix_ptl_base_connection_handler(int sd, short args, void *cbdata)
     /* it is a client that is connecting, so it should have
      * been registered with us prior to being started.
      * See if we know this nspace */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(tmp->nspace, pnd->proc.nspace)) {
-            nptr = tmp;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(pnd->proc.nspace);
     if (NULL == nptr) {
         /* we don't know this namespace, reject it */
         rc = PMIX_ERR_NOT_FOUND;
@@ -407,13 +401,7 @@ void pmix_ptl_base_connection_handler(int sd, short args, void *cbdata)
     }
 
     /* likewise, we should have this peer in our list */
-    info = NULL;
-    PMIX_LIST_FOREACH (iptr, &nptr->ranks, pmix_rank_info_t) {
-        if (iptr->pname.rank == pnd->proc.rank) {
-            info = iptr;
-            break;
-        }
-    }
+    info = pmix_nspace_find_rank(nptr, pnd->proc.rank);
     if (NULL == info) {
         /* rank unknown, reject it */
         rc = PMIX_ERR_NOT_FOUND;
@@ -720,8 +708,8 @@ static pmix_namespace_t *consolidate_nspace(pmix_pending_connection_t *pnd,
                                             pmix_peer_t *peer,
                                             pmix_namespace_t *nptr)
 {
-    pmix_namespace_t *ns, *existing = NULL;
-    pmix_rank_info_t *rinfo, *match = NULL;
+    pmix_namespace_t *existing = NULL;
+    pmix_rank_info_t *match = NULL;
 
     /* An object with no name cannot be looked up by one, so there is
      * nothing to reconcile against and nothing for the list to do with
@@ -730,7 +718,8 @@ static pmix_namespace_t *consolidate_nspace(pmix_pending_connection_t *pnd,
         return nptr;
     }
 
-    /* Compare names EXACTLY. Do not reach for PMIx_Check_nspace() here:
+    /* Compare names EXACTLY, as the registry lookup does. Do not reach
+     * for PMIx_Check_nspace() here:
      * it reports a match whenever *either* name is absent, which is the
      * right answer for the wildcard matching its callers do and a
      * catastrophic one for us. The server's list legitimately carries
@@ -739,36 +728,28 @@ static pmix_namespace_t *consolidate_nspace(pmix_pending_connection_t *pnd,
      * to something else - after which the job data the server packs for
      * it is somebody else's, and the tool fails to unpack its own
      * identity out of the reply. */
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (ns != nptr && NULL != ns->nspace &&
-            0 == strncmp(nptr->nspace, ns->nspace, PMIX_MAX_NSLEN)) {
-            existing = ns;
-            break;
-        }
+    existing = pmix_nspace_lookup(nptr->nspace);
+    if (existing == nptr) {
+        existing = NULL;
     }
     if (NULL == existing) {
         /* ours is the only one - the reference PMIX_NEW gave us becomes
          * the one the list holds */
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
         return nptr;
     }
 
     /* Someone got there first. Move what we built onto their object and
      * dispose of ours. */
     if (pnd->rinfo_created && NULL != peer->info) {
-        PMIX_LIST_FOREACH (rinfo, &existing->ranks, pmix_rank_info_t) {
-            if (rinfo->pname.rank == peer->info->pname.rank) {
-                match = rinfo;
-                break;
-            }
-        }
-        pmix_list_remove_item(&nptr->ranks, &peer->info->super);
+        match = pmix_nspace_find_rank(existing, peer->info->pname.rank);
+        pmix_nspace_remove_rank(nptr, peer->info);
         if (NULL == match) {
             /* they have no entry for this rank - carry ours across. The
              * reference the rank list holds moves with it, so nothing is
              * released here, and rinfo_created stays true because the
              * entry is still ours to withdraw on failure */
-            pmix_list_append(&existing->ranks, &peer->info->super);
+            pmix_nspace_add_rank(existing, peer->info);
         } else {
             /* they already describe this rank - use their entry and drop
              * ours entirely: the reference its rank list was holding and
@@ -901,7 +882,7 @@ static void process_cbfunc(int sd, short args, void *cbdata)
         info->pname.rank = cd->proc.rank;
         info->uid = pnd->uid;
         info->gid = pnd->gid;
-        pmix_list_append(&nptr->ranks, &info->super);
+        pmix_nspace_add_rank(nptr, info);
         PMIX_RETAIN(info);
         peer->info = info;
         pnd->rinfo_created = true;
@@ -1073,7 +1054,7 @@ error:
              * the reference that list was holding - removing an item
              * does not release it. The peer's own reference is given
              * back when the peer is released below. */
-            pmix_list_remove_item(&peer->nptr->ranks, &peer->info->super);
+            pmix_nspace_remove_rank(peer->nptr, peer->info);
             PMIX_RELEASE(peer->info);
         }
         if (NULL != peer->nptr && pnd->nspace_created) {
@@ -1086,7 +1067,7 @@ error:
              * give it back here. The peer's own reference comes back when
              * the peer is released below. */
             if (nspace_listed) {
-                pmix_list_remove_item(&pmix_globals.nspaces, &peer->nptr->super);
+                pmix_nspace_remove(peer->nptr);
             }
             PMIX_RELEASE(peer->nptr);
         }
@@ -1128,7 +1109,7 @@ static pmix_status_t process_tool_request(pmix_pending_connection_t *pnd,
                                           char *mg, size_t cnt)
 {
     pmix_peer_t *peer, *p2;
-    pmix_namespace_t *nptr, *tmp;
+    pmix_namespace_t *nptr;
     pmix_rank_info_t *info;
     bool found;
     size_t n, sz;
@@ -1159,13 +1140,7 @@ static pmix_status_t process_tool_request(pmix_pending_connection_t *pnd,
 
     /* see if we know this nspace - i.e., was it registered or did
      * another tool within it already connect */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(tmp->nspace, pnd->proc.nspace)) {
-            nptr = tmp;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(pnd->proc.nspace);
 
     /* if this is a tool we launched, then the host may
      * have already registered it as a client - so check
@@ -1195,15 +1170,8 @@ static pmix_status_t process_tool_request(pmix_pending_connection_t *pnd,
             pnd->nspace_created = true;
         }
         /* now look for the rank */
-        info = NULL;
-        found = false;
-        PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-            if (info->pname.rank == pnd->proc.rank) {
-                found = true;
-                break;
-            }
-        }
-        if (found) {
+        info = pmix_nspace_find_rank(nptr, pnd->proc.rank);
+        if (NULL != info) {
             /* check that the uid/gid of the connecting tool
              * matches the expected values */
             if (info->uid != pnd->uid ||
@@ -1220,7 +1188,7 @@ static pmix_status_t process_tool_request(pmix_pending_connection_t *pnd,
             info->pname.rank = pnd->proc.rank;
             info->uid = pnd->uid;
             info->gid = pnd->gid;
-            pmix_list_append(&nptr->ranks, &info->super);
+            pmix_nspace_add_rank(nptr, info);
             pnd->rinfo_created = true;
         }
         PMIX_RETAIN(info);
@@ -1432,7 +1400,7 @@ cleanup:
          * give back the reference that list was holding, since removing
          * an item does not release it. The peer's own reference is given
          * back when the peer is released below. */
-        pmix_list_remove_item(&nptr->ranks, &peer->info->super);
+        pmix_nspace_remove_rank(nptr, peer->info);
         PMIX_RELEASE(peer->info);
     }
     if (pnd->nspace_created) {
@@ -1489,7 +1457,7 @@ static void _check_cached_events(pmix_peer_t *peer)
                     /* if this is the last one, then evict this event
                      * from the cache */
                     if (0 == cd->nleft) {
-                        pmix_hotel_checkout(&pmix_globals.notifications, cd->room);
+                        pmix_notify_event_uncache(cd);
                         found = true; // mark that we should release cd
                     }
                     break;
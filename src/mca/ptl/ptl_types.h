@@ -261,6 +261,11 @@ typedef struct {
     pmix_list_item_t super;
     pmix_event_t ev;
     pmix_ptl_hdr_t hdr;
+    /* The message body. The send holds one reference to it and drops
+     * it when the message is gone, and it only ever reads the bytes the
+     * header was built from - so the same buffer may sit in any number
+     * of send queues at once, as long as nobody packs into it again
+     * once it has been queued. See PMIX_SERVER_QUEUE_SHARED_REPLY. */
     pmix_buffer_t *data;
     bool hdr_sent;
     char *sdptr;
@@ -447,6 +452,21 @@ PMIX_EXPORT extern int pmix_ptl_base_output;
         }                                                                                       \
     } while (0)
 
+/* queue a message that is also being sent to others - same params as
+ * PMIX_SERVER_QUEUE_REPLY, but the caller keeps its own reference to
+ * the buffer rather than handing it over, and may queue it to as many
+ * peers as it likes without copying it. The buffer is read-only from
+ * the first of those calls on: packing into it can move or grow the
+ * storage that a queued send is still writing from. */
+#define PMIX_SERVER_QUEUE_SHARED_REPLY(r, p, t, b)  \
+    do {                                            \
+        PMIX_RETAIN(b);                             \
+        PMIX_SERVER_QUEUE_REPLY(r, p, t, b);        \
+        if (PMIX_SUCCESS != (r)) {                  \
+            PMIX_RELEASE(b);                        \
+        }                                           \
+    } while (0)
+
 #define CLOSE_THE_SOCKET(s)   \
     do {                      \
         if (0 <= (s)) {       \
@@ -179,12 +179,14 @@ void pmix_rte_finalize(void)
     PMIX_LIST_DESTRUCT(&pmix_globals.cached_events);
     /* clear any notifications */
     for (i = 0; i < pmix_globals.max_events; i++) {
-        pmix_hotel_checkout_and_return_occupant(&pmix_globals.notifications, i, (void **) &cd);
+        pmix_hotel_knock(&pmix_globals.notifications, i, (void **) &cd);
         if (NULL != cd) {
+            pmix_notify_event_uncache(cd);
             PMIX_RELEASE(cd);
         }
     }
     PMIX_DESTRUCT(&pmix_globals.notifications);
+    PMIX_DESTRUCT(&pmix_globals.notifications_index);
     /* the stdin read event and SIGCONT handler in src/common/pmix_iof.c
      * are process-wide and outlive every request, so nothing else gives
      * them back. This has to happen while the event base is still up -
@@ -220,6 +222,8 @@ void pmix_rte_finalize(void)
         free(pmix_globals.iof_flags.directory);
         pmix_globals.iof_flags.directory = NULL;
     }
+    /* the index only borrows the entries the list is about to release */
+    PMIX_DESTRUCT(&pmix_globals.nspace_index);
     PMIX_LIST_DESTRUCT(&pmix_globals.nspaces);
     PMIX_LIST_DESTRUCT(&pmix_client_globals.groups);
     PMIX_DESTRUCT(&pmix_globals.keyindex);
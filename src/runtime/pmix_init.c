@@ -110,6 +110,7 @@ PMIX_EXPORT pmix_globals_t pmix_globals = {
     .max_events = INT_MAX,
     .event_eviction_time = 0,
     .notifications = PMIX_HOTEL_STATIC_INIT,
+    .notifications_index = PMIX_HASH_TABLE_STATIC_INIT,
     .pushstdin = false,
     .stdin_targets = PMIX_LIST_STATIC_INIT,
     .tag_output = false,
@@ -135,6 +136,9 @@ static void _notification_eviction_cbfunc(struct pmix_hotel_t *hotel, int room_n
     pmix_notify_caddy_t *cache = (pmix_notify_caddy_t *) occupant;
     PMIX_HIDE_UNUSED_PARAMS(hotel, room_num);
 
+    /* the hotel has already emptied the room - this just files the
+     * eviction with the index */
+    pmix_notify_event_uncache(cache);
     PMIX_RELEASE(cache);
 }
 
@@ -376,9 +380,13 @@ int pmix_rte_init(uint32_t type, pmix_info_t info[], size_t ninfo, pmix_ptl_cbfu
     PMIX_CONSTRUCT(&pmix_globals.cached_events, pmix_list_t);
     /* construct the global notification ring buffer */
     PMIX_CONSTRUCT(&pmix_globals.notifications, pmix_hotel_t);
+    PMIX_CONSTRUCT(&pmix_globals.notifications_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_globals.notifications_index, 64);
     ret = pmix_hotel_init(&pmix_globals.notifications, pmix_globals.max_events, pmix_globals.evbase,
                           pmix_globals.event_eviction_time, _notification_eviction_cbfunc);
     PMIX_CONSTRUCT(&pmix_globals.nspaces, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_globals.nspace_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_globals.nspace_index, 64);
     PMIX_CONSTRUCT(&pmix_globals.keyindex, pmix_keyindex_t);
     // construct client globals structures
     PMIX_CONSTRUCT(&pmix_client_globals.groups, pmix_list_t);
@@ -279,6 +279,115 @@ pmix_status_t pmix_register_params(void)
         PMIX_MCA_BASE_VAR_TYPE_BOOL,
         &pmix_server_globals.fence_delta_modex);
 
+    /* Packing a fence contribution is one buffer per local rank and
+     * nothing shared between them, so it divides across threads without
+     * changing a byte of what is sent. This is only the thread count;
+     * whether the compression step is split up as well is the separate
+     * question below, because that one does change the wire format. */
+    pmix_server_globals.fence_threads = 1;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "fence_threads",
+        "Number of threads used to pack and compress this server's contribution "
+        "to a collecting fence. 1 does it all on the progress thread; 0 uses one "
+        "thread per online processor (default: 1)",
+        PMIX_MCA_BASE_VAR_TYPE_UNSIGNED_INT,
+        &pmix_server_globals.fence_threads);
+
+    /* Default off for the same reason as fence_delta_modex: a
+     * contribution sent as a framed container carries a marker that a
+     * release predating it cannot read, and such a server fails the
+     * collective rather than guess (see pmix_gds_base_store_modex). Only
+     * set it once every node understands the framed form. */
+    pmix_server_globals.fence_compress_chunk = 0;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "fence_compress_chunk",
+        "Send a fence contribution larger than this many bytes as independently "
+        "compressed frames of about this size, so that fence_threads can compress "
+        "them at once and the receiver can expand and store them one batch at a "
+        "time. 0 compresses it whole (default: 0). Requires every node in the job "
+        "to be running a PMIx release that understands framed modex data",
+        PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
+        &pmix_server_globals.fence_compress_chunk);
+
+    /* Unlike the two above this changes nothing on the wire - a cached
+     * reply is the same bytes a fresh one would be - so it is on by
+     * default. The cap is what a server pays to answer a rank that every
+     * remote server asks for with one pack instead of one per request. */
+    pmix_server_globals.dmodex_cache_size = 16 * 1024 * 1024;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "dmodex_cache_size",
+        "Bytes of packed direct-modex replies to keep for local ranks, so that "
+        "repeat requests for a rank's data are answered without repacking it. "
+        "Least recently used replies are dropped first; 0 keeps none "
+        "(default: 16777216)",
+        PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
+        &pmix_server_globals.dmodex_cache_size);
+
+    /* Only consulted when the host declared PMIX_SERVER_DMODEX_BATCH at
+     * init - a host that did not gets one direct_modex call per target,
+     * as it always has. The window is the most a request waits for
+     * company; a batch that fills goes at once. */
+    pmix_server_globals.dmodex_batch_window = 1000;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "dmodex_batch_window",
+        "Microseconds to gather direct-modex requests for procs on the same node "
+        "into one request to the host, when the host supports it. 0 sends each "
+        "request at once (default: 1000)",
+        PMIX_MCA_BASE_VAR_TYPE_UNSIGNED_INT,
+        &pmix_server_globals.dmodex_batch_window);
+
+    pmix_server_globals.dmodex_batch_max = 64;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "dmodex_batch_max",
+        "Number of procs at which a gathered direct-modex request is sent without "
+        "waiting for the rest of its window (default: 64)",
+        PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
+        &pmix_server_globals.dmodex_batch_max);
+
+    /* Rides on the batching above - the peers go up in the same request
+     * as the target that was asked for, so with a host that cannot take a
+     * batch there is no round trip to share and this does nothing. The
+     * hit rate is reported at finalize under pmix_server_get_verbose. */
+    pmix_server_globals.dmodex_prefetch = false;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "dmodex_prefetch",
+        "When a remote proc's data is asked for, fetch the data of every proc on its "
+        "node in the same request to the host, if the host takes gathered requests "
+        "(default: false)",
+        PMIX_MCA_BASE_VAR_TYPE_BOOL,
+        &pmix_server_globals.dmodex_prefetch);
+
+    /* Off by default: a cached answer can be up to a TTL out of date
+     * about anything the host does not tell us of by event, and only
+     * the site knows how stale its tools can stand. Job start and end,
+     * proc aborts and nspace registration all drop the cache. */
+    pmix_server_globals.query_cache_ttl = 0;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "query_cache_ttl",
+        "Milliseconds for which the host's answer to a set of queries is reused "
+        "for the same set asked again, instead of asking the host. 0 always asks "
+        "(default: 0)",
+        PMIX_MCA_BASE_VAR_TYPE_UNSIGNED_INT,
+        &pmix_server_globals.query_cache_ttl);
+
+    pmix_server_globals.query_cache_key_ttls = NULL;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "query_cache_key_ttls",
+        "Comma-separated list of key=msec overriding query_cache_ttl for a query key, "
+        "named by its string (pmix.qry.ns) or its attribute name "
+        "(PMIX_QUERY_NAMESPACES). A set of queries is kept for the shortest TTL of "
+        "the keys in it; 0 never caches a set containing the key (default: none)",
+        PMIX_MCA_BASE_VAR_TYPE_STRING,
+        &pmix_server_globals.query_cache_key_ttls);
+
+    pmix_server_globals.query_cache_max = 256;
+    (void) pmix_mca_base_var_register(
+        "pmix", "pmix", "server", "query_cache_max",
+        "Number of host query answers to keep; the oldest is dropped to make room "
+        "(default: 256)",
+        PMIX_MCA_BASE_VAR_TYPE_SIZE_T,
+        &pmix_server_globals.query_cache_max);
+
     /* check for maximum number of pending output messages */
     pmix_globals.output_limit = (size_t) INT_MAX;
     (void) pmix_mca_base_var_register("pmix", "iof", NULL, "output_limit",
@@ -88,6 +88,20 @@ pmix_server_globals_t pmix_server_globals = {
     .collectives = PMIX_LIST_STATIC_INIT,
     .remote_pnd = PMIX_LIST_STATIC_INIT,
     .local_reqs = PMIX_LIST_STATIC_INIT,
+    .dmodex_cache = PMIX_LIST_STATIC_INIT,
+    .dmodex_cache_bytes = 0,
+    .dmodex_cache_size = 16 * 1024 * 1024,
+    .dmodex_batch = false,
+    .dmodex_batches = PMIX_LIST_STATIC_INIT,
+    .dmodex_batch_window = 1000,
+    .dmodex_batch_max = 64,
+    .dmodex_prefetch = false,
+    .dmodex_prefetched = 0,
+    .dmodex_prefetch_hits = 0,
+    .query_cache = PMIX_LIST_STATIC_INIT,
+    .query_cache_ttl = 0,
+    .query_cache_key_ttls = NULL,
+    .query_cache_max = 256,
     .gdata = PMIX_LIST_STATIC_INIT,
     .genvars = NULL,
     .events = PMIX_LIST_STATIC_INIT,
@@ -100,6 +114,8 @@ pmix_server_globals_t pmix_server_globals = {
     .system_tmpdir = NULL,
     .fence_localonly_opt = false,
     .fence_delta_modex = false,
+    .fence_threads = 1,
+    .fence_compress_chunk = 0,
     .get_output = -1,
     .get_verbose = 0,
     .connect_output = -1,
@@ -316,14 +332,14 @@ static pmix_status_t register_singleton(char *name)
         free(tmp);
         return PMIX_ERR_NOMEM;
     }
-    pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+    pmix_nspace_add(nptr, false);
     rinfo->pname.nspace = strdup(tmp);
     rinfo->pname.rank = rank;
     rinfo->realuid = getuid();
     rinfo->uid = geteuid();
     rinfo->realgid = getgid();
     rinfo->gid = getegid();
-    pmix_list_append(&nptr->ranks, &rinfo->super);
+    pmix_nspace_add_rank(nptr, rinfo);
     nptr->all_registered = true;
     free(tmp);
 
@@ -340,13 +356,31 @@ pmix_status_t pmix_server_initialize(void)
     pmix_pointer_array_init(&pmix_server_globals.peer_cache, 1, INT_MAX, 1);
     PMIX_CONSTRUCT(&pmix_server_globals.nspaces, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_server_globals.collectives, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.collectives_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.collectives_index, 64);
     PMIX_CONSTRUCT(&pmix_server_globals.remote_pnd, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_server_globals.local_reqs, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.local_reqs_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.local_reqs_index, 64);
+    PMIX_CONSTRUCT(&pmix_server_globals.dmodex_cache, pmix_list_t);
+    pmix_server_globals.dmodex_cache_bytes = 0;
+    PMIX_CONSTRUCT(&pmix_server_globals.dmodex_batches, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.dmodex_batches_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.dmodex_batches_index, 64);
+    PMIX_CONSTRUCT(&pmix_server_globals.query_cache, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.query_cache_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.query_cache_index, 64);
     PMIX_CONSTRUCT(&pmix_server_globals.gdata, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_server_globals.events, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.events_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.events_index, 64);
+    pmix_server_globals.default_events = NULL;
+    pmix_server_globals.events_stamp = 0;
     PMIX_CONSTRUCT(&pmix_server_globals.iof, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_server_globals.iof_residuals, pmix_list_t);
     PMIX_CONSTRUCT(&pmix_server_globals.psets, pmix_list_t);
+    PMIX_CONSTRUCT(&pmix_server_globals.psets_index, pmix_hash_table_t);
+    pmix_hash_table_init(&pmix_server_globals.psets_index, 64);
     PMIX_CONSTRUCT(&pmix_server_globals.grp_collectives, pmix_list_t);
 
     pmix_output_verbose(2, pmix_server_globals.base_output, "pmix:server init called");
@@ -550,6 +584,9 @@ PMIX_EXPORT pmix_status_t PMIx_server_init(pmix_server_module_t *module,
             } else if (PMIX_CHECK_KEY(&info[n], PMIX_SERVER_SHARE_TOPOLOGY)) {
                 share_topo = true;
 
+            } else if (PMIX_CHECK_KEY(&info[n], PMIX_SERVER_DMODEX_BATCH)) {
+                pmix_server_globals.dmodex_batch = PMIX_INFO_TRUE(&info[n]);
+
             } else if (PMIX_CHECK_KEY(&info[n], PMIX_IOF_LOCAL_OUTPUT)) {
                 outputio = PMIX_INFO_TRUE(&info[n]);
 
@@ -743,11 +780,14 @@ PMIX_EXPORT pmix_status_t PMIx_server_init(pmix_server_module_t *module,
     }
     if (NULL == pmix_globals.mypeer->nptr) {
         pmix_globals.mypeer->nptr = PMIX_NEW(pmix_namespace_t);
+        /* name it before it goes on the list so the registry can index it */
+        pmix_globals.mypeer->nptr->nspace = strdup(pmix_globals.myid.nspace);
         /* ensure our own nspace is first on the list */
         PMIX_RETAIN(pmix_globals.mypeer->nptr);
-        pmix_list_prepend(&pmix_globals.nspaces, &pmix_globals.mypeer->nptr->super);
+        pmix_nspace_add(pmix_globals.mypeer->nptr, true);
+    } else {
+        pmix_globals.mypeer->nptr->nspace = strdup(pmix_globals.myid.nspace);
     }
-    pmix_globals.mypeer->nptr->nspace = strdup(pmix_globals.myid.nspace);
     rinfo->pname.nspace = strdup(pmix_globals.mypeer->nptr->nspace);
     rinfo->pname.rank = pmix_globals.myid.rank;
     rinfo->realuid = pmix_globals.realuid;
@@ -1128,10 +1168,35 @@ PMIX_EXPORT pmix_status_t PMIx_server_finalize(void)
     PMIX_DESTRUCT(&pmix_server_globals.peer_cache);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.nspaces);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.collectives);
+    PMIX_DESTRUCT(&pmix_server_globals.collectives_index);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.remote_pnd);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.local_reqs);
+    PMIX_DESTRUCT(&pmix_server_globals.local_reqs_index);
+    /* the rank_infos outlive this list, so unhook them from it */
+    pmix_server_dmodex_forget_all();
+    PMIX_DESTRUCT(&pmix_server_globals.dmodex_cache);
+    PMIX_LIST_DESTRUCT(&pmix_server_globals.dmodex_batches);
+    PMIX_DESTRUCT(&pmix_server_globals.dmodex_batches_index);
+    pmix_server_query_cache_finalize();
+    PMIX_DESTRUCT(&pmix_server_globals.query_cache);
+    PMIX_DESTRUCT(&pmix_server_globals.query_cache_index);
+    pmix_server_globals.dmodex_batch = false;
+    /* what the prefetch bought, for whoever is tuning it */
+    if (0 < pmix_server_globals.dmodex_prefetched) {
+        pmix_output_verbose(1, pmix_server_globals.get_output,
+                            "%s dmodex prefetch: %lu targets fetched ahead, %lu later asked for (%.1f%%)",
+                            PMIX_NAME_PRINT(&pmix_globals.myid),
+                            (unsigned long) pmix_server_globals.dmodex_prefetched,
+                            (unsigned long) pmix_server_globals.dmodex_prefetch_hits,
+                            100.0 * (double) pmix_server_globals.dmodex_prefetch_hits
+                                / (double) pmix_server_globals.dmodex_prefetched);
+    }
+    pmix_server_globals.dmodex_prefetched = 0;
+    pmix_server_globals.dmodex_prefetch_hits = 0;
     PMIX_LIST_DESTRUCT(&pmix_server_globals.gdata);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.events);
+    PMIX_DESTRUCT(&pmix_server_globals.events_index);
+    pmix_server_globals.default_events = NULL;
     // the list will be destructed in rte_finalize, but do the
     // epilog here
     PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
@@ -1142,7 +1207,9 @@ PMIX_EXPORT pmix_status_t PMIx_server_finalize(void)
     }
     PMIX_LIST_DESTRUCT(&pmix_server_globals.iof);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.iof_residuals);
+    pmix_server_purge_psets();
     PMIX_LIST_DESTRUCT(&pmix_server_globals.psets);
+    PMIX_DESTRUCT(&pmix_server_globals.psets_index);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.grp_collectives);
 
     /* NULL each of these as it goes: they are file-scope statics that
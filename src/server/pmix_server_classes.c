@@ -96,6 +96,9 @@ static void tcon(pmix_server_trkr_t *t)
     t->info_cbfunc = NULL;
     t->hybrid = false;
     t->cbdata = NULL;
+    t->indexed = false;
+    t->index_key = 0;
+    t->index_next = NULL;
 }
 static void tdes(pmix_server_trkr_t *t)
 {
@@ -249,6 +252,42 @@ PMIX_CLASS_INSTANCE(pmix_dmdx_remote_t,
                     pmix_list_item_t,
                     dmcon, dmdes);
 
+static void dmrcon(pmix_dmodex_reply_t *p)
+{
+    p->info = NULL;
+    p->gen = 0;
+    p->data = NULL;
+    p->size = 0;
+}
+static void dmrdes(pmix_dmodex_reply_t *p)
+{
+    if (NULL != p->info) {
+        PMIX_RELEASE(p->info);
+    }
+    if (NULL != p->data) {
+        free(p->data);
+    }
+}
+PMIX_CLASS_INSTANCE(pmix_dmodex_reply_t, pmix_list_item_t, dmrcon, dmrdes);
+
+static void qrcon(pmix_query_reply_t *p)
+{
+    p->key = NULL;
+    p->info = NULL;
+    p->ninfo = 0;
+    p->expires = 0;
+}
+static void qrdes(pmix_query_reply_t *p)
+{
+    if (NULL != p->key) {
+        free(p->key);
+    }
+    if (NULL != p->info) {
+        PMIX_INFO_FREE(p->info, p->ninfo);
+    }
+}
+PMIX_CLASS_INSTANCE(pmix_query_reply_t, pmix_list_item_t, qrcon, qrdes);
+
 static void dmrqcon(pmix_dmdx_request_t *p)
 {
     memset(&p->ev, 0, sizeof(pmix_event_t));
@@ -288,6 +327,10 @@ static void lmcon(pmix_dmdx_local_t *p)
     PMIX_CONSTRUCT(&p->loc_reqs, pmix_list_t);
     p->info = NULL;
     p->ninfo = 0;
+    p->prefetch = false;
+    p->indexed = false;
+    p->index_key = 0;
+    p->index_next = NULL;
 }
 static void lmdes(pmix_dmdx_local_t *p)
 {
@@ -354,6 +397,70 @@ PMIX_CLASS_INSTANCE(pmix_iof_cache_t,
                     pmix_list_item_t,
                     iocon, iodes);
 
+static void nsmcon(pmix_grp_nsmbrs_t *p)
+{
+    memset(p->nspace, 0, sizeof(p->nspace));
+    PMIX_CONSTRUCT(&p->ranks, pmix_bitmap_t);
+    pmix_bitmap_set_max_size(&p->ranks, PMIX_GRP_RANK_BITS);
+    PMIX_CONSTRUCT(&p->others, pmix_list_t);
+    p->wildcard = false;
+    p->first = 0;
+}
+static void nsmdes(pmix_grp_nsmbrs_t *p)
+{
+    PMIX_DESTRUCT(&p->ranks);
+    PMIX_LIST_DESTRUCT(&p->others);
+}
+PMIX_CLASS_INSTANCE(pmix_grp_nsmbrs_t,
+                    pmix_list_item_t,
+                    nsmcon, nsmdes);
+
+static void mscon(pmix_grp_mbrset_t *p)
+{
+    PMIX_CONSTRUCT(&p->nspaces, pmix_list_t);
+    PMIX_CONSTRUCT(&p->index, pmix_hash_table_t);
+    pmix_hash_table_init(&p->index, 8);
+}
+static void msdes(pmix_grp_mbrset_t *p)
+{
+    PMIX_DESTRUCT(&p->index);
+    PMIX_LIST_DESTRUCT(&p->nspaces);
+}
+PMIX_CLASS_INSTANCE(pmix_grp_mbrset_t,
+                    pmix_object_t,
+                    mscon, msdes);
+
+static void psmcon(pmix_pset_member_t *p)
+{
+    p->pset = NULL;
+    p->nsidx = NULL;
+    p->wildcard = false;
+    p->ranges = NULL;
+    p->nranges = 0;
+}
+static void psmdes(pmix_pset_member_t *p)
+{
+    if (NULL != p->ranges) {
+        free(p->ranges);
+    }
+}
+PMIX_CLASS_INSTANCE(pmix_pset_member_t,
+                    pmix_list_item_t,
+                    psmcon, psmdes);
+
+static void psncon(pmix_pset_nspace_t *p)
+{
+    memset(p->nspace, 0, sizeof(p->nspace));
+    PMIX_CONSTRUCT(&p->members, pmix_list_t);
+}
+static void psndes(pmix_pset_nspace_t *p)
+{
+    PMIX_LIST_DESTRUCT(&p->members);
+}
+PMIX_CLASS_INSTANCE(pmix_pset_nspace_t,
+                    pmix_object_t,
+                    psncon, psndes);
+
 static void pscon(pmix_pset_t *p)
 {
     p->name = NULL;
@@ -362,10 +469,17 @@ static void pscon(pmix_pset_t *p)
 }
 static void psdes(pmix_pset_t *p)
 {
+    size_t n;
+
     if (NULL != p->name) {
         free(p->name);
     }
     if (NULL != p->members) {
+        for (n = 0; n < p->nmembers; n++) {
+            if (NULL != p->members[n]) {
+                PMIX_RELEASE(p->members[n]);
+            }
+        }
         free(p->members);
     }
 }
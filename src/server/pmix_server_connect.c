@@ -101,7 +101,7 @@ static void collective_timeout(int sd, short args, void *cbdata)
      * Being on that list is not a reference; releasing while still linked
      * leaves a dangling entry that the next sweep walks into. */
     trk->event_active = false;
-    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_untrack_collective(trk);
     PMIX_RELEASE(trk);
 }
 
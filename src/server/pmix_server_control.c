@@ -106,6 +106,311 @@ pmix_status_t pmix_server_query(pmix_peer_t *peer, pmix_buffer_t *buf,
     return PMIX_SUCCESS;
 }
 
+/* Host query answers, kept for the next identical question.
+ *
+ * Monitoring tools and applications poll the host through us for the
+ * same few things - the namespaces, a job's status, a proc table - at
+ * rates the host's answer does not change at, and each poll was a
+ * fresh upcall. When query_cache_ttl (or a per-key override) allows it,
+ * the host's successful answer to a set of queries is kept for that
+ * long, and the same set asked again in the meantime is answered from
+ * here.
+ *
+ * "The same set" is decided on a normalized form: each query's keys
+ * sorted, its qualifiers rendered and sorted, and the queries sorted,
+ * so neither the order a requestor listed things in nor which
+ * requestor is asking changes the key - the host is always asked on
+ * our own behalf, so neither changes its answer. PMIX_QUERY_REFRESH_CACHE
+ * is left out of the key: a query carrying it skips the lookup and
+ * replaces whatever is cached with the fresh answer.
+ *
+ * The events that change the commonly polled answers drop the whole
+ * cache: nspace registration and deregistration, a job starting or
+ * ending, and a proc ending - by abort or otherwise. Anything else the
+ * host changes without telling us is visible within a TTL. */
+static char **key_ttl_names = NULL;       // parsed query_cache_key_ttls
+static unsigned int *key_ttl_msecs = NULL;
+static bool key_ttls_parsed = false;
+
+static uint64_t now_msec(void)
+{
+    /* monotonic, so a step in the wall clock can neither keep an
+     * answer alive forever nor expire the whole cache at once */
+    struct timespec tp;
+    (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+    return (uint64_t) tp.tv_sec * 1000 + (uint64_t) tp.tv_nsec / 1000000;
+}
+
+static void parse_key_ttls(void)
+{
+    char **entries, *eq, *end;
+    const char *name;
+    unsigned long msec;
+    size_t n, k;
+
+    key_ttls_parsed = true;
+    if (NULL == pmix_server_globals.query_cache_key_ttls) {
+        return;
+    }
+    entries = PMIx_Argv_split(pmix_server_globals.query_cache_key_ttls, ',');
+    if (NULL == entries) {
+        return;
+    }
+    key_ttl_msecs = (unsigned int *) calloc(PMIx_Argv_count(entries), sizeof(unsigned int));
+    if (NULL == key_ttl_msecs) {
+        PMIx_Argv_free(entries);
+        return;
+    }
+    for (n = 0, k = 0; NULL != entries[n]; n++) {
+        eq = strchr(entries[n], '=');
+        if (NULL == eq || eq == entries[n]) {
+            pmix_output(0, "pmix:server ignoring malformed query_cache_key_ttls entry \"%s\"",
+                        entries[n]);
+            continue;
+        }
+        *eq = '\0';
+        msec = strtoul(eq + 1, &end, 10);
+        if (end == eq + 1 || '\0' != *end || UINT_MAX < msec) {
+            pmix_output(0, "pmix:server ignoring malformed query_cache_key_ttls entry \"%s=%s\"",
+                        entries[n], eq + 1);
+            continue;
+        }
+        /* takes either the attribute name or its string - a string
+         * comes back as it went in */
+        name = PMIx_Get_attribute_string(entries[n]);
+        PMIx_Argv_append_nosize(&key_ttl_names, name);
+        key_ttl_msecs[k++] = (unsigned int) msec;
+    }
+    PMIx_Argv_free(entries);
+}
+
+static unsigned int key_ttl(const char *key)
+{
+    size_t n;
+
+    if (!key_ttls_parsed) {
+        parse_key_ttls();
+    }
+    for (n = 0; NULL != key_ttl_names && NULL != key_ttl_names[n]; n++) {
+        if (0 == strcmp(key_ttl_names[n], key)) {
+            return key_ttl_msecs[n];
+        }
+    }
+    return pmix_server_globals.query_cache_ttl;
+}
+
+static int strptr_order(const void *a, const void *b)
+{
+    return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/* sort an argv array in place and join it */
+static char *sorted_join(char **argv, int sep)
+{
+    if (NULL == argv) {
+        return strdup("");
+    }
+    qsort(argv, PMIx_Argv_count(argv), sizeof(char *), strptr_order);
+    return PMIx_Argv_join(argv, sep);
+}
+
+char *pmix_server_query_cache_key(pmix_query_t *queries, size_t nqueries,
+                                  unsigned int *ttl, bool *refresh)
+{
+    char **parts = NULL, **items, *keys, *quals, *part, *key = NULL;
+    unsigned int t;
+    size_t n, p;
+    int rc;
+
+    *ttl = UINT_MAX;
+    *refresh = false;
+    if (0 == pmix_server_globals.query_cache_max) {
+        return NULL;
+    }
+
+    for (n = 0; n < nqueries; n++) {
+        items = NULL;
+        for (p = 0; NULL != queries[n].keys && NULL != queries[n].keys[p]; p++) {
+            t = key_ttl(queries[n].keys[p]);
+            if (0 == t) {
+                PMIx_Argv_free(items);
+                goto nocache;
+            }
+            if (t < *ttl) {
+                *ttl = t;
+            }
+            PMIx_Argv_append_nosize(&items, queries[n].keys[p]);
+        }
+        keys = sorted_join(items, ',');
+        PMIx_Argv_free(items);
+
+        items = NULL;
+        for (p = 0; p < queries[n].nqual; p++) {
+            if (PMIX_CHECK_KEY(&queries[n].qualifiers[p], PMIX_QUERY_REFRESH_CACHE)) {
+                if (PMIX_INFO_TRUE(&queries[n].qualifiers[p])) {
+                    *refresh = true;
+                }
+                continue;
+            }
+            part = PMIx_Info_string(&queries[n].qualifiers[p]);
+            if (NULL != part) {
+                PMIx_Argv_append_nosize(&items, part);
+                free(part);
+            }
+        }
+        quals = sorted_join(items, ';');
+        PMIx_Argv_free(items);
+
+        part = NULL;
+        if (NULL != keys && NULL != quals) {
+            rc = asprintf(&part, "%s|%s", keys, quals);
+            if (0 > rc) {
+                part = NULL;
+            }
+        }
+        free(keys);
+        free(quals);
+        if (NULL == part) {
+            goto nocache;
+        }
+        PMIx_Argv_append_nosize(&parts, part);
+        free(part);
+    }
+    if (NULL != parts && UINT_MAX != *ttl) {
+        key = sorted_join(parts, '\n');
+    }
+
+nocache:
+    PMIx_Argv_free(parts);
+    return key;
+}
+
+static void reply_drop(pmix_query_reply_t *qr)
+{
+    pmix_hash_table_remove_value_ptr(&pmix_server_globals.query_cache_index, qr->key,
+                                     strlen(qr->key));
+    pmix_list_remove_item(&pmix_server_globals.query_cache, &qr->super);
+    PMIX_RELEASE(qr);
+}
+
+pmix_query_reply_t *pmix_server_query_cache_fetch(const char *key)
+{
+    pmix_query_reply_t *qr;
+
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_ptr(&pmix_server_globals.query_cache_index,
+                                                      key, strlen(key), (void **) &qr)) {
+        return NULL;
+    }
+    if (qr->expires <= now_msec()) {
+        reply_drop(qr);
+        return NULL;
+    }
+    return qr;
+}
+
+void pmix_server_query_cache_store(char *key, unsigned int ttl,
+                                   const pmix_info_t *info, size_t ninfo)
+{
+    pmix_query_reply_t *qr, *next;
+    uint64_t now = now_msec();
+    size_t n;
+
+    /* anything already under this key is what is being refreshed, and
+     * anything past its time is only taking up room */
+    PMIX_LIST_FOREACH_SAFE (qr, next, &pmix_server_globals.query_cache, pmix_query_reply_t) {
+        if (qr->expires <= now || 0 == strcmp(qr->key, key)) {
+            reply_drop(qr);
+        }
+    }
+    if (0 == pmix_server_globals.query_cache_max) {
+        free(key);
+        return;
+    }
+    while (pmix_server_globals.query_cache_max <= pmix_list_get_size(&pmix_server_globals.query_cache)) {
+        reply_drop((pmix_query_reply_t *) pmix_list_get_first(&pmix_server_globals.query_cache));
+    }
+
+    qr = PMIX_NEW(pmix_query_reply_t);
+    if (NULL == qr) {
+        free(key);
+        return;
+    }
+    qr->key = key;
+    if (0 < ninfo) {
+        PMIX_INFO_CREATE(qr->info, ninfo);
+        if (NULL == qr->info) {
+            PMIX_RELEASE(qr);
+            return;
+        }
+        qr->ninfo = ninfo;
+        for (n = 0; n < ninfo; n++) {
+            if (PMIX_SUCCESS != PMIx_Info_xfer(&qr->info[n], &info[n])) {
+                PMIX_RELEASE(qr);
+                return;
+            }
+        }
+    }
+    qr->expires = now + ttl;
+    if (PMIX_SUCCESS != pmix_hash_table_set_value_ptr(&pmix_server_globals.query_cache_index,
+                                                      qr->key, strlen(qr->key), qr)) {
+        PMIX_RELEASE(qr);
+        return;
+    }
+    pmix_list_append(&pmix_server_globals.query_cache, &qr->super);
+}
+
+void pmix_server_query_cache_forget_all(void)
+{
+    pmix_query_reply_t *qr, *next;
+
+    PMIX_LIST_FOREACH_SAFE (qr, next, &pmix_server_globals.query_cache, pmix_query_reply_t) {
+        reply_drop(qr);
+    }
+}
+
+void pmix_server_query_cache_finalize(void)
+{
+    pmix_server_query_cache_forget_all();
+    PMIx_Argv_free(key_ttl_names);
+    key_ttl_names = NULL;
+    if (NULL != key_ttl_msecs) {
+        free(key_ttl_msecs);
+        key_ttl_msecs = NULL;
+    }
+    key_ttls_parsed = false;
+}
+
+void pmix_server_query_cache_event(pmix_status_t status)
+{
+    switch (status) {
+        /* a job coming or going */
+        case PMIX_EVENT_JOB_START:
+        case PMIX_EVENT_JOB_END:
+        case PMIX_ERR_JOB_CANCELED:
+        case PMIX_ERR_JOB_FAILED_TO_LAUNCH:
+        case PMIX_ERR_JOB_ABORTED:
+        case PMIX_ERR_JOB_KILLED_BY_CMD:
+        case PMIX_ERR_JOB_ABORTED_BY_SIG:
+        case PMIX_ERR_JOB_TERM_WO_SYNC:
+        case PMIX_ERR_JOB_SENSOR_BOUND_EXCEEDED:
+        case PMIX_ERR_JOB_NON_ZERO_TERM:
+        case PMIX_ERR_JOB_ABORTED_BY_SYS_EVENT:
+        /* a proc ending */
+        case PMIX_ERR_PROC_REQUESTED_ABORT:
+        case PMIX_ERR_PROC_TERM_WO_SYNC:
+        case PMIX_EVENT_PROC_TERMINATED:
+        case PMIX_ERR_PROC_KILLED_BY_CMD:
+        case PMIX_ERR_PROC_FAILED_TO_START:
+        case PMIX_ERR_PROC_ABORTED_BY_SIG:
+        case PMIX_ERR_PROC_SENSOR_BOUND_EXCEEDED:
+        case PMIX_ERR_EXIT_NONZERO_TERM:
+            pmix_server_query_cache_forget_all();
+            break;
+        default:
+            break;
+    }
+}
+
 static void localcbfn(pmix_status_t status, void *cbdata)
 {
     pmix_shift_caddy_t *cb = (pmix_shift_caddy_t *) cbdata;
@@ -356,7 +661,7 @@ pmix_status_t pmix_server_job_ctrl(pmix_peer_t *peer, pmix_buffer_t *buf,
     int32_t cnt, m;
     pmix_status_t rc;
     pmix_query_caddy_t *cd;
-    pmix_namespace_t *nptr, *tmp;
+    pmix_namespace_t *nptr;
     pmix_peer_t *pr;
     pmix_proc_t proc;
     size_t n;
@@ -417,13 +722,7 @@ pmix_status_t pmix_server_job_ctrl(pmix_peer_t *peer, pmix_buffer_t *buf,
     } else {
         for (n = 0; n < cd->ntargets; n++) {
             /* find the nspace of this proc */
-            nptr = NULL;
-            PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-                if (0 == strcmp(tmp->nspace, cd->targets[n].nspace)) {
-                    nptr = tmp;
-                    break;
-                }
-            }
+            nptr = pmix_nspace_lookup(cd->targets[n].nspace);
             if (NULL == nptr) {
                 nptr = PMIX_NEW(pmix_namespace_t);
                 if (NULL == nptr) {
@@ -431,7 +730,7 @@ pmix_status_t pmix_server_job_ctrl(pmix_peer_t *peer, pmix_buffer_t *buf,
                     goto exit;
                 }
                 nptr->nspace = strdup(cd->targets[n].nspace);
-                pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+                pmix_nspace_add(nptr, false);
             }
             /* if the rank is wildcard, then we use the epilog for the nspace */
             if (PMIX_RANK_WILDCARD == cd->targets[n].rank) {
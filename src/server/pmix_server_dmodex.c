@@ -52,14 +52,135 @@
  *  of our local clients                                                                           *
  ***************************************************************************************************/
 
+/* Packed replies, kept for the next request.
+ *
+ * A job that connects lazily has every remote server ask for the same
+ * local rank, and each of those requests used to fetch the rank's
+ * remote-scope data from the GDS - a copy of every kval - and pack it
+ * into a new buffer, all to produce the same bytes as the last one. The
+ * bytes only change when the rank commits, so keep them until it does:
+ * pmix_server_commit bumps the rank's modex_gen and drops its entry,
+ * and an entry is only ever served at the generation it was packed at.
+ * Deletions arrive as commits too, so they are covered the same way.
+ *
+ * The cache is bounded by dmodex_cache_size, in bytes of packed data,
+ * and evicts the least recently served entry first. A reply larger than
+ * the whole cap is still sent - it just is not kept.
+ *
+ * The bytes are kept as the requesting server unpacks them - a plain
+ * stream of kvals - rather than compressed: there is no marker in that
+ * stream a receiver could tell a compressed reply by. */
+static void reply_drop(pmix_dmodex_reply_t *reply)
+{
+    pmix_list_remove_item(&pmix_server_globals.dmodex_cache, &reply->super);
+    pmix_server_globals.dmodex_cache_bytes -= reply->size;
+    if (reply->info->dmodex_reply == reply) {
+        reply->info->dmodex_reply = NULL;
+    }
+    PMIX_RELEASE(reply);
+}
+
+void pmix_server_dmodex_forget(pmix_rank_info_t *info)
+{
+    if (NULL != info->dmodex_reply) {
+        reply_drop(info->dmodex_reply);
+    }
+}
+
+void pmix_server_dmodex_forget_all(void)
+{
+    pmix_dmodex_reply_t *reply, *next;
+
+    PMIX_LIST_FOREACH_SAFE (reply, next, &pmix_server_globals.dmodex_cache,
+                            pmix_dmodex_reply_t) {
+        reply_drop(reply);
+    }
+}
+
+pmix_status_t pmix_server_dmodex_reply(pmix_rank_info_t *info,
+                                       pmix_dmodex_reply_t **reply)
+{
+    pmix_dmodex_reply_t *rp = info->dmodex_reply;
+    pmix_buffer_t pbkt;
+    pmix_proc_t proc;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    pmix_cb_t cb;
+
+    *reply = NULL;
+    if (NULL != rp) {
+        if (rp->gen == info->modex_gen) {
+            /* most recently served goes to the back */
+            pmix_list_remove_item(&pmix_server_globals.dmodex_cache, &rp->super);
+            pmix_list_append(&pmix_server_globals.dmodex_cache, &rp->super);
+            PMIX_RETAIN(rp);
+            *reply = rp;
+            return PMIX_SUCCESS;
+        }
+        /* commits always drop the entry, so this is only belt and braces */
+        reply_drop(rp);
+    }
+
+    /* collect the remote/global data from this proc */
+    PMIX_LOAD_PROCID(&proc, info->pname.nspace, info->pname.rank);
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    cb.proc = &proc;
+    cb.scope = PMIX_REMOTE;
+    cb.copy = true;
+    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_DESTRUCT(&cb);
+        return rc;
+    }
+    /* assemble the provided data into a byte object - we pack this in
+     * our native BFROPS form as it will be sent to another daemon */
+    PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
+    PMIX_LIST_FOREACH (kv, &cb.kvs, pmix_kval_t) {
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &pbkt, kv, 1, PMIX_KVAL);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_DESTRUCT(&pbkt);
+            PMIX_DESTRUCT(&cb);
+            return rc;
+        }
+    }
+    PMIX_DESTRUCT(&cb);
+
+    rp = PMIX_NEW(pmix_dmodex_reply_t);
+    if (NULL == rp) {
+        PMIX_DESTRUCT(&pbkt);
+        return PMIX_ERR_NOMEM;
+    }
+    PMIX_RETAIN(info);
+    rp->info = info;
+    rp->gen = info->modex_gen;
+    PMIX_UNLOAD_BUFFER(&pbkt, rp->data, rp->size);
+    PMIX_DESTRUCT(&pbkt);
+
+    if (rp->size <= pmix_server_globals.dmodex_cache_size) {
+        /* make room, least recently served first */
+        while (pmix_server_globals.dmodex_cache_size - rp->size
+               < pmix_server_globals.dmodex_cache_bytes) {
+            reply_drop((pmix_dmodex_reply_t *)
+                           pmix_list_get_first(&pmix_server_globals.dmodex_cache));
+        }
+        PMIX_RETAIN(rp);
+        pmix_list_append(&pmix_server_globals.dmodex_cache, &rp->super);
+        pmix_server_globals.dmodex_cache_bytes += rp->size;
+        info->dmodex_reply = rp;
+    }
+    *reply = rp;
+    return PMIX_SUCCESS;
+}
+
 static void _dmodex_req(int sd, short args, void *cbdata)
 {
     pmix_setup_caddy_t *cd = (pmix_setup_caddy_t *) cbdata;
-    pmix_rank_info_t *info, *iptr;
-    pmix_namespace_t *nptr, *ns;
+    pmix_rank_info_t *info;
+    pmix_namespace_t *nptr;
     char *data = NULL;
     size_t sz = 0;
     pmix_dmdx_remote_t *dcd;
+    pmix_dmodex_reply_t *reply;
     pmix_status_t rc;
     pmix_buffer_t pbkt;
     pmix_kval_t *kv;
@@ -75,13 +196,7 @@ static void _dmodex_req(int sd, short args, void *cbdata)
      * could cause this request to arrive prior to us having
      * been informed of it - so first check to see if we know
      * about this nspace yet */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(ns->nspace, cd->proc.nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(cd->proc.nspace);
     if (NULL == nptr) {
         /* we don't know this namespace yet, and so we obviously
          * haven't received the data from this proc yet - defer
@@ -125,13 +240,7 @@ static void _dmodex_req(int sd, short args, void *cbdata)
     }
 
     /* see if we have this peer in our list */
-    info = NULL;
-    PMIX_LIST_FOREACH (iptr, &nptr->ranks, pmix_rank_info_t) {
-        if (iptr->pname.rank == cd->proc.rank) {
-            info = iptr;
-            break;
-        }
-    }
+    info = pmix_nspace_find_rank(nptr, cd->proc.rank);
     if (NULL == info) {
         /* Not a rank we currently host. There are two ways to get here
          * and they need opposite answers: it may not have been
@@ -185,27 +294,16 @@ static void _dmodex_req(int sd, short args, void *cbdata)
         return;
     }
 
-    /* collect the remote/global data from this proc */
-    PMIX_CONSTRUCT(&cb, pmix_cb_t);
-    cb.proc = &cd->proc;
-    cb.scope = PMIX_REMOTE;
-    cb.copy = true;
-    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    rc = pmix_server_dmodex_reply(info, &reply);
     if (PMIX_SUCCESS == rc) {
-        /* assemble the provided data into a byte object */
-        PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
-        PMIX_LIST_FOREACH (kv, &cb.kvs, pmix_kval_t) {
-            PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &pbkt, kv, 1, PMIX_KVAL);
-            if (PMIX_SUCCESS != rc) {
-                PMIX_DESTRUCT(&pbkt);
-                PMIX_DESTRUCT(&cb);
-                goto cleanup;
-            }
-        }
-        PMIX_UNLOAD_BUFFER(&pbkt, data, sz);
-        PMIX_DESTRUCT(&pbkt);
+        /* the host copies what it needs before returning, so the
+         * cached bytes can be handed over as they are - the reference
+         * keeps them alive across the call */
+        cd->cbfunc(rc, reply->data, reply->size, cd->cbdata);
+        PMIX_RELEASE(reply);
+        PMIX_RELEASE(cd);
+        return;
     }
-    PMIX_DESTRUCT(&cb);
 
 cleanup:
     /* execute the callback */
@@ -58,8 +58,8 @@ static void _check_cached_events(int sd, short args, void *cbdata)
     pmix_notify_caddy_t *cd;
     pmix_range_trkr_t rngtrk;
     pmix_proc_t proc;
-    int i;
-    size_t k, n;
+    pmix_notify_caddy_t **cds;
+    size_t k, n, ncds;
     bool found, matched;
     pmix_buffer_t *relay;
     pmix_status_t ret = PMIX_SUCCESS;
@@ -67,29 +67,21 @@ static void _check_cached_events(int sd, short args, void *cbdata)
 
     PMIX_HIDE_UNUSED_PARAMS(sd, args);
 
-    /* check if any matching notifications have been cached */
+    /* check if any matching notifications have been cached - only
+     * those with the codes being registered, or all of them for a
+     * default handler */
     rngtrk.procs = NULL;
     rngtrk.nprocs = 0;
-    for (i = 0; i < pmix_globals.max_events; i++) {
-        pmix_hotel_knock(&pmix_globals.notifications, i, (void **) &cd);
-        if (NULL == cd) {
+    ncds = pmix_notify_event_lookup(scd->codes, scd->ncodes, &cds);
+    for (k = 0; k < ncds; k++) {
+        cd = cds[k];
+        if (0 > cd->room) {
+            /* left the cache since the lookup */
             continue;
         }
-        found = false;
-        if (NULL == scd->codes) {
-            if (!cd->nondefault) {
-                /* they registered a default event handler - always matches */
-                found = true;
-            }
-        } else {
-            for (k = 0; k < scd->ncodes; k++) {
-                if (scd->codes[k] == cd->status) {
-                    found = true;
-                    break;
-                }
-            }
-        }
-        if (!found) {
+        if (NULL == scd->codes && cd->nondefault) {
+            /* a default event handler matches anything not flagged
+             * for non-default handlers only */
             continue;
         }
         /* check if the affected procs (if given) match those they
@@ -128,7 +120,7 @@ static void _check_cached_events(int sd, short args, void *cbdata)
                     /* if this is the last one, then evict this event
                      * from the cache */
                     if (0 == cd->nleft) {
-                        pmix_hotel_checkout(&pmix_globals.notifications, cd->room);
+                        pmix_notify_event_uncache(cd);
                         found = true; // mark that we should release cd
                     }
                     break;
@@ -184,6 +176,12 @@ static void _check_cached_events(int sd, short args, void *cbdata)
             PMIX_RELEASE(cd);
         }
     }
+    for (k = 0; k < ncds; k++) {
+        PMIX_RELEASE(cds[k]);
+    }
+    if (NULL != cds) {
+        free(cds);
+    }
     /* release the caddy */
     if (NULL != scd->codes) {
         free(scd->codes);
@@ -300,6 +298,66 @@ static void stop_forwarding(pmix_status_t *codes, size_t ncodes)
     }
 }
 
+/* The registration store is a list, so the objects can be walked in
+ * the order they were created when a departing peer must be purged from
+ * all of them, and an index of the same objects by code. Delivering a
+ * notification used to walk the whole list looking for the one code it
+ * carried - plus the default handlers - so every event cost time in
+ * proportion to the number of distinct codes anyone had registered, and
+ * a fault storm of hundreds of PROC_TERMINATED events paid it hundreds
+ * of times over. The lookup is now a single probe of the index.
+ *
+ * The default-handler registrations are kept out of the index and held
+ * by pmix_server_globals.default_events instead: every notification
+ * that is not flagged non-default wants them, and PMIX_MAX_ERR_CONSTANT
+ * is their marker rather than a code anyone can raise. An object is on
+ * the list if and only if it can be found by code - one that cannot be
+ * filed is not tracked at all. */
+pmix_regevents_info_t *pmix_server_find_reginfo(pmix_status_t code)
+{
+    pmix_regevents_info_t *reginfo = NULL;
+
+    if (PMIX_MAX_ERR_CONSTANT == code) {
+        return pmix_server_globals.default_events;
+    }
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_uint32(&pmix_server_globals.events_index,
+                                                         (uint32_t) code, (void **) &reginfo)) {
+        return NULL;
+    }
+    return reginfo;
+}
+
+static pmix_status_t track_reginfo(pmix_regevents_info_t *reginfo)
+{
+    pmix_status_t rc;
+
+    if (PMIX_MAX_ERR_CONSTANT == reginfo->code) {
+        pmix_server_globals.default_events = reginfo;
+    } else {
+        rc = pmix_hash_table_set_value_uint32(&pmix_server_globals.events_index,
+                                              (uint32_t) reginfo->code, reginfo);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+    pmix_list_append(&pmix_server_globals.events, &reginfo->super);
+    return PMIX_SUCCESS;
+}
+
+static void untrack_reginfo(pmix_regevents_info_t *reginfo)
+{
+    if (PMIX_MAX_ERR_CONSTANT == reginfo->code) {
+        if (pmix_server_globals.default_events == reginfo) {
+            pmix_server_globals.default_events = NULL;
+        }
+    } else {
+        (void) pmix_hash_table_remove_value_uint32(&pmix_server_globals.events_index,
+                                                   (uint32_t) reginfo->code);
+    }
+    pmix_list_remove_item(&pmix_server_globals.events, &reginfo->super);
+}
+
 bool pmix_server_prune_reginfo(pmix_regevents_info_t *reginfo)
 {
     pmix_status_t *codes;
@@ -309,7 +367,7 @@ bool pmix_server_prune_reginfo(pmix_regevents_info_t *reginfo)
         return false;
     }
 
-    pmix_list_remove_item(&pmix_server_globals.events, &reginfo->super);
+    untrack_reginfo(reginfo);
     if (reginfo->active) {
         codes = (pmix_status_t *) malloc(sizeof(pmix_status_t));
         if (NULL == codes) {
@@ -331,17 +389,19 @@ static pmix_regevents_info_t *get_reginfo(pmix_status_t code)
 {
     pmix_regevents_info_t *reginfo;
 
-    PMIX_LIST_FOREACH (reginfo, &pmix_server_globals.events, pmix_regevents_info_t) {
-        if (code == reginfo->code) {
-            return reginfo;
-        }
+    reginfo = pmix_server_find_reginfo(code);
+    if (NULL != reginfo) {
+        return reginfo;
     }
     reginfo = PMIX_NEW(pmix_regevents_info_t);
     if (NULL == reginfo) {
         return NULL;
     }
     reginfo->code = code;
-    pmix_list_append(&pmix_server_globals.events, &reginfo->super);
+    if (PMIX_SUCCESS != track_reginfo(reginfo)) {
+        PMIX_RELEASE(reginfo);
+        return NULL;
+    }
     return reginfo;
 }
 
@@ -359,18 +419,13 @@ static size_t mark_activations(pmix_status_t *codes, size_t ncodes)
         if (!PMIX_SYSTEM_EVENT(codes[n])) {
             continue;
         }
-        PMIX_LIST_FOREACH (reginfo, &pmix_server_globals.events, pmix_regevents_info_t) {
-            if (codes[n] != reginfo->code) {
-                continue;
-            }
-            if (!reginfo->active) {
-                reginfo->active = true;
-                tmp = codes[nactive];
-                codes[nactive] = codes[n];
-                codes[n] = tmp;
-                ++nactive;
-            }
-            break;
+        reginfo = pmix_server_find_reginfo(codes[n]);
+        if (NULL != reginfo && !reginfo->active) {
+            reginfo->active = true;
+            tmp = codes[nactive];
+            codes[nactive] = codes[n];
+            codes[n] = tmp;
+            ++nactive;
         }
     }
     return nactive;
@@ -384,11 +439,9 @@ static void undo_activations(pmix_status_t *codes, size_t nactive)
     size_t n;
 
     for (n = 0; n < nactive; n++) {
-        PMIX_LIST_FOREACH (reginfo, &pmix_server_globals.events, pmix_regevents_info_t) {
-            if (codes[n] == reginfo->code) {
-                reginfo->active = false;
-                break;
-            }
+        reginfo = pmix_server_find_reginfo(codes[n]);
+        if (NULL != reginfo) {
+            reginfo->active = false;
         }
     }
 }
@@ -420,7 +473,7 @@ size_t pmix_server_activate_events(pmix_status_t *codes, size_t ncodes)
 
 void pmix_server_deactivate_events(pmix_status_t *codes, size_t ncodes)
 {
-    pmix_regevents_info_t *reginfo, *regnext;
+    pmix_regevents_info_t *reginfo;
     size_t n;
 
     if (NULL == codes) {
@@ -431,18 +484,42 @@ void pmix_server_deactivate_events(pmix_status_t *codes, size_t ncodes)
         if (!PMIX_SYSTEM_EVENT(codes[n])) {
             continue;
         }
-        PMIX_LIST_FOREACH_SAFE (reginfo, regnext, &pmix_server_globals.events,
-                                pmix_regevents_info_t) {
-            if (codes[n] != reginfo->code) {
-                continue;
-            }
-            if (0 < reginfo->nmine) {
-                --reginfo->nmine;
-            }
-            pmix_server_prune_reginfo(reginfo);
-            break;
+        reginfo = pmix_server_find_reginfo(codes[n]);
+        if (NULL == reginfo) {
+            continue;
+        }
+        if (0 < reginfo->nmine) {
+            --reginfo->nmine;
+        }
+        pmix_server_prune_reginfo(reginfo);
+    }
+}
+
+/* add a peer's registration to the object tracking its code */
+static pmix_status_t add_registrant(pmix_regevents_info_t *reginfo, pmix_peer_t *peer,
+                                    pmix_proc_t *affected, size_t naffected,
+                                    bool enviro_events)
+{
+    pmix_peer_events_info_t *prev;
+
+    prev = PMIX_NEW(pmix_peer_events_info_t);
+    if (NULL == prev) {
+        return PMIX_ERR_NOMEM;
+    }
+    if (NULL != affected) {
+        PMIX_PROC_CREATE(prev->affected, naffected);
+        if (NULL == prev->affected) {
+            PMIX_RELEASE(prev);
+            return PMIX_ERR_NOMEM;
         }
+        prev->naffected = naffected;
+        memcpy(prev->affected, affected, naffected * sizeof(pmix_proc_t));
     }
+    PMIX_RETAIN(peer);
+    prev->peer = peer;
+    prev->enviro_events = enviro_events;
+    pmix_list_append(&reginfo->peers, &prev->super);
+    return PMIX_SUCCESS;
 }
 
 pmix_status_t pmix_server_register_events(pmix_peer_t *peer, pmix_buffer_t *buf,
@@ -453,11 +530,9 @@ pmix_status_t pmix_server_register_events(pmix_peer_t *peer, pmix_buffer_t *buf,
     pmix_status_t *codes = NULL;
     pmix_info_t *info = NULL;
     size_t ninfo = 0, ncodes, n;
-    pmix_regevents_info_t *reginfo, *rptr;
-    pmix_peer_events_info_t *prev = NULL;
+    pmix_regevents_info_t *reginfo;
     pmix_setup_caddy_t *scd;
     bool enviro_events = false;
-    bool found;
     pmix_proc_t *affected = NULL;
     size_t naffected = 0;
     size_t nactive = 0;
@@ -603,40 +678,15 @@ pmix_status_t pmix_server_register_events(pmix_peer_t *peer, pmix_buffer_t *buf,
      * The code != 0 path below has always created a missing entry; this
      * one simply has to do the same. */
     if (0 == ncodes) {
-        reginfo = NULL;
-        PMIX_LIST_FOREACH (rptr, &pmix_server_globals.events, pmix_regevents_info_t) {
-            if (PMIX_MAX_ERR_CONSTANT == rptr->code) {
-                reginfo = rptr;
-                break;
-            }
-        }
+        reginfo = get_reginfo(PMIX_MAX_ERR_CONSTANT);
         if (NULL == reginfo) {
-            reginfo = PMIX_NEW(pmix_regevents_info_t);
-            if (NULL == reginfo) {
-                rc = PMIX_ERR_NOMEM;
-                goto cleanup;
-            }
-            reginfo->code = PMIX_MAX_ERR_CONSTANT;
-            pmix_list_append(&pmix_server_globals.events, &reginfo->super);
-        }
-        prev = PMIX_NEW(pmix_peer_events_info_t);
-        if (NULL == prev) {
             rc = PMIX_ERR_NOMEM;
             goto cleanup;
         }
-        PMIX_RETAIN(peer);
-        prev->peer = peer;
-        if (NULL != affected) {
-            PMIX_PROC_CREATE(prev->affected, naffected);
-            if (NULL == prev->affected) {
-                PMIX_RELEASE(prev);
-                rc = PMIX_ERR_NOMEM;
-                goto cleanup;
-            }
-            prev->naffected = naffected;
-            memcpy(prev->affected, affected, naffected * sizeof(pmix_proc_t));
+        rc = add_registrant(reginfo, peer, affected, naffected, false);
+        if (PMIX_SUCCESS != rc) {
+            goto cleanup;
         }
-        pmix_list_append(&reginfo->peers, &prev->super);
         /* fall through rather than returning here: a default handler must
          * still be given any matching notification already sitting in the
          * cache, and _check_cached_events has a dedicated arm for exactly
@@ -650,64 +700,14 @@ pmix_status_t pmix_server_register_events(pmix_peer_t *peer, pmix_buffer_t *buf,
     /* store the event registration info so we can call the registered
      * client when the server notifies the event */
     for (n = 0; n < ncodes; n++) {
-        found = false;
-        PMIX_LIST_FOREACH (reginfo, &pmix_server_globals.events, pmix_regevents_info_t) {
-            if (PMIX_MAX_ERR_CONSTANT == reginfo->code) {
-                continue;
-            } else if (codes[n] == reginfo->code) {
-                found = true;
-                break;
-            }
+        reginfo = get_reginfo(codes[n]);
+        if (NULL == reginfo) {
+            rc = PMIX_ERR_NOMEM;
+            goto cleanup;
         }
-        if (found) {
-            /* found it - add this request */
-            prev = PMIX_NEW(pmix_peer_events_info_t);
-            if (NULL == prev) {
-                rc = PMIX_ERR_NOMEM;
-                goto cleanup;
-            }
-            PMIX_RETAIN(peer);
-            prev->peer = peer;
-            if (NULL != affected) {
-                PMIX_PROC_CREATE(prev->affected, naffected);
-                if (NULL == prev->affected) {
-                    PMIX_RELEASE(prev);
-                    rc = PMIX_ERR_NOMEM;
-                    goto cleanup;
-                }
-                prev->naffected = naffected;
-                memcpy(prev->affected, affected, naffected * sizeof(pmix_proc_t));
-            }
-            prev->enviro_events = enviro_events;
-            pmix_list_append(&reginfo->peers, &prev->super);
-        } else {
-            /* if we get here, then we didn't find an existing registration for this code */
-            rptr = PMIX_NEW(pmix_regevents_info_t);
-            if (NULL == rptr) {
-                rc = PMIX_ERR_NOMEM;
-                goto cleanup;
-            }
-            rptr->code = codes[n];
-            pmix_list_append(&pmix_server_globals.events, &rptr->super);
-            prev = PMIX_NEW(pmix_peer_events_info_t);
-            if (NULL == prev) {
-                rc = PMIX_ERR_NOMEM;
-                goto cleanup;
-            }
-            PMIX_RETAIN(peer);
-            prev->peer = peer;
-            if (NULL != affected) {
-                PMIX_PROC_CREATE(prev->affected, naffected);
-                if (NULL == prev->affected) {
-                    PMIX_RELEASE(prev);
-                    rc = PMIX_ERR_NOMEM;
-                    goto cleanup;
-                }
-                prev->naffected = naffected;
-                memcpy(prev->affected, affected, naffected * sizeof(pmix_proc_t));
-            }
-            prev->enviro_events = enviro_events;
-            pmix_list_append(&rptr->peers, &prev->super);
+        rc = add_registrant(reginfo, peer, affected, naffected, enviro_events);
+        if (PMIX_SUCCESS != rc) {
+            goto cleanup;
         }
     }
 
@@ -855,8 +855,7 @@ void pmix_server_deregister_events(pmix_peer_t *peer, pmix_buffer_t *buf)
 {
     int32_t cnt;
     pmix_status_t rc, code;
-    pmix_regevents_info_t *reginfo = NULL;
-    pmix_regevents_info_t *reginfo_next;
+    pmix_regevents_info_t *reginfo;
     pmix_peer_events_info_t *prev, *prev_next;
 
     pmix_output_verbose(2, pmix_server_globals.event_output,
@@ -868,32 +867,30 @@ void pmix_server_deregister_events(pmix_peer_t *peer, pmix_buffer_t *buf)
     cnt = 1;
     PMIX_BFROPS_UNPACK(rc, peer, buf, &code, &cnt, PMIX_STATUS);
     while (PMIX_SUCCESS == rc) {
-        PMIX_LIST_FOREACH_SAFE (reginfo, reginfo_next, &pmix_server_globals.events,
-                                pmix_regevents_info_t) {
-            if (code == reginfo->code) {
-                /* Found it - remove _every_ registration this peer holds
-                 * for the code, not just the first. A peer can hold more
-                 * than one: its library packs the whole code list of a
-                 * handler whenever any code in that list is new to us, so
-                 * a second handler naming an already-registered code adds
-                 * a second entry here. It sends the deregistration only
-                 * when its last handler for the code is gone, so anything
-                 * of this peer's still sitting on the list is stale -
-                 * stopping at the first left one behind, which kept us
-                 * forwarding the code to a peer that had no handler for it
-                 * and kept the reginfo from ever being pruned. */
-                PMIX_LIST_FOREACH_SAFE (prev, prev_next, &reginfo->peers,
-                                        pmix_peer_events_info_t) {
-                    if (prev->peer == peer) {
-                        pmix_list_remove_item(&reginfo->peers, &prev->super);
-                        PMIX_RELEASE(prev);
-                    }
+        reginfo = pmix_server_find_reginfo(code);
+        if (NULL != reginfo) {
+            /* Found it - remove _every_ registration this peer holds
+             * for the code, not just the first. A peer can hold more
+             * than one: its library packs the whole code list of a
+             * handler whenever any code in that list is new to us, so
+             * a second handler naming an already-registered code adds
+             * a second entry here. It sends the deregistration only
+             * when its last handler for the code is gone, so anything
+             * of this peer's still sitting on the list is stale -
+             * stopping at the first left one behind, which kept us
+             * forwarding the code to a peer that had no handler for it
+             * and kept the reginfo from ever being pruned. */
+            PMIX_LIST_FOREACH_SAFE (prev, prev_next, &reginfo->peers,
+                                    pmix_peer_events_info_t) {
+                if (prev->peer == peer) {
+                    pmix_list_remove_item(&reginfo->peers, &prev->super);
+                    PMIX_RELEASE(prev);
                 }
-                /* if nobody is left registered for this code - not the
-                 * server itself, nor any of our local clients - then
-                 * remove it and tell our host to stop forwarding it */
-                pmix_server_prune_reginfo(reginfo);
             }
+            /* if nobody is left registered for this code - not the
+             * server itself, nor any of our local clients - then
+             * remove it and tell our host to stop forwarding it */
+            pmix_server_prune_reginfo(reginfo);
         }
         cnt = 1;
         PMIX_BFROPS_UNPACK(rc, peer, buf, &code, &cnt, PMIX_STATUS);
@@ -59,7 +59,7 @@
 #include "src/hwloc/pmix_hwloc.h"
 #include "src/mca/bfrops/base/base.h"
 #include "src/mca/gds/base/base.h"
-#include "src/mca/pcompress/pcompress.h"
+#include "src/mca/pcompress/base/base.h"
 #include "src/mca/plog/plog.h"
 #include "src/mca/pnet/pnet.h"
 #include "src/mca/psensor/psensor.h"
@@ -68,6 +68,7 @@
 #include "src/util/pmix_error.h"
 #include "src/util/pmix_name_fns.h"
 #include "src/runtime/pmix_progress_threads.h"
+#include "src/threads/pmix_parallel.h"
 #include "src/util/pmix_output.h"
 #include "src/util/pmix_environ.h"
 
@@ -75,21 +76,36 @@
 #include "pmix_server_ops.h"
 
 /* The rank_blob_t type to collect processes blobs,
- * this list afterward will form a node modex blob. */
+ * this list afterward will form a node modex blob.
+ *
+ * A blob starts out as what is to go into it - the rank, and the kvals
+ * to pack for it - and pack_rank_blob() turns that into "buf". The two
+ * steps are apart so the packing can be shared across threads: see
+ * pmix_server_collect_data(). */
 typedef struct {
     pmix_list_item_t super;
     pmix_buffer_t *buf;
+    pmix_proc_t proc;
+    pmix_rank_info_t *info;
+    /* the kvals to pack - either "fetched" or the rank's own pending
+     * list, which is only read */
+    pmix_list_t *kvs;
+    pmix_list_t fetched;
 } rank_blob_t;
 
 static void bufcon(rank_blob_t *p)
 {
     p->buf = NULL;
+    p->info = NULL;
+    p->kvs = NULL;
+    PMIX_CONSTRUCT(&p->fetched, pmix_list_t);
 }
 static void bufdes(rank_blob_t *p)
 {
     if (NULL != p->buf) {
         PMIX_RELEASE(p->buf);
     }
+    PMIX_LIST_DESTRUCT(&p->fetched);
 }
 static PMIX_CLASS_INSTANCE(rank_blob_t,
                            pmix_list_item_t,
@@ -99,16 +115,14 @@ pmix_status_t pmix_server_commit(pmix_peer_t *peer, pmix_buffer_t *buf)
 {
     int32_t cnt;
     pmix_status_t rc;
-    pmix_buffer_t b2, pbkt;
+    pmix_buffer_t b2;
     pmix_kval_t *kp;
     pmix_scope_t scope;
     pmix_namespace_t *nptr;
     pmix_rank_info_t *info;
     pmix_proc_t proc;
     pmix_dmdx_remote_t *dcd, *dcdnext;
-    char *data;
-    size_t sz;
-    pmix_cb_t cb;
+    pmix_dmodex_reply_t *reply = NULL;
 
     /* shorthand */
     info = peer->info;
@@ -116,6 +130,12 @@ pmix_status_t pmix_server_commit(pmix_peer_t *peer, pmix_buffer_t *buf)
     pmix_strncpy(proc.nspace, nptr->nspace, PMIX_MAX_NSLEN);
     proc.rank = info->pname.rank;
 
+    /* whatever was packed for a direct-modex request is out of date
+     * from the first store below - and stays so even if a later one
+     * fails, so do this before any of them */
+    info->modex_gen++;
+    pmix_server_dmodex_forget(info);
+
     pmix_output_verbose(2, pmix_server_globals.fence_output,
                         "%s:%d EXECUTE COMMIT FOR %s:%d",
                         pmix_globals.myid.nspace, pmix_globals.myid.rank, nptr->nspace,
@@ -291,36 +311,25 @@ pmix_status_t pmix_server_commit(pmix_peer_t *peer, pmix_buffer_t *buf)
         }
         if (dcd->cd->proc.rank == info->pname.rank) {
             pmix_list_remove_item(&pmix_server_globals.remote_pnd, &dcd->super);
-            /* we can now fulfill this request - collect the
-             * remote/global data from this proc - note that there
-             * may not be a contribution */
-            data = NULL;
-            sz = 0;
-            PMIX_CONSTRUCT(&cb, pmix_cb_t);
-            cb.proc = &proc;
-            cb.scope = PMIX_REMOTE;
-            cb.copy = true;
-            PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
-            if (PMIX_SUCCESS == rc) {
-                /* package it up */
-                PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
-                PMIX_LIST_FOREACH (kp, &cb.kvs, pmix_kval_t) {
-                    /* we pack this in our native BFROPS form as it
-                     * will be sent to another daemon */
-                    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &pbkt, kp, 1, PMIX_KVAL);
-                }
-                PMIX_UNLOAD_BUFFER(&pbkt, data, sz);
+            /* we can now fulfill this request - note that there may
+             * not be a contribution. Every request parked on this rank
+             * gets the same bytes, so pack them once */
+            if (NULL == reply) {
+                rc = pmix_server_dmodex_reply(info, &reply);
             }
-            PMIX_DESTRUCT(&cb);
             /* execute the callback */
-            dcd->cd->cbfunc(rc, data, sz, dcd->cd->cbdata);
-            if (NULL != data) {
-                free(data);
+            if (NULL != reply) {
+                dcd->cd->cbfunc(PMIX_SUCCESS, reply->data, reply->size, dcd->cd->cbdata);
+            } else {
+                dcd->cd->cbfunc(rc, NULL, 0, dcd->cd->cbdata);
             }
             /* we have finished this request */
             PMIX_RELEASE(dcd);
         }
     }
+    if (NULL != reply) {
+        PMIX_RELEASE(reply);
+    }
     /* see if anyone local is waiting on this data- could be more than one */
     rc = pmix_pending_resolve(nptr, info->pname.rank, PMIX_SUCCESS, PMIX_LOCAL, NULL);
     if (PMIX_SUCCESS != rc) {
@@ -329,6 +338,204 @@ pmix_status_t pmix_server_commit(pmix_peer_t *peer, pmix_buffer_t *buf)
     return rc;
 }
 
+/* Trackers are filed in pmix_server_globals.collectives_index so that
+ * finding the one a contribution belongs to does not mean comparing it
+ * against every tracker in flight. That used to be a brute-force walk of
+ * the collectives list, comparing participant arrays proc by proc, on
+ * the theory that there would only ever be one or two trackers active.
+ * An application running many non-blocking fences over different
+ * sub-communicators, or connecting many groups at once, has far more
+ * than that, and paid for every one of them on every contribution.
+ *
+ * A tracker with an id is filed under its id. One without is filed
+ * under its type and its participant *set*: the same procs in any order
+ * have to find the same tracker, which is why this is not
+ * participant_signature() - that digest is deliberately order-sensitive.
+ * Each proc is hashed on its own and the hashes summed, so the order
+ * drops out. Trackers that share a key are chained through index_next;
+ * a lookup still compares each candidate in full, so a collision costs
+ * a comparison and never a wrong match. */
+static inline uint64_t tracker_mix(uint64_t x)
+{
+    /* the splitmix64 finalizer - spreads sums of similar hashes */
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static uint64_t tracker_key(const char *id, const pmix_proc_t *procs,
+                            size_t nprocs, pmix_cmd_t type)
+{
+    uint64_t h = 14695981039346656037ULL; /* FNV-1a 64-bit offset basis */
+    uint64_t sum = 0;
+    const unsigned char *p;
+    size_t n;
+
+    if (NULL != id) {
+        for (p = (const unsigned char *) id; '\0' != *p; p++) {
+            h ^= (uint64_t) *p;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+    for (n = 0; NULL != procs && n < nprocs; n++) {
+        h = 14695981039346656037ULL;
+        for (p = (const unsigned char *) procs[n].nspace; '\0' != *p; p++) {
+            h ^= (uint64_t) *p;
+            h *= 1099511628211ULL;
+        }
+        sum += tracker_mix(h ^ (uint64_t) procs[n].rank);
+    }
+    return tracker_mix(sum ^ tracker_mix(((uint64_t) type << 32) ^ (uint64_t) nprocs));
+}
+
+void pmix_server_track_collective(pmix_server_trkr_t *trk)
+{
+    pmix_server_trkr_t *head = NULL;
+    pmix_status_t rc;
+
+    pmix_list_append(&pmix_server_globals.collectives, &trk->super);
+    if (NULL == trk->id && NULL == trk->pcs) {
+        /* nothing a lookup could name it by */
+        return;
+    }
+    trk->index_key = tracker_key(trk->id, trk->pcs, trk->npcs, trk->type);
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.collectives_index,
+                                            trk->index_key, (void **) &head);
+    trk->index_next = head;
+    rc = pmix_hash_table_set_value_uint64(&pmix_server_globals.collectives_index,
+                                          trk->index_key, trk);
+    if (PMIX_SUCCESS != rc) {
+        /* the tracker is still on the list and still completes - it
+         * just cannot be found by a later contributor */
+        PMIX_ERROR_LOG(rc);
+        trk->index_next = NULL;
+        return;
+    }
+    trk->indexed = true;
+}
+
+void pmix_server_untrack_collective(pmix_server_trkr_t *trk)
+{
+    pmix_server_trkr_t *prev = NULL;
+
+    if (trk->indexed) {
+        (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.collectives_index,
+                                                trk->index_key, (void **) &prev);
+        if (prev == trk) {
+            if (NULL != trk->index_next) {
+                pmix_hash_table_set_value_uint64(&pmix_server_globals.collectives_index,
+                                                 trk->index_key, trk->index_next);
+            } else {
+                pmix_hash_table_remove_value_uint64(&pmix_server_globals.collectives_index,
+                                                    trk->index_key);
+            }
+        } else {
+            while (NULL != prev && prev->index_next != trk) {
+                prev = prev->index_next;
+            }
+            if (NULL != prev) {
+                prev->index_next = trk->index_next;
+            }
+        }
+        trk->indexed = false;
+        trk->index_next = NULL;
+    }
+    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+}
+
+/* Whether two participant arrays of the same length name the same procs.
+ * Every contributor to a collective passes the participant array its
+ * application built, which is almost always the same array in the same
+ * order - so compare in place first, and only search when that fails. */
+static bool same_participants(const pmix_proc_t *procs, const pmix_proc_t *pcs,
+                              size_t nprocs)
+{
+    size_t i, j, matches;
+
+    for (i = 0; i < nprocs; i++) {
+        if (procs[i].rank != pcs[i].rank || 0 != strcmp(procs[i].nspace, pcs[i].nspace)) {
+            break;
+        }
+    }
+    if (i == nprocs) {
+        return true;
+    }
+    matches = i;
+    for (; i < nprocs; i++) {
+        /* the procs may be in different order, so we have
+         * to do an exhaustive search */
+        for (j = 0; j < nprocs; j++) {
+            if (0 == strcmp(procs[i].nspace, pcs[j].nspace) && procs[i].rank == pcs[j].rank) {
+                ++matches;
+                break;
+            }
+        }
+    }
+    return (nprocs == matches);
+}
+
+/* Add to an id-based tracker whichever of the given procs it does not
+ * already have. A hash set of what it has keeps this linear: the nested
+ * search it replaces was quadratic in the participant count, once per
+ * contribution. Keys are whole pmix_proc_t's, zeroed first so that the
+ * bytes after the nspace's terminator compare equal too. */
+static void merge_participants(pmix_server_trkr_t *trk, const pmix_proc_t *procs,
+                               size_t nprocs)
+{
+    pmix_hash_table_t seen;
+    pmix_proc_t key, *ptr;
+    void *dummy;
+    size_t n, sz;
+
+    if (NULL == procs || 0 == nprocs) {
+        return;
+    }
+    sz = trk->npcs + nprocs;
+    PMIX_PROC_CREATE(ptr, sz);
+    if (NULL == ptr) {
+        /* hand back the tracker without the new participants rather
+         * than dereferencing NULL; failing the lookup would be worse
+         * still, as the caller would then create a second tracker for
+         * an id that already has one */
+        PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+        return;
+    }
+    PMIX_CONSTRUCT(&seen, pmix_hash_table_t);
+    pmix_hash_table_init(&seen, sz);
+    for (n = 0; n < trk->npcs; n++) {
+        memset(&key, 0, sizeof(key));
+        PMIX_LOAD_PROCID(&key, trk->pcs[n].nspace, trk->pcs[n].rank);
+        pmix_hash_table_set_value_ptr(&seen, &key, sizeof(key), trk);
+    }
+    if (0 < trk->npcs) {
+        memcpy(ptr, trk->pcs, trk->npcs * sizeof(pmix_proc_t));
+    }
+    sz = trk->npcs;
+    for (n = 0; n < nprocs; n++) {
+        memset(&key, 0, sizeof(key));
+        PMIX_LOAD_PROCID(&key, procs[n].nspace, procs[n].rank);
+        if (PMIX_SUCCESS == pmix_hash_table_get_value_ptr(&seen, &key, sizeof(key), &dummy)) {
+            // match - can ignore it
+            continue;
+        }
+        pmix_hash_table_set_value_ptr(&seen, &key, sizeof(key), trk);
+        memcpy(&ptr[sz], &procs[n], sizeof(pmix_proc_t));
+        ++sz;
+    }
+    PMIX_DESTRUCT(&seen);
+    if (sz == trk->npcs) {
+        PMIX_PROC_FREE(ptr, trk->npcs + nprocs);
+        return;
+    }
+    PMIX_PROC_FREE(trk->pcs, trk->npcs);
+    trk->pcs = ptr;
+    trk->npcs = sz;
+}
+
 /* get an existing object for tracking LOCAL participation in a collective
  * operation such as "fence". The only way this function can be
  * called is if at least one local client process is participating
@@ -348,13 +555,7 @@ pmix_status_t pmix_server_commit(pmix_peer_t *peer, pmix_buffer_t *buf)
 pmix_server_trkr_t *pmix_server_get_tracker(char *id, pmix_proc_t *procs,
                                             size_t nprocs, pmix_cmd_t type)
 {
-    pmix_server_trkr_t *trk;
-    size_t i, j, sz;
-    size_t matches;
-    pmix_proclist_t *p;
-    pmix_proc_t *ptr;
-    pmix_list_t cache;
-    bool found;
+    pmix_server_trkr_t *trk = NULL;
 
     pmix_output_verbose(5, pmix_server_globals.fence_output,
                         "pmix_server_get_tracker called with %d procs",
@@ -366,17 +567,17 @@ pmix_server_trkr_t *pmix_server_get_tracker(char *id, pmix_proc_t *procs,
         return NULL;
     }
 
-    /* there is no shortcut way to search the trackers - all
-     * we can do is perform a brute-force search. Fortunately,
-     * it is highly unlikely that there will be more than one
-     * or two active at a time, and they are most likely to
-     * involve only a single proc with WILDCARD rank - so this
-     * shouldn't take long */
-    PMIX_LIST_FOREACH (trk, &pmix_server_globals.collectives, pmix_server_trkr_t) {
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_uint64(&pmix_server_globals.collectives_index,
+                                                         tracker_key(id, procs, nprocs, type),
+                                                         (void **) &trk)) {
+        /* No tracker was found */
+        return NULL;
+    }
+    for (; NULL != trk; trk = trk->index_next) {
         /* a tracker whose completion has been driven is on its way out -
          * its handler is thread-shifted and will reply to everyone on
          * local_cbs, unlink the tracker and release it. It is still on
-         * this list until then, but it must not take a new participant:
+         * the list until then, but it must not take a new participant:
          * that caddy would be freed with the tracker without ever being
          * answered, hanging a client whose only mistake was to call the
          * next collective quickly. Skip it and let the caller open a
@@ -386,85 +587,23 @@ pmix_server_trkr_t *pmix_server_get_tracker(char *id, pmix_proc_t *procs,
         }
         /* Collective operation if unique identified by
          * the set of participating processes and the type of collective,
-         * or by the operation ID
+         * or by the operation ID - and a tracker with an ID is only ever
+         * found by it
          */
         if (NULL != id) {
             if (NULL != trk->id && 0 == strcmp(id, trk->id)) {
-                PMIX_CONSTRUCT(&cache, pmix_list_t);
                 /* update tracked procs to include the given ones,
                  * filtered to only keep unique entries */
-                if (NULL != procs) {
-                    for (i=0; i < nprocs; i++) {
-                        found = false;
-                        for (j=0; j < trk->npcs; j++) {
-                            if (PMIX_CHECK_PROCID(&procs[i], &trk->pcs[j])) {
-                                // match - can ignore it
-                                found = true;
-                                break;
-                            }
-                        }
-                        if (!found) {
-                            // new proc, so we need to add it
-                            p = PMIX_NEW(pmix_proclist_t);
-                            memcpy(&p->proc, &procs[i], sizeof(pmix_proc_t));
-                            pmix_list_append(&cache, &p->super);
-                        }
-                    }
-                }
-                i = pmix_list_get_size(&cache);
-                if (0 < i) {
-                    sz = trk->npcs + i;
-                    PMIX_PROC_CREATE(ptr, sz);
-                    if (NULL == ptr) {
-                        /* nothing screens this allocation downstream - the
-                         * next statement copies into it. Hand back the
-                         * tracker we found without the new participants
-                         * rather than dereferencing NULL; returning NULL
-                         * would be worse still, as the caller would then
-                         * create a second tracker for an id that already
-                         * has one */
-                        PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
-                        PMIX_LIST_DESTRUCT(&cache);
-                        return trk;
-                    }
-                    memcpy(ptr, trk->pcs, trk->npcs * sizeof(pmix_proc_t));
-                    j = trk->npcs;
-                    PMIX_LIST_FOREACH(p, &cache, pmix_proclist_t) {
-                        memcpy(&ptr[j], &p->proc, sizeof(pmix_proc_t));
-                        ++j;
-                    }
-                    PMIX_PROC_FREE(trk->pcs, trk->npcs);
-                    trk->pcs = ptr;
-                    trk->npcs = sz;
-                }
-                PMIX_LIST_DESTRUCT(&cache);
-                return trk;
-            }
-        } else {
-            // id must have been NULL, so we know procs is not
-            if (nprocs != trk->npcs) {
-                continue;
-            }
-            if (type != trk->type) {
-                continue;
-            }
-            matches = 0;
-            if (NULL != procs) {
-                for (i = 0; i < nprocs; i++) {
-                    /* the procs may be in different order, so we have
-                     * to do an exhaustive search */
-                    for (j = 0; j < trk->npcs; j++) {
-                        if (0 == strcmp(procs[i].nspace, trk->pcs[j].nspace)
-                            && procs[i].rank == trk->pcs[j].rank) {
-                            ++matches;
-                            break;
-                        }
-                    }
-                }
-            }
-            if (trk->npcs == matches) {
+                merge_participants(trk, procs, nprocs);
                 return trk;
             }
+            continue;
+        }
+        if (NULL != trk->id || nprocs != trk->npcs || type != trk->type) {
+            continue;
+        }
+        if (same_participants(procs, trk->pcs, nprocs)) {
+            return trk;
         }
     }
     /* No tracker was found */
@@ -493,7 +632,7 @@ pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
     pmix_server_trkr_t *trk;
     size_t i;
     bool all_def, found;
-    pmix_namespace_t *nptr, *ns;
+    pmix_namespace_t *nptr;
     pmix_rank_info_t *info;
     pmix_nspace_caddy_t *nm;
     pmix_nspace_t first;
@@ -527,7 +666,7 @@ pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
     if (NULL == procs) {
         // we are done
         trk->def_complete = true;
-        pmix_list_append(&pmix_server_globals.collectives, &trk->super);
+        pmix_server_track_collective(trk);
         return trk;
     }
 
@@ -547,13 +686,7 @@ pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
     PMIX_LOAD_NSPACE(first, NULL);
     for (i = 0; i < nprocs; i++) {
         /* is this nspace known to us? */
-        nptr = NULL;
-        PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (0 == strcmp(procs[i].nspace, ns->nspace)) {
-                nptr = ns;
-                break;
-            }
-        }
+        nptr = pmix_nspace_lookup(procs[i].nspace);
         /* check if multiple nspaces are involved in this operation */
         if (0 == strlen(first)) {
             PMIX_LOAD_NSPACE(first, procs[i].nspace);
@@ -655,19 +788,14 @@ pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
             continue;
         }
         /* is this one of my local ranks? */
-        found = false;
-        PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-            if (procs[i].rank == info->pname.rank) {
-                pmix_output_verbose(5, pmix_server_globals.fence_output,
-                                    "adding local proc %s.%d to tracker", info->pname.nspace,
-                                    info->pname.rank);
-                found = true;
-                /* track the count */
-                trk->nlocal++;
-                break;
-            }
-        }
-        if (!found) {
+        info = pmix_nspace_find_rank(nptr, procs[i].rank);
+        if (NULL != info) {
+            pmix_output_verbose(5, pmix_server_globals.fence_output,
+                                "adding local proc %s.%d to tracker", info->pname.nspace,
+                                info->pname.rank);
+            /* track the count */
+            trk->nlocal++;
+        } else {
             trk->local = false;
         }
     }
@@ -675,7 +803,7 @@ pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
     if (all_def) {
         trk->def_complete = true;
     }
-    pmix_list_append(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_track_collective(trk);
     return trk;
 }
 
@@ -706,7 +834,7 @@ static void fence_timeout(int sd, short args, void *cbdata)
      * Being on that list is not a reference; releasing while still linked
      * leaves a dangling entry that the next sweep walks into. */
     trk->event_active = false;
-    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_untrack_collective(trk);
     PMIX_RELEASE(trk);
 }
 
@@ -723,7 +851,7 @@ static void _collect_job_info(int sd, short args, void *cbdata)
     pmix_buffer_t pbkt;
     pmix_kval_t *kptr;
     pmix_byte_object_t pbo;
-    pmix_namespace_t *nptr, *ns;
+    pmix_namespace_t *nptr;
     pmix_rank_info_t *rinfo;
     pmix_peer_t *peer;
     PMIX_HIDE_UNUSED_PARAMS(sd, args);
@@ -758,13 +886,7 @@ static void _collect_job_info(int sd, short args, void *cbdata)
     // cycle across the nspaces to collect their job info
     for (n = 0; NULL != nspaces[n]; n++) {
         // see if we have this nspace
-        nptr = NULL;
-        PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-            if (0 == strcmp(ns->nspace, nspaces[n])) {
-                nptr = ns;
-                break;
-            }
-        }
+        nptr = pmix_nspace_lookup(nspaces[n]);
         if (NULL == nptr) {
             // we don't know this one, so nothing we can do
             continue;
@@ -1103,38 +1225,216 @@ void pmix_server_modex_resync(const pmix_proc_t *proc)
     if (NULL == proc) {
         return;
     }
-    PMIX_LIST_FOREACH (nptr, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 != strncmp(nptr->nspace, proc->nspace, PMIX_MAX_NSLEN)) {
-            continue;
+    nptr = pmix_nspace_lookup(proc->nspace);
+    if (NULL == nptr) {
+        return;
+    }
+    if (PMIX_RANK_WILDCARD != proc->rank) {
+        info = pmix_nspace_find_rank(nptr, proc->rank);
+        if (NULL != info) {
+            info->modex_contributed = false;
+        }
+        return;
+    }
+    PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
+        info->modex_contributed = false;
+    }
+}
+
+/* --- assembling a contribution on several threads ---
+ *
+ * With a few hundred local ranks each posting a few hundred KiB, what
+ * pmix_server_collect_data() spends its time on is copying: packing
+ * every rank's kvals into a wire buffer, then compressing the lot - all
+ * on the progress thread, while the host waits for the contribution.
+ * Both divide cleanly. A rank's blob is its own buffer built from its
+ * own kvals, and the compressor is handed one span of bytes and hands
+ * back another, keeping nothing between calls. So those two steps are
+ * shared out across fence_threads with pmix_parallel_items(), the
+ * calling thread taking the first range itself.
+ *
+ * Fetching the kvals from the datastore is not shared out. That walks
+ * (and on a miss can create) the GDS's per-namespace tables, which are
+ * progress-thread-only like everything else in it, so it stays serial
+ * and is done before any worker starts. It is also the cheap part: it
+ * hands over copies, and the copying that matters is what the packing
+ * does with them. */
+
+/* How many threads to share "nitems" out across, each given at least
+ * "minper" of them */
+static size_t fence_nworkers(size_t nitems, size_t minper)
+{
+    return pmix_parallel_nworkers(pmix_server_globals.fence_threads, nitems, minper);
+}
+
+/* Pack one rank's blob from what the serial pass gathered for it. Runs
+ * on a worker: it touches nothing but this blob, the rank's pending
+ * lists - which are only read, and which nothing changes while the
+ * progress thread is in here waiting on the workers - and the packing
+ * code, which keeps its state in the buffer it is given. */
+static pmix_status_t pack_rank_blob(void *items, size_t n)
+{
+    rank_blob_t *blob = ((rank_blob_t **) items)[n];
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+
+    blob->buf = PMIX_NEW(pmix_buffer_t);
+    if (NULL == blob->buf) {
+        return PMIX_ERR_NOMEM;
+    }
+    /* pack the rank */
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, blob->buf, &blob->proc, 1, PMIX_PROC);
+    if (PMIX_SUCCESS != rc) {
+        return rc;
+    }
+    /* an empty list is a legitimate answer for a delta - the receiver
+     * reads a proc with no kvals as "this rank published nothing new" */
+    PMIX_LIST_FOREACH (kv, blob->kvs, pmix_kval_t) {
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, blob->buf, kv, 1, PMIX_KVAL);
+        if (PMIX_SUCCESS != rc) {
+            return rc;
         }
-        PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-            if (PMIX_RANK_WILDCARD == proc->rank || info->pname.rank == proc->rank) {
-                info->modex_contributed = false;
+    }
+    if (PMIX_SUCCESS != pack_pending_deletes(blob->info, blob->buf)) {
+        return PMIX_ERR_PACK_FAILURE;
+    }
+    /* the copies are in the buffer now, so let them go as we go rather
+     * than holding every rank's twice until the whole bucket is done */
+    PMIX_LIST_DESTRUCT(&blob->fetched);
+    PMIX_CONSTRUCT(&blob->fetched, pmix_list_t);
+    return PMIX_SUCCESS;
+}
+
+static pmix_status_t compress_frame(void *items, size_t n)
+{
+    pmix_compress_base_frame_compress(&((pmix_compress_frame_t *) items)[n]);
+    return PMIX_SUCCESS;
+}
+
+/* Pack the assembled bucket into "bkt" in the form
+ * pmix_gds_base_store_modex() reads: a flag saying whether it is
+ * compressed, then the bytes.
+ *
+ * A compressor only ever sees one span, so however many threads there
+ * are, a bucket compressed whole is compressed on one of them - and the
+ * receiver has to expand all of it before it can store any of it. With
+ * fence_compress_chunk set, a bucket larger than that is instead cut
+ * into frames of about that size, each compressed on its own - all at
+ * once, here - and sent as a framed container (see pcompress's base.h):
+ *
+ *     true, <empty byte object>        marks the framed form
+ *     byte object                      the container
+ *
+ * Frames are cut only at "bounds", the offsets at which one packed item
+ * of the bucket ends and the next begins, so every frame unpacks on its
+ * own: the receiver stores each frame's ranks as it expands it and can
+ * drop it before expanding the next. A rank blob larger than the frame
+ * size simply makes a larger frame.
+ *
+ * The marker is the one pairing the whole form can never produce - a
+ * compressor declines an empty input - and it is also what makes a
+ * release that predates this fail cleanly: it hands the empty object to
+ * its decompressor, which refuses it. Where the frames fall depends on
+ * nothing but the bucket and the parameter, so the bytes sent are the
+ * same however many threads made them. */
+static pmix_status_t pack_bucket(pmix_byte_object_t *bo, const size_t *bounds,
+                                 size_t nbounds, pmix_buffer_t *bkt)
+{
+    size_t csize = pmix_server_globals.fence_compress_chunk;
+    pmix_byte_object_t outbo, empty;
+    pmix_compress_frame_t *frames = NULL;
+    size_t n, nframes = 0, start = 0;
+    bool compressed;
+    pmix_status_t rc;
+
+    if (0 < csize && bo->size > csize && 1 < nbounds) {
+        frames = (pmix_compress_frame_t *) calloc(nbounds, sizeof(*frames));
+        if (NULL == frames) {
+            return PMIX_ERR_NOMEM;
+        }
+        for (n = 0; n < nbounds; n++) {
+            if (bounds[n] - start >= csize || n == nbounds - 1) {
+                frames[nframes].bytes = (const uint8_t *) bo->bytes + start;
+                frames[nframes].size = bounds[n] - start;
+                ++nframes;
+                start = bounds[n];
             }
         }
-        return;
+        if (2 > nframes) {
+            /* one rank's blob is most of the bucket - nothing to cut */
+            free(frames);
+            frames = NULL;
+        }
     }
+
+    if (NULL == frames) {
+        // compress the data
+        if (pmix_compress.compress((uint8_t*)bo->bytes, bo->size, (uint8_t**)&outbo.bytes, &outbo.size)) {
+            compressed = true;
+            PMIX_BYTE_OBJECT_DESTRUCT(bo);
+            bo->bytes = outbo.bytes;
+            bo->size = outbo.size;
+        } else {
+            compressed = false;
+        }
+        // need to get the compressed flag inside the byte object we pass along
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, bkt, &compressed, 1, PMIX_BOOL);
+        if (PMIX_SUCCESS != rc) {
+            return rc;
+        }
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, bkt, bo, 1, PMIX_BYTE_OBJECT);
+        return rc;
+    }
+
+    /* The first frame is done here before any worker starts. With no
+     * compression component the base module's stub warns, once, and
+     * keeps the fact that it has in a plain global - so ask it here
+     * first, and the workers only ever find the warning given. */
+    (void) compress_frame(frames, 0);
+    (void) pmix_parallel_items(compress_frame, frames, 1, nframes,
+                               fence_nworkers(nframes - 1, 1));
+    PMIX_BYTE_OBJECT_CONSTRUCT(&outbo);
+    if (!pmix_compress_base_frames_build(frames, nframes, (uint8_t **) &outbo.bytes,
+                                         &outbo.size)) {
+        rc = PMIX_ERR_NOMEM;
+    } else {
+        compressed = true;
+        PMIX_BYTE_OBJECT_CONSTRUCT(&empty);
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, bkt, &compressed, 1, PMIX_BOOL);
+        if (PMIX_SUCCESS == rc) {
+            PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, bkt, &empty, 1, PMIX_BYTE_OBJECT);
+        }
+        if (PMIX_SUCCESS == rc) {
+            PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, bkt, &outbo, 1, PMIX_BYTE_OBJECT);
+        }
+        PMIX_BYTE_OBJECT_DESTRUCT(&outbo);
+    }
+    for (n = 0; n < nframes; n++) {
+        pmix_compress_base_frame_release(&frames[n]);
+    }
+    free(frames);
+    return rc;
 }
 
 pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
                                        pmix_buffer_t *buf)
 {
-    pmix_buffer_t bucket, bkt, *pbkt = NULL;
+    pmix_buffer_t bucket, bkt;
     pmix_cb_t cb;
-    pmix_kval_t *kv;
-    pmix_byte_object_t bo, outbo;
+    pmix_byte_object_t bo;
     pmix_server_caddy_t *scd;
-    pmix_proc_t pcs;
     pmix_status_t rc = PMIX_SUCCESS;
     pmix_list_t rank_blobs;
-    rank_blob_t *blob;
+    rank_blob_t *blob, **blobs;
     uint8_t blob_info_byte;
-    bool compressed;
     pmix_list_t pnames;
     pmix_namelist_t *pn;
     bool found;
     bool usedelta;
     uint64_t sig;
+    size_t n, nblobs;
+    /* where each packed item of the bucket ends - see pack_bucket() */
+    size_t *bounds = NULL, nbounds = 0;
 
     PMIX_CONSTRUCT(&bucket, pmix_buffer_t);
 
@@ -1163,6 +1463,8 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
             }
         }
 
+        /* First pass, on this thread: decide who contributes and gather
+         * what each will contribute. Nothing is packed yet. */
         PMIX_CONSTRUCT(&rank_blobs, pmix_list_t);
         PMIX_CONSTRUCT(&pnames, pmix_list_t);
         PMIX_LIST_FOREACH (scd, &trk->local_cbs, pmix_server_caddy_t) {
@@ -1183,105 +1485,76 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
                 continue;
             }
             pn = PMIX_NEW(pmix_namelist_t);
-            if (NULL == pn) {
+            blob = PMIX_NEW(rank_blob_t);
+            if (NULL == pn || NULL == blob) {
                 PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
                 rc = PMIX_ERR_NOMEM;
+                if (NULL != pn) {
+                    PMIX_RELEASE(pn);
+                }
+                if (NULL != blob) {
+                    PMIX_RELEASE(blob);
+                }
                 PMIX_LIST_DESTRUCT(&pnames);
                 PMIX_LIST_DESTRUCT(&rank_blobs);
                 goto cleanup;
             }
             pn->pname = &scd->peer->info->pname;
             pmix_list_append(&pnames, &pn->super);
-            /* get any remote contribution - note that there
-             * may not be a contribution */
-            PMIX_LOAD_PROCID(&pcs, scd->peer->info->pname.nspace, scd->peer->info->pname.rank);
-            pbkt = PMIX_NEW(pmix_buffer_t);
-            if (NULL == pbkt) {
-                /* the pack below screens a NULL buffer, but its error arm
-                 * then releases it - so catch this here */
-                PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
-                rc = PMIX_ERR_NOMEM;
-                PMIX_LIST_DESTRUCT(&pnames);
-                PMIX_LIST_DESTRUCT(&rank_blobs);
-                goto cleanup;
-            }
-            /* pack the rank */
-            PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, pbkt, &pcs, 1, PMIX_PROC);
-            if (PMIX_SUCCESS != rc) {
-                PMIX_ERROR_LOG(rc);
-                PMIX_LIST_DESTRUCT(&pnames);
-                PMIX_LIST_DESTRUCT(&rank_blobs);
-                PMIX_RELEASE(pbkt);
-                goto cleanup;
-            }
+            PMIX_LOAD_PROCID(&blob->proc, scd->peer->info->pname.nspace,
+                             scd->peer->info->pname.rank);
+            blob->info = scd->peer->info;
             if (usedelta) {
-                /* pack what this rank has committed since it last
-                 * contributed - an empty list is a legitimate answer,
-                 * and the receiver reads a proc with no kvals as "this
-                 * rank published nothing new" */
-                PMIX_LIST_FOREACH (kv, &scd->peer->info->pending_modex, pmix_kval_t) {
-                    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, pbkt, kv, 1, PMIX_KVAL);
-                    if (PMIX_SUCCESS != rc) {
-                        PMIX_ERROR_LOG(rc);
-                        PMIX_LIST_DESTRUCT(&pnames);
-                        PMIX_LIST_DESTRUCT(&rank_blobs);
-                        PMIX_RELEASE(pbkt);
-                        goto cleanup;
-                    }
-                }
-                if (PMIX_SUCCESS != pack_pending_deletes(scd->peer->info, pbkt)) {
-                    PMIX_ERROR_LOG(PMIX_ERR_PACK_FAILURE);
-                    PMIX_LIST_DESTRUCT(&pnames);
-                    PMIX_LIST_DESTRUCT(&rank_blobs);
-                    PMIX_RELEASE(pbkt);
-                    rc = PMIX_ERR_PACK_FAILURE;
-                    goto cleanup;
-                }
-                blob = PMIX_NEW(rank_blob_t);
-                blob->buf = pbkt;
+                /* what this rank has committed since it last contributed */
+                blob->kvs = &scd->peer->info->pending_modex;
                 pmix_list_append(&rank_blobs, &blob->super);
-                pbkt = NULL;
                 continue;
             }
+            /* get any remote contribution - note that there
+             * may not be a contribution */
             PMIX_CONSTRUCT(&cb, pmix_cb_t);
-            cb.proc = &pcs;
+            cb.proc = &blob->proc;
             cb.scope = PMIX_REMOTE;
             cb.copy = true;
             PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
             if (PMIX_SUCCESS == rc) {
-                /* pack the returned kval's */
-                PMIX_LIST_FOREACH (kv, &cb.kvs, pmix_kval_t) {
-                    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, pbkt, kv, 1, PMIX_KVAL);
-                    if (PMIX_SUCCESS != rc) {
-                        PMIX_ERROR_LOG(rc);
-                        PMIX_DESTRUCT(&cb);
-                        PMIX_LIST_DESTRUCT(&pnames);
-                        PMIX_LIST_DESTRUCT(&rank_blobs);
-                        PMIX_RELEASE(pbkt);
-                        goto cleanup;
-                    }
-                }
-                if (PMIX_SUCCESS != pack_pending_deletes(scd->peer->info, pbkt)) {
-                    PMIX_ERROR_LOG(PMIX_ERR_PACK_FAILURE);
-                    PMIX_DESTRUCT(&cb);
-                    PMIX_LIST_DESTRUCT(&pnames);
-                    PMIX_LIST_DESTRUCT(&rank_blobs);
-                    PMIX_RELEASE(pbkt);
-                    rc = PMIX_ERR_PACK_FAILURE;
-                    goto cleanup;
-                }
-                /* add the blob to the list */
-                blob = PMIX_NEW(rank_blob_t);
-                blob->buf = pbkt;
+                pmix_list_join(&blob->fetched, pmix_list_get_end(&blob->fetched), &cb.kvs);
+                blob->kvs = &blob->fetched;
                 pmix_list_append(&rank_blobs, &blob->super);
-                pbkt = NULL;
+            } else {
+                PMIX_RELEASE(blob);
             }
             PMIX_DESTRUCT(&cb);
-            if (NULL != pbkt) {
-                PMIX_RELEASE(pbkt);
-            }
         }
         PMIX_LIST_DESTRUCT(&pnames);
+
+        /* Second pass, shared out: pack each rank's blob */
+        nblobs = pmix_list_get_size(&rank_blobs);
+        blobs = NULL;
+        if (0 < nblobs) {
+            blobs = (rank_blob_t **) malloc(nblobs * sizeof(*blobs));
+            if (NULL == blobs) {
+                PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+                rc = PMIX_ERR_NOMEM;
+                PMIX_LIST_DESTRUCT(&rank_blobs);
+                goto cleanup;
+            }
+            n = 0;
+            PMIX_LIST_FOREACH (blob, &rank_blobs, rank_blob_t) {
+                blobs[n++] = blob;
+            }
+            /* a rank's kvals are a few dozen packs - too little to be
+             * worth a thread of its own */
+            rc = pmix_parallel_items(pack_rank_blob, blobs, 0, nblobs,
+                                     fence_nworkers(nblobs, 16));
+            free(blobs);
+            if (PMIX_SUCCESS != rc) {
+                PMIX_ERROR_LOG(rc);
+                PMIX_LIST_DESTRUCT(&rank_blobs);
+                goto cleanup;
+            }
+        }
+
         /* mark the collection type so we can check on the
          * receiving end that all participants did the same. Note
          * that if the receiving end thinks that the collect flag
@@ -1298,8 +1571,13 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
             PMIX_LIST_DESTRUCT(&rank_blobs);
             goto cleanup;
         }
+        bounds = (size_t *) malloc((nblobs + 1) * sizeof(*bounds));
+        if (NULL != bounds) {
+            bounds[nbounds++] = bucket.bytes_used;
+        }
 
-        /* pack the collected blobs of processes */
+        /* pack the collected blobs of processes, in participant order
+         * however they were packed */
         PMIX_LIST_FOREACH (blob, &rank_blobs, rank_blob_t) {
             /* extract the blob */
             PMIX_UNLOAD_BUFFER(blob->buf, bo.bytes, bo.size);
@@ -1315,6 +1593,9 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
                 PMIX_LIST_DESTRUCT(&rank_blobs);
                 goto cleanup;
             }
+            if (NULL != bounds) {
+                bounds[nbounds++] = bucket.bytes_used;
+            }
         }
         PMIX_LIST_DESTRUCT(&rank_blobs);
 
@@ -1342,25 +1623,8 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
          * in chunks, we have to pack the bucket as a single
          * byte object to allow remote unpack */
         PMIX_UNLOAD_BUFFER(&bucket, bo.bytes, bo.size);
-        // compress the data
-        if (pmix_compress.compress((uint8_t*)bo.bytes, bo.size, (uint8_t**)&outbo.bytes, &outbo.size)) {
-            compressed = true;
-            PMIX_BYTE_OBJECT_DESTRUCT(&bo);
-            bo.bytes = outbo.bytes;
-            bo.size = outbo.size;
-        } else {
-            compressed = false;
-        }
-        // need to get the compressed flag inside the byte object we pass along
         PMIX_CONSTRUCT(&bkt, pmix_buffer_t);
-        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &bkt, &compressed, 1, PMIX_BOOL);
-        if (PMIX_SUCCESS != rc) {
-            PMIX_ERROR_LOG(rc);
-            PMIX_BYTE_OBJECT_DESTRUCT(&bo);
-            PMIX_DESTRUCT(&bkt);
-            goto cleanup;
-        }
-        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &bkt, &bo, 1, PMIX_BYTE_OBJECT);
+        rc = pack_bucket(&bo, bounds, nbounds, &bkt);
         PMIX_BYTE_OBJECT_DESTRUCT(&bo); // releases the data
         if (PMIX_SUCCESS != rc) {
             PMIX_ERROR_LOG(rc);
@@ -1381,6 +1645,7 @@ pmix_status_t pmix_server_collect_data(pmix_server_trkr_t *trk,
     }
 
 cleanup:
+    free(bounds);
     PMIX_DESTRUCT(&bucket);
     return rc;
 }
@@ -1913,7 +2178,7 @@ void pmix_server_trk_peer_lost(pmix_peer_t *peer)
                                                    trk->ninfo, NULL, 0,
                                                    trk->modexcbfunc, trk);
                     if (PMIX_SUCCESS != rc) {
-                        pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+                        pmix_server_untrack_collective(trk);
                         PMIX_RELEASE(trk);
                     }
                 } else if (PMIX_CONNECTNB_CMD == trk->type) {
@@ -1921,7 +2186,7 @@ void pmix_server_trk_peer_lost(pmix_peer_t *peer)
                     rc = pmix_host_server.connect(trk->pcs, trk->npcs, trk->info,
                                                   trk->ninfo, trk->op_cbfunc, trk);
                     if (PMIX_SUCCESS != rc) {
-                        pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+                        pmix_server_untrack_collective(trk);
                         PMIX_RELEASE(trk);
                     }
                 } else if (PMIX_DISCONNECTNB_CMD == trk->type) {
@@ -1929,7 +2194,7 @@ void pmix_server_trk_peer_lost(pmix_peer_t *peer)
                     rc = pmix_host_server.disconnect(trk->pcs, trk->npcs, trk->info,
                                                      trk->ninfo, trk->op_cbfunc, trk);
                     if (PMIX_SUCCESS != rc) {
-                        pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+                        pmix_server_untrack_collective(trk);
                         PMIX_RELEASE(trk);
                     }
                 }
@@ -29,6 +29,8 @@
 #    include <string.h>
 #endif
 #include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
 #ifdef HAVE_UNISTD_H
 #    include <unistd.h>
 #endif
@@ -107,19 +109,154 @@ static void relfn(void *cbdata)
     }
 }
 
-/* Is this tracker still on the pending list? A tracker handed to the host
- * for a direct modex carries a reference of its own, so it outlives being
- * retired - but a retired tracker must not be resolved or removed again. */
-static bool tracker_is_pending(pmix_dmdx_local_t *lcd)
+/* Pending trackers are filed in pmix_server_globals.local_reqs_index
+ * under their (nspace, rank) as well as sitting on local_reqs. Finding
+ * the tracker for a target used to be a walk of the whole list - on
+ * every get that missed, and again on every commit and every arrival of
+ * remote data - which is cheap with a handful of outstanding requests
+ * and quadratic in a connection storm, when every local client is asking
+ * after hundreds of remote procs at once and each answer rescans all
+ * the questions still open.
+ *
+ * There is only ever one tracker per target: create_local_tracker parks
+ * a second requester on the tracker already there, and a prefetch is
+ * never made for a target that has one. So a lookup wants exactly one
+ * tracker, and trackers chained through index_next under the same key
+ * are hash collisions between different targets - each candidate is
+ * still compared in full. A tracker is on the list if and only if it is
+ * in the index: one that cannot be filed is not tracked at all.
+ *
+ * The list walk matched on PMIX_CHECK_NSPACE, under which a nspace that
+ * is not set matches every nspace. A key cannot do that, so trackers
+ * without one are filed under the empty nspace and looked for there as
+ * well, and a request without one falls back to the walk. */
+
+/* FNV-1a over at most max bytes of a string */
+static uint64_t hash_str(uint64_t h, const char *s, size_t max)
+{
+    const unsigned char *p = (const unsigned char *) ((NULL == s) ? "" : s);
+    size_t n;
+
+    for (n = 0; n < max && '\0' != p[n]; n++) {
+        h ^= (uint64_t) p[n];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/* the splitmix64 finalizer, so keys differing in a few low bits spread out */
+static uint64_t mix_key(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+static uint64_t local_key(const char *nspace, pmix_rank_t rank)
+{
+    uint64_t h = 14695981039346656037ULL; /* FNV-1a 64-bit offset basis */
+
+    /* no further than PMIX_CHECK_NSPACE compares */
+    h = hash_str(h, nspace, PMIX_MAX_NSLEN);
+    return mix_key(h ^ (uint64_t) rank);
+}
+
+/* The tracker filed under exactly this nspace and rank */
+static pmix_dmdx_local_t *lookup_local(const char *nspace, pmix_rank_t rank)
+{
+    pmix_dmdx_local_t *cd = NULL;
+
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.local_reqs_index,
+                                            local_key(nspace, rank), (void **) &cd);
+    while (NULL != cd) {
+        if (0 == strncmp(nspace, cd->proc.nspace, PMIX_MAX_NSLEN) && rank == cd->proc.rank) {
+            return cd;
+        }
+        cd = cd->index_next;
+    }
+    return NULL;
+}
+
+/* The tracker waiting on this target, as PMIX_CHECK_NSPACE matches it */
+static pmix_dmdx_local_t *find_local_tracker(const char *nspace, pmix_rank_t rank)
 {
     pmix_dmdx_local_t *cd;
 
-    PMIX_LIST_FOREACH (cd, &pmix_server_globals.local_reqs, pmix_dmdx_local_t) {
-        if (cd == lcd) {
-            return true;
+    if (PMIX_NSPACE_INVALID(nspace)) {
+        PMIX_LIST_FOREACH (cd, &pmix_server_globals.local_reqs, pmix_dmdx_local_t) {
+            if (rank == cd->proc.rank) {
+                return cd;
+            }
+        }
+        return NULL;
+    }
+    cd = lookup_local(nspace, rank);
+    if (NULL == cd) {
+        cd = lookup_local("", rank);
+    }
+    return cd;
+}
+
+static pmix_status_t track_local(pmix_dmdx_local_t *lcd)
+{
+    pmix_dmdx_local_t *head = NULL;
+    pmix_status_t rc;
+
+    lcd->index_key = local_key(lcd->proc.nspace, lcd->proc.rank);
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.local_reqs_index,
+                                            lcd->index_key, (void **) &head);
+    lcd->index_next = head;
+    rc = pmix_hash_table_set_value_uint64(&pmix_server_globals.local_reqs_index,
+                                          lcd->index_key, lcd);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_ERROR_LOG(rc);
+        lcd->index_next = NULL;
+        return rc;
+    }
+    lcd->indexed = true;
+    pmix_list_append(&pmix_server_globals.local_reqs, &lcd->super);
+    return PMIX_SUCCESS;
+}
+
+static void untrack_local(pmix_dmdx_local_t *lcd)
+{
+    pmix_dmdx_local_t *prev = NULL;
+
+    if (!lcd->indexed) {
+        return;
+    }
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.local_reqs_index,
+                                            lcd->index_key, (void **) &prev);
+    if (prev == lcd) {
+        if (NULL != lcd->index_next) {
+            pmix_hash_table_set_value_uint64(&pmix_server_globals.local_reqs_index,
+                                             lcd->index_key, lcd->index_next);
+        } else {
+            pmix_hash_table_remove_value_uint64(&pmix_server_globals.local_reqs_index,
+                                                lcd->index_key);
+        }
+    } else {
+        while (NULL != prev && prev->index_next != lcd) {
+            prev = prev->index_next;
+        }
+        if (NULL != prev) {
+            prev->index_next = lcd->index_next;
         }
     }
-    return false;
+    lcd->indexed = false;
+    lcd->index_next = NULL;
+    pmix_list_remove_item(&pmix_server_globals.local_reqs, &lcd->super);
+}
+
+/* Is this tracker still on the pending list? A tracker handed to the host
+ * for a direct modex carries a reference of its own, so it outlives being
+ * retired - but a retired tracker must not be resolved or removed again. */
+static bool tracker_is_pending(pmix_dmdx_local_t *lcd)
+{
+    return lcd->indexed;
 }
 
 /* Discard a local dmodex tracker that we created for a request we then
@@ -138,7 +275,7 @@ static void discard_local_tracker(pmix_dmdx_local_t *lcd)
     while (NULL != (req = (pmix_dmdx_request_t *) pmix_list_remove_first(&lcd->loc_reqs))) {
         PMIX_RELEASE(req);
     }
-    pmix_list_remove_item(&pmix_server_globals.local_reqs, &lcd->super);
+    untrack_local(lcd);
     PMIX_RELEASE(lcd);
 }
 
@@ -159,10 +296,700 @@ void pmix_server_fail_local_reqs(pmix_dmdx_local_t *lcd, pmix_status_t status)
         }
         PMIX_RELEASE(req);
     }
-    pmix_list_remove_item(&pmix_server_globals.local_reqs, &lcd->super);
+    untrack_local(lcd);
     PMIX_RELEASE(lcd);
 }
 
+/* Gathering direct-modex requests.
+ *
+ * In a connection storm every local client asks after many remote procs
+ * at once, and each missing target has been its own direct_modex up-call
+ * - its own trip through the host and across the network - even when a
+ * dozen of them live on the same node and the host ends up talking to the
+ * same remote daemon a dozen times over. A host that declared
+ * PMIX_SERVER_DMODEX_BATCH at init can take such requests together: a
+ * request for a target whose node we know is held for up to
+ * dmodex_batch_window usec waiting for others bound for the same node and
+ * namespace (the host addresses requests by namespace, so we do not mix
+ * them), or until dmodex_batch_max have gathered, and they then go up as a
+ * single call carrying PMIX_DMODEX_BATCH. The reply is taken apart here
+ * and each piece handed to dmdx_cbfunc exactly as a reply to its own
+ * request would have been, so nothing downstream can tell the difference.
+ *
+ * A target whose node we do not know - a namespace we hold no map for -
+ * is asked for on its own straight away: grouping it with anything would
+ * be a guess. So is a batch that gathered only one target, and so is
+ * every target of a batch the host refused, or whose reply left it out.
+ * A host that never declared the attribute sees exactly the up-calls it
+ * always has.
+ *
+ * Open batches are filed in pmix_server_globals.dmodex_batches_index
+ * under their (nspace, node) as well as sitting on dmodex_batches, the
+ * same way pending trackers are: with requests for every node of a large
+ * job in flight, finding the batch for a target was otherwise a walk of
+ * all of them for each request. There is one open batch per nspace and
+ * node, batches chained under the same key are hash collisions, and a
+ * batch leaves the index when it leaves the list - when it is sent. */
+typedef struct pmix_dmdx_batch_t {
+    pmix_list_item_t super;
+    pmix_event_t ev;
+    bool timer_active;
+    pmix_nspace_t nspace;
+    char *hostname;
+    /* its key in dmodex_batches_index, and the next batch filed there */
+    uint64_t index_key;
+    struct pmix_dmdx_batch_t *index_next;
+    /* the trackers waiting on this batch - one reference held on each */
+    pmix_dmdx_local_t **lcds;
+    size_t nlcds;
+    size_t size;
+    /* the directives of the up-call, kept until the host answers */
+    pmix_info_t *info;
+    size_t ninfo;
+    /* the host's reply, held across the thread-shift */
+    pmix_status_t status;
+    const char *data;
+    size_t ndata;
+    pmix_release_cbfunc_t relfn;
+    void *relcbdata;
+} pmix_dmdx_batch_t;
+static void dbcon(pmix_dmdx_batch_t *p)
+{
+    p->timer_active = false;
+    memset(p->nspace, 0, sizeof(pmix_nspace_t));
+    p->hostname = NULL;
+    p->index_key = 0;
+    p->index_next = NULL;
+    p->lcds = NULL;
+    p->nlcds = 0;
+    p->size = 0;
+    p->info = NULL;
+    p->ninfo = 0;
+    p->status = PMIX_ERROR;
+    p->data = NULL;
+    p->ndata = 0;
+    p->relfn = NULL;
+    p->relcbdata = NULL;
+}
+static void dbdes(pmix_dmdx_batch_t *p)
+{
+    size_t n;
+
+    if (p->timer_active) {
+        pmix_event_del(&p->ev);
+    }
+    for (n = 0; n < p->nlcds; n++) {
+        PMIX_RELEASE(p->lcds[n]);
+    }
+    if (NULL != p->lcds) {
+        free(p->lcds);
+    }
+    if (NULL != p->hostname) {
+        free(p->hostname);
+    }
+    if (NULL != p->info) {
+        PMIX_INFO_FREE(p->info, p->ninfo);
+    }
+}
+static PMIX_CLASS_INSTANCE(pmix_dmdx_batch_t, pmix_list_item_t, dbcon, dbdes);
+
+static void batch_send(pmix_dmdx_batch_t *batch);
+static void prefetch_forget(const pmix_proc_t *proc);
+
+/* Hand one tracker to the host's direct_modex on its own. The host holds
+ * this pointer until it calls dmdx_cbfunc, and the tracker can be retired
+ * out from under it in the meantime - a namespace deregistration for the
+ * target retires every tracker naming it - so take a reference for the
+ * host to hold, and give it back if the host refuses. */
+static pmix_status_t host_upcall(pmix_dmdx_local_t *lcd)
+{
+    pmix_status_t rc;
+
+    PMIX_RETAIN(lcd);
+    rc = pmix_host_server.direct_modex(&lcd->proc, lcd->info, lcd->ninfo, dmdx_cbfunc, lcd);
+    /* this up-call's entire product is a data blob delivered through
+     * dmdx_cbfunc, so an atomic "success" carrying nothing cannot be
+     * acted on - say so rather than treating it as a bare refusal */
+    if (PMIX_UNLIKELY(PMIX_OPERATION_SUCCEEDED == rc)) {
+        pmix_show_help("help-pmix-server.txt", "atomic-completion-unsupported",
+                       true, "direct_modex");
+        rc = PMIX_ERR_NOT_SUPPORTED;
+    }
+    if (PMIX_SUCCESS != rc) {
+        /* may have a function entry but not support the request - it
+         * will not call us back, so give the reference back */
+        PMIX_RELEASE(lcd);
+    }
+    return rc;
+}
+
+/* Ask a tracker that has gone into a batch for its data on its own. By
+ * now the caller that created it has returned, so a refusal is reported
+ * to the parked requesters here rather than to it. A tracker retired
+ * while it waited has nobody left to answer. */
+static void host_upcall_deferred(pmix_dmdx_local_t *lcd)
+{
+    if (!tracker_is_pending(lcd)) {
+        return;
+    }
+    /* a fetch nobody has asked for yet is only worth making alongside
+     * one somebody has - see prefetch_node */
+    if (lcd->prefetch && 0 == pmix_list_get_size(&lcd->loc_reqs)) {
+        prefetch_forget(&lcd->proc);
+        pmix_server_fail_local_reqs(lcd, PMIX_ERR_NOT_FOUND);
+        return;
+    }
+    if (PMIX_SUCCESS != host_upcall(lcd)) {
+        pmix_server_fail_local_reqs(lcd, PMIX_ERR_NOT_FOUND);
+    }
+}
+
+/* The node the target runs on, if we hold a map that says */
+static char *target_host(const pmix_proc_t *proc)
+{
+    pmix_cb_t cb;
+    pmix_info_t optional;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    char *host = NULL;
+
+    PMIX_INFO_LOAD(&optional, PMIX_OPTIONAL, NULL, PMIX_BOOL);
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    cb.proc = (pmix_proc_t *) proc;
+    cb.key = PMIX_HOSTNAME;
+    cb.info = &optional;
+    cb.ninfo = 1;
+    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    if (PMIX_SUCCESS == rc || PMIX_OPERATION_SUCCEEDED == rc) {
+        kv = (pmix_kval_t *) pmix_list_get_first(&cb.kvs);
+        if (kv != (pmix_kval_t *) pmix_list_get_end(&cb.kvs) && NULL != kv->value
+            && PMIX_STRING == kv->value->type && NULL != kv->value->data.string) {
+            host = strdup(kv->value->data.string);
+        }
+    }
+    cb.key = NULL;
+    PMIX_DESTRUCT(&cb);
+    PMIX_INFO_DESTRUCT(&optional);
+    return host;
+}
+
+static void batch_timeout(int sd, short args, void *cbdata)
+{
+    pmix_dmdx_batch_t *batch = (pmix_dmdx_batch_t *) cbdata;
+    PMIX_HIDE_UNUSED_PARAMS(sd, args);
+
+    batch->timer_active = false;
+    batch_send(batch);
+}
+
+/* Can requests be gathered at all? */
+static bool batching(void)
+{
+    return (pmix_server_globals.dmodex_batch && 0 < pmix_server_globals.dmodex_batch_window
+            && 2 <= pmix_server_globals.dmodex_batch_max);
+}
+
+static uint64_t batch_key(const char *nspace, const char *host)
+{
+    uint64_t h = 14695981039346656037ULL; /* FNV-1a 64-bit offset basis */
+
+    h = hash_str(h, nspace, PMIX_MAX_NSLEN);
+    /* a zero byte between them, so "ab"+"c" and "a"+"bc" differ */
+    h *= 1099511628211ULL;
+    h = hash_str(h, host, SIZE_MAX);
+    return mix_key(h);
+}
+
+/* The batch open for procs of this namespace on this node, if any. A
+ * batch is only ever opened for a target with a nspace - see
+ * request_from_host - so the key is exact */
+static pmix_dmdx_batch_t *open_batch(const char *nspace, const char *host)
+{
+    pmix_dmdx_batch_t *batch = NULL;
+
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                            batch_key(nspace, host), (void **) &batch);
+    while (NULL != batch) {
+        if (0 == strncmp(batch->nspace, nspace, PMIX_MAX_NSLEN)
+            && 0 == strcmp(batch->hostname, host)) {
+            return batch;
+        }
+        batch = batch->index_next;
+    }
+    return NULL;
+}
+
+static pmix_status_t file_batch(pmix_dmdx_batch_t *batch)
+{
+    pmix_dmdx_batch_t *head = NULL;
+    pmix_status_t rc;
+
+    batch->index_key = batch_key(batch->nspace, batch->hostname);
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                            batch->index_key, (void **) &head);
+    batch->index_next = head;
+    rc = pmix_hash_table_set_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                          batch->index_key, batch);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_ERROR_LOG(rc);
+        batch->index_next = NULL;
+        return rc;
+    }
+    pmix_list_append(&pmix_server_globals.dmodex_batches, &batch->super);
+    return PMIX_SUCCESS;
+}
+
+static void unfile_batch(pmix_dmdx_batch_t *batch)
+{
+    pmix_dmdx_batch_t *prev = NULL;
+
+    (void) pmix_hash_table_get_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                            batch->index_key, (void **) &prev);
+    if (prev == batch) {
+        if (NULL != batch->index_next) {
+            pmix_hash_table_set_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                             batch->index_key, batch->index_next);
+        } else {
+            pmix_hash_table_remove_value_uint64(&pmix_server_globals.dmodex_batches_index,
+                                                batch->index_key);
+        }
+    } else {
+        while (NULL != prev && prev->index_next != batch) {
+            prev = prev->index_next;
+        }
+        if (NULL != prev) {
+            prev->index_next = batch->index_next;
+        }
+    }
+    batch->index_next = NULL;
+    pmix_list_remove_item(&pmix_server_globals.dmodex_batches, &batch->super);
+}
+
+/* Put a tracker into the open batch for "host", the node its target runs
+ * on, opening one if need be. Returns false if that could not be done,
+ * leaving the caller to ask for the tracker on its own. */
+static bool batch_add(pmix_dmdx_local_t *lcd, const char *host)
+{
+    pmix_dmdx_batch_t *batch;
+    struct timeval tv;
+
+    batch = open_batch(lcd->proc.nspace, host);
+    if (NULL == batch) {
+        batch = PMIX_NEW(pmix_dmdx_batch_t);
+        if (NULL == batch) {
+            return false;
+        }
+        batch->hostname = strdup(host);
+        /* the cap is read once per batch so the array cannot be outgrown
+         * should the parameter change while it is open */
+        batch->size = pmix_server_globals.dmodex_batch_max;
+        batch->lcds = (pmix_dmdx_local_t **) calloc(batch->size, sizeof(pmix_dmdx_local_t *));
+        if (NULL == batch->hostname || NULL == batch->lcds) {
+            PMIX_RELEASE(batch);
+            return false;
+        }
+        PMIX_LOAD_NSPACE(batch->nspace, lcd->proc.nspace);
+        if (PMIX_SUCCESS != file_batch(batch)) {
+            PMIX_RELEASE(batch);
+            return false;
+        }
+        tv.tv_sec = pmix_server_globals.dmodex_batch_window / 1000000;
+        tv.tv_usec = pmix_server_globals.dmodex_batch_window % 1000000;
+        pmix_event_evtimer_set(pmix_globals.evbase, &batch->ev, batch_timeout, batch);
+        pmix_event_evtimer_add(&batch->ev, &tv);
+        batch->timer_active = true;
+    }
+    PMIX_RETAIN(lcd);
+    batch->lcds[batch->nlcds++] = lcd;
+    if (batch->nlcds == batch->size) {
+        batch_send(batch);
+    }
+    return true;
+}
+
+/* Fetching ahead.
+ *
+ * Communicators are usually laid out node by node, so a process that asks
+ * for one rank on a remote node is likely to ask for that rank's
+ * neighbours next - and each of those has been another round trip. With
+ * pmix_server_dmodex_prefetch set, a request for a rank that goes into a
+ * batch brings the other ranks on the same node (its PMIX_LOCAL_PEERS,
+ * from the job map) into the batch with it, each on a tracker of its own
+ * marked "prefetch" that nobody is waiting on. Their data comes back in
+ * the same reply and _process_dmdx_reply puts it in our own store, where
+ * a later request finds it without going to the host; a request that
+ * arrives while it is still on its way simply joins the tracker.
+ *
+ * Nothing is fetched ahead unless it shares the round trip of a request
+ * somebody made. Without a host that takes batches there is none to
+ * share; the peers only fill the room left in the target's own batch; and
+ * a prefetch tracker whose batch the host refused, or whose reply left it
+ * out, is dropped rather than asked for on its own. Ranks whose data we
+ * hold or have already asked for are skipped.
+ *
+ * A namespace's "prefetched" bitmap marks the ranks fetched ahead that
+ * nobody has asked for yet. The first request for one clears its bit and
+ * counts a hit; the counts are reported at finalize so the option can be
+ * judged per workload. */
+static void prefetch_forget(const pmix_proc_t *proc)
+{
+    pmix_namespace_t *nptr;
+
+    if (INT_MAX < proc->rank) {
+        return;
+    }
+    nptr = pmix_nspace_lookup(proc->nspace);
+    if (NULL != nptr && pmix_bitmap_is_set_bit(&nptr->prefetched, (int) proc->rank)) {
+        pmix_bitmap_clear_bit(&nptr->prefetched, (int) proc->rank);
+    }
+}
+
+/* a request for this rank has arrived - count it if we fetched it ahead */
+static void prefetch_taken(pmix_namespace_t *nptr, pmix_rank_t rank)
+{
+    if (INT_MAX < rank || !pmix_bitmap_is_set_bit(&nptr->prefetched, (int) rank)) {
+        return;
+    }
+    pmix_bitmap_clear_bit(&nptr->prefetched, (int) rank);
+    pmix_server_globals.dmodex_prefetch_hits++;
+}
+
+/* The ranks of the namespace on the given node, as the job map gives them */
+static char **node_peers(const char *nspace, const char *host)
+{
+    pmix_cb_t cb;
+    pmix_info_t info[3];
+    pmix_proc_t proc;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    char **peers = NULL;
+    size_t n;
+
+    /* only what we already hold - never ask the host from in here */
+    PMIX_INFO_LOAD(&info[0], PMIX_OPTIONAL, NULL, PMIX_BOOL);
+    PMIX_INFO_LOAD(&info[1], PMIX_NODE_INFO, NULL, PMIX_BOOL);
+    PMIX_INFO_LOAD(&info[2], PMIX_HOSTNAME, host, PMIX_STRING);
+    PMIX_LOAD_PROCID(&proc, nspace, PMIX_RANK_UNDEF);
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    cb.proc = &proc;
+    cb.key = PMIX_LOCAL_PEERS;
+    cb.scope = PMIX_INTERNAL;
+    cb.info = info;
+    cb.ninfo = 3;
+    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    if (PMIX_SUCCESS != rc) {
+        /* an older peer records these at job level - see
+         * pmix_server_locally_resolve_peers */
+        while (NULL != (kv = (pmix_kval_t *) pmix_list_remove_first(&cb.kvs))) {
+            PMIX_RELEASE(kv);
+        }
+        proc.rank = PMIX_RANK_WILDCARD;
+        PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    }
+    if (PMIX_SUCCESS == rc) {
+        kv = (pmix_kval_t *) pmix_list_get_first(&cb.kvs);
+        if (kv != (pmix_kval_t *) pmix_list_get_end(&cb.kvs) && NULL != kv->value
+            && PMIX_STRING == kv->value->type && NULL != kv->value->data.string) {
+            peers = PMIx_Argv_split(kv->value->data.string, ',');
+        }
+    }
+    cb.key = NULL;
+    PMIX_DESTRUCT(&cb);
+    for (n = 0; n < 3; n++) {
+        PMIX_INFO_DESTRUCT(&info[n]);
+    }
+    return peers;
+}
+
+/* Do we already hold modex data for this proc? */
+static bool data_held(pmix_proc_t *proc)
+{
+    pmix_cb_t cb;
+    pmix_status_t rc;
+    bool held;
+
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    cb.proc = proc;
+    cb.scope = PMIX_REMOTE;
+    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    held = (PMIX_SUCCESS == rc && 0 < pmix_list_get_size(&cb.kvs));
+    PMIX_DESTRUCT(&cb);
+    return held;
+}
+
+/* Bring the node peers of a tracker's target into the batch it has just
+ * gone into, as far as the batch has room for them */
+static void prefetch_node(pmix_dmdx_local_t *lcd, const char *host)
+{
+    pmix_namespace_t *nptr;
+    pmix_dmdx_batch_t *batch;
+    pmix_dmdx_local_t *pf;
+    pmix_proc_t proc;
+    char **peers, *end;
+    unsigned long r;
+    size_t n, room;
+
+    nptr = pmix_nspace_lookup(lcd->proc.nspace);
+    batch = open_batch(lcd->proc.nspace, host);
+    /* a batch the target filled has already gone */
+    if (NULL == nptr || NULL == batch) {
+        return;
+    }
+    room = batch->size - batch->nlcds;
+    peers = node_peers(lcd->proc.nspace, host);
+    if (NULL == peers) {
+        return;
+    }
+    for (n = 0; NULL != peers[n] && 0 < room; n++) {
+        r = strtoul(peers[n], &end, 10);
+        if (end == peers[n] || '\0' != *end || INT_MAX < r || lcd->proc.rank == r
+            || pmix_bitmap_is_set_bit(&nptr->prefetched, (int) r)) {
+            continue;
+        }
+        PMIX_LOAD_PROCID(&proc, lcd->proc.nspace, (pmix_rank_t) r);
+        if (NULL != find_local_tracker(proc.nspace, proc.rank) || data_held(&proc)) {
+            continue;
+        }
+        pf = PMIX_NEW(pmix_dmdx_local_t);
+        if (NULL == pf) {
+            break;
+        }
+        memcpy(&pf->proc, &proc, sizeof(pmix_proc_t));
+        pf->prefetch = true;
+        if (PMIX_SUCCESS != track_local(pf)) {
+            PMIX_RELEASE(pf);
+            break;
+        }
+        /* mark it first: a batch this fills goes up at once, and if the
+         * host refuses it the tracker is dropped - and unmarked - before
+         * batch_add returns */
+        pmix_bitmap_set_bit(&nptr->prefetched, (int) r);
+        pmix_server_globals.dmodex_prefetched++;
+        if (!batch_add(pf, host)) {
+            pmix_bitmap_clear_bit(&nptr->prefetched, (int) r);
+            pmix_server_globals.dmodex_prefetched--;
+            untrack_local(pf);
+            PMIX_RELEASE(pf);
+            break;
+        }
+        --room;
+    }
+    PMIx_Argv_free(peers);
+}
+
+/* Ask the host for a tracker's data - through a batch if this one can go
+ * in one, otherwise on its own. A tracker that went into a batch counts
+ * as asked for: anything that goes wrong from there is reported to its
+ * requesters when the batch goes up or comes back. */
+static pmix_status_t request_from_host(pmix_dmdx_local_t *lcd)
+{
+    char *host;
+
+    if (!batching() || PMIX_RANK_WILDCARD == lcd->proc.rank
+        || PMIX_RANK_UNDEF == lcd->proc.rank || PMIX_NSPACE_INVALID(lcd->proc.nspace)) {
+        return host_upcall(lcd);
+    }
+    host = target_host(&lcd->proc);
+    if (NULL == host) {
+        return host_upcall(lcd);
+    }
+    if (!batch_add(lcd, host)) {
+        free(host);
+        return host_upcall(lcd);
+    }
+    if (pmix_server_globals.dmodex_prefetch) {
+        prefetch_node(lcd, host);
+    }
+    free(host);
+    return PMIX_SUCCESS;
+}
+
+static void batch_cbfunc(pmix_status_t status, const char *data, size_t ndata, void *cbdata,
+                         pmix_release_cbfunc_t release_fn, void *release_cbdata);
+
+static void batch_send(pmix_dmdx_batch_t *batch)
+{
+    pmix_data_array_t *targets, *tgt;
+    pmix_info_t *tinfo, *iptr;
+    pmix_dmdx_local_t *lcd;
+    pmix_status_t rc;
+    size_t n, m;
+
+    unfile_batch(batch);
+    if (batch->timer_active) {
+        pmix_event_del(&batch->ev);
+        batch->timer_active = false;
+    }
+    if (1 == batch->nlcds) {
+        goto singly;
+    }
+
+    pmix_output_verbose(2, pmix_server_globals.get_output,
+                        "%s:%d sending dmdx batch of %lu for %s on %s",
+                        pmix_globals.myid.nspace, pmix_globals.myid.rank,
+                        (unsigned long) batch->nlcds, batch->nspace, batch->hostname);
+
+    PMIX_INFO_CREATE(batch->info, 1);
+    if (NULL == batch->info) {
+        goto singly;
+    }
+    batch->ninfo = 1;
+    PMIX_DATA_ARRAY_CREATE(targets, batch->nlcds, PMIX_INFO);
+    if (NULL == targets) {
+        goto singly;
+    }
+    (void) strncpy(batch->info[0].key, PMIX_DMODEX_BATCH, PMIX_MAX_KEYLEN);
+    batch->info[0].value.type = PMIX_DATA_ARRAY;
+    batch->info[0].value.data.darray = targets;
+    tinfo = (pmix_info_t *) targets->array;
+    for (n = 0; n < batch->nlcds; n++) {
+        lcd = batch->lcds[n];
+        PMIX_DATA_ARRAY_CREATE(tgt, 1 + lcd->ninfo, PMIX_INFO);
+        if (NULL == tgt) {
+            goto singly;
+        }
+        (void) strncpy(tinfo[n].key, PMIX_DMODEX_TARGET, PMIX_MAX_KEYLEN);
+        tinfo[n].value.type = PMIX_DATA_ARRAY;
+        tinfo[n].value.data.darray = tgt;
+        iptr = (pmix_info_t *) tgt->array;
+        PMIX_INFO_LOAD(&iptr[0], PMIX_PROCID, &lcd->proc, PMIX_PROC);
+        for (m = 0; m < lcd->ninfo; m++) {
+            PMIX_INFO_XFER(&iptr[1 + m], &lcd->info[m]);
+        }
+    }
+
+    /* the batch is the host's to hold until it calls batch_cbfunc */
+    rc = pmix_host_server.direct_modex(&batch->lcds[0]->proc, batch->info, batch->ninfo,
+                                       batch_cbfunc, batch);
+    if (PMIX_SUCCESS == rc) {
+        return;
+    }
+    if (PMIX_UNLIKELY(PMIX_OPERATION_SUCCEEDED == rc)) {
+        pmix_show_help("help-pmix-server.txt", "atomic-completion-unsupported",
+                       true, "direct_modex");
+    }
+
+singly:
+    for (n = 0; n < batch->nlcds; n++) {
+        host_upcall_deferred(batch->lcds[n]);
+    }
+    PMIX_RELEASE(batch);
+}
+
+/* Take a batch reply apart on our own progress thread. Each target the
+ * reply answers is handed to dmdx_cbfunc with its own copy of the data,
+ * just as the host would have handed it had it been asked singly. */
+static void batch_reply(int sd, short args, void *cbdata)
+{
+    pmix_dmdx_batch_t *batch = (pmix_dmdx_batch_t *) cbdata;
+    pmix_buffer_t pbkt;
+    pmix_proc_t proc;
+    pmix_status_t rc, st;
+    pmix_byte_object_t bo;
+    int32_t cnt;
+    bool *answered = NULL;
+    size_t n;
+    PMIX_HIDE_UNUSED_PARAMS(sd, args);
+
+    PMIX_ACQUIRE_OBJECT(batch);
+
+    if (PMIX_SUCCESS != batch->status) {
+        /* the host says the lot failed - tell each tracker so, the same
+         * way it would have been told on its own */
+        for (n = 0; n < batch->nlcds; n++) {
+            PMIX_RETAIN(batch->lcds[n]);
+            dmdx_cbfunc(batch->status, NULL, 0, batch->lcds[n], NULL, NULL);
+        }
+        goto done;
+    }
+
+    answered = (bool *) calloc(batch->nlcds, sizeof(bool));
+    if (NULL == answered) {
+        PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+        for (n = 0; n < batch->nlcds; n++) {
+            PMIX_RETAIN(batch->lcds[n]);
+            dmdx_cbfunc(PMIX_ERR_NOMEM, NULL, 0, batch->lcds[n], NULL, NULL);
+        }
+        goto done;
+    }
+
+    /* the host's data stays the host's - we only read it */
+    PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
+    PMIX_LOAD_BUFFER_NON_DESTRUCT(pmix_globals.mypeer, &pbkt, batch->data, batch->ndata);
+    while (1) {
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, &proc, &cnt, PMIX_PROC);
+        if (PMIX_SUCCESS != rc) {
+            break;
+        }
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, &st, &cnt, PMIX_STATUS);
+        if (PMIX_SUCCESS != rc) {
+            break;
+        }
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, &bo, &cnt, PMIX_BYTE_OBJECT);
+        if (PMIX_SUCCESS != rc) {
+            break;
+        }
+        for (n = 0; n < batch->nlcds; n++) {
+            if (!answered[n] && PMIX_CHECK_PROCID(&proc, &batch->lcds[n]->proc)) {
+                break;
+            }
+        }
+        if (n == batch->nlcds) {
+            /* not one we asked for, or one already answered */
+            PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+            continue;
+        }
+        answered[n] = true;
+        PMIX_RETAIN(batch->lcds[n]);
+        dmdx_cbfunc(st, bo.bytes, bo.size, batch->lcds[n], relfn, bo.bytes);
+    }
+    if (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
+        PMIX_ERROR_LOG(rc);
+    }
+    pbkt.base_ptr = NULL;
+    PMIX_DESTRUCT(&pbkt);
+
+    /* whatever the reply left out - or could not be read past - is asked
+     * for again on its own rather than left waiting */
+    for (n = 0; n < batch->nlcds; n++) {
+        if (!answered[n]) {
+            host_upcall_deferred(batch->lcds[n]);
+        }
+    }
+    free(answered);
+
+done:
+    if (NULL != batch->relfn) {
+        batch->relfn(batch->relcbdata);
+    }
+    PMIX_RELEASE(batch);
+}
+
+/* the host's answer to a batched direct_modex */
+static void batch_cbfunc(pmix_status_t status, const char *data, size_t ndata, void *cbdata,
+                         pmix_release_cbfunc_t release_fn, void *release_cbdata)
+{
+    pmix_dmdx_batch_t *batch = (pmix_dmdx_batch_t *) cbdata;
+
+    if (pmix_atomic_check_bool(&pmix_globals.progress_thread_stopped)) {
+        if (NULL != release_fn) {
+            release_fn(release_cbdata);
+        }
+        PMIX_RELEASE(batch);
+        return;
+    }
+    batch->status = status;
+    batch->data = data;
+    batch->ndata = ndata;
+    batch->relfn = release_fn;
+    batch->relcbdata = release_cbdata;
+    /* the host may be calling from its own thread */
+    PMIX_THREADSHIFT(batch, batch_reply);
+}
+
 static pmix_status_t defer_response(char *nspace, pmix_rank_t rank, char *key,
                                     pmix_server_caddy_t *cd, bool localonly,
                                     pmix_modex_cbfunc_t cbfunc, void *cbdata,
@@ -212,7 +1039,7 @@ pmix_status_t pmix_server_get(pmix_buffer_t *buf, pmix_modex_cbfunc_t cbfunc, vo
     pmix_rank_t rank;
     char *cptr, *key = NULL;
     char nspace[PMIX_MAX_NSLEN + 1];
-    pmix_namespace_t *ns, *nptr;
+    pmix_namespace_t *nptr;
     pmix_dmdx_local_t *lcd;
     bool local = false;
     bool localonly = false;
@@ -220,7 +1047,6 @@ pmix_status_t pmix_server_get(pmix_buffer_t *buf, pmix_modex_cbfunc_t cbfunc, vo
     bool refresh_cache = false;
     bool scope_given = false;
     bool keyprovided = false;
-    bool found = false;
     uint32_t tmo;
     struct timeval tv = {0, 0};
     pmix_buffer_t pbkt;
@@ -350,18 +1176,8 @@ pmix_status_t pmix_server_get(pmix_buffer_t *buf, pmix_modex_cbfunc_t cbfunc, vo
      * with a given nspace. Instead, we are searching for any psets
      * that contain the calling process */
     if (keyprovided && PMIx_Check_key(key, PMIX_PSET_NAMES)) {
-        /* loop over all known psets and collect names
-         * in which this proc is a member */
-        pmix_pset_t *pset;
-        char **psets = NULL;
-        PMIX_LIST_FOREACH(pset, &pmix_server_globals.psets, pmix_pset_t) {
-            for (n=0; n < pset->nmembers; n++) {
-                if (PMIx_Check_procid(&pset->members[n], &proc)) {
-                    PMIx_Argv_append_nosize(&psets, pset->name);
-                    break;
-                }
-            }
-        }
+        /* collect the names of the psets in which this proc is a member */
+        char **psets = pmix_server_pset_membership(&proc);
         if (NULL != psets) {
             data = PMIx_Argv_join(psets, ',');
             PMIx_Argv_free(psets);
@@ -431,13 +1247,7 @@ pmix_status_t pmix_server_get(pmix_buffer_t *buf, pmix_modex_cbfunc_t cbfunc, vo
     }
 
     /* find the nspace object for the target proc */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(nspace, ns->nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(nspace);
 
     pmix_output_verbose(2, pmix_server_globals.get_output,
                         "%s EXECUTE GET FOR %s:%d WITH KEY %s ON BEHALF OF %s",
@@ -551,40 +1361,33 @@ pmix_status_t pmix_server_get(pmix_buffer_t *buf, pmix_modex_cbfunc_t cbfunc, vo
             local = true;
         } else {
             /* see if this proc is one of our local ones */
-            found = false;
-            PMIX_LIST_FOREACH (iptr, &nptr->ranks, pmix_rank_info_t) {
-                if (rank == iptr->pname.rank) {
-                    if (0 > iptr->peerid) {
-                        /* this rank has not connected yet, so this request needs to be held */
-                        rc = defer_response(nspace, rank, key, cd, localonly, cbfunc, cbdata, &tv, &lcd);
-                        if (PMIX_ERR_NOT_FOUND == rc) {
-                            /* just means we created a tracker */
-                            rc = PMIX_SUCCESS;
-                        } else if (PMIX_ERR_NOT_AVAILABLE == rc) {
-                            /* means they requested "immediate" */
-                            rc = PMIX_ERR_NOT_FOUND;
-                        }
-                        return rc;
+            iptr = pmix_nspace_find_rank(nptr, rank);
+            if (NULL != iptr) {
+                if (0 > iptr->peerid) {
+                    /* this rank has not connected yet, so this request needs to be held */
+                    rc = defer_response(nspace, rank, key, cd, localonly, cbfunc, cbdata, &tv, &lcd);
+                    if (PMIX_ERR_NOT_FOUND == rc) {
+                        /* just means we created a tracker */
+                        rc = PMIX_SUCCESS;
+                    } else if (PMIX_ERR_NOT_AVAILABLE == rc) {
+                        /* means they requested "immediate" */
+                        rc = PMIX_ERR_NOT_FOUND;
                     }
-                    local = true;
-                    found = true;
-                    break;
+                    return rc;
+                }
+                local = true;
+                if (NULL == pmix_pointer_array_get_item(&pmix_server_globals.clients, iptr->peerid)) {
+                    /* this must be a remote rank */
+                    local = false;
                 }
-            }
-            /* only consult iptr when the loop actually matched a rank - a
-             * loop that ran to completion leaves iptr pointing at the list
-             * sentinel, and reading peerid out of that is an out-of-bounds
-             * read whose garbage value could index a live client slot and
-             * wrongly mark a remote rank as local */
-            if (found &&
-                NULL == pmix_pointer_array_get_item(&pmix_server_globals.clients, iptr->peerid)) {
-                /* this must be a remote rank */
-                local = false;
             }
         }
     } else {
         local = false;
     }
+    if (!local) {
+        prefetch_taken(nptr, rank);
+    }
 
     /* if the proc is local, then we assume that the host/server maintains
      * updated info - there is no need to ask the host to refresh a cache */
@@ -828,24 +1631,11 @@ request:
             lcd->info = info;
             lcd->ninfo = sz + 1;
         }
-        /* the host holds this pointer until it calls dmdx_cbfunc, and the
-         * tracker can be retired out from under it in the meantime - a
-         * namespace deregistration for the target retires every tracker
-         * naming it - so take a reference for the host to hold */
-        PMIX_RETAIN(lcd);
-        rc = pmix_host_server.direct_modex(&lcd->proc, lcd->info, lcd->ninfo, dmdx_cbfunc, lcd);
-        /* this up-call's entire product is a data blob delivered through
-         * dmdx_cbfunc, so an atomic "success" carrying nothing cannot be
-         * acted on - say so rather than treating it as a bare refusal */
-        if (PMIX_UNLIKELY(PMIX_OPERATION_SUCCEEDED == rc)) {
-            pmix_show_help("help-pmix-server.txt", "atomic-completion-unsupported",
-                           true, "direct_modex");
-            rc = PMIX_ERR_NOT_SUPPORTED;
-        }
+        /* the host is asked through request_from_host, which holds the
+         * tracker for it - gathered into a batch with others bound for
+         * the same node if the host takes those */
+        rc = request_from_host(lcd);
         if (PMIX_SUCCESS != rc) {
-            /* may have a function entry but not support the request - it
-             * will not call us back, so give the reference back */
-            PMIX_RELEASE(lcd);
             discard_local_tracker(lcd);
         }
     } else {
@@ -864,7 +1654,7 @@ static pmix_status_t create_local_tracker(char nspace[], pmix_rank_t rank, char
                                           pmix_modex_cbfunc_t cbfunc, void *cbdata,
                                           pmix_dmdx_local_t **ld, pmix_dmdx_request_t **rq)
 {
-    pmix_dmdx_local_t *lcd, *cd;
+    pmix_dmdx_local_t *lcd;
     pmix_dmdx_request_t *req;
     pmix_status_t rc;
     size_t n;
@@ -875,14 +1665,7 @@ static pmix_status_t create_local_tracker(char nspace[], pmix_rank_t rank, char
 
     /* see if we already have an existing request for data
      * from this namespace/rank */
-    lcd = NULL;
-    PMIX_LIST_FOREACH (cd, &pmix_server_globals.local_reqs, pmix_dmdx_local_t) {
-        if (!PMIX_CHECK_NSPACE(nspace, cd->proc.nspace) || rank != cd->proc.rank) {
-            continue;
-        }
-        lcd = cd;
-        break;
-    }
+    lcd = find_local_tracker(nspace, rank);
     if (NULL != lcd) {
         /* we already have a request, so just track that someone
          * else wants data from the same target - the new request
@@ -904,7 +1687,10 @@ static pmix_status_t create_local_tracker(char nspace[], pmix_rank_t rank, char
             PMIX_INFO_XFER(&lcd->info[n], &info[n]);
         }
     }
-    pmix_list_append(&pmix_server_globals.local_reqs, &lcd->super);
+    if (PMIX_SUCCESS != track_local(lcd)) {
+        PMIX_RELEASE(lcd);
+        return PMIX_ERR_NOMEM;
+    }
     rc = PMIX_ERR_NOT_FOUND; // indicates that we created a new request tracker
 
 complete:
@@ -918,7 +1704,7 @@ complete:
              * than leaving an empty tracker there for the life of the
              * server. Leave *ld NULL: nothing is parked, so no caller may
              * hand this tracker to the host */
-            pmix_list_remove_item(&pmix_server_globals.local_reqs, &lcd->super);
+            untrack_local(lcd);
             PMIX_RELEASE(lcd);
         }
         return PMIX_ERR_NOMEM;
@@ -949,7 +1735,6 @@ void pmix_pending_nspace_requests(pmix_namespace_t *nptr)
      * that were waiting for registration to complete
      */
     PMIX_LIST_FOREACH_SAFE (cd, cd_next, &pmix_server_globals.local_reqs, pmix_dmdx_local_t) {
-        pmix_rank_info_t *info;
         bool found = false;
 
         if (!PMIX_CHECK_NSPACE(nptr->nspace, cd->proc.nspace)) {
@@ -959,13 +1744,8 @@ void pmix_pending_nspace_requests(pmix_namespace_t *nptr)
         /*  If they asked for job level data, then the data was just registered */
         if (PMIX_RANK_WILDCARD == cd->proc.rank) {
             found = true;
-        } else {
-            PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-                if (info->pname.rank == cd->proc.rank) {
-                    found = true; // we will satisy this request upon commit from new proc
-                    break;
-                }
-            }
+        } else if (NULL != pmix_nspace_find_rank(nptr, cd->proc.rank)) {
+            found = true; // we will satisy this request upon commit from new proc
         }
 
         /* if not found - this is remote process and we need to send
@@ -973,19 +1753,7 @@ void pmix_pending_nspace_requests(pmix_namespace_t *nptr)
         if (!found) {
             rc = PMIX_ERR_NOT_SUPPORTED;
             if (NULL != pmix_host_server.direct_modex) {
-                /* hand the host a reference of its own - see the matching
-                 * comment in pmix_server_get */
-                PMIX_RETAIN(cd);
-                rc = pmix_host_server.direct_modex(&cd->proc, cd->info, cd->ninfo, dmdx_cbfunc, cd);
-                if (PMIX_UNLIKELY(PMIX_OPERATION_SUCCEEDED == rc)) {
-                    /* see the matching note in pmix_server_get */
-                    pmix_show_help("help-pmix-server.txt", "atomic-completion-unsupported",
-                                   true, "direct_modex");
-                    rc = PMIX_ERR_NOT_SUPPORTED;
-                }
-                if (PMIX_SUCCESS != rc) {
-                    PMIX_RELEASE(cd);
-                }
+                rc = request_from_host(cd);
             }
             if (PMIX_SUCCESS != rc) {
                 pmix_dmdx_request_t *req, *req_next;
@@ -996,7 +1764,7 @@ void pmix_pending_nspace_requests(pmix_namespace_t *nptr)
                     pmix_list_remove_item(&cd->loc_reqs, &req->super);
                     PMIX_RELEASE(req);
                 }
-                pmix_list_remove_item(&pmix_server_globals.local_reqs, &cd->super);
+                untrack_local(cd);
                 PMIX_RELEASE(cd);
             }
         }
@@ -1324,27 +2092,42 @@ pmix_status_t pmix_pending_resolve(pmix_namespace_t *nptr,
                                    pmix_scope_t scope,
                                    pmix_dmdx_local_t *lcd)
 {
-    pmix_dmdx_local_t *cd, *cdnext;
-
-    /* find corresponding request (if exists) */
+    pmix_dmdx_local_t *cd;
+    pmix_rank_t want[2] = {rank, PMIX_RANK_UNDEF};
+    const char *ns[2] = {nptr->nspace, ""};
+    size_t n, m;
+
+    /* find corresponding request (if exists) - the one waiting on this
+     * rank, and the one waiting on whichever rank of the nspace turns up
+     * first, each under this nspace and under no nspace at all, which is
+     * everything the old walk of the list matched. Nothing else in the
+     * nspace has anything to gain from this arrival, so there is no need
+     * to look at it. The walk also swept out trackers whose requesters
+     * had all given up; get_timeout now retires those itself */
     if (NULL == lcd) {
-        PMIX_LIST_FOREACH_SAFE(cd, cdnext, &pmix_server_globals.local_reqs, pmix_dmdx_local_t) {
-            if (!PMIX_CHECK_NSPACE(nptr->nspace, cd->proc.nspace) ) {
-                continue;
+        for (n = 0; n < 2; n++) {
+            if (1 == n && PMIX_RANK_UNDEF == rank) {
+                break;
             }
-            if (PMIX_RANK_UNDEF == cd->proc.rank ||
-                rank == cd->proc.rank) {
+            for (m = 0; m < 2; m++) {
+                if (1 == m && PMIX_NSPACE_INVALID(nptr->nspace)) {
+                    break;
+                }
+                cd = lookup_local(ns[m], want[n]);
+                if (NULL == cd) {
+                    continue;
+                }
                 check_req(nptr, cd->proc.rank, status, scope, cd);
-            }
-            if (0 == pmix_list_get_size(&cd->loc_reqs)) {
-                pmix_list_remove_item(&pmix_server_globals.local_reqs, &cd->super);
-                PMIX_RELEASE(cd);
+                if (0 == pmix_list_get_size(&cd->loc_reqs)) {
+                    untrack_local(cd);
+                    PMIX_RELEASE(cd);
+                }
             }
         }
     } else {
         check_req(nptr, rank, status, scope, lcd);
         if (0 == pmix_list_get_size(&lcd->loc_reqs)) {
-            pmix_list_remove_item(&pmix_server_globals.local_reqs, &lcd->super);
+            untrack_local(lcd);
             PMIX_RELEASE(lcd);
         }
     }
@@ -1352,6 +2135,47 @@ pmix_status_t pmix_pending_resolve(pmix_namespace_t *nptr,
     return PMIX_SUCCESS;
 }
 
+/* Unpack a direct-modex reply and store what it carries for the target
+ * through the given peer's GDS module. The host's data is only read. */
+static pmix_status_t store_reply(pmix_peer_t *peer, pmix_dmdx_reply_caddy_t *caddy)
+{
+    pmix_buffer_t pbkt;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    int32_t cnt;
+
+    PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
+    PMIX_LOAD_BUFFER_NON_DESTRUCT(pmix_globals.mypeer, &pbkt, caddy->data, caddy->ndata);
+    kv = PMIX_NEW(pmix_kval_t);
+    cnt = 1;
+    PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, kv, &cnt, PMIX_KVAL);
+    while (PMIX_SUCCESS == rc) {
+        if (caddy->lcd->proc.rank == PMIX_RANK_WILDCARD) {
+            PMIX_GDS_STORE_KV(rc, peer, &caddy->lcd->proc, PMIX_INTERNAL, kv);
+        } else {
+            PMIX_GDS_STORE_KV(rc, peer, &caddy->lcd->proc, PMIX_REMOTE, kv);
+        }
+        PMIX_RELEASE(kv);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_ERROR_LOG(rc);
+            pbkt.base_ptr = NULL; // do not free the caller's data
+            PMIX_DESTRUCT(&pbkt);
+            return rc;
+        }
+        kv = PMIX_NEW(pmix_kval_t);
+        cnt = 1;
+        PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, kv, &cnt, PMIX_KVAL);
+    }
+    PMIX_RELEASE(kv);
+    pbkt.base_ptr = NULL; // protect the data
+    PMIX_DESTRUCT(&pbkt);
+    if (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
+        PMIX_ERROR_LOG(rc);
+        return rc;
+    }
+    return PMIX_SUCCESS;
+}
+
 /* process the returned data from the host RM server */
 static void _process_dmdx_reply(int sd, short args, void *cbdata)
 {
@@ -1359,15 +2183,13 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
     pmix_server_caddy_t *cd;
     pmix_peer_t *peer;
     pmix_rank_info_t *rinfo, *rptr;
-    int32_t cnt;
     pmix_kval_t *kv;
-    pmix_namespace_t *ns, *nptr;
+    pmix_namespace_t *nptr;
     pmix_status_t rc;
     pmix_list_t nspaces;
     pmix_nspace_caddy_t *nm;
     pmix_dmdx_request_t *dm;
-    bool found;
-    pmix_buffer_t pbkt;
+    bool found, stored = false;
     pmix_cb_t cb;
     pmix_proc_t wildcard;
 
@@ -1392,13 +2214,7 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
     }
 
     /* find the nspace object for the proc whose data is being received */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (PMIX_CHECK_NSPACE(caddy->lcd->proc.nspace, ns->nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(caddy->lcd->proc.nspace);
 
     if (NULL == nptr) {
         /* We may not have this namespace because there are no local
@@ -1413,7 +2229,7 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
         }
         nptr->nspace = strdup(caddy->lcd->proc.nspace);
         /* add to the list */
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
     }
 
     /* if the request was successfully satisfied, then store the data.
@@ -1432,6 +2248,17 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
      * the 'complete' label releases it (and its retained namespace
      * references) in one place */
     PMIX_CONSTRUCT(&nspaces, pmix_list_t);
+    if (PMIX_SUCCESS == caddy->status && caddy->lcd->prefetch && NULL != caddy->data) {
+        /* data fetched ahead may have nobody waiting for it yet, so
+         * nobody below decides where it goes - put it in our own store,
+         * which is where a later request looks first */
+        rc = store_reply(pmix_globals.mypeer, caddy);
+        if (PMIX_SUCCESS != rc) {
+            caddy->status = rc;
+            goto complete;
+        }
+        stored = true;
+    }
     if (PMIX_SUCCESS == caddy->status) {
         /* cycle across all outstanding local requests and collect their
          * unique nspaces so we can store this for each one */
@@ -1481,7 +2308,9 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
                     goto complete;
                 }
             }
-            PMIX_CONSTRUCT(&pbkt, pmix_buffer_t);
+            if (stored && peer == pmix_globals.mypeer) {
+                continue;
+            }
             if (NULL == caddy->data) {
                 if (peer != pmix_globals.mypeer) {
                     /* we assume that the data was provided via a call to
@@ -1517,35 +2346,8 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
                     PMIX_DESTRUCT(&cb);
                 }
             } else {
-                PMIX_LOAD_BUFFER(pmix_globals.mypeer, &pbkt, caddy->data, caddy->ndata);
-                /* unpack and store it*/
-                kv = PMIX_NEW(pmix_kval_t);
-                cnt = 1;
-                PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, kv, &cnt, PMIX_KVAL);
-                while (PMIX_SUCCESS == rc) {
-                    if (caddy->lcd->proc.rank == PMIX_RANK_WILDCARD) {
-                        PMIX_GDS_STORE_KV(rc, peer, &caddy->lcd->proc, PMIX_INTERNAL, kv);
-                    } else {
-                        PMIX_GDS_STORE_KV(rc, peer, &caddy->lcd->proc, PMIX_REMOTE, kv);
-                    }
-                    if (PMIX_SUCCESS != rc) {
-                        PMIX_ERROR_LOG(rc);
-                        caddy->status = rc;
-                        PMIX_RELEASE(kv);
-                        pbkt.base_ptr = NULL; // do not free the caller's data
-                        PMIX_DESTRUCT(&pbkt);
-                        goto complete;
-                    }
-                    PMIX_RELEASE(kv);
-                    kv = PMIX_NEW(pmix_kval_t);
-                    cnt = 1;
-                    PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &pbkt, kv, &cnt, PMIX_KVAL);
-                }
-                PMIX_RELEASE(kv);
-                pbkt.base_ptr = NULL; // protect the data
-                PMIX_DESTRUCT(&pbkt);
-                if (PMIX_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
-                    PMIX_ERROR_LOG(rc);
+                rc = store_reply(peer, caddy);
+                if (PMIX_SUCCESS != rc) {
                     caddy->status = rc;
                     goto complete;
                 }
@@ -1555,6 +2357,10 @@ static void _process_dmdx_reply(int sd, short args, void *cbdata)
 
 complete:
     PMIX_LIST_DESTRUCT(&nspaces);
+    if (caddy->lcd->prefetch && PMIX_SUCCESS != caddy->status) {
+        /* a later request is not served from what we fetched ahead */
+        prefetch_forget(&caddy->lcd->proc);
+    }
     /* always execute the callback to avoid having the client hang */
     pmix_pending_resolve(nptr, caddy->lcd->proc.rank,
                          caddy->status, PMIX_REMOTE, caddy->lcd);
@@ -1620,6 +2426,7 @@ static void dmdx_cbfunc(pmix_status_t status, const char *data, size_t ndata, vo
 static void get_timeout(int sd, short args, void *cbdata)
 {
     pmix_dmdx_request_t *req = (pmix_dmdx_request_t *) cbdata;
+    pmix_dmdx_local_t *lcd;
     PMIX_HIDE_UNUSED_PARAMS(sd, args);
 
     pmix_output_verbose(2, pmix_server_globals.get_output, "ALERT: get timeout fired");
@@ -1628,6 +2435,19 @@ static void get_timeout(int sd, short args, void *cbdata)
         req->cbfunc(PMIX_ERR_TIMEOUT, NULL, 0, req->cbdata, NULL, NULL);
     }
     req->event_active = false;
-    pmix_list_remove_item(&req->lcd->loc_reqs, &req->super);
+    lcd = req->lcd;
+    pmix_list_remove_item(&lcd->loc_reqs, &req->super);
+    /* the request holds a reference on its tracker */
+    PMIX_RETAIN(lcd);
     PMIX_RELEASE(req);
+    /* A tracker nobody is waiting on any more is retired here rather than
+     * left for whatever comes next: a later get for the target asks
+     * afresh, and a reply still out at the host is discarded when it
+     * lands. One fetched ahead has never had anyone waiting on it, and is
+     * retired by its own reply */
+    if (!lcd->prefetch && 0 == pmix_list_get_size(&lcd->loc_reqs) && tracker_is_pending(lcd)) {
+        untrack_local(lcd);
+        PMIX_RELEASE(lcd);
+    }
+    PMIX_RELEASE(lcd);
 }
@@ -92,6 +92,9 @@ typedef struct {
                             //    Counted alongside mbrs so the construct can
                             //    complete on the survivors rather than hang.
                             //    See docs/how-things-work/collectives.
+    pmix_grp_mbrset_t members;   // every proc any participant named as a member
+    pmix_grp_mbrset_t arrived;   // the local procs whose calls are on mbrs
+    pmix_grp_mbrset_t gone;      // the procs on departed
     bool host_called;       // the block has been forwarded to the host - the
                             //    local phase is frozen
     bool def_complete;      // all local procs have been registered and the trk definition is complete
@@ -108,6 +111,9 @@ static void gbcon(grp_block_t *p)
     p->ninfo = 0;
     PMIX_CONSTRUCT(&p->mbrs, pmix_list_t);
     PMIX_CONSTRUCT(&p->departed, pmix_list_t);
+    PMIX_CONSTRUCT(&p->members, pmix_grp_mbrset_t);
+    PMIX_CONSTRUCT(&p->arrived, pmix_grp_mbrset_t);
+    PMIX_CONSTRUCT(&p->gone, pmix_grp_mbrset_t);
     p->host_called = false;
     p->def_complete = false;
     p->nlocal = 0;
@@ -131,6 +137,9 @@ static void gbdes(grp_block_t *p)
     }
     PMIX_LIST_DESTRUCT(&p->mbrs);
     PMIX_LIST_DESTRUCT(&p->departed);
+    PMIX_DESTRUCT(&p->members);
+    PMIX_DESTRUCT(&p->arrived);
+    PMIX_DESTRUCT(&p->gone);
 }
 static PMIX_CLASS_INSTANCE(grp_block_t,
                            pmix_list_item_t,
@@ -215,7 +224,7 @@ static bool grp_notify_termination(grp_block_t *blk);
 
 static void check_definition_complete(grp_block_t *blk)
 {
-    pmix_namespace_t *ns, *nptr;
+    pmix_namespace_t *nptr;
     pmix_rank_info_t *info;
     size_t i;
     uint32_t nlocal = 0;
@@ -228,13 +237,7 @@ static void check_definition_complete(grp_block_t *blk)
     PMIX_LIST_FOREACH(trk, &blk->mbrs, grp_trk_t) {
         for (i = 0; i < trk->npcs; i++) {
             /* is this nspace known to us? */
-            nptr = NULL;
-            PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-                if (0 == strcmp(trk->pcs[i].nspace, ns->nspace)) {
-                    nptr = ns;
-                    break;
-                }
-            }
+            nptr = pmix_nspace_lookup(trk->pcs[i].nspace);
             if (NULL == nptr) {
                 /* we don't know about this nspace - we need to
                  * wait until it has been registered */
@@ -281,15 +284,13 @@ static void check_definition_complete(grp_block_t *blk)
                 return;
             }
             /* is this one of my local ranks? */
-            PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-                if (trk->pcs[i].rank == info->pname.rank) {
-                    pmix_output_verbose(5, pmix_server_globals.fence_output,
-                                        "adding local proc %s.%d to tracker", info->pname.nspace,
-                                        info->pname.rank);
-                    /* track the count */
-                    nlocal++;
-                    break;
-                }
+            info = pmix_nspace_find_rank(nptr, trk->pcs[i].rank);
+            if (NULL != info) {
+                pmix_output_verbose(5, pmix_server_globals.fence_output,
+                                    "adding local proc %s.%d to tracker", info->pname.nspace,
+                                    info->pname.rank);
+                /* track the count */
+                nlocal++;
             }
         }
     }
@@ -313,6 +314,22 @@ static bool grp_blk_locally_complete(grp_block_t *blk)
             pmix_list_get_size(&blk->departed)) >= blk->nlocal;
 }
 
+/* Record the membership a participant brought, so that asking whether
+ * a proc is a member of the block does not mean walking every
+ * participant's array. All or nothing: the callers drop the new tracker
+ * on an error, and members must not go on naming procs that only it
+ * brought. */
+static pmix_status_t note_members(grp_block_t *blk, const pmix_proc_t *procs, size_t nprocs)
+{
+    pmix_status_t rc;
+
+    rc = pmix_grp_mbrset_add_procs(&blk->members, procs, nprocs);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_ERROR_LOG(rc);
+    }
+    return rc;
+}
+
 static pmix_status_t get_tracker(char *grpid, bool bootstrap, bool follower,
                                  pmix_proc_t *procs, size_t nprocs,
                                  pmix_info_t *info, size_t ninfo,
@@ -347,6 +364,10 @@ static pmix_status_t get_tracker(char *grpid, bool bootstrap, bool follower,
                 trk->npcs = nprocs;
                 memcpy(trk->pcs, procs, nprocs * sizeof(pmix_proc_t));
             }
+            if (PMIX_SUCCESS != note_members(blk, procs, nprocs)) {
+                PMIX_RELEASE(trk);
+                return PMIX_ERR_NOMEM;
+            }
             // non-owning back-reference - see gtdes
             trk->blk = blk;
             trk->info = info;
@@ -386,6 +407,11 @@ newblock:
         trk->npcs = nprocs;
         memcpy(trk->pcs, procs, nprocs * sizeof(pmix_proc_t));
     }
+    if (PMIX_SUCCESS != note_members(blk, procs, nprocs)) {
+        PMIX_RELEASE(trk);
+        PMIX_RELEASE(blk);
+        return PMIX_ERR_NOMEM;
+    }
     /* nothing below here can fail, so it is safe to publish the block and
      * to take ownership of the caller's info array */
     pmix_list_append(&pmix_server_globals.grp_collectives, &blk->super);
@@ -917,39 +943,29 @@ static void group_timeout(int sd, short args, void *cbdata)
 static pmix_status_t aggregate_info(grp_block_t *blk)
 {
     grp_trk_t *trk;
-    pmix_list_t ilist, nmlist, plist;
-    size_t n, m, j, k, niptr;
+    pmix_list_t ilist;
+    size_t n, m, niptr;
     pmix_info_t *iptr;
-    bool found, nmfound;
+    bool found;
     pmix_info_caddy_t *icd;
-    pmix_proclist_t *nm;
-    pmix_proc_t *nmarray, *trkarray, *tmp;
-    size_t nmsize, trksize, bt, bt2;
+    pmix_proc_t *nmarray;
+    size_t nmsize, bt, bt2;
+    pmix_grp_union_t pcs, nms;
     pmix_status_t rc;
 
     // only keep unique entries
     PMIX_CONSTRUCT(&ilist, pmix_list_t);
-    PMIX_CONSTRUCT(&plist, pmix_list_t);
+    rc = pmix_grp_union_start(&pcs, &blk->pcs, &blk->npcs);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_LIST_DESTRUCT(&ilist);
+        return rc;
+    }
 
     PMIX_LIST_FOREACH(trk, &blk->mbrs, grp_trk_t) {
         // aggregate procs
-        for (n=0; n < trk->npcs; n++) {
-            found = false;
-            for (m=0; m < blk->npcs; m++) {
-                if (PMIX_CHECK_PROCID(&trk->pcs[n], &blk->pcs[m])) {
-                    found = true;
-                    // preserve WILDCARD rank
-                    if (PMIX_RANK_WILDCARD == trk->pcs[n].rank) {
-                        blk->pcs[m].rank = PMIX_RANK_WILDCARD;
-                    }
-                    break;
-                }
-            }
-            if (!found) {
-                nm = PMIX_NEW(pmix_proclist_t);
-                memcpy(&nm->proc, &trk->pcs[n], sizeof(pmix_proc_t));
-                pmix_list_append(&plist, &nm->super);
-            }
+        rc = pmix_grp_union_merge(&pcs, trk->pcs, trk->npcs);
+        if (PMIX_SUCCESS != rc) {
+            goto bailout;
         }
         // aggregate info structs
         for (n=0; n < trk->ninfo; n++) {
@@ -970,44 +986,19 @@ static pmix_status_t aggregate_info(grp_block_t *blk)
                         // aggregate the members
                         nmarray = (pmix_proc_t*)blk->info[m].value.data.darray->array;
                         nmsize = blk->info[m].value.data.darray->size;
-                        trkarray = (pmix_proc_t*)trk->info[n].value.data.darray->array;
-                        trksize = trk->info[n].value.data.darray->size;
-                        PMIX_CONSTRUCT(&nmlist, pmix_list_t);
-                        // sadly, an exhaustive search
-                        for (k=0; k < trksize; k++) {
-                            nmfound = false;
-                            for (j=0; j < nmsize; j++) {
-                                if (PMIX_CHECK_PROCID(&nmarray[j], &trkarray[k])) {
-                                    // if the new one is rank=WILDCARD, then ensure
-                                    // we keep it as wildcard
-                                    if (PMIX_RANK_WILDCARD == trkarray[k].rank) {
-                                        nmarray[j].rank = PMIX_RANK_WILDCARD;
-                                    }
-                                    nmfound = true;
-                                    break;
-                                }
-                            }
-                            if (!nmfound) {
-                                nm = PMIX_NEW(pmix_proclist_t);
-                                memcpy(&nm->proc, &trkarray[k], sizeof(pmix_proc_t));
-                                pmix_list_append(&nmlist, &nm->super);
-                            }
+                        rc = pmix_grp_union_start(&nms, &nmarray, &nmsize);
+                        if (PMIX_SUCCESS == rc) {
+                            rc = pmix_grp_union_merge(&nms,
+                                                      (pmix_proc_t*)trk->info[n].value.data.darray->array,
+                                                      trk->info[n].value.data.darray->size);
+                            rc = pmix_grp_union_finish(&nms, rc);
                         }
-                        // create the replacement array, if needed
-                        if (0 < pmix_list_get_size(&nmlist)) {
-                            bt = nmsize + pmix_list_get_size(&nmlist);
-                            PMIX_PROC_CREATE(tmp, bt);
-                            memcpy(tmp, nmarray, nmsize * sizeof(pmix_proc_t));
-                            j = nmsize;
-                            PMIX_LIST_FOREACH(nm, &nmlist, pmix_proclist_t) {
-                                memcpy(&tmp[j], &nm->proc, sizeof(pmix_proc_t));
-                                ++j;
-                            }
-                            PMIX_PROC_FREE(nmarray, nmsize);
-                            blk->info[m].value.data.darray->array = tmp;
-                            blk->info[m].value.data.darray->size = bt;
+                        if (PMIX_SUCCESS != rc) {
+                            PMIX_ERROR_LOG(rc);
+                            goto bailout;
                         }
-                        PMIX_LIST_DESTRUCT(&nmlist);
+                        blk->info[m].value.data.darray->array = nmarray;
+                        blk->info[m].value.data.darray->size = nmsize;
 
                     } else if (PMIX_CHECK_KEY(&blk->info[m], PMIX_GROUP_BOOTSTRAP)) {
                         // the numbers must match
@@ -1044,22 +1035,10 @@ static pmix_status_t aggregate_info(grp_block_t *blk)
             }
         }
     }
-    if (0 < pmix_list_get_size(&plist)) {
-        m = blk->npcs + pmix_list_get_size(&plist);
-        PMIX_PROC_CREATE(tmp, m);
-        if (NULL != blk->pcs) {
-            memcpy(tmp, blk->pcs, blk->npcs * sizeof(pmix_proc_t));
-        }
-        n = blk->npcs;
-        PMIX_LIST_FOREACH(nm, &plist, pmix_proclist_t) {
-            memcpy(&tmp[n], &nm->proc, sizeof(pmix_proc_t));
-            n++;
-        }
-        if (NULL != blk->pcs) {
-            PMIX_PROC_FREE(blk->pcs, blk->npcs);
-        }
-        blk->pcs = tmp;
-        blk->npcs = m;
+    rc = pmix_grp_union_finish(&pcs, PMIX_SUCCESS);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_LIST_DESTRUCT(&ilist);
+        return rc;
     }
     if (0 < pmix_list_get_size(&ilist)) {
         niptr = blk->ninfo + pmix_list_get_size(&ilist);
@@ -1078,15 +1057,14 @@ static pmix_status_t aggregate_info(grp_block_t *blk)
         /* cleanup */
     }
     PMIX_LIST_DESTRUCT(&ilist);
-    PMIX_LIST_DESTRUCT(&plist);
     return PMIX_SUCCESS;
 
 bailout:
-    /* both scratch lists have to come down on the error paths too - the
-     * bootstrap-mismatch returns used to drop only ilist and leak every
-     * proc entry accumulated in plist */
+    /* the scratch list and the union in progress have to come down on
+     * the error paths too - the bootstrap-mismatch returns used to drop
+     * only ilist and leak every proc entry accumulated alongside it */
     PMIX_LIST_DESTRUCT(&ilist);
-    PMIX_LIST_DESTRUCT(&plist);
+    (void) pmix_grp_union_finish(&pcs, rc);
     return rc;
 }
 
@@ -1100,6 +1078,7 @@ pmix_status_t pmix_server_group(pmix_server_caddy_t *cd, pmix_buffer_t *buf,
     pmix_status_t rc;
     char *grpid = NULL;
     pmix_proc_t *procs = NULL;
+    pmix_proc_t pname;
     pmix_info_t *info = NULL;
     /* ninf is initialized because a peer whose message is short or malformed
      * can have the unpack below report success without writing it - the count
@@ -1251,6 +1230,13 @@ pmix_status_t pmix_server_group(pmix_server_caddy_t *cd, pmix_buffer_t *buf,
     blk->grpop = op;
     // track the callback
     pmix_list_append(&trk->local_cbs, &cd->super);
+    PMIX_LOAD_PROCID(&pname, peer->info->pname.nspace, peer->info->pname.rank);
+    rc = pmix_grp_mbrset_add(&blk->arrived, &pname, 0);
+    if (PMIX_SUCCESS != rc) {
+        /* it still counts towards completion - only a departure of
+         * this same proc could now be mistaken for one that matters */
+        PMIX_ERROR_LOG(rc);
+    }
 
     if (follower || bootstrap) {
         /* this is an add-member, so pass it up by itself. We cannot
@@ -1389,11 +1375,8 @@ error:
 static void account_departed(grp_block_t *blk, const pmix_proc_t *proc)
 {
     grp_trk_t *trk;
-    pmix_server_caddy_t *scd;
     pmix_proclist_t *dp;
     pmix_status_t rc;
-    bool ismbr, contributed, known;
-    size_t n;
 
     /* bootstrap/follower blocks are passed up per-call and never wait on a
      * local count (nlocal == 0), so nothing here can hang; and a block that
@@ -1404,43 +1387,20 @@ static void account_departed(grp_block_t *blk, const pmix_proc_t *proc)
     }
     /* is this proc an expected member of this group, and has its rank
      * already contributed? */
-    ismbr = false;
-    contributed = false;
-    PMIX_LIST_FOREACH (trk, &blk->mbrs, grp_trk_t) {
-        for (n = 0; n < trk->npcs; n++) {
-            if (PMIX_CHECK_NAMES(&trk->pcs[n], proc)) {
-                ismbr = true;
-                break;
-            }
-        }
-        PMIX_LIST_FOREACH (scd, &trk->local_cbs, pmix_server_caddy_t) {
-            if (PMIX_CHECK_NAMES(&scd->peer->info->pname, proc)) {
-                contributed = true;
-                break;
-            }
-        }
-        if (contributed) {
-            break;
-        }
-    }
-    if (!ismbr || contributed) {
+    switch (pmix_grp_mbrset_depart(&blk->members, &blk->arrived, &blk->gone, proc)) {
+    case PMIX_GRP_DEPART_IGNORE:
         /* not a participant, or Case A (already contributed - its
          * contribution and data stand, so ignore the departure) */
         return;
-    }
-    /* Case B: the rank had not yet contributed and never will. Record it as
-     * departed (once) so the block can complete on the survivors. */
-    known = false;
-    PMIX_LIST_FOREACH (dp, &blk->departed, pmix_proclist_t) {
-        if (PMIX_CHECK_NAMES(&dp->proc, proc)) {
-            known = true;
-            break;
-        }
-    }
-    if (!known) {
+    case PMIX_GRP_DEPART_NEW:
+        /* Case B: the rank had not yet contributed and never will. Record
+         * it as departed (once) so the block can complete on the survivors. */
         dp = PMIX_NEW(pmix_proclist_t);
         PMIX_LOAD_PROCID(&dp->proc, proc->nspace, proc->rank);
         pmix_list_append(&blk->departed, &dp->super);
+        break;
+    case PMIX_GRP_DEPART_KNOWN:
+        break;
     }
     /* did that complete the local phase? if so we must forward to the host
      * now - no further participant call will arrive to do it for us. All
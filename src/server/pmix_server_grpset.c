@@ -0,0 +1,319 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "src/include/pmix_stdint.h"
+
+#include "pmix_common.h"
+
+#include "src/include/pmix_globals.h"
+
+#ifdef HAVE_STRING_H
+#    include <string.h>
+#endif
+
+#include "src/class/pmix_bitmap.h"
+#include "src/class/pmix_hash_table.h"
+#include "src/class/pmix_list.h"
+#include "src/util/pmix_error.h"
+
+#include "pmix_server_ops.h"
+
+/* GROUP MEMBERSHIP, BY NSPACE
+ *
+ * Whether a proc is among a group's members, has already arrived, or has
+ * already been counted as departed was answered by walking a list or an
+ * array of pmix_proc_t - and merging the membership every participant
+ * brought meant doing that for each proc it named, so building a group of
+ * N procs cost N^2 comparisons and a list item per proc. A set holds one
+ * entry per nspace, with the ranks it names as bits: a lookup is a hash of
+ * the nspace and a bit test, and 100k ranks of one nspace take 12.5KB.
+ *
+ * Membership here has PMIX_CHECK_PROCID's sense. A WILDCARD rank in the
+ * set names every rank of its nspace, and a WILDCARD rank asked about is
+ * a member if anything of its nspace is. Ranks past PMIX_GRP_RANK_BITS -
+ * far past any real job, but a rank is only a number off the wire - are
+ * kept on a short list instead, so one of them cannot size the bitmap.
+ *
+ * These live apart from pmix_server_group.c, which is their only user,
+ * so that the unit tests can reach them. */
+
+static pmix_grp_nsmbrs_t *mbrset_nspace(pmix_grp_mbrset_t *set, const char *nspace)
+{
+    pmix_grp_nsmbrs_t *ns;
+
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_ptr(&set->index, nspace,
+                                                      strnlen(nspace, PMIX_MAX_NSLEN),
+                                                      (void **) &ns)) {
+        return NULL;
+    }
+    return ns;
+}
+
+bool pmix_grp_mbrset_has(pmix_grp_mbrset_t *set, const pmix_proc_t *proc)
+{
+    pmix_grp_nsmbrs_t *ns;
+    pmix_proclist_t *p;
+
+    ns = mbrset_nspace(set, proc->nspace);
+    if (NULL == ns) {
+        return false;
+    }
+    if (ns->wildcard || PMIX_RANK_WILDCARD == proc->rank) {
+        return true;
+    }
+    if (proc->rank < PMIX_GRP_RANK_BITS) {
+        return pmix_bitmap_is_set_bit(&ns->ranks, (int) proc->rank);
+    }
+    PMIX_LIST_FOREACH (p, &ns->others, pmix_proclist_t) {
+        if (p->proc.rank == proc->rank) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* What one add changed, filled in step by step as each change is made,
+ * so that an add which fails partway can be taken back too */
+typedef struct {
+    pmix_grp_nsmbrs_t *ns;
+    bool created;   // the nspace was new to the set
+    bool wildcard;  // ns->wildcard before the add
+    bool setbit;    // the bit for "rank", clear before, is now set
+    pmix_rank_t rank;
+    bool appended;  // a rank was appended to ns->others
+} mbrset_undo_t;
+
+static pmix_status_t mbrset_add(pmix_grp_mbrset_t *set, const pmix_proc_t *proc, size_t pos,
+                                mbrset_undo_t *undo)
+{
+    pmix_grp_nsmbrs_t *ns;
+    pmix_proclist_t *p;
+    pmix_status_t rc;
+    bool wasset;
+
+    ns = mbrset_nspace(set, proc->nspace);
+    if (NULL == ns) {
+        ns = PMIX_NEW(pmix_grp_nsmbrs_t);
+        if (NULL == ns) {
+            return PMIX_ERR_NOMEM;
+        }
+        PMIX_LOAD_NSPACE(ns->nspace, proc->nspace);
+        ns->first = pos;
+        rc = pmix_hash_table_set_value_ptr(&set->index, ns->nspace,
+                                           strnlen(ns->nspace, PMIX_MAX_NSLEN), ns);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_RELEASE(ns);
+            return rc;
+        }
+        pmix_list_append(&set->nspaces, &ns->super);
+        if (NULL != undo) {
+            undo->created = true;
+        }
+    }
+    if (NULL != undo) {
+        undo->ns = ns;
+        undo->wildcard = ns->wildcard;
+    }
+    if (PMIX_RANK_WILDCARD == proc->rank) {
+        ns->wildcard = true;
+        return PMIX_SUCCESS;
+    }
+    if (proc->rank < PMIX_GRP_RANK_BITS) {
+        wasset = pmix_bitmap_is_set_bit(&ns->ranks, (int) proc->rank);
+        rc = pmix_bitmap_set_bit(&ns->ranks, (int) proc->rank);
+        if (PMIX_SUCCESS == rc && NULL != undo) {
+            undo->setbit = !wasset;
+            undo->rank = proc->rank;
+        }
+        return rc;
+    }
+    p = PMIX_NEW(pmix_proclist_t);
+    if (NULL == p) {
+        return PMIX_ERR_NOMEM;
+    }
+    memcpy(&p->proc, proc, sizeof(pmix_proc_t));
+    pmix_list_append(&ns->others, &p->super);
+    if (NULL != undo) {
+        undo->appended = true;
+    }
+    return PMIX_SUCCESS;
+}
+
+/* Take back one add. Undone newest first, so whatever was added to an
+ * nspace after the add that created it is gone before the nspace is */
+static void mbrset_undo(pmix_grp_mbrset_t *set, mbrset_undo_t *undo)
+{
+    pmix_grp_nsmbrs_t *ns = undo->ns;
+    pmix_list_item_t *item;
+
+    if (NULL == ns) {
+        return;
+    }
+    if (undo->appended) {
+        item = pmix_list_remove_last(&ns->others);
+        PMIX_RELEASE(item);
+    }
+    if (undo->setbit) {
+        (void) pmix_bitmap_clear_bit(&ns->ranks, (int) undo->rank);
+    }
+    ns->wildcard = undo->wildcard;
+    if (undo->created) {
+        (void) pmix_hash_table_remove_value_ptr(&set->index, ns->nspace,
+                                                strnlen(ns->nspace, PMIX_MAX_NSLEN));
+        pmix_list_remove_item(&set->nspaces, &ns->super);
+        PMIX_RELEASE(ns);
+    }
+}
+
+pmix_status_t pmix_grp_mbrset_add(pmix_grp_mbrset_t *set, const pmix_proc_t *proc, size_t pos)
+{
+    return mbrset_add(set, proc, pos, NULL);
+}
+
+pmix_status_t pmix_grp_mbrset_add_procs(pmix_grp_mbrset_t *set, const pmix_proc_t *procs,
+                                        size_t nprocs)
+{
+    mbrset_undo_t *undo;
+    pmix_status_t rc = PMIX_SUCCESS;
+    size_t n, m;
+
+    if (NULL == procs || 0 == nprocs) {
+        return PMIX_SUCCESS;
+    }
+    /* the undo log is allocated before anything changes, so failing to
+     * get it leaves the set as it was too */
+    undo = (mbrset_undo_t *) calloc(nprocs, sizeof(*undo));
+    if (NULL == undo) {
+        return PMIX_ERR_NOMEM;
+    }
+    for (n = 0; n < nprocs; n++) {
+        rc = mbrset_add(set, &procs[n], n, &undo[n]);
+        if (PMIX_SUCCESS != rc) {
+            break;
+        }
+    }
+    if (PMIX_SUCCESS != rc) {
+        /* the failed add may have made some of its changes before it
+         * failed - those are recorded too, so start from it */
+        for (m = n + 1; 0 < m; m--) {
+            mbrset_undo(set, &undo[m - 1]);
+        }
+    }
+    free(undo);
+    return rc;
+}
+
+pmix_grp_depart_t pmix_grp_mbrset_depart(pmix_grp_mbrset_t *members, pmix_grp_mbrset_t *arrived,
+                                         pmix_grp_mbrset_t *gone, const pmix_proc_t *proc)
+{
+    pmix_status_t rc;
+
+    if (!pmix_grp_mbrset_has(members, proc) || pmix_grp_mbrset_has(arrived, proc)) {
+        return PMIX_GRP_DEPART_IGNORE;
+    }
+    if (pmix_grp_mbrset_has(gone, proc)) {
+        return PMIX_GRP_DEPART_KNOWN;
+    }
+    rc = mbrset_add(gone, proc, 0, NULL);
+    if (PMIX_SUCCESS != rc) {
+        /* it is still a departure - only a second report of this same
+         * proc could now be counted twice */
+        PMIX_ERROR_LOG(rc);
+    }
+    return PMIX_GRP_DEPART_NEW;
+}
+
+pmix_status_t pmix_grp_union_start(pmix_grp_union_t *u, pmix_proc_t **base, size_t *nbase)
+{
+    pmix_status_t rc;
+    size_t n;
+
+    PMIX_CONSTRUCT(&u->set, pmix_grp_mbrset_t);
+    u->base = base;
+    u->nbase = nbase;
+    u->extra = NULL;
+    u->nextra = 0;
+    u->nalloc = 0;
+    for (n = 0; NULL != *base && n < *nbase; n++) {
+        rc = mbrset_add(&u->set, &(*base)[n], n, NULL);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_DESTRUCT(&u->set);
+            return rc;
+        }
+    }
+    return PMIX_SUCCESS;
+}
+
+pmix_status_t pmix_grp_union_merge(pmix_grp_union_t *u, const pmix_proc_t *procs, size_t nprocs)
+{
+    pmix_grp_nsmbrs_t *ns;
+    pmix_proc_t *tmp;
+    pmix_status_t rc;
+    size_t n;
+
+    for (n = 0; n < nprocs; n++) {
+        if (PMIX_RANK_WILDCARD == procs[n].rank) {
+            ns = mbrset_nspace(&u->set, procs[n].nspace);
+            if (NULL != ns) {
+                if (ns->first < *u->nbase) {
+                    (*u->base)[ns->first].rank = PMIX_RANK_WILDCARD;
+                } else {
+                    u->extra[ns->first - *u->nbase].rank = PMIX_RANK_WILDCARD;
+                }
+                ns->wildcard = true;
+                continue;
+            }
+        } else if (pmix_grp_mbrset_has(&u->set, &procs[n])) {
+            continue;
+        }
+        if (u->nextra == u->nalloc) {
+            u->nalloc = (0 == u->nalloc) ? nprocs : 2 * u->nalloc;
+            tmp = (pmix_proc_t *) realloc(u->extra, u->nalloc * sizeof(pmix_proc_t));
+            if (NULL == tmp) {
+                return PMIX_ERR_NOMEM;
+            }
+            u->extra = tmp;
+        }
+        rc = mbrset_add(&u->set, &procs[n], *u->nbase + u->nextra, NULL);
+        if (PMIX_SUCCESS != rc) {
+            return rc;
+        }
+        memcpy(&u->extra[u->nextra], &procs[n], sizeof(pmix_proc_t));
+        u->nextra++;
+    }
+    return PMIX_SUCCESS;
+}
+
+pmix_status_t pmix_grp_union_finish(pmix_grp_union_t *u, pmix_status_t status)
+{
+    pmix_proc_t *tmp;
+    size_t total;
+
+    if (PMIX_SUCCESS == status && 0 < u->nextra) {
+        total = *u->nbase + u->nextra;
+        PMIX_PROC_CREATE(tmp, total);
+        if (NULL == tmp) {
+            status = PMIX_ERR_NOMEM;
+        } else {
+            if (NULL != *u->base) {
+                memcpy(tmp, *u->base, *u->nbase * sizeof(pmix_proc_t));
+                PMIX_PROC_FREE(*u->base, *u->nbase);
+            }
+            memcpy(&tmp[*u->nbase], u->extra, u->nextra * sizeof(pmix_proc_t));
+            *u->base = tmp;
+            *u->nbase = total;
+        }
+    }
+    free(u->extra);
+    PMIX_DESTRUCT(&u->set);
+    return status;
+}
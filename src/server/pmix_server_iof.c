@@ -644,18 +644,13 @@ static bool iof_inherit_allowed(const char *nspace)
 static size_t inherit_parent_iof(pmix_setup_caddy_t *cd, char nspace[])
 {
     pmix_proc_t parent;
-    pmix_namespace_t *ns, *nptr = NULL;
+    pmix_namespace_t *nptr = NULL;
 
     if (NULL == cd->peer || NULL == cd->peer->info) {
         return 0;
     }
 
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (PMIX_CHECK_NSPACE(ns->nspace, nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(nspace);
     if (NULL == nptr) {
         pmix_output_verbose(2, pmix_server_globals.iof_output,
                             "PMIx:SERVER job %s not registered here yet - "
@@ -65,7 +65,10 @@ static void _mdxcbfunc(int sd, short args, void *cbdata)
 {
     pmix_shift_caddy_t *scd = (pmix_shift_caddy_t *) cbdata;
     pmix_server_trkr_t *tracker = scd->tracker;
-    pmix_buffer_t xfer, *reply;
+    pmix_buffer_t xfer, *reply, *shared = NULL;
+    pmix_bfrops_module_t *sbfrops = NULL;
+    pmix_bfrop_buffer_type_t stype = PMIX_BFROP_BUFFER_UNDEF;
+    pmix_gds_base_module_t *sgds = NULL;
     pmix_server_caddy_t *cd, *nxt;
     pmix_status_t rc = PMIX_SUCCESS, ret;
     pmix_nspace_caddy_t *nptr;
@@ -201,37 +204,58 @@ finish_collective:
      * given: writing it into rc would report a failed fence as a success
      * to every participant after the first. */
     PMIX_LIST_FOREACH_SAFE (cd, nxt, &tracker->local_cbs, pmix_server_caddy_t) {
-        reply = PMIX_NEW(pmix_buffer_t);
-        if (NULL == reply) {
-            PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
-            continue;
-        }
-        /* setup the reply, starting with the returned status */
-        PMIX_BFROPS_PACK(ret, cd->peer, reply, &rc, 1, PMIX_STATUS);
-        if (PMIX_SUCCESS != ret) {
-            PMIX_ERROR_LOG(ret);
-            PMIX_RELEASE(reply);
-            continue;
-        }
-        /* let the gds have a chance to add any data it needs
-         * for providing access to any collected data */
-        PMIX_GDS_MARK_MODEX_COMPLETE(ret, cd->peer, &nslist, reply);
-        if (PMIX_SUCCESS != ret) {
-            PMIX_RELEASE(reply);
-            PMIX_ERROR_LOG(ret);
-            continue;
+        /* The release depends only on the status, the nspace list, and
+         * the participant's wire format and gds module - and on a node
+         * those are nearly always the same for everyone. Build it once
+         * per combination and queue that one buffer to each participant
+         * it fits, rather than packing and holding one per process.
+         * Participants are served in order, so a participant that
+         * differs from the last simply gets a fresh buffer. */
+        if (NULL != shared &&
+            cd->peer->nptr->compat.bfrops == sbfrops &&
+            cd->peer->nptr->compat.type == stype &&
+            PMIX_GDS_PEER_MODULE(cd->peer) == sgds) {
+            reply = shared;
+        } else {
+            reply = PMIX_NEW(pmix_buffer_t);
+            if (NULL == reply) {
+                PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
+                continue;
+            }
+            /* setup the reply, starting with the returned status */
+            PMIX_BFROPS_PACK(ret, cd->peer, reply, &rc, 1, PMIX_STATUS);
+            if (PMIX_SUCCESS != ret) {
+                PMIX_ERROR_LOG(ret);
+                PMIX_RELEASE(reply);
+                continue;
+            }
+            /* let the gds have a chance to add any data it needs
+             * for providing access to any collected data */
+            PMIX_GDS_MARK_MODEX_COMPLETE(ret, cd->peer, &nslist, reply);
+            if (PMIX_SUCCESS != ret) {
+                PMIX_RELEASE(reply);
+                PMIX_ERROR_LOG(ret);
+                continue;
+            }
+            if (NULL != shared) {
+                PMIX_RELEASE(shared);
+            }
+            shared = reply;
+            sbfrops = cd->peer->nptr->compat.bfrops;
+            stype = cd->peer->nptr->compat.type;
+            sgds = PMIX_GDS_PEER_MODULE(cd->peer);
         }
         pmix_output_verbose(2, pmix_server_globals.base_output,
                             "server:modex_cbfunc reply being sent to %s:%u",
                             cd->peer->info->pname.nspace, cd->peer->info->pname.rank);
-        PMIX_SERVER_QUEUE_REPLY(ret, cd->peer, cd->hdr.tag, reply);
-        if (PMIX_SUCCESS != ret) {
-            PMIX_RELEASE(reply);
-        }
+        PMIX_SERVER_QUEUE_SHARED_REPLY(ret, cd->peer, cd->hdr.tag, reply);
         /* remove this entry */
         pmix_list_remove_item(&tracker->local_cbs, &cd->super);
         PMIX_RELEASE(cd);
     }
+    if (NULL != shared) {
+        PMIX_RELEASE(shared);
+    }
 
     /* Protect data from being free'd because RM pass
      * the pointer that is set to the middle of some
@@ -242,7 +266,7 @@ finish_collective:
     xfer.bytes_used = 0;
     PMIX_DESTRUCT(&xfer);
 
-    pmix_list_remove_item(&pmix_server_globals.collectives, &tracker->super);
+    pmix_server_untrack_collective(tracker);
     PMIX_RELEASE(tracker);
     PMIX_LIST_DESTRUCT(&nslist);
 
@@ -620,7 +644,7 @@ participant_error:
     if (NULL != nspaces) {
         PMIx_Argv_free(nspaces);
     }
-    pmix_list_remove_item(&pmix_server_globals.collectives, &tracker->super);
+    pmix_server_untrack_collective(tracker);
     PMIX_RELEASE(tracker);
 
     /* we are done */
@@ -715,7 +739,7 @@ static void _discnct(int sd, short args, void *cbdata)
 
     /* cleanup the tracker -- the host RM is responsible for
      * telling us when to remove the nspace from our data */
-    pmix_list_remove_item(&pmix_server_globals.collectives, &tracker->super);
+    pmix_server_untrack_collective(tracker);
     PMIX_RELEASE(tracker);
 
     /* we are done */
@@ -182,6 +182,10 @@ pmix_status_t pmix_server_abort(pmix_peer_t *peer, pmix_buffer_t *buf,
         }
     }
 
+    /* whatever the host does about it, the job is no longer the one
+     * any cached query answers describe */
+    pmix_server_query_cache_event(PMIX_ERR_PROC_REQUESTED_ABORT);
+
     /* let the local host's server execute it */
     if (NULL == pmix_host_server.abort) {
         rc = PMIX_ERR_NOT_SUPPORTED;
@@ -24,6 +24,7 @@
 #include "pmix_common.h"
 #include "pmix_server.h"
 
+#include "src/class/pmix_bitmap.h"
 #include "src/class/pmix_hotel.h"
 #include "src/include/pmix_globals.h"
 #include "src/include/pmix_types.h"
@@ -92,13 +93,46 @@ typedef struct {
 } pmix_dmdx_remote_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_dmdx_remote_t);
 
+/* The packed answer to a direct-modex request for one local rank, as
+ * of the rank's modex_gen when it was packed. Cached entries sit on
+ * pmix_server_globals.dmodex_cache, least recently used first, and
+ * hold a reference on their rank_info. */
+typedef struct pmix_dmodex_reply_t {
+    pmix_list_item_t super;
+    pmix_rank_info_t *info;
+    uint64_t gen;
+    char *data;
+    size_t size;
+} pmix_dmodex_reply_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_dmodex_reply_t);
+
+/* The host's answer to a set of queries, kept so that the same set
+ * asked again before it expires is answered without the host. Cached
+ * entries sit on pmix_server_globals.query_cache, oldest first, and are
+ * found through query_cache_index by their normalized query set. */
 typedef struct {
+    pmix_list_item_t super;
+    char *key;          // the normalized query set
+    pmix_info_t *info;
+    size_t ninfo;
+    uint64_t expires;   // msec on the monotonic clock
+} pmix_query_reply_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_query_reply_t);
+
+typedef struct pmix_dmdx_local_t {
     pmix_list_item_t super;
     pmix_proc_t proc;     // id of proc whose data is being requested
     pmix_list_t loc_reqs; // list of pmix_dmdx_request_t elem is keeping track of
                           // all local ranks that are interested in this namespace-rank
     pmix_info_t *info;    // array of info structs for this request
     size_t ninfo;         // number of info structs
+    bool prefetch;        // created speculatively, not for a requester - see pmix_server_get.c
+    /* where lookups find this tracker: its key in
+     * pmix_server_globals.local_reqs_index, and the next tracker filed
+     * under the same key. Set while the tracker is on local_reqs. */
+    bool indexed;
+    uint64_t index_key;
+    struct pmix_dmdx_local_t *index_next;
 } pmix_dmdx_local_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_dmdx_local_t);
 
@@ -145,14 +179,93 @@ typedef struct {
 } pmix_iof_cache_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_iof_cache_t);
 
+/* a run of consecutive ranks, both ends included */
+typedef struct {
+    pmix_rank_t first;
+    pmix_rank_t last;
+} pmix_rank_range_t;
+
+struct pmix_pset_t;
+struct pmix_pset_nspace_t;
+
+/* A process set's members within one nspace, held as sorted, disjoint
+ * and non-adjacent rank ranges - a set naming a contiguous block of a
+ * large job costs one range, not one proc per rank. These are also the
+ * entries of the membership index: each sits on the pmix_pset_nspace_t
+ * of its nspace, alongside those of every other set naming it */
 typedef struct {
+    pmix_list_item_t super;
+    struct pmix_pset_t *pset;   // the set this belongs to - not retained
+    struct pmix_pset_nspace_t *nsidx; // the index entry it sits on
+    bool wildcard;              // the whole nspace is a member
+    pmix_rank_range_t *ranges;
+    size_t nranges;
+} pmix_pset_member_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_pset_member_t);
+
+/* every known process set's members within one nspace, found through
+ * pmix_server_globals.psets_index */
+typedef struct pmix_pset_nspace_t {
+    pmix_object_t super;
+    pmix_nspace_t nspace;
+    pmix_list_t members;        // pmix_pset_member_t, in definition order
+} pmix_pset_nspace_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_pset_nspace_t);
+
+typedef struct pmix_pset_t {
     pmix_list_item_t super;
     char *name;
-    pmix_proc_t *members;
+    /* one per nspace the set names, each retained here and by the
+     * index - see pmix_server_pset.c */
+    pmix_pset_member_t **members;
     size_t nmembers;
 } pmix_pset_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_pset_t);
 
+/* A group's membership, one entry per nspace with its ranks as bits -
+ * see pmix_server_grpset.c. Ranks from PMIX_GRP_RANK_BITS up go on a
+ * short list instead, so a stray rank off the wire cannot size a bitmap */
+#define PMIX_GRP_RANK_BITS (1 << 24)
+
+typedef struct {
+    pmix_list_item_t super;
+    pmix_nspace_t nspace;
+    pmix_bitmap_t ranks;   // ranks below PMIX_GRP_RANK_BITS named individually
+    pmix_list_t others;    // pmix_proclist_t - the ranks named past that
+    bool wildcard;         // the whole nspace is named
+    size_t first;          // where the nspace first appears in the array
+                           //    the set was built alongside, if any
+} pmix_grp_nsmbrs_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_grp_nsmbrs_t);
+
+typedef struct {
+    pmix_object_t super;
+    pmix_list_t nspaces;     // pmix_grp_nsmbrs_t, one per nspace named
+    pmix_hash_table_t index; // the same, by nspace
+} pmix_grp_mbrset_t;
+PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_grp_mbrset_t);
+
+/* The union of proc arrays, in the order the procs first appear. It
+ * starts as a base array and pmix_grp_union_merge() extends it with
+ * whatever each further array names that it lacks, in PMIX_CHECK_PROCID's
+ * sense: a WILDCARD rank for a nspace already present widens that
+ * nspace's first entry to WILDCARD rather than adding another. */
+typedef struct {
+    pmix_grp_mbrset_t set;
+    pmix_proc_t **base;
+    size_t *nbase;
+    pmix_proc_t *extra;  // what is being added, in order
+    size_t nextra;
+    size_t nalloc;
+} pmix_grp_union_t;
+
+/* What a departure means to a group block still in its local phase */
+typedef enum {
+    PMIX_GRP_DEPART_IGNORE,  // not a member, or it already contributed
+    PMIX_GRP_DEPART_KNOWN,   // already counted as departed
+    PMIX_GRP_DEPART_NEW      // newly departed, and now on the gone set
+} pmix_grp_depart_t;
+
 typedef struct {
     bool module_set;    // pmix_host_server has been set
     pmix_list_t nspaces;          // list of pmix_nspace_t for the nspaces we know about
@@ -166,21 +279,45 @@ typedef struct {
      * matter of course. See _findpeer() in src/common/pmix_data.c */
     pmix_pointer_array_t peer_cache;
     pmix_list_t collectives;      // list of active pmix_server_trkr_t
+    pmix_hash_table_t collectives_index; // the same trackers, by id or participant set
     pmix_list_t remote_pnd; // list of pmix_dmdx_remote_t awaiting arrival of data fror servicing
                             // remote req's
     pmix_list_t local_reqs;     // list of pmix_dmdx_local_t awaiting arrival of data from local neighbours
+    pmix_hash_table_t local_reqs_index; // the same trackers, by nspace and rank
+    pmix_list_t dmodex_cache;   // pmix_dmodex_reply_t, least recently used first
+    size_t dmodex_cache_bytes;  // sum of the cached replies' sizes
+    size_t dmodex_cache_size;   // cap on the above; 0 = cache nothing
+    bool dmodex_batch;          // host's direct_modex takes PMIX_DMODEX_BATCH requests
+    pmix_list_t dmodex_batches; // open batches of dmodex requests - see pmix_server_get.c
+    pmix_hash_table_t dmodex_batches_index; // the same batches, by nspace and node
+    unsigned int dmodex_batch_window; // usec a batch stays open; 0 = no batching
+    size_t dmodex_batch_max;    // targets at which a batch goes at once
+    bool dmodex_prefetch;       // fetch a remote target's node peers along with it
+    size_t dmodex_prefetched;   // targets fetched speculatively
+    size_t dmodex_prefetch_hits; // ...and later asked for
+    pmix_list_t query_cache;    // pmix_query_reply_t, oldest first
+    pmix_hash_table_t query_cache_index; // the same, by normalized query set
+    unsigned int query_cache_ttl; // msec a host query answer is reused; 0 = never
+    char *query_cache_key_ttls; // per-key overrides of the above, "key=msec,..."
+    size_t query_cache_max;     // answers kept
     pmix_list_t gdata;  // cache of data given to me for passing to all clients
     char **genvars;     // argv array of envars given to me for passing to all clients
     pmix_list_t events; // list of pmix_regevents_info_t registered events
+    pmix_hash_table_t events_index; // the same registrations, by code
+    pmix_regevents_info_t *default_events; // default handlers - not in the index
+    uint64_t events_stamp; // last notification fanned out to our clients
     pmix_list_t iof;    // IO to be forwarded to clients
     pmix_list_t iof_residuals;  // leftover bytes waiting for newline
     pmix_list_t psets;  // list of known psets and memberships
+    pmix_hash_table_t psets_index; // their memberships, by nspace
     size_t max_iof_cache; // max number of IOF messages to cache
     bool tool_connections_allowed;
     char *tmpdir;             // temporary directory for this server
     char *system_tmpdir;      // system tmpdir
     bool fence_localonly_opt; // local-only fence optimization
     bool fence_delta_modex;   // contribute only what changed since our last collecting fence
+    unsigned int fence_threads;   // threads assembling a fence contribution; 0 = one per cpu
+    size_t fence_compress_chunk;  // compress a contribution in pieces of this size; 0 = whole
     pmix_list_t grp_collectives;  // group-op collectives
     pmix_pointer_array_t monitors;  // monitoring operations
     // verbosity for server get operations
@@ -267,6 +404,22 @@ PMIX_EXPORT void pmix_server_fail_remote_pnd(pmix_peer_t *peer,
                                              pmix_proc_t *proc,
                                              pmix_status_t status);
 
+/* The packed answer to a direct-modex request for a local rank that
+ * has committed: its PMIX_REMOTE-scope data, as the requesting server
+ * unpacks it. Served from the cache while the rank's modex_gen is the
+ * one it was packed at, packed afresh (and cached, if it fits under
+ * dmodex_cache_size) otherwise. The reply comes back with a reference
+ * the caller must release. */
+PMIX_EXPORT pmix_status_t pmix_server_dmodex_reply(pmix_rank_info_t *info,
+                                                   pmix_dmodex_reply_t **reply);
+
+/* Drop the rank's cached reply, if it has one - for when its data has
+ * changed or the rank has gone. */
+PMIX_EXPORT void pmix_server_dmodex_forget(pmix_rank_info_t *info);
+
+/* ... and every cached reply, at finalize */
+PMIX_EXPORT void pmix_server_dmodex_forget_all(void);
+
 PMIX_EXPORT pmix_status_t pmix_server_abort(pmix_peer_t *peer, pmix_buffer_t *buf,
                                             pmix_op_cbfunc_t cbfunc, void *cbdata);
 
@@ -324,6 +477,28 @@ PMIX_EXPORT void pmix_server_deregister_events(pmix_peer_t *peer, pmix_buffer_t
 PMIX_EXPORT pmix_status_t pmix_server_query(pmix_peer_t *peer, pmix_buffer_t *buf,
                                             pmix_info_cbfunc_t cbfunc, void *cbdata);
 
+/* The query cache. A set of queries the host is about to be asked is
+ * first normalized into a key - NULL if the set is not to be cached at
+ * all - and looked up. A hit returns the cached answer, which stays
+ * valid until the next call into the cache; a miss leaves the caller to
+ * ask the host and store a successful answer under the same key. See
+ * pmix_server_control.c. */
+PMIX_EXPORT char *pmix_server_query_cache_key(pmix_query_t *queries, size_t nqueries,
+                                              unsigned int *ttl, bool *refresh);
+PMIX_EXPORT pmix_query_reply_t *pmix_server_query_cache_fetch(const char *key);
+PMIX_EXPORT void pmix_server_query_cache_store(char *key, unsigned int ttl,
+                                               const pmix_info_t *info, size_t ninfo);
+
+/* Drop every cached answer if the event changes what the host would
+ * say - a job or proc ending, or a job starting */
+PMIX_EXPORT void pmix_server_query_cache_event(pmix_status_t status);
+
+/* Drop every cached answer - for nspace (de)registration */
+PMIX_EXPORT void pmix_server_query_cache_forget_all(void);
+
+/* ... and the parsed per-key TTLs with them, at finalize */
+PMIX_EXPORT void pmix_server_query_cache_finalize(void);
+
 PMIX_EXPORT pmix_status_t pmix_server_log(pmix_peer_t *peer, pmix_buffer_t *buf,
                                           pmix_op_cbfunc_t cbfunc, void *cbdata);
 
@@ -411,6 +586,11 @@ PMIX_EXPORT void pmix_server_deactivate_events(pmix_status_t *codes, size_t ncod
  * was released. */
 PMIX_EXPORT bool pmix_server_prune_reginfo(pmix_regevents_info_t *reginfo);
 
+/* Return the object tracking registrations for the given code, or NULL
+ * if nobody has registered for it. PMIX_MAX_ERR_CONSTANT returns the
+ * default-handler registrations. */
+PMIX_EXPORT pmix_regevents_info_t *pmix_server_find_reginfo(pmix_status_t code);
+
 /* Handle the departure of a cleanly-finalized local client peer whose
  * socket has dropped: decrement the rank's live-process count and leave
  * the peer in place as an inert finalized "tombstone" at its existing
@@ -565,6 +745,14 @@ PMIX_EXPORT pmix_server_trkr_t *pmix_server_get_tracker(char *id, pmix_proc_t *p
 PMIX_EXPORT pmix_server_trkr_t *pmix_server_new_tracker(char *id, pmix_proc_t *procs,
                                                         size_t nprocs, pmix_cmd_t type);
 
+/* Put a tracker on pmix_server_globals.collectives, and file it where
+ * pmix_server_get_tracker() will look for it; and take it off both
+ * again. Anything that links or unlinks a tracker has to go through
+ * these - a tracker left in the index after it is released is a
+ * dangling pointer the next lookup with the same key follows. */
+PMIX_EXPORT void pmix_server_track_collective(pmix_server_trkr_t *trk);
+PMIX_EXPORT void pmix_server_untrack_collective(pmix_server_trkr_t *trk);
+
 /* Record that every local participant of this tracker has had its
  * contribution taken by the host, so the next one can carry only what
  * changes from here. Call it once the up-call has been accepted, never
@@ -604,4 +792,42 @@ PMIX_EXPORT void pmix_server_grp_peer_lost(pmix_peer_t *peer);
 
 PMIX_EXPORT void pmix_server_grp_member_left(const char *grpid, const pmix_proc_t *proc);
 
+/* Return the names of the known process sets the given proc belongs to,
+ * in the order the sets were defined, as an argv array the caller must
+ * free - or NULL if it belongs to none. Membership is in the
+ * PMIX_CHECK_PROCID sense: a WILDCARD rank on either side matches the
+ * whole nspace. */
+PMIX_EXPORT char **pmix_server_pset_membership(const pmix_proc_t *proc);
+
+/* Drop every known process set - for finalize */
+PMIX_EXPORT void pmix_server_purge_psets(void);
+
+/* Group membership sets - see pmix_server_grpset.c. "pos" is where the
+ * proc sits in the array the set is kept alongside, and only matters to
+ * a nspace's first entry. pmix_grp_mbrset_add_procs() adds all of the
+ * procs or, on an error, none of them. */
+PMIX_EXPORT bool pmix_grp_mbrset_has(pmix_grp_mbrset_t *set, const pmix_proc_t *proc);
+PMIX_EXPORT pmix_status_t pmix_grp_mbrset_add(pmix_grp_mbrset_t *set, const pmix_proc_t *proc,
+                                              size_t pos);
+PMIX_EXPORT pmix_status_t pmix_grp_mbrset_add_procs(pmix_grp_mbrset_t *set,
+                                                    const pmix_proc_t *procs, size_t nprocs);
+
+/* Account for a proc that will never contribute: ignored unless it is
+ * among "members" and not among "arrived", and put on "gone" the first
+ * time it is reported */
+PMIX_EXPORT pmix_grp_depart_t pmix_grp_mbrset_depart(pmix_grp_mbrset_t *members,
+                                                     pmix_grp_mbrset_t *arrived,
+                                                     pmix_grp_mbrset_t *gone,
+                                                     const pmix_proc_t *proc);
+
+/* Build a union over the array at *base, *nbase long. On finish the
+ * array is replaced with the union if anything was added - or, given an
+ * error status, left as it stands apart from any widened entries - and
+ * the status returned */
+PMIX_EXPORT pmix_status_t pmix_grp_union_start(pmix_grp_union_t *u, pmix_proc_t **base,
+                                               size_t *nbase);
+PMIX_EXPORT pmix_status_t pmix_grp_union_merge(pmix_grp_union_t *u, const pmix_proc_t *procs,
+                                               size_t nprocs);
+PMIX_EXPORT pmix_status_t pmix_grp_union_finish(pmix_grp_union_t *u, pmix_status_t status);
+
 #endif // PMIX_SERVER_OPS_H
@@ -59,6 +59,243 @@ static void release_info(pmix_status_t status, void *cbdata)
     free(cd);
 }
 
+/* Membership index
+ *
+ * Answering "which sets is this proc in" used to mean walking every
+ * member of every known set. Hosts running workflows define sets by the
+ * thousand on servers that live for days, so each set is now filed by
+ * the nspaces it names: pmix_server_globals.psets_index maps an nspace
+ * to a pmix_pset_nspace_t holding that nspace's share of every set that
+ * names it, each share a sorted array of rank ranges. A lookup is then
+ * one hash probe plus a binary search per set that names the proc's
+ * nspace - sets confined to other jobs are never looked at.
+ *
+ * A set's shares are built once, when it is defined, and are held both
+ * by the set and by the index; pset_untrack() takes them off the index
+ * before the set goes. */
+
+static pmix_pset_nspace_t *pset_nspace(const char *nspace)
+{
+    pmix_pset_nspace_t *idx;
+
+    if (PMIX_SUCCESS != pmix_hash_table_get_value_ptr(&pmix_server_globals.psets_index, nspace,
+                                                      strnlen(nspace, PMIX_MAX_NSLEN),
+                                                      (void **) &idx)) {
+        return NULL;
+    }
+    return idx;
+}
+
+/* by nspace, then by rank - so each nspace's members sit together with
+ * their ranks ascending, ready to be folded into ranges */
+static int proc_order(const void *a, const void *b)
+{
+    const pmix_proc_t *p = (const pmix_proc_t *) a;
+    const pmix_proc_t *q = (const pmix_proc_t *) b;
+    int rc;
+
+    rc = strncmp(p->nspace, q->nspace, PMIX_MAX_NSLEN);
+    if (0 != rc) {
+        return rc;
+    }
+    if (p->rank < q->rank) {
+        return -1;
+    }
+    return (p->rank > q->rank) ? 1 : 0;
+}
+
+/* Fold one nspace's worth of sorted members into ranges. Duplicates
+ * collapse, and a WILDCARD member is a flag rather than a rank - it is
+ * not a real rank, and must not be merged into a range with its
+ * numerical neighbours. */
+static pmix_status_t pset_fold(pmix_pset_member_t *mb, const pmix_proc_t *procs, size_t nprocs)
+{
+    pmix_rank_range_t *rng, *last = NULL;
+    size_t n;
+
+    mb->ranges = (pmix_rank_range_t *) malloc(nprocs * sizeof(pmix_rank_range_t));
+    if (NULL == mb->ranges) {
+        return PMIX_ERR_NOMEM;
+    }
+    for (n = 0; n < nprocs; n++) {
+        if (PMIX_RANK_WILDCARD == procs[n].rank) {
+            mb->wildcard = true;
+            continue;
+        }
+        if (NULL != last) {
+            if (procs[n].rank <= last->last) {
+                continue;
+            }
+            /* sorted, so the rank is above last->last and the
+             * subtraction cannot wrap */
+            if (procs[n].rank - 1 == last->last) {
+                last->last = procs[n].rank;
+                continue;
+            }
+        }
+        last = &mb->ranges[mb->nranges++];
+        last->first = procs[n].rank;
+        last->last = procs[n].rank;
+    }
+    if (0 == mb->nranges) {
+        free(mb->ranges);
+        mb->ranges = NULL;
+    } else if (mb->nranges < nprocs) {
+        /* hand back what compression saved - keeping the original block
+         * is harmless if this fails */
+        rng = (pmix_rank_range_t *) realloc(mb->ranges, mb->nranges * sizeof(pmix_rank_range_t));
+        if (NULL != rng) {
+            mb->ranges = rng;
+        }
+    }
+    return PMIX_SUCCESS;
+}
+
+static void pset_untrack(pmix_pset_t *ps)
+{
+    pmix_pset_member_t *mb;
+    pmix_pset_nspace_t *idx;
+    size_t n;
+
+    for (n = 0; n < ps->nmembers; n++) {
+        mb = ps->members[n];
+        idx = mb->nsidx;
+        if (NULL == idx) {
+            continue;
+        }
+        pmix_list_remove_item(&idx->members, &mb->super);
+        mb->nsidx = NULL;
+        PMIX_RELEASE(mb);
+        if (0 == pmix_list_get_size(&idx->members)) {
+            pmix_hash_table_remove_value_ptr(&pmix_server_globals.psets_index, idx->nspace,
+                                             strnlen(idx->nspace, PMIX_MAX_NSLEN));
+            PMIX_RELEASE(idx);
+        }
+    }
+}
+
+/* Build the set's per-nspace shares from its member array and file each
+ * on the index. On failure whatever was filed is taken off again. */
+static pmix_status_t pset_track(pmix_pset_t *ps, const pmix_proc_t *procs, size_t nprocs)
+{
+    pmix_proc_t *sorted;
+    pmix_pset_member_t *mb;
+    pmix_pset_nspace_t *idx;
+    size_t n, m, nns;
+    pmix_status_t rc = PMIX_SUCCESS;
+
+    sorted = (pmix_proc_t *) malloc(nprocs * sizeof(pmix_proc_t));
+    if (NULL == sorted) {
+        return PMIX_ERR_NOMEM;
+    }
+    memcpy(sorted, procs, nprocs * sizeof(pmix_proc_t));
+    qsort(sorted, nprocs, sizeof(pmix_proc_t), proc_order);
+
+    nns = 1;
+    for (n = 1; n < nprocs; n++) {
+        if (!PMIX_CHECK_NSPACE(sorted[n].nspace, sorted[n - 1].nspace)) {
+            ++nns;
+        }
+    }
+    ps->members = (pmix_pset_member_t **) calloc(nns, sizeof(pmix_pset_member_t *));
+    if (NULL == ps->members) {
+        free(sorted);
+        return PMIX_ERR_NOMEM;
+    }
+
+    for (n = 0; n < nprocs; n = m) {
+        /* [n, m) is one nspace's share */
+        for (m = n + 1; m < nprocs && PMIX_CHECK_NSPACE(sorted[m].nspace, sorted[n].nspace); m++) {
+            continue;
+        }
+        mb = PMIX_NEW(pmix_pset_member_t);
+        if (NULL == mb) {
+            rc = PMIX_ERR_NOMEM;
+            break;
+        }
+        mb->pset = ps;
+        rc = pset_fold(mb, &sorted[n], m - n);
+        if (PMIX_SUCCESS != rc) {
+            PMIX_RELEASE(mb);
+            break;
+        }
+        idx = pset_nspace(sorted[n].nspace);
+        if (NULL == idx) {
+            idx = PMIX_NEW(pmix_pset_nspace_t);
+            if (NULL == idx) {
+                PMIX_RELEASE(mb);
+                rc = PMIX_ERR_NOMEM;
+                break;
+            }
+            PMIX_LOAD_NSPACE(idx->nspace, sorted[n].nspace);
+            rc = pmix_hash_table_set_value_ptr(&pmix_server_globals.psets_index, idx->nspace,
+                                               strnlen(idx->nspace, PMIX_MAX_NSLEN), idx);
+            if (PMIX_SUCCESS != rc) {
+                PMIX_RELEASE(idx);
+                PMIX_RELEASE(mb);
+                break;
+            }
+        }
+        /* one reference for the set, one for the index */
+        PMIX_RETAIN(mb);
+        mb->nsidx = idx;
+        pmix_list_append(&idx->members, &mb->super);
+        ps->members[ps->nmembers++] = mb;
+    }
+    free(sorted);
+
+    if (PMIX_SUCCESS != rc) {
+        pset_untrack(ps);
+    }
+    return rc;
+}
+
+static bool pset_has_rank(pmix_pset_member_t *mb, pmix_rank_t rank)
+{
+    size_t lo = 0, hi = mb->nranges, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (rank < mb->ranges[mid].first) {
+            hi = mid;
+        } else if (rank > mb->ranges[mid].last) {
+            lo = mid + 1;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+char **pmix_server_pset_membership(const pmix_proc_t *proc)
+{
+    pmix_pset_nspace_t *idx;
+    pmix_pset_member_t *mb;
+    char **names = NULL;
+
+    idx = pset_nspace(proc->nspace);
+    if (NULL == idx) {
+        return NULL;
+    }
+    PMIX_LIST_FOREACH (mb, &idx->members, pmix_pset_member_t) {
+        if (mb->wildcard || PMIX_RANK_WILDCARD == proc->rank || pset_has_rank(mb, proc->rank)) {
+            PMIx_Argv_append_nosize(&names, mb->pset->name);
+        }
+    }
+    return names;
+}
+
+void pmix_server_purge_psets(void)
+{
+    pmix_pset_t *ps, *next;
+
+    PMIX_LIST_FOREACH_SAFE (ps, next, &pmix_server_globals.psets, pmix_pset_t) {
+        pmix_list_remove_item(&pmix_server_globals.psets, &ps->super);
+        pset_untrack(ps);
+        PMIX_RELEASE(ps);
+    }
+}
+
 static void psetdef(int sd, short args, void *cbdata)
 {
     pmix_setup_caddy_t *cd = (pmix_setup_caddy_t *) cbdata;
@@ -86,14 +323,16 @@ static void psetdef(int sd, short args, void *cbdata)
         goto done;
     }
     ps->name = strdup(cd->nspace);
-    ps->members = (pmix_proc_t *) malloc(cd->nprocs * sizeof(pmix_proc_t));
-    if (NULL == ps->name || NULL == ps->members) {
+    if (NULL == ps->name) {
         PMIX_RELEASE(ps);
         rc = PMIX_ERR_NOMEM;
         goto done;
     }
-    memcpy(ps->members, cd->procs, cd->nprocs * sizeof(pmix_proc_t));
-    ps->nmembers = cd->nprocs;
+    rc = pset_track(ps, cd->procs, cd->nprocs);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_RELEASE(ps);
+        goto done;
+    }
     pmix_list_append(&pmix_server_globals.psets, &ps->super);
 
     /* now tell any local registrants about it */
@@ -213,6 +452,7 @@ static void psetdel(int sd, short args, void *cbdata)
     PMIX_LIST_FOREACH (ps, &pmix_server_globals.psets, pmix_pset_t) {
         if (0 == strcmp(cd->nspace, ps->name)) {
             pmix_list_remove_item(&pmix_server_globals.psets, &ps->super);
+            pset_untrack(ps);
             PMIX_RELEASE(ps);
             break;
         }
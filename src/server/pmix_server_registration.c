@@ -54,7 +54,7 @@
 static void _register_nspace(int sd, short args, void *cbdata)
 {
     pmix_setup_caddy_t *cd = (pmix_setup_caddy_t *) cbdata;
-    pmix_namespace_t *nptr, *tmp;
+    pmix_namespace_t *nptr;
     pmix_status_t rc;
     size_t i, m, ninfo;
     pmix_info_t *iptr;
@@ -77,14 +77,12 @@ static void _register_nspace(int sd, short args, void *cbdata)
 
     PMIX_HIDE_UNUSED_PARAMS(sd, args);
 
+    /* a new job changes what the host says about the namespaces and
+     * their procs, so answers kept from before it are out of date */
+    pmix_server_query_cache_forget_all();
+
     /* see if we already have this nspace */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(tmp->nspace, cd->proc.nspace)) {
-            nptr = tmp;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(cd->proc.nspace);
     if (NULL == nptr) {
         nptr = PMIX_NEW(pmix_namespace_t);
         if (NULL == nptr) {
@@ -101,7 +99,7 @@ static void _register_nspace(int sd, short args, void *cbdata)
             rc = PMIX_ERR_NOMEM;
             goto release;
         }
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
     }
     if (0 > cd->nlocalprocs) {
         /* this is just an update, so we store it
@@ -267,13 +265,9 @@ static void _register_nspace(int sd, short args, void *cbdata)
              * if the nspaces are all completely registered */
             if (all_def) {
                 /* so far, they have all been defined - check this one */
-                PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-                    if (0 == strcmp(trk->pcs[i].nspace, ns->nspace)) {
-                        if (SIZE_MAX == ns->nlocalprocs || !ns->all_registered) {
-                            all_def = false;
-                        }
-                        break;
-                    }
+                ns = pmix_nspace_lookup(trk->pcs[i].nspace);
+                if (NULL != ns && (SIZE_MAX == ns->nlocalprocs || !ns->all_registered)) {
+                    all_def = false;
                 }
             }
             /* now see if this nspace is the one we just registered */
@@ -507,7 +501,7 @@ void pmix_server_purge_events(pmix_peer_t *peer, pmix_proc_t *proc,
                 /* if this client was the only target, then just
                  * evict the notification */
                 if (1 == ncd->ntargets) {
-                    pmix_hotel_checkout(&pmix_globals.notifications, i);
+                    pmix_notify_event_uncache(ncd);
                     PMIX_RELEASE(ncd);
                 } else if (PMIX_RANK_WILDCARD == tgt->rank && NULL != proc
                            && PMIX_RANK_WILDCARD == proc->rank) {
@@ -620,107 +614,119 @@ void pmix_server_peer_finalized(pmix_peer_t *peer)
     PMIX_RELEASE(peer);
 }
 
-static void remove_client(pmix_namespace_t *nptr, pmix_proc_t *p)
+/* Give back everything a local rank held - its peer, its resources, its
+ * entry on the namespace's rank list. p names the rank when it alone is
+ * leaving, and is NULL when the whole namespace is. */
+static void release_rank(pmix_namespace_t *nptr, pmix_rank_info_t *info, pmix_proc_t *p)
 {
-    pmix_rank_info_t *info, *inext;
     pmix_peer_t *peer;
     pmix_proc_t proc;
 
-    PMIX_LIST_FOREACH_SAFE(info, inext, &nptr->ranks, pmix_rank_info_t) {
-        if (NULL == p || info->pname.rank == p->rank) {
-            if (NULL == p) {
-                PMIX_LOAD_PROCID(&proc, info->pname.nspace, info->pname.rank);
-            } else {
-                memcpy(&proc, p, sizeof(pmix_proc_t));
-            }
-            /* if this client failed to call finalize, we still need
-             * to restore any allocations that were given to it */
-            peer = (pmix_peer_t *) pmix_pointer_array_get_item(&pmix_server_globals.clients, info->peerid);
-            if (NULL == peer) {
-                /* this peer never connected, and hence it won't finalize,
-                 * so account for it here */
-                nptr->nfinalized++;
-                /* even if they never connected, resources were allocated
-                 * to them, so we need to ensure they are properly released */
-                pmix_pnet.child_finalized(&proc);
-                pmix_pgpu.child_finalized(&proc);
-            } else {
-                if (!peer->finalized) {
-                    /* this peer connected to us, but is being deregistered
-                     * without having finalized. This usually means an
-                     * abnormal termination that was picked up by
-                     * our host prior to our seeing the connection drop.
-                     * It is also possible that we missed the dropped
-                     * connection, so mark the peer as finalized so
-                     * we don't duplicate account for it and take care
-                     * of it here */
-                    peer->finalized = true;
-                    nptr->nfinalized++;
-                }
-                /* resources may have been allocated to them, so
-                 * ensure they get cleaned up - this isn't true
-                 * for tools, so don't clean them up */
-                if (!PMIX_PEER_IS_TOOL(peer)) {
-                    pmix_pnet.child_finalized(&proc);
-                    pmix_pgpu.child_finalized(&proc);
-                    pmix_psensor.stop(peer, NULL);
-                }
-                /* honor any registered epilogs */
-                pmix_execute_epilog(&peer->epilog);
-                /* ensure we close the socket to this peer so we don't
-                 * generate "connection lost" events should it be
-                 * subsequently "killed" by the host */
-                CLOSE_THE_SOCKET(peer->sd);
-                // remove it from our client array
-                pmix_pointer_array_set_item(&pmix_server_globals.clients, info->peerid, NULL);
-                PMIX_RELEASE(peer);
-            }
-            /* Fire the "all local processes finalized" callback exactly
-             * once. In the tombstone model a finalized peer stays counted in
-             * nfinalized until it is reclaimed, so nfinalized is already
-             * saturated at nlocalprocs here and this equality holds on every
-             * rank we iterate; without the guard the callback would fire once
-             * per rank as the nspace is torn down. */
-            if (!nptr->local_app_fini_fired &&
-                nptr->nlocalprocs == nptr->nfinalized) {
-                nptr->local_app_fini_fired = true;
-                pmix_pnet.local_app_finalized(nptr);
-                pmix_pgpu.local_app_finalized(nptr);
-            }
-            /* Remember that this rank existed and is gone.
-             *
-             * The entry below is about to be destroyed, and once it is,
-             * a direct-modex request naming this rank looks exactly like
-             * one that arrived before the rank was ever registered -
-             * which _dmodex_req() answers by waiting. Nothing would ever
-             * end that wait. Record the departure so it can answer "not
-             * found" instead, which is the same thing a request already
-             * parked when the proc finalized is told.
-             *
-             * Only for a named rank: p == NULL is the namespace being
-             * torn down, and this list dies with it. */
-            if (NULL != p) {
-                pmix_proclist_t *dp = PMIX_NEW(pmix_proclist_t);
-                if (NULL != dp) {
-                    PMIX_LOAD_PROCID(&dp->proc, info->pname.nspace,
-                                     info->pname.rank);
-                    pmix_list_append(&nptr->departed, &dp->super);
-                }
-            }
-            pmix_list_remove_item(&nptr->ranks, &info->super);
-            PMIX_RELEASE(info);
-            if (NULL != p) {
-                break;
-            }
+    if (NULL == p) {
+        PMIX_LOAD_PROCID(&proc, info->pname.nspace, info->pname.rank);
+    } else {
+        memcpy(&proc, p, sizeof(pmix_proc_t));
+    }
+    /* if this client failed to call finalize, we still need
+     * to restore any allocations that were given to it */
+    peer = (pmix_peer_t *) pmix_pointer_array_get_item(&pmix_server_globals.clients, info->peerid);
+    if (NULL == peer) {
+        /* this peer never connected, and hence it won't finalize,
+         * so account for it here */
+        nptr->nfinalized++;
+        /* even if they never connected, resources were allocated
+         * to them, so we need to ensure they are properly released */
+        pmix_pnet.child_finalized(&proc);
+        pmix_pgpu.child_finalized(&proc);
+    } else {
+        if (!peer->finalized) {
+            /* this peer connected to us, but is being deregistered
+             * without having finalized. This usually means an
+             * abnormal termination that was picked up by
+             * our host prior to our seeing the connection drop.
+             * It is also possible that we missed the dropped
+             * connection, so mark the peer as finalized so
+             * we don't duplicate account for it and take care
+             * of it here */
+            peer->finalized = true;
+            nptr->nfinalized++;
+        }
+        /* resources may have been allocated to them, so
+         * ensure they get cleaned up - this isn't true
+         * for tools, so don't clean them up */
+        if (!PMIX_PEER_IS_TOOL(peer)) {
+            pmix_pnet.child_finalized(&proc);
+            pmix_pgpu.child_finalized(&proc);
+            pmix_psensor.stop(peer, NULL);
         }
+        /* honor any registered epilogs */
+        pmix_execute_epilog(&peer->epilog);
+        /* ensure we close the socket to this peer so we don't
+         * generate "connection lost" events should it be
+         * subsequently "killed" by the host */
+        CLOSE_THE_SOCKET(peer->sd);
+        // remove it from our client array
+        pmix_pointer_array_set_item(&pmix_server_globals.clients, info->peerid, NULL);
+        PMIX_RELEASE(peer);
+    }
+    /* Fire the "all local processes finalized" callback exactly
+     * once. In the tombstone model a finalized peer stays counted in
+     * nfinalized until it is reclaimed, so nfinalized is already
+     * saturated at nlocalprocs here and this equality holds on every
+     * rank we iterate; without the guard the callback would fire once
+     * per rank as the nspace is torn down. */
+    if (!nptr->local_app_fini_fired &&
+        nptr->nlocalprocs == nptr->nfinalized) {
+        nptr->local_app_fini_fired = true;
+        pmix_pnet.local_app_finalized(nptr);
+        pmix_pgpu.local_app_finalized(nptr);
+    }
+    /* Remember that this rank existed and is gone.
+     *
+     * The entry below is about to be destroyed, and once it is,
+     * a direct-modex request naming this rank looks exactly like
+     * one that arrived before the rank was ever registered -
+     * which _dmodex_req() answers by waiting. Nothing would ever
+     * end that wait. Record the departure so it can answer "not
+     * found" instead, which is the same thing a request already
+     * parked when the proc finalized is told.
+     *
+     * Only for a named rank: p == NULL is the namespace being
+     * torn down, and this list dies with it. */
+    if (NULL != p) {
+        pmix_proclist_t *dp = PMIX_NEW(pmix_proclist_t);
+        if (NULL != dp) {
+            PMIX_LOAD_PROCID(&dp->proc, info->pname.nspace,
+                             info->pname.rank);
+            pmix_list_append(&nptr->departed, &dp->super);
+        }
+    }
+    /* a reply cached for it holds it, and nothing can ask for it now */
+    pmix_server_dmodex_forget(info);
+    pmix_nspace_remove_rank(nptr, info);
+    PMIX_RELEASE(info);
+}
+
+static void remove_client(pmix_namespace_t *nptr, pmix_proc_t *p)
+{
+    pmix_rank_info_t *info, *inext;
+
+    if (NULL != p) {
+        info = pmix_nspace_find_rank(nptr, p->rank);
+        if (NULL != info) {
+            release_rank(nptr, info, p);
+        }
+        return;
+    }
+    PMIX_LIST_FOREACH_SAFE(info, inext, &nptr->ranks, pmix_rank_info_t) {
+        release_rank(nptr, info, NULL);
     }
-    return;
 }
 
 static void _deregister_nspace(int sd, short args, void *cbdata)
 {
     pmix_setup_caddy_t *cd = (pmix_setup_caddy_t *) cbdata;
-    pmix_namespace_t *tmp, *nptr;
+    pmix_namespace_t *nptr;
     pmix_status_t rc;
 
     PMIX_ACQUIRE_OBJECT(cd);
@@ -755,14 +761,11 @@ static void _deregister_nspace(int sd, short args, void *cbdata)
      * cached notifications targeting procs from this nspace */
     pmix_server_purge_events(NULL, &cd->proc, PMIX_ERR_NOT_FOUND);
 
+    /* and any host query answers given while it existed */
+    pmix_server_query_cache_forget_all();
+
     // find the nspace object
-    nptr = NULL;
-    PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (PMIX_CHECK_NSPACE(tmp->nspace, cd->proc.nspace)) {
-            nptr = tmp;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(cd->proc.nspace);
     if (NULL == nptr) {
         /* nothing to do */
         goto cleanup;
@@ -775,7 +778,7 @@ static void _deregister_nspace(int sd, short args, void *cbdata)
     pmix_execute_epilog(&nptr->epilog);
 
     /* remove and release it */
-    pmix_list_remove_item(&pmix_globals.nspaces, &nptr->super);
+    pmix_nspace_remove(nptr);
     PMIX_RELEASE(nptr);
 
 cleanup:
@@ -924,7 +927,7 @@ static void fail_collective(pmix_server_trkr_t *trk, pmix_status_t status)
         trk->op_cbfunc(status, trk);
         return;
     }
-    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_untrack_collective(trk);
     PMIX_RELEASE(trk);
 }
 
@@ -1044,7 +1047,7 @@ void pmix_server_execute_collective(int sd, short args, void *cbdata)
          * does not, then unlink before releasing */
         PMIX_ERROR_LOG(PMIX_ERR_NOT_FOUND);
         cancel_collective_timer(trk);
-        pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+        pmix_server_untrack_collective(trk);
         PMIX_RELEASE(trk);
     }
     PMIX_RELEASE(tcd);
@@ -1070,13 +1073,7 @@ static void _register_client(int sd, short args, void *cbdata)
                         (NULL == cd->server_object) ? "NULL" : "NON-NULL");
 
     /* see if we already have this nspace */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(ns->nspace, cd->proc.nspace)) {
-            nptr = ns;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(cd->proc.nspace);
     if (NULL == nptr) {
         /* there is no requirement in the Standard that hosts register
          * an nspace prior to registering clients for that nspace. So
@@ -1094,7 +1091,7 @@ static void _register_client(int sd, short args, void *cbdata)
             rc = PMIX_ERR_NOMEM;
             goto cleanup;
         }
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
     }
     /* Setup a peer object for this client - since the host server only
      * deals with the original processes and not any clones, this should
@@ -1104,12 +1101,10 @@ static void _register_client(int sd, short args, void *cbdata)
      * list permanently past nlocalprocs, all_registered is never set, and
      * every collective involving this namespace hangs with nothing
      * anywhere reporting why. */
-    PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
-        if (info->pname.rank == cd->proc.rank) {
-            PMIX_ERROR_LOG(PMIX_ERR_DUPLICATE_KEY);
-            rc = PMIX_ERR_DUPLICATE_KEY;
-            goto cleanup;
-        }
+    if (NULL != pmix_nspace_find_rank(nptr, cd->proc.rank)) {
+        PMIX_ERROR_LOG(PMIX_ERR_DUPLICATE_KEY);
+        rc = PMIX_ERR_DUPLICATE_KEY;
+        goto cleanup;
     }
     info = PMIX_NEW(pmix_rank_info_t);
     if (NULL == info) {
@@ -1126,7 +1121,7 @@ static void _register_client(int sd, short args, void *cbdata)
     info->uid = cd->uid;
     info->gid = cd->gid;
     info->server_object = cd->server_object;
-    pmix_list_append(&nptr->ranks, &info->super);
+    pmix_nspace_add_rank(nptr, info);
     /* see if we have everyone - note that nlocalprocs is set to
      * a default value to ensure we don't execute this
      * test until the host calls "register_nspace" */
@@ -1160,13 +1155,9 @@ static void _register_client(int sd, short args, void *cbdata)
                  * if the nspaces are all completely registered */
                 if (all_def) {
                     /* so far, they have all been defined - check this one */
-                    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
-                        if (0 == strcmp(trk->pcs[i].nspace, ns->nspace)) {
-                            if (SIZE_MAX == ns->nlocalprocs || !ns->all_registered) {
-                                all_def = false;
-                            }
-                            break;
-                        }
+                    ns = pmix_nspace_lookup(trk->pcs[i].nspace);
+                    if (NULL != ns && (SIZE_MAX == ns->nlocalprocs || !ns->all_registered)) {
+                        all_def = false;
                     }
                 }
                 /* now see if this nspace is the one to which the client we just
@@ -1277,7 +1268,7 @@ PMIX_EXPORT pmix_status_t PMIx_server_register_client(const pmix_proc_t *proc, u
 static void _deregister_client(int sd, short args, void *cbdata)
 {
     pmix_setup_caddy_t *cd = (pmix_setup_caddy_t *) cbdata;
-    pmix_namespace_t *nptr, *tmp;
+    pmix_namespace_t *nptr;
 
     PMIX_ACQUIRE_OBJECT(cd);
     PMIX_HIDE_UNUSED_PARAMS(sd, args);
@@ -1287,13 +1278,7 @@ static void _deregister_client(int sd, short args, void *cbdata)
                         cd->proc.rank);
 
     /* see if we already have this nspace */
-    nptr = NULL;
-    PMIX_LIST_FOREACH (tmp, &pmix_globals.nspaces, pmix_namespace_t) {
-        if (0 == strcmp(tmp->nspace, cd->proc.nspace)) {
-            nptr = tmp;
-            break;
-        }
-    }
+    nptr = pmix_nspace_lookup(cd->proc.nspace);
     if (NULL == nptr) {
         /* nothing to do */
         goto cleanup;
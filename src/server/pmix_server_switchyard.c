@@ -329,15 +329,13 @@ static pmix_status_t server_switchyard(pmix_peer_t *peer, uint32_t tag, pmix_buf
      * function for processing */
 
     if (PMIX_REQ_CMD == cmd) {
-        reply = PMIX_NEW(pmix_buffer_t);
-        if (NULL == reply) {
-            PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
-            return PMIX_ERR_NOMEM;
-        }
-        PMIX_GDS_REGISTER_JOB_INFO(rc, peer, reply);
+        /* the module hands back the reply - quite possibly the same
+         * buffer it gave the last client of this nspace, so it is
+         * queued exactly as it comes and never packed into */
+        reply = NULL;
+        PMIX_GDS_REGISTER_JOB_INFO(rc, peer, &reply);
         if (PMIX_SUCCESS != rc) {
             PMIX_ERROR_LOG(rc);
-            PMIX_RELEASE(reply);
             return rc;
         }
         PMIX_SERVER_QUEUE_REPLY(rc, peer, tag, reply);
@@ -381,15 +379,10 @@ static pmix_status_t server_switchyard(pmix_peer_t *peer, uint32_t tag, pmix_buf
         }
         free(modname);
         peer->gds = mod;
-        reply = PMIX_NEW(pmix_buffer_t);
-        if (NULL == reply) {
-            PMIX_ERROR_LOG(PMIX_ERR_NOMEM);
-            return PMIX_ERR_NOMEM;
-        }
-        PMIX_GDS_REGISTER_JOB_INFO(rc, peer, reply);
+        reply = NULL;
+        PMIX_GDS_REGISTER_JOB_INFO(rc, peer, &reply);
         if (PMIX_SUCCESS != rc) {
             PMIX_ERROR_LOG(rc);
-            PMIX_RELEASE(reply);
             return rc;
         }
         PMIX_SERVER_QUEUE_REPLY(rc, peer, tag, reply);
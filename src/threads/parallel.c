@@ -0,0 +1,157 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "pmix_config.h"
+
+#include <stdlib.h>
+#ifdef HAVE_UNISTD_H
+#    include <unistd.h>
+#endif
+
+#include "src/threads/pmix_parallel.h"
+#include "src/threads/pmix_threads.h"
+
+typedef struct {
+    pmix_thread_t thread;
+    pmix_parallel_range_fn_t fn;
+    void *ctx;
+    size_t worker;
+    /* the items this worker does: [first, last) */
+    size_t first;
+    size_t last;
+    bool started;
+    pmix_status_t rc;
+} parallel_worker_t;
+
+static void run_slice(parallel_worker_t *w)
+{
+    w->rc = w->fn(w->ctx, w->worker, w->first, w->last);
+}
+
+static void *worker_thread(pmix_object_t *obj)
+{
+    pmix_thread_t *t = (pmix_thread_t *) obj;
+
+    run_slice((parallel_worker_t *) t->t_arg);
+    return NULL;
+}
+
+size_t pmix_parallel_nworkers(unsigned int nthreads, size_t nitems, size_t minper)
+{
+    /* the processor count does not change under us - ask once */
+    static size_t ncpus = 0;
+    size_t nworkers = nthreads, most;
+    long nproc;
+
+    if (0 == nworkers) {
+        if (0 == ncpus) {
+            nproc = sysconf(_SC_NPROCESSORS_ONLN);
+            ncpus = (0 < nproc) ? (size_t) nproc : 1;
+        }
+        nworkers = ncpus;
+    }
+    most = (0 < minper) ? nitems / minper : nitems;
+    if (nworkers > most) {
+        nworkers = most;
+    }
+    return (0 < nworkers) ? nworkers : 1;
+}
+
+pmix_status_t pmix_parallel_range(pmix_parallel_range_fn_t fn, void *ctx,
+                                  size_t nitems, size_t nworkers)
+{
+    parallel_worker_t *workers = NULL;
+    size_t w;
+    pmix_status_t rc = PMIX_SUCCESS, wrc;
+
+    if (0 == nworkers) {
+        nworkers = 1;
+    }
+    if (1 < nworkers) {
+        workers = (parallel_worker_t *) calloc(nworkers, sizeof(*workers));
+    }
+    if (NULL == workers) {
+        /* the same slices, one after another */
+        for (w = 0; w < nworkers; w++) {
+            wrc = fn(ctx, w, (nitems * w) / nworkers, (nitems * (w + 1)) / nworkers);
+            if (PMIX_SUCCESS == rc) {
+                rc = wrc;
+            }
+        }
+        return rc;
+    }
+
+    for (w = 0; w < nworkers; w++) {
+        workers[w].fn = fn;
+        workers[w].ctx = ctx;
+        workers[w].worker = w;
+        workers[w].first = (nitems * w) / nworkers;
+        workers[w].last = (nitems * (w + 1)) / nworkers;
+        PMIX_CONSTRUCT(&workers[w].thread, pmix_thread_t);
+        workers[w].thread.t_run = worker_thread;
+        workers[w].thread.t_arg = &workers[w];
+    }
+    for (w = 1; w < nworkers; w++) {
+        workers[w].started = (PMIX_SUCCESS == pmix_thread_start(&workers[w].thread));
+    }
+    run_slice(&workers[0]);
+    for (w = 1; w < nworkers; w++) {
+        if (workers[w].started) {
+            pmix_thread_join(&workers[w].thread, NULL);
+        } else {
+            run_slice(&workers[w]);
+        }
+    }
+    for (w = 0; w < nworkers; w++) {
+        if (PMIX_SUCCESS == rc) {
+            rc = workers[w].rc;
+        }
+        PMIX_DESTRUCT(&workers[w].thread);
+    }
+    free(workers);
+    return rc;
+}
+
+typedef struct {
+    pmix_parallel_item_fn_t fn;
+    void *items;
+    size_t base;
+} items_ctx_t;
+
+static pmix_status_t items_slice(void *ctx, size_t worker, size_t first, size_t last)
+{
+    items_ctx_t *ic = (items_ctx_t *) ctx;
+    size_t n;
+    pmix_status_t rc;
+    (void) worker;
+
+    for (n = ic->base + first; n < ic->base + last; n++) {
+        rc = ic->fn(ic->items, n);
+        if (PMIX_SUCCESS != rc) {
+            return rc;
+        }
+    }
+    return PMIX_SUCCESS;
+}
+
+pmix_status_t pmix_parallel_items(pmix_parallel_item_fn_t fn, void *items,
+                                  size_t first, size_t last, size_t nworkers)
+{
+    items_ctx_t ic;
+    size_t nitems = (last > first) ? last - first : 0;
+
+    if (nworkers > nitems) {
+        nworkers = nitems;
+    }
+    ic.fn = fn;
+    ic.items = items;
+    ic.base = first;
+    return pmix_parallel_range(items_slice, &ic, nitems, nworkers);
+}
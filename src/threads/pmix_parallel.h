@@ -0,0 +1,73 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Nanook Consulting.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/** @file
+ *
+ * Sharing a run of independent items out across a few threads.
+ *
+ * The items are numbered 0..nitems-1 and split into one contiguous
+ * slice per worker, worker w taking [nitems*w/nworkers,
+ * nitems*(w+1)/nworkers). The calling thread does slice 0 itself while
+ * the others run, then joins them. The split depends on nothing but
+ * nitems and nworkers, so a caller that keeps per-worker state - a
+ * sub-arena, a list of things put off until later - gets the same
+ * slices on every call with the same counts.
+ *
+ * A worker that cannot be started, or a call that cannot allocate its
+ * bookkeeping, has its slices done on the calling thread in worker
+ * order, so the result never depends on how many threads there turned
+ * out to be. Threads are started per call and joined before it returns:
+ * this is for bulk steps worth at least a thread start per worker, not
+ * for anything on a fast path.
+ */
+
+#ifndef PMIX_PARALLEL_H
+#define PMIX_PARALLEL_H
+
+#include "src/include/pmix_config.h"
+
+#include "pmix_common.h"
+
+BEGIN_C_DECLS
+
+/* Do slice [first, last) as worker "worker" (0 is the calling thread) */
+typedef pmix_status_t (*pmix_parallel_range_fn_t)(void *ctx, size_t worker,
+                                                  size_t first, size_t last);
+
+/* Do item "n" of "items" */
+typedef pmix_status_t (*pmix_parallel_item_fn_t)(void *items, size_t n);
+
+/**
+ * How many workers to use for "nitems" items, at most "nthreads" of
+ * them (0 meaning one per online processor) and each given at least
+ * "minper" items - below that a thread costs more to start than it
+ * takes off. Never less than one.
+ */
+PMIX_EXPORT size_t pmix_parallel_nworkers(unsigned int nthreads, size_t nitems, size_t minper);
+
+/**
+ * Run "fn" over the slices of [0, nitems) for "nworkers" workers.
+ * Every slice is done even if one fails. Returns the first failure in
+ * worker order - which, the slices being contiguous, is item order.
+ */
+PMIX_EXPORT pmix_status_t pmix_parallel_range(pmix_parallel_range_fn_t fn, void *ctx,
+                                              size_t nitems, size_t nworkers);
+
+/**
+ * Apply "fn" to every item in [first, last), shared across "nworkers"
+ * workers. A worker stops at its first failure; the first in item
+ * order is returned.
+ */
+PMIX_EXPORT pmix_status_t pmix_parallel_items(pmix_parallel_item_fn_t fn, void *items,
+                                              size_t first, size_t last, size_t nworkers);
+
+END_C_DECLS
+
+#endif /* PMIX_PARALLEL_H */
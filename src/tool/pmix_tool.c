@@ -1812,13 +1812,27 @@ PMIX_EXPORT pmix_status_t PMIx_tool_finalize(void)
     PMIX_DESTRUCT(&pmix_server_globals.peer_cache);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.nspaces);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.collectives);
+    PMIX_DESTRUCT(&pmix_server_globals.collectives_index);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.remote_pnd);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.local_reqs);
+    PMIX_DESTRUCT(&pmix_server_globals.local_reqs_index);
+    /* the rank_infos outlive this list, so unhook them from it */
+    pmix_server_dmodex_forget_all();
+    PMIX_DESTRUCT(&pmix_server_globals.dmodex_cache);
+    PMIX_LIST_DESTRUCT(&pmix_server_globals.dmodex_batches);
+    PMIX_DESTRUCT(&pmix_server_globals.dmodex_batches_index);
+    pmix_server_query_cache_finalize();
+    PMIX_DESTRUCT(&pmix_server_globals.query_cache);
+    PMIX_DESTRUCT(&pmix_server_globals.query_cache_index);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.gdata);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.events);
+    PMIX_DESTRUCT(&pmix_server_globals.events_index);
+    pmix_server_globals.default_events = NULL;
     PMIX_LIST_DESTRUCT(&pmix_server_globals.iof);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.iof_residuals);
+    pmix_server_purge_psets();
     PMIX_LIST_DESTRUCT(&pmix_server_globals.psets);
+    PMIX_DESTRUCT(&pmix_server_globals.psets_index);
     PMIX_LIST_DESTRUCT(&pmix_server_globals.grp_collectives);
 
     (void) pmix_mca_base_framework_close(&pmix_pmdl_base_framework);
@@ -244,10 +244,9 @@ pmix_status_t pmix_hash_store(pmix_hash_table_t *table,
                             PMIX_NAME_PRINT(&pmix_globals.myid), kin->key, tmp);
                 free(tmp);
             }
-            pmix_bfrops_base_tma_value_release(&hv->value, tma);
         }
         /* TODO(skg) eventually, we want to eliminate this copy */
-        rc = pmix_bfrops_base_tma_copy_value(&hv->value, kin->value, PMIX_VALUE, tma);
+        rc = pmix_dstor_load_value_tma(hv, kin->value, tma);
         if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
             PMIX_ERROR_LOG(rc);
             return rc;
@@ -256,7 +255,7 @@ pmix_status_t pmix_hash_store(pmix_hash_table_t *table,
     }
 
     /* we don't already have it, so create it */
-    hv = pmix_dstor_new_tma(kid, tma);
+    hv = pmix_dstor_new_tma(kid, kin->value, tma);
     if (PMIX_UNLIKELY(NULL == hv)) {
         return PMIX_ERR_NOMEM;
     }
@@ -303,7 +302,7 @@ pmix_status_t pmix_hash_store(pmix_hash_table_t *table,
     }
 
     /* TODO(skg) eventually, we want to eliminate this copy */
-    rc = pmix_bfrops_base_tma_copy_value(&hv->value, kin->value, PMIX_VALUE, tma);
+    rc = pmix_dstor_load_value_tma(hv, kin->value, tma);
     if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
         PMIX_ERROR_LOG(rc);
         if (UINT32_MAX != hv->qualindex) {
@@ -328,6 +327,71 @@ pmix_status_t pmix_hash_store(pmix_hash_table_t *table,
     return PMIX_SUCCESS;
 }
 
+void *pmix_hash_reserve_proc(pmix_hash_table_t *table,
+                             pmix_rank_t rank, size_t nkeys)
+{
+    pmix_proc_data_t *proc_data;
+    int nfree;
+
+    if (PMIX_UNLIKELY(NULL == (proc_data = lookup_proc(table, rank, true)))) {
+        return NULL;
+    }
+    if (PMIX_UNLIKELY((size_t) INT_MAX < nkeys)) {
+        return NULL;
+    }
+    /* Most procs fit in what pdcon() gave them, so this is usually a
+     * no-op; a host that describes its procs at length pays for one
+     * grow here rather than one per block in pmix_hash_store(). */
+    nfree = proc_data->data->number_free;
+    if ((int) nkeys > nfree) {
+        if (PMIX_SUCCESS != pmix_pointer_array_set_size(proc_data->data,
+                                                        proc_data->data->size
+                                                        + ((int) nkeys - nfree))) {
+            return NULL;
+        }
+    }
+    return proc_data;
+}
+
+pmix_status_t pmix_hash_store_reserved(void *proc, uint32_t kid,
+                                       const pmix_value_t *val,
+                                       pmix_tma_t *tma)
+{
+    pmix_proc_data_t *const proc_data = (pmix_proc_data_t *) proc;
+    pmix_dstor_t *hv;
+    pmix_status_t rc;
+
+    if (PMIX_UNLIKELY(NULL == proc_data || NULL == val)) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    /* the unqualified half of pmix_hash_store(): replace what is there
+     * if the value changed, otherwise add an entry. lookup_keyval() only
+     * consults the keyindex for qualifiers, so passing none keeps it to
+     * this proc's own storage. */
+    hv = lookup_keyval(proc_data, kid, NULL, 0, NULL);
+    if (NULL != hv) {
+        if (NULL != hv->value && PMIX_EQUAL == PMIx_Value_compare(hv->value,
+                                                                (pmix_value_t *) val)) {
+            return PMIX_SUCCESS;
+        }
+        return pmix_dstor_load_value_tma(hv, val, tma);
+    }
+    if (0 == proc_data->data->number_free) {
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+    hv = pmix_dstor_new_tma(kid, val, tma);
+    if (PMIX_UNLIKELY(NULL == hv)) {
+        return PMIX_ERR_NOMEM;
+    }
+    rc = pmix_dstor_load_value_tma(hv, val, tma);
+    if (PMIX_UNLIKELY(PMIX_SUCCESS != rc)) {
+        pmix_dstor_release_tma(hv, tma);
+        return rc;
+    }
+    pmix_pointer_array_add(proc_data->data, hv);
+    return PMIX_SUCCESS;
+}
+
 static pmix_status_t make_copy(pmix_regattr_input_t *p,
                                pmix_dstor_t *hv,
                                pmix_list_t *kvals,
@@ -630,13 +694,10 @@ pmix_status_t pmix_hash_remove_data(pmix_hash_table_t *table,
                     for (n=0; n < proc_data->data->size; n++) {
                         d = (pmix_dstor_t*)pmix_pointer_array_get_item(proc_data->data, n);
                         if (NULL != d && kid == d->index) {
-                            if (NULL != d->value) {
-                                pmix_bfrops_base_tma_value_release(&d->value, tma);
-                            }
                             if (UINT32_MAX != d->qualindex) {
                                 erase_qualifiers(proc_data, d->qualindex);
                             }
-                            pmix_tma_free(tma, d);
+                            pmix_dstor_release_tma(d, tma);
                             pmix_pointer_array_set_item(proc_data->data, n, NULL);
                             break;
                         }
@@ -660,13 +721,10 @@ pmix_status_t pmix_hash_remove_data(pmix_hash_table_t *table,
         for (n=0; n < proc_data->data->size; n++) {
             d = (pmix_dstor_t*)pmix_pointer_array_get_item(proc_data->data, n);
             if (NULL != d) {
-                if (NULL != d->value) {
-                    pmix_bfrops_base_tma_value_release(&d->value, tma);
-                }
                 if (UINT32_MAX != d->qualindex) {
                     erase_qualifiers(proc_data, d->qualindex);
                 }
-                pmix_tma_free(tma, d);
+                pmix_dstor_release_tma(d, tma);
                 pmix_pointer_array_set_item(proc_data->data, n, NULL);
             }
         }
@@ -681,13 +739,10 @@ pmix_status_t pmix_hash_remove_data(pmix_hash_table_t *table,
     for (n=0; n < proc_data->data->size; n++) {
         d = (pmix_dstor_t*)pmix_pointer_array_get_item(proc_data->data, n);
         if (NULL != d && kid == d->index) {
-            if (NULL != d->value) {
-                pmix_bfrops_base_tma_value_release(&d->value, tma);
-            }
             if (UINT32_MAX != d->qualindex) {
                 erase_qualifiers(proc_data, d->qualindex);
             }
-            pmix_tma_free(tma, d);
+            pmix_dstor_release_tma(d, tma);
             pmix_pointer_array_set_item(proc_data->data, n, NULL);
             break;
         }
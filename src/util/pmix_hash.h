@@ -31,6 +31,30 @@ PMIX_EXPORT pmix_status_t pmix_hash_store(pmix_hash_table_t *table,
                                           pmix_info_t *qualifiers, size_t nquals,
                                           pmix_keyindex_t *kidx);
 
+/* pmix_hash_store() taken apart, for a caller that fills one table
+ * from several threads at once - gds/shmem3 building a job segment.
+ *
+ * pmix_hash_reserve_proc() is the half that touches shared state: it
+ * finds or creates the storage for "rank" and makes room in it for at
+ * least "nkeys" more unqualified values, allocating from the table's
+ * own TMA. It returns an opaque handle to that storage, or NULL if
+ * memory ran out. Call it from one thread.
+ *
+ * pmix_hash_store_reserved() is the half that does not: it stores an
+ * already-numbered key into a handle, copying the value with "tma"
+ * rather than the table's, and touching nothing but that one proc's
+ * storage. Any number of threads may call it at once provided no two
+ * share a handle and nothing registers keys meanwhile. It never grows
+ * the proc's storage - that would allocate from the table's TMA - so
+ * once the room reserved is used up it returns PMIX_ERR_OUT_OF_RESOURCE
+ * without storing, and the caller falls back on pmix_hash_store(). */
+PMIX_EXPORT void *pmix_hash_reserve_proc(pmix_hash_table_t *table,
+                                         pmix_rank_t rank, size_t nkeys);
+
+PMIX_EXPORT pmix_status_t pmix_hash_store_reserved(void *proc, uint32_t kid,
+                                                   const pmix_value_t *val,
+                                                   pmix_tma_t *tma);
+
 /* Fetch the value for a specified key and rank from within
  * the given hash_table */
 /* Number of key slots initially allocated per process in the
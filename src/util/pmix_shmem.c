@@ -22,7 +22,11 @@
 #ifdef HAVE_FCNTL_H
 #include <fcntl.h>
 #endif
+#ifdef HAVE_SYS_VFS_H
+#include <sys/vfs.h>
+#endif
 #include <sys/mman.h>
+#include <sys/resource.h>
 #include <errno.h>
 
 // MAP_FIXED_NOREPLACE (Linux 4.17+) may be unavailable on older systems; fall
@@ -31,6 +35,12 @@
 #define MAP_FIXED_NOREPLACE 0
 #endif
 
+// What fstatfs() reports for a hugetlbfs mount. A backing file there can
+// only be sized and mapped in whole huge pages, asked for or not.
+#if defined(HAVE_SYS_VFS_H) && defined(HAVE_STRUCT_STATFS_F_TYPE)
+#define PMIX_SHMEM_HUGETLBFS_MAGIC 0x958458f6UL
+#endif
+
 /* Marks a segment as one of ours, so a stale or foreign backing file is
  * rejected rather than interpreted. */
 #define PMIX_SHMEM_HEADER_MAGIC 0x504d5853u /* "PMXS" */
@@ -47,6 +57,11 @@ typedef struct pmix_shmem_header_t {
     uint32_t magic;
     /** Layout of what the creator stored - see pmix_shmem_segment_create. */
     uint32_t layout_id;
+    /** log2 of the page size the creator backed the segment with, or 0
+     *  for base pages. Last, so a segment from before it existed reads
+     *  as zero here - the file is created zero-filled - and means what
+     *  it always did. */
+    uint32_t page_shift;
 } pmix_shmem_header_t;
 
 static void *
@@ -118,6 +133,7 @@ segment_attach(
     else if (must_map_at_raddr) {
         mmap_flags |= MAP_FIXED_NOREPLACE;
     }
+
     mmap_addr = mmap(
         (void *)desired_base_address, shmem->size,
         PROT_READ | PROT_WRITE, mmap_flags, fd, 0
@@ -160,11 +176,20 @@ out:
     return rc;
 }
 
+static size_t get_page_size(void);
+
 static pmix_status_t
 add_internal_segment_header(
     pmix_shmem_t *shmem,
     uint32_t layout_id
 ) {
+    uint32_t page_shift = 0;
+
+    if (shmem->page_size > get_page_size()) {
+        while (((size_t)1 << page_shift) < shmem->page_size) {
+            ++page_shift;
+        }
+    }
     int rc = PMIX_SUCCESS;
     // The base address here is inconsequential because this is a temporary,
     // internal attachment site that should not be exposed to the caller.
@@ -177,20 +202,51 @@ add_internal_segment_header(
     pmix_shmem_header_t shmem_header = {
         .ref_count = 0,
         .magic = PMIX_SHMEM_HEADER_MAGIC,
-        .layout_id = layout_id
+        .layout_id = layout_id,
+        .page_shift = page_shift
     };
     memmove(shmem->hdr_address, &shmem_header, sizeof(shmem_header));
     // Done with internal mapping, so detach.
     return pmix_shmem_segment_detach(shmem);
 }
 
+/* The pages a segment whose backing file is open on fd will get. */
+static size_t
+backing_page_size(
+    int fd,
+    pmix_shmem_flags_t flags
+) {
+    const size_t base_page = get_page_size();
+
+#ifdef PMIX_SHMEM_HUGETLBFS_MAGIC
+    // Not a choice: hugetlbfs refuses a size or a mapping that is not a
+    // whole number of its pages.
+    struct statfs sfs;
+    if (0 == fstatfs(fd, &sfs)
+        && PMIX_SHMEM_HUGETLBFS_MAGIC == (unsigned long)sfs.f_type
+        && (size_t)sfs.f_bsize > base_page) {
+        return (size_t)sfs.f_bsize;
+    }
+#else
+    PMIX_HIDE_UNUSED_PARAMS(fd);
+#endif
+    if (flags & PMIX_SHMEM_HUGE_PAGES) {
+        const size_t huge_page = pmix_shmem_utils_huge_page_size();
+        if (huge_page > base_page) {
+            return huge_page;
+        }
+    }
+    return base_page;
+}
+
 // TODO(skg) Add network FS warning?
 pmix_status_t
 pmix_shmem_segment_create(
     pmix_shmem_t *shmem,
     size_t size,
     const char *backing_path,
-    uint32_t layout_id
+    uint32_t layout_id,
+    pmix_shmem_flags_t flags
 ) {
     int rc = PMIX_SUCCESS;
     // Real size of the segment: the data region begins a full page in
@@ -199,7 +255,7 @@ pmix_shmem_segment_create(
     // is in pmix_shmem_utils_segment_footprint() because callers placing
     // segments adjacently need the same answer, and two copies of it
     // would drift.
-    const size_t real_size = pmix_shmem_utils_segment_footprint(size);
+    size_t real_size = pmix_shmem_utils_segment_footprint(size);
 
     /* O_TRUNC is what makes "a freshly created segment reads as zero" a
      * guarantee rather than an assumption. Segments are unlinked when their
@@ -215,6 +271,12 @@ pmix_shmem_segment_create(
         rc = PMIX_ERR_FILE_OPEN_FAILURE;
         goto out;
     }
+    // A segment backed by huge pages is a whole number of them. Only the
+    // tail grows: the header stays one base page, so where the data
+    // region begins - which every attacher works out for itself - does
+    // not depend on what backs it.
+    shmem->page_size = backing_page_size(fd, flags);
+    real_size = (real_size + shmem->page_size - 1) & ~(shmem->page_size - 1);
     // Size backing file.
     if (0 != ftruncate(fd, real_size)) {
         rc = PMIX_ERROR;
@@ -235,6 +297,26 @@ out:
     return rc;
 }
 
+/* Fill in this process's page tables for the whole segment. */
+static void
+prefault(
+    pmix_shmem_t *shmem
+) {
+#ifdef MADV_POPULATE_READ
+    // Linux 5.14 and on: the kernel does the walk, in one call.
+    if (0 == madvise(shmem->hdr_address, shmem->size, MADV_POPULATE_READ)) {
+        return;
+    }
+#endif
+    // Otherwise read a byte of each page, which faults it in the same
+    // way a later read would have - only all now.
+    const size_t step = (0 < shmem->page_size) ? shmem->page_size : get_page_size();
+    const volatile unsigned char *p = (const volatile unsigned char *)shmem->hdr_address;
+    for (size_t off = 0; off < shmem->size; off += step) {
+        (void)p[off];
+    }
+}
+
 pmix_status_t
 pmix_shmem_segment_attach(
     pmix_shmem_t *shmem,
@@ -268,10 +350,43 @@ pmix_shmem_segment_attach(
         return PMIX_ERR_NOT_SUPPORTED;
     }
 
+    // Ask for the pages the creator chose. On hugetlbfs the mapping has
+    // them already; on tmpfs it is advice, which the kernel is free to
+    // decline - and if it does, the segment simply stays on base pages.
+    shmem->page_size = get_page_size();
+    if (0 < header->page_shift && header->page_shift < 8 * sizeof(size_t)) {
+        shmem->page_size = (size_t)1 << header->page_shift;
+#ifdef MADV_HUGEPAGE
+        (void)madvise(shmem->hdr_address, shmem->size, MADV_HUGEPAGE);
+#endif
+    }
+
     inc_ref_count(shmem->hdr_address);
+    shmem->faults_at_attach = pmix_shmem_segment_faults(NULL);
+    // After the advice above, not before: pages mapped ahead of it would
+    // be mapped small.
+    if (flags & PMIX_SHMEM_PREFAULT) {
+        prefault(shmem);
+    }
     return rc;
 }
 
+long
+pmix_shmem_segment_faults(
+    const pmix_shmem_t *shmem
+) {
+    struct rusage ru;
+
+    if (NULL != shmem && !shmem->attached) {
+        return -1;
+    }
+    if (0 != getrusage(RUSAGE_SELF, &ru)) {
+        return -1;
+    }
+    const long faults = ru.ru_minflt + ru.ru_majflt;
+    return (NULL == shmem) ? faults : faults - shmem->faults_at_attach;
+}
+
 pmix_status_t
 pmix_shmem_segment_detach(
     pmix_shmem_t *shmem
@@ -326,13 +441,22 @@ pmix_shmem_segment_protect_data(
     /* The header page stays writable - inc/dec_ref_count() live there,
      * and a reader still has to be able to detach. Everything from the
      * data region on is what a reader has no business touching. */
-    const size_t header_offset = pmix_shmem_utils_pad_to_page(
+    size_t header_offset = pmix_shmem_utils_pad_to_page(
         sizeof(pmix_shmem_header_t)
     );
+    /* Protection comes in whole pages of whatever backs the mapping:
+     * hugetlbfs refuses anything finer, and a transparent huge page would
+     * be split back into base pages to honor it. So on huge pages the
+     * first one - header and the start of the data - stays writable, and
+     * the MMU watches everything after it. */
+    if (shmem->page_size > header_offset) {
+        header_offset = shmem->page_size;
+    }
     if (shmem->size <= header_offset) {
         return PMIX_ERR_BAD_PARAM;
     }
-    if (0 != mprotect(shmem->data_address, shmem->size - header_offset, PROT_READ)) {
+    if (0 != mprotect((char *)shmem->hdr_address + header_offset,
+                      shmem->size - header_offset, PROT_READ)) {
         return PMIX_ERROR;
     }
     return PMIX_SUCCESS;
@@ -376,6 +500,55 @@ get_page_size(void)
     return i;
 }
 
+/* Up to len - 1 bytes of a small file, NUL-terminated. */
+static bool
+read_small_file(
+    const char *path,
+    char *buf,
+    size_t len
+) {
+    const int fd = open(path, O_RDONLY);
+    if (-1 == fd) {
+        return false;
+    }
+    const ssize_t n = read(fd, buf, len - 1);
+    (void)close(fd);
+    if (0 >= n) {
+        return false;
+    }
+    buf[n] = '\0';
+    return true;
+}
+
+size_t
+pmix_shmem_utils_huge_page_size(void)
+{
+#ifdef MADV_HUGEPAGE
+    char buf[256];
+
+    // Shared memory has its own switch, separate from the one for
+    // anonymous memory, and only "never" and "deny" rule it out: under
+    // "advise" the madvise() at attach is what turns it on.
+    if (!read_small_file("/sys/kernel/mm/transparent_hugepage/shmem_enabled",
+                         buf, sizeof(buf))
+        || NULL != strstr(buf, "[never]") || NULL != strstr(buf, "[deny]")) {
+        return 0;
+    }
+    if (!read_small_file("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                         buf, sizeof(buf))) {
+        return 0;
+    }
+    const unsigned long long huge_page = strtoull(buf, NULL, 10);
+    // Anything else is not a page size, whatever the file says.
+    if (huge_page <= get_page_size() || 0 != (huge_page & (huge_page - 1))) {
+        return 0;
+    }
+    return (size_t)huge_page;
+#else
+    return 0;
+#endif
+}
+
 size_t
 pmix_shmem_utils_pad_to_page(
     size_t size
@@ -407,6 +580,8 @@ shmem_construct(
     s->hdr_address = NULL;
     s->data_address = NULL;
     memset(s->backing_path, 0, PMIX_PATH_MAX);
+    s->page_size = 0;
+    s->faults_at_attach = 0;
 }
 
 static void
@@ -45,7 +45,33 @@ typedef enum {
      *
      * Implies PMIX_SHMEM_MUST_MAP_AT_RADDR.
      */
-    PMIX_SHMEM_MAP_OVER_RESERVATION = 0x02
+    PMIX_SHMEM_MAP_OVER_RESERVATION = 0x02,
+    /**
+     * At create: back the segment with huge pages where the system will
+     * give them to us (see pmix_shmem_utils_huge_page_size()), and
+     * ordinary pages where it will not. Asking is never an error.
+     *
+     * A segment mapped by hundreds of processes and read at random costs
+     * each of them a TLB entry and a fault per base page it touches; a
+     * 2 MiB page is one of each for 512 of those. The segment's size is
+     * rounded up to a whole number of the pages it ends up with, so
+     * shmem->size is the number to carve address space by, not anything
+     * worked out beforehand.
+     *
+     * Nothing needs passing at attach: the creator records the page size
+     * in the segment, and every process mapping it asks for the same.
+     */
+    PMIX_SHMEM_HUGE_PAGES = 0x04,
+    /**
+     * At attach: map every page of the segment now, in one call, rather
+     * than fault them in one at a time as they are first read.
+     *
+     * For a reader whose first act is to walk much of the segment this
+     * trades a long tail of faults for one up-front cost. It does not
+     * allocate anything - the creator's writes did that - it only fills
+     * in this process's page tables.
+     */
+    PMIX_SHMEM_PREFAULT = 0x08
 } pmix_shmem_flag_t;
 
 typedef struct pmix_shmem_t {
@@ -64,6 +90,13 @@ typedef struct pmix_shmem_t {
     void *data_address;
     /** Buffer holding path to backing store. */
     char backing_path[PMIX_PATH_MAX];
+    /** Size of the pages backing the segment: the system's base page
+     *  unless huge pages were asked for at create and could be had. Known
+     *  once the segment is created or attached. */
+    size_t page_size;
+    /** This process's page-fault count when it attached, so the faults
+     *  since can be reported - see pmix_shmem_segment_faults(). */
+    long faults_at_attach;
 } pmix_shmem_t;
 PMIX_EXPORT PMIX_CLASS_DECLARATION(pmix_shmem_t);
 
@@ -88,7 +121,8 @@ pmix_shmem_segment_create(
     pmix_shmem_t *shmem,
     size_t size,
     const char *backing_path,
-    uint32_t layout_id
+    uint32_t layout_id,
+    pmix_shmem_flags_t flags
 );
 
 /**
@@ -162,6 +196,32 @@ pmix_shmem_segment_protect_data(
     pmix_shmem_t *shmem
 );
 
+/**
+ * Page faults this process has taken since it attached to the segment,
+ * or -1 if it is not attached.
+ *
+ * The kernel counts faults per process, not per mapping, so this is
+ * everything the process faulted on in the meantime. Read right after
+ * a segment is filled or first walked it is dominated by that segment,
+ * which is when it says something.
+ */
+PMIX_EXPORT long
+pmix_shmem_segment_faults(
+    const pmix_shmem_t *shmem
+);
+
+/**
+ * The huge page size a segment created with PMIX_SHMEM_HUGE_PAGES would
+ * get, or 0 if it would get base pages.
+ *
+ * This is the transparent huge page size, and it is 0 where the kernel
+ * has no such thing or will not use it for shared memory. A segment whose
+ * backing file is on hugetlbfs gets that mount's page size whatever is
+ * asked, because it cannot have any other.
+ */
+PMIX_EXPORT size_t
+pmix_shmem_utils_huge_page_size(void);
+
 /**
  * Returns size padded to page boundary.
  */
@@ -0,0 +1,965 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "src/util/pmix_shmem_flat.h"
+
+#include "src/mca/bfrops/bfrops.h"
+
+#include <string.h>
+
+/* ------------------------------------------------------------------ */
+/* references                                                          */
+/* ------------------------------------------------------------------ */
+
+/* Both ends of a reference live in the image, so the distance between
+ * them is the same wherever the image is mapped. */
+static inline void
+rel_set(
+    pmix_shmem_rel_t *r,
+    const void *target
+) {
+    *r = (NULL == target) ? 0 : (pmix_shmem_rel_t)((const char *)target - (const char *)r);
+}
+
+/* Writer side: the writer built the image, so it follows its own
+ * references without checking them. */
+static inline void *
+rel_raw(
+    const pmix_shmem_rel_t *r
+) {
+    return (0 == *r) ? NULL : (void *)((char *)r + *r);
+}
+
+/* Reader side: follow r only if len bytes at its target lie inside the
+ * part of the image the writer says it used. */
+static inline const void *
+rel_get(
+    const pmix_shmem_flat_t *f,
+    const pmix_shmem_rel_t *r,
+    size_t len
+) {
+    if (0 == *r) {
+        return NULL;
+    }
+    const int64_t at = (int64_t)((const char *)r - (const char *)f);
+    if (0 > at || (uint64_t)at > f->used) {
+        return NULL;
+    }
+    /* written so neither sum can wrap */
+    if ((0 > *r && -*r > at) || (0 < *r && (uint64_t)*r > f->used - (uint64_t)at)) {
+        return NULL;
+    }
+    const uint64_t off = (uint64_t)(at + *r);
+    if (len > f->used - off) {
+        return NULL;
+    }
+    return (const char *)f + off;
+}
+
+/* A string has no length field; it is in bounds if its terminator is. */
+static inline const char *
+rel_str(
+    const pmix_shmem_flat_t *f,
+    const pmix_shmem_rel_t *r
+) {
+    const char *s = rel_get(f, r, 1);
+    if (NULL == s) {
+        return NULL;
+    }
+    const size_t room = f->used - (size_t)(s - (const char *)f);
+    return (NULL == memchr(s, '\0', room)) ? NULL : s;
+}
+
+/* ------------------------------------------------------------------ */
+/* layout                                                              */
+/* ------------------------------------------------------------------ */
+
+static inline size_t
+align8(
+    size_t n
+) {
+    return (n + 7) & ~(size_t)7;
+}
+
+static inline uint32_t
+pow2_at_least(
+    size_t n
+) {
+    uint32_t p = 8;
+    while (p < n && p < (UINT32_C(1) << 30)) {
+        p <<= 1;
+    }
+    return p;
+}
+
+/* Bump allocation out of the image. Zeroed, so every reference in what
+ * comes back starts out NULL. */
+static void *
+flat_alloc(
+    pmix_shmem_flat_t *f,
+    size_t len
+) {
+    const uint64_t at = align8(f->used);
+    if (at > f->size || len > f->size - at) {
+        return NULL;
+    }
+    f->used = at + len;
+    void *p = (char *)f + at;
+    memset(p, 0, len);
+    return p;
+}
+
+static inline uint32_t
+flat_hash(
+    pmix_rank_t rank,
+    const char *key
+) {
+    /* FNV-1a over the key, then the rank folded in */
+    uint32_t h = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)key; '\0' != *p; ++p) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    h ^= (uint32_t)rank;
+    h *= 0x9e3779b1u;
+    return h ^ (h >> 16);
+}
+
+static inline uint32_t
+rank_home(
+    pmix_rank_t rank,
+    uint32_t cap
+) {
+    return ((uint32_t)rank * 0x9e3779b1u) & (cap - 1);
+}
+
+size_t
+pmix_shmem_flat_sizeof(
+    size_t nranks,
+    size_t nkvals,
+    size_t payload
+) {
+    const size_t nbuckets = pow2_at_least(nkvals);
+    const size_t rankcap = pow2_at_least(2 * nranks);
+
+    /* The rank table can be rebuilt once or twice on the way up if the
+     * estimate was short; leave room for one rebuild. Per entry, the
+     * alignment of the key and of the payload costs up to 14 bytes. */
+    return align8(sizeof(pmix_shmem_flat_t))
+         + nbuckets * sizeof(pmix_shmem_rel_t)
+         + 3 * rankcap * sizeof(pmix_shmem_flat_rank_t)
+         + nkvals * (align8(sizeof(pmix_shmem_flat_entry_t)) + 16)
+         + payload;
+}
+
+size_t
+pmix_shmem_flat_sizeof_tables(
+    size_t nranks,
+    size_t nkvals
+) {
+    return align8(sizeof(pmix_shmem_flat_t))
+         + align8(pow2_at_least(nkvals) * sizeof(pmix_shmem_rel_t))
+         + align8(pow2_at_least(2 * nranks) * sizeof(pmix_shmem_flat_rank_t));
+}
+
+pmix_status_t
+pmix_shmem_flat_init(
+    void *base,
+    size_t size,
+    size_t nranks,
+    size_t nkvals
+) {
+    pmix_shmem_flat_t *const f = (pmix_shmem_flat_t *)base;
+
+    if (NULL == base || size < sizeof(pmix_shmem_flat_t)) {
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+    memset(f, 0, sizeof(*f));
+    f->size = size;
+    f->used = sizeof(*f);
+    f->nbuckets = pow2_at_least(nkvals);
+    f->rankcap = pow2_at_least(2 * nranks);
+    f->buftype = pmix_globals.mypeer->nptr->compat.type;
+
+    pmix_shmem_rel_t *const buckets = flat_alloc(f, f->nbuckets * sizeof(pmix_shmem_rel_t));
+    pmix_shmem_flat_rank_t *const ranks = flat_alloc(f, f->rankcap * sizeof(pmix_shmem_flat_rank_t));
+    if (NULL == buckets || NULL == ranks) {
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+    rel_set(&f->buckets, buckets);
+    rel_set(&f->ranks, ranks);
+    /* last, so a half-built image never looks like one */
+    f->magic = PMIX_SHMEM_FLAT_MAGIC;
+    return PMIX_SUCCESS;
+}
+
+bool
+pmix_shmem_flat_check(
+    const void *base,
+    size_t size
+) {
+    const pmix_shmem_flat_t *const f = (const pmix_shmem_flat_t *)base;
+
+    if (NULL == base || size < sizeof(*f)) {
+        return false;
+    }
+    if (PMIX_SHMEM_FLAT_MAGIC != f->magic || f->size > size || f->used > f->size) {
+        return false;
+    }
+    /* the table sizes are masks, so they have to be powers of two */
+    if (0 == f->nbuckets || 0 != (f->nbuckets & (f->nbuckets - 1)) ||
+        0 == f->rankcap || 0 != (f->rankcap & (f->rankcap - 1))) {
+        return false;
+    }
+    return NULL != rel_get(f, &f->buckets, f->nbuckets * sizeof(pmix_shmem_rel_t)) &&
+           NULL != rel_get(f, &f->ranks, f->rankcap * sizeof(pmix_shmem_flat_rank_t));
+}
+
+/* ------------------------------------------------------------------ */
+/* values                                                              */
+/* ------------------------------------------------------------------ */
+
+/* A type whose whole value sits in pmix_value_t's data union, with no
+ * pointer in it, so that copying the union copies the value. */
+static bool
+is_inline(
+    pmix_data_type_t type
+) {
+    switch (type) {
+        case PMIX_UNDEF:
+        case PMIX_BOOL:
+        case PMIX_BYTE:
+        case PMIX_SIZE:
+        case PMIX_PID:
+        case PMIX_INT:
+        case PMIX_INT8:
+        case PMIX_INT16:
+        case PMIX_INT32:
+        case PMIX_INT64:
+        case PMIX_UINT:
+        case PMIX_UINT8:
+        case PMIX_UINT16:
+        case PMIX_UINT32:
+        case PMIX_UINT64:
+        case PMIX_FLOAT:
+        case PMIX_DOUBLE:
+        case PMIX_TIMEVAL:
+        case PMIX_TIME:
+        case PMIX_STATUS:
+        case PMIX_PROC_RANK:
+        case PMIX_PERSIST:
+        case PMIX_SCOPE:
+        case PMIX_DATA_RANGE:
+        case PMIX_PROC_STATE:
+        case PMIX_DATA_TYPE:
+        case PMIX_ALLOC_DIRECTIVE:
+        case PMIX_RESBLOCK_DIRECTIVE:
+        case PMIX_ALLOC_INHERIT:
+        case PMIX_IOF_CHANNEL:
+        case PMIX_JOB_STATE:
+        case PMIX_LINK_STATE:
+        case PMIX_LOCTYPE:
+        case PMIX_DEVTYPE:
+        case PMIX_STOR_MEDIUM:
+        case PMIX_STOR_ACCESS:
+        case PMIX_STOR_PERSIST:
+        case PMIX_STOR_ACCESS_TYPE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/* A type held in data.bo. */
+static inline bool
+is_bytes(
+    pmix_data_type_t type
+) {
+    return PMIX_BYTE_OBJECT == type || PMIX_COMPRESSED_STRING == type ||
+           PMIX_COMPRESSED_BYTE_OBJECT == type || PMIX_REGEX == type;
+}
+
+/* The form val is held in, and - for anything but a string or bytes,
+ * which are their own payload - the packed form in buf, which the caller
+ * then owns. */
+static pmix_status_t
+flat_form(
+    const pmix_value_t *val,
+    uint8_t flags,
+    uint8_t *form,
+    pmix_buffer_t *buf
+) {
+    pmix_status_t rc;
+
+    if (0 == flags && is_inline(val->type)) {
+        *form = PMIX_SHMEM_FLAT_INLINE;
+        return PMIX_SUCCESS;
+    }
+    if (0 == flags && (PMIX_STRING == val->type || is_bytes(val->type))) {
+        *form = PMIX_SHMEM_FLAT_BYTES;
+        return PMIX_SUCCESS;
+    }
+    *form = PMIX_SHMEM_FLAT_PACKED;
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, (pmix_value_t *)val, 1, PMIX_VALUE);
+    return rc;
+}
+
+/* Put val's payload in the image and only then describe it in dst, so a
+ * full image leaves dst - which may be a live entry's value - alone. */
+static pmix_status_t
+flat_encode(
+    pmix_shmem_flat_t *f,
+    pmix_shmem_flat_value_t *dst,
+    const pmix_value_t *val,
+    uint8_t flags
+) {
+    pmix_status_t rc;
+    uint8_t form;
+    void *payload = NULL;
+    size_t size = 0;
+    pmix_buffer_t buf;
+
+    PMIX_CONSTRUCT(&buf, pmix_buffer_t);
+    rc = flat_form(val, flags, &form, &buf);
+    if (PMIX_SUCCESS != rc) {
+        PMIX_DESTRUCT(&buf);
+        return rc;
+    }
+    if (PMIX_SHMEM_FLAT_PACKED == form) {
+        size = buf.bytes_used;
+        payload = flat_alloc(f, size);
+        if (NULL != payload) {
+            memcpy(payload, buf.base_ptr, size);
+        }
+    } else if (PMIX_SHMEM_FLAT_BYTES == form && PMIX_STRING == val->type) {
+        if (NULL != val->data.string) {
+            size = strlen(val->data.string) + 1;
+            if (NULL != (payload = flat_alloc(f, size))) {
+                memcpy(payload, val->data.string, size);
+            }
+        }
+    } else if (PMIX_SHMEM_FLAT_BYTES == form) {
+        size = (NULL == val->data.bo.bytes) ? 0 : val->data.bo.size;
+        if (0 < size && NULL != (payload = flat_alloc(f, size))) {
+            memcpy(payload, val->data.bo.bytes, size);
+        }
+    }
+    PMIX_DESTRUCT(&buf);
+    if (0 < size && NULL == payload) {
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+
+    memset(dst, 0, sizeof(*dst));
+    dst->type = (uint16_t)val->type;
+    dst->form = form;
+    dst->flags = flags;
+    dst->size = size;
+    if (PMIX_SHMEM_FLAT_INLINE == form) {
+        memcpy(dst->u.raw, &val->data, PMIX_SHMEM_FLAT_RAWSIZE);
+    } else {
+        rel_set(&dst->u.data, payload);
+    }
+    return PMIX_SUCCESS;
+}
+
+/* The reverse, into a value the caller owns outright. */
+static pmix_status_t
+flat_decode(
+    const pmix_shmem_flat_t *f,
+    const pmix_shmem_flat_value_t *src,
+    pmix_value_t *dst
+) {
+    const char *payload = NULL;
+    pmix_status_t rc;
+
+    PMIX_VALUE_CONSTRUCT(dst);
+    if (PMIX_SHMEM_FLAT_INLINE != src->form && 0 < src->size) {
+        payload = rel_get(f, &src->u.data, src->size);
+        if (NULL == payload) {
+            return PMIX_ERR_NOT_FOUND;
+        }
+    }
+
+    switch (src->form) {
+        case PMIX_SHMEM_FLAT_INLINE:
+            dst->type = src->type;
+            memcpy(&dst->data, src->u.raw, PMIX_SHMEM_FLAT_RAWSIZE);
+            return PMIX_SUCCESS;
+
+        case PMIX_SHMEM_FLAT_BYTES:
+            if (PMIX_STRING == src->type) {
+                if (NULL != payload) {
+                    if ('\0' != payload[src->size - 1]) {
+                        return PMIX_ERR_NOT_FOUND;
+                    }
+                    dst->data.string = strdup(payload);
+                    if (NULL == dst->data.string) {
+                        return PMIX_ERR_NOMEM;
+                    }
+                }
+            } else if (NULL != payload) {
+                dst->data.bo.bytes = (char *)malloc(src->size);
+                if (NULL == dst->data.bo.bytes) {
+                    return PMIX_ERR_NOMEM;
+                }
+                memcpy(dst->data.bo.bytes, payload, src->size);
+                dst->data.bo.size = src->size;
+            }
+            dst->type = src->type;
+            return PMIX_SUCCESS;
+
+        case PMIX_SHMEM_FLAT_PACKED: {
+            pmix_buffer_t buf;
+            int32_t cnt = 1;
+
+            if (NULL == payload) {
+                return PMIX_ERR_NOT_FOUND;
+            }
+            /* Unpacking only reads, so point the buffer straight at the
+             * image - and take it back before the destructor frees it. */
+            PMIX_CONSTRUCT(&buf, pmix_buffer_t);
+            buf.type = (pmix_bfrop_buffer_type_t)f->buftype;
+            buf.base_ptr = (char *)payload;
+            buf.bytes_used = src->size;
+            buf.bytes_allocated = src->size;
+            buf.unpack_ptr = buf.base_ptr;
+            buf.pack_ptr = buf.base_ptr + src->size;
+            PMIX_BFROPS_UNPACK(rc, pmix_globals.mypeer, &buf, dst, &cnt, PMIX_VALUE);
+            buf.base_ptr = NULL;
+            buf.unpack_ptr = NULL;
+            buf.pack_ptr = NULL;
+            PMIX_DESTRUCT(&buf);
+            return rc;
+        }
+
+        default:
+            return PMIX_ERR_NOT_FOUND;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* qualifiers                                                          */
+/* ------------------------------------------------------------------ */
+
+/* A PMIX_QUALIFIED_VALUE is a darray of pmix_info_t: the value, then its
+ * qualifiers. Check the shape before anything indexes it - it can arrive
+ * from a peer. */
+static bool
+qualified_shape(
+    const pmix_value_t *v
+) {
+    return PMIX_DATA_ARRAY == v->type && NULL != v->data.darray &&
+           PMIX_INFO == v->data.darray->type && NULL != v->data.darray->array &&
+           0 < v->data.darray->size;
+}
+
+/* Is the qualifier (key, val) among those stored in q? */
+static bool
+has_qualifier(
+    const pmix_value_t *q,
+    const char *key,
+    const pmix_value_t *val
+) {
+    const pmix_info_t *info = (const pmix_info_t *)q->data.darray->array;
+
+    for (size_t n = 1; n < q->data.darray->size; n++) {
+        if (PMIX_CHECK_KEY(&info[n], key) &&
+            PMIX_EQUAL == PMIx_Value_compare((pmix_value_t *)&info[n].value,
+                                             (pmix_value_t *)val)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Does the stored q answer a request carrying these qualifiers? */
+static bool
+quals_satisfy(
+    const pmix_value_t *q,
+    const pmix_info_t *quals,
+    size_t nquals
+) {
+    for (size_t m = 0; m < nquals; m++) {
+        if (PMIX_INFO_IS_QUALIFIER(&quals[m]) &&
+            !has_qualifier(q, quals[m].key, &quals[m].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Do a and b carry the same set of qualifiers? Then one replaces the
+ * other. */
+static bool
+quals_same(
+    const pmix_value_t *a,
+    const pmix_value_t *b
+) {
+    const pmix_info_t *info = (const pmix_info_t *)b->data.darray->array;
+
+    if (a->data.darray->size != b->data.darray->size) {
+        return false;
+    }
+    for (size_t n = 1; n < b->data.darray->size; n++) {
+        if (!has_qualifier(a, info[n].key, &info[n].value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------ */
+/* lookup                                                              */
+/* ------------------------------------------------------------------ */
+
+static const pmix_shmem_flat_rank_t *
+find_rank(
+    const pmix_shmem_flat_t *f,
+    pmix_rank_t rank
+) {
+    const pmix_shmem_flat_rank_t *tab =
+        rel_get(f, &f->ranks, f->rankcap * sizeof(pmix_shmem_flat_rank_t));
+    if (NULL == tab) {
+        return NULL;
+    }
+    uint32_t i = rank_home(rank, f->rankcap);
+    for (uint32_t n = 0; n < f->rankcap; n++, i = (i + 1) & (f->rankcap - 1)) {
+        if (0 == tab[i].first) {
+            return NULL;
+        }
+        if (tab[i].rank == (uint32_t)rank) {
+            return &tab[i];
+        }
+    }
+    return NULL;
+}
+
+/* The entry for (rank, key) - unqualified unless want is given, in which
+ * case the qualified one whose qualifiers match it exactly. Writer side. */
+static pmix_shmem_flat_entry_t *
+find_entry(
+    pmix_shmem_flat_t *f,
+    pmix_rank_t rank,
+    const char *key,
+    uint32_t h,
+    const pmix_value_t *want
+) {
+    pmix_shmem_rel_t *const buckets = rel_raw(&f->buckets);
+    pmix_shmem_flat_entry_t *e = rel_raw(&buckets[h & (f->nbuckets - 1)]);
+
+    for (; NULL != e; e = rel_raw(&e->chain)) {
+        if (e->hash != h || e->rank != (uint32_t)rank ||
+            0 != strcmp(rel_raw(&e->key), key)) {
+            continue;
+        }
+        if (NULL == want) {
+            if (0 == (e->value.flags & PMIX_SHMEM_FLAT_QUALIFIED)) {
+                return e;
+            }
+            continue;
+        }
+        if (0 != (e->value.flags & PMIX_SHMEM_FLAT_QUALIFIED)) {
+            pmix_value_t have;
+            bool same = false;
+            if (PMIX_SUCCESS == flat_decode(f, &e->value, &have)) {
+                same = qualified_shape(&have) && quals_same(&have, want);
+            }
+            PMIX_VALUE_DESTRUCT(&have);
+            if (same) {
+                return e;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Make room for one more rank: a new table twice the size, every slot
+ * rehashed into it. The references in each slot are re-made rather than
+ * copied - they are relative to where they are stored, and that is what
+ * is changing. The old table is left behind, unreferenced. */
+static pmix_status_t
+grow_ranks(
+    pmix_shmem_flat_t *f
+) {
+    if ((f->nranks + 1) * 4 <= f->rankcap * 3) {
+        return PMIX_SUCCESS;
+    }
+    const uint32_t cap = f->rankcap * 2;
+    pmix_shmem_flat_rank_t *const old = rel_raw(&f->ranks);
+    pmix_shmem_flat_rank_t *const tab = flat_alloc(f, cap * sizeof(pmix_shmem_flat_rank_t));
+    if (NULL == tab) {
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+    for (uint32_t n = 0; n < f->rankcap; n++) {
+        if (0 == old[n].first) {
+            continue;
+        }
+        uint32_t i = rank_home(old[n].rank, cap);
+        while (0 != tab[i].first) {
+            i = (i + 1) & (cap - 1);
+        }
+        tab[i].rank = old[n].rank;
+        tab[i].nentries = old[n].nentries;
+        rel_set(&tab[i].first, rel_raw(&old[n].first));
+        rel_set(&tab[i].last, rel_raw(&old[n].last));
+    }
+    rel_set(&f->ranks, tab);
+    f->rankcap = cap;
+    return PMIX_SUCCESS;
+}
+
+pmix_status_t
+pmix_shmem_flat_sizeof_kval(
+    const pmix_kval_t *kv,
+    size_t *size
+) {
+    const pmix_value_t *val;
+    const char *key;
+    uint8_t flags = 0, form;
+    pmix_buffer_t buf;
+    pmix_status_t rc;
+
+    if (NULL == kv || NULL == kv->key || NULL == kv->value || NULL == size) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    val = kv->value;
+    key = kv->key;
+    if (PMIX_CHECK_KEY(kv, PMIX_QUALIFIED_VALUE)) {
+        if (!qualified_shape(val)) {
+            return PMIX_ERR_BAD_PARAM;
+        }
+        key = ((const pmix_info_t *)val->data.darray->array)[0].key;
+        flags = PMIX_SHMEM_FLAT_QUALIFIED;
+    }
+    /* every flat_alloc() a new entry makes, each rounded up as it is */
+    *size = align8(sizeof(pmix_shmem_flat_entry_t)) + align8(strlen(key) + 1);
+
+    PMIX_CONSTRUCT(&buf, pmix_buffer_t);
+    rc = flat_form(val, flags, &form, &buf);
+    if (PMIX_SUCCESS == rc) {
+        if (PMIX_SHMEM_FLAT_PACKED == form) {
+            *size += align8(buf.bytes_used);
+        } else if (PMIX_SHMEM_FLAT_BYTES == form && PMIX_STRING == val->type) {
+            *size += (NULL == val->data.string) ? 0 : align8(strlen(val->data.string) + 1);
+        } else if (PMIX_SHMEM_FLAT_BYTES == form) {
+            *size += (NULL == val->data.bo.bytes) ? 0 : align8(val->data.bo.size);
+        }
+    }
+    PMIX_DESTRUCT(&buf);
+    return rc;
+}
+
+pmix_status_t
+pmix_shmem_flat_store(
+    pmix_shmem_flat_t *f,
+    pmix_rank_t rank,
+    const pmix_kval_t *kv
+) {
+    const pmix_value_t *val;
+    const char *key;
+    uint8_t flags = 0;
+    pmix_status_t rc;
+
+    if (NULL == f || PMIX_SHMEM_FLAT_MAGIC != f->magic || NULL == kv ||
+        NULL == kv->key || NULL == kv->value) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    val = kv->value;
+    key = kv->key;
+    if (PMIX_CHECK_KEY(kv, PMIX_QUALIFIED_VALUE)) {
+        if (!qualified_shape(val)) {
+            return PMIX_ERR_BAD_PARAM;
+        }
+        /* filed under the key it qualifies */
+        key = ((const pmix_info_t *)val->data.darray->array)[0].key;
+        flags = PMIX_SHMEM_FLAT_QUALIFIED;
+    }
+    const uint32_t h = flat_hash(rank, key);
+
+    pmix_shmem_flat_entry_t *e = find_entry(f, rank, key, h,
+                                            (0 == flags) ? NULL : val);
+    if (NULL != e) {
+        return flat_encode(f, &e->value, val, flags);
+    }
+
+    /* A new entry. Grow the rank table first, on its own: it leaves the
+     * image consistent whatever happens next, so a failure past this
+     * point can simply give back what it allocated. */
+    rc = grow_ranks(f);
+    if (PMIX_SUCCESS != rc) {
+        return rc;
+    }
+    const uint64_t mark = f->used;
+    const size_t klen = strlen(key) + 1;
+    char *kcopy;
+
+    e = flat_alloc(f, sizeof(*e));
+    kcopy = (NULL == e) ? NULL : flat_alloc(f, klen);
+    if (NULL == kcopy) {
+        f->used = mark;
+        return PMIX_ERR_OUT_OF_RESOURCE;
+    }
+    rc = flat_encode(f, &e->value, val, flags);
+    if (PMIX_SUCCESS != rc) {
+        f->used = mark;
+        return rc;
+    }
+    memcpy(kcopy, key, klen);
+    rel_set(&e->key, kcopy);
+    e->rank = (uint32_t)rank;
+    e->hash = h;
+
+    /* into its bucket, at the head */
+    pmix_shmem_rel_t *const head = &((pmix_shmem_rel_t *)rel_raw(&f->buckets))[h & (f->nbuckets - 1)];
+    rel_set(&e->chain, rel_raw(head));
+    rel_set(head, e);
+
+    /* and onto the end of its rank's chain */
+    pmix_shmem_flat_rank_t *const tab = rel_raw(&f->ranks);
+    uint32_t i = rank_home(rank, f->rankcap);
+    while (0 != tab[i].first && tab[i].rank != (uint32_t)rank) {
+        i = (i + 1) & (f->rankcap - 1);
+    }
+    if (0 == tab[i].first) {
+        tab[i].rank = (uint32_t)rank;
+        rel_set(&tab[i].first, e);
+        ++f->nranks;
+    } else {
+        pmix_shmem_flat_entry_t *const last = rel_raw(&tab[i].last);
+        rel_set(&last->next, e);
+    }
+    rel_set(&tab[i].last, e);
+    ++tab[i].nentries;
+    ++f->nentries;
+    return PMIX_SUCCESS;
+}
+
+/* ------------------------------------------------------------------ */
+/* fetch                                                               */
+/* ------------------------------------------------------------------ */
+
+/* Copy one entry out as a kval - under PMIX_QUALIFIED_VALUE if that is
+ * how it was stored, the way pmix_hash_fetch() returns one. */
+static pmix_status_t
+copy_out(
+    const pmix_shmem_flat_t *f,
+    const pmix_shmem_flat_entry_t *e,
+    const char *key,
+    pmix_list_t *kvals
+) {
+    const bool qualified = (0 != (e->value.flags & PMIX_SHMEM_FLAT_QUALIFIED));
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+
+    PMIX_KVAL_NEW(kv, qualified ? PMIX_QUALIFIED_VALUE : key);
+    if (NULL == kv || NULL == kv->key) {
+        if (NULL != kv) {
+            PMIX_RELEASE(kv);
+        }
+        return PMIX_ERR_NOMEM;
+    }
+    rc = flat_decode(f, &e->value, kv->value);
+    if (PMIX_SUCCESS == rc && qualified) {
+        if (!qualified_shape(kv->value)) {
+            rc = PMIX_ERR_NOT_FOUND;
+        } else {
+            pmix_info_t *info = (pmix_info_t *)kv->value->data.darray->array;
+            for (size_t n = 1; n < kv->value->data.darray->size; n++) {
+                PMIX_INFO_SET_QUALIFIER(&info[n]);
+            }
+        }
+    }
+    if (PMIX_SUCCESS != rc) {
+        PMIX_RELEASE(kv);
+        return rc;
+    }
+    pmix_list_append(kvals, &kv->super);
+    return PMIX_SUCCESS;
+}
+
+/* Every entry on a rank's chain. The walk is bounded by the count the
+ * writer kept, so a damaged chain cannot loop. */
+static pmix_status_t
+fetch_rank(
+    const pmix_shmem_flat_t *f,
+    const pmix_shmem_flat_rank_t *slot,
+    bool skip_reserved,
+    pmix_list_t *kvals
+) {
+    const pmix_shmem_flat_entry_t *e = rel_get(f, &slot->first, sizeof(*e));
+    pmix_status_t rc;
+
+    for (uint32_t n = 0; NULL != e && n < slot->nentries; n++) {
+        const char *key = rel_str(f, &e->key);
+        if (NULL == key) {
+            return PMIX_ERR_NOT_FOUND;
+        }
+        if (!(skip_reserved && PMIX_CHECK_RESERVED_KEY(key))) {
+            rc = copy_out(f, e, key, kvals);
+            if (PMIX_ERR_NOMEM == rc) {
+                return rc;
+            }
+        }
+        e = rel_get(f, &e->next, sizeof(*e));
+    }
+    return PMIX_SUCCESS;
+}
+
+static pmix_status_t
+fetch_key(
+    const pmix_shmem_flat_t *f,
+    pmix_rank_t rank,
+    const char *key,
+    pmix_info_t *quals,
+    size_t nquals,
+    size_t numquals,
+    pmix_list_t *kvals
+) {
+    const uint32_t h = flat_hash(rank, key);
+    const pmix_shmem_rel_t *buckets =
+        rel_get(f, &f->buckets, f->nbuckets * sizeof(pmix_shmem_rel_t));
+    if (NULL == buckets) {
+        return PMIX_ERR_NOT_FOUND;
+    }
+    const pmix_shmem_flat_entry_t *e = rel_get(f, &buckets[h & (f->nbuckets - 1)], sizeof(*e));
+
+    for (uint32_t n = 0; NULL != e && n < f->nentries; n++, e = rel_get(f, &e->chain, sizeof(*e))) {
+        if (e->hash != h || e->rank != (uint32_t)rank) {
+            continue;
+        }
+        const char *ekey = rel_str(f, &e->key);
+        if (NULL == ekey || 0 != strcmp(ekey, key)) {
+            continue;
+        }
+        const bool qualified = (0 != (e->value.flags & PMIX_SHMEM_FLAT_QUALIFIED));
+        if (0 == numquals) {
+            /* an unqualified request is answered by an unqualified value */
+            if (qualified) {
+                continue;
+            }
+            return copy_out(f, e, key, kvals);
+        }
+        if (!qualified) {
+            continue;
+        }
+        pmix_value_t have;
+        bool match = false;
+        if (PMIX_SUCCESS == flat_decode(f, &e->value, &have)) {
+            match = qualified_shape(&have) && quals_satisfy(&have, quals, nquals);
+        }
+        PMIX_VALUE_DESTRUCT(&have);
+        if (match) {
+            return copy_out(f, e, key, kvals);
+        }
+    }
+    return PMIX_ERR_NOT_FOUND;
+}
+
+pmix_status_t
+pmix_shmem_flat_fetch(
+    const pmix_shmem_flat_t *f,
+    pmix_rank_t rank,
+    const char *key,
+    pmix_info_t *qualifiers,
+    size_t nquals,
+    pmix_list_t *kvals
+) {
+    const pmix_shmem_flat_rank_t *slot;
+    size_t numquals = 0;
+    pmix_status_t rc;
+
+    if (NULL == f || PMIX_SHMEM_FLAT_MAGIC != f->magic) {
+        return PMIX_ERR_NOT_FOUND;
+    }
+    for (size_t m = 0; NULL != qualifiers && m < nquals; m++) {
+        if (PMIX_INFO_IS_QUALIFIER(&qualifiers[m])) {
+            ++numquals;
+        }
+    }
+
+    if (PMIX_RANK_UNDEF == rank) {
+        const pmix_shmem_flat_rank_t *tab =
+            rel_get(f, &f->ranks, f->rankcap * sizeof(pmix_shmem_flat_rank_t));
+        if (NULL == tab) {
+            return PMIX_ERR_NOT_FOUND;
+        }
+        for (uint32_t i = 0; i < f->rankcap; i++) {
+            if (0 == tab[i].first) {
+                continue;
+            }
+            if (NULL == key) {
+                return fetch_rank(f, &tab[i], true, kvals);
+            }
+            rc = fetch_key(f, tab[i].rank, key, qualifiers, nquals, numquals, kvals);
+            if (PMIX_ERR_NOT_FOUND != rc) {
+                return rc;
+            }
+        }
+        return PMIX_ERR_NOT_FOUND;
+    }
+
+    if (NULL == key) {
+        slot = find_rank(f, rank);
+        if (NULL == slot) {
+            return PMIX_ERR_NOT_FOUND;
+        }
+        return fetch_rank(f, slot, false, kvals);
+    }
+    return fetch_key(f, rank, key, qualifiers, nquals, numquals, kvals);
+}
+
+/* ------------------------------------------------------------------ */
+/* merge                                                               */
+/* ------------------------------------------------------------------ */
+
+pmix_status_t
+pmix_shmem_flat_merge(
+    pmix_shmem_flat_t *dst,
+    const pmix_shmem_flat_t *src,
+    pmix_shmem_flat_keep_fn_t keep,
+    void *cbdata
+) {
+    pmix_kval_t *kv;
+    pmix_list_t kvs;
+    pmix_status_t rc = PMIX_SUCCESS;
+
+    if (NULL == dst || PMIX_SHMEM_FLAT_MAGIC != dst->magic ||
+        NULL == src || PMIX_SHMEM_FLAT_MAGIC != src->magic) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    const pmix_shmem_flat_rank_t *tab =
+        rel_get(src, &src->ranks, src->rankcap * sizeof(pmix_shmem_flat_rank_t));
+    if (NULL == tab) {
+        return PMIX_ERR_BAD_PARAM;
+    }
+    /* Through the fetch path and back in through the store, rather than
+     * copying entries across: every reference in an entry is relative to
+     * where it sits, and a store is what decides whether one replaces
+     * something dst already holds. */
+    for (uint32_t i = 0; i < src->rankcap && PMIX_SUCCESS == rc; i++) {
+        if (0 == tab[i].first) {
+            continue;
+        }
+        PMIX_CONSTRUCT(&kvs, pmix_list_t);
+        rc = fetch_rank(src, &tab[i], false, &kvs);
+        PMIX_LIST_FOREACH (kv, &kvs, pmix_kval_t) {
+            if (PMIX_SUCCESS != rc) {
+                break;
+            }
+            if (NULL != keep && !keep(tab[i].rank, kv, cbdata)) {
+                continue;
+            }
+            rc = pmix_shmem_flat_store(dst, tab[i].rank, kv);
+        }
+        PMIX_LIST_DESTRUCT(&kvs);
+    }
+    return rc;
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * A read-mostly key-value image that can be mapped at any address.
+ *
+ * gds/shmem3 builds its shared stores out of the ordinary PMIx classes -
+ * lists, hash tables, key indices - allocated in a segment through a TMA.
+ * Every one of those holds absolute pointers, so every process that reads
+ * the segment has to map it at exactly the address the writer used. When
+ * a client cannot - its address space has moved on since the server chose
+ * the address - it cannot read the segment at all.
+ *
+ * This is the alternative for data that is written once and then only
+ * read. An image is a single contiguous region with no absolute pointer
+ * anywhere in it: every reference is a pmix_shmem_rel_t, the signed
+ * distance from the reference itself to what it names. Copy the region,
+ * map it twice, map it somewhere else in another process - it reads the
+ * same.
+ *
+ * What is in it:
+ *
+ *   - a header, at the base, naming the rest,
+ *   - a chained hash table keyed by (rank, key string). The bucket array
+ *     is flat and its size fixed at creation; chaining means a short
+ *     estimate costs lookups, not correctness,
+ *   - a rank table, open-addressed by rank, heading a chain of that
+ *     rank's entries in the order they were stored - which is what a
+ *     fetch of every key a rank posted walks,
+ *   - the entries, their key strings, and their values.
+ *
+ * A value is held in one of three forms. Scalars are copied bit for bit
+ * into the entry. Strings and byte objects keep their bytes in the image
+ * and are copied out on a fetch. Everything else - arrays, structured
+ * types - is packed with bfrops, so the image never has to know their
+ * shape; those are unpacked on the way out.
+ *
+ * The writer owns the image until it is published, and never writes it
+ * again after. There is no removal: a deletion is stored as a value of
+ * type PMIX_UNDEF, exactly as gds/shmem3 already does for its other
+ * stores, and the reader decides what that means.
+ *
+ * Readers do not trust the image further than they must. Every offset is
+ * checked against the bytes the writer reports having used before it is
+ * followed, so a damaged image reads as "not found" rather than as a
+ * wild pointer.
+ */
+
+#ifndef PMIX_UTIL_SHMEM_FLAT_H
+#define PMIX_UTIL_SHMEM_FLAT_H
+
+#include "src/include/pmix_config.h"
+#include "include/pmix_common.h"
+#include "src/class/pmix_list.h"
+#include "src/include/pmix_globals.h"
+
+BEGIN_C_DECLS
+
+/**
+ * A self-relative reference: the distance in bytes from the field itself
+ * to its target. Zero means NULL - nothing refers to itself.
+ */
+typedef int64_t pmix_shmem_rel_t;
+
+/** "FLAT" */
+#define PMIX_SHMEM_FLAT_MAGIC 0x464c4154u
+
+/** How a value's payload is held - see pmix_shmem_flat_value_t. */
+#define PMIX_SHMEM_FLAT_INLINE 0
+#define PMIX_SHMEM_FLAT_BYTES  1
+#define PMIX_SHMEM_FLAT_PACKED 2
+
+/** The entry holds a PMIX_QUALIFIED_VALUE: a packed array whose first
+ *  element is the value proper and whose remaining ones qualify it. */
+#define PMIX_SHMEM_FLAT_QUALIFIED 0x01
+
+/** Room for any scalar member of pmix_value_t's data union. */
+#define PMIX_SHMEM_FLAT_RAWSIZE sizeof(((pmix_value_t *) 0)->data)
+
+typedef struct {
+    /** pmix_data_type_t of the value as stored. */
+    uint16_t type;
+    /** PMIX_SHMEM_FLAT_INLINE, _BYTES or _PACKED. */
+    uint8_t form;
+    /** PMIX_SHMEM_FLAT_QUALIFIED or zero. */
+    uint8_t flags;
+    uint32_t pad;
+    /** Bytes at "data" - unused for an inline value. */
+    uint64_t size;
+    union {
+        /** The payload, for _BYTES and _PACKED. */
+        pmix_shmem_rel_t data;
+        /** The union member itself, for _INLINE. */
+        unsigned char raw[PMIX_SHMEM_FLAT_RAWSIZE];
+    } u;
+} pmix_shmem_flat_value_t;
+
+typedef struct {
+    /** Next entry in the same hash bucket. */
+    pmix_shmem_rel_t chain;
+    /** Next entry of the same rank, in the order stored. */
+    pmix_shmem_rel_t next;
+    /** NUL-terminated key. */
+    pmix_shmem_rel_t key;
+    uint32_t rank;
+    uint32_t hash;
+    pmix_shmem_flat_value_t value;
+} pmix_shmem_flat_entry_t;
+
+typedef struct {
+    /** First and last of this rank's entries; first is zero in an
+     *  unused slot. */
+    pmix_shmem_rel_t first;
+    pmix_shmem_rel_t last;
+    uint32_t rank;
+    uint32_t nentries;
+} pmix_shmem_flat_rank_t;
+
+/**
+ * The image header, at its base.
+ */
+typedef struct {
+    uint32_t magic;
+    /** pmix_bfrop_buffer_type_t the packed values were written with, so a
+     *  reader unpacks them the same way whatever its own default. */
+    uint32_t buftype;
+    /** Bytes the image may occupy, header included. */
+    uint64_t size;
+    /** Bytes handed out so far, header included. Nothing past this is
+     *  ever referenced. */
+    uint64_t used;
+    /** Buckets in the hash table - a power of two. */
+    uint32_t nbuckets;
+    uint32_t nentries;
+    /** Slots in the rank table - a power of two - and how many are in
+     *  use. The table is rebuilt at twice the size when it passes three
+     *  quarters full. */
+    uint32_t rankcap;
+    uint32_t nranks;
+    /** pmix_shmem_rel_t[nbuckets]: the head of each bucket's chain. */
+    pmix_shmem_rel_t buckets;
+    /** pmix_shmem_flat_rank_t[rankcap] */
+    pmix_shmem_rel_t ranks;
+} pmix_shmem_flat_t;
+
+/**
+ * An upper bound on the bytes an image needs for the given contents:
+ * nranks ranks posting nkvals values between them, whose keys and
+ * payloads total "payload" bytes. Anything bfrops has to pack counts at
+ * its packed size.
+ */
+PMIX_EXPORT size_t
+pmix_shmem_flat_sizeof(
+    size_t nranks,
+    size_t nkvals,
+    size_t payload
+);
+
+/**
+ * The exact bytes an empty image's header and tables take, sized for
+ * nranks ranks and nkvals values - what pmix_shmem_flat_init() lays out
+ * for the same arguments.
+ *
+ * With the true rank count the rank table never has to grow, so this
+ * plus pmix_shmem_flat_sizeof_kval() of every value to be stored is an
+ * image size that is enough, and not by a guess.
+ */
+PMIX_EXPORT size_t
+pmix_shmem_flat_sizeof_tables(
+    size_t nranks,
+    size_t nkvals
+);
+
+/**
+ * The most a pmix_shmem_flat_store() of kv can add to an image: its
+ * entry, its key and its payload, each as aligned. A store that replaces
+ * an existing entry adds less.
+ *
+ * A value that has to be packed is packed to find out, so this is not
+ * free; it is meant for a sizing pass, not for every store.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_shmem_flat_sizeof_kval(
+    const pmix_kval_t *kv,
+    size_t *size
+);
+
+/**
+ * Lay out an empty image in [base, base + size).
+ *
+ * nranks and nkvals size the rank and hash tables; they are estimates,
+ * not limits. Returns PMIX_ERR_OUT_OF_RESOURCE if even the empty tables
+ * do not fit.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_shmem_flat_init(
+    void *base,
+    size_t size,
+    size_t nranks,
+    size_t nkvals
+);
+
+/**
+ * Is there an image of ours at base, within size bytes?
+ *
+ * Only the header is examined. A reader calls this once, when it maps the
+ * region, and then relies on the per-reference checks in the fetch path.
+ */
+PMIX_EXPORT bool
+pmix_shmem_flat_check(
+    const void *base,
+    size_t size
+);
+
+/**
+ * Store kv for rank, replacing what the rank already holds for that key
+ * (and, for a PMIX_QUALIFIED_VALUE, that same set of qualifiers).
+ *
+ * Returns PMIX_ERR_OUT_OF_RESOURCE if the image is full, in which case it
+ * is unchanged. Nothing ever released is reclaimed: a replaced value's
+ * old payload stays where it was, unreferenced.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_shmem_flat_store(
+    pmix_shmem_flat_t *flat,
+    pmix_rank_t rank,
+    const pmix_kval_t *kv
+);
+
+/**
+ * Copy what the image holds into kvals, with the semantics of
+ * pmix_hash_fetch():
+ *
+ *   - a NULL key returns every value the rank posted, in the order it
+ *     was stored,
+ *   - PMIX_RANK_UNDEF with a key returns it from the first rank that
+ *     has it; with no key, the first rank's data minus its reserved keys,
+ *   - qualifiers, when given, must all be matched by a stored qualified
+ *     value; without them, a qualified value does not answer for its key.
+ *
+ * Everything appended is a fresh pmix_kval_t owned by the caller, with no
+ * reference back into the image.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_shmem_flat_fetch(
+    const pmix_shmem_flat_t *flat,
+    pmix_rank_t rank,
+    const char *key,
+    pmix_info_t *qualifiers,
+    size_t nquals,
+    pmix_list_t *kvals
+);
+
+/**
+ * Decide whether pmix_shmem_flat_merge() carries kv, which rank posted,
+ * across. kv is as a fetch returns it: a qualified value comes under
+ * PMIX_QUALIFIED_VALUE.
+ */
+typedef bool (*pmix_shmem_flat_keep_fn_t)(
+    pmix_rank_t rank,
+    const pmix_kval_t *kv,
+    void *cbdata
+);
+
+/**
+ * Store everything src holds into dst, rank by rank and in the order
+ * each rank stored it, skipping whatever keep (if given) turns down.
+ *
+ * What dst already holds for a key is replaced, exactly as a store
+ * would, so merging images oldest first leaves the newest value of
+ * every key - a PMIX_UNDEF one included. Nothing in dst refers to src
+ * afterwards.
+ *
+ * Each value costs dst no more than it occupies in src, so src->used
+ * bytes are always enough for src's share, tables aside. Returns
+ * PMIX_ERR_OUT_OF_RESOURCE if dst fills, having stored what fit.
+ */
+PMIX_EXPORT pmix_status_t
+pmix_shmem_flat_merge(
+    pmix_shmem_flat_t *dst,
+    const pmix_shmem_flat_t *src,
+    pmix_shmem_flat_keep_fn_t keep,
+    void *cbdata
+);
+
+END_C_DECLS
+
+#endif
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for pmix_timer_wheel_t:
+ *   init parameter checks, expiry on the right tick, rounding up to
+ *   whole ticks, batch expiry, del before expiry, re-arming, timeouts
+ *   longer than a full turn, callbacks that add and delete entries,
+ *   and destructing a wheel with entries still pending.
+ *
+ * No event base is used; the wheel is driven by hand through
+ * pmix_timer_wheel_tick().
+ *
+ * Exit 0 if all tests pass, 1 otherwise.
+ */
+
+#include "src/include/pmix_config.h"
+#include "src/include/pmix_globals.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "src/class/pmix_timer_wheel.h"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        npass++;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        nfail++;
+    }
+}
+
+/* 100ms ticks throughout */
+static const struct timeval tick = {0, 100000};
+
+static struct timeval ticks_tv(long nticks)
+{
+    struct timeval tv;
+    long usec = nticks * 100000;
+
+    tv.tv_sec = usec / 1000000;
+    tv.tv_usec = usec % 1000000;
+    return tv;
+}
+
+/* counts its own expiries */
+static void count_cb(pmix_timer_wheel_entry_t *entry, void *cbdata)
+{
+    (void) entry;
+    ++*(int *) cbdata;
+}
+
+/* Tick until the counter moves, returning the tick it moved on, or -1
+ * if it did not within the limit */
+static int ticks_until(pmix_timer_wheel_t *wheel, int *count, int limit)
+{
+    int start = *count;
+    int n;
+
+    for (n = 1; n <= limit; n++) {
+        pmix_timer_wheel_tick(wheel);
+        if (*count != start) {
+            return n;
+        }
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------ */
+/* init                                                                 */
+/* ------------------------------------------------------------------ */
+
+static void test_init(void)
+{
+    pmix_timer_wheel_t wheel;
+    struct timeval zero = {0, 0};
+    pmix_status_t rc;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+
+    rc = pmix_timer_wheel_init(&wheel, NULL, NULL, 8);
+    report("init NULL tick: ERR_BAD_PARAM", PMIX_ERR_BAD_PARAM == rc);
+    rc = pmix_timer_wheel_init(&wheel, NULL, &zero, 8);
+    report("init zero tick: ERR_BAD_PARAM", PMIX_ERR_BAD_PARAM == rc);
+    rc = pmix_timer_wheel_init(&wheel, NULL, &tick, 0);
+    report("init zero slots: ERR_BAD_PARAM", PMIX_ERR_BAD_PARAM == rc);
+
+    rc = pmix_timer_wheel_init(&wheel, NULL, &tick, 5);
+    report("init: returns PMIX_SUCCESS", PMIX_SUCCESS == rc);
+    report("init: slot count rounded up to a power of two", 8 == wheel.nslots);
+    report("init: nothing pending", 0 == wheel.npending);
+    report("init: tick on an empty wheel expires nothing", 0 == pmix_timer_wheel_tick(&wheel));
+
+    /* an idle wheel can be resized */
+    rc = pmix_timer_wheel_init(&wheel, NULL, &tick, 16);
+    report("re-init idle wheel: returns PMIX_SUCCESS", PMIX_SUCCESS == rc);
+    report("re-init idle wheel: new slot count", 16 == wheel.nslots);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_init_busy(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entry;
+    struct timeval tv = ticks_tv(2);
+    int count = 0;
+    pmix_status_t rc;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    pmix_timer_wheel_entry_init(&entry, count_cb, &count);
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+
+    rc = pmix_timer_wheel_init(&wheel, NULL, &tick, 16);
+    report("re-init busy wheel: ERR_BAD_PARAM", PMIX_ERR_BAD_PARAM == rc);
+    report("re-init busy wheel: slots untouched", 8 == wheel.nslots);
+    report("re-init busy wheel: entry still expires on time",
+           2 == ticks_until(&wheel, &count, 20));
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+/* ------------------------------------------------------------------ */
+/* expiry                                                               */
+/* ------------------------------------------------------------------ */
+
+static void test_expiry(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entry;
+    struct timeval tv;
+    int count = 0;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    pmix_timer_wheel_entry_init(&entry, count_cb, &count);
+    report("expiry: new entry is not pending", !pmix_timer_wheel_entry_pending(&entry));
+
+    tv = ticks_tv(3);
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    report("expiry: added entry is pending", pmix_timer_wheel_entry_pending(&entry));
+    report("expiry: wheel counts it", 1 == wheel.npending);
+    report("expiry: fires on the third tick", 3 == ticks_until(&wheel, &count, 20));
+    report("expiry: fires exactly once", 1 == count);
+    report("expiry: no longer pending", !pmix_timer_wheel_entry_pending(&entry));
+    report("expiry: wheel is empty", 0 == wheel.npending);
+    report("expiry: stays quiet afterwards", -1 == ticks_until(&wheel, &count, 20));
+
+    /* a partial tick rounds up, never down */
+    tv.tv_sec = 0;
+    tv.tv_usec = 250000;
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    report("expiry: 2.5 ticks fires on the third", 3 == ticks_until(&wheel, &count, 20));
+
+    /* and a zero timeout still waits for the next tick */
+    tv.tv_usec = 0;
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    report("expiry: zero timeout fires on the next tick", 1 == ticks_until(&wheel, &count, 20));
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_batch(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entries[10];
+    struct timeval tv = ticks_tv(4);
+    int count = 0;
+    size_t n, nexpired = 0;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    for (n = 0; n < 10; n++) {
+        pmix_timer_wheel_entry_init(&entries[n], count_cb, &count);
+        pmix_timer_wheel_add(&wheel, &entries[n], &tv);
+    }
+    report("batch: all ten pending", 10 == wheel.npending);
+    for (n = 0; n < 3; n++) {
+        nexpired += pmix_timer_wheel_tick(&wheel);
+    }
+    report("batch: nothing before the fourth tick", 0 == nexpired && 0 == count);
+    nexpired = pmix_timer_wheel_tick(&wheel);
+    report("batch: fourth tick expires all ten", 10 == nexpired && 10 == count);
+    report("batch: wheel is empty", 0 == wheel.npending);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_del(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t a, b;
+    struct timeval tv = ticks_tv(2);
+    int counta = 0, countb = 0;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    pmix_timer_wheel_entry_init(&a, count_cb, &counta);
+    pmix_timer_wheel_entry_init(&b, count_cb, &countb);
+    pmix_timer_wheel_add(&wheel, &a, &tv);
+    pmix_timer_wheel_add(&wheel, &b, &tv);
+
+    pmix_timer_wheel_del(&wheel, &a);
+    report("del: entry no longer pending", !pmix_timer_wheel_entry_pending(&a));
+    report("del: wheel count drops", 1 == wheel.npending);
+    pmix_timer_wheel_del(&wheel, &a);
+    report("del: second del is harmless", 1 == wheel.npending);
+
+    report("del: the other entry still fires", 2 == ticks_until(&wheel, &countb, 20));
+    report("del: the deleted entry never fires", 0 == counta);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_rearm(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entry;
+    struct timeval tv;
+    int count = 0;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    pmix_timer_wheel_entry_init(&entry, count_cb, &count);
+
+    tv = ticks_tv(2);
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    pmix_timer_wheel_tick(&wheel);
+    /* push it back before it falls due */
+    tv = ticks_tv(5);
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    report("rearm: still counted once", 1 == wheel.npending);
+    report("rearm: fires on the new deadline only", 5 == ticks_until(&wheel, &count, 20));
+    report("rearm: fires exactly once", 1 == count);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_multi_round(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t long_entry, short_entry;
+    struct timeval tv;
+    int countl = 0, counts = 0;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    pmix_timer_wheel_entry_init(&long_entry, count_cb, &countl);
+    pmix_timer_wheel_entry_init(&short_entry, count_cb, &counts);
+
+    /* 19 ticks on an 8-slot wheel shares a slot with 3 ticks */
+    tv = ticks_tv(19);
+    pmix_timer_wheel_add(&wheel, &long_entry, &tv);
+    tv = ticks_tv(3);
+    pmix_timer_wheel_add(&wheel, &short_entry, &tv);
+
+    report("multi-round: short entry fires on its own tick",
+           3 == ticks_until(&wheel, &counts, 40));
+    report("multi-round: long entry not fired with it", 0 == countl);
+    report("multi-round: long entry fires after two more turns",
+           16 == ticks_until(&wheel, &countl, 40));
+
+    /* exactly one full turn */
+    tv = ticks_tv(8);
+    pmix_timer_wheel_add(&wheel, &long_entry, &tv);
+    report("multi-round: a full turn fires on the eighth tick",
+           8 == ticks_until(&wheel, &countl, 40));
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+/* ------------------------------------------------------------------ */
+/* callbacks that touch the wheel                                       */
+/* ------------------------------------------------------------------ */
+
+typedef struct {
+    pmix_timer_wheel_t *wheel;
+    pmix_timer_wheel_entry_t *other;
+    long readd;
+    int count;
+} reentry_t;
+
+/* re-arms itself while readd is positive */
+static void readd_cb(pmix_timer_wheel_entry_t *entry, void *cbdata)
+{
+    reentry_t *r = (reentry_t *) cbdata;
+    struct timeval tv;
+
+    ++r->count;
+    if (0 < r->readd) {
+        tv = ticks_tv(r->readd);
+        r->readd = 0;
+        pmix_timer_wheel_add(r->wheel, entry, &tv);
+    }
+}
+
+/* cancels another entry */
+static void del_cb(pmix_timer_wheel_entry_t *entry, void *cbdata)
+{
+    reentry_t *r = (reentry_t *) cbdata;
+
+    (void) entry;
+    ++r->count;
+    pmix_timer_wheel_del(r->wheel, r->other);
+}
+
+static void test_readd_from_callback(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entry;
+    struct timeval tv = ticks_tv(2);
+    reentry_t r;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+    r.wheel = &wheel;
+    r.other = NULL;
+    r.count = 0;
+
+    /* re-arm for a full turn - it lands in the slot being expired and
+     * must wait for that turn rather than firing again at once */
+    r.readd = 8;
+    pmix_timer_wheel_entry_init(&entry, readd_cb, &r);
+    pmix_timer_wheel_add(&wheel, &entry, &tv);
+    report("readd: first expiry on the second tick", 2 == ticks_until(&wheel, &r.count, 40));
+    report("readd: fires once on that tick", 1 == r.count);
+    report("readd: re-armed from its callback", pmix_timer_wheel_entry_pending(&entry));
+    report("readd: second expiry a full turn later", 8 == ticks_until(&wheel, &r.count, 40));
+    report("readd: wheel is empty", 0 == wheel.npending);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+static void test_del_from_callback(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t first, second;
+    struct timeval tv = ticks_tv(2);
+    reentry_t r1, r2;
+    size_t nexpired;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 8);
+
+    /* both fall due on the same tick; the first to run cancels the other */
+    r1.wheel = &wheel;
+    r1.other = &second;
+    r1.readd = 0;
+    r1.count = 0;
+    r2 = r1;
+    r2.other = &first;
+    pmix_timer_wheel_entry_init(&first, del_cb, &r1);
+    pmix_timer_wheel_entry_init(&second, del_cb, &r2);
+    pmix_timer_wheel_add(&wheel, &first, &tv);
+    pmix_timer_wheel_add(&wheel, &second, &tv);
+
+    pmix_timer_wheel_tick(&wheel);
+    nexpired = pmix_timer_wheel_tick(&wheel);
+    report("del in callback: only one of the pair expired", 1 == nexpired);
+    report("del in callback: only one callback ran", 1 == r1.count + r2.count);
+    report("del in callback: neither is pending",
+           !pmix_timer_wheel_entry_pending(&first) && !pmix_timer_wheel_entry_pending(&second));
+    report("del in callback: wheel is empty", 0 == wheel.npending);
+
+    PMIX_DESTRUCT(&wheel);
+}
+
+/* ------------------------------------------------------------------ */
+/* destruct                                                             */
+/* ------------------------------------------------------------------ */
+
+static void test_destruct_pending(void)
+{
+    pmix_timer_wheel_t wheel;
+    pmix_timer_wheel_entry_t entries[3];
+    struct timeval tv;
+    int count = 0;
+    size_t n;
+
+    PMIX_CONSTRUCT(&wheel, pmix_timer_wheel_t);
+    pmix_timer_wheel_init(&wheel, NULL, &tick, 4);
+    for (n = 0; n < 3; n++) {
+        pmix_timer_wheel_entry_init(&entries[n], count_cb, &count);
+        tv = ticks_tv((long) (n + 1) * 3);
+        pmix_timer_wheel_add(&wheel, &entries[n], &tv);
+    }
+    PMIX_DESTRUCT(&wheel);
+
+    report("destruct: entries left disarmed",
+           !pmix_timer_wheel_entry_pending(&entries[0])
+           && !pmix_timer_wheel_entry_pending(&entries[1])
+           && !pmix_timer_wheel_entry_pending(&entries[2]));
+    report("destruct: no callbacks ran", 0 == count);
+    report("destruct: back to constructed state", NULL == wheel.slots && 0 == wheel.nslots
+           && 0 == wheel.npending);
+    report("destruct: tick on a destructed wheel is a no-op", 0 == pmix_timer_wheel_tick(&wheel));
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    fprintf(stdout, "\n=== pmix_timer_wheel_t unit tests ===\n\n");
+
+    test_init();
+    test_init_busy();
+    test_expiry();
+    test_batch();
+    test_del();
+    test_rearm();
+    test_multi_round();
+    test_readd_from_callback();
+    test_del_from_callback();
+    test_destruct_pending();
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+    return (nfail > 0) ? 1 : 0;
+}
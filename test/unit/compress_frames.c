@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the pcompress framed container - the format a fence
+ * contribution travels in when fence_compress_chunk is set, and which a
+ * receiver opens before expanding any of it. The index is read straight
+ * off the wire, so most of what is pinned here is what open() refuses:
+ *
+ *   - a container of raw and compressed frames reads back frame by
+ *     frame, each to exactly the bytes it was built from,
+ *   - a wrong magic or version is refused,
+ *   - a container cut short anywhere - header, index or data - is
+ *     refused,
+ *   - frames that overlap, leave a gap or stop short of the end of the
+ *     data are refused,
+ *   - a frame count larger than the index could hold is refused before
+ *     anything is read through it,
+ *   - a frame stored as it is must be the size it claims, and unknown
+ *     flags are refused,
+ *   - a compressed frame expanding to other than its claimed size is
+ *     refused.
+ *
+ * The compressed frames need a working compressor, so those checks are
+ * skipped in a --enable-test-build; the rest use raw frames only.
+ *
+ * Exit 0 if all tests pass, 1 otherwise.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix_server.h"
+#include "src/include/pmix_globals.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "src/mca/pcompress/base/base.h"
+
+#define HDR_SIZE   12
+#define ENTRY_SIZE 32
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static uint8_t one[100], two[300], three[7];
+
+/* Three raw frames of different sizes, as a container */
+static bool build_raw(uint8_t **out, size_t *outlen)
+{
+    pmix_compress_frame_t frames[3];
+
+    memset(frames, 0, sizeof(frames));
+    frames[0].bytes = one;
+    frames[0].size = sizeof(one);
+    frames[1].bytes = two;
+    frames[1].size = sizeof(two);
+    frames[2].bytes = three;
+    frames[2].size = sizeof(three);
+    return pmix_compress_base_frames_build(frames, 3, out, outlen);
+}
+
+static bool opens(const uint8_t *in, size_t len)
+{
+    pmix_compress_frames_t frames;
+
+    return pmix_compress_base_frames_open(&frames, in, len);
+}
+
+static void put_u64(uint8_t *p, uint64_t v)
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        p[i] = (uint8_t) (v >> (8 * i));
+    }
+}
+
+static uint8_t *entry(uint8_t *buf, size_t n)
+{
+    return buf + HDR_SIZE + n * ENTRY_SIZE;
+}
+
+static void test_raw(void)
+{
+    pmix_compress_frames_t frames;
+    uint8_t *buf = NULL, *back;
+    size_t len, backlen;
+    bool ok;
+
+    fprintf(stdout, "\n-- raw frames --\n");
+
+    report("a container is built", build_raw(&buf, &len));
+    report("its length is the header, the index and the frames",
+           HDR_SIZE + 3 * ENTRY_SIZE + sizeof(one) + sizeof(two) + sizeof(three) == len);
+    report("it opens", pmix_compress_base_frames_open(&frames, buf, len));
+    report("with all three frames", 3 == frames.nframes);
+    report("and their total size",
+           sizeof(one) + sizeof(two) + sizeof(three) == frames.size);
+
+    ok = pmix_compress_base_frames_read(&frames, 1, &back, &backlen);
+    report("the middle frame reads back on its own", ok);
+    report("as the bytes it was built from",
+           ok && sizeof(two) == backlen && 0 == memcmp(back, two, backlen));
+    if (ok) {
+        free(back);
+    }
+    ok = pmix_compress_base_frames_read(&frames, 2, &back, &backlen);
+    report("so does the last",
+           ok && sizeof(three) == backlen && 0 == memcmp(back, three, backlen));
+    if (ok) {
+        free(back);
+    }
+    report("a frame past the last is refused",
+           !pmix_compress_base_frames_read(&frames, 3, &back, &backlen));
+    report("as is an empty set of frames",
+           !pmix_compress_base_frames_build(NULL, 0, &back, &backlen));
+    free(buf);
+}
+
+static void test_header(void)
+{
+    uint8_t *buf = NULL;
+    size_t len, n;
+    bool all;
+
+    fprintf(stdout, "\n-- header and length --\n");
+
+    if (!build_raw(&buf, &len)) {
+        report("a container is built", false);
+        return;
+    }
+    buf[0] = 'Q';
+    report("a wrong magic is refused", !opens(buf, len));
+    buf[0] = 'P';
+    buf[4] = 2;
+    report("a version from the future is refused", !opens(buf, len));
+    buf[4] = 1;
+    report("restored, it opens again", opens(buf, len));
+
+    /* every strict prefix, whichever part it stops in */
+    all = true;
+    for (n = 0; n < len; n++) {
+        if (opens(buf, n)) {
+            all = false;
+        }
+    }
+    report("a container cut short anywhere is refused", all);
+
+    buf[8] = 4;
+    report("one more frame than was written is refused", !opens(buf, len));
+    buf[8] = 0xff;
+    buf[9] = 0xff;
+    buf[10] = 0xff;
+    buf[11] = 0xff;
+    report("and a count that would overflow the index is refused", !opens(buf, len));
+    buf[8] = 0;
+    buf[9] = 0;
+    buf[10] = 0;
+    buf[11] = 0;
+    report("as is no frames at all", !opens(buf, len));
+    free(buf);
+}
+
+static void test_index(void)
+{
+    uint8_t *buf = NULL;
+    size_t len;
+
+    fprintf(stdout, "\n-- the index --\n");
+
+    if (!build_raw(&buf, &len)) {
+        report("a container is built", false);
+        return;
+    }
+    /* the second frame starts one byte early, overlapping the first */
+    put_u64(entry(buf, 1), sizeof(one) - 1);
+    report("overlapping frames are refused", !opens(buf, len));
+    /* and one byte late, leaving a gap */
+    put_u64(entry(buf, 1), sizeof(one) + 1);
+    report("a gap between frames is refused", !opens(buf, len));
+    put_u64(entry(buf, 1), sizeof(one));
+    report("restored, it opens again", opens(buf, len));
+
+    /* stored less than it says it expands to, with no compression flag */
+    put_u64(entry(buf, 2) + 16, sizeof(three) + 1);
+    report("a raw frame claiming another size is refused", !opens(buf, len));
+    put_u64(entry(buf, 2) + 16, sizeof(three));
+
+    /* the last frame ends short of the data */
+    put_u64(entry(buf, 2) + 8, sizeof(three) - 1);
+    put_u64(entry(buf, 2) + 16, sizeof(three) - 1);
+    report("frames stopping short of the data are refused", !opens(buf, len));
+    put_u64(entry(buf, 2) + 8, sizeof(three));
+    put_u64(entry(buf, 2) + 16, sizeof(three));
+
+    entry(buf, 0)[24] = 0x2;
+    report("an unknown flag is refused", !opens(buf, len));
+    entry(buf, 0)[24] = 0;
+    report("restored, it opens again", opens(buf, len));
+    free(buf);
+}
+
+#if !PMIX_TESTBUILD
+static void test_compressed(void)
+{
+    pmix_compress_frame_t frames[2];
+    pmix_compress_frames_t open;
+    uint8_t *big, *buf = NULL, *back;
+    size_t biglen = 64 * 1024, len, backlen, n;
+    bool ok;
+
+    fprintf(stdout, "\n-- compressed frames --\n");
+
+    big = (uint8_t *) malloc(biglen);
+    for (n = 0; n < biglen; n++) {
+        big[n] = (uint8_t) ('a' + (n / 100) % 26);
+    }
+    memset(frames, 0, sizeof(frames));
+    frames[0].bytes = big;
+    frames[0].size = biglen;
+    pmix_compress_base_frame_compress(&frames[0]);
+    frames[1].bytes = three;
+    frames[1].size = sizeof(three);
+    pmix_compress_base_frame_compress(&frames[1]);
+    report("a large frame compresses", NULL != frames[0].packed);
+    report("a tiny one is left as it is", NULL == frames[1].packed);
+
+    ok = pmix_compress_base_frames_build(frames, 2, &buf, &len);
+    report("a container of both is built", ok);
+    report("smaller than what it holds", ok && len < biglen);
+    ok = ok && pmix_compress_base_frames_open(&open, buf, len);
+    report("it opens", ok);
+    report("claiming both frames' expanded size", ok && biglen + sizeof(three) == open.size);
+    ok = ok && pmix_compress_base_frames_read(&open, 0, &back, &backlen);
+    report("the compressed frame expands",
+           ok && biglen == backlen && 0 == memcmp(back, big, biglen));
+    if (ok) {
+        free(back);
+    }
+
+    /* claim one byte more than the frame expands to */
+    if (NULL != buf) {
+        put_u64(entry(buf, 0) + 16, biglen + 1);
+        ok = pmix_compress_base_frames_open(&open, buf, len);
+        report("a claimed size the frame does not expand to opens",
+               ok);
+        report("but is refused when the frame is read",
+               ok && !pmix_compress_base_frames_read(&open, 0, &back, &backlen));
+    }
+
+    pmix_compress_base_frame_release(&frames[0]);
+    pmix_compress_base_frame_release(&frames[1]);
+    report("release clears the frame", NULL == frames[0].packed && 0 == frames[0].packed_size);
+    free(buf);
+    free(big);
+}
+#endif
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_status_t rc;
+
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+    fprintf(stdout, "pcompress framed container tests\n");
+
+    memset(one, 1, sizeof(one));
+    memset(two, 2, sizeof(two));
+    memset(three, 3, sizeof(three));
+    test_raw();
+    test_header();
+    test_index();
+#if !PMIX_TESTBUILD
+    test_compressed();
+#endif
+
+    fprintf(stdout, "SUMMARY: %d passed, %d failed\n", npass, nfail);
+    PMIx_server_finalize();
+    return (0 == nfail) ? 0 : 1;
+}
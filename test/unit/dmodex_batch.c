@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * White-box unit tests for the gathering of direct-modex requests in
+ * src/server/pmix_server_get.c, and for the fetching ahead that rides on
+ * it.
+ *
+ * The process comes up as a PMIx server whose stub host module has a
+ * direct_modex entry point and declares PMIX_SERVER_DMODEX_BATCH, then
+ * registers an nspace spread over three nodes: ours holds rank 0, a second
+ * node ranks 1-4 and a third ranks 5-7. Server-side GETs for the remote ranks
+ * are driven straight into pmix_server_get, and the stub records every
+ * up-call without answering it, so each case can look at what went up
+ * before deciding what comes back.
+ *
+ * The batch window is set far longer than any case runs, and the batch
+ * size to three, so a batch goes up when the third target for its node
+ * arrives and never behind the test's back - except in the one case that
+ * is about the window, which shortens it first.
+ *
+ * Replies are made with per-target error statuses rather than data. That
+ * keeps the store out of it: an error is forwarded to each requester as it
+ * stands, so which requester hears which status is exactly what says the
+ * reply was taken apart correctly.
+ *
+ * Ordering is deterministic rather than timed. The host's answer is
+ * thread-shifted, and each piece of a batch reply is thread-shifted again
+ * on its way to the tracker, so two blocking round trips through the
+ * progress thread (PMIx_Store_internal) see every piece delivered.
+ *
+ * Test cases:
+ *
+ *   two targets on one node, one on another -> nothing goes up yet
+ *   a third target on the first node        -> one up-call naming all three
+ *   a reply answering two of them, plus a
+ *      proc that was never asked for        -> each answered with its own
+ *                                              status, the stranger ignored,
+ *                                              the host's data released
+ *   the target the reply left out           -> asked for again on its own
+ *   the host refuses a batch                -> each target asked for singly
+ *   the host fails a batch outright         -> every target told so
+ *   a batch the window closes with one
+ *      target in it                         -> asked for on its own
+ *   with prefetch on, a miss                -> its node peers go in the same
+ *                                              up-call, and are marked
+ *   a request for a peer on its way         -> joins it, and counts a hit
+ *   a request for a peer that has landed    -> answered from our store, a hit
+ *   a refused batch with peers in it        -> only the wanted target is
+ *                                              asked for again
+ *   a host that did not opt in              -> asked for at once, singly
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/mca/bfrops/bfrops.h"
+#include "src/server/pmix_server_ops.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DMB_NSPACE  "dmodex-batch-ut"
+#define DMB_NPROCS  8
+#define DMB_MAXCALL 32
+#define DMB_MAXTGT  8
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+/* what the host's direct_modex was asked */
+typedef struct {
+    pmix_rank_t rank;
+    bool batch;
+    size_t ntargets;
+    pmix_rank_t targets[DMB_MAXTGT];
+    pmix_modex_cbfunc_t cbfunc;
+    void *cbdata;
+} upcall_t;
+static volatile int ncalls = 0;
+static upcall_t calls[DMB_MAXCALL];
+/* refuse batched requests, as a host that cannot honor one might */
+static bool refuse_batches = false;
+
+static pmix_status_t direct_modex(const pmix_proc_t *proc, const pmix_info_t info[],
+                                  size_t ninfo, pmix_modex_cbfunc_t cbfunc, void *cbdata)
+{
+    upcall_t *c;
+    pmix_info_t *targets, *tgt;
+    pmix_proc_t *p;
+    size_t n, ntargets;
+
+    if (DMB_MAXCALL <= ncalls) {
+        return PMIX_ERR_NOT_SUPPORTED;
+    }
+    c = &calls[ncalls];
+    memset(c, 0, sizeof(*c));
+    c->rank = proc->rank;
+    for (n = 0; n < ninfo; n++) {
+        if (!PMIX_CHECK_KEY(&info[n], PMIX_DMODEX_BATCH)
+            || PMIX_DATA_ARRAY != info[n].value.type) {
+            continue;
+        }
+        c->batch = true;
+        targets = (pmix_info_t *) info[n].value.data.darray->array;
+        ntargets = info[n].value.data.darray->size;
+        for (c->ntargets = 0; c->ntargets < ntargets && c->ntargets < DMB_MAXTGT; c->ntargets++) {
+            tgt = (pmix_info_t *) targets[c->ntargets].value.data.darray->array;
+            /* the target's id leads its directives */
+            if (!PMIX_CHECK_KEY(&tgt[0], PMIX_PROCID)) {
+                c->targets[c->ntargets] = PMIX_RANK_INVALID;
+                continue;
+            }
+            p = tgt[0].value.data.proc;
+            c->targets[c->ntargets] = p->rank;
+        }
+    }
+    ++ncalls;
+    if (c->batch && refuse_batches) {
+        return PMIX_ERR_NOT_SUPPORTED;
+    }
+    c->cbfunc = cbfunc;
+    c->cbdata = cbdata;
+    return PMIX_SUCCESS;
+}
+
+/* what each requester was told, by rank - the caddy's tag says which */
+static bool answered[DMB_NPROCS];
+static pmix_status_t answer[DMB_NPROCS];
+
+static void get_cbfunc(pmix_status_t status, const char *data, size_t ndata,
+                       void *cbdata, pmix_release_cbfunc_t relfn, void *relcbd)
+{
+    pmix_server_caddy_t *cd = (pmix_server_caddy_t *) cbdata;
+
+    (void) data;
+    (void) ndata;
+    if (cd->hdr.tag < DMB_NPROCS) {
+        answered[cd->hdr.tag] = true;
+        answer[cd->hdr.tag] = status;
+    }
+    if (NULL != relfn) {
+        relfn(relcbd);
+    }
+    PMIX_RELEASE(cd);
+}
+
+/* Drive one server-side GET for a rank of the test nspace */
+static pmix_status_t do_get(pmix_rank_t rank)
+{
+    pmix_server_caddy_t *cd;
+    pmix_buffer_t *buf;
+    pmix_status_t rc;
+    char *cptr = DMB_NSPACE;
+    size_t ninfo = 0;
+
+    answered[rank] = false;
+    answer[rank] = PMIX_SUCCESS;
+
+    buf = PMIX_NEW(pmix_buffer_t);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &cptr, 1, PMIX_STRING);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &rank, 1, PMIX_PROC_RANK);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &ninfo, 1, PMIX_SIZE);
+    cptr = "dmodex-batch-ut.key";
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &cptr, 1, PMIX_STRING);
+
+    cd = PMIX_NEW(pmix_server_caddy_t);
+    PMIX_RETAIN(pmix_globals.mypeer);
+    cd->peer = pmix_globals.mypeer;
+    cd->hdr.tag = rank;
+
+    rc = pmix_server_get(buf, get_cbfunc, cd);
+    if (PMIX_SUCCESS != rc) {
+        /* the switchyard owns the caddy on a non-success return */
+        PMIX_RELEASE(cd);
+    }
+    PMIX_RELEASE(buf);
+    return rc;
+}
+
+/* A blocking round trip through the progress thread. Anything queued onto
+ * that thread before this call has been serviced by the time it returns. */
+static void progress_barrier(void)
+{
+    pmix_value_t v;
+
+    PMIX_VALUE_LOAD(&v, "barrier", PMIX_STRING);
+    PMIx_Store_internal(&pmix_globals.myid, "dmodex-batch-ut.barrier", &v);
+    PMIX_VALUE_DESTRUCT(&v);
+}
+
+static bool host_released = false;
+
+static void host_relfn(void *cbdata)
+{
+    free(cbdata);
+    host_released = true;
+}
+
+/* One target's piece of a batch reply, in the documented form */
+static void pack_piece(pmix_data_buffer_t *dbuf, pmix_rank_t rank, pmix_status_t status)
+{
+    pmix_proc_t proc;
+    pmix_byte_object_t bo = {NULL, 0};
+
+    PMIX_LOAD_PROCID(&proc, DMB_NSPACE, rank);
+    PMIx_Data_pack(NULL, dbuf, &proc, 1, PMIX_PROC);
+    PMIx_Data_pack(NULL, dbuf, &status, 1, PMIX_STATUS);
+    PMIx_Data_pack(NULL, dbuf, &bo, 1, PMIX_BYTE_OBJECT);
+}
+
+/* answer an up-call and wait for the answer to reach every requester */
+static void reply(int call, pmix_status_t status, char *data, size_t ndata)
+{
+    calls[call].cbfunc(status, data, ndata, calls[call].cbdata,
+                       (NULL == data) ? NULL : host_relfn, data);
+    progress_barrier();
+    progress_barrier();
+}
+
+static bool targets_are(int call, pmix_rank_t a, pmix_rank_t b, pmix_rank_t c)
+{
+    return calls[call].batch && 3 == calls[call].ntargets && a == calls[call].targets[0]
+           && b == calls[call].targets[1] && c == calls[call].targets[2];
+}
+
+static bool single(int call, pmix_rank_t rank)
+{
+    return !calls[call].batch && rank == calls[call].rank;
+}
+
+static size_t nbatches(void)
+{
+    return pmix_list_get_size(&pmix_server_globals.dmodex_batches);
+}
+
+static size_t nbatches_indexed(void)
+{
+    return pmix_hash_table_get_size(&pmix_server_globals.dmodex_batches_index);
+}
+
+static bool nothing_parked(void)
+{
+    return (0 == pmix_list_get_size(&pmix_server_globals.local_reqs));
+}
+
+/* Register an nspace over three nodes - ours with rank 0, a second with
+ * ranks 1-4 and a third with ranks 5-7 - and rank 0 as our client, so the
+ * nspace is fully registered and the other ranks are known to be remote.
+ * The maps are what give each remote rank a PMIX_HOSTNAME to group by. */
+static pmix_status_t register_job(void)
+{
+    pmix_info_t info[3];
+    pmix_nspace_t ns;
+    pmix_proc_t proc;
+    pmix_status_t rc;
+    char *noderegex = NULL, *ppnregex = NULL, *nodelist = NULL;
+    uint32_t nprocs = DMB_NPROCS;
+
+    if (0 > asprintf(&nodelist, "%s,dmodex-batch-a,dmodex-batch-b", pmix_globals.hostname)) {
+        return PMIX_ERR_NOMEM;
+    }
+    PMIx_generate_regex(nodelist, &noderegex);
+    PMIx_generate_ppn("0;1,2,3,4;5,6,7", &ppnregex);
+
+    PMIX_INFO_LOAD(&info[0], PMIX_NODE_MAP, noderegex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[1], PMIX_PROC_MAP, ppnregex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[2], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+
+    PMIX_LOAD_NSPACE(ns, DMB_NSPACE);
+    rc = PMIx_server_register_nspace(ns, 1, info, 3, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_DESTRUCT(&info[0]);
+    PMIX_INFO_DESTRUCT(&info[1]);
+    PMIX_INFO_DESTRUCT(&info[2]);
+    free(noderegex);
+    free(ppnregex);
+    free(nodelist);
+    if (PMIX_SUCCESS != rc) {
+        return rc;
+    }
+
+    PMIX_LOAD_PROCID(&proc, DMB_NSPACE, 0);
+    rc = PMIx_server_register_client(&proc, geteuid(), getegid(), NULL, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    return rc;
+}
+
+static void test_gather(void)
+{
+    pmix_data_buffer_t dbuf;
+    pmix_byte_object_t bo;
+    int base;
+
+    fprintf(stdout, "\n-- gathering by node --\n");
+
+    base = ncalls;
+    report("first target is taken", PMIX_SUCCESS == do_get(1));
+    report("second target on the same node is taken", PMIX_SUCCESS == do_get(2));
+    report("a target on another node is taken", PMIX_SUCCESS == do_get(5));
+    report("nothing has gone up yet", base == ncalls);
+    report("one batch is open per node", 2 == nbatches());
+    report("and each is indexed", 2 == nbatches_indexed());
+
+    report("third target on the first node is taken", PMIX_SUCCESS == do_get(3));
+    report("one up-call went", base + 1 == ncalls);
+    report("and it names all three targets", targets_are(base, 1, 2, 3));
+    report("the other node's batch is still open", 1 == nbatches());
+    report("and only it is indexed", 1 == nbatches_indexed());
+
+    /* answer ranks 2 and 1 - in that order, so position in the reply is
+     * not mistaken for position in the request - and a stranger, but not
+     * rank 3 */
+    host_released = false;
+    PMIx_Data_buffer_construct(&dbuf);
+    pack_piece(&dbuf, 2, PMIX_ERR_TIMEOUT);
+    pack_piece(&dbuf, 4, PMIX_ERR_NOT_SUPPORTED);
+    pack_piece(&dbuf, 1, PMIX_ERR_UNREACH);
+    PMIx_Data_unload(&dbuf, &bo);
+    PMIx_Data_buffer_destruct(&dbuf);
+    reply(base, PMIX_SUCCESS, bo.bytes, bo.size);
+
+    report("rank 1 hears its own status", answered[1] && PMIX_ERR_UNREACH == answer[1]);
+    report("rank 2 hears its own status", answered[2] && PMIX_ERR_TIMEOUT == answer[2]);
+    report("the host's data is released", host_released);
+    report("rank 3 is not answered", !answered[3]);
+    report("rank 3 is asked for again on its own",
+           base + 2 == ncalls && single(base + 1, 3));
+
+    reply(base + 1, PMIX_ERR_NOT_FOUND, NULL, 0);
+    report("and hears that answer", answered[3] && PMIX_ERR_NOT_FOUND == answer[3]);
+}
+
+static void test_refused(void)
+{
+    int base, n;
+
+    fprintf(stdout, "\n-- refused and failed batches --\n");
+
+    base = ncalls;
+    refuse_batches = true;
+    do_get(1);
+    do_get(2);
+    do_get(3);
+    refuse_batches = false;
+    report("a refused batch is asked for singly",
+           base + 4 == ncalls && calls[base].batch && single(base + 1, 1)
+               && single(base + 2, 2) && single(base + 3, 3));
+    for (n = 1; n <= 3; n++) {
+        reply(base + n, PMIX_ERR_NOT_FOUND, NULL, 0);
+    }
+    report("and each single is answered",
+           answered[1] && answered[2] && answered[3]);
+
+    base = ncalls;
+    do_get(1);
+    do_get(2);
+    do_get(3);
+    report("a batch goes up", base + 1 == ncalls && targets_are(base, 1, 2, 3));
+    reply(base, PMIX_ERR_TIMEOUT, NULL, 0);
+    report("a failed batch fails every target",
+           answered[1] && PMIX_ERR_TIMEOUT == answer[1]
+               && answered[2] && PMIX_ERR_TIMEOUT == answer[2]
+               && answered[3] && PMIX_ERR_TIMEOUT == answer[3]);
+    report("and asks for none of them again", base + 1 == ncalls);
+}
+
+static void test_window(void)
+{
+    int base, n;
+
+    fprintf(stdout, "\n-- the window --\n");
+
+    /* rank 5's batch was opened with the long window - answer it by
+     * filling it instead */
+    base = ncalls;
+    pmix_server_globals.dmodex_batch_window = 10000;
+    do_get(4);
+    report("a lone target waits for the window", base == ncalls && 2 == nbatches());
+    for (n = 0; n < 200 && base == ncalls; n++) {
+        usleep(10000);
+    }
+    report("the window sends it on its own", base + 1 == ncalls && single(base, 4));
+    reply(base, PMIX_ERR_NOT_FOUND, NULL, 0);
+    report("and its requester is answered", answered[4]);
+
+    base = ncalls;
+    do_get(6);
+    do_get(7);
+    report("rank 5's batch goes when it fills", base + 1 == ncalls && targets_are(base, 5, 6, 7));
+    reply(base, PMIX_ERR_NOT_FOUND, NULL, 0);
+    report("and every requester is answered", answered[5] && answered[6] && answered[7]);
+}
+
+/* Wait for the window to send what is open, and for everything the
+ * timer callback did along with it */
+static void await_calls(int count)
+{
+    int n;
+
+    for (n = 0; n < 200 && count > ncalls; n++) {
+        usleep(10000);
+    }
+    progress_barrier();
+}
+
+/* One target's piece of a batch reply that carries data: a single value,
+ * packed as the host would have returned it for that target alone */
+static void pack_data_piece(pmix_data_buffer_t *dbuf, pmix_rank_t rank)
+{
+    pmix_proc_t proc;
+    pmix_status_t rc, st = PMIX_SUCCESS;
+    pmix_buffer_t blob;
+    pmix_byte_object_t bo;
+    pmix_kval_t kv;
+    pmix_value_t val;
+
+    PMIX_CONSTRUCT(&blob, pmix_buffer_t);
+    val.type = PMIX_STRING;
+    val.data.string = "endpoint";
+    kv.key = "dmodex-batch-ut.key";
+    kv.value = &val;
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &blob, &kv, 1, PMIX_KVAL);
+    (void) rc;
+    PMIX_UNLOAD_BUFFER(&blob, bo.bytes, bo.size);
+    PMIX_DESTRUCT(&blob);
+
+    PMIX_LOAD_PROCID(&proc, DMB_NSPACE, rank);
+    PMIx_Data_pack(NULL, dbuf, &proc, 1, PMIX_PROC);
+    PMIx_Data_pack(NULL, dbuf, &st, 1, PMIX_STATUS);
+    PMIx_Data_pack(NULL, dbuf, &bo, 1, PMIX_BYTE_OBJECT);
+    PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+}
+
+static bool prefetch_marked(pmix_rank_t rank)
+{
+    pmix_namespace_t *nptr = pmix_nspace_lookup(DMB_NSPACE);
+
+    return (NULL != nptr && pmix_bitmap_is_set_bit(&nptr->prefetched, (int) rank));
+}
+
+static void test_prefetch(void)
+{
+    pmix_data_buffer_t dbuf;
+    pmix_byte_object_t bo;
+    int base;
+
+    fprintf(stdout, "\n-- fetching ahead --\n");
+
+    pmix_server_globals.dmodex_prefetch = true;
+    pmix_server_globals.dmodex_batch_max = 8;
+    pmix_server_globals.dmodex_batch_window = 10000;
+
+    /* nothing has been stored for ranks 1-4 - every reply so far was an
+     * error - so all three of rank 1's node peers are fetched with it */
+    base = ncalls;
+    do_get(1);
+    report("a miss brings its node peers along",
+           3 == pmix_server_globals.dmodex_prefetched && 4 == pmix_list_get_size(&pmix_server_globals.local_reqs));
+    report("and marks them", prefetch_marked(2) && prefetch_marked(3) && prefetch_marked(4));
+    do_get(2);
+    report("a request for one on its way joins it",
+           1 == pmix_server_globals.dmodex_prefetch_hits && !prefetch_marked(2)
+               && 4 == pmix_list_get_size(&pmix_server_globals.local_reqs));
+    await_calls(base + 1);
+    report("they all go in one up-call", base + 1 == ncalls && calls[base].batch
+                                             && 4 == calls[base].ntargets
+                                             && 1 == calls[base].targets[0]);
+
+    PMIx_Data_buffer_construct(&dbuf);
+    pack_data_piece(&dbuf, 1);
+    pack_data_piece(&dbuf, 2);
+    pack_data_piece(&dbuf, 3);
+    pack_data_piece(&dbuf, 4);
+    PMIx_Data_unload(&dbuf, &bo);
+    PMIx_Data_buffer_destruct(&dbuf);
+    reply(base, PMIX_SUCCESS, bo.bytes, bo.size);
+    report("both requesters are answered with data",
+           answered[1] && PMIX_SUCCESS == answer[1] && answered[2] && PMIX_SUCCESS == answer[2]);
+    report("nothing is left waiting", nothing_parked());
+
+    base = ncalls;
+    report("a request for a rank fetched ahead is answered at once",
+           PMIX_SUCCESS == do_get(3) && answered[3] && PMIX_SUCCESS == answer[3]);
+    report("without going to the host", base == ncalls);
+    report("and counts as a hit", 2 == pmix_server_globals.dmodex_prefetch_hits
+                                      && !prefetch_marked(3) && prefetch_marked(4));
+
+    /* only ride along - a speculative fetch never goes on its own */
+    base = ncalls;
+    refuse_batches = true;
+    do_get(5);
+    report("the next node's peers are brought along",
+           5 == pmix_server_globals.dmodex_prefetched && prefetch_marked(6) && prefetch_marked(7));
+    await_calls(base + 2);
+    report("when the batch is refused only the wanted target goes again",
+           base + 2 == ncalls && calls[base].batch && single(base + 1, 5));
+    refuse_batches = false;
+    report("and the peers are dropped", !prefetch_marked(6) && !prefetch_marked(7)
+                                            && 1 == pmix_list_get_size(&pmix_server_globals.local_reqs));
+    reply(base + 1, PMIX_ERR_NOT_FOUND, NULL, 0);
+    report("the target's requester is answered", answered[5] && nothing_parked());
+
+    pmix_server_globals.dmodex_prefetch = false;
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_info_t info;
+    pmix_status_t rc;
+    int base;
+
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "dmodex_batch: direct-modex batching unit tests\n");
+
+    mymodule.direct_modex = direct_modex;
+    PMIX_INFO_LOAD(&info, PMIX_SERVER_DMODEX_BATCH, NULL, PMIX_BOOL);
+    rc = PMIx_server_init(&mymodule, &info, 1);
+    PMIX_INFO_DESTRUCT(&info);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+    pmix_server_globals.dmodex_batch_window = 60 * 1000000;
+    pmix_server_globals.dmodex_batch_max = 3;
+
+    rc = register_job();
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "register_job failed: %s\n", PMIx_Error_string(rc));
+        PMIx_server_finalize();
+        return 1;
+    }
+
+    test_gather();
+    test_refused();
+    test_window();
+    test_prefetch();
+    report("nothing is left parked", nothing_parked() && 0 == nbatches()
+                                         && 0 == nbatches_indexed());
+
+    fprintf(stdout, "\n-- a host that did not opt in --\n");
+    pmix_server_globals.dmodex_batch = false;
+    base = ncalls;
+    do_get(6);
+    report("a target goes up at once, singly", base + 1 == ncalls && single(base, 6));
+    reply(base, PMIX_ERR_NOT_FOUND, NULL, 0);
+    report("and is answered", answered[6] && nothing_parked());
+
+    PMIx_server_finalize();
+
+    fprintf(stdout, "dmodex_batch: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * White-box unit tests for the index of pending direct-modex trackers -
+ * pmix_server_globals.local_reqs_index, kept by src/server/pmix_server_get.c
+ * alongside the local_reqs list.
+ *
+ * The process comes up as a PMIx server whose stub host module has a
+ * direct_modex entry point that records every up-call without answering
+ * it, then registers an nspace with one rank on our node and DMI_NREMOTE on
+ * another. A server-side GET for each remote rank parks a tracker, so the
+ * cases start with that many outstanding requests - the situation the
+ * index is there for.
+ *
+ * Resolution is driven through pmix_pending_resolve() with no tracker
+ * given, which is the nspace-wide form a local commit uses, and with error
+ * statuses rather than data so the store stays out of it: a requester that
+ * hears the status meant for its target was found through the index, and
+ * one that hears nothing was rightly left alone.
+ *
+ * Test cases:
+ *
+ *   a get for each remote rank          -> one up-call and one tracker each,
+ *                                          every tracker filed in the index
+ *   a second get for a parked target    -> joins its tracker, no up-call
+ *   resolving one rank                  -> both its requesters answered,
+ *                                          nobody else, its tracker gone
+ *   resolving a rank nobody asked for   -> nothing changes
+ *   the host answering the retired
+ *      target late                      -> nobody is answered twice
+ *   the host answering every other
+ *      target, last asked first         -> each requester hears its own
+ *                                          status, list and index empty
+ *   a get for a job-level key we do
+ *      not hold                         -> one wildcard-rank up-call
+ *   resolving the wildcard rank         -> its requester answered, its
+ *                                          tracker gone
+ *   a get for the unconnected local
+ *      rank that times out              -> its requester hears the timeout
+ *                                          and its tracker is retired
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/mca/bfrops/bfrops.h"
+#include "src/server/pmix_server_ops.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define DMI_NSPACE  "dmodex-index-ut"
+#define DMI_NREMOTE 256
+#define DMI_NPROCS  (DMI_NREMOTE + 1)
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+/* what the host's direct_modex was asked, by target rank */
+static int ncalls = 0;
+static pmix_modex_cbfunc_t call_cbfunc[DMI_NPROCS];
+static void *call_cbdata[DMI_NPROCS];
+static pmix_modex_cbfunc_t wild_cbfunc = NULL;
+static void *wild_cbdata = NULL;
+
+static pmix_status_t direct_modex(const pmix_proc_t *proc, const pmix_info_t info[],
+                                  size_t ninfo, pmix_modex_cbfunc_t cbfunc, void *cbdata)
+{
+    (void) info;
+    (void) ninfo;
+    if (PMIX_RANK_WILDCARD == proc->rank && NULL == wild_cbfunc) {
+        wild_cbfunc = cbfunc;
+        wild_cbdata = cbdata;
+        ++ncalls;
+        return PMIX_SUCCESS;
+    }
+    if (DMI_NPROCS <= proc->rank || NULL != call_cbfunc[proc->rank]) {
+        return PMIX_ERR_NOT_SUPPORTED;
+    }
+    call_cbfunc[proc->rank] = cbfunc;
+    call_cbdata[proc->rank] = cbdata;
+    ++ncalls;
+    return PMIX_SUCCESS;
+}
+
+/* How often each requester was answered, and with what. A requester's
+ * caddy tag is its target rank, plus DMI_NPROCS for a second requester
+ * after the same target. */
+static int nanswers[2 * DMI_NPROCS];
+static pmix_status_t answer[2 * DMI_NPROCS];
+
+static void get_cbfunc(pmix_status_t status, const char *data, size_t ndata,
+                       void *cbdata, pmix_release_cbfunc_t relfn, void *relcbd)
+{
+    pmix_server_caddy_t *cd = (pmix_server_caddy_t *) cbdata;
+
+    (void) data;
+    (void) ndata;
+    if (cd->hdr.tag < 2 * DMI_NPROCS) {
+        nanswers[cd->hdr.tag]++;
+        answer[cd->hdr.tag] = status;
+    }
+    if (NULL != relfn) {
+        relfn(relcbd);
+    }
+    PMIX_RELEASE(cd);
+}
+
+/* Drive one server-side GET for a rank of the test nspace, with a
+ * PMIX_TIMEOUT if tmo is not zero */
+static pmix_status_t do_get_key(pmix_rank_t rank, uint32_t tag, char *key, uint32_t tmo)
+{
+    pmix_server_caddy_t *cd;
+    pmix_buffer_t *buf;
+    pmix_info_t info;
+    pmix_status_t rc;
+    char *cptr = DMI_NSPACE;
+    size_t ninfo = (0 < tmo) ? 1 : 0;
+
+    buf = PMIX_NEW(pmix_buffer_t);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &cptr, 1, PMIX_STRING);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &rank, 1, PMIX_PROC_RANK);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &ninfo, 1, PMIX_SIZE);
+    if (0 < ninfo) {
+        PMIX_INFO_LOAD(&info, PMIX_TIMEOUT, &tmo, PMIX_UINT32);
+        PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &info, 1, PMIX_INFO);
+        PMIX_INFO_DESTRUCT(&info);
+    }
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, buf, &key, 1, PMIX_STRING);
+
+    cd = PMIX_NEW(pmix_server_caddy_t);
+    PMIX_RETAIN(pmix_globals.mypeer);
+    cd->peer = pmix_globals.mypeer;
+    cd->hdr.tag = tag;
+
+    rc = pmix_server_get(buf, get_cbfunc, cd);
+    if (PMIX_SUCCESS != rc) {
+        /* the switchyard owns the caddy on a non-success return */
+        PMIX_RELEASE(cd);
+    }
+    PMIX_RELEASE(buf);
+    return rc;
+}
+
+static pmix_status_t do_get(pmix_rank_t rank, uint32_t tag)
+{
+    return do_get_key(rank, tag, "dmodex-index-ut.key", 0);
+}
+
+/* A blocking round trip through the progress thread. Anything queued onto
+ * that thread before this call has been serviced by the time it returns. */
+static void progress_barrier(void)
+{
+    pmix_value_t v;
+
+    PMIX_VALUE_LOAD(&v, "barrier", PMIX_STRING);
+    PMIx_Store_internal(&pmix_globals.myid, "dmodex-index-ut.barrier", &v);
+    PMIX_VALUE_DESTRUCT(&v);
+}
+
+/* answer an up-call and wait for the answer to reach every requester */
+static void reply(pmix_rank_t rank, pmix_status_t status)
+{
+    call_cbfunc[rank](status, NULL, 0, call_cbdata[rank], NULL, NULL);
+    progress_barrier();
+    progress_barrier();
+}
+
+/* a status to tell each target's requesters, different for neighbours */
+static pmix_status_t status_for(pmix_rank_t rank)
+{
+    return (0 == rank % 2) ? PMIX_ERR_UNREACH : PMIX_ERR_TIMEOUT;
+}
+
+static size_t nparked(void)
+{
+    return pmix_list_get_size(&pmix_server_globals.local_reqs);
+}
+
+static size_t nindexed(void)
+{
+    return pmix_hash_table_get_size(&pmix_server_globals.local_reqs_index);
+}
+
+/* Register an nspace over two nodes - ours with rank 0, a second with
+ * every other rank - and rank 0 as our client, so the nspace is fully
+ * registered and the other ranks are known to be remote. */
+static pmix_status_t register_job(void)
+{
+    pmix_info_t info[3];
+    pmix_nspace_t ns;
+    pmix_proc_t proc;
+    pmix_status_t rc;
+    char *noderegex = NULL, *ppnregex = NULL, *nodelist = NULL;
+    char *ppn, *p;
+    uint32_t nprocs = DMI_NPROCS;
+    pmix_rank_t r;
+
+    if (0 > asprintf(&nodelist, "%s,dmodex-index-a", pmix_globals.hostname)) {
+        return PMIX_ERR_NOMEM;
+    }
+    ppn = (char *) malloc(16 * DMI_NPROCS);
+    if (NULL == ppn) {
+        free(nodelist);
+        return PMIX_ERR_NOMEM;
+    }
+    p = ppn + sprintf(ppn, "0;");
+    for (r = 1; r < DMI_NPROCS; r++) {
+        p += sprintf(p, (1 == r) ? "%u" : ",%u", r);
+    }
+    PMIx_generate_regex(nodelist, &noderegex);
+    PMIx_generate_ppn(ppn, &ppnregex);
+
+    PMIX_INFO_LOAD(&info[0], PMIX_NODE_MAP, noderegex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[1], PMIX_PROC_MAP, ppnregex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[2], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+
+    PMIX_LOAD_NSPACE(ns, DMI_NSPACE);
+    rc = PMIx_server_register_nspace(ns, 1, info, 3, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_DESTRUCT(&info[0]);
+    PMIX_INFO_DESTRUCT(&info[1]);
+    PMIX_INFO_DESTRUCT(&info[2]);
+    free(noderegex);
+    free(ppnregex);
+    free(nodelist);
+    free(ppn);
+    if (PMIX_SUCCESS != rc) {
+        return rc;
+    }
+
+    PMIX_LOAD_PROCID(&proc, DMI_NSPACE, 0);
+    rc = PMIx_server_register_client(&proc, geteuid(), getegid(), NULL, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    return rc;
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_namespace_t *nptr;
+    pmix_status_t rc;
+    pmix_rank_t r;
+    bool ok;
+    int base;
+
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "dmodex_index: pending direct-modex index unit tests\n");
+
+    mymodule.direct_modex = direct_modex;
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+    rc = register_job();
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "register_job failed: %s\n", PMIx_Error_string(rc));
+        PMIx_server_finalize();
+        return 1;
+    }
+    nptr = pmix_nspace_lookup(DMI_NSPACE);
+    if (NULL == nptr) {
+        fprintf(stderr, "registered nspace not found\n");
+        PMIx_server_finalize();
+        return 1;
+    }
+
+    fprintf(stdout, "\n-- parking --\n");
+    ok = true;
+    for (r = 1; r < DMI_NPROCS; r++) {
+        ok = ok && PMIX_SUCCESS == do_get(r, r);
+    }
+    report("a get for each remote rank is taken", ok);
+    report("each went up on its own", DMI_NREMOTE == ncalls);
+    report("each parked a tracker", DMI_NREMOTE == nparked());
+    report("and each tracker is indexed", DMI_NREMOTE == nindexed());
+
+    base = ncalls;
+    report("a second get for a parked target is taken",
+           PMIX_SUCCESS == do_get(7, 7 + DMI_NPROCS));
+    report("and joins its tracker", base == ncalls && DMI_NREMOTE == nparked()
+                                        && DMI_NREMOTE == nindexed());
+
+    fprintf(stdout, "\n-- resolving --\n");
+    pmix_pending_resolve(nptr, 7, PMIX_ERR_TIMEOUT, PMIX_REMOTE, NULL);
+    report("resolving a rank answers both its requesters",
+           1 == nanswers[7] && PMIX_ERR_TIMEOUT == answer[7]
+               && 1 == nanswers[7 + DMI_NPROCS] && PMIX_ERR_TIMEOUT == answer[7 + DMI_NPROCS]);
+    ok = true;
+    for (r = 1; r < DMI_NPROCS; r++) {
+        ok = ok && (7 == r || 0 == nanswers[r]);
+    }
+    report("and nobody else", ok);
+    report("and retires its tracker", DMI_NREMOTE - 1 == nparked()
+                                          && DMI_NREMOTE - 1 == nindexed());
+
+    pmix_pending_resolve(nptr, DMI_NPROCS + 5, PMIX_ERR_TIMEOUT, PMIX_REMOTE, NULL);
+    report("resolving a rank nobody asked for changes nothing",
+           DMI_NREMOTE - 1 == nparked() && DMI_NREMOTE - 1 == nindexed());
+
+    reply(7, PMIX_ERR_UNREACH);
+    report("the host's late answer for it answers nobody twice",
+           1 == nanswers[7] && 1 == nanswers[7 + DMI_NPROCS] && PMIX_ERR_TIMEOUT == answer[7]);
+
+    for (r = DMI_NPROCS - 1; 0 < r; r--) {
+        if (7 != r) {
+            reply(r, status_for(r));
+        }
+    }
+    ok = true;
+    for (r = 1; r < DMI_NPROCS; r++) {
+        ok = ok && 1 == nanswers[r] && (7 == r || status_for(r) == answer[r]);
+    }
+    report("the host's answers reach each requester with its own status", ok);
+    report("nothing is left parked", 0 == nparked());
+    report("nothing is left indexed", 0 == nindexed());
+
+    /* the tags of rank 0, which is local and so never asked after above */
+    fprintf(stdout, "\n-- wildcard rank --\n");
+    base = ncalls;
+    report("a get for a job-level key we do not hold is taken",
+           PMIX_SUCCESS == do_get_key(PMIX_RANK_WILDCARD, DMI_NPROCS, "pmix.dmodex-index-ut", 0));
+    report("and goes up for the wildcard rank",
+           base + 1 == ncalls && NULL != wild_cbfunc && 1 == nparked() && 1 == nindexed());
+    pmix_pending_resolve(nptr, PMIX_RANK_WILDCARD, PMIX_ERR_TIMEOUT, PMIX_REMOTE, NULL);
+    report("resolving the wildcard rank answers its requester",
+           1 == nanswers[DMI_NPROCS] && PMIX_ERR_TIMEOUT == answer[DMI_NPROCS]);
+    report("and retires its tracker", 0 == nparked() && 0 == nindexed());
+    wild_cbfunc(PMIX_ERR_UNREACH, NULL, 0, wild_cbdata, NULL, NULL);
+    progress_barrier();
+    progress_barrier();
+    report("the host's late answer for it answers nobody twice", 1 == nanswers[DMI_NPROCS]);
+
+    fprintf(stdout, "\n-- timing out --\n");
+    report("a get with a timeout for the unconnected local rank is taken",
+           PMIX_SUCCESS == do_get_key(0, 0, "dmodex-index-ut.key", 1));
+    report("and parks a tracker", 1 == nparked() && 1 == nindexed());
+    sleep(2);
+    progress_barrier();
+    report("the requester hears the timeout", 1 == nanswers[0] && PMIX_ERR_TIMEOUT == answer[0]);
+    report("and the tracker nobody waits on is retired", 0 == nparked() && 0 == nindexed());
+
+    PMIx_server_finalize();
+
+    fprintf(stdout, "dmodex_index: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
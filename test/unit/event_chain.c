@@ -67,6 +67,12 @@
  *      joins the same entry; and deregistration finds what registration
  *      created.
  *
+ *  registration index: a few hundred codes registered by a client can
+ *      each be found by code, every entry on the registration list is
+ *      in the index, the default handlers are found by
+ *      PMIX_MAX_ERR_CONSTANT without being filed under it, and
+ *      deregistration removes a code from both.
+ *
  *  internal observers (openpmix#4059): a library observer records the
  *      same per-code interest a handler does, sees an event even when an
  *      application handler ends the chain with PMIX_EVENT_ACTION_COMPLETE,
@@ -973,6 +979,104 @@ static void test_duplicate_code_registrations(void)
     report("the untouched code deregisters normally", !exists && 0 == n);
 }
 
+/* Every code a client registers for has to be found by code alone - that
+ * is how _notify_client_event picks the registrations an event fans out
+ * to - and must stop being found once the last registrant is gone. The
+ * list and the index hold the same objects, so check them against each
+ * other as well as against what was registered. */
+#define EVUT_NINDEX 300
+#define EVUT_CODE_INDEX_BASE -9100
+
+static bool index_matches_list(void)
+{
+    pmix_regevents_info_t *reginfo;
+
+    PMIX_LIST_FOREACH (reginfo, &pmix_server_globals.events, pmix_regevents_info_t) {
+        if (pmix_server_find_reginfo(reginfo->code) != reginfo) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_registration_index(void)
+{
+    pmix_status_t codes[EVUT_NINDEX];
+    pmix_status_t wildcard = PMIX_MAX_ERR_CONSTANT;
+    pmix_regevents_info_t *reginfo;
+    size_t n, nfound = 0, nbad = 0;
+    pmix_status_t rc;
+
+    fprintf(stdout, "registration index:\n");
+
+    for (n = 0; n < EVUT_NINDEX; n++) {
+        codes[n] = EVUT_CODE_INDEX_BASE - (pmix_status_t) n;
+    }
+    report("no entry exists for an unregistered code",
+           NULL == pmix_server_find_reginfo(codes[0]));
+
+    rc = client_evreq(codes, EVUT_NINDEX, false);
+    report("registering many codes at once succeeds",
+           PMIX_SUCCESS == rc || PMIX_OPERATION_SUCCEEDED == rc);
+    for (n = 0; n < EVUT_NINDEX; n++) {
+        reginfo = pmix_server_find_reginfo(codes[n]);
+        if (NULL == reginfo) {
+            continue;
+        }
+        ++nfound;
+        if (codes[n] != reginfo->code || 1 != pmix_list_get_size(&reginfo->peers)) {
+            ++nbad;
+        }
+    }
+    report("every code is found by code", EVUT_NINDEX == nfound);
+    report("each is the entry for that code, with its registrant", 0 == nbad);
+    report("every listed entry is indexed", index_matches_list());
+
+    /* the default handlers are found by their marker, but are not filed
+     * in the index under it - nothing raises PMIX_MAX_ERR_CONSTANT */
+    rc = client_evreq(NULL, 0, false);
+    report("a default registration alongside succeeds",
+           PMIX_SUCCESS == rc || PMIX_OPERATION_SUCCEEDED == rc);
+    reginfo = pmix_server_find_reginfo(PMIX_MAX_ERR_CONSTANT);
+    report("the default handlers are found by their marker",
+           NULL != reginfo && reginfo == pmix_server_globals.default_events);
+    report("the default handlers are kept out of the index",
+           pmix_list_get_size(&pmix_server_globals.events)
+               == pmix_hash_table_get_size(&pmix_server_globals.events_index) + 1);
+
+    /* drop every other code, then the rest */
+    for (n = 0; n < EVUT_NINDEX; n += 2) {
+        client_evreq(&codes[n], 1, true);
+    }
+    nbad = 0;
+    for (n = 0; n < EVUT_NINDEX; n++) {
+        reginfo = pmix_server_find_reginfo(codes[n]);
+        if ((0 == n % 2) != (NULL == reginfo)) {
+            ++nbad;
+        }
+    }
+    report("deregistered codes are gone and the rest remain", 0 == nbad);
+    report("list and index still agree", index_matches_list());
+
+    for (n = 1; n < EVUT_NINDEX; n += 2) {
+        client_evreq(&codes[n], 1, true);
+    }
+    client_evreq(&wildcard, 1, true);
+    nfound = 0;
+    for (n = 0; n < EVUT_NINDEX; n++) {
+        if (NULL != pmix_server_find_reginfo(codes[n])) {
+            ++nfound;
+        }
+    }
+    report("no code survives its deregistration", 0 == nfound);
+    report("the default handlers are gone too",
+           NULL == pmix_server_globals.default_events);
+    report("list and index are back where they started",
+           index_matches_list()
+               && pmix_list_get_size(&pmix_server_globals.events)
+                      == pmix_hash_table_get_size(&pmix_server_globals.events_index));
+}
+
 static void test_enviro_handshake(void)
 {
     pmix_status_t s1 = PMIX_EVENT_SYS_BASE;
@@ -1455,6 +1559,7 @@ int main(int argc, char **argv)
      * absent when we ask for one */
     test_default_registration();
     test_duplicate_code_registrations();
+    test_registration_index();
 
     /* registration placement and chain progression */
     test_chain_order();
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the assembly of a server's fence contribution -
+ * pmix_server_collect_data() - and for reading it back with
+ * pmix_gds_base_store_modex().
+ *
+ * The contribution can be packed on several threads (fence_threads) and
+ * sent as a framed container (fence_compress_chunk), which the receiver
+ * expands and stores a frame at a time. What is pinned here:
+ *
+ *   - threads alone change nothing on the wire: the bytes are the ones
+ *     a single thread sends,
+ *   - a framed contribution is the same bytes however many threads
+ *     compressed it, and is really in the framed form,
+ *   - the receiver reads a framed contribution back into exactly what
+ *     it reads from a whole one - every rank, every value, in order -
+ *     whether it expands the frames on one thread or several,
+ *   - a frame that ends partway through a rank's data is refused, not
+ *     stored short.
+ *
+ * Exit 0 if all tests pass, 1 otherwise.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/class/pmix_list.h"
+#include "src/include/pmix_globals.h"
+#include "src/mca/bfrops/bfrops.h"
+#include "src/mca/gds/base/base.h"
+#include "src/mca/gds/gds.h"
+#include "src/mca/pcompress/base/base.h"
+#include "src/server/pmix_server_ops.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_NSPACE "fence-collect"
+#define TEST_NRANKS 64
+#define TEST_CHUNK  4096
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+/* Give every rank a couple of KiB of remote-scope data: a string that
+ * compresses, differing per rank so no two blobs are alike, and an int. */
+static bool populate(void)
+{
+    pmix_nspace_t nsp;
+    pmix_proc_t proc;
+    pmix_kval_t kv;
+    pmix_value_t val;
+    pmix_status_t rc;
+    char str[2048];
+    pmix_rank_t r;
+    size_t n;
+
+    PMIX_LOAD_NSPACE(nsp, TEST_NSPACE);
+    rc = PMIx_server_register_nspace(nsp, TEST_NRANKS, NULL, 0, NULL, NULL);
+    if (PMIX_SUCCESS != rc && PMIX_OPERATION_SUCCEEDED != rc) {
+        return false;
+    }
+    for (r = 0; r < TEST_NRANKS; r++) {
+        PMIX_LOAD_PROCID(&proc, TEST_NSPACE, r);
+        for (n = 0; n < sizeof(str) - 1; n++) {
+            str[n] = (char) ('a' + (n / 64 + r) % 26);
+        }
+        str[sizeof(str) - 1] = '\0';
+        val.type = PMIX_STRING;
+        val.data.string = str;
+        kv.key = "fence.collect.endpoint";
+        kv.value = &val;
+        PMIX_GDS_STORE_KV(rc, pmix_globals.mypeer, &proc, PMIX_REMOTE, &kv);
+        if (PMIX_SUCCESS != rc) {
+            return false;
+        }
+        val.type = PMIX_UINT32;
+        val.data.uint32 = 1000 + r;
+        kv.key = "fence.collect.port";
+        PMIX_GDS_STORE_KV(rc, pmix_globals.mypeer, &proc, PMIX_REMOTE, &kv);
+        if (PMIX_SUCCESS != rc) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* A collecting tracker with one local participant per rank, built the
+ * way the fence handler leaves one: a caddy per peer, each peer with
+ * its rank info. */
+static pmix_server_trkr_t *mktracker(void)
+{
+    pmix_server_trkr_t *trk = PMIX_NEW(pmix_server_trkr_t);
+    pmix_server_caddy_t *cd;
+    pmix_peer_t *peer;
+    pmix_rank_t r;
+
+    trk->type = PMIX_FENCENB_CMD;
+    trk->collect_type = PMIX_COLLECT_YES;
+    for (r = 0; r < TEST_NRANKS; r++) {
+        peer = PMIX_NEW(pmix_peer_t);
+        peer->info = PMIX_NEW(pmix_rank_info_t);
+        peer->info->pname.nspace = strdup(TEST_NSPACE);
+        peer->info->pname.rank = r;
+        cd = PMIX_NEW(pmix_server_caddy_t);
+        cd->peer = peer;
+        pmix_list_append(&trk->local_cbs, &cd->super);
+    }
+    return trk;
+}
+
+static pmix_status_t collect(pmix_server_trkr_t *trk, unsigned int threads,
+                             size_t chunk, pmix_buffer_t *out)
+{
+    pmix_server_globals.fence_threads = threads;
+    pmix_server_globals.fence_compress_chunk = chunk;
+    return pmix_server_collect_data(trk, out);
+}
+
+static bool same_bytes(pmix_buffer_t *a, pmix_buffer_t *b)
+{
+    return a->bytes_used == b->bytes_used
+           && 0 == memcmp(a->base_ptr, b->base_ptr, a->bytes_used);
+}
+
+/* What the receiver handed its GDS callback, folded into one digest so
+ * two receptions can be compared: each rank, in order, and the bytes of
+ * its data. */
+static size_t seen_nblobs = 0;
+static uint64_t seen_digest = 0;
+
+static void fold(const void *p, size_t len)
+{
+    const unsigned char *c = (const unsigned char *) p;
+    size_t n;
+
+    for (n = 0; n < len; n++) {
+        seen_digest ^= c[n];
+        seen_digest *= 1099511628211ULL;
+    }
+}
+
+static pmix_status_t seen_cb(pmix_proc_t *proc, pmix_buffer_t *pbkt, uint8_t kind)
+{
+    (void) kind;
+    if (NULL == pbkt) {
+        return PMIX_SUCCESS;
+    }
+    ++seen_nblobs;
+    fold(&proc->rank, sizeof(proc->rank));
+    fold(pbkt->unpack_ptr, pbkt->bytes_used - (size_t) (pbkt->unpack_ptr - pbkt->base_ptr));
+    return PMIX_SUCCESS;
+}
+
+static pmix_status_t receive(pmix_buffer_t *in, pmix_server_trkr_t *trk, uint64_t *digest)
+{
+    pmix_buffer_t copy;
+    pmix_status_t rc;
+    char *bytes;
+
+    /* store_modex consumes what it reads, so give it a copy */
+    bytes = (char *) malloc(in->bytes_used);
+    memcpy(bytes, in->base_ptr, in->bytes_used);
+    PMIX_CONSTRUCT(&copy, pmix_buffer_t);
+    PMIX_LOAD_BUFFER(pmix_globals.mypeer, &copy, bytes, in->bytes_used);
+
+    seen_nblobs = 0;
+    seen_digest = 14695981039346656037ULL;
+    rc = pmix_gds_base_store_modex(&copy, NULL, seen_cb, trk);
+    *digest = seen_digest;
+    PMIX_DESTRUCT(&copy);
+    return rc;
+}
+
+static void test_threads_and_chunks(void)
+{
+    pmix_server_trkr_t *trk;
+    pmix_buffer_t whole1, whole4, chunk1, chunk4;
+    uint64_t dwhole, dchunk;
+    pmix_status_t rc;
+
+    fprintf(stdout, "\n-- threads and chunks --\n");
+
+    trk = mktracker();
+    PMIX_CONSTRUCT(&whole1, pmix_buffer_t);
+    PMIX_CONSTRUCT(&whole4, pmix_buffer_t);
+    PMIX_CONSTRUCT(&chunk1, pmix_buffer_t);
+    PMIX_CONSTRUCT(&chunk4, pmix_buffer_t);
+
+    report("a contribution is assembled on one thread",
+           PMIX_SUCCESS == collect(trk, 1, 0, &whole1));
+    report("and on four",
+           PMIX_SUCCESS == collect(trk, 4, 0, &whole4));
+    report("the threads change nothing on the wire", same_bytes(&whole1, &whole4));
+
+    report("a framed contribution is assembled on one thread",
+           PMIX_SUCCESS == collect(trk, 1, TEST_CHUNK, &chunk1));
+    report("and on four",
+           PMIX_SUCCESS == collect(trk, 4, TEST_CHUNK, &chunk4));
+    report("the same bytes however many threads compressed it",
+           same_bytes(&chunk1, &chunk4));
+    report("and they are not the whole form", !same_bytes(&whole1, &chunk4));
+
+    rc = receive(&whole1, trk, &dwhole);
+    report("the whole form is read back", PMIX_SUCCESS == rc);
+    report("with every rank in it", TEST_NRANKS == seen_nblobs);
+    pmix_server_globals.fence_threads = 1;
+    rc = receive(&chunk4, trk, &dchunk);
+    report("the framed form is read back on one thread", PMIX_SUCCESS == rc);
+    report("with every rank in it", TEST_NRANKS == seen_nblobs);
+    report("and the same data, rank by rank", dwhole == dchunk);
+    pmix_server_globals.fence_threads = 4;
+    rc = receive(&chunk4, trk, &dchunk);
+    report("and on four", PMIX_SUCCESS == rc);
+    report("with every rank in it", TEST_NRANKS == seen_nblobs);
+    report("and the same data, rank by rank", dwhole == dchunk);
+
+    PMIX_DESTRUCT(&whole1);
+    PMIX_DESTRUCT(&whole4);
+    PMIX_DESTRUCT(&chunk1);
+    PMIX_DESTRUCT(&chunk4);
+    PMIX_RELEASE(trk);
+}
+
+/* A framed contribution whose only frame stops partway through the
+ * first rank's data - its index is in order, so only the store can
+ * tell */
+static void test_cut_frame(void)
+{
+    pmix_server_trkr_t *trk = PMIX_NEW(pmix_server_trkr_t);
+    pmix_buffer_t bucket, server, out;
+    pmix_compress_frame_t frame;
+    pmix_byte_object_t bo, marker;
+    pmix_status_t rc;
+    uint8_t blob_info = PMIX_COLLECT_YES;
+    bool flag = true, built;
+    char piece[50];
+    uint64_t digest;
+
+    fprintf(stdout, "\n-- a frame cut short --\n");
+
+    trk->collect_type = PMIX_COLLECT_YES;
+    memset(piece, 0, sizeof(piece));
+    PMIX_CONSTRUCT(&bucket, pmix_buffer_t);
+    PMIX_CONSTRUCT(&server, pmix_buffer_t);
+    PMIX_CONSTRUCT(&out, pmix_buffer_t);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &bucket, &blob_info, 1, PMIX_BYTE);
+    bo.bytes = piece;
+    bo.size = sizeof(piece);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &bucket, &bo, 1, PMIX_BYTE_OBJECT);
+
+    /* stored as it is, less the tail of that object */
+    frame.bytes = (const uint8_t *) bucket.base_ptr;
+    frame.size = bucket.bytes_used - 10;
+    frame.packed = NULL;
+    frame.packed_size = 0;
+    built = pmix_compress_base_frames_build(&frame, 1, (uint8_t **) &bo.bytes, &bo.size);
+
+    /* the marker - compressed, over an empty object - then the container */
+    PMIX_BYTE_OBJECT_CONSTRUCT(&marker);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &server, &flag, 1, PMIX_BOOL);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &server, &marker, 1, PMIX_BYTE_OBJECT);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &server, &bo, 1, PMIX_BYTE_OBJECT);
+    free(bo.bytes);
+    PMIX_UNLOAD_BUFFER(&server, bo.bytes, bo.size);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, &out, &bo, 1, PMIX_BYTE_OBJECT);
+    PMIX_BYTE_OBJECT_DESTRUCT(&bo);
+    report("the test contribution is built", built && PMIX_SUCCESS == rc);
+
+    rc = receive(&out, trk, &digest);
+    report("it is refused", PMIX_SUCCESS != rc);
+    report("and nothing of it stored", 0 == seen_nblobs);
+
+    PMIX_DESTRUCT(&bucket);
+    PMIX_DESTRUCT(&server);
+    PMIX_DESTRUCT(&out);
+    PMIX_RELEASE(trk);
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_status_t rc;
+
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+#if PMIX_TESTBUILD
+    /* the compressors are non-functional shims in a --enable-test-build,
+     * so a framed contribution cannot be read back - as in compress.c */
+    fprintf(stdout, "SKIP: compression is stubbed in --enable-test-build\n");
+    return 77;
+#endif
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    /* a missing compressor is fine here - the pieces then travel as
+     * they are - so do not warn about it */
+    setenv("PMIX_MCA_pcompress_base_silence_warning", "1", 0);
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+    fprintf(stdout, "fence contribution assembly tests\n");
+
+    report("the job's data is stored", populate());
+    test_threads_and_chunks();
+    test_cut_frame();
+
+    fprintf(stdout, "SUMMARY: %d passed, %d failed\n", npass, nfail);
+    PMIx_server_finalize();
+    return (0 == nfail) ? 0 : 1;
+}
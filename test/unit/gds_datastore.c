@@ -38,6 +38,9 @@
  * That decision used to be made once for the whole job, which lost those
  * keys for every proc a host did not fully describe.
  *
+ * The shmem3 cases build a job's shared segment and read it back; one
+ * of them builds it with several threads, and checks the seams.
+ *
  * The base modex walker case pins the contract every component's
  * store_modex callback has to honor: it is called once per proc blob and
  * then once per involved nspace with a NULL buffer, and a callback that
@@ -1190,7 +1193,7 @@ static void test_realm_classifiers(void)
 /* ------------------------------------------------------------------ */
 
 /* Build a peer bound to a specific gds module, packable enough for
- * register_job_info() to write a reply into.
+ * register_job_info() to build a reply for.
  *
  * The wire format and role are borrowed from the local server's own
  * peer: nothing here is a real client, but pack_shmem3_connection_info()
@@ -1217,6 +1220,40 @@ static pmix_peer_t *mkgdspeer(const char *nspace, pmix_rank_t nprocs,
     return p;
 }
 
+/* Find the PMIX_GDS_SEGMENT_USAGE assembly for one kind of segment in a
+ * usage report, and read its size and used bytes out of it. */
+static bool usage_for(pmix_list_t *kvs, const char *kind, size_t *size, size_t *used)
+{
+    pmix_kval_t *kv;
+    pmix_info_t *iptr;
+    size_t n, nel;
+    bool mine;
+
+    PMIX_LIST_FOREACH (kv, kvs, pmix_kval_t) {
+        if (!PMIX_CHECK_KEY(kv, PMIX_GDS_SEGMENT_USAGE) || PMIX_DATA_ARRAY != kv->value->type
+            || PMIX_INFO != kv->value->data.darray->type) {
+            continue;
+        }
+        iptr = (pmix_info_t *) kv->value->data.darray->array;
+        nel = kv->value->data.darray->size;
+        mine = false;
+        *size = *used = 0;
+        for (n = 0; n < nel; n++) {
+            if (PMIX_CHECK_KEY(&iptr[n], PMIX_GDS_SEGMENT_KIND)) {
+                mine = (0 == strcmp(iptr[n].value.data.string, kind));
+            } else if (PMIX_CHECK_KEY(&iptr[n], PMIX_GDS_SEGMENT_SIZE)) {
+                *size = iptr[n].value.data.size;
+            } else if (PMIX_CHECK_KEY(&iptr[n], PMIX_GDS_SEGMENT_USED)) {
+                *used = iptr[n].value.data.size;
+            }
+        }
+        if (mine) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /* Drive the shmem3 module end to end: register a job, have it build its
  * shared segments, then read them back through its own fetch.
  *
@@ -1247,10 +1284,12 @@ static void test_shmem3_job_segment(void)
     pmix_nspace_t ns;
     pmix_status_t rc;
     pmix_peer_t *peer;
-    pmix_buffer_t reply;
+    pmix_buffer_t *reply;
     pmix_cb_t cb;
     pmix_proc_t proc;
     uint32_t nprocs = 2, sid = 11, univ = 4;
+    pmix_list_t usage;
+    size_t size, used;
     /* Bytes, not infos - and chosen so that reading element zero as a
      * pmix_info_t finds a key that MATCHES. PMIx_Check_key() stops at the
      * first differing byte, so an array of arbitrary bytes is read one
@@ -1311,15 +1350,17 @@ static void test_shmem3_job_segment(void)
 
     /* Building the segments happens here, on the first peer to ask. */
     peer = mkgdspeer("gds-shmem3-job", nprocs, mod);
-    PMIX_CONSTRUCT(&reply, pmix_buffer_t);
+    reply = NULL;
     PMIX_GDS_REGISTER_JOB_INFO(rc, peer, &reply);
     report("shmem3 registers job info and describes its segments",
-           PMIX_SUCCESS == rc && 0 < reply.bytes_used);
+           PMIX_SUCCESS == rc && NULL != reply && 0 < reply->bytes_used);
     if (PMIX_SUCCESS != rc) {
         fprintf(stdout, "        (register_job_info: %s)\n",
                 PMIx_Error_string(rc));
     }
-    PMIX_DESTRUCT(&reply);
+    if (NULL != reply) {
+        PMIX_RELEASE(reply);
+    }
 
     /* Read a plain job-level key back out of the segment we just built,
      * through shmem3's own fetch. */
@@ -1370,12 +1411,194 @@ static void test_shmem3_job_segment(void)
     cb.proc = NULL;
     PMIX_DESTRUCT(&cb);
 
+    /* What PMIX_QUERY_GDS_USAGE is built from: one assembly per segment
+     * this process has mapped, with figures that add up. */
+    PMIX_CONSTRUCT(&usage, pmix_list_t);
+    rc = pmix_gds_base_report_usage("gds-shmem3-job", &usage);
+    report("the segments are reported on", PMIX_SUCCESS == rc);
+    report("the job segment's usage fits inside it",
+           usage_for(&usage, "job", &size, &used) && 0 < used && used <= size);
+    report("and so does the session segment's",
+           usage_for(&usage, "session", &size, &used) && 0 < used && used <= size);
+    PMIX_LIST_DESTRUCT(&usage);
+
     /* Deregistering has to give the segments back - the tracker owns
      * their mappings, and the arena reservation goes with it. */
     PMIX_GDS_DEL_NSPACE(rc, "gds-shmem3-job");
     report("deregistering the nspace releases the segments",
            PMIX_SUCCESS == rc);
 
+    /* ...and then there is nothing left to report on, which is what
+     * sends a query on to the server rather than answering it here. */
+    PMIX_CONSTRUCT(&usage, pmix_list_t);
+    rc = pmix_gds_base_report_usage("gds-shmem3-job", &usage);
+    report("a released job is not reported on",
+           PMIX_ERR_NOT_FOUND == rc && 0 == pmix_list_get_size(&usage));
+    PMIX_LIST_DESTRUCT(&usage);
+
+    PMIX_RELEASE(peer);
+}
+
+/* Read one number for one rank back through a module's own fetch. */
+static bool fetch_u32_via(pmix_peer_t *peer, const char *nspace, pmix_rank_t rank,
+                          const char *key, uint32_t *out)
+{
+    pmix_cb_t cb;
+    pmix_proc_t proc;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    bool found = false;
+
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    PMIX_LOAD_PROCID(&proc, nspace, rank);
+    cb.proc = &proc;
+    cb.key = (char *) key;
+    cb.copy = true;
+    cb.scope = PMIX_SCOPE_UNDEF;
+    PMIX_GDS_FETCH_KV(rc, peer, &cb);
+    kv = (pmix_kval_t *) pmix_list_get_first(&cb.kvs);
+    if (PMIX_SUCCESS == rc && NULL != kv && NULL != kv->value) {
+        found = (PMIX_SUCCESS == PMIx_Value_get_number(kv->value, out, PMIX_UINT32));
+    }
+    cb.key = NULL;
+    cb.proc = NULL;
+    PMIX_DESTRUCT(&cb);
+    return found;
+}
+
+/* A job big enough that shmem3 builds its segment with several threads
+ * (main() asks for four), read back rank by rank.
+ *
+ * The ranks are shared out in ranges, each thread copying into its own
+ * part of the segment, so what is pinned is everything that division
+ * could get wrong: the ranks at the edges of the ranges, a key only one
+ * rank has (no worker may register it - it is stored after them), a
+ * rank described twice (its later array still wins), and that the
+ * segment the dry run sized is big enough for the chunks the threads
+ * took - short is an abort, not a failure. */
+#define PARALLEL_NPROCS 1024
+static void test_shmem3_parallel_population(void)
+{
+    const char *nspace = "gds-shmem3-par";
+    pmix_gds_base_module_t *mod;
+    pmix_info_t *info, *pdata, dir;
+    pmix_data_array_t *array;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    pmix_peer_t *peer;
+    pmix_buffer_t *reply;
+    pmix_list_t usage;
+    char *noderegex = NULL, *ppnregex = NULL, *ppnstr, **agg = NULL;
+    char rankstr[64];
+    size_t ninfo, n, size, used;
+    uint32_t nprocs = PARALLEL_NPROCS, val, tag;
+    pmix_rank_t edges[] = {0, 1, 255, 256, 511, 512, 767, 768, PARALLEL_NPROCS - 1};
+    bool allok;
+    int m;
+
+    fprintf(stdout, "\n-- shmem3 parallel population --\n");
+
+    PMIX_INFO_LOAD(&dir, PMIX_GDS_MODULE, "shmem3", PMIX_STRING);
+    mod = pmix_gds_base_assign_module(&dir, 1);
+    PMIX_INFO_DESTRUCT(&dir);
+    if (NULL == mod || 0 != strcmp(mod->name, "shmem3")) {
+        fprintf(stdout, "    SKIP  shmem3 is not available in this build\n");
+        return;
+    }
+
+    for (m = 0; m < PARALLEL_NPROCS; m++) {
+        snprintf(rankstr, sizeof(rankstr), "%d", m);
+        PMIx_Argv_append_nosize(&agg, rankstr);
+    }
+    ppnstr = PMIx_Argv_join(agg, ',');
+    PMIx_Argv_free(agg);
+    PMIx_generate_regex(pmix_globals.hostname, &noderegex);
+    PMIx_generate_ppn(ppnstr, &ppnregex);
+    free(ppnstr);
+
+    /* the maps, one array per rank, and a second array for rank 300 */
+    ninfo = 3 + PARALLEL_NPROCS + 1;
+    PMIX_INFO_CREATE(info, ninfo);
+    PMIX_INFO_LOAD(&info[0], PMIX_NODE_MAP, noderegex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[1], PMIX_PROC_MAP, ppnregex, PMIX_REGEX);
+    PMIX_INFO_LOAD(&info[2], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    free(noderegex);
+    free(ppnregex);
+    for (n = 3, m = 0; m <= PARALLEL_NPROCS; m++, n++) {
+        const pmix_rank_t rank = (PARALLEL_NPROCS == m) ? 300 : (pmix_rank_t) m;
+        const bool extra = (700 == m);
+
+        PMIX_LOAD_KEY(info[n].key, PMIX_PROC_INFO_ARRAY);
+        info[n].value.type = PMIX_DATA_ARRAY;
+        PMIX_DATA_ARRAY_CREATE(array, extra ? 3 : 2, PMIX_INFO);
+        info[n].value.data.darray = array;
+        pdata = (pmix_info_t *) array->array;
+        /* not always first: the id may sit anywhere in the array */
+        tag = (PARALLEL_NPROCS == m) ? 99999 : 7 * rank;
+        PMIX_INFO_LOAD(&pdata[0], "gds.test.tag", &tag, PMIX_UINT32);
+        PMIX_INFO_LOAD(&pdata[1], PMIX_RANK, &rank, PMIX_PROC_RANK);
+        if (extra) {
+            PMIX_INFO_LOAD(&pdata[2], "gds.test.late", &tag, PMIX_UINT32);
+        }
+    }
+
+    PMIX_LOAD_NSPACE(ns, nspace);
+    rc = PMIx_server_register_nspace(ns, nprocs, info, ninfo, NULL, NULL);
+    PMIX_INFO_FREE(info, ninfo);
+    report("a job of a thousand ranks registers", registered(rc));
+    if (!registered(rc)) {
+        fprintf(stdout, "        (register_nspace: %s)\n", PMIx_Error_string(rc));
+        return;
+    }
+
+    peer = mkgdspeer(nspace, nprocs, mod);
+    reply = NULL;
+    PMIX_GDS_REGISTER_JOB_INFO(rc, peer, &reply);
+    report("and its segment is built", PMIX_SUCCESS == rc);
+    if (NULL != reply) {
+        PMIX_RELEASE(reply);
+    }
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stdout, "        (register_job_info: %s)\n", PMIx_Error_string(rc));
+        PMIX_RELEASE(peer);
+        return;
+    }
+
+    allok = true;
+    for (n = 0; n < sizeof(edges) / sizeof(edges[0]); n++) {
+        if (!fetch_u32_via(peer, nspace, edges[n], "gds.test.tag", &val)
+            || val != 7 * edges[n]) {
+            fprintf(stdout, "        (rank %u: tag missing or wrong)\n", edges[n]);
+            allok = false;
+        }
+    }
+    report("the ranks either side of every range read back", allok);
+
+    allok = true;
+    for (m = 0; m < PARALLEL_NPROCS && allok; m++) {
+        if (300 == m) {
+            continue;
+        }
+        allok = fetch_u32_via(peer, nspace, (pmix_rank_t) m, "gds.test.tag", &val)
+                && val == 7 * (uint32_t) m;
+    }
+    report("and so does every other rank", allok);
+
+    report("a rank described twice keeps its later value",
+           fetch_u32_via(peer, nspace, 300, "gds.test.tag", &val) && 99999 == val);
+    report("a key only one rank has is stored for it",
+           fetch_u32_via(peer, nspace, 700, "gds.test.late", &val) && 7 * 700 == val);
+    report("and for no other",
+           !fetch_u32_via(peer, nspace, 701, "gds.test.late", &val));
+
+    PMIX_CONSTRUCT(&usage, pmix_list_t);
+    rc = pmix_gds_base_report_usage(nspace, &usage);
+    report("what the threads used fits the segment the dry run sized",
+           PMIX_SUCCESS == rc && usage_for(&usage, "job", &size, &used)
+               && 0 < used && used <= size);
+    PMIX_LIST_DESTRUCT(&usage);
+
+    PMIX_GDS_DEL_NSPACE(rc, nspace);
     PMIX_RELEASE(peer);
 }
 
@@ -1388,6 +1611,10 @@ int main(int argc, char **argv)
      * several of these crash rather than fail against an unfixed library */
     setvbuf(stdout, NULL, _IOLBF, 0);
 
+    /* enough threads for test_shmem3_parallel_population() to share a
+     * big job's segment out; the small jobs elsewhere stay single */
+    setenv("PMIX_MCA_gds_shmem3_populate_threads", "4", 0);
+
     rc = PMIx_server_init(&mymodule, NULL, 0);
     if (PMIX_SUCCESS != rc) {
         fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
@@ -1406,6 +1633,7 @@ int main(int argc, char **argv)
     test_scope_routing();
     test_realm_classifiers();
     test_shmem3_job_segment();
+    test_shmem3_parallel_population();
 
     fprintf(stdout, "\n=== %d passed, %d failed ===\n", npass, nfail);
 
@@ -0,0 +1,402 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Fetches from gds/hash on application threads while the progress thread
+ * rewrites the store.
+ *
+ * gds/hash now declares itself is_tsafe, which is what lets
+ * try_local_fetch() in src/client/pmix_client_get.c answer a get without
+ * the thread-shift. That claim rests entirely on the component lock taken
+ * by each module entry point: fetch for reading, everything that changes
+ * the job trackers, their tables or the session list for writing. This
+ * drives exactly that overlap, through the module table as the client
+ * does:
+ *
+ *   - several reader threads fetch per-rank and job-level keys of a job
+ *     that stays registered throughout, and check every answer,
+ *   - meanwhile main() registers and deregisters a stream of other jobs,
+ *     each of which creates, fills and tears down a tracker on the
+ *     progress thread - list insertion and removal, table growth, and
+ *     new keys entering the key index,
+ *   - the readers also fetch from the churning jobs, so they hit trackers
+ *     that are being built and released under them.
+ *
+ * A second phase has the readers all ask, at once, for session info of
+ * a job that was never bound to a session, naming the session by ID.
+ * The lookup that finds it runs under the read lock, so it must not
+ * bind the job to the session it found as a side effect - several
+ * readers doing that at once raced on the tracker and leaked a
+ * reference each. Every answer must be right, and afterwards the job
+ * must still be unbound: asked without a session ID, it answers as it
+ * did before.
+ *
+ * Without the lock this is a use-after-free waiting to happen, and shows
+ * up as a crash, a wrong answer, or a report from a thread sanitizer.
+ * With it, every answer from the stable job is right, and an answer from
+ * a churning job is either right or "no such namespace". The test cannot
+ * prove the absence of a race; run it under -fsanitize=thread for that.
+ *
+ * PMIX_MCA_gds is pinned to "hash" so the server's own store - which is
+ * what is fetched from - is the module under test.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/mca/gds/base/base.h"
+#include "src/mca/gds/gds.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define GHR_STABLE   "gds-hash-readers-stable"
+#define GHR_CHURN    "gds-hash-readers-churn"
+#define GHR_NPROCS   16
+#define GHR_NCHURN   4
+#define GHR_ROUNDS   50
+#define GHR_NREADERS 4
+#define GHR_BASE     5000
+/* the job that owns a session, and that session */
+#define GHR_OWNER    "gds-hash-readers-owner"
+#define GHR_SID      7
+#define GHR_UNIV     64
+#define GHR_SFETCHES 2000
+
+static int npass = 0;
+static int nfail = 0;
+
+static volatile int stop = 0;
+
+typedef struct {
+    pthread_t tid;
+    int id;
+    unsigned long nfetch;
+    unsigned long nwrong;
+} reader_t;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static pmix_status_t register_job(const char *name)
+{
+    pmix_info_t *info, *pdata;
+    pmix_data_array_t *array;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    pmix_rank_t arank;
+    uint32_t nprocs = GHR_NPROCS;
+    size_t ninfo, n;
+
+    ninfo = 1 + GHR_NPROCS;
+    PMIX_INFO_CREATE(info, ninfo);
+    PMIX_INFO_LOAD(&info[0], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    for (n = 0; n < GHR_NPROCS; n++) {
+        PMIX_LOAD_KEY(info[n + 1].key, PMIX_PROC_INFO_ARRAY);
+        info[n + 1].value.type = PMIX_DATA_ARRAY;
+        PMIX_DATA_ARRAY_CREATE(array, 2, PMIX_INFO);
+        info[n + 1].value.data.darray = array;
+        pdata = (pmix_info_t *) array->array;
+        PMIX_LOAD_KEY(pdata[0].key, PMIX_RANK);
+        pdata[0].value.type = PMIX_PROC_RANK;
+        pdata[0].value.data.rank = (pmix_rank_t) n;
+        arank = GHR_BASE + (pmix_rank_t) n;
+        PMIX_INFO_LOAD(&pdata[1], PMIX_APP_RANK, &arank, PMIX_PROC_RANK);
+    }
+
+    PMIX_LOAD_NSPACE(ns, name);
+    rc = PMIx_server_register_nspace(ns, 0, info, ninfo, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_FREE(info, ninfo);
+    return rc;
+}
+
+/* a job bound to session GHR_SID, which puts GHR_UNIV in that
+ * session's info */
+static pmix_status_t register_owner(void)
+{
+    pmix_info_t info[3];
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    uint32_t sid = GHR_SID, univ = GHR_UNIV, nprocs = 1;
+
+    PMIX_INFO_LOAD(&info[0], PMIX_SESSION_ID, &sid, PMIX_UINT32);
+    PMIX_INFO_LOAD(&info[1], PMIX_UNIV_SIZE, &univ, PMIX_UINT32);
+    PMIX_INFO_LOAD(&info[2], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    PMIX_LOAD_NSPACE(ns, GHR_OWNER);
+    rc = PMIx_server_register_nspace(ns, 1, info, 3, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_DESTRUCT(&info[0]);
+    PMIX_INFO_DESTRUCT(&info[1]);
+    PMIX_INFO_DESTRUCT(&info[2]);
+    return rc;
+}
+
+/* One fetch through the module table, as try_local_fetch() makes it,
+ * with whatever qualifiers are given. Returns the fetch status; *val is
+ * the number found, if any. */
+static pmix_status_t fetch_qualified(const char *nspace, pmix_rank_t rank, const char *key,
+                                     pmix_info_t *qual, size_t nqual, uint32_t *val)
+{
+    pmix_cb_t cb;
+    pmix_proc_t proc;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+
+    PMIX_CONSTRUCT(&cb, pmix_cb_t);
+    PMIX_LOAD_PROCID(&proc, nspace, rank);
+    cb.proc = &proc;
+    cb.key = (char *) key;
+    cb.copy = true;
+    cb.scope = PMIX_SCOPE_UNDEF;
+    cb.info = qual;
+    cb.ninfo = nqual;
+    PMIX_GDS_FETCH_KV(rc, pmix_globals.mypeer, &cb);
+    if (PMIX_SUCCESS == rc) {
+        kv = (pmix_kval_t *) pmix_list_get_first(&cb.kvs);
+        if (NULL == kv || NULL == kv->value ||
+            PMIX_SUCCESS != PMIx_Value_get_number(kv->value, val, PMIX_UINT32)) {
+            rc = PMIX_ERR_BAD_PARAM;
+        }
+    }
+    cb.key = NULL;
+    cb.proc = NULL;
+    cb.info = NULL;
+    cb.ninfo = 0;
+    PMIX_DESTRUCT(&cb);
+    return rc;
+}
+
+static pmix_status_t fetch_number(const char *nspace, pmix_rank_t rank,
+                                  const char *key, uint32_t *val)
+{
+    return fetch_qualified(nspace, rank, key, NULL, 0, val);
+}
+
+/* GHR_UNIV asked of "nspace" as session info - of session GHR_SID if
+ * "named", else of whichever session the job is bound to */
+static pmix_status_t fetch_univ(const char *nspace, bool named, uint32_t *val)
+{
+    pmix_info_t qual[2];
+    pmix_status_t rc;
+    uint32_t sid = GHR_SID;
+    bool flag = true;
+
+    PMIX_INFO_LOAD(&qual[0], PMIX_SESSION_INFO, &flag, PMIX_BOOL);
+    PMIX_INFO_LOAD(&qual[1], PMIX_SESSION_ID, &sid, PMIX_UINT32);
+    rc = fetch_qualified(nspace, PMIX_RANK_WILDCARD, PMIX_UNIV_SIZE, qual, named ? 2 : 1, val);
+    PMIX_INFO_DESTRUCT(&qual[0]);
+    PMIX_INFO_DESTRUCT(&qual[1]);
+    return rc;
+}
+
+/* Every reader asks the stable job - never bound to a session - for
+ * session GHR_SID's info at the same time */
+static void *session_reader(void *arg)
+{
+    reader_t *me = (reader_t *) arg;
+    pmix_status_t rc;
+    uint32_t val;
+    int n;
+
+    for (n = 0; n < GHR_SFETCHES; n++) {
+        val = 0;
+        rc = fetch_univ(GHR_STABLE, true, &val);
+        if (PMIX_SUCCESS != rc || GHR_UNIV != val) {
+            ++me->nwrong;
+        }
+        me->nfetch++;
+    }
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    reader_t *me = (reader_t *) arg;
+    char churn[PMIX_MAX_NSLEN + 1];
+    pmix_rank_t rank;
+    pmix_status_t rc;
+    uint32_t val;
+    int n = 0;
+
+    while (!stop) {
+        rank = (pmix_rank_t) ((me->id + n) % GHR_NPROCS);
+
+        /* the stable job: always present, always right */
+        val = 0;
+        rc = fetch_number(GHR_STABLE, rank, PMIX_APP_RANK, &val);
+        if (PMIX_SUCCESS != rc || GHR_BASE + rank != val) {
+            ++me->nwrong;
+        }
+        val = 0;
+        rc = fetch_number(GHR_STABLE, PMIX_RANK_WILDCARD, PMIX_JOB_SIZE, &val);
+        if (PMIX_SUCCESS != rc || GHR_NPROCS != val) {
+            ++me->nwrong;
+        }
+
+        /* a churning job: there or not, but never wrong */
+        snprintf(churn, sizeof(churn), "%s-%d", GHR_CHURN, n % GHR_NCHURN);
+        val = 0;
+        rc = fetch_number(churn, rank, PMIX_APP_RANK, &val);
+        if (PMIX_SUCCESS == rc && GHR_BASE + rank != val) {
+            ++me->nwrong;
+        }
+
+        me->nfetch += 3;
+        ++n;
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    reader_t readers[GHR_NREADERS];
+    char name[PMIX_MAX_NSLEN + 1];
+    pmix_gds_base_module_t *mod;
+    pmix_info_t info;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    unsigned long nfetch = 0, nwrong = 0;
+    int n, m, nstarted = 0;
+    bool churned = true;
+
+    (void) argc;
+    (void) argv;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fprintf(stdout, "gds_hash_readers: concurrent gds/hash fetch unit tests\n");
+
+    setenv("PMIX_MCA_gds", "hash", 1);
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    PMIX_INFO_LOAD(&info, PMIX_GDS_MODULE, "hash", PMIX_STRING);
+    mod = pmix_gds_base_assign_module(&info, 1);
+    PMIX_INFO_DESTRUCT(&info);
+    report("gds/hash is selected", NULL != mod && 0 == strcmp(mod->name, "hash"));
+    report("gds/hash declares its fetch thread-safe", NULL != mod && mod->is_tsafe);
+    report("our own store is gds/hash",
+           PMIX_GDS_CHECK_COMPONENT(pmix_globals.mypeer, "hash"));
+
+    rc = register_job(GHR_STABLE);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "register failed: %s\n", PMIx_Error_string(rc));
+        PMIx_server_finalize();
+        return 1;
+    }
+
+    for (n = 0; n < GHR_NREADERS; n++) {
+        memset(&readers[n], 0, sizeof(reader_t));
+        readers[n].id = n;
+        if (0 != pthread_create(&readers[n].tid, NULL, reader, &readers[n])) {
+            break;
+        }
+        ++nstarted;
+    }
+    report("reader threads started", GHR_NREADERS == nstarted);
+
+    /* rewrite the store under them */
+    for (m = 0; m < GHR_ROUNDS; m++) {
+        for (n = 0; n < GHR_NCHURN; n++) {
+            snprintf(name, sizeof(name), "%s-%d", GHR_CHURN, n);
+            if (PMIX_SUCCESS != register_job(name)) {
+                churned = false;
+            }
+        }
+        for (n = 0; n < GHR_NCHURN; n++) {
+            snprintf(name, sizeof(name), "%s-%d", GHR_CHURN, n);
+            PMIX_LOAD_NSPACE(ns, name);
+            PMIx_server_deregister_nspace(ns, NULL, NULL);
+        }
+    }
+    report("churning jobs registered every round", churned);
+
+    stop = 1;
+    for (n = 0; n < nstarted; n++) {
+        pthread_join(readers[n].tid, NULL);
+        nfetch += readers[n].nfetch;
+        nwrong += readers[n].nwrong;
+    }
+    fprintf(stdout, "        (%lu fetches across %d threads)\n", nfetch, nstarted);
+    report("readers made progress while the store changed", 0 < nfetch);
+    report("every answer was right", 0 == nwrong);
+    if (0 != nwrong) {
+        fprintf(stdout, "        (%lu wrong answers)\n", nwrong);
+    }
+
+    /* and the store is still intact afterwards */
+    {
+        uint32_t val = 0;
+        rc = fetch_number(GHR_STABLE, 3, PMIX_APP_RANK, &val);
+        report("stable job still answers", PMIX_SUCCESS == rc && GHR_BASE + 3 == val);
+    }
+
+    /* session-qualified fetches, all at once, of a job with no session */
+    {
+        pmix_status_t before, after;
+        uint32_t bval = 0, aval = 0;
+
+        rc = register_owner();
+        report("session owner registered", PMIX_SUCCESS == rc);
+        before = fetch_univ(GHR_STABLE, false, &bval);
+        nfetch = 0;
+        nwrong = 0;
+        nstarted = 0;
+        for (n = 0; n < GHR_NREADERS; n++) {
+            memset(&readers[n], 0, sizeof(reader_t));
+            readers[n].id = n;
+            if (0 != pthread_create(&readers[n].tid, NULL, session_reader, &readers[n])) {
+                break;
+            }
+            ++nstarted;
+        }
+        for (n = 0; n < nstarted; n++) {
+            pthread_join(readers[n].tid, NULL);
+            nfetch += readers[n].nfetch;
+            nwrong += readers[n].nwrong;
+        }
+        report("session readers started", GHR_NREADERS == nstarted);
+        report("every session-qualified answer was right", 0 < nfetch && 0 == nwrong);
+        if (0 != nwrong) {
+            fprintf(stdout, "        (%lu wrong answers of %lu)\n", nwrong, nfetch);
+        }
+        after = fetch_univ(GHR_STABLE, false, &aval);
+        report("a session-qualified fetch does not bind the job to the session",
+               before == after && bval == aval);
+        PMIX_LOAD_NSPACE(ns, GHR_OWNER);
+        PMIx_server_deregister_nspace(ns, NULL, NULL);
+    }
+
+    PMIX_LOAD_NSPACE(ns, GHR_STABLE);
+    PMIx_server_deregister_nspace(ns, NULL, NULL);
+    PMIx_server_finalize();
+
+    fprintf(stdout, "gds_hash_readers: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
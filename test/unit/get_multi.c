@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for PMIx_Get_multi - one key, many ranks, one result array.
+ *
+ * The process comes up as a PMIx server and registers a job whose
+ * PMIX_PROC_INFO_ARRAY entries give every rank but the last a distinct
+ * PMIX_APP_RANK. A server resolves a get against its own datastore and,
+ * having nobody to ask, refuses a miss rather than sending it, so every
+ * outcome here is deterministic: the described ranks are found, the
+ * undescribed one is not.
+ *
+ * What is under test is the bookkeeping around the batch rather than the
+ * lookup itself, which is the same get_data() a PMIx_Get runs:
+ *
+ *   - each slot of the result carries the answer for the rank at the same
+ *     index of the request, including when ranks repeat,
+ *   - a slot that could not be filled is PMIX_UNDEF and the call says
+ *     PMIX_ERR_PARTIAL_SUCCESS, rather than failing the whole batch,
+ *   - nothing found means an error and no array at all,
+ *   - the answer matches what PMIx_Get returns for the same rank.
+ *
+ * Test cases:
+ *
+ *   every described rank               -> PMIX_SUCCESS, values in order
+ *   ranks reversed and repeated        -> PMIX_SUCCESS, values follow ranks
+ *   described ranks + undescribed one  -> PMIX_ERR_PARTIAL_SUCCESS, UNDEF slot
+ *   undescribed rank only              -> PMIX_ERR_NOT_FOUND, NULL array
+ *   NULL nspace                        -> resolves against our own nspace
+ *   NULL key / ranks / count / result  -> PMIX_ERR_BAD_PARAM
+ *   PMIX_GET_STATIC_VALUES             -> PMIX_ERR_NOT_SUPPORTED
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define GMUT_NSPACE    "get-multi-ut"
+#define GMUT_NPROCS    8
+/* the last rank is deliberately left undescribed */
+#define GMUT_NDESCRIBED (GMUT_NPROCS - 1)
+#define GMUT_BASE      1000
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static pmix_status_t register_job(void)
+{
+    pmix_info_t *info, *pdata;
+    pmix_data_array_t *array;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    pmix_rank_t arank;
+    uint32_t nprocs = GMUT_NPROCS;
+    size_t ninfo, n;
+
+    ninfo = 1 + GMUT_NDESCRIBED;
+    PMIX_INFO_CREATE(info, ninfo);
+    PMIX_INFO_LOAD(&info[0], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    for (n = 0; n < GMUT_NDESCRIBED; n++) {
+        PMIX_LOAD_KEY(info[n + 1].key, PMIX_PROC_INFO_ARRAY);
+        info[n + 1].value.type = PMIX_DATA_ARRAY;
+        PMIX_DATA_ARRAY_CREATE(array, 2, PMIX_INFO);
+        info[n + 1].value.data.darray = array;
+        pdata = (pmix_info_t *) array->array;
+        PMIX_LOAD_KEY(pdata[0].key, PMIX_RANK);
+        pdata[0].value.type = PMIX_PROC_RANK;
+        pdata[0].value.data.rank = (pmix_rank_t) n;
+        arank = GMUT_BASE + (pmix_rank_t) n;
+        PMIX_INFO_LOAD(&pdata[1], PMIX_APP_RANK, &arank, PMIX_PROC_RANK);
+    }
+
+    PMIX_LOAD_NSPACE(ns, GMUT_NSPACE);
+    rc = PMIx_server_register_nspace(ns, 0, info, ninfo, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_FREE(info, ninfo);
+    return rc;
+}
+
+/* true if every slot holds the PMIX_APP_RANK registered for its rank */
+static bool check_values(const pmix_value_t *vals, const pmix_rank_t *ranks, size_t n)
+{
+    size_t m;
+
+    for (m = 0; m < n; m++) {
+        if (PMIX_PROC_RANK != vals[m].type ||
+            GMUT_BASE + ranks[m] != vals[m].data.rank) {
+            fprintf(stdout, "        (slot %lu for rank %u: type %s)\n",
+                    (unsigned long) m, ranks[m], PMIx_Data_type_string(vals[m].type));
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_rank_t ranks[GMUT_NPROCS + 4];
+    pmix_value_t *vals, *val;
+    pmix_nspace_t ns;
+    pmix_proc_t proc;
+    pmix_info_t info;
+    pmix_status_t rc;
+    size_t n;
+    bool ok;
+
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "get_multi: PMIx_Get_multi unit tests\n");
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+    rc = register_job();
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "register failed: %s\n", PMIx_Error_string(rc));
+        PMIx_server_finalize();
+        return 1;
+    }
+    PMIX_LOAD_NSPACE(ns, GMUT_NSPACE);
+
+    /* --- every described rank ---------------------------------------- */
+    for (n = 0; n < GMUT_NDESCRIBED; n++) {
+        ranks[n] = (pmix_rank_t) n;
+    }
+    vals = NULL;
+    rc = PMIx_Get_multi(ns, ranks, GMUT_NDESCRIBED, PMIX_APP_RANK, NULL, 0, &vals);
+    report("all described ranks: PMIX_SUCCESS", PMIX_SUCCESS == rc);
+    report("all described ranks: values in request order",
+           NULL != vals && check_values(vals, ranks, GMUT_NDESCRIBED));
+
+    /* the same answer PMIx_Get gives, one rank at a time */
+    ok = (NULL != vals);
+    for (n = 0; ok && n < GMUT_NDESCRIBED; n++) {
+        PMIX_LOAD_PROCID(&proc, GMUT_NSPACE, ranks[n]);
+        val = NULL;
+        rc = PMIx_Get(&proc, PMIX_APP_RANK, NULL, 0, &val);
+        ok = (PMIX_SUCCESS == rc && NULL != val &&
+              PMIX_EQUAL == PMIx_Value_compare(val, &vals[n]));
+        if (NULL != val) {
+            PMIX_VALUE_RELEASE(val);
+        }
+    }
+    report("all described ranks: matches PMIx_Get per rank", ok);
+    if (NULL != vals) {
+        PMIX_VALUE_FREE(vals, GMUT_NDESCRIBED);
+    }
+
+    /* --- ranks reversed, with repeats -------------------------------- */
+    for (n = 0; n < GMUT_NDESCRIBED; n++) {
+        ranks[n] = (pmix_rank_t) (GMUT_NDESCRIBED - 1 - n);
+    }
+    ranks[GMUT_NDESCRIBED] = 0;
+    ranks[GMUT_NDESCRIBED + 1] = 0;
+    ranks[GMUT_NDESCRIBED + 2] = 3;
+    vals = NULL;
+    rc = PMIx_Get_multi(ns, ranks, GMUT_NDESCRIBED + 3, PMIX_APP_RANK, NULL, 0, &vals);
+    report("reversed and repeated: PMIX_SUCCESS", PMIX_SUCCESS == rc);
+    report("reversed and repeated: each slot follows its rank",
+           NULL != vals && check_values(vals, ranks, GMUT_NDESCRIBED + 3));
+    if (NULL != vals) {
+        PMIX_VALUE_FREE(vals, GMUT_NDESCRIBED + 3);
+    }
+
+    /* --- a miss among hits ------------------------------------------- */
+    ranks[0] = 0;
+    ranks[1] = GMUT_NPROCS - 1;
+    ranks[2] = 2;
+    vals = NULL;
+    rc = PMIx_Get_multi(ns, ranks, 3, PMIX_APP_RANK, NULL, 0, &vals);
+    report("one miss: PMIX_ERR_PARTIAL_SUCCESS", PMIX_ERR_PARTIAL_SUCCESS == rc);
+    report("one miss: the missing slot is PMIX_UNDEF",
+           NULL != vals && PMIX_UNDEF == vals[1].type);
+    report("one miss: the found slots are intact",
+           NULL != vals && check_values(&vals[0], &ranks[0], 1) &&
+           check_values(&vals[2], &ranks[2], 1));
+    if (NULL != vals) {
+        PMIX_VALUE_FREE(vals, 3);
+    }
+
+    /* --- nothing found ----------------------------------------------- */
+    ranks[0] = GMUT_NPROCS - 1;
+    vals = NULL;
+    rc = PMIx_Get_multi(ns, ranks, 1, PMIX_APP_RANK, NULL, 0, &vals);
+    report("all missing: PMIX_ERR_NOT_FOUND", PMIX_ERR_NOT_FOUND == rc);
+    report("all missing: no array returned", NULL == vals);
+
+    /* --- NULL nspace means our own ----------------------------------- */
+    ranks[0] = pmix_globals.myid.rank;
+    vals = NULL;
+    rc = PMIx_Get_multi(NULL, ranks, 1, "get.multi.ut.never.put", NULL, 0, &vals);
+    report("NULL nspace: unknown key in our own nspace is not found",
+           PMIX_ERR_NOT_FOUND == rc && NULL == vals);
+
+    /* --- parameter validation ---------------------------------------- */
+    ranks[0] = 0;
+    vals = NULL;
+    report("NULL key rejected",
+           PMIX_ERR_BAD_PARAM == PMIx_Get_multi(ns, ranks, 1, NULL, NULL, 0, &vals));
+    report("NULL ranks rejected",
+           PMIX_ERR_BAD_PARAM == PMIx_Get_multi(ns, NULL, 1, PMIX_APP_RANK, NULL, 0, &vals));
+    report("zero ranks rejected",
+           PMIX_ERR_BAD_PARAM == PMIx_Get_multi(ns, ranks, 0, PMIX_APP_RANK, NULL, 0, &vals));
+    report("NULL result rejected",
+           PMIX_ERR_BAD_PARAM == PMIx_Get_multi(ns, ranks, 1, PMIX_APP_RANK, NULL, 0, NULL));
+    PMIX_INFO_LOAD(&info, PMIX_GET_STATIC_VALUES, NULL, PMIX_BOOL);
+    report("PMIX_GET_STATIC_VALUES not supported",
+           PMIX_ERR_NOT_SUPPORTED == PMIx_Get_multi(ns, ranks, 1, PMIX_APP_RANK,
+                                                    &info, 1, &vals));
+    PMIX_INFO_DESTRUCT(&info);
+    report("rejected calls leave no array", NULL == vals);
+
+    PMIx_server_deregister_nspace(ns, NULL, NULL);
+    PMIx_server_finalize();
+
+    fprintf(stdout, "get_multi: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
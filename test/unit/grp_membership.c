@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the group membership sets and the membership union in
+ * src/server/pmix_server_grpset.c, which pmix_server_group.c builds a
+ * group's members, arrivals and departures out of.
+ *
+ * Test cases:
+ *
+ *   sets:      a rank named is a member, a rank or nspace not named is
+ *              not, and ranks past PMIX_GRP_RANK_BITS are kept too
+ *   wildcard:  a WILDCARD entry names the whole nspace, and a WILDCARD
+ *              asked about matches anything of its nspace
+ *   add_procs: every proc of the array goes in, repeats and all
+ *   union:     procs are kept in the order first seen, with repeats
+ *              dropped across and within arrays
+ *   union:     a WILDCARD for a nspace already present widens that
+ *              nspace's first entry - in the base or in what was added -
+ *              rather than adding another, and later ranks of that
+ *              nspace are dropped as covered
+ *   departure: a proc that is not a member, or has already arrived, is
+ *              ignored; a member that has not is new once, then known
+ *   large:     four participants naming the same 100k-proc group in
+ *              different orders merge in seconds at most, into one
+ *              nspace entry whose bitmap is a few KB
+ */
+
+#include "src/include/pmix_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "include/pmix_server.h"
+#include "src/include/pmix_globals.h"
+#include "src/server/pmix_server_ops.h"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static bool has(pmix_grp_mbrset_t *set, const char *nspace, pmix_rank_t rank)
+{
+    pmix_proc_t proc;
+
+    PMIX_LOAD_PROCID(&proc, nspace, rank);
+    return pmix_grp_mbrset_has(set, &proc);
+}
+
+static bool proc_is(const pmix_proc_t *proc, const char *nspace, pmix_rank_t rank)
+{
+    return PMIX_CHECK_NSPACE(proc->nspace, nspace) && proc->rank == rank;
+}
+
+static double now(void)
+{
+    struct timespec tp;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+    return (double) tp.tv_sec + (double) tp.tv_nsec / 1.0e9;
+}
+
+/* ------------------------------------------------------------------ */
+
+static void test_sets(void)
+{
+    pmix_grp_mbrset_t set;
+    pmix_proc_t proc;
+
+    PMIX_CONSTRUCT(&set, pmix_grp_mbrset_t);
+    PMIX_LOAD_PROCID(&proc, "gm.a", 3);
+    pmix_grp_mbrset_add(&set, &proc, 0);
+    PMIX_LOAD_PROCID(&proc, "gm.a", 70000);
+    pmix_grp_mbrset_add(&set, &proc, 1);
+    PMIX_LOAD_PROCID(&proc, "gm.a", PMIX_GRP_RANK_BITS + 5);
+    pmix_grp_mbrset_add(&set, &proc, 2);
+
+    report("sets: named rank is a member", has(&set, "gm.a", 3) && has(&set, "gm.a", 70000));
+    report("sets: unnamed rank is not", !has(&set, "gm.a", 4) && !has(&set, "gm.a", 0));
+    report("sets: other nspace is not", !has(&set, "gm.b", 3));
+    report("sets: rank past the bitmap kept",
+           has(&set, "gm.a", PMIX_GRP_RANK_BITS + 5) && !has(&set, "gm.a", PMIX_GRP_RANK_BITS + 6));
+    report("sets: one entry for the nspace", 1 == pmix_list_get_size(&set.nspaces));
+    PMIX_DESTRUCT(&set);
+}
+
+static void test_wildcard(void)
+{
+    pmix_grp_mbrset_t set;
+    pmix_proc_t proc;
+
+    PMIX_CONSTRUCT(&set, pmix_grp_mbrset_t);
+    PMIX_LOAD_PROCID(&proc, "gm.w", PMIX_RANK_WILDCARD);
+    pmix_grp_mbrset_add(&set, &proc, 0);
+    PMIX_LOAD_PROCID(&proc, "gm.r", 7);
+    pmix_grp_mbrset_add(&set, &proc, 1);
+
+    report("wildcard: entry names every rank",
+           has(&set, "gm.w", 0) && has(&set, "gm.w", 123456));
+    report("wildcard: query matches a named rank's nspace", has(&set, "gm.r", PMIX_RANK_WILDCARD));
+    report("wildcard: query for an unnamed nspace does not",
+           !has(&set, "gm.x", PMIX_RANK_WILDCARD));
+    PMIX_DESTRUCT(&set);
+}
+
+static void test_add_procs(void)
+{
+    pmix_grp_mbrset_t set;
+    pmix_proc_t procs[5];
+    pmix_status_t rc;
+
+    PMIX_CONSTRUCT(&set, pmix_grp_mbrset_t);
+    PMIX_LOAD_PROCID(&procs[0], "gm.p", 1);
+    PMIX_LOAD_PROCID(&procs[1], "gm.q", 2);
+    PMIX_LOAD_PROCID(&procs[2], "gm.p", 1);
+    PMIX_LOAD_PROCID(&procs[3], "gm.q", PMIX_RANK_WILDCARD);
+    PMIX_LOAD_PROCID(&procs[4], "gm.p", 9);
+    rc = pmix_grp_mbrset_add_procs(&set, procs, 5);
+    report("add_procs: succeeds", PMIX_SUCCESS == rc);
+    report("add_procs: every proc is in",
+           has(&set, "gm.p", 1) && has(&set, "gm.p", 9) && has(&set, "gm.q", 50));
+    report("add_procs: one entry per nspace", 2 == pmix_list_get_size(&set.nspaces));
+    report("add_procs: nothing to add is fine",
+           PMIX_SUCCESS == pmix_grp_mbrset_add_procs(&set, NULL, 0));
+    PMIX_DESTRUCT(&set);
+}
+
+static void test_union_order(void)
+{
+    pmix_grp_union_t u;
+    pmix_proc_t *base, more[5];
+    size_t nbase = 3;
+    pmix_status_t rc;
+
+    PMIX_PROC_CREATE(base, nbase);
+    PMIX_LOAD_PROCID(&base[0], "gm.u", 5);
+    PMIX_LOAD_PROCID(&base[1], "gm.v", 0);
+    PMIX_LOAD_PROCID(&base[2], "gm.u", 1);
+    PMIX_LOAD_PROCID(&more[0], "gm.u", 1);   // in the base already
+    PMIX_LOAD_PROCID(&more[1], "gm.u", 2);
+    PMIX_LOAD_PROCID(&more[2], "gm.v", 0);   // in the base already
+    PMIX_LOAD_PROCID(&more[3], "gm.u", 2);   // repeated within the array
+    PMIX_LOAD_PROCID(&more[4], "gm.t", 0);
+
+    rc = pmix_grp_union_start(&u, &base, &nbase);
+    if (PMIX_SUCCESS == rc) {
+        rc = pmix_grp_union_merge(&u, more, 5);
+        rc = pmix_grp_union_finish(&u, rc);
+    }
+    report("union: succeeds", PMIX_SUCCESS == rc);
+    report("union: repeats dropped", 5 == nbase);
+    report("union: first-seen order kept",
+           5 == nbase && proc_is(&base[0], "gm.u", 5) && proc_is(&base[1], "gm.v", 0)
+           && proc_is(&base[2], "gm.u", 1) && proc_is(&base[3], "gm.u", 2)
+           && proc_is(&base[4], "gm.t", 0));
+    PMIX_PROC_FREE(base, nbase);
+}
+
+static void test_union_widen(void)
+{
+    pmix_grp_union_t u;
+    pmix_proc_t *base, first[3], second[3];
+    size_t nbase = 2;
+    pmix_status_t rc;
+
+    PMIX_PROC_CREATE(base, nbase);
+    PMIX_LOAD_PROCID(&base[0], "gm.b1", 4);
+    PMIX_LOAD_PROCID(&base[1], "gm.b2", 0);
+    /* widens the base's entry for gm.b1, and adds gm.e1 */
+    PMIX_LOAD_PROCID(&first[0], "gm.e1", 8);
+    PMIX_LOAD_PROCID(&first[1], "gm.b1", PMIX_RANK_WILDCARD);
+    PMIX_LOAD_PROCID(&first[2], "gm.e1", 9);
+    /* widens the added entry for gm.e1; the rest are covered */
+    PMIX_LOAD_PROCID(&second[0], "gm.e1", PMIX_RANK_WILDCARD);
+    PMIX_LOAD_PROCID(&second[1], "gm.b1", 77);
+    PMIX_LOAD_PROCID(&second[2], "gm.e1", 3);
+
+    rc = pmix_grp_union_start(&u, &base, &nbase);
+    if (PMIX_SUCCESS == rc) {
+        rc = pmix_grp_union_merge(&u, first, 3);
+    }
+    if (PMIX_SUCCESS == rc) {
+        rc = pmix_grp_union_merge(&u, second, 3);
+    }
+    rc = pmix_grp_union_finish(&u, rc);
+    report("widen: succeeds", PMIX_SUCCESS == rc);
+    report("widen: base entry widened in place",
+           4 <= nbase && proc_is(&base[0], "gm.b1", PMIX_RANK_WILDCARD));
+    report("widen: added entry widened in place",
+           4 <= nbase && proc_is(&base[2], "gm.e1", PMIX_RANK_WILDCARD));
+    /* gm.e1:9 went in before the nspace was widened and stays; what
+     * came after the widening is covered and is not added */
+    report("widen: no extra entries for covered ranks",
+           4 == nbase && proc_is(&base[1], "gm.b2", 0) && proc_is(&base[3], "gm.e1", 9));
+    PMIX_PROC_FREE(base, nbase);
+}
+
+static void test_departure(void)
+{
+    pmix_grp_mbrset_t members, arrived, gone;
+    pmix_proc_t procs[3], proc;
+
+    PMIX_CONSTRUCT(&members, pmix_grp_mbrset_t);
+    PMIX_CONSTRUCT(&arrived, pmix_grp_mbrset_t);
+    PMIX_CONSTRUCT(&gone, pmix_grp_mbrset_t);
+    PMIX_LOAD_PROCID(&procs[0], "gm.d", 0);
+    PMIX_LOAD_PROCID(&procs[1], "gm.d", 1);
+    PMIX_LOAD_PROCID(&procs[2], "gm.all", PMIX_RANK_WILDCARD);
+    pmix_grp_mbrset_add_procs(&members, procs, 3);
+    pmix_grp_mbrset_add(&arrived, &procs[0], 0);
+
+    PMIX_LOAD_PROCID(&proc, "gm.d", 5);
+    report("departure: a non-member is ignored",
+           PMIX_GRP_DEPART_IGNORE == pmix_grp_mbrset_depart(&members, &arrived, &gone, &proc));
+    report("departure: a member that arrived is ignored",
+           PMIX_GRP_DEPART_IGNORE
+               == pmix_grp_mbrset_depart(&members, &arrived, &gone, &procs[0]));
+    report("departure: a member that had not arrived is new",
+           PMIX_GRP_DEPART_NEW == pmix_grp_mbrset_depart(&members, &arrived, &gone, &procs[1]));
+    report("departure: ... and known the second time",
+           PMIX_GRP_DEPART_KNOWN == pmix_grp_mbrset_depart(&members, &arrived, &gone, &procs[1]));
+    PMIX_LOAD_PROCID(&proc, "gm.all", 42);
+    report("departure: a rank of a wildcard member counts",
+           PMIX_GRP_DEPART_NEW == pmix_grp_mbrset_depart(&members, &arrived, &gone, &proc));
+    report("departure: only what departed is gone",
+           has(&gone, "gm.d", 1) && has(&gone, "gm.all", 42) && !has(&gone, "gm.d", 0)
+           && !has(&gone, "gm.all", 43));
+
+    PMIX_DESTRUCT(&members);
+    PMIX_DESTRUCT(&arrived);
+    PMIX_DESTRUCT(&gone);
+}
+
+#define NLARGE 100000
+
+static void test_large(void)
+{
+    pmix_grp_union_t u;
+    pmix_grp_nsmbrs_t *ns;
+    pmix_proc_t *base, *part;
+    size_t nbase = NLARGE, n, p;
+    pmix_status_t rc;
+    double start, elapsed;
+    int ordered = 1;
+
+    PMIX_PROC_CREATE(base, nbase);
+    part = (pmix_proc_t *) malloc(NLARGE * sizeof(pmix_proc_t));
+    if (NULL == base || NULL == part) {
+        report("large: allocated", 0);
+        return;
+    }
+    for (n = 0; n < NLARGE; n++) {
+        PMIX_LOAD_PROCID(&base[n], "gm.large", (pmix_rank_t) n);
+    }
+
+    start = now();
+    rc = pmix_grp_union_start(&u, &base, &nbase);
+    for (p = 1; PMIX_SUCCESS == rc && p < 4; p++) {
+        /* every participant names the same members, in its own order */
+        for (n = 0; n < NLARGE; n++) {
+            PMIX_LOAD_PROCID(&part[n], "gm.large", (pmix_rank_t) ((n * 7919 * p) % NLARGE));
+        }
+        rc = pmix_grp_union_merge(&u, part, NLARGE);
+    }
+    ns = (pmix_grp_nsmbrs_t *) pmix_list_get_first(&u.set.nspaces);
+    report("large: one nspace entry", 1 == pmix_list_get_size(&u.set.nspaces));
+    report("large: bitmap is a few KB",
+           (size_t) ns->ranks.array_size * sizeof(uint64_t) <= 16 * 1024);
+    rc = pmix_grp_union_finish(&u, rc);
+    elapsed = now() - start;
+
+    for (n = 0; n < nbase; n++) {
+        if (base[n].rank != (pmix_rank_t) n) {
+            ordered = 0;
+            break;
+        }
+    }
+    report("large: merged", PMIX_SUCCESS == rc && NLARGE == nbase);
+    report("large: order of first sighting kept", ordered);
+    fprintf(stdout, "    merged 4 x %d procs in %.3f sec\n", NLARGE, elapsed);
+    /* pairwise comparison would be 4e10 of them - minutes, not this */
+    report("large: merged in linear time", elapsed < 5.0);
+
+    free(part);
+    PMIX_PROC_FREE(base, nbase);
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    fprintf(stdout, "\n=== group membership set unit tests ===\n\n");
+
+    test_sets();
+    test_wildcard();
+    test_add_procs();
+    test_union_order();
+    test_union_widen();
+    test_departure();
+    test_large();
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+
+    return (nfail > 0) ? 1 : 0;
+}
@@ -169,7 +169,7 @@ static void do_op(int sd, short args, void *cbdata)
         }
         nptr->nspace = strdup(r->nspace);
         memcpy(&nptr->iof_flags, &r->flags, sizeof(pmix_iof_flags_t));
-        pmix_list_append(&pmix_globals.nspaces, &nptr->super);
+        pmix_nspace_add(nptr, false);
         break;
     case OP_PENDING_COUNT:
         r->count = pmix_list_get_size(&pmix_globals.iof_pending);
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * White-box unit tests for the namespace registry in
+ * src/include/pmix_globals.c - pmix_nspace_add/remove/lookup - and for
+ * the rank index each namespace keeps the same way -
+ * pmix_nspace_add_rank/remove_rank/find_rank.
+ *
+ * pmix_globals.nspaces is still the list that owns every namespace, but
+ * the per-message paths find an entry through pmix_globals.nspace_index
+ * instead of walking it. The two have to agree for the life of the
+ * server: whatever a walk of the list would have found, the lookup has to
+ * find, and something the list no longer holds must not be found at all.
+ * A stale index entry is worse than a slow lookup - it hands the caller a
+ * released object.
+ *
+ * Registration and deregistration run on the progress thread; both are
+ * driven in their blocking form here, so by the time they return the
+ * registry has been updated and can be read from main().
+ *
+ * Test cases:
+ *
+ *   our own namespace                      -> first on the list, and found
+ *   registered namespaces                  -> each found, exact name only
+ *   NULL, empty and unknown names          -> not found
+ *   one namespace deregistered             -> gone, the others still found
+ *   a namespace's registered clients       -> each rank found, and the entry
+ *                                             found is the one on the list
+ *   a rank never registered                -> not found
+ *   a rank registered twice                -> refused, the first kept
+ *   one client deregistered                -> gone, the others still found
+ *   a second entry for a rank              -> the first is still the one
+ *                                             found; once it goes, the
+ *                                             second is
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/class/pmix_list.h"
+#include "src/include/pmix_globals.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define NSUT_NJOBS  8
+#define NSUT_PREFIX "nspace-registry-ut"
+#define NSUT_NRANKS 300
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static pmix_status_t register_job(const char *name)
+{
+    pmix_info_t info;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    uint32_t nprocs = 1;
+
+    PMIX_INFO_LOAD(&info, PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    PMIX_LOAD_NSPACE(ns, name);
+    rc = PMIx_server_register_nspace(ns, 0, &info, 1, NULL, NULL);
+    if (PMIX_OPERATION_SUCCEEDED == rc) {
+        rc = PMIX_SUCCESS;
+    }
+    PMIX_INFO_DESTRUCT(&info);
+    return rc;
+}
+
+/* the answer a walk of the list gives, for comparison */
+static pmix_namespace_t *walk(const char *name)
+{
+    pmix_namespace_t *ns;
+
+    PMIX_LIST_FOREACH (ns, &pmix_globals.nspaces, pmix_namespace_t) {
+        if (NULL != ns->nspace && 0 == strcmp(ns->nspace, name)) {
+            return ns;
+        }
+    }
+    return NULL;
+}
+
+/* the entry a walk of a namespace's ranks gives, for comparison */
+static pmix_rank_info_t *walk_rank(pmix_namespace_t *nptr, pmix_rank_t rank)
+{
+    pmix_rank_info_t *info;
+
+    PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
+        if (info->pname.rank == rank) {
+            return info;
+        }
+    }
+    return NULL;
+}
+
+static pmix_status_t register_ranks(const char *name)
+{
+    pmix_info_t info;
+    pmix_nspace_t ns;
+    pmix_proc_t proc;
+    pmix_status_t rc;
+    uint32_t nprocs = NSUT_NRANKS;
+    pmix_rank_t r;
+
+    PMIX_INFO_LOAD(&info, PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    PMIX_LOAD_NSPACE(ns, name);
+    rc = PMIx_server_register_nspace(ns, NSUT_NRANKS, &info, 1, NULL, NULL);
+    PMIX_INFO_DESTRUCT(&info);
+    if (PMIX_SUCCESS != rc && PMIX_OPERATION_SUCCEEDED != rc) {
+        return rc;
+    }
+    for (r = 0; r < NSUT_NRANKS; r++) {
+        PMIX_LOAD_PROCID(&proc, name, r);
+        rc = PMIx_server_register_client(&proc, geteuid(), getegid(), NULL, NULL, NULL);
+        if (PMIX_SUCCESS != rc && PMIX_OPERATION_SUCCEEDED != rc) {
+            return rc;
+        }
+    }
+    return PMIX_SUCCESS;
+}
+
+static void test_ranks(void)
+{
+    char name[PMIX_MAX_NSLEN + 1];
+    pmix_namespace_t *nptr;
+    pmix_rank_info_t *info, *dup;
+    pmix_proc_t proc;
+    pmix_status_t rc;
+    pmix_rank_t r;
+    bool ok;
+
+    snprintf(name, sizeof(name), "%s-ranks", NSUT_PREFIX);
+    rc = register_ranks(name);
+    nptr = pmix_nspace_lookup(name);
+    report("a namespace's clients register", PMIX_SUCCESS == rc && NULL != nptr);
+    if (NULL == nptr) {
+        return;
+    }
+    ok = true;
+    for (r = 0; r < NSUT_NRANKS; r++) {
+        info = pmix_nspace_find_rank(nptr, r);
+        if (NULL == info || info != walk_rank(nptr, r) || r != info->pname.rank) {
+            ok = false;
+        }
+    }
+    report("every registered rank is found, as the list has it", ok);
+    report("a rank never registered is not found",
+           NULL == pmix_nspace_find_rank(nptr, NSUT_NRANKS)
+               && NULL == pmix_nspace_find_rank(nptr, PMIX_RANK_WILDCARD));
+
+    PMIX_LOAD_PROCID(&proc, name, 7);
+    info = pmix_nspace_find_rank(nptr, 7);
+    rc = PMIx_server_register_client(&proc, geteuid(), getegid(), NULL, NULL, NULL);
+    report("a rank registered twice is refused",
+           PMIX_ERR_DUPLICATE_KEY == rc && info == pmix_nspace_find_rank(nptr, 7)
+               && NSUT_NRANKS == pmix_list_get_size(&nptr->ranks));
+
+    PMIx_server_deregister_client(&proc, NULL, NULL);
+    report("a deregistered client is gone from the list", NULL == walk_rank(nptr, 7));
+    report("and from the index", NULL == pmix_nspace_find_rank(nptr, 7));
+    ok = true;
+    for (r = 0; r < NSUT_NRANKS; r++) {
+        if (7 != r && NULL == pmix_nspace_find_rank(nptr, r)) {
+            ok = false;
+        }
+    }
+    report("the other ranks are still found", ok);
+
+    /* nothing registers a rank twice, but the index has to say what a
+     * walk of the list would if something did */
+    info = pmix_nspace_find_rank(nptr, 9);
+    dup = PMIX_NEW(pmix_rank_info_t);
+    dup->pname.nspace = strdup(name);
+    dup->pname.rank = 9;
+    pmix_nspace_add_rank(nptr, dup);
+    report("a second entry for a rank does not displace the first",
+           info == pmix_nspace_find_rank(nptr, 9));
+    pmix_nspace_remove_rank(nptr, info);
+    report("once the first goes, the second is found", dup == pmix_nspace_find_rank(nptr, 9));
+    /* put the original back so deregistration finds it to release */
+    pmix_nspace_add_rank(nptr, info);
+    pmix_nspace_remove_rank(nptr, dup);
+    PMIX_RELEASE(dup);
+    report("and the first again once the second goes", info == pmix_nspace_find_rank(nptr, 9));
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    char names[NSUT_NJOBS][PMIX_MAX_NSLEN + 1];
+    pmix_namespace_t *first, *nptr;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    bool ok;
+    int n;
+
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "nspace_registry: namespace and rank index unit tests\n");
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    /* --- our own namespace ------------------------------------------- */
+    first = (pmix_namespace_t *) pmix_list_get_first(&pmix_globals.nspaces);
+    report("own namespace is first on the list",
+           first == pmix_globals.mypeer->nptr);
+    report("own namespace is found by name",
+           pmix_globals.mypeer->nptr == pmix_nspace_lookup(pmix_globals.myid.nspace));
+
+    /* --- a handful of registered jobs -------------------------------- */
+    for (n = 0; n < NSUT_NJOBS; n++) {
+        snprintf(names[n], sizeof(names[n]), "%s-%d", NSUT_PREFIX, n);
+        rc = register_job(names[n]);
+        if (PMIX_SUCCESS != rc) {
+            fprintf(stderr, "register %s failed: %s\n", names[n], PMIx_Error_string(rc));
+            PMIx_server_finalize();
+            return 1;
+        }
+    }
+    ok = true;
+    for (n = 0; n < NSUT_NJOBS; n++) {
+        nptr = pmix_nspace_lookup(names[n]);
+        if (NULL == nptr || nptr != walk(names[n])) {
+            ok = false;
+        }
+    }
+    report("every registered namespace is found", ok);
+    report("lookup matches the whole name, not a prefix",
+           NULL == pmix_nspace_lookup(NSUT_PREFIX));
+
+    /* --- names that must not resolve --------------------------------- */
+    report("NULL name is not found", NULL == pmix_nspace_lookup(NULL));
+    report("empty name is not found", NULL == pmix_nspace_lookup(""));
+    report("unknown name is not found", NULL == pmix_nspace_lookup("no-such-nspace"));
+
+    /* --- deregistration withdraws the entry -------------------------- */
+    PMIX_LOAD_NSPACE(ns, names[0]);
+    PMIx_server_deregister_nspace(ns, NULL, NULL);
+    report("deregistered namespace is gone from the list", NULL == walk(names[0]));
+    report("deregistered namespace is gone from the index",
+           NULL == pmix_nspace_lookup(names[0]));
+    ok = true;
+    for (n = 1; n < NSUT_NJOBS; n++) {
+        if (NULL == pmix_nspace_lookup(names[n])) {
+            ok = false;
+        }
+    }
+    report("the other namespaces are still found", ok);
+
+    /* --- the ranks within one ---------------------------------------- */
+    test_ranks();
+
+    PMIx_server_finalize();
+
+    fprintf(stdout, "nspace_registry: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
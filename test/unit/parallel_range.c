@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the range-parallel helper in src/threads/parallel.c,
+ * which the fence, gds/base and gds/shmem3 share out their bulk steps
+ * with.
+ *
+ * Test cases:
+ *
+ *   nworkers: capped by the thread count, by the items per worker,
+ *             and never below one; 0 threads means one per processor
+ *   range:    the slices cover [0, nitems) exactly once, contiguously
+ *             and in worker order, for any worker count
+ *   range:    the same counts give the same slices every time
+ *   range:    the first failure in worker order is the one returned,
+ *             and every slice still runs
+ *   items:    every item in [first, last) is visited exactly once
+ *   items:    more workers than items, and no items at all
+ */
+
+#include "src/include/pmix_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pmix_common.h"
+#include "src/threads/pmix_parallel.h"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+#define MAXWORKERS 16
+
+typedef struct {
+    size_t first[MAXWORKERS];
+    size_t last[MAXWORKERS];
+    int ran[MAXWORKERS];
+    /* workers told to fail, and with what */
+    pmix_status_t fail[MAXWORKERS];
+} slices_t;
+
+static pmix_status_t record_slice(void *ctx, size_t worker, size_t first, size_t last)
+{
+    slices_t *sl = (slices_t *) ctx;
+
+    sl->first[worker] = first;
+    sl->last[worker] = last;
+    sl->ran[worker] = 1;
+    return sl->fail[worker];
+}
+
+static pmix_status_t count_item(void *items, size_t n)
+{
+    /* each item is only ever touched by the one worker that owns it */
+    ((int *) items)[n]++;
+    return PMIX_SUCCESS;
+}
+
+/* ------------------------------------------------------------------ */
+
+static void test_nworkers(void)
+{
+    report("nworkers: capped by the thread count", 4 == pmix_parallel_nworkers(4, 1000, 1));
+    report("nworkers: capped by items per worker", 3 == pmix_parallel_nworkers(8, 50, 16));
+    report("nworkers: never below one", 1 == pmix_parallel_nworkers(8, 3, 16));
+    report("nworkers: never below one with no items", 1 == pmix_parallel_nworkers(8, 0, 1));
+    report("nworkers: 0 threads is at least one", 1 <= pmix_parallel_nworkers(0, 1000000, 1));
+    report("nworkers: 0 threads is stable",
+           pmix_parallel_nworkers(0, 1000000, 1) == pmix_parallel_nworkers(0, 1000000, 1));
+}
+
+static void test_slices(void)
+{
+    slices_t sl, again;
+    size_t nworkers, nitems, w;
+    int ok = 1, same = 1;
+
+    for (nworkers = 1; nworkers <= MAXWORKERS; nworkers++) {
+        for (nitems = 0; nitems < 40; nitems += 3) {
+            memset(&sl, 0, sizeof(sl));
+            memset(&again, 0, sizeof(again));
+            if (PMIX_SUCCESS != pmix_parallel_range(record_slice, &sl, nitems, nworkers)) {
+                ok = 0;
+            }
+            (void) pmix_parallel_range(record_slice, &again, nitems, nworkers);
+            for (w = 0; w < nworkers; w++) {
+                if (!sl.ran[w] || sl.first[w] > sl.last[w]) {
+                    ok = 0;
+                }
+                if (0 == w ? 0 != sl.first[w] : sl.first[w] != sl.last[w - 1]) {
+                    ok = 0;
+                }
+                if (sl.first[w] != again.first[w] || sl.last[w] != again.last[w]) {
+                    same = 0;
+                }
+            }
+            if (nitems != sl.last[nworkers - 1]) {
+                ok = 0;
+            }
+        }
+    }
+    report("range: slices cover every item once, in worker order", ok);
+    report("range: the same counts give the same slices", same);
+}
+
+static void test_errors(void)
+{
+    slices_t sl;
+    pmix_status_t rc;
+    size_t w;
+    int allran = 1;
+
+    memset(&sl, 0, sizeof(sl));
+    sl.fail[1] = PMIX_ERR_NOMEM;
+    sl.fail[3] = PMIX_ERR_BAD_PARAM;
+    rc = pmix_parallel_range(record_slice, &sl, 100, 4);
+    for (w = 0; w < 4; w++) {
+        allran &= sl.ran[w];
+    }
+    report("range: first failure in worker order returned", PMIX_ERR_NOMEM == rc);
+    report("range: every slice ran regardless", allran);
+}
+
+static void test_items(void)
+{
+    int counts[1000];
+    size_t n;
+    int ok = 1, untouched = 1;
+
+    memset(counts, 0, sizeof(counts));
+    if (PMIX_SUCCESS != pmix_parallel_items(count_item, counts, 10, 990, 7)) {
+        ok = 0;
+    }
+    for (n = 0; n < 1000; n++) {
+        if ((10 <= n && n < 990) ? 1 != counts[n] : 0 != counts[n]) {
+            ok = 0;
+        }
+    }
+    report("items: each item in the range visited once", ok);
+
+    memset(counts, 0, sizeof(counts));
+    ok = (PMIX_SUCCESS == pmix_parallel_items(count_item, counts, 0, 3, 8));
+    report("items: more workers than items",
+           ok && 1 == counts[0] && 1 == counts[1] && 1 == counts[2] && 0 == counts[3]);
+
+    memset(counts, 0, sizeof(counts));
+    ok = (PMIX_SUCCESS == pmix_parallel_items(count_item, counts, 5, 5, 4));
+    for (n = 0; n < 1000; n++) {
+        untouched &= (0 == counts[n]);
+    }
+    report("items: an empty range does nothing", ok && untouched);
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    fprintf(stdout, "\n=== range-parallel helper unit tests ===\n\n");
+
+    test_nworkers();
+    test_slices();
+    test_errors();
+    test_items();
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+
+    return (nfail > 0) ? 1 : 0;
+}
@@ -0,0 +1,276 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the server's process-set membership index in
+ * src/server/pmix_server_pset.c.
+ *
+ * The process is initialized as a PMIx server and defines its sets
+ * through PMIx_server_define_process_set, which returns only once the
+ * progress thread has filed the set - so the index can be read from
+ * here afterwards without racing it.
+ *
+ * What is covered:
+ *   - a set's members are folded into sorted, merged rank ranges per
+ *     nspace, with duplicates collapsed and WILDCARD kept as a flag;
+ *   - a proc is reported in a set when its rank falls in a range, and
+ *     not when it falls in a gap or names another nspace;
+ *   - WILDCARD matches from either side, as PMIX_CHECK_PROCID does;
+ *   - names come back in definition order;
+ *   - deleting a set takes it off the index, and the last set naming
+ *     an nspace takes the nspace's entry with it;
+ *   - thousands of sets spread over many nspaces.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/pmix_server.h"
+#include "src/include/pmix_globals.h"
+#include "src/server/pmix_server_ops.h"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static pmix_pset_t *find_pset(const char *name)
+{
+    pmix_pset_t *ps;
+
+    PMIX_LIST_FOREACH (ps, &pmix_server_globals.psets, pmix_pset_t) {
+        if (0 == strcmp(ps->name, name)) {
+            return ps;
+        }
+    }
+    return NULL;
+}
+
+/* the sets the proc is in, joined with commas - "" for none */
+static char *membership(const char *nspace, pmix_rank_t rank)
+{
+    pmix_proc_t proc;
+    char **names, *joined;
+
+    PMIX_LOAD_PROCID(&proc, nspace, rank);
+    names = pmix_server_pset_membership(&proc);
+    if (NULL == names) {
+        return strdup("");
+    }
+    joined = PMIx_Argv_join(names, ',');
+    PMIx_Argv_free(names);
+    return joined;
+}
+
+static int membership_is(const char *nspace, pmix_rank_t rank, const char *expected)
+{
+    char *got = membership(nspace, rank);
+    int match = (0 == strcmp(got, expected));
+
+    if (!match) {
+        fprintf(stdout, "    %s:%u -> \"%s\", expected \"%s\"\n", nspace, rank, got, expected);
+    }
+    free(got);
+    return match;
+}
+
+static bool nspace_indexed(const char *nspace)
+{
+    void *idx;
+
+    return PMIX_SUCCESS == pmix_hash_table_get_value_ptr(&pmix_server_globals.psets_index,
+                                                         nspace, strlen(nspace), &idx);
+}
+
+/* ------------------------------------------------------------------ */
+
+static void test_ranges(void)
+{
+    pmix_proc_t members[9];
+    pmix_rank_t ranks[] = {5, 3, 4, 3, 10, 11, 1, 12, 4};
+    pmix_pset_member_t *mb;
+    pmix_pset_t *ps;
+    size_t n;
+    pmix_status_t rc;
+
+    for (n = 0; n < 9; n++) {
+        PMIX_LOAD_PROCID(&members[n], "ut.ns.a", ranks[n]);
+    }
+    rc = PMIx_server_define_process_set(members, 9, "ranges");
+    report("ranges: set defined", PMIX_SUCCESS == rc);
+    ps = find_pset("ranges");
+    report("ranges: set is listed", NULL != ps);
+    if (NULL == ps) {
+        return;
+    }
+    report("ranges: one share for one nspace", 1 == ps->nmembers);
+    mb = ps->members[0];
+    report("ranges: folded into three ranges", 3 == mb->nranges);
+    if (3 == mb->nranges) {
+        report("ranges: sorted and merged",
+               1 == mb->ranges[0].first && 1 == mb->ranges[0].last
+               && 3 == mb->ranges[1].first && 5 == mb->ranges[1].last
+               && 10 == mb->ranges[2].first && 12 == mb->ranges[2].last);
+    }
+    report("ranges: no wildcard", !mb->wildcard);
+
+    report("ranges: rank at a range's start", membership_is("ut.ns.a", 3, "ranges"));
+    report("ranges: rank inside a range", membership_is("ut.ns.a", 4, "ranges"));
+    report("ranges: rank at a range's end", membership_is("ut.ns.a", 12, "ranges"));
+    report("ranges: rank in a gap", membership_is("ut.ns.a", 7, ""));
+    report("ranges: rank below all ranges", membership_is("ut.ns.a", 0, ""));
+    report("ranges: rank above all ranges", membership_is("ut.ns.a", 13, ""));
+    report("ranges: same rank, other nspace", membership_is("ut.ns.b", 4, ""));
+    report("ranges: wildcard query matches", membership_is("ut.ns.a", PMIX_RANK_WILDCARD, "ranges"));
+
+    PMIx_server_delete_process_set("ranges");
+}
+
+static void test_contiguous(void)
+{
+    pmix_proc_t *members;
+    pmix_pset_t *ps;
+    size_t n;
+
+    members = (pmix_proc_t *) malloc(1000 * sizeof(pmix_proc_t));
+    for (n = 0; n < 1000; n++) {
+        PMIX_LOAD_PROCID(&members[n], "ut.ns.big", 999 - n);
+    }
+    PMIx_server_define_process_set(members, 1000, "block");
+    free(members);
+    ps = find_pset("block");
+    report("contiguous: 1000 ranks in one range",
+           NULL != ps && 1 == ps->nmembers && 1 == ps->members[0]->nranges
+           && 0 == ps->members[0]->ranges[0].first && 999 == ps->members[0]->ranges[0].last);
+    report("contiguous: member found", membership_is("ut.ns.big", 500, "block"));
+    report("contiguous: past the end", membership_is("ut.ns.big", 1000, ""));
+    PMIx_server_delete_process_set("block");
+}
+
+static void test_multi_nspace(void)
+{
+    pmix_proc_t members[4];
+    pmix_pset_t *ps;
+
+    PMIX_LOAD_PROCID(&members[0], "ut.ns.b", 2);
+    PMIX_LOAD_PROCID(&members[1], "ut.ns.a", 0);
+    PMIX_LOAD_PROCID(&members[2], "ut.ns.b", PMIX_RANK_WILDCARD);
+    PMIX_LOAD_PROCID(&members[3], "ut.ns.a", 1);
+    PMIx_server_define_process_set(members, 4, "multi");
+    ps = find_pset("multi");
+    report("multi: one share per nspace", NULL != ps && 2 == ps->nmembers);
+    report("multi: listed nspace a member", membership_is("ut.ns.a", 1, "multi"));
+    report("multi: unlisted nspace a rank", membership_is("ut.ns.a", 2, ""));
+    report("multi: wildcard member covers all of nspace b",
+           membership_is("ut.ns.b", 77, "multi"));
+    report("multi: nspaces indexed", nspace_indexed("ut.ns.a") && nspace_indexed("ut.ns.b"));
+
+    PMIx_server_delete_process_set("multi");
+    report("multi: nspaces dropped from the index with the set",
+           !nspace_indexed("ut.ns.a") && !nspace_indexed("ut.ns.b"));
+    report("multi: no membership after delete", membership_is("ut.ns.a", 1, ""));
+}
+
+static void test_order_and_delete(void)
+{
+    pmix_proc_t members[2];
+
+    PMIX_LOAD_PROCID(&members[0], "ut.ns.c", 0);
+    PMIX_LOAD_PROCID(&members[1], "ut.ns.c", 1);
+    PMIx_server_define_process_set(members, 2, "first");
+    PMIx_server_define_process_set(members, 1, "second");
+    PMIX_LOAD_PROCID(&members[0], "ut.ns.c", 1);
+    PMIx_server_define_process_set(members, 1, "third");
+
+    report("order: rank 0 in first and second", membership_is("ut.ns.c", 0, "first,second"));
+    report("order: rank 1 in first and third", membership_is("ut.ns.c", 1, "first,third"));
+
+    PMIx_server_delete_process_set("first");
+    report("delete: rank 0 left in second", membership_is("ut.ns.c", 0, "second"));
+    report("delete: nspace still indexed while sets remain", nspace_indexed("ut.ns.c"));
+    PMIx_server_delete_process_set("second");
+    PMIx_server_delete_process_set("third");
+    report("delete: nspace dropped with its last set", !nspace_indexed("ut.ns.c"));
+}
+
+static void test_many(void)
+{
+    pmix_proc_t members[3];
+    char name[64], nspace[64];
+    int n, ok = 1;
+
+    for (n = 0; n < 2000; n++) {
+        snprintf(nspace, sizeof(nspace), "ut.many.%d", n % 50);
+        snprintf(name, sizeof(name), "many.%d", n);
+        PMIX_LOAD_PROCID(&members[0], nspace, n);
+        PMIX_LOAD_PROCID(&members[1], nspace, n + 1);
+        PMIX_LOAD_PROCID(&members[2], "ut.many.shared", n);
+        if (PMIX_SUCCESS != PMIx_server_define_process_set(members, 3, name)) {
+            ok = 0;
+        }
+    }
+    report("many: 2000 sets defined", ok);
+    /* rank 1001 of ut.many.1 is in many.1001 (as n) only - many.1000
+     * names ut.many.0 */
+    report("many: rank in exactly one set", membership_is("ut.many.1", 1001, "many.1001"));
+    report("many: shared nspace rank in its own set",
+           membership_is("ut.many.shared", 1234, "many.1234"));
+    report("many: rank matching no set", membership_is("ut.many.1", 1000, ""));
+
+    for (n = 0; n < 2000; n++) {
+        snprintf(name, sizeof(name), "many.%d", n);
+        PMIx_server_delete_process_set(name);
+    }
+    report("many: index empty after deleting them all",
+           0 == pmix_hash_table_get_size(&pmix_server_globals.psets_index));
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    pmix_status_t rc;
+    static pmix_server_module_t mymodule = {0};
+    pmix_proc_t member;
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    fprintf(stdout, "\n=== process-set membership index unit tests ===\n\n");
+
+    test_ranges();
+    test_contiguous();
+    test_multi_nspace();
+    test_order_and_delete();
+    test_many();
+
+    /* leave one behind for finalize to clear */
+    PMIX_LOAD_PROCID(&member, "ut.ns.left", 0);
+    PMIx_server_define_process_set(&member, 1, "leftover");
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+
+    PMIx_server_finalize();
+
+    return (nfail > 0) ? 1 : 0;
+}
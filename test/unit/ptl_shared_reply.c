@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * One reply buffer, many peers: PMIX_SERVER_QUEUE_SHARED_REPLY and the
+ * job-info delivery built on it.
+ *
+ * The server used to give every local client of a job its own copy of
+ * the packed job info, and every fence participant its own release.
+ * Both are now a single read-only buffer queued to each peer by
+ * reference. What has to hold for that to be safe:
+ *
+ *   - queueing takes a reference per peer and leaves the caller's own,
+ *   - every peer receives the complete, identical message, including
+ *     when one of them cannot take it all in one write,
+ *   - each completed send drops exactly its own reference, so the
+ *     buffer outlives the last send and no longer,
+ *   - a queue that fails (finalized peer) gives its reference back,
+ *   - gds/hash hands successive clients of one nspace the same buffer,
+ *     and stops caching it after the last local client without
+ *     disturbing replies already handed out.
+ *
+ * The peers here are socketpairs driven by calling the send handler
+ * directly, so no connection handshake or event loop is involved.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/mca/bfrops/bfrops.h"
+#include "src/mca/gds/base/base.h"
+#include "src/mca/gds/gds.h"
+#include "src/mca/ptl/base/base.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define PSR_NPEERS 4
+#define PSR_TAG    77
+#define PSR_NSPACE "ptl-shared-reply"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static int32_t refs(pmix_buffer_t *b)
+{
+    return ((pmix_object_t *) b)->obj_reference_count;
+}
+
+/* A peer whose socket leads back to us: sv[0] is its end, sv[1] ours.
+ * The peer is built with no socket so that queueing does not arm a
+ * send event we never run; the test attaches sv[0] afterwards and
+ * drives the send handler by hand. */
+static pmix_peer_t *mkpeer(int rank, int sv[2])
+{
+    pmix_peer_t *p;
+
+    if (0 != socketpair(AF_UNIX, SOCK_STREAM, 0, sv)) {
+        return NULL;
+    }
+    p = PMIX_NEW(pmix_peer_t);
+    p->info = PMIX_NEW(pmix_rank_info_t);
+    p->info->pname.nspace = strdup(PSR_NSPACE);
+    p->info->pname.rank = rank;
+    p->sd = -1;
+    return p;
+}
+
+static void test_shared_queue(void)
+{
+    pmix_peer_t *peers[PSR_NPEERS];
+    int sv[PSR_NPEERS][2];
+    pmix_buffer_t *b;
+    pmix_status_t rc;
+    char payload[256 * 1024];
+    char *ptr = payload;
+    bool ok;
+    int n, m;
+
+    fprintf(stdout, "\n-- one buffer queued to many peers --\n");
+
+    for (n = 0; n < (int) sizeof(payload) - 1; n++) {
+        payload[n] = 'a' + (n % 26);
+    }
+    payload[sizeof(payload) - 1] = '\0';
+    b = PMIX_NEW(pmix_buffer_t);
+    PMIX_BFROPS_PACK(rc, pmix_globals.mypeer, b, &ptr, 1, PMIX_STRING);
+    report("payload packed", PMIX_SUCCESS == rc && 0 < b->bytes_used);
+
+    for (n = 0; n < PSR_NPEERS; n++) {
+        peers[n] = mkpeer(n, sv[n]);
+        if (NULL == peers[n]) {
+            report("socketpair", 0);
+            for (m = 0; m < n; m++) {
+                close(sv[m][0]);
+                close(sv[m][1]);
+                PMIX_RELEASE(peers[m]);
+            }
+            PMIX_RELEASE(b);
+            return;
+        }
+        PMIX_SERVER_QUEUE_SHARED_REPLY(rc, peers[n], PSR_TAG, b);
+        if (PMIX_SUCCESS != rc) {
+            break;
+        }
+    }
+    report("queued to every peer", PMIX_SUCCESS == rc);
+    report("one reference per queued send, plus ours", 1 + PSR_NPEERS == refs(b));
+    ok = true;
+    for (n = 0; n < PSR_NPEERS; n++) {
+        ok = ok && NULL != peers[n]->send_msg && b == peers[n]->send_msg->data;
+    }
+    report("every send carries the same buffer, not a copy", ok);
+
+    /* A quarter of a megabyte does not fit a unix socket in one write,
+     * so the handler has to come back for the rest; read as we go */
+    ok = true;
+    for (n = 0; n < PSR_NPEERS; n++) {
+        pmix_ptl_hdr_t hdr;
+        size_t want, got = 0;
+        char *body;
+        ssize_t r;
+
+        peers[n]->sd = sv[n][0];
+        fcntl(peers[n]->sd, F_SETFL, O_NONBLOCK);
+        body = NULL;
+        want = 0;
+        for (m = 0; m < 100000 && (NULL != peers[n]->send_msg || got < want); m++) {
+            if (NULL != peers[n]->send_msg) {
+                pmix_ptl_base_send_handler(peers[n]->sd, 0, peers[n]);
+            }
+            if (NULL == body) {
+                if (sizeof(hdr) != recv(sv[n][1], &hdr, sizeof(hdr), MSG_DONTWAIT | MSG_PEEK)) {
+                    continue;
+                }
+                (void) read(sv[n][1], &hdr, sizeof(hdr));
+                want = ntohl(hdr.nbytes);
+                body = (char *) malloc(want);
+            }
+            r = recv(sv[n][1], body + got, want - got, MSG_DONTWAIT);
+            if (0 < r) {
+                got += r;
+            }
+        }
+        ok = ok && NULL != body && want == b->bytes_used && got == want &&
+             PSR_TAG == ntohl(hdr.tag) && 0 == memcmp(body, b->base_ptr, want);
+        free(body);
+    }
+    report("every peer received the whole, identical message", ok);
+    report("completed sends dropped their references", 1 == refs(b));
+
+    /* a finalized peer refuses the message and must not keep a ref */
+    peers[0]->finalized = true;
+    PMIX_SERVER_QUEUE_SHARED_REPLY(rc, peers[0], PSR_TAG, b);
+    report("finalized peer refuses", PMIX_ERR_UNREACH == rc);
+    report("refused queue gave its reference back", 1 == refs(b));
+
+    for (n = 0; n < PSR_NPEERS; n++) {
+        close(sv[n][1]);
+        PMIX_RELEASE(peers[n]);
+    }
+    PMIX_RELEASE(b);
+}
+
+static pmix_status_t register_job(uint32_t nlocal)
+{
+    pmix_info_t info[1];
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    uint32_t nprocs = nlocal;
+
+    PMIX_INFO_LOAD(&info[0], PMIX_JOB_SIZE, &nprocs, PMIX_UINT32);
+    PMIX_LOAD_NSPACE(ns, PSR_NSPACE);
+    rc = PMIx_server_register_nspace(ns, (int) nlocal, info, 1, NULL, NULL);
+    PMIX_INFO_DESTRUCT(&info[0]);
+    return (PMIX_OPERATION_SUCCEEDED == rc) ? PMIX_SUCCESS : rc;
+}
+
+static void test_job_info(void)
+{
+    pmix_buffer_t *replies[3] = {NULL, NULL, NULL};
+    pmix_gds_base_module_t *mod;
+    pmix_namespace_t *nptr;
+    pmix_info_t dir;
+    pmix_peer_t *peer;
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    int n, sv[2];
+    bool ok;
+
+    fprintf(stdout, "\n-- gds/hash job info --\n");
+
+    PMIX_INFO_LOAD(&dir, PMIX_GDS_MODULE, "hash", PMIX_STRING);
+    mod = pmix_gds_base_assign_module(&dir, 1);
+    PMIX_INFO_DESTRUCT(&dir);
+    if (NULL == mod || 0 != strcmp(mod->name, "hash")) {
+        report("gds/hash available", 0);
+        return;
+    }
+
+    rc = register_job(3);
+    nptr = pmix_nspace_lookup(PSR_NSPACE);
+    report("job with three local clients registered", PMIX_SUCCESS == rc && NULL != nptr);
+    if (NULL == nptr) {
+        return;
+    }
+    peer = mkpeer(0, sv);
+    if (NULL == peer) {
+        report("socketpair", 0);
+        return;
+    }
+    close(sv[0]);
+    close(sv[1]);
+    PMIX_RETAIN(nptr);
+    peer->nptr = nptr;
+    peer->gds = mod;
+    /* no client has connected, so nothing has told the nspace its wire
+     * format yet - borrow ours, as a local client would have */
+    if (NULL == nptr->compat.bfrops) {
+        nptr->compat.bfrops = pmix_globals.mypeer->nptr->compat.bfrops;
+        nptr->compat.type = pmix_globals.mypeer->nptr->compat.type;
+    }
+
+    /* three clients connect, as the switchyard would serve them */
+    ok = true;
+    for (n = 0; n < 3; n++) {
+        PMIX_GDS_REGISTER_JOB_INFO(rc, peer, &replies[n]);
+        ok = ok && PMIX_SUCCESS == rc && NULL != replies[n] && 0 < replies[n]->bytes_used;
+        nptr->ndelivered++;
+    }
+    report("every client gets its job info", ok);
+    report("the second client shares the first client's buffer",
+           NULL != replies[1] && replies[0] == replies[1]);
+    report("so does the last", NULL != replies[2] && replies[0] == replies[2]);
+    report("the cache is dropped after the last local client", NULL == nptr->jobbkt);
+    report("the replies hold the only references", NULL != replies[0] && 3 == refs(replies[0]));
+
+    for (n = 0; n < 3; n++) {
+        if (NULL != replies[n]) {
+            PMIX_RELEASE(replies[n]);
+        }
+    }
+    PMIX_RELEASE(peer);
+    PMIX_LOAD_NSPACE(ns, PSR_NSPACE);
+    PMIx_server_deregister_nspace(ns, NULL, NULL);
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_status_t rc;
+
+    (void) argc;
+    (void) argv;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fprintf(stdout, "ptl_shared_reply: shared send buffer unit tests\n");
+
+    setenv("PMIX_MCA_gds", "hash", 1);
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    test_shared_queue();
+    test_job_info();
+
+    PMIx_server_finalize();
+
+    fprintf(stdout, "\nptl_shared_reply: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
@@ -0,0 +1,348 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the server's cache of host query answers, in
+ * src/server/pmix_server_control.c and src/common/pmix_query.c.
+ *
+ * The process comes up as a PMIx server whose host module answers every
+ * query with a generation number that goes up on each upcall, so a test
+ * can tell a cached answer from a fresh one and count how often the host
+ * was asked. The server queries on its own behalf through PMIx_Query_info,
+ * which takes the same path to the host a client's query does. The cache
+ * is switched on through its MCA params before init, with per-key
+ * overrides for the TTL cases.
+ *
+ * Test cases:
+ *
+ *   the same query twice                -> one upcall, same answer
+ *   the same keys and qualifiers listed
+ *     in another order                  -> answered from the cache
+ *   a different qualifier               -> a new upcall
+ *   PMIX_QUERY_REFRESH_CACHE            -> a new upcall, and its answer
+ *                                          replaces the cached one
+ *   a key whose TTL is overridden to 0  -> never cached
+ *   a key with a short TTL              -> cached until it runs out
+ *   an answer stored on a given TTL     -> expires on the monotonic
+ *                                          clock once it has passed
+ *   a host error                        -> not cached
+ *   PMIX_EVENT_JOB_END, a proc abort
+ *     event, and nspace registration    -> each drops the cache
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/server/pmix_server_ops.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+/* ------------------------------------------------------------------ */
+/* the host                                                             */
+/* ------------------------------------------------------------------ */
+
+static volatile int nupcalls = 0;
+
+static pmix_status_t host_query(pmix_proc_t *proct, pmix_query_t *queries, size_t nqueries,
+                                pmix_info_cbfunc_t cbfunc, void *cbdata)
+{
+    pmix_info_t info[8];
+    uint32_t gen;
+    size_t n, p, ninfo = 0;
+    PMIX_HIDE_UNUSED_PARAMS(proct);
+
+    gen = (uint32_t) ++nupcalls;
+    for (n = 0; n < nqueries; n++) {
+        for (p = 0; NULL != queries[n].keys[p] && ninfo < 8; p++) {
+            if (0 == strcmp(queries[n].keys[p], PMIX_QUERY_QUEUE_LIST)) {
+                /* the one key this host cannot answer */
+                cbfunc(PMIX_ERR_NOT_FOUND, NULL, 0, cbdata, NULL, NULL);
+                return PMIX_SUCCESS;
+            }
+            PMIX_INFO_LOAD(&info[ninfo], queries[n].keys[p], &gen, PMIX_UINT32);
+            ++ninfo;
+        }
+    }
+    /* answering from inside the upcall is allowed, and the info only has
+     * to last until cbfunc returns - which is why the cache copies it */
+    cbfunc(PMIX_SUCCESS, info, ninfo, cbdata, NULL, NULL);
+    for (n = 0; n < ninfo; n++) {
+        PMIX_INFO_DESTRUCT(&info[n]);
+    }
+    return PMIX_SUCCESS;
+}
+
+/* ------------------------------------------------------------------ */
+/* helpers                                                              */
+/* ------------------------------------------------------------------ */
+
+/* Ask for one key, with up to two qualifiers, and return the generation
+ * the host answered with - or -1 if it did not answer */
+static int ask(const char *key1, const char *key2, pmix_info_t *quals, size_t nquals)
+{
+    pmix_query_t query;
+    pmix_info_t *results = NULL;
+    size_t nresults = 0, n;
+    pmix_status_t rc;
+    int gen = -1;
+
+    PMIX_QUERY_CONSTRUCT(&query);
+    PMIx_Argv_append_nosize(&query.keys, key1);
+    if (NULL != key2) {
+        PMIx_Argv_append_nosize(&query.keys, key2);
+    }
+    query.qualifiers = quals;
+    query.nqual = nquals;
+
+    rc = PMIx_Query_info(&query, 1, &results, &nresults);
+    if (PMIX_SUCCESS == rc) {
+        for (n = 0; n < nresults; n++) {
+            if (PMIX_CHECK_KEY(&results[n], key1) && PMIX_UINT32 == results[n].value.type) {
+                gen = (int) results[n].value.data.uint32;
+            }
+        }
+    }
+    if (NULL != results) {
+        PMIX_INFO_FREE(results, nresults);
+    }
+    /* the qualifiers are the caller's */
+    query.qualifiers = NULL;
+    query.nqual = 0;
+    PMIX_QUERY_DESTRUCT(&query);
+    return gen;
+}
+
+static volatile bool notified = false;
+
+static void notify_done(pmix_status_t status, void *cbdata)
+{
+    PMIX_HIDE_UNUSED_PARAMS(status, cbdata);
+    notified = true;
+}
+
+/* Generate the event and wait until the server has processed it */
+static void generate(pmix_status_t code)
+{
+    int n;
+
+    notified = false;
+    if (PMIX_SUCCESS != PMIx_Notify_event(code, &pmix_globals.myid, PMIX_RANGE_LOCAL,
+                                          NULL, 0, notify_done, NULL)) {
+        return;
+    }
+    for (n = 0; !notified && n < 5000; n++) {
+        usleep(1000);
+    }
+}
+
+/* ------------------------------------------------------------------ */
+
+static void test_repeat(void)
+{
+    int before = nupcalls, first, second;
+
+    first = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("repeat: host answered", 0 < first);
+    report("repeat: second answered from the cache", first == second);
+    report("repeat: host asked once", before + 1 == nupcalls);
+}
+
+static void test_normalized(void)
+{
+    pmix_info_t quals[2], swapped[2];
+    int before, first, second, third, other;
+
+    PMIX_INFO_LOAD(&quals[0], PMIX_NSPACE, "qc.ns.a", PMIX_STRING);
+    PMIX_INFO_LOAD(&quals[1], PMIX_RANK, &(pmix_rank_t){3}, PMIX_PROC_RANK);
+    PMIX_INFO_LOAD(&swapped[0], PMIX_RANK, &(pmix_rank_t){3}, PMIX_PROC_RANK);
+    PMIX_INFO_LOAD(&swapped[1], PMIX_NSPACE, "qc.ns.a", PMIX_STRING);
+
+    before = nupcalls;
+    first = ask(PMIX_QUERY_PROC_TABLE, PMIX_QUERY_NUM_PSETS, quals, 2);
+    second = ask(PMIX_QUERY_PROC_TABLE, PMIX_QUERY_NUM_PSETS, swapped, 2);
+    third = ask(PMIX_QUERY_NUM_PSETS, PMIX_QUERY_PROC_TABLE, swapped, 2);
+    report("normalized: reordered qualifiers hit the cache", 0 < first && first == second);
+    report("normalized: reordered keys hit the cache", 0 < third);
+    report("normalized: host asked once", before + 1 == nupcalls);
+
+    PMIX_INFO_DESTRUCT(&swapped[1]);
+    PMIX_INFO_LOAD(&swapped[1], PMIX_NSPACE, "qc.ns.b", PMIX_STRING);
+    other = ask(PMIX_QUERY_PROC_TABLE, PMIX_QUERY_NUM_PSETS, swapped, 2);
+    report("normalized: another qualifier value is another question",
+           0 < other && other != first && before + 2 == nupcalls);
+
+    PMIX_INFO_DESTRUCT(&quals[0]);
+    PMIX_INFO_DESTRUCT(&quals[1]);
+    PMIX_INFO_DESTRUCT(&swapped[0]);
+    PMIX_INFO_DESTRUCT(&swapped[1]);
+}
+
+static void test_refresh(void)
+{
+    pmix_info_t refresh;
+    int first, fresh, after;
+
+    first = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    PMIX_INFO_LOAD(&refresh, PMIX_QUERY_REFRESH_CACHE, NULL, PMIX_BOOL);
+    fresh = ask(PMIX_QUERY_NAMESPACES, NULL, &refresh, 1);
+    after = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("refresh: a refresh asks the host", 0 < fresh && fresh != first);
+    report("refresh: and its answer replaces the cached one", fresh == after);
+    PMIX_INFO_DESTRUCT(&refresh);
+}
+
+static void test_key_ttls(void)
+{
+    int before, first, second;
+
+    /* pmix.qry.jst is overridden to 0 */
+    before = nupcalls;
+    first = ask(PMIX_QUERY_JOB_STATUS, NULL, NULL, 0);
+    second = ask(PMIX_QUERY_JOB_STATUS, NULL, NULL, 0);
+    report("ttl 0: every ask goes to the host", first != second && before + 2 == nupcalls);
+
+    /* ... and poisons any set it is in */
+    before = nupcalls;
+    ask(PMIX_QUERY_NAMESPACES, PMIX_QUERY_JOB_STATUS, NULL, 0);
+    ask(PMIX_QUERY_NAMESPACES, PMIX_QUERY_JOB_STATUS, NULL, 0);
+    report("ttl 0: a set holding the key is not cached either", before + 2 == nupcalls);
+
+    /* PMIX_QUERY_NUM_GROUPS, named by attribute, is 50ms */
+    before = nupcalls;
+    first = ask(PMIX_QUERY_NUM_GROUPS, NULL, NULL, 0);
+    second = ask(PMIX_QUERY_NUM_GROUPS, NULL, NULL, 0);
+    report("short ttl: cached within it", first == second && before + 1 == nupcalls);
+    usleep(100000);
+    second = ask(PMIX_QUERY_NUM_GROUPS, NULL, NULL, 0);
+    report("short ttl: asked again once it runs out", first != second && before + 2 == nupcalls);
+}
+
+/* the cache's own entry points, on the default TTL: the stamp is read
+ * off the monotonic clock and the entry is gone once it has passed */
+static void test_expiry(void)
+{
+    pmix_query_reply_t *qr;
+    pmix_info_t answer;
+    struct timespec tp;
+    uint64_t now;
+    uint32_t val = 7;
+
+    PMIX_INFO_LOAD(&answer, PMIX_QUERY_NUM_PSETS, &val, PMIX_UINT32);
+    pmix_server_query_cache_store(strdup("qc.expiry"), 200, &answer, 1);
+    PMIX_INFO_DESTRUCT(&answer);
+    (void) clock_gettime(CLOCK_MONOTONIC, &tp);
+    now = (uint64_t) tp.tv_sec * 1000 + (uint64_t) tp.tv_nsec / 1000000;
+
+    qr = pmix_server_query_cache_fetch("qc.expiry");
+    report("expiry: stored answer is found", NULL != qr && 1 == qr->ninfo);
+    report("expiry: stamped on the monotonic clock",
+           NULL != qr && qr->expires <= now + 200 && now + 150 < qr->expires);
+    usleep(100000);
+    report("expiry: still cached inside its TTL", NULL != pmix_server_query_cache_fetch("qc.expiry"));
+    usleep(200000);
+    report("expiry: gone once its TTL has passed", NULL == pmix_server_query_cache_fetch("qc.expiry"));
+}
+
+static void test_error_not_cached(void)
+{
+    int before = nupcalls;
+
+    ask(PMIX_QUERY_QUEUE_LIST, NULL, NULL, 0);
+    ask(PMIX_QUERY_QUEUE_LIST, NULL, NULL, 0);
+    report("error: a failed answer is not kept", before + 2 == nupcalls);
+}
+
+static void test_invalidation(void)
+{
+    pmix_nspace_t ns;
+    pmix_status_t rc;
+    int first, second;
+
+    first = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: cached before the event", first == ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0));
+    generate(PMIX_EVENT_JOB_END);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: job end drops it", notified && first != second);
+
+    first = second;
+    generate(PMIX_ERR_PROC_ABORTED_BY_SIG);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: a proc abort drops it", notified && first != second);
+
+    first = second;
+    generate(PMIX_EVENT_NODE_DOWN);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: an unrelated event leaves it", notified && first == second);
+
+    PMIX_LOAD_NSPACE(ns, "qc.new.job");
+    rc = PMIx_server_register_nspace(ns, 0, NULL, 0, NULL, NULL);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: nspace registration drops it", PMIX_SUCCESS == rc && first != second);
+    first = second;
+    PMIx_server_deregister_nspace(ns, NULL, NULL);
+    second = ask(PMIX_QUERY_NAMESPACES, NULL, NULL, 0);
+    report("invalidate: nspace deregistration drops it", first != second);
+}
+
+/* ------------------------------------------------------------------ */
+
+int main(int argc, char **argv)
+{
+    pmix_status_t rc;
+    static pmix_server_module_t mymodule = {
+        .query = host_query
+    };
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    setenv("PMIX_MCA_pmix_server_query_cache_ttl", "60000", 1);
+    setenv("PMIX_MCA_pmix_server_query_cache_key_ttls",
+           "pmix.qry.jst=0,PMIX_QUERY_NUM_GROUPS=50", 1);
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    fprintf(stdout, "\n=== server query cache unit tests ===\n\n");
+
+    test_repeat();
+    test_normalized();
+    test_refresh();
+    test_key_ttls();
+    test_expiry();
+    test_error_not_cached();
+    test_invalidation();
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+
+    PMIx_server_finalize();
+
+    return (nfail > 0) ? 1 : 0;
+}
@@ -31,12 +31,23 @@
  * time it returns and the response function has either fired or never
  * will. No sleeps, no polling.
  *
+ * The replies to requests that can be answered are cached, packed, per
+ * rank (see pmix_server_dmodex_reply). A commit is stood in for here by
+ * what pmix_server_commit does to the cache - bump the rank's modex_gen
+ * and forget its reply - since there is no client to commit.
+ *
  * Test cases:
  *
  *   store internal, then read it back      -> the value survives the xfer
  *   store internal with a NULL value       -> PMIX_ERR_BAD_PARAM
+ *   dmodex for a committed local rank      -> answered, and the reply kept
+ *   the same request again                 -> answered from the kept bytes
+ *   the rank commits again                 -> the next answer is repacked
+ *   a reply larger than the cache          -> answered, not kept
+ *   more replies than the cache holds      -> least recently served goes
  *   dmodex for an uncommitted local rank   -> parked, host not answered
- *   that rank's nspace is deregistered     -> host answered with an error
+ *   that rank's nspace is deregistered     -> host answered with an error,
+ *                                             and nothing of it kept
  */
 
 #include "src/include/pmix_config.h"
@@ -46,6 +57,7 @@
 
 #include "src/class/pmix_list.h"
 #include "src/include/pmix_globals.h"
+#include "src/mca/gds/gds.h"
 #include "src/server/pmix_server_ops.h"
 
 #include <stdio.h>
@@ -54,7 +66,7 @@
 #include <unistd.h>
 
 #define DMUT_NSPACE "server-dmodex-ut"
-#define DMUT_NPROCS 2
+#define DMUT_NPROCS 4
 
 static int npass = 0;
 static int nfail = 0;
@@ -73,15 +85,22 @@ static void report(const char *name, int passed)
 /* what the host's dmodex response function was told */
 static bool dm_fired = false;
 static pmix_status_t dm_status = PMIX_SUCCESS;
+static char *dm_ptr = NULL;
+static char dm_bytes[512];
+static size_t dm_size = 0;
 
 static void dmresponse(pmix_status_t status, char *data, size_t sz, void *cbdata)
 {
-    (void) data;
-    (void) sz;
     (void) cbdata;
 
     dm_fired = true;
     dm_status = status;
+    /* the blob is freed when this returns - keep what it said */
+    dm_ptr = data;
+    dm_size = sz;
+    if (NULL != data && sz <= sizeof(dm_bytes)) {
+        memcpy(dm_bytes, data, sz);
+    }
 }
 
 static size_t nparked(void)
@@ -100,6 +119,120 @@ static void progress_barrier(void)
     PMIX_VALUE_DESTRUCT(&v);
 }
 
+static pmix_rank_info_t *rank_info(pmix_rank_t rank)
+{
+    pmix_namespace_t *nptr = pmix_nspace_lookup(DMUT_NSPACE);
+    pmix_rank_info_t *info;
+
+    if (NULL == nptr) {
+        return NULL;
+    }
+    PMIX_LIST_FOREACH (info, &nptr->ranks, pmix_rank_info_t) {
+        if (rank == info->pname.rank) {
+            return info;
+        }
+    }
+    return NULL;
+}
+
+/* What a commit leaves behind, without a client to make one: the value
+ * in the server's store, and the rank's data marked as in. The values
+ * are all the same length, so every rank's reply is the same size. */
+static bool publish(pmix_rank_t rank, const char *value)
+{
+    pmix_rank_info_t *info = rank_info(rank);
+    pmix_proc_t proc;
+    pmix_kval_t kv;
+    pmix_value_t val;
+    pmix_status_t rc;
+
+    if (NULL == info) {
+        return false;
+    }
+    PMIX_LOAD_PROCID(&proc, DMUT_NSPACE, rank);
+    val.type = PMIX_STRING;
+    val.data.string = (char *) value;
+    kv.key = "server-dmodex-ut.endpoint";
+    kv.value = &val;
+    PMIX_GDS_STORE_KV(rc, pmix_globals.mypeer, &proc, PMIX_REMOTE, &kv);
+    info->modex_recvd = true;
+    info->modex_gen++;
+    pmix_server_dmodex_forget(info);
+    return PMIX_SUCCESS == rc;
+}
+
+static void request(pmix_rank_t rank)
+{
+    pmix_proc_t target;
+
+    dm_fired = false;
+    dm_ptr = NULL;
+    dm_size = 0;
+    PMIX_LOAD_PROCID(&target, DMUT_NSPACE, rank);
+    if (PMIX_SUCCESS == PMIx_server_dmodex_request(&target, dmresponse, NULL)) {
+        progress_barrier();
+    }
+}
+
+static void test_cache(void)
+{
+    pmix_rank_info_t *r1 = rank_info(1), *r2 = rank_info(2), *r3 = rank_info(3);
+    char first[sizeof(dm_bytes)];
+    size_t firstsz, one;
+
+    fprintf(stdout, "\n-- packed replies --\n");
+
+    report("ranks 1-3 publish", publish(1, "endpoint-1-first")
+                                    && publish(2, "endpoint-2-first")
+                                    && publish(3, "endpoint-3-first"));
+    if (NULL == r1 || NULL == r2 || NULL == r3) {
+        return;
+    }
+
+    request(1);
+    report("a committed rank is answered", dm_fired && PMIX_SUCCESS == dm_status
+                                                && 0 < dm_size);
+    report("and the reply is kept", NULL != r1->dmodex_reply
+                                        && dm_size == pmix_server_globals.dmodex_cache_bytes);
+    one = dm_size;
+    firstsz = dm_size;
+    memcpy(first, dm_bytes, dm_size);
+
+    request(1);
+    report("asked again, it is answered from the kept bytes",
+           dm_fired && NULL != r1->dmodex_reply && dm_ptr == r1->dmodex_reply->data);
+    report("which are the same bytes", firstsz == dm_size && 0 == memcmp(first, dm_bytes, dm_size));
+
+    report("the rank commits again", publish(1, "endpoint-1-again"));
+    report("and its kept reply is gone", NULL == r1->dmodex_reply
+                                             && 0 == pmix_server_globals.dmodex_cache_bytes);
+    request(1);
+    report("the next answer carries the new value",
+           dm_fired && firstsz == dm_size && 0 != memcmp(first, dm_bytes, dm_size));
+    report("and is kept in turn", NULL != r1->dmodex_reply
+                                      && r1->dmodex_reply->gen == r1->modex_gen);
+
+    /* a cache too small for any one reply */
+    pmix_server_dmodex_forget(r1);
+    pmix_server_globals.dmodex_cache_size = one - 1;
+    request(1);
+    report("a reply larger than the cache is still answered", dm_fired && one == dm_size);
+    report("but not kept", NULL == r1->dmodex_reply
+                               && 0 == pmix_server_globals.dmodex_cache_bytes);
+
+    /* room for two: 1 and 2 kept, 1 served again, then 3 */
+    pmix_server_globals.dmodex_cache_size = 2 * one;
+    request(1);
+    request(2);
+    request(1);
+    request(3);
+    report("the least recently served reply makes room",
+           NULL != r1->dmodex_reply && NULL == r2->dmodex_reply
+               && NULL != r3->dmodex_reply);
+    report("and the cache stays under its cap",
+           2 * one == pmix_server_globals.dmodex_cache_bytes);
+}
+
 static pmix_status_t register_job(void)
 {
     pmix_info_t info[2];
@@ -172,7 +305,6 @@ int main(int argc, char **argv)
     rc = PMIx_Store_internal(&pmix_globals.myid, "server-dmodex-ut.bad", NULL);
     report("store internal rejects a NULL value", PMIX_ERR_BAD_PARAM == rc);
 
-    /* --- a dmodex request for a rank that has not committed ---------- */
     rc = register_job();
     if (PMIX_SUCCESS != rc) {
         fprintf(stderr, "register_job failed: %s\n", PMIx_Error_string(rc));
@@ -180,6 +312,11 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    /* --- replies to requests that can be answered -------------------- */
+    test_cache();
+
+    /* --- a dmodex request for a rank that has not committed ---------- */
+
     dm_fired = false;
     PMIX_LOAD_PROCID(&target, DMUT_NSPACE, 0);
     rc = PMIx_server_dmodex_request(&target, dmresponse, NULL);
@@ -196,6 +333,9 @@ int main(int argc, char **argv)
     report("departure answered the host", dm_fired);
     report("departure answered with a failure status",
            dm_fired && PMIX_SUCCESS != dm_status);
+    report("departure dropped the kept replies",
+           0 == pmix_list_get_size(&pmix_server_globals.dmodex_cache)
+               && 0 == pmix_server_globals.dmodex_cache_bytes);
 
     PMIx_server_finalize();
 
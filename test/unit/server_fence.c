@@ -298,7 +298,7 @@ static void build_tracker(int sd, short args, void *cbdata)
         pmix_list_append(&trk->local_cbs, &cd->super);
     }
     /* the completion unlinks it from here, so it has to be on the list */
-    pmix_list_append(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_track_collective(trk);
     b->trk = trk;
     PMIX_WAKEUP_THREAD(&b->lock);
 }
@@ -400,11 +400,11 @@ static void drop_reg_trackers(int sd, short args, void *cbdata)
     (void) args;
 
     /* unlink before releasing - being on the list is not a reference */
-    pmix_list_remove_item(&pmix_server_globals.collectives, &r->acc->super);
+    pmix_server_untrack_collective(r->acc);
     PMIX_RELEASE(r->acc);
-    pmix_list_remove_item(&pmix_server_globals.collectives, &r->bad->super);
+    pmix_server_untrack_collective(r->bad);
     PMIX_RELEASE(r->bad);
-    pmix_list_remove_item(&pmix_server_globals.collectives, &r->carry->super);
+    pmix_server_untrack_collective(r->carry);
     PMIX_RELEASE(r->carry);
 
     PMIX_WAKEUP_THREAD(&r->lock);
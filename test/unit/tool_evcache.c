@@ -31,7 +31,12 @@
  *   4. the tool registers handler B, restricted to process Z, and B must
  *      not fire;
  *   5. the server notifies the code about Z, and B must fire - so the
- *      test cannot pass by never delivering anything at all.
+ *      test cannot pass by never delivering anything at all;
+ *   6. the server notifies the code about three more ranks of Y, which
+ *      the tool parks behind the first, and the tool registers handler
+ *      C for every rank of Y. C must be offered all four, oldest first:
+ *      cached events of one code are filed together, and a late handler
+ *      has to see them in the order they happened.
  *
  * WHERE THE PARKED EVENT COMES FROM, since this file used to say the
  * opposite. A tool hands an event its server forwarded straight to
@@ -114,6 +119,11 @@ static pmix_server_module_t mymodule = {
 
 static volatile int nfired_a = 0;
 static volatile int nfired_b = 0;
+static volatile int nfired_c = 0;
+
+/* the Y ranks handler C was offered, in the order it was offered them */
+#define NREPLAY 4
+static pmix_rank_t replayed[NREPLAY];
 
 /* handler A exists only to make the server forward the code to us */
 static void hdlr_a(size_t evhdlr_registration_id, pmix_status_t status,
@@ -145,6 +155,29 @@ static void hdlr_b(size_t evhdlr_registration_id, pmix_status_t status,
     }
 }
 
+/* handler C records which rank of Y each replayed event was about */
+static void hdlr_c(size_t evhdlr_registration_id, pmix_status_t status,
+                   const pmix_proc_t *source, pmix_info_t info[], size_t ninfo,
+                   pmix_info_t results[], size_t nresults,
+                   pmix_event_notification_cbfunc_fn_t cbfunc, void *cbdata)
+{
+    size_t n;
+    PMIX_HIDE_UNUSED_PARAMS(evhdlr_registration_id, status, source, results, nresults);
+
+    for (n = 0; n < ninfo; n++) {
+        if (PMIX_CHECK_KEY(&info[n], PMIX_EVENT_AFFECTED_PROC)) {
+            if (nfired_c < NREPLAY) {
+                replayed[nfired_c] = info[n].value.data.proc->rank;
+            }
+            break;
+        }
+    }
+    ++nfired_c;
+    if (NULL != cbfunc) {
+        cbfunc(PMIX_EVENT_ACTION_COMPLETE, NULL, 0, NULL, NULL, cbdata);
+    }
+}
+
 static void reg_cbfunc(pmix_status_t status, size_t refid, void *cbdata)
 {
     pmix_status_t *sp = (pmix_status_t *) cbdata;
@@ -221,11 +254,11 @@ static int run_tool(int urifd, int readyfd, int gofd)
 {
     char uri[2048];
     ssize_t n;
-    pmix_proc_t myproc, procx, procz;
+    pmix_proc_t myproc, procx, procy, procz;
     pmix_info_t tinfo;
     pmix_status_t rc;
     char c = 'r';
-    int ret = 1, fires;
+    int ret = 1, fires, i;
 
     n = read(urifd, uri, sizeof(uri) - 1);
     if (0 >= n) {
@@ -297,6 +330,37 @@ static int run_tool(int urifd, int readyfd, int gofd)
         goto done;
     }
     fprintf(stdout, "  tool: the event handler B asked for was delivered\n");
+
+    /* ask for three more events about Y, and order ourselves behind
+     * them as before: the first Y event is still parked, and these
+     * three are parked after it */
+    if (1 != write(readyfd, &c, 1) || 1 != read(gofd, &c, 1)) {
+        goto done;
+    }
+    round_trip();
+
+    /* Handler C, for every rank of Y. Registering it replays all four,
+     * and they must come oldest first */
+    PMIX_LOAD_PROCID(&procy, NS_Y, PMIX_RANK_WILDCARD);
+    rc = register_for(&procy, hdlr_c);
+    if (0 > rc) {
+        fprintf(stderr, "  tool: could not register handler C: %s\n", PMIx_Error_string(rc));
+        goto done;
+    }
+    fires = wait_for_fires(&nfired_c, NREPLAY, LOUD_SECS);
+    if (NREPLAY != fires) {
+        fprintf(stderr, "  tool: handler C was offered %d cached events, not %d\n", fires,
+                NREPLAY);
+        goto done;
+    }
+    for (i = 0; i < NREPLAY; i++) {
+        if ((pmix_rank_t) i != replayed[i]) {
+            fprintf(stderr, "  tool: cached event %d replayed was about rank %u of %s, "
+                    "not rank %d\n", i, replayed[i], NS_Y, i);
+            goto done;
+        }
+    }
+    fprintf(stdout, "  tool: cached events were replayed oldest first\n");
     ret = 0;
 
 done:
@@ -354,6 +418,7 @@ int main(int argc, char **argv)
     char *uri;
     int uripipe[2], readypipe[2], gopipe[2];
     pid_t child;
+    pmix_rank_t n;
     int status = 0;
     bool flag = true;
     char c = 'g';
@@ -423,8 +488,6 @@ int main(int argc, char **argv)
         report("first notification released the tool", 0, "short write");
         goto done;
     }
-    close(gopipe[1]);
-    gopipe[1] = -1;
     report("server notified an event about a process no handler wants", 1, NULL);
 
     /* the tool tells us when it is satisfied nothing was replayed */
@@ -440,6 +503,30 @@ int main(int argc, char **argv)
     notify_about(&procz);
     report("server notified an event about the process B asked about", 1, NULL);
 
+    /* once B has it, three more about Y for the tool to park behind the
+     * first - in rank order, so the ranks say the order they came in */
+    if (!wait_readable(readypipe[0], 60) || 1 != read(readypipe[0], &c, 1)) {
+        report("server notified more events about a process no handler wants", 0,
+               "the tool never saw the event about Z, or died");
+        goto done;
+    }
+    for (n = 1; n < 4; n++) {
+        PMIX_LOAD_PROCID(&procy, NS_Y, n);
+        notify_about(&procy);
+    }
+    if (1 != write(gopipe[1], &c, 1)) {
+        report("server notified more events about a process no handler wants", 0,
+               "short write");
+        goto done;
+    }
+    close(gopipe[1]);
+    gopipe[1] = -1;
+    report("server notified more events about a process no handler wants", 1, NULL);
+
+    /* the tool registers C against us, so stay up until it exits -
+     * which closes its end of the pipe */
+    (void) wait_readable(readypipe[0], 2 * LOUD_SECS);
+
 done:
     PMIx_server_finalize();
 
@@ -453,9 +540,10 @@ reap:
     close(readypipe[0]);
     waitpid(child, &status, 0);
     if (!WIFEXITED(status) || 0 != WEXITSTATUS(status)) {
-        report("tool saw exactly the events it asked for", 0, "tool exited non-zero");
+        report("tool saw exactly the events it asked for, oldest first", 0,
+               "tool exited non-zero");
     } else {
-        report("tool saw exactly the events it asked for", 1, NULL);
+        report("tool saw exactly the events it asked for, oldest first", 1, NULL);
     }
 
     fprintf(stdout, "\n%d passed, %d failed\n", npass, nfail);
@@ -10,12 +10,17 @@
  * pmix_server_new_tracker() and pmix_server_get_tracker().
  *
  * A collective tracker is uniquely identified either by a string id, or by the
- * tuple {set of participating procs, collective type}. get_tracker() performs a
- * brute-force search of pmix_server_globals.collectives and must:
+ * tuple {set of participating procs, collective type}. get_tracker() looks it
+ * up in pmix_server_globals.collectives_index and must:
  *   - find a tracker by its id;
  *   - find a tracker by an exact proc-set + type match (order-independent);
  *   - NOT match when the type differs, the proc set differs, or the id is
- *     unknown.
+ *     unknown;
+ *   - keep finding each of many trackers in flight at once, and stop finding
+ *     one as soon as it is untracked - including one chained in the middle of
+ *     others filed under the same key;
+ *   - add only the new procs when a contribution to an id-based tracker
+ *     names some it already has, or names one twice.
  * This underpins how the fence/connect/disconnect families join contributors to
  * the right in-flight collective, so a matching regression would silently split
  * or merge collectives.
@@ -49,7 +54,7 @@ static void release_tracker(pmix_server_trkr_t *trk)
 {
     /* new_tracker appended it to the collectives list; detach before
      * releasing so we do not leave a dangling entry */
-    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_untrack_collective(trk);
     PMIX_RELEASE(trk);
 }
 
@@ -131,6 +136,90 @@ int main(int argc, char **argv)
     release_tracker(t1);
     release_tracker(t2);
 
+    /* Many fences in flight at once, each over its own sub-communicator:
+     * the case that made a linear search of the list expensive. Every one
+     * has to stay findable, and releasing some must not lose the others. */
+    {
+        pmix_server_trkr_t *many[200];
+        pmix_proc_t pair[2];
+        bool allfound = true, nonefound = true;
+        int m;
+
+        for (m = 0; m < 200; m++) {
+            PMIX_LOAD_PROCID(&pair[0], "trk.ns.many", (pmix_rank_t) (2 * m));
+            PMIX_LOAD_PROCID(&pair[1], "trk.ns.many", (pmix_rank_t) (2 * m + 1));
+            many[m] = pmix_server_new_tracker(NULL, pair, 2, PMIX_FENCENB_CMD);
+        }
+        for (m = 0; m < 200; m++) {
+            PMIX_LOAD_PROCID(&pair[0], "trk.ns.many", (pmix_rank_t) (2 * m + 1));
+            PMIX_LOAD_PROCID(&pair[1], "trk.ns.many", (pmix_rank_t) (2 * m));
+            allfound &= (many[m] == pmix_server_get_tracker(NULL, pair, 2, PMIX_FENCENB_CMD));
+        }
+        report("each of 200 concurrent trackers is found by its own set", allfound);
+
+        for (m = 0; m < 200; m += 2) {
+            release_tracker(many[m]);
+        }
+        allfound = true;
+        for (m = 0; m < 200; m++) {
+            PMIX_LOAD_PROCID(&pair[0], "trk.ns.many", (pmix_rank_t) (2 * m));
+            PMIX_LOAD_PROCID(&pair[1], "trk.ns.many", (pmix_rank_t) (2 * m + 1));
+            found = pmix_server_get_tracker(NULL, pair, 2, PMIX_FENCENB_CMD);
+            if (0 == m % 2) {
+                nonefound &= (NULL == found);
+            } else {
+                allfound &= (many[m] == found);
+            }
+        }
+        report("an untracked tracker is no longer found", nonefound);
+        report("and the rest still are", allfound);
+        for (m = 1; m < 200; m += 2) {
+            release_tracker(many[m]);
+        }
+    }
+
+    /* Three trackers under one key - one fired, so a new one for the same
+     * collective was opened behind it, and a third for the same set again
+     * once that one fired too. Untracking the middle of the chain must
+     * leave both ends reachable. */
+    {
+        pmix_server_trkr_t *a, *b, *c;
+
+        a = pmix_server_new_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD);
+        a->completion_fired = true;
+        b = pmix_server_new_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD);
+        b->completion_fired = true;
+        c = pmix_server_new_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD);
+        report("a fresh tracker is found past fired ones with its key",
+               c == pmix_server_get_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD));
+        release_tracker(b);
+        report("and still is once one in the middle is untracked",
+               c == pmix_server_get_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD));
+        release_tracker(c);
+        a->completion_fired = false;
+        report("as is the one at the end of the chain",
+               a == pmix_server_get_tracker(NULL, procsC, 1, PMIX_FENCENB_CMD));
+        release_tracker(a);
+    }
+
+    /* An id-based tracker picks up participants as contributions name
+     * them - each proc once, however often it is named. */
+    {
+        pmix_proc_t more[3];
+
+        t1 = pmix_server_new_tracker("trk-collective-B", procsB, 2, PMIX_CONNECTNB_CMD);
+        PMIX_LOAD_PROCID(&more[0], "trk.ns.b", 1);   /* already there */
+        PMIX_LOAD_PROCID(&more[1], "trk.ns.c", 0);   /* new */
+        PMIX_LOAD_PROCID(&more[2], "trk.ns.c", 0);   /* new, and named twice */
+        found = pmix_server_get_tracker("trk-collective-B", more, 3, PMIX_CONNECTNB_CMD);
+        report("an id lookup merges in only the procs it lacks",
+               found == t1 && 3 == t1->npcs
+                   && PMIX_CHECK_PROCID(&t1->pcs[2], &procsC[0]));
+        found = pmix_server_get_tracker("trk-collective-B", more, 3, PMIX_CONNECTNB_CMD);
+        report("and nothing when it lacks none", found == t1 && 3 == t1->npcs);
+        release_tracker(t1);
+    }
+
     fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
 
     PMIx_server_finalize();
@@ -108,7 +108,7 @@ static pmix_server_trkr_t *make_trk(uint32_t nlocal)
     PMIX_INFO_CREATE(trk->info, 1);
     trk->ninfo = 1;
     PMIX_INFO_LOAD(&trk->info[0], PMIX_LOCAL_COLLECTIVE_STATUS, &seed, PMIX_STATUS);
-    pmix_list_append(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_track_collective(trk);
     return trk;
 }
 
@@ -124,7 +124,7 @@ static void contribute(pmix_server_trkr_t *trk, pmix_rank_t rank)
 
 static void release_trk(pmix_server_trkr_t *trk)
 {
-    pmix_list_remove_item(&pmix_server_globals.collectives, &trk->super);
+    pmix_server_untrack_collective(trk);
     PMIX_RELEASE(trk);
 }
 
@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the inline value storage of pmix_dstor_t:
+ *   pmix_dstor_new_tma, pmix_dstor_load_value_tma,
+ *   pmix_dstor_clear_value_tma, pmix_dstor_release_tma.
+ *
+ * A stored value used to be a pmix_dstor_t pointing at a pmix_value_t
+ * of its own, which in turn pointed at its own string. The value now
+ * lives in the entry, and so does a string that was given room when the
+ * entry was created. These check which values end up where - and,
+ * since d->value is no longer a separate allocation, that replacing and
+ * clearing a value never frees something the entry owns:
+ *
+ *   scalar                         -> in the entry, no payload
+ *   short string, sized for        -> in the tail of the entry
+ *   string longer than the limit   -> payload out of line
+ *   longer string into short room  -> falls back out of line
+ *   string into an unsized entry   -> out of line
+ *   data array                     -> payload out of line, deep copy
+ *   clear                          -> value NULL, entry reusable
+ *
+ * followed by a round trip through pmix_hash_store/fetch that switches
+ * one key between an inline string, a long string and a scalar.
+ *
+ * Run under valgrind or -fsanitize=address to check the release paths.
+ *
+ * Exit 0 if all tests pass, 1 otherwise.
+ */
+
+#include "src/include/pmix_config.h"
+#include "src/include/pmix_globals.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/pmix_server.h"
+#include "pmix.h"
+#include "src/class/pmix_hash_table.h"
+#include "src/class/pmix_list.h"
+#include "src/util/pmix_hash.h"
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        npass++;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        nfail++;
+    }
+}
+
+/* true if the entry's string lives in its own tail */
+static bool held_inline(const pmix_dstor_t *d)
+{
+    return NULL != d->value && PMIX_STRING == d->value->type &&
+           d->str == d->value->data.string;
+}
+
+static void test_scalar(void)
+{
+    pmix_value_t val;
+    pmix_dstor_t *d;
+    uint32_t u32 = 1234;
+
+    PMIx_Value_load(&val, &u32, PMIX_UINT32);
+    d = pmix_dstor_new_tma(7, &val, NULL);
+    report("scalar: entry created", NULL != d);
+    if (NULL == d) {
+        return;
+    }
+    report("scalar: no string room reserved", 0 == d->slen);
+    report("scalar: nothing stored yet", NULL == d->value);
+    report("scalar: load succeeds", PMIX_SUCCESS == pmix_dstor_load_value_tma(d, &val, NULL));
+    report("scalar: value is the entry's own",
+           d->value == &d->inl && PMIX_UINT32 == d->value->type &&
+           1234 == d->value->data.uint32);
+    report("scalar: index and qualifier preserved",
+           7 == d->index && UINT32_MAX == d->qualindex);
+    pmix_dstor_release_tma(d, NULL);
+}
+
+static void test_short_string(void)
+{
+    pmix_value_t val;
+    pmix_dstor_t *d;
+
+    PMIx_Value_load(&val, "node042", PMIX_STRING);
+    d = pmix_dstor_new_tma(1, &val, NULL);
+    report("short string: room reserved", NULL != d && strlen("node042") + 1 == d->slen);
+    if (NULL == d) {
+        PMIx_Value_destruct(&val);
+        return;
+    }
+    pmix_dstor_load_value_tma(d, &val, NULL);
+    report("short string: held in the entry", held_inline(d));
+    report("short string: content", 0 == strcmp(d->value->data.string, "node042"));
+    report("short string: independent of the source", val.data.string != d->value->data.string);
+
+    /* a shorter replacement reuses the room */
+    pmix_dstor_load_value_tma(d, &(pmix_value_t){.type = PMIX_STRING,
+                                                  .data.string = "n1"}, NULL);
+    report("short string: shorter replacement stays inline",
+           held_inline(d) && 0 == strcmp(d->value->data.string, "n1"));
+
+    /* a longer one does not fit and goes out of line */
+    pmix_dstor_load_value_tma(d, &(pmix_value_t){.type = PMIX_STRING,
+                                                  .data.string = "node042-but-longer"}, NULL);
+    report("short string: longer replacement goes out of line",
+           NULL != d->value && !held_inline(d) &&
+           0 == strcmp(d->value->data.string, "node042-but-longer"));
+
+    /* and back again */
+    pmix_dstor_load_value_tma(d, &val, NULL);
+    report("short string: fits again once short", held_inline(d));
+
+    pmix_dstor_clear_value_tma(d, NULL);
+    report("short string: clear leaves no value", NULL == d->value);
+    pmix_dstor_release_tma(d, NULL);
+    PMIx_Value_destruct(&val);
+}
+
+static void test_long_string(void)
+{
+    char big[PMIX_DSTOR_INLINE_MAX + 16];
+    pmix_value_t val;
+    pmix_dstor_t *d;
+
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    PMIx_Value_load(&val, big, PMIX_STRING);
+    d = pmix_dstor_new_tma(2, &val, NULL);
+    report("long string: no room reserved", NULL != d && 0 == d->slen);
+    if (NULL == d) {
+        PMIx_Value_destruct(&val);
+        return;
+    }
+    pmix_dstor_load_value_tma(d, &val, NULL);
+    report("long string: held out of line",
+           NULL != d->value && !held_inline(d) && 0 == strcmp(d->value->data.string, big));
+    pmix_dstor_release_tma(d, NULL);
+    PMIx_Value_destruct(&val);
+
+    /* exactly at the limit still fits */
+    big[PMIX_DSTOR_INLINE_MAX - 1] = '\0';
+    PMIx_Value_load(&val, big, PMIX_STRING);
+    d = pmix_dstor_new_tma(2, &val, NULL);
+    if (NULL != d) {
+        pmix_dstor_load_value_tma(d, &val, NULL);
+    }
+    report("long string: PMIX_DSTOR_INLINE_MAX including terminator fits",
+           NULL != d && held_inline(d));
+    if (NULL != d) {
+        pmix_dstor_release_tma(d, NULL);
+    }
+    PMIx_Value_destruct(&val);
+}
+
+static void test_unsized(void)
+{
+    pmix_value_t val;
+    pmix_dstor_t *d;
+
+    d = pmix_dstor_new_tma(3, NULL, NULL);
+    report("unsized: entry created", NULL != d && 0 == d->slen);
+    if (NULL == d) {
+        return;
+    }
+    PMIx_Value_load(&val, "abc", PMIX_STRING);
+    pmix_dstor_load_value_tma(d, &val, NULL);
+    report("unsized: string goes out of line",
+           NULL != d->value && !held_inline(d) && 0 == strcmp(d->value->data.string, "abc"));
+    PMIx_Value_destruct(&val);
+    pmix_dstor_release_tma(d, NULL);
+}
+
+static void test_darray(void)
+{
+    pmix_value_t val;
+    pmix_data_array_t *darray;
+    pmix_dstor_t *d;
+    uint32_t *u;
+
+    PMIX_DATA_ARRAY_CREATE(darray, 3, PMIX_UINT32);
+    u = (uint32_t *) darray->array;
+    u[0] = 10;
+    u[1] = 20;
+    u[2] = 30;
+    val.type = PMIX_DATA_ARRAY;
+    val.data.darray = darray;
+
+    d = pmix_dstor_new_tma(4, &val, NULL);
+    if (NULL == d) {
+        report("darray: entry created", 0);
+        PMIX_DATA_ARRAY_FREE(darray);
+        return;
+    }
+    pmix_dstor_load_value_tma(d, &val, NULL);
+    report("darray: header in the entry, array copied",
+           d->value == &d->inl && PMIX_DATA_ARRAY == d->value->type &&
+           NULL != d->value->data.darray && darray != d->value->data.darray);
+    report("darray: contents",
+           NULL != d->value->data.darray && 3 == d->value->data.darray->size &&
+           20 == ((uint32_t *) d->value->data.darray->array)[1]);
+    PMIX_DATA_ARRAY_FREE(darray);
+    report("darray: copy survives the source",
+           30 == ((uint32_t *) d->value->data.darray->array)[2]);
+    pmix_dstor_release_tma(d, NULL);
+}
+
+static pmix_status_t fetch_one(pmix_hash_table_t *t, const char *key, pmix_value_t **out)
+{
+    pmix_list_t kvals;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+
+    *out = NULL;
+    PMIX_CONSTRUCT(&kvals, pmix_list_t);
+    rc = pmix_hash_fetch(t, 0, key, NULL, 0, &kvals, NULL);
+    kv = (pmix_kval_t *) pmix_list_remove_first(&kvals);
+    if (PMIX_SUCCESS == rc && NULL != kv) {
+        *out = kv->value;
+        kv->value = NULL;
+    }
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    while (NULL != (kv = (pmix_kval_t *) pmix_list_remove_first(&kvals))) {
+        PMIX_RELEASE(kv);
+    }
+    PMIX_DESTRUCT(&kvals);
+    return rc;
+}
+
+static void test_hash_round_trip(void)
+{
+    char big[PMIX_DSTOR_INLINE_MAX * 2];
+    pmix_hash_table_t *t;
+    pmix_value_t *v;
+    pmix_kval_t kv;
+    uint16_t u16 = 77;
+
+    t = PMIX_NEW(pmix_hash_table_t, NULL);
+    pmix_hash_table_init(t, 16);
+    memset(big, 'y', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+
+    PMIX_CONSTRUCT(&kv, pmix_kval_t);
+    kv.key = "unit.dstor.key";
+    PMIX_VALUE_CREATE(kv.value, 1);
+
+    PMIx_Value_load(kv.value, "short", PMIX_STRING);
+    report("hash: store short string", PMIX_SUCCESS == pmix_hash_store(t, 0, &kv, NULL, 0, NULL));
+    report("hash: fetch short string",
+           PMIX_SUCCESS == fetch_one(t, kv.key, &v) && NULL != v &&
+           PMIX_STRING == v->type && 0 == strcmp(v->data.string, "short"));
+    if (NULL != v) {
+        PMIX_VALUE_RELEASE(v);
+    }
+    PMIx_Value_destruct(kv.value);
+
+    PMIx_Value_load(kv.value, big, PMIX_STRING);
+    report("hash: replace with long string", PMIX_SUCCESS == pmix_hash_store(t, 0, &kv, NULL, 0, NULL));
+    report("hash: fetch long string",
+           PMIX_SUCCESS == fetch_one(t, kv.key, &v) && NULL != v &&
+           PMIX_STRING == v->type && 0 == strcmp(v->data.string, big));
+    if (NULL != v) {
+        PMIX_VALUE_RELEASE(v);
+    }
+    PMIx_Value_destruct(kv.value);
+
+    PMIx_Value_load(kv.value, &u16, PMIX_UINT16);
+    report("hash: replace with scalar", PMIX_SUCCESS == pmix_hash_store(t, 0, &kv, NULL, 0, NULL));
+    report("hash: fetch scalar",
+           PMIX_SUCCESS == fetch_one(t, kv.key, &v) && NULL != v &&
+           PMIX_UINT16 == v->type && 77 == v->data.uint16);
+    if (NULL != v) {
+        PMIX_VALUE_RELEASE(v);
+    }
+
+    report("hash: remove", PMIX_SUCCESS == pmix_hash_remove_data(t, 0, kv.key, NULL));
+    report("hash: gone after remove", PMIX_ERR_NOT_FOUND == fetch_one(t, kv.key, &v));
+
+    kv.key = NULL;
+    PMIX_DESTRUCT(&kv);
+    pmix_hash_remove_data(t, 0, NULL, NULL);
+    PMIX_RELEASE(t);
+}
+
+int main(int argc, char **argv)
+{
+    pmix_status_t rc;
+    static pmix_server_module_t mymodule = {0};
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    fprintf(stdout, "\n=== pmix_dstor_t unit tests ===\n\n");
+
+    test_scalar();
+    test_short_string();
+    test_long_string();
+    test_unsized();
+    test_darray();
+    test_hash_round_trip();
+
+    fprintf(stdout, "\nResults: %d passed, %d failed\n\n", npass, nfail);
+
+    PMIx_server_finalize();
+
+    return (nfail > 0) ? 1 : 0;
+}
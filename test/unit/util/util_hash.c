@@ -11,7 +11,7 @@
  *   pmix_hash_fetch, pmix_hash_remove_data.
  *
  * Requires PMIx_server_init because pmix_hash_store copies values
- * via pmix_bfrops_base_tma_copy_value, which needs the bfrops MCA
+ * via pmix_dstor_load_value_tma, which needs the bfrops MCA
  * framework to be initialised.
  *
  * Exit 0 if all tests pass, 1 otherwise.
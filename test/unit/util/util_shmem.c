@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * Unit tests for the page-size handling in src/util/pmix_shmem.c.
+ *
+ * A segment created with PMIX_SHMEM_HUGE_PAGES may or may not get huge
+ * pages - that is up to the kernel, and a test suite runs wherever it is
+ * run - so what is pinned here is the contract either way:
+ *
+ *   - a segment is a whole number of the pages it ends up with, and says
+ *     which those are,
+ *   - an attacher learns the creator's page size from the segment
+ *     itself, with nothing passed at attach,
+ *   - asking for huge pages where there are none is not an error; it is
+ *     base pages,
+ *   - dropping write access still works on huge pages, where it has to
+ *     be done in whole ones,
+ *   - the fault count moves when a fresh segment is touched,
+ *   - an attach that asks to prefault has already paid for those faults
+ *     by the time it returns.
+ *
+ * Exit 0 if all tests pass, 1 otherwise.
+ */
+
+#include "src/include/pmix_config.h"
+#include "src/include/pmix_globals.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "src/util/pmix_shmem.h"
+#include "src/util/pmix_string_copy.h"
+
+#define TEST_LAYOUT_ID 0x75736d31u /* "usm1" */
+
+static int npass = 0;
+static int nfail = 0;
+static char tmpdir[] = "/tmp/util_shmem.XXXXXX";
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static size_t base_page(void)
+{
+    return (size_t) sysconf(_SC_PAGE_SIZE);
+}
+
+/* Create a segment, then attach a second handle to it the way a client
+ * would: knowing only the path and the size. */
+static pmix_shmem_t *mkseg(const char *name, size_t size, pmix_shmem_flags_t flags,
+                           pmix_shmem_t **reader)
+{
+    char path[PMIX_PATH_MAX];
+    pmix_shmem_t *seg = PMIX_NEW(pmix_shmem_t);
+
+    snprintf(path, sizeof(path), "%s/%s", tmpdir, name);
+    *reader = NULL;
+    if (PMIX_SUCCESS != pmix_shmem_segment_create(seg, size, path, TEST_LAYOUT_ID, flags)
+        || PMIX_SUCCESS != pmix_shmem_segment_attach(seg, 0, 0, TEST_LAYOUT_ID)) {
+        PMIX_RELEASE(seg);
+        return NULL;
+    }
+    *reader = PMIX_NEW(pmix_shmem_t);
+    pmix_string_copy((*reader)->backing_path, seg->backing_path, PMIX_PATH_MAX);
+    (*reader)->size = seg->size;
+    if (PMIX_SUCCESS != pmix_shmem_segment_attach(*reader, 0, 0, TEST_LAYOUT_ID)) {
+        PMIX_RELEASE(*reader);
+        *reader = NULL;
+    }
+    return seg;
+}
+
+static void test_base_pages(void)
+{
+    pmix_shmem_t *seg, *reader;
+
+    fprintf(stdout, "\n-- base pages --\n");
+
+    seg = mkseg("base", 100000, 0, &reader);
+    report("a segment is created and attached", NULL != seg && NULL != reader);
+    if (NULL == seg || NULL == reader) {
+        return;
+    }
+    report("it is on base pages", base_page() == seg->page_size);
+    report("and is the footprint it was always going to be",
+           pmix_shmem_utils_segment_footprint(100000) == seg->size);
+    report("a reader is told the same page size", seg->page_size == reader->page_size);
+
+    memset(seg->data_address, 0x5a, 100000);
+    report("what one writes the other reads",
+           0x5a == ((unsigned char *) reader->data_address)[99999]);
+    PMIX_RELEASE(reader);
+    PMIX_RELEASE(seg);
+}
+
+static void test_huge_pages(void)
+{
+    pmix_shmem_t *seg, *reader;
+    const size_t hp = pmix_shmem_utils_huge_page_size();
+    size_t size;
+
+    fprintf(stdout, "\n-- huge pages --\n");
+
+    report("the huge page size is zero or a power of two above a base page",
+           0 == hp || (hp > base_page() && 0 == (hp & (hp - 1))));
+    fprintf(stdout, "        (huge page size here: %zu)\n", hp);
+
+    /* three and a bit huge pages, so the rounding has something to do */
+    size = (0 < hp) ? 3 * hp + 1 : 1024 * 1024 + 1;
+    seg = mkseg("huge", size, PMIX_SHMEM_HUGE_PAGES, &reader);
+    report("asking for huge pages is never an error", NULL != seg && NULL != reader);
+    if (NULL == seg || NULL == reader) {
+        return;
+    }
+    if (0 < hp) {
+        report("where there are some, the segment gets them", hp == seg->page_size);
+    } else {
+        report("where there are none, it gets base pages", base_page() == seg->page_size);
+    }
+    report("it is a whole number of its pages", 0 == seg->size % seg->page_size);
+    report("and holds what was asked for",
+           seg->size >= pmix_shmem_utils_segment_footprint(size));
+    report("a reader learns the page size from the segment", seg->page_size == reader->page_size);
+
+    memset(seg->data_address, 0xa5, size);
+    report("the far end of the data region is there",
+           0xa5 == ((unsigned char *) reader->data_address)[size - 1]);
+    report("a reader can still drop write access",
+           PMIX_SUCCESS == pmix_shmem_segment_protect_data(reader));
+    report("and still read after it",
+           0xa5 == ((unsigned char *) reader->data_address)[size - 1]);
+    PMIX_RELEASE(reader);
+    PMIX_RELEASE(seg);
+}
+
+static void test_faults(void)
+{
+    pmix_shmem_t *seg, *reader;
+    pmix_shmem_t *loose = PMIX_NEW(pmix_shmem_t);
+    const size_t npages = 64;
+    long before;
+
+    fprintf(stdout, "\n-- fault counts --\n");
+
+    report("a segment not attached has no count", -1 == pmix_shmem_segment_faults(loose));
+    PMIX_RELEASE(loose);
+
+    seg = mkseg("faults", npages * base_page(), 0, &reader);
+    if (NULL == seg || NULL == reader) {
+        report("a segment is created and attached", 0);
+        return;
+    }
+    before = pmix_shmem_segment_faults(reader);
+    report("a fresh attach starts near zero", 0 <= before);
+    /* a write to each page of a fresh shared mapping is a fault apiece;
+     * allow for the kernel mapping some of them ahead */
+    for (size_t n = 0; n < npages; n++) {
+        ((volatile char *) reader->data_address)[n * base_page()] = 1;
+    }
+    report("touching the segment shows up in the count",
+           pmix_shmem_segment_faults(reader) >= before + (long) (npages / 2));
+    PMIX_RELEASE(reader);
+    PMIX_RELEASE(seg);
+}
+
+static void test_prefault(void)
+{
+    pmix_shmem_t *seg, *reader;
+    pmix_shmem_t *eager = PMIX_NEW(pmix_shmem_t);
+    const size_t npages = 64;
+    volatile char sink = 0;
+    long before;
+
+    fprintf(stdout, "\n-- prefault --\n");
+
+    seg = mkseg("prefault", npages * base_page(), 0, &reader);
+    if (NULL == seg || NULL == reader) {
+        report("a segment is created and attached", 0);
+        PMIX_RELEASE(eager);
+        return;
+    }
+    /* the creator writes every page, so they all exist and an attacher's
+     * first read of each is only a mapping fault - the kind prefault is
+     * there to take up front */
+    memset(seg->data_address, 0x3c, npages * base_page());
+
+    pmix_string_copy(eager->backing_path, seg->backing_path, PMIX_PATH_MAX);
+    eager->size = seg->size;
+    report("an attach can ask to prefault",
+           PMIX_SUCCESS == pmix_shmem_segment_attach(eager, 0, PMIX_SHMEM_PREFAULT,
+                                                     TEST_LAYOUT_ID));
+    before = pmix_shmem_segment_faults(eager);
+    for (size_t n = 0; n < npages; n++) {
+        sink += ((volatile char *) eager->data_address)[n * base_page()];
+    }
+    report("reading it afterwards costs next to no faults",
+           pmix_shmem_segment_faults(eager) < before + (long) (npages / 2));
+    report("and reads what was written", 0x3c == ((char *) eager->data_address)[0]);
+    (void) sink;
+
+    PMIX_RELEASE(eager);
+    PMIX_RELEASE(reader);
+    PMIX_RELEASE(seg);
+}
+
+int main(int argc, char **argv)
+{
+    PMIX_HIDE_UNUSED_PARAMS(argc, argv);
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fprintf(stdout, "pmix_shmem page-size tests\n");
+
+    if (NULL == mkdtemp(tmpdir)) {
+        fprintf(stdout, "  SKIP: cannot make a temporary directory\n");
+        return 0;
+    }
+
+    test_base_pages();
+    test_huge_pages();
+    test_faults();
+    test_prefault();
+
+    (void) rmdir(tmpdir);
+
+    fprintf(stdout, "SUMMARY: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}
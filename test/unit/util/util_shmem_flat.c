@@ -0,0 +1,704 @@
+/*
+ * Copyright (c) 2026      Nanook Consulting  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ * The position-independent key-value image behind gds/shmem3's modex
+ * segments (src/util/pmix_shmem_flat.h).
+ *
+ * The point of the image is that it holds no absolute address, so the
+ * tests that matter most read it somewhere other than where it was
+ * written: after a copy whose original is then scribbled over, and
+ * through two mappings of one file at different addresses. Around that:
+ *
+ *   - every form a value can take - inline scalars, strings and byte
+ *     objects, and packed arrays - comes back out as it went in,
+ *   - storing a key twice replaces it, and a NULL-key fetch returns a
+ *     rank's values in the order they were stored,
+ *   - PMIX_RANK_UNDEF searches every rank, and skips reserved keys when
+ *     asked for everything,
+ *   - a qualified value answers only to its qualifiers,
+ *   - a PMIX_UNDEF value is stored and handed back, not dropped,
+ *   - the rank table grows past its initial estimate,
+ *   - a full image refuses a store and is otherwise left as it was,
+ *   - an image sized by pmix_shmem_flat_sizeof_tables() and
+ *     pmix_shmem_flat_sizeof_kval() holds exactly what was measured,
+ *   - merging images oldest first keeps the newest value of each key,
+ *     deletions included, and leaves nothing pointing at the sources,
+ *   - a damaged header is rejected before anything is followed.
+ */
+
+#include "src/include/pmix_config.h"
+
+#include "include/pmix.h"
+#include "include/pmix_server.h"
+
+#include "src/include/pmix_globals.h"
+#include "src/util/pmix_shmem_flat.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define USF_SIZE (256 * 1024)
+
+static int npass = 0;
+static int nfail = 0;
+
+static void report(const char *name, int passed)
+{
+    if (passed) {
+        fprintf(stdout, "  PASS: %s\n", name);
+        ++npass;
+    } else {
+        fprintf(stdout, "  FAIL: %s\n", name);
+        ++nfail;
+    }
+}
+
+static pmix_status_t store(pmix_shmem_flat_t *f, pmix_rank_t rank, const char *key,
+                           const void *data, pmix_data_type_t type)
+{
+    pmix_kval_t kv;
+    pmix_status_t rc;
+
+    PMIX_CONSTRUCT(&kv, pmix_kval_t);
+    kv.key = strdup(key);
+    PMIX_VALUE_CREATE(kv.value, 1);
+    PMIX_VALUE_LOAD(kv.value, data, type);
+    rc = pmix_shmem_flat_store(f, rank, &kv);
+    PMIX_DESTRUCT(&kv);
+    return rc;
+}
+
+/* The single value fetched for (rank, key), or NULL. Caller releases. */
+static pmix_kval_t *fetch1(const pmix_shmem_flat_t *f, pmix_rank_t rank, const char *key,
+                           pmix_info_t *quals, size_t nquals)
+{
+    pmix_list_t kvs;
+    pmix_kval_t *kv = NULL;
+
+    PMIX_CONSTRUCT(&kvs, pmix_list_t);
+    if (PMIX_SUCCESS == pmix_shmem_flat_fetch(f, rank, key, quals, nquals, &kvs)
+        && 1 == pmix_list_get_size(&kvs)) {
+        kv = (pmix_kval_t *) pmix_list_remove_first(&kvs);
+    }
+    PMIX_LIST_DESTRUCT(&kvs);
+    return kv;
+}
+
+static bool has_u32(const pmix_shmem_flat_t *f, pmix_rank_t rank, const char *key, uint32_t want)
+{
+    pmix_kval_t *kv = fetch1(f, rank, key, NULL, 0);
+    bool ok = NULL != kv && NULL != kv->value && PMIX_UINT32 == kv->value->type
+              && want == kv->value->data.uint32;
+
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    return ok;
+}
+
+static bool has_string(const pmix_shmem_flat_t *f, pmix_rank_t rank, const char *key,
+                       const char *want)
+{
+    pmix_kval_t *kv = fetch1(f, rank, key, NULL, 0);
+    bool ok = NULL != kv && NULL != kv->value && PMIX_STRING == kv->value->type
+              && 0 == strcmp(want, kv->value->data.string);
+
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    return ok;
+}
+
+/* The contents the relocation tests read back, wherever the image is. */
+static void fill(pmix_shmem_flat_t *f)
+{
+    uint32_t u;
+    char s[32];
+    pmix_byte_object_t bo;
+
+    for (pmix_rank_t r = 0; r < 8; r++) {
+        u = 100 + r;
+        store(f, r, "usf.num", &u, PMIX_UINT32);
+        snprintf(s, sizeof(s), "host-%u", (unsigned) r);
+        store(f, r, "usf.str", s, PMIX_STRING);
+    }
+    bo.bytes = "\x01\x02\x00\x03";
+    bo.size = 4;
+    store(f, 3, "usf.bo", &bo, PMIX_BYTE_OBJECT);
+}
+
+static bool check_filled(const pmix_shmem_flat_t *f)
+{
+    char s[32];
+    bool ok = true;
+    pmix_kval_t *kv;
+
+    for (pmix_rank_t r = 0; r < 8; r++) {
+        snprintf(s, sizeof(s), "host-%u", (unsigned) r);
+        ok = ok && has_u32(f, r, "usf.num", 100 + r) && has_string(f, r, "usf.str", s);
+    }
+    kv = fetch1(f, 3, "usf.bo", NULL, 0);
+    ok = ok && NULL != kv && PMIX_BYTE_OBJECT == kv->value->type
+         && 4 == kv->value->data.bo.size
+         && 0 == memcmp("\x01\x02\x00\x03", kv->value->data.bo.bytes, 4);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    return ok;
+}
+
+static void test_values(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    pmix_data_array_t *darray;
+    pmix_envar_t env;
+    pmix_list_t kvs;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    uint64_t u64 = 0x0123456789abcdefULL;
+    double d = 2.5;
+    uint32_t u;
+    bool ok;
+
+    fprintf(stdout, "\n-- values --\n");
+
+    rc = pmix_shmem_flat_init(base, USF_SIZE, 4, 64);
+    report("an empty image is laid out", PMIX_SUCCESS == rc);
+    report("and recognized", pmix_shmem_flat_check(base, USF_SIZE));
+
+    ok = PMIX_SUCCESS == store(f, 0, "usf.u64", &u64, PMIX_UINT64)
+         && PMIX_SUCCESS == store(f, 0, "usf.dbl", &d, PMIX_DOUBLE)
+         && PMIX_SUCCESS == store(f, 0, "usf.str", "hello", PMIX_STRING);
+    report("scalars and a string are stored", ok);
+    kv = fetch1(f, 0, "usf.u64", NULL, 0);
+    report("a scalar is copied back bit for bit",
+           NULL != kv && PMIX_UINT64 == kv->value->type && u64 == kv->value->data.uint64);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    kv = fetch1(f, 0, "usf.dbl", NULL, 0);
+    report("so is a double", NULL != kv && PMIX_DOUBLE == kv->value->type
+                             && 2.5 == kv->value->data.dval);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    report("a string comes back", has_string(f, 0, "usf.str", "hello"));
+
+    /* a type bfrops has to pack */
+    PMIX_DATA_ARRAY_CREATE(darray, 3, PMIX_UINT32);
+    for (u = 0; u < 3; u++) {
+        ((uint32_t *) darray->array)[u] = 7 * u;
+    }
+    rc = store(f, 1, "usf.darray", darray, PMIX_DATA_ARRAY);
+    PMIX_DATA_ARRAY_FREE(darray);
+    kv = fetch1(f, 1, "usf.darray", NULL, 0);
+    report("a data array is packed and unpacked",
+           PMIX_SUCCESS == rc && NULL != kv && PMIX_DATA_ARRAY == kv->value->type
+           && NULL != kv->value->data.darray && 3 == kv->value->data.darray->size
+           && 14 == ((uint32_t *) kv->value->data.darray->array)[2]);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+    PMIX_ENVAR_LOAD(&env, "USF_VAR", "value", ':');
+    rc = store(f, 1, "usf.envar", &env, PMIX_ENVAR);
+    PMIX_ENVAR_DESTRUCT(&env);
+    kv = fetch1(f, 1, "usf.envar", NULL, 0);
+    report("so is an envar",
+           PMIX_SUCCESS == rc && NULL != kv && PMIX_ENVAR == kv->value->type
+           && 0 == strcmp("USF_VAR", kv->value->data.envar.envar)
+           && 0 == strcmp("value", kv->value->data.envar.value)
+           && ':' == kv->value->data.envar.separator);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+
+    /* replacement, and store order */
+    u = 1;
+    store(f, 2, "usf.a", &u, PMIX_UINT32);
+    u = 2;
+    store(f, 2, "usf.b", &u, PMIX_UINT32);
+    u = 3;
+    store(f, 2, "usf.c", &u, PMIX_UINT32);
+    u = 20;
+    store(f, 2, "usf.b", &u, PMIX_UINT32);
+    report("a second store of a key replaces it", has_u32(f, 2, "usf.b", 20));
+    PMIX_CONSTRUCT(&kvs, pmix_list_t);
+    rc = pmix_shmem_flat_fetch(f, 2, NULL, NULL, 0, &kvs);
+    ok = PMIX_SUCCESS == rc && 3 == pmix_list_get_size(&kvs);
+    if (ok) {
+        const char *order[] = {"usf.a", "usf.b", "usf.c"};
+        int n = 0;
+        PMIX_LIST_FOREACH (kv, &kvs, pmix_kval_t) {
+            ok = ok && 0 == strcmp(order[n++], kv->key);
+        }
+    }
+    PMIX_LIST_DESTRUCT(&kvs);
+    report("a NULL key returns the rank's values once each, in store order", ok);
+
+    /* RANK_UNDEF */
+    report("RANK_UNDEF finds a key wherever it is", has_u32(f, PMIX_RANK_UNDEF, "usf.c", 3));
+    report("and reports one nobody has",
+           NULL == fetch1(f, PMIX_RANK_UNDEF, "usf.none", NULL, 0));
+    report("a key another rank has is not this rank's", NULL == fetch1(f, 0, "usf.c", NULL, 0));
+
+    /* a deletion is a value like any other */
+    rc = store(f, 0, "usf.gone", NULL, PMIX_UNDEF);
+    kv = fetch1(f, 0, "usf.gone", NULL, 0);
+    report("a PMIX_UNDEF tombstone is stored and returned",
+           PMIX_SUCCESS == rc && NULL != kv && PMIX_UNDEF == kv->value->type);
+    if (NULL != kv) {
+        PMIX_RELEASE(kv);
+    }
+}
+
+static void test_reserved(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    pmix_list_t kvs;
+    pmix_kval_t *kv;
+    pmix_status_t rc;
+    uint32_t u = 9;
+    bool ok;
+
+    fprintf(stdout, "\n-- reserved keys --\n");
+
+    pmix_shmem_flat_init(base, USF_SIZE, 1, 8);
+    store(f, 5, PMIX_LOCAL_RANK, &u, PMIX_UINT32);
+    store(f, 5, "usf.mine", &u, PMIX_UINT32);
+
+    PMIX_CONSTRUCT(&kvs, pmix_list_t);
+    rc = pmix_shmem_flat_fetch(f, PMIX_RANK_UNDEF, NULL, NULL, 0, &kvs);
+    kv = (pmix_kval_t *) pmix_list_get_first(&kvs);
+    ok = PMIX_SUCCESS == rc && 1 == pmix_list_get_size(&kvs) && 0 == strcmp("usf.mine", kv->key);
+    PMIX_LIST_DESTRUCT(&kvs);
+    report("RANK_UNDEF with no key skips reserved keys", ok);
+
+    PMIX_CONSTRUCT(&kvs, pmix_list_t);
+    rc = pmix_shmem_flat_fetch(f, 5, NULL, NULL, 0, &kvs);
+    ok = PMIX_SUCCESS == rc && 2 == pmix_list_get_size(&kvs);
+    PMIX_LIST_DESTRUCT(&kvs);
+    report("a named rank with no key returns them", ok);
+}
+
+static void test_qualified(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    pmix_data_array_t *darray;
+    pmix_info_t *info, qual;
+    pmix_kval_t kv, *out;
+    pmix_status_t rc;
+    uint32_t u = 42, which = 1;
+
+    fprintf(stdout, "\n-- qualified values --\n");
+
+    pmix_shmem_flat_init(base, USF_SIZE, 1, 8);
+
+    PMIX_DATA_ARRAY_CREATE(darray, 2, PMIX_INFO);
+    info = (pmix_info_t *) darray->array;
+    PMIX_INFO_LOAD(&info[0], "usf.q", &u, PMIX_UINT32);
+    PMIX_INFO_LOAD(&info[1], "usf.which", &which, PMIX_UINT32);
+    PMIX_CONSTRUCT(&kv, pmix_kval_t);
+    kv.key = strdup(PMIX_QUALIFIED_VALUE);
+    PMIX_VALUE_CREATE(kv.value, 1);
+    kv.value->type = PMIX_DATA_ARRAY;
+    kv.value->data.darray = darray;
+    rc = pmix_shmem_flat_store(f, 0, &kv);
+    PMIX_DESTRUCT(&kv);
+    report("a qualified value is stored", PMIX_SUCCESS == rc);
+
+    PMIX_INFO_LOAD(&qual, "usf.which", &which, PMIX_UINT32);
+    PMIX_INFO_SET_QUALIFIER(&qual);
+    out = fetch1(f, 0, "usf.q", &qual, 1);
+    report("its qualifier finds it, wrapped as PMIX_QUALIFIED_VALUE",
+           NULL != out && 0 == strcmp(PMIX_QUALIFIED_VALUE, out->key)
+           && PMIX_DATA_ARRAY == out->value->type
+           && 42 == ((pmix_info_t *) out->value->data.darray->array)[0].value.data.uint32);
+    if (NULL != out) {
+        PMIX_RELEASE(out);
+    }
+    PMIX_INFO_DESTRUCT(&qual);
+
+    which = 2;
+    PMIX_INFO_LOAD(&qual, "usf.which", &which, PMIX_UINT32);
+    PMIX_INFO_SET_QUALIFIER(&qual);
+    out = fetch1(f, 0, "usf.q", &qual, 1);
+    report("a different qualifier does not", NULL == out);
+    if (NULL != out) {
+        PMIX_RELEASE(out);
+    }
+    PMIX_INFO_DESTRUCT(&qual);
+    out = fetch1(f, 0, "usf.q", NULL, 0);
+    report("nor does an unqualified request", NULL == out);
+    if (NULL != out) {
+        PMIX_RELEASE(out);
+    }
+
+    u = 7;
+    store(f, 0, "usf.q", &u, PMIX_UINT32);
+    report("an unqualified value of the same key lives alongside it",
+           has_u32(f, 0, "usf.q", 7));
+}
+
+static void test_growth(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    pmix_status_t rc = PMIX_SUCCESS;
+    uint32_t cap;
+    bool ok = true;
+
+    fprintf(stdout, "\n-- capacity --\n");
+
+    /* sized for one rank; posted by many */
+    pmix_shmem_flat_init(base, USF_SIZE, 1, 4);
+    cap = f->rankcap;
+    for (uint32_t r = 0; r < 200 && PMIX_SUCCESS == rc; r++) {
+        rc = store(f, r, "usf.num", &r, PMIX_UINT32);
+    }
+    report("stores past the rank estimate succeed", PMIX_SUCCESS == rc);
+    report("the rank table grew", f->rankcap > cap && 200 == f->nranks);
+    for (uint32_t r = 0; r < 200; r++) {
+        ok = ok && has_u32(f, r, "usf.num", r);
+    }
+    report("every rank is still found after growing", ok);
+
+    /* fill a small image to the brim */
+    char big[512];
+    memset(big, 'x', sizeof(big) - 1);
+    big[sizeof(big) - 1] = '\0';
+    pmix_shmem_flat_init(base, 4096, 1, 4);
+    rc = PMIX_SUCCESS;
+    for (int n = 0; n < 64 && PMIX_SUCCESS == rc; n++) {
+        char key[32];
+        snprintf(key, sizeof(key), "usf.big.%d", n);
+        rc = store(f, 0, key, big, PMIX_STRING);
+    }
+    report("a full image refuses the store", PMIX_ERR_OUT_OF_RESOURCE == rc);
+    {
+        const uint64_t used = f->used;
+        const uint32_t nentries = f->nentries;
+        rc = store(f, 0, "usf.more", big, PMIX_STRING);
+        report("and is left as it was",
+               PMIX_ERR_OUT_OF_RESOURCE == rc && used == f->used && nentries == f->nentries
+               && NULL == fetch1(f, 0, "usf.more", NULL, 0));
+    }
+    report("what fit is still there", has_string(f, 0, "usf.big.0", big));
+}
+
+/* One value of each form, for the sizing test to measure and then store. */
+static pmix_kval_t *mkkv(int form)
+{
+    pmix_kval_t *kv = PMIX_NEW(pmix_kval_t);
+    pmix_data_array_t *darray;
+    pmix_info_t *info;
+    pmix_byte_object_t bo;
+    uint32_t u = 5;
+    char bytes[40];
+
+    PMIX_VALUE_CREATE(kv->value, 1);
+    switch (form) {
+    case 0:
+        kv->key = strdup("usf.size.num");
+        PMIX_VALUE_LOAD(kv->value, &u, PMIX_UINT32);
+        break;
+    case 1:
+        kv->key = strdup("usf.size.string");
+        PMIX_VALUE_LOAD(kv->value, "a string of no particular length", PMIX_STRING);
+        break;
+    case 2:
+        memset(bytes, 0x3c, sizeof(bytes));
+        bo.bytes = bytes;
+        bo.size = sizeof(bytes);
+        kv->key = strdup("usf.size.bytes");
+        PMIX_VALUE_LOAD(kv->value, &bo, PMIX_BYTE_OBJECT);
+        break;
+    case 3:
+        PMIX_DATA_ARRAY_CREATE(darray, 7, PMIX_UINT32);
+        for (uint32_t n = 0; n < 7; n++) {
+            ((uint32_t *) darray->array)[n] = n;
+        }
+        kv->key = strdup("usf.size.array");
+        kv->value->type = PMIX_DATA_ARRAY;
+        kv->value->data.darray = darray;
+        break;
+    default:
+        PMIX_DATA_ARRAY_CREATE(darray, 2, PMIX_INFO);
+        info = (pmix_info_t *) darray->array;
+        PMIX_INFO_LOAD(&info[0], "usf.size.q", &u, PMIX_UINT32);
+        PMIX_INFO_LOAD(&info[1], "usf.which", &u, PMIX_UINT32);
+        kv->key = strdup(PMIX_QUALIFIED_VALUE);
+        kv->value->type = PMIX_DATA_ARRAY;
+        kv->value->data.darray = darray;
+        break;
+    }
+    return kv;
+}
+
+#define USF_NFORMS 5
+#define USF_NRANKS 6
+
+/* gds/shmem3 sizes a modex image as the tables plus the sum of every
+ * value's pmix_shmem_flat_sizeof_kval(), with no multiplier on top. That
+ * is only safe if the two really are what a store consumes, so: measure
+ * a mixed contribution, lay out an image of exactly that many bytes, and
+ * store it. Every store has to fit, and the image has to end up full to
+ * within alignment - an estimate that is merely large enough would pass
+ * the first half of this and not the second. */
+static void test_sizing(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    pmix_kval_t *kvs[USF_NFORMS];
+    pmix_status_t rc = PMIX_SUCCESS;
+    size_t need, one, total;
+    bool ok = true;
+
+    fprintf(stdout, "\n-- exact sizing --\n");
+
+    need = 0;
+    for (int n = 0; n < USF_NFORMS; n++) {
+        kvs[n] = mkkv(n);
+        if (PMIX_SUCCESS != pmix_shmem_flat_sizeof_kval(kvs[n], &one)) {
+            ok = false;
+        }
+        need += one;
+    }
+    report("every form can be measured", ok);
+
+    total = pmix_shmem_flat_sizeof_tables(USF_NRANKS, USF_NRANKS * USF_NFORMS)
+            + USF_NRANKS * need;
+    report("the tables alone fit in their own size",
+           PMIX_SUCCESS == pmix_shmem_flat_init(base, pmix_shmem_flat_sizeof_tables(4, 4), 4, 4));
+    report("and not in one byte less",
+           PMIX_SUCCESS != pmix_shmem_flat_init(base, pmix_shmem_flat_sizeof_tables(4, 4) - 1, 4, 4));
+
+    rc = pmix_shmem_flat_init(base, total, USF_NRANKS, USF_NRANKS * USF_NFORMS);
+    report("an image of exactly the measured size lays out", PMIX_SUCCESS == rc);
+    for (pmix_rank_t r = 0; r < USF_NRANKS && PMIX_SUCCESS == rc; r++) {
+        for (int n = 0; n < USF_NFORMS && PMIX_SUCCESS == rc; n++) {
+            rc = pmix_shmem_flat_store(f, r, kvs[n]);
+        }
+    }
+    report("every value it was measured for fits", PMIX_SUCCESS == rc);
+    report("and fills it to within alignment",
+           f->used <= total && total - f->used < 8 * USF_NRANKS * USF_NFORMS);
+    report("what was stored reads back", has_u32(f, USF_NRANKS - 1, "usf.size.num", 5)
+           && has_string(f, 0, "usf.size.string", "a string of no particular length"));
+
+    for (int n = 0; n < USF_NFORMS; n++) {
+        PMIX_RELEASE(kvs[n]);
+    }
+}
+
+static bool keep_all_but_drop(pmix_rank_t rank, const pmix_kval_t *kv, void *cbdata)
+{
+    (void) rank;
+    ++*(int *) cbdata;
+    return 0 != strcmp(kv->key, "usf.drop");
+}
+
+/* gds/shmem3 folds a chain of delta generations into one by merging
+ * them into a fresh image oldest first. What comes out has to answer
+ * every read as the chain did - the newest value of each key, deletions
+ * included - and has to fit in the bytes the sources used. */
+static void test_merge(void *base)
+{
+    pmix_shmem_flat_t *dst = (pmix_shmem_flat_t *) base;
+    pmix_shmem_flat_t *older, *newer;
+    pmix_data_array_t *darray;
+    pmix_info_t *info, qual;
+    pmix_kval_t kv, *out;
+    pmix_status_t rc;
+    uint32_t u;
+    size_t budget;
+    int asked = 0;
+
+    fprintf(stdout, "\n-- merging images --\n");
+
+    older = (pmix_shmem_flat_t *) malloc(USF_SIZE / 4);
+    newer = (pmix_shmem_flat_t *) malloc(USF_SIZE / 4);
+    pmix_shmem_flat_init(older, USF_SIZE / 4, 2, 8);
+    pmix_shmem_flat_init(newer, USF_SIZE / 4, 2, 8);
+
+    u = 1;
+    store(older, 0, "usf.a", &u, PMIX_UINT32);
+    store(older, 0, "usf.b", "old b", PMIX_STRING);
+    store(older, 0, "usf.drop", "filtered", PMIX_STRING);
+    u = 3;
+    store(older, 1, "usf.c", &u, PMIX_UINT32);
+    PMIX_DATA_ARRAY_CREATE(darray, 2, PMIX_INFO);
+    info = (pmix_info_t *) darray->array;
+    u = 42;
+    PMIX_INFO_LOAD(&info[0], "usf.q", &u, PMIX_UINT32);
+    PMIX_INFO_LOAD(&info[1], "usf.which", &u, PMIX_UINT32);
+    PMIX_CONSTRUCT(&kv, pmix_kval_t);
+    kv.key = strdup(PMIX_QUALIFIED_VALUE);
+    PMIX_VALUE_CREATE(kv.value, 1);
+    kv.value->type = PMIX_DATA_ARRAY;
+    kv.value->data.darray = darray;
+    pmix_shmem_flat_store(older, 1, &kv);
+    PMIX_DESTRUCT(&kv);
+
+    u = 10;
+    store(newer, 0, "usf.a", &u, PMIX_UINT32);
+    store(newer, 0, "usf.b", NULL, PMIX_UNDEF);
+
+    budget = pmix_shmem_flat_sizeof_tables(older->nranks + newer->nranks,
+                                           older->nentries + newer->nentries)
+             + older->used + newer->used;
+    rc = pmix_shmem_flat_init(dst, budget, older->nranks + newer->nranks,
+                              older->nentries + newer->nentries);
+    if (PMIX_SUCCESS == rc) {
+        rc = pmix_shmem_flat_merge(dst, older, keep_all_but_drop, &asked);
+    }
+    if (PMIX_SUCCESS == rc) {
+        rc = pmix_shmem_flat_merge(dst, newer, keep_all_but_drop, &asked);
+    }
+    report("both images merge within the bytes they used", PMIX_SUCCESS == rc);
+    report("the filter is asked about every value", 7 == asked);
+    report("the newer value of a key wins", has_u32(dst, 0, "usf.a", 10));
+    out = fetch1(dst, 0, "usf.b", NULL, 0);
+    report("a newer deletion replaces the older value",
+           NULL != out && PMIX_UNDEF == out->value->type);
+    if (NULL != out) {
+        PMIX_RELEASE(out);
+    }
+    report("what only the older image had survives", has_u32(dst, 1, "usf.c", 3));
+    report("what the filter refused does not",
+           NULL == fetch1(dst, 0, "usf.drop", NULL, 0));
+    u = 42;
+    PMIX_INFO_LOAD(&qual, "usf.which", &u, PMIX_UINT32);
+    PMIX_INFO_SET_QUALIFIER(&qual);
+    out = fetch1(dst, 1, "usf.q", &qual, 1);
+    report("a qualified value keeps its qualifiers",
+           NULL != out && 0 == strcmp(PMIX_QUALIFIED_VALUE, out->key));
+    if (NULL != out) {
+        PMIX_RELEASE(out);
+    }
+    PMIX_INFO_DESTRUCT(&qual);
+
+    /* nothing in the result may refer back into its sources */
+    memset(older, 0xa5, USF_SIZE / 4);
+    memset(newer, 0xa5, USF_SIZE / 4);
+    report("the result stands without its sources",
+           has_u32(dst, 0, "usf.a", 10) && has_u32(dst, 1, "usf.c", 3));
+    free(older);
+    free(newer);
+}
+
+static void test_relocation(void *base)
+{
+    char path[] = "/tmp/util_shmem_flat.XXXXXX";
+    void *copy, *m1, *m2;
+    int fd;
+
+    fprintf(stdout, "\n-- relocation --\n");
+
+    pmix_shmem_flat_init(base, USF_SIZE, 8, 32);
+    fill((pmix_shmem_flat_t *) base);
+    report("the image reads where it was written", check_filled(base));
+
+    copy = malloc(USF_SIZE);
+    memcpy(copy, base, USF_SIZE);
+    memset(base, 0xa5, USF_SIZE);
+    report("a copy reads with the original scribbled over",
+           pmix_shmem_flat_check(copy, USF_SIZE) && check_filled(copy));
+
+    fd = mkstemp(path);
+    if (0 > fd) {
+        report("temporary file", 0);
+        free(copy);
+        return;
+    }
+    unlink(path);
+    if (USF_SIZE != write(fd, copy, USF_SIZE)) {
+        report("temporary file written", 0);
+        close(fd);
+        free(copy);
+        return;
+    }
+    m1 = mmap(NULL, USF_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    m2 = mmap(NULL, USF_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    free(copy);
+    report("two mappings of one file land at different addresses",
+           MAP_FAILED != m1 && MAP_FAILED != m2 && m1 != m2);
+    if (MAP_FAILED == m1 || MAP_FAILED == m2) {
+        return;
+    }
+    report("the first read-only mapping reads", check_filled(m1));
+    report("so does the second", check_filled(m2));
+    munmap(m1, USF_SIZE);
+    munmap(m2, USF_SIZE);
+}
+
+static void test_check(void *base)
+{
+    pmix_shmem_flat_t *f = (pmix_shmem_flat_t *) base;
+    uint64_t used;
+    pmix_shmem_rel_t ranks;
+
+    fprintf(stdout, "\n-- header checks --\n");
+
+    pmix_shmem_flat_init(base, USF_SIZE, 2, 8);
+    report("a good header passes", pmix_shmem_flat_check(base, USF_SIZE));
+    report("a mapping smaller than the image does not",
+           !pmix_shmem_flat_check(base, USF_SIZE / 2));
+
+    used = f->used;
+    f->used = USF_SIZE + 1;
+    report("nor does a use count past the end", !pmix_shmem_flat_check(base, USF_SIZE));
+    f->used = used;
+
+    ranks = f->ranks;
+    f->ranks = (pmix_shmem_rel_t) USF_SIZE * 4;
+    report("nor does a table out of bounds", !pmix_shmem_flat_check(base, USF_SIZE));
+    f->ranks = ranks;
+
+    f->magic = 0;
+    report("nor does a wrong magic", !pmix_shmem_flat_check(base, USF_SIZE));
+    report("and a fetch from it finds nothing", NULL == fetch1(f, 0, "usf.num", NULL, 0));
+}
+
+int main(int argc, char **argv)
+{
+    static pmix_server_module_t mymodule = {0};
+    pmix_status_t rc;
+    void *base;
+
+    (void) argc;
+    (void) argv;
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fprintf(stdout, "util_shmem_flat: position-independent image unit tests\n");
+
+    /* bfrops, for the packed form */
+    rc = PMIx_server_init(&mymodule, NULL, 0);
+    if (PMIX_SUCCESS != rc) {
+        fprintf(stderr, "PMIx_server_init failed: %s\n", PMIx_Error_string(rc));
+        return 1;
+    }
+
+    base = malloc(USF_SIZE);
+    test_values(base);
+    test_reserved(base);
+    test_qualified(base);
+    test_growth(base);
+    test_sizing(base);
+    test_merge(base);
+    test_relocation(base);
+    test_check(base);
+    free(base);
+
+    PMIx_server_finalize();
+
+    fprintf(stdout, "\nutil_shmem_flat: %d passed, %d failed\n", npass, nfail);
+    return (0 == nfail) ? 0 : 1;
+}